@@ -23,6 +23,7 @@
 #include <beast/threads/SharedData.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <deque>
@@ -87,7 +88,6 @@ public:
     void increment (CounterImpl::value_type amount);
 
     void flush ();
-    void do_increment (CounterImpl::value_type amount);
     void do_process ();
 
 private:
@@ -95,8 +95,10 @@ private:
 
     std::shared_ptr <StatsDCollectorImp> m_impl;
     std::string m_name;
-    CounterImpl::value_type m_value;
-    bool m_dirty;
+
+    // Accumulated on the caller's thread; drained by the collector's
+    // periodic flush. Callers never touch the collector's io_service.
+    std::atomic <CounterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -138,8 +140,6 @@ public:
     void increment (GaugeImpl::difference_type amount);
 
     void flush ();
-    void do_set (GaugeImpl::value_type value);
-    void do_increment (GaugeImpl::difference_type amount);
     void do_process ();
 
 private:
@@ -147,9 +147,11 @@ private:
 
     std::shared_ptr <StatsDCollectorImp> m_impl;
     std::string m_name;
+
+    // m_value is written on the caller's thread; m_last_value is only
+    // touched by the collector's periodic flush.
     GaugeImpl::value_type m_last_value;
-    GaugeImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic <GaugeImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -167,7 +169,6 @@ public:
     void increment (MeterImpl::value_type amount);
 
     void flush ();
-    void do_increment (MeterImpl::value_type amount);
     void do_process ();
 
 private:
@@ -175,8 +176,10 @@ private:
 
     std::shared_ptr <StatsDCollectorImp> m_impl;
     std::string m_name;
-    MeterImpl::value_type m_value;
-    bool m_dirty;
+
+    // Accumulated on the caller's thread; drained by the collector's
+    // periodic flush.
+    std::atomic <MeterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -477,7 +480,6 @@ StatsDCounterImpl::StatsDCounterImpl (std::string const& name,
     : m_impl (impl)
     , m_name (name)
     , m_value (0)
-    , m_dirty (false)
 {
     m_impl->add (*this);
 }
@@ -489,34 +491,26 @@ StatsDCounterImpl::~StatsDCounterImpl ()
 
 void StatsDCounterImpl::increment (CounterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch (std::bind (
-        &StatsDCounterImpl::do_increment,
-            std::static_pointer_cast <StatsDCounterImpl> (
-                shared_from_this ()), amount));
+    m_value.fetch_add (amount, std::memory_order_relaxed);
 }
 
 void StatsDCounterImpl::flush ()
 {
-    if (m_dirty)
+    CounterImpl::value_type const value (
+        m_value.exchange (0, std::memory_order_relaxed));
+
+    if (value != 0)
     {
-        m_dirty = false;
         std::stringstream ss;
         ss <<
             m_impl->prefix() << "." <<
             m_name << ":" <<
-            m_value << "|c" <<
+            value << "|c" <<
             "\n";
-        m_value = 0;
         m_impl->post_buffer (ss.str ());
     }
 }
 
-void StatsDCounterImpl::do_increment (CounterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
-}
-
 void StatsDCounterImpl::do_process ()
 {
     flush ();
@@ -562,7 +556,6 @@ StatsDGaugeImpl::StatsDGaugeImpl (std::string const& name,
     , m_name (name)
     , m_last_value (0)
     , m_value (0)
-    , m_dirty (false)
 {
     m_impl->add (*this);
 }
@@ -574,69 +567,57 @@ StatsDGaugeImpl::~StatsDGaugeImpl ()
 
 void StatsDGaugeImpl::set (GaugeImpl::value_type value)
 {
-    m_impl->get_io_service().dispatch (std::bind (
-        &StatsDGaugeImpl::do_set,
-            std::static_pointer_cast <StatsDGaugeImpl> (
-                shared_from_this ()), value));
+    m_value.store (value, std::memory_order_relaxed);
 }
 
 void StatsDGaugeImpl::increment (GaugeImpl::difference_type amount)
 {
-    m_impl->get_io_service().dispatch (std::bind (
-        &StatsDGaugeImpl::do_increment,
-            std::static_pointer_cast <StatsDGaugeImpl> (
-                shared_from_this ()), amount));
+    GaugeImpl::value_type value (
+        m_value.load (std::memory_order_relaxed));
+    GaugeImpl::value_type desired;
+
+    do
+    {
+        desired = value;
+
+        if (amount > 0)
+        {
+            GaugeImpl::value_type const d (
+                static_cast <GaugeImpl::value_type> (amount));
+            desired +=
+                (d >= std::numeric_limits <GaugeImpl::value_type>::max() - value)
+                ? std::numeric_limits <GaugeImpl::value_type>::max() - value
+                : d;
+        }
+        else if (amount < 0)
+        {
+            GaugeImpl::value_type const d (
+                static_cast <GaugeImpl::value_type> (-amount));
+            desired = (d >= value) ? 0 : value - d;
+        }
+    }
+    while (! m_value.compare_exchange_weak (
+        value, desired, std::memory_order_relaxed));
 }
 
 void StatsDGaugeImpl::flush ()
 {
-    if (m_dirty)
+    GaugeImpl::value_type const value (
+        m_value.load (std::memory_order_relaxed));
+
+    if (value != m_last_value)
     {
-        m_dirty = false;
+        m_last_value = value;
         std::stringstream ss;
         ss <<
             m_impl->prefix() << "." <<
             m_name << ":" <<
-            m_value << "|c" <<
+            value << "|c" <<
             "\n";
         m_impl->post_buffer (ss.str ());
     }
 }
 
-void StatsDGaugeImpl::do_set (GaugeImpl::value_type value)
-{
-    m_value = value;
-    
-    if (m_value != m_last_value)
-    {
-        m_last_value = m_value;
-        m_dirty = true;
-    }
-}
-
-void StatsDGaugeImpl::do_increment (GaugeImpl::difference_type amount)
-{
-    GaugeImpl::value_type value (m_value);
-
-    if (amount > 0)
-    {
-        GaugeImpl::value_type const d (
-            static_cast <GaugeImpl::value_type> (amount));
-        value +=
-            (d >= std::numeric_limits <GaugeImpl::value_type>::max() - m_value)
-            ? std::numeric_limits <GaugeImpl::value_type>::max() - m_value
-            : d;
-    }
-    else if (amount < 0)
-    {
-        GaugeImpl::value_type const d (
-            static_cast <GaugeImpl::value_type> (-amount));
-        value = (d >= value) ? 0 : value - d; 
-    }
-
-    do_set (value);
-}
-
 void StatsDGaugeImpl::do_process ()
 {
     flush ();
@@ -649,7 +630,6 @@ StatsDMeterImpl::StatsDMeterImpl (std::string const& name,
     : m_impl (impl)
     , m_name (name)
     , m_value (0)
-    , m_dirty (false)
 {
     m_impl->add (*this);
 }
@@ -661,34 +641,26 @@ StatsDMeterImpl::~StatsDMeterImpl ()
 
 void StatsDMeterImpl::increment (MeterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch (std::bind (
-        &StatsDMeterImpl::do_increment,
-            std::static_pointer_cast <StatsDMeterImpl> (
-                shared_from_this ()), amount));
+    m_value.fetch_add (amount, std::memory_order_relaxed);
 }
 
 void StatsDMeterImpl::flush ()
 {
-    if (m_dirty)
+    MeterImpl::value_type const value (
+        m_value.exchange (0, std::memory_order_relaxed));
+
+    if (value != 0)
     {
-        m_dirty = false;
         std::stringstream ss;
         ss <<
             m_impl->prefix() << "." <<
             m_name << ":" <<
-            m_value << "|m" <<
+            value << "|m" <<
             "\n";
-        m_value = 0;
         m_impl->post_buffer (ss.str ());
     }
 }
 
-void StatsDMeterImpl::do_increment (MeterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
-}
-
 void StatsDMeterImpl::do_process ()
 {
     flush ();
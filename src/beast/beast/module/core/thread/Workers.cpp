@@ -155,6 +155,8 @@ Workers::Worker::~Worker ()
 
 void Workers::Worker::run ()
 {
+    m_workers.m_callback.threadStarted ();
+
     while (! threadShouldExit ())
     {
         // Increment the count of active workers, and if
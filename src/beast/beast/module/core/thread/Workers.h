@@ -46,6 +46,13 @@ public:
             @see Workers::addTask
         */
         virtual void processTask () = 0;
+
+        /** Called once when a worker thread starts, on that thread.
+
+            The default implementation does nothing. Override to apply
+            per-thread settings such as scheduling or affinity.
+        */
+        virtual void threadStarted () { }
     };
 
     /** Create the object.
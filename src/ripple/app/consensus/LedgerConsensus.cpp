@@ -29,6 +29,7 @@
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/misc/IHashRouter.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/SignatureVerifier.h>
 #include <ripple/app/misc/Validations.h>
 #include <ripple/app/tx/TransactionAcquire.h>
 #include <ripple/basics/CountedObject.h>
@@ -40,6 +41,8 @@
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/STValidation.h>
 #include <ripple/protocol/UintTypes.h>
+#include <condition_variable>
+#include <mutex>
 
 namespace ripple {
 
@@ -156,6 +159,25 @@ public:
         }
         else  // update the network status table as to whether we're proposing/validating
             getApp().getOPs ().setProposing (mProposing, mValidating);
+
+        if ((getConfig ().RUN_STANDALONE || (mProposing && mHaveCorrectLCL))
+                && ((mPreviousLedger->getLedgerSeq () % 256) == 0))
+        {
+            // Previous ledger was a flag ledger: tally the fee and
+            // amendment votes now, off the close path, so that
+            // takeInitialPosition finds them precomputed. If the LCL
+            // changes before then, doVoting falls back to an inline
+            // tally for the right ledger.
+            Ledger::pointer flagLedger = mPreviousLedger;
+            FeeVote* feeVote = &m_feeVote;
+            getApp().getJobQueue ().addJob (
+                jtADVANCE, "prepareVoting",
+                [flagLedger, feeVote] (Job&)
+                {
+                    feeVote->preVote (flagLedger);
+                    getApp().getAmendmentTable ().preVote (flagLedger);
+                });
+        }
     }
 
     /**
@@ -446,6 +468,20 @@ public:
         mAcquired[hash] = map;
         mAcquiring.erase (hash);
 
+        if (!acquired)
+        {
+            // Seed the temp node cache with this locally-built set's
+            // nodes. Competing sets mostly share subtrees with ours,
+            // so acquiring one then fetches only the nodes that differ.
+            // Sets acquired from the network are already in the cache.
+            auto& nodeCache (getApp().getTempNodeCache ());
+            map->getFetchPack (nullptr, true, 4096,
+                [&nodeCache](uint256 const& nodeHash, Blob&& nodeData)
+                {
+                    nodeCache.insert (nodeHash, nodeData);
+                });
+        }
+
         // Adjust tracking for each peer that takes this position
         std::vector<NodeID> peers;
         for (auto& it : mPeerPositions)
@@ -764,7 +800,7 @@ public:
     {
 
         // Give everyone a chance to take an initial position
-        if (mCurrentMSeconds < LEDGER_MIN_CONSENSUS)
+        if (mCurrentMSeconds < ContinuousLedgerTiming::getMinConsensusTime ())
             return;
 
         updateOurPositions ();
@@ -903,6 +939,20 @@ public:
         WriteLog (lsTRACE, LedgerConsensus) << "Processing peer proposal "
             << newPosition->getProposeSeq () << "/"
             << newPosition->getCurrentHash ();
+
+        // If we hold the set the peer is moving away from, its votes on
+        // our disputes already reflect that set, so we only need to
+        // reconsider transactions that differ between the two sets.
+        SHAMap::pointer prevSet;
+
+        if (currentPosition && !mDisputes.empty ())
+        {
+            auto ait = mAcquired.find (currentPosition->getCurrentHash ());
+
+            if (ait != mAcquired.end ())
+                prevSet = ait->second;
+        }
+
         currentPosition = newPosition;
 
         SHAMap::pointer set
@@ -910,8 +960,25 @@ public:
 
         if (set)
         {
-            for (auto& it : mDisputes)
-                it.second->setVote (peerID, set->hasItem (it.first));
+            SHAMap::Delta differences;
+
+            if (prevSet &&
+                prevSet->compare (set, differences, 16384, mCompareCache))
+            {
+                for (auto& pos : differences)
+                {
+                    auto dit = mDisputes.find (pos.first);
+
+                    if (dit != mDisputes.end ())
+                        dit->second->setVote (peerID,
+                            pos.second.second != nullptr);
+                }
+            }
+            else
+            {
+                for (auto& it : mDisputes)
+                    it.second->setVote (peerID, set->hasItem (it.first));
+            }
         }
         else
         {
@@ -991,7 +1058,6 @@ public:
         closeLedger ();
         mCurrentMSeconds = 100;
         beginAccept (true);
-        endConsensus ();
         WriteLog (lsINFO, LedgerConsensus) << "Simulation complete";
     }
 private:
@@ -1003,8 +1069,7 @@ private:
     {
 
         {
-            Application::ScopedLockType lock
-                (getApp ().getMasterLock ());
+            MasterLockGuard lock (getApp ().consensusLock ());
 
             // put our set where others can get it later
             if (set->getHash ().isNonZero ())
@@ -1121,8 +1186,13 @@ private:
                 WriteLog (lsINFO, LedgerConsensus)
                     << "CNF newLCL " << newLCLHash;
 
-            // See if we can accept a ledger as fully-validated
-            getApp().getLedgerMaster().consensusBuilt (newLCL);
+            // See if we can accept a ledger as fully-validated. This can
+            // trigger the SQL save and client publishing, so run it on a
+            // pipeline stage instead of under the master lock; the next
+            // round does not depend on it.
+            getApp().getJobQueue ().addJob (jtPUBLEDGER, "Consensus::built",
+                std::bind (&LedgerConsensusImp::ledgerBuilt,
+                    shared_from_this (), newLCL));
 
             // Build new open ledger
             Ledger::pointer newOL = std::make_shared<Ledger>
@@ -1187,6 +1257,10 @@ private:
             mState = lcsACCEPTED;
             sl.unlock ();
 
+            // The new open ledger has capacity again; release the
+            // best-fee transactions held back by admission control
+            getApp().getOPs ().releaseQueuedTransactions ();
+
             if (mValidating)
             {
                 // see how close our close time is to other node's
@@ -1219,9 +1293,27 @@ private:
                     << offset << " (" << closeCount << ")";
                 getApp().getOPs ().closeTimeOffset (offset);
             }
+
+            // The remaining post-accept work (checkAccept, the SQL save,
+            // publishing to subscribers) is completing on the job queue.
+            // End this round now, while we still hold the master lock, so
+            // the next one starts on the fresh open ledger instead of
+            // waiting for the heartbeat timer to notice we accepted.
+            endConsensus ();
         }
     }
 
+    /** Pipeline stage: process the ledger we built
+
+      Sees if the new last closed ledger can become fully validated, which
+      can trigger the SQL save and publishing to subscribers. Runs off the
+      accept path so the next consensus round is not delayed by it.
+    */
+    void ledgerBuilt (Ledger::pointer newLCL)
+    {
+        getApp().getLedgerMaster().consensusBuilt (newLCL);
+    }
+
     /**
       Begin acquiring a transaction set
 
@@ -1291,7 +1383,7 @@ private:
         WriteLog (lsDEBUG, LedgerConsensus) << "createDisputes "
             << m1->getHash() << " to " << m2->getHash();
         SHAMap::Delta differences;
-        m1->compare (m2, differences, 16384);
+        m1->compare (m2, differences, 16384, mCompareCache);
 
         int dc = 0;
         // for each difference between the transactions
@@ -1513,6 +1605,10 @@ private:
     */
     void takeInitialPosition (Ledger& initialLedger)
     {
+        // The candidate set is the open ledger's transaction map, which
+        // the engine has been building incrementally as each transaction
+        // was admitted. Taking a position is a copy-on-write snapshot of
+        // it, not a rebuild, so there is no construction burst at close.
         SHAMap::pointer initialSet;
 
         if ((getConfig ().RUN_STANDALONE || (mProposing && mHaveCorrectLCL))
@@ -1974,6 +2070,9 @@ private:
     hash_map<uint256, DisputedTx::pointer> mDisputes;
     hash_set<uint256> mCompares;
 
+    // Memoized per-branch set differences for this round
+    SHAMap::DeltaCache mCompareCache;
+
     // Close time estimates
     std::map<std::uint32_t, int> mCloseTimes;
 
@@ -2016,9 +2115,11 @@ int applyTransaction (TransactionEngine& engine
         parms = static_cast<TransactionEngineParams> (parms | tapRETRY);
     }
 
-    if (getApp().getHashRouter ().setFlag (txn->getTransactionID ()
-        , SF_SIGGOOD))
+    if ((getApp().getHashRouter ().getFlags (txn->getTransactionID ())
+        & SF_SIGGOOD) != 0)
     {
+        // The signature was verified when the transaction was relayed
+        // or by the pre-verification pass in applyTransactions
         parms = static_cast<TransactionEngineParams>
             (parms | tapNO_CHECK_SIGN);
     }
@@ -2078,27 +2179,23 @@ void applyTransactions (SHAMap::ref set, Ledger::ref applyLedger,
 
     if (set)
     {
+        // First deserialize the candidates and verify their signatures
+        // on all cores. Application itself must stay serial and in
+        // canonical order so every node computes an identical ledger,
+        // but with the flags pre-set the serial loop is pure state
+        // mutation and no longer pays for ECDSA.
+        std::vector <STTx::pointer> candidates;
+
         for (SHAMapItem::pointer item = set->peekFirstItem (); !!item;
             item = set->peekNextItem (item->getTag ()))
         {
             // If the checkLedger doesn't have the transaction
             if (!checkLedger->hasTransaction (item->getTag ()))
             {
-                // Then try to apply the transaction to applyLedger
-                WriteLog (lsINFO, LedgerConsensus) <<
-                    "Processing candidate transaction: " << item->getTag ();
                 try
                 {
                     SerializerIterator sit (item->peekSerializer ());
-                    STTx::pointer txn
-                        = std::make_shared<STTx>(sit);
-                    if (applyTransaction (engine, txn,
-                              openLgr, true) == LedgerConsensusImp::resultRetry)
-                    {
-                        // On failure, stash the failed transaction for
-                        // later retry.
-                        retriableTransactions.push_back (txn);
-                    }
+                    candidates.push_back (std::make_shared<STTx> (sit));
                 }
                 catch (...)
                 {
@@ -2106,6 +2203,66 @@ void applyTransactions (SHAMap::ref set, Ledger::ref applyLedger,
                 }
             }
         }
+
+        {
+            std::mutex lock;
+            std::condition_variable cond;
+
+            // Decide what needs verifying before dispatching anything, so
+            // the count of outstanding jobs is final by the time the first
+            // worker can decrement it. Touching it from this thread after
+            // workers start would race.
+            std::vector <STTx::pointer> unverified;
+
+            for (auto const& txn : candidates)
+            {
+                if ((getApp().getHashRouter ().getFlags (
+                        txn->getTransactionID ()) & SF_SIGGOOD) == 0)
+                    unverified.push_back (txn);
+            }
+
+            int pending = unverified.size ();
+
+            for (auto const& txn : unverified)
+            {
+                getApp().getSignatureVerifier ().verify (txn,
+                    [&lock, &cond, &pending] (STTx::pointer tx, bool sigGood)
+                    {
+                        if (sigGood)
+                            getApp().getHashRouter ().setFlag (
+                                tx->getTransactionID (), SF_SIGGOOD);
+
+                        std::lock_guard <std::mutex> sl (lock);
+                        if (--pending == 0)
+                            cond.notify_one ();
+                    });
+            }
+
+            std::unique_lock <std::mutex> sl (lock);
+            cond.wait (sl, [&pending] { return pending == 0; });
+        }
+
+        for (auto const& txn : candidates)
+        {
+            // Try to apply the transaction to applyLedger
+            WriteLog (lsINFO, LedgerConsensus) <<
+                "Processing candidate transaction: "
+                << txn->getTransactionID ();
+            try
+            {
+                if (applyTransaction (engine, txn,
+                          openLgr, true) == LedgerConsensusImp::resultRetry)
+                {
+                    // On failure, stash the failed transaction for
+                    // later retry.
+                    retriableTransactions.push_back (txn);
+                }
+            }
+            catch (...)
+            {
+                WriteLog (lsWARNING, LedgerConsensus) << "  Throws";
+            }
+        }
     }
 
     int changes;
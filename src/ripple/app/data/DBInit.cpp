@@ -53,6 +53,9 @@ const char* TxnDBInit[] =
     );",
     "CREATE INDEX AcctTxIDIndex ON              \
         AccountTransactions(TransID);",
+
+    // Covers account_tx paging: marker-based resume seeks directly to
+    // (Account, LedgerSeq, TxnSeq) without touching the table
     "CREATE INDEX AcctTxIndex ON                \
         AccountTransactions(Account, LedgerSeq, TxnSeq, TransID);",
     "CREATE INDEX AcctLgrIndex ON               \
@@ -39,14 +39,78 @@ DatabaseCon::DatabaseCon (Setup const& setup,
 
     for (int i = 0; i < initCount; ++i)
         mDatabase->executeSQL (initStrings[i], true);
+
+    // Extra connections for concurrent reads. The main connection has
+    // already put the database in WAL mode, so these never block the
+    // writer and the writer never blocks them.
+    if (!useTempFiles)
+    {
+        for (int i = 0; i < setup.readers; ++i)
+        {
+            Database* reader = new SqliteDatabase (pPath.string ().c_str ());
+            reader->connect ();
+            mReaders.push_back (reader);
+            mFreeReaders.push_back (reader);
+        }
+    }
 }
 
 DatabaseCon::~DatabaseCon ()
 {
+    for (auto reader : mReaders)
+    {
+        reader->disconnect ();
+        delete reader;
+    }
+
     mDatabase->disconnect ();
     delete mDatabase;
 }
 
+Database* DatabaseCon::checkoutReader ()
+{
+    std::unique_lock <std::mutex> sl (mReaderLock);
+
+    if (mReaders.empty ())
+        return nullptr;
+
+    while (mFreeReaders.empty ())
+        mReaderFreed.wait (sl);
+
+    Database* reader = mFreeReaders.back ();
+    mFreeReaders.pop_back ();
+    return reader;
+}
+
+void DatabaseCon::returnReader (Database* reader)
+{
+    {
+        std::lock_guard <std::mutex> sl (mReaderLock);
+        mFreeReaders.push_back (reader);
+    }
+
+    mReaderFreed.notify_one ();
+}
+
+DatabaseCon::ScopedReader::ScopedReader (DatabaseCon& con)
+    : mCon (con)
+    , mDatabase (con.checkoutReader ())
+{
+    if (mDatabase == nullptr)
+    {
+        // No pool: serialize on the main connection as callers
+        // always used to
+        mFallback = con.lock ();
+        mDatabase = con.getDB ();
+    }
+}
+
+DatabaseCon::ScopedReader::~ScopedReader ()
+{
+    if (!mFallback.owns_lock ())
+        mCon.returnReader (mDatabase);
+}
+
 DatabaseCon::Setup
 setup_DatabaseCon (Config const& c)
 {
@@ -57,6 +121,7 @@ setup_DatabaseCon (Config const& c)
     setup.startUp = c.START_UP;
     setup.standAlone = c.RUN_STANDALONE;
     setup.dataDir = c.DATA_DIR;
+    setup.readers = c.SQLITE_READERS;
 
     return setup;
 }
@@ -22,8 +22,10 @@
 
 #include <ripple/core/Config.h>
 
+#include <condition_variable>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -40,6 +42,9 @@ public:
         Config::StartUpType startUp = Config::NORMAL;
         bool standAlone = false;
         boost::filesystem::path dataDir;
+
+        // Reader connections to pool (0 disables the pool)
+        int readers = 0;
     };
 
     DatabaseCon (Setup const& setup,
@@ -65,9 +70,49 @@ public:
         return mLock;
     }
 
+    /** A connection borrowed from the reader pool.
+
+        The databases run in WAL journal mode, so reads on their own
+        connections proceed concurrently with each other and with the
+        writer instead of serializing on the writer's mutex. If the
+        pool is exhausted the checkout waits for a connection; if there
+        is no pool (standalone temporary databases, or readers disabled
+        by configuration) it falls back to locking the main connection.
+
+        The borrowed connection must only be used to read.
+    */
+    class ScopedReader
+    {
+    public:
+        explicit ScopedReader (DatabaseCon& con);
+        ~ScopedReader ();
+
+        ScopedReader (ScopedReader const&) = delete;
+        ScopedReader& operator= (ScopedReader const&) = delete;
+
+        Database* getDB () const
+        {
+            return mDatabase;
+        }
+
+    private:
+        DatabaseCon& mCon;
+        Database* mDatabase;
+        std::unique_lock <mutex> mFallback;
+    };
+
 private:
+    // Returns nullptr when the pool is disabled
+    Database* checkoutReader ();
+    void returnReader (Database* reader);
+
     Database* mDatabase;
     mutex  mLock;
+
+    std::vector <Database*> mReaders;      // every pooled connection
+    std::vector <Database*> mFreeReaders;  // those not checked out
+    std::mutex mReaderLock;
+    std::condition_variable mReaderFreed;
 };
 
 //------------------------------------------------------------------------------
@@ -18,24 +18,36 @@
 //==============================================================================
 
 #include <ripple/app/impl/BasicApp.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/ThreadAffinity.h>
 
-BasicApp::BasicApp(std::size_t numberOfThreads)
+BasicApp::io_pool::io_pool(char const* name, std::size_t numberOfThreads)
 {
     work_ = boost::in_place(std::ref(io_service_));
     threads_.reserve(numberOfThreads);
     while(numberOfThreads--)
         threads_.emplace_back(
-            [this, numberOfThreads](){
+            [this, name, numberOfThreads](){
                 beast::Thread::setCurrentThreadName(
-                    std::string("io_service #") +
+                    std::string("io ") + name + " #" +
                         std::to_string(numberOfThreads));
+                ripple::setCurrentThreadAffinity(
+                    ripple::getConfig().IO_WORKERS_AFFINITY);
                 this->io_service_.run();
             });
 }
 
-BasicApp::~BasicApp()
+BasicApp::io_pool::~io_pool()
 {
     work_ = boost::none;
     for (auto& _ : threads_)
         _.join();
 }
+
+BasicApp::BasicApp(std::size_t networkThreads, std::size_t clientThreads,
+    std::size_t backgroundThreads)
+    : network_("network", networkThreads)
+    , client_("client", clientThreads)
+    , background_("background", backgroundThreads)
+{
+}
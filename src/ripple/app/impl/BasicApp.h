@@ -25,23 +25,63 @@
 #include <thread>
 #include <vector>
 
-// This is so that the io_service can outlive all the children
+// This is so that the io_services can outlive all the children.
+//
+// Each traffic class runs on its own pool so a burst on one cannot
+// starve another: overlay peer sockets, client-facing RPC and
+// websocket servers, and timers/background services. A crawler
+// hammering the RPC port or a storm of TLS handshakes then never
+// queues ahead of consensus-critical peer messages.
 class BasicApp
 {
 private:
-    boost::optional<boost::asio::io_service::work> work_;
-    std::vector<std::thread> threads_;
-    boost::asio::io_service io_service_;
+    class io_pool
+    {
+    private:
+        boost::optional<boost::asio::io_service::work> work_;
+        std::vector<std::thread> threads_;
+        boost::asio::io_service io_service_;
+
+    public:
+        io_pool(char const* name, std::size_t numberOfThreads);
+        ~io_pool();
+
+        boost::asio::io_service&
+        get()
+        {
+            return io_service_;
+        }
+    };
+
+    io_pool network_;
+    io_pool client_;
+    io_pool background_;
 
 protected:
-    BasicApp(std::size_t numberOfThreads);
-    ~BasicApp();
+    BasicApp(std::size_t networkThreads, std::size_t clientThreads,
+        std::size_t backgroundThreads);
+    ~BasicApp() = default;
 
 public:
+    /** The pool carrying overlay peer sockets. */
     boost::asio::io_service&
     get_io_service()
     {
-        return io_service_;
+        return network_.get();
+    }
+
+    /** The pool carrying the RPC and websocket servers. */
+    boost::asio::io_service&
+    get_client_io_service()
+    {
+        return client_.get();
+    }
+
+    /** The pool carrying timers and background services. */
+    boost::asio::io_service&
+    get_background_io_service()
+    {
+        return background_.get();
     }
 };
 
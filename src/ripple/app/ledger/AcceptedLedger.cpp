@@ -39,6 +39,14 @@ AcceptedLedger::AcceptedLedger (Ledger::ref ledger) : mLedger (ledger)
         SerializerIterator sit (item->peekSerializer ());
         insert (std::make_shared<AcceptedLedgerTx> (ledger, std::ref (sit)));
     }
+
+    // Invert the affected-account lists, walking the transactions in
+    // order so each account's list comes out in transaction order
+    for (auto const& it : mMap)
+    {
+        for (auto const& address : it.second->getAffected ())
+            mAffectedIndex[address.getAccountID ()].push_back (it.second);
+    }
 }
 
 AcceptedLedger::pointer AcceptedLedger::makeAcceptedLedger (Ledger::ref ledger)
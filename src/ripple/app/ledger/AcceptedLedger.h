@@ -46,6 +46,8 @@ public:
     typedef std::map<int, AcceptedLedgerTx::pointer>    map_t;              // Must be an ordered map!
     typedef map_t::value_type                       value_type;
     typedef map_t::const_iterator                   const_iterator;
+    typedef hash_map<Account,
+        std::vector<AcceptedLedgerTx::pointer>>     affected_map_t;
 
 public:
     static pointer makeAcceptedLedger (Ledger::ref ledger);
@@ -63,6 +65,16 @@ public:
         return mMap;
     }
 
+    /** Each account affected in this ledger, with the transactions
+        that touched it in transaction order. Built once from the
+        metadata so publishers and history queries can go straight
+        from an account to its transactions.
+    */
+    affected_map_t const& getAffectedIndex () const
+    {
+        return mAffectedIndex;
+    }
+
     int getLedgerSeq () const
     {
         return mLedger->getLedgerSeq ();
@@ -89,6 +101,7 @@ private:
 
     Ledger::pointer     mLedger;
     map_t               mMap;
+    affected_map_t      mAffectedIndex;
 };
 
 } // ripple
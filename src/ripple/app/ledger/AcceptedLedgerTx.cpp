@@ -62,7 +62,7 @@ AcceptedLedgerTx::AcceptedLedgerTx (Ledger::ref ledger,
 std::string AcceptedLedgerTx::getEscMeta () const
 {
     assert (!mRawMeta.empty ());
-    return sqlEscape (mRawMeta);
+    return sqlEscape (compressTxnMeta (mRawMeta));
 }
 
 void AcceptedLedgerTx::buildJson ()
@@ -92,6 +92,10 @@ public:
         return mMeta ? mMeta->getIndex () : 0;
     }
     std::string getEscMeta () const;
+    Blob const& getRawMeta () const
+    {
+        return mRawMeta;
+    }
     Json::Value getJson () const
     {
         return mJson;
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/AccountItemsCache.h>
+
+namespace ripple {
+
+AccountItemsCache& AccountItemsCache::instance ()
+{
+    static AccountItemsCache cache;
+    return cache;
+}
+
+bool AccountItemsCache::isCurrent (uint256 const& ledgerHash) const
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    return ledgerHash.isNonZero () && (ledgerHash == m_ledgerHash);
+}
+
+AccountItemsCache::Items AccountItemsCache::fetch (
+    Account const& account, uint256 const& ledgerHash)
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    if (ledgerHash.isZero () || (ledgerHash != m_ledgerHash))
+        return Items ();
+
+    auto const iter = m_entries.find (account);
+
+    if (iter == m_entries.end ())
+        return Items ();
+
+    iter->second.lastUse = m_generation;
+    return iter->second.items;
+}
+
+void AccountItemsCache::insert (Account const& account,
+    uint256 const& ledgerHash, Items const& items)
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    // A ledger accepted while the snapshot was being built may have
+    // changed this account, so only entries from the latest one count
+    if (ledgerHash.isZero () || (ledgerHash != m_ledgerHash))
+        return;
+
+    if (m_entries.size () >= maxEntries)
+        m_entries.clear ();
+
+    Entry& entry = m_entries[account];
+    entry.items = items;
+    entry.lastUse = m_generation;
+}
+
+void AccountItemsCache::onLedgerAccepted (
+    hash_set <Account> const& touched, uint256 const& ledgerHash)
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    ++m_generation;
+    m_ledgerHash = ledgerHash;
+
+    for (auto iter = m_entries.begin (); iter != m_entries.end ();)
+    {
+        if ((touched.count (iter->first) != 0) ||
+            ((m_generation - iter->second.lastUse) > maxIdle))
+        {
+            iter = m_entries.erase (iter);
+        }
+        else
+            ++iter;
+    }
+}
+
+bool AccountItemsCache::visitItems (Items const& items,
+    uint256 const& startAfter, unsigned int limit,
+    std::function <bool (SLE::ref)> const& func)
+{
+    bool found (startAfter.isZero ());
+
+    for (auto const& sle : *items)
+    {
+        if (! found)
+        {
+            if (sle->getIndex () == startAfter)
+                found = true;
+        }
+        else if (func (sle) && limit-- <= 1)
+            break;
+    }
+
+    return found;
+}
+
+} // ripple
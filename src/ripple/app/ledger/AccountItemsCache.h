@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_ACCOUNTITEMSCACHE_H
+#define RIPPLE_ACCOUNTITEMSCACHE_H
+
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Cross-request cache of account owner directory items.
+
+    Paging through a big account's trust lines or offers walks the
+    owner directory and fetches every entry out of the state map again
+    on every page. This cache keeps the decoded entries of recently
+    queried accounts, in directory order, so repeated enumerations and
+    markered pages are served from memory.
+
+    An entry reflects the latest accepted ledger and stays valid, as
+    accepted ledgers advance, until a transaction's metadata touches
+    the account; idle entries age out. Queries against other ledgers
+    simply miss.
+
+    Thread safe.
+*/
+class AccountItemsCache
+{
+public:
+    typedef std::shared_ptr <std::vector <SLE::pointer> const> Items;
+
+    static AccountItemsCache& instance ();
+
+    /** Returns `true` if the given ledger is the one entries reflect. */
+    bool isCurrent (uint256 const& ledgerHash) const;
+
+    /** Look up an account's owner directory items.
+        @param ledgerHash The hash of the ledger being queried.
+        @return The items, or an empty pointer on a miss.
+    */
+    Items fetch (Account const& account, uint256 const& ledgerHash);
+
+    /** Remember items gathered from the given ledger.
+        Ignored if the ledger is no longer the latest accepted one.
+    */
+    void insert (Account const& account, uint256 const& ledgerHash,
+        Items const& items);
+
+    /** Apply one accepted ledger's touched accounts.
+        Invalidates every touched account's entry and ages out entries
+        that have not been used recently.
+    */
+    void onLedgerAccepted (hash_set <Account> const& touched,
+        uint256 const& ledgerHash);
+
+    /** Visit a snapshot with Ledger::visitAccountItems semantics.
+        Skips items through `startAfter` if it is nonzero, then calls
+        `func` until it has accepted `limit` items.
+        @return `false` if a nonzero `startAfter` was not found.
+    */
+    static bool visitItems (Items const& items, uint256 const& startAfter,
+        unsigned int limit, std::function <bool (SLE::ref)> const& func);
+
+private:
+    struct Entry
+    {
+        Items items;
+        std::uint32_t lastUse;
+    };
+
+    // Entries unused for this many accepted ledgers age out
+    static std::uint32_t const maxIdle = 32;
+
+    // Sweep everything rather than grow without bound
+    static std::size_t const maxEntries = 64;
+
+    AccountItemsCache ()
+        : m_generation (0)
+    {
+    }
+
+    std::mutex mutable m_mutex;
+    hash_map <Account, Entry> m_entries;
+    uint256 m_ledgerHash;
+    std::uint32_t m_generation;
+};
+
+} // ripple
+
+#endif
@@ -35,7 +35,7 @@ void BookListeners::removeSubscriber (std::uint64_t seq)
 
 void BookListeners::publish (Json::Value const& jvObj)
 {
-    std::string sObj = to_string (jvObj);
+    auto sObj = std::make_shared <std::string const> (to_string (jvObj));
 
     ScopedLockType sl (mLock);
     NetworkOPs::SubMapType::const_iterator it = mListeners.begin ();
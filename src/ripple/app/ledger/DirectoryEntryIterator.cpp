@@ -62,6 +62,9 @@ bool DirectoryEntryIterator::nextEntry (LedgerEntrySet& les)
             mEntryIndex.zero();
             return false;
         }
+
+        // Start reads for this page's entries before we walk them
+        les.dirPrefetch (mRootIndex, mDirNode);
     }
 
     if (!les.dirNext (mRootIndex, mDirNode, mEntry, mEntryIndex))
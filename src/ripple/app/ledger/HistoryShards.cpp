@@ -0,0 +1,577 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/HistoryShards.h>
+#include <ripple/core/LoadFeeTrack.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <beast/threads/Thread.h>
+#include <beast/cxx14/memory.h> // <memory>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace ripple {
+
+/*
+
+HistoryShards
+
+Divides history into deterministic fixed-range shards and acquires the
+shards this server is configured to hold. A shard is acquired backwards:
+the hash of its last ledger is taken from the validated chain, every
+earlier ledger is vouched for by its child's parent hash, and each
+ledger is obtained through the regular inbound ledger machinery, so a
+completed shard is verifiable without trusting the peer that supplied
+any part of it.
+
+Within a shard the last ledger's full state is stored and every earlier
+ledger contributes only the nodes absent from its child, which is the
+same deduplication consecutive ledgers get from sharing a node store.
+
+*/
+
+enum
+{
+    // Acquisition poll interval while there is nothing to do
+    shardPollMilliseconds = 1000
+};
+
+class HistoryShardsImp
+    : public HistoryShards
+    , public beast::Thread
+    , public beast::LeakChecked <HistoryShardsImp>
+{
+public:
+    struct Shard
+    {
+        std::uint32_t index;
+
+        // Next ledger to copy, walking backwards; acquisition is done
+        // once this passes below the front of the shard's range.
+        LedgerIndex nextSeq;
+
+        // The known correct hash of nextSeq, zero until anchored
+        uint256 nextHash;
+
+        bool complete;
+
+        // The child of the last copied ledger, kept so the next copy
+        // stores a state delta. Not persisted: after a restart the
+        // first copy falls back to a full state, which is correct but
+        // larger.
+        Ledger::pointer lastCopied;
+
+        std::unique_ptr <NodeStore::Database> db;
+
+        Shard (std::uint32_t index_)
+            : index (index_)
+            , nextSeq (HistoryShards::lastLedgerSeq (index_))
+            , complete (false)
+        {
+        }
+    };
+
+    struct State
+    {
+        State ()
+            : ledgersCopied (0)
+        {
+        }
+
+        std::map <std::uint32_t, std::shared_ptr <Shard>> shards;
+        std::uint64_t ledgersCopied;
+    };
+
+    typedef beast::SharedData <State> SharedState;
+
+    SharedState m_state;
+    beast::Journal m_journal;
+    NodeStore::DummyScheduler m_scheduler;
+
+    // Configuration, fixed at construction
+    std::string m_path;
+    int m_maxShards;
+
+    //--------------------------------------------------------------------------
+
+    HistoryShardsImp (
+        Stoppable& stoppable,
+        beast::Journal journal)
+        : HistoryShards (stoppable)
+        , Thread ("HistoryShards")
+        , m_journal (journal)
+        , m_maxShards (1)
+    {
+        auto const& config = getConfig ().shardDatabase;
+
+        m_path = config ["path"].toStdString ();
+
+        if (config ["max_shards"].isNotEmpty ())
+            m_maxShards = std::max (1, config ["max_shards"].getIntValue ());
+    }
+
+    ~HistoryShardsImp ()
+    {
+        stopThread ();
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // Stoppable
+    //
+    //--------------------------------------------------------------------------
+
+    void onPrepare ()
+    {
+    }
+
+    void onStart ()
+    {
+        if (! m_path.empty ())
+            startThread ();
+    }
+
+    void onStop ()
+    {
+        if (! isThreadRunning ())
+        {
+            stopped ();
+            return;
+        }
+
+        m_journal.info << "Stopping";
+        signalThreadShouldExit ();
+        notify ();
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // PropertyStream
+    //
+    //--------------------------------------------------------------------------
+
+    void onWrite (beast::PropertyStream::Map& map)
+    {
+        SharedState::Access state (m_state);
+
+        map["max_shards"] = m_maxShards;
+        map["ledgers_copied"] = static_cast <std::uint32_t> (
+            state->ledgersCopied);
+
+        std::ostringstream held;
+
+        for (auto const& entry : state->shards)
+        {
+            auto const& shard = *entry.second;
+
+            if (! shard.complete)
+            {
+                map["acquiring"] = shard.index;
+                map["ledgers_left"] = shard.nextSeq -
+                    firstLedgerSeq (shard.index) + 1;
+                continue;
+            }
+
+            if (held.tellp () > 0)
+                held << ",";
+            held << shard.index;
+        }
+
+        map["complete"] = held.str ();
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // HistoryShards
+    //
+    //--------------------------------------------------------------------------
+
+    bool hasLedger (LedgerIndex seq)
+    {
+        SharedState::Access state (m_state);
+        auto const it = state->shards.find (seqToShardIndex (seq));
+        return (it != state->shards.end ()) && it->second->complete;
+    }
+
+    NodeObject::pointer fetch (uint256 const& hash)
+    {
+        // Collect the completed shards under the lock, query outside it.
+        // Shards are never destroyed before shutdown.
+        std::vector <std::shared_ptr <Shard>> complete;
+        {
+            SharedState::Access state (m_state);
+
+            for (auto const& entry : state->shards)
+                if (entry.second->complete)
+                    complete.push_back (entry.second);
+        }
+
+        for (auto const& shard : complete)
+        {
+            NodeObject::pointer object = shard->db->fetch (hash);
+
+            if (object)
+                return object;
+        }
+
+        return NodeObject::pointer ();
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // HistoryShardsImp
+    //
+    //--------------------------------------------------------------------------
+
+    void run ()
+    {
+        m_journal.debug << "Started";
+
+        openShards ();
+
+        while (! this->threadShouldExit ())
+        {
+            this->wait (shardPollMilliseconds);
+            if (! this->threadShouldExit ())
+                doAcquire ();
+        }
+
+        stopped ();
+    }
+
+    std::string shardDir (std::uint32_t index) const
+    {
+        return (boost::filesystem::path (m_path) /
+            std::to_string (index)).string ();
+    }
+
+    /** Open a shard's NodeStore database.
+        The backend defaults to the one the main node store uses.
+    */
+    std::unique_ptr <NodeStore::Database> openDatabase (std::uint32_t index)
+    {
+        NodeStore::Parameters parameters (getConfig ().shardDatabase);
+        parameters.set ("path", shardDir (index).c_str ());
+
+        if (! parameters ["type"].isNotEmpty ())
+            parameters.set ("type", getConfig ().nodeDatabase ["type"]);
+
+        return getApp ().getNodeStoreManager ().make_Database (
+            "shard" + std::to_string (index), m_scheduler, m_journal, 0,
+                parameters);
+    }
+
+    /** Record a shard's acquisition cursor so a restart resumes it. */
+    void writeControl (Shard const& shard)
+    {
+        std::string const file = (boost::filesystem::path (
+            shardDir (shard.index)) / "control.txt").string ();
+
+        std::ofstream out (file.c_str (), std::ios::trunc);
+
+        if (! out)
+        {
+            m_journal.warning << "Cannot write " << file;
+            return;
+        }
+
+        if (shard.complete)
+            out << "complete\n";
+        else
+            out << shard.nextSeq << " " << to_string (shard.nextHash) << "\n";
+    }
+
+    /** Open the shards already on disk, resuming unfinished ones. */
+    void openShards ()
+    {
+        if (! boost::filesystem::is_directory (m_path))
+            return;
+
+        for (boost::filesystem::directory_iterator it (m_path), end;
+            it != end; ++it)
+        {
+            std::string const name = it->path ().filename ().string ();
+
+            std::uint32_t index;
+            try
+            {
+                index = beast::lexicalCastThrow <std::uint32_t> (name);
+            }
+            catch (...)
+            {
+                continue;
+            }
+
+            auto shard = std::make_shared <Shard> (index);
+
+            std::string const file =
+                (it->path () / "control.txt").string ();
+            std::ifstream in (file.c_str ());
+
+            std::string word;
+            if (! (in >> word))
+            {
+                m_journal.warning << "Shard " << index <<
+                    " has no control file; reacquiring";
+            }
+            else if (word == "complete")
+            {
+                shard->complete = true;
+                shard->nextSeq = 0;
+            }
+            else
+            {
+                std::string hash;
+                in >> hash;
+                shard->nextSeq = beast::lexicalCast <std::uint32_t> (word, 0);
+                shard->nextHash.SetHex (hash);
+
+                if ((shard->nextSeq < firstLedgerSeq (index)) ||
+                    (shard->nextSeq > lastLedgerSeq (index)))
+                {
+                    m_journal.warning << "Shard " << index <<
+                        " has a bad control file; reacquiring";
+                    shard->nextSeq = lastLedgerSeq (index);
+                    shard->nextHash.zero ();
+                }
+            }
+
+            try
+            {
+                shard->db = openDatabase (index);
+            }
+            catch (std::exception const& e)
+            {
+                m_journal.error << "Cannot open shard " << index <<
+                    ": " << e.what ();
+                continue;
+            }
+
+            m_journal.info << "Opened shard " << index <<
+                (shard->complete ? " (complete)" : " (incomplete)");
+
+            SharedState::Access state (m_state);
+            state->shards[index] = shard;
+        }
+    }
+
+    /** Returns the shard being acquired, selecting one if necessary. */
+    std::shared_ptr <Shard> getAcquireShard ()
+    {
+        {
+            SharedState::Access state (m_state);
+
+            for (auto const& entry : state->shards)
+                if (! entry.second->complete)
+                    return entry.second;
+
+            if (state->shards.size () >=
+                    static_cast <std::size_t> (m_maxShards))
+                return std::shared_ptr <Shard> ();
+        }
+
+        // Choose a random shard whose range the validated chain has
+        // fully passed, so every server holding N shards picks an
+        // independent sample of history.
+        Ledger::pointer validated =
+            getApp ().getLedgerMaster ().getValidatedLedger ();
+
+        if (! validated)
+            return std::shared_ptr <Shard> ();
+
+        std::uint32_t const frontier =
+            seqToShardIndex (validated->getLedgerSeq ());
+
+        std::vector <std::uint32_t> candidates;
+        {
+            SharedState::Access state (m_state);
+
+            for (std::uint32_t i = 0; i < frontier; ++i)
+                if (state->shards.find (i) == state->shards.end ())
+                    candidates.push_back (i);
+        }
+
+        if (candidates.empty ())
+            return std::shared_ptr <Shard> ();
+
+        std::uint32_t const index = candidates[rand () % candidates.size ()];
+
+        auto shard = std::make_shared <Shard> (index);
+
+        try
+        {
+            boost::filesystem::create_directories (shardDir (index));
+            shard->db = openDatabase (index);
+        }
+        catch (std::exception const& e)
+        {
+            m_journal.error << "Cannot create shard " << index <<
+                ": " << e.what ();
+            return std::shared_ptr <Shard> ();
+        }
+
+        m_journal.info << "Acquiring shard " << index <<
+            " (ledgers " << firstLedgerSeq (index) <<
+            "-" << lastLedgerSeq (index) << ")";
+        writeControl (*shard);
+
+        SharedState::Access state (m_state);
+        state->shards[index] = shard;
+        return shard;
+    }
+
+    /** Copy one ledger into its shard's database.
+        @param child The already copied child ledger, or null to copy
+                     the full state.
+        @return `true` if every node was copied.
+    */
+    bool copyLedger (NodeStore::Database& db, Ledger::ref ledger,
+        Ledger::ref child)
+    {
+        std::uint32_t const seq = ledger->getLedgerSeq ();
+
+        auto copier = [&db, seq](NodeObjectType type)
+        {
+            return [&db, seq, type](uint256 const& hash, Blob&& data)
+            {
+                db.store (type, seq, std::move (data), hash);
+            };
+        };
+
+        try
+        {
+            if (ledger->getTransHash ().isNonZero ())
+                ledger->peekTransactionMap ()->getFetchPack (
+                    nullptr, true, std::numeric_limits <int>::max (),
+                        copier (hotTRANSACTION_NODE));
+
+            if (ledger->getAccountHash ().isNonZero ())
+                ledger->peekAccountStateMap ()->getFetchPack (
+                    child ? child->peekAccountStateMap ().get () : nullptr,
+                        true, std::numeric_limits <int>::max (),
+                            copier (hotACCOUNT_NODE));
+        }
+        catch (SHAMapMissingNode&)
+        {
+            m_journal.warning << "Ledger " << seq <<
+                " is missing nodes; refetching";
+            getApp ().getInboundLedgers ().findCreate (
+                ledger->getHash (), seq, InboundLedger::fcGENERIC);
+            return false;
+        }
+
+        // The header goes in last: its presence implies the rest of
+        // the ledger made it in.
+        Serializer s (256);
+        s.add32 (HashPrefix::ledgerMaster);
+        ledger->addRaw (s);
+        db.store (hotLEDGER, seq, std::move (s.modData ()),
+            ledger->getHash ());
+
+        return true;
+    }
+
+    /** Advance the current shard, copying as many ledgers as possible.
+        Returns when the next ledger is not yet available; the inbound
+        fetch it triggers completes in the background and the next poll
+        picks up from here.
+    */
+    void doAcquire ()
+    {
+        auto shard = getAcquireShard ();
+
+        if (! shard)
+            return;
+
+        while (! this->threadShouldExit () &&
+            ! getApp ().getFeeTrack ().isLoadedLocal ())
+        {
+            if (shard->nextHash.isZero ())
+            {
+                // Anchor the shard's last ledger to the validated chain
+                shard->nextHash =
+                    getApp ().getLedgerMaster ().walkHashBySeq (
+                        shard->nextSeq);
+
+                if (shard->nextHash.isZero ())
+                    return;
+            }
+
+            Ledger::pointer ledger =
+                getApp ().getLedgerMaster ().findAcquireLedger (
+                    shard->nextSeq, shard->nextHash);
+
+            if (! ledger)
+                return;
+
+            if (! copyLedger (*shard->db, ledger, shard->lastCopied))
+                return;
+
+            shard->lastCopied = ledger;
+            shard->nextHash = ledger->getParentHash ();
+            --shard->nextSeq;
+
+            bool const complete = shard->nextSeq < firstLedgerSeq (
+                shard->index);
+
+            {
+                SharedState::Access state (m_state);
+                ++state->ledgersCopied;
+
+                if (complete)
+                {
+                    shard->complete = true;
+                    shard->lastCopied.reset ();
+                }
+            }
+
+            writeControl (*shard);
+
+            if (complete)
+            {
+                m_journal.info << "Shard " << shard->index << " complete";
+                return;
+            }
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+HistoryShards::HistoryShards (Stoppable& parent)
+    : Stoppable ("HistoryShards", parent)
+    , beast::PropertyStream::Source ("shards")
+{
+}
+
+HistoryShards::~HistoryShards ()
+{
+}
+
+std::unique_ptr<HistoryShards>
+make_HistoryShards (beast::Stoppable& parent, beast::Journal journal)
+{
+    return std::make_unique <HistoryShardsImp> (parent, journal);
+}
+
+} // ripple
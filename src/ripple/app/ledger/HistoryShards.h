@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_HISTORYSHARDS_H_INCLUDED
+#define RIPPLE_HISTORYSHARDS_H_INCLUDED
+
+#include <ripple/nodestore/NodeObject.h>
+#include <ripple/protocol/Protocol.h>
+#include <beast/cxx14/memory.h> // <memory>
+#include <beast/threads/Stoppable.h>
+#include <beast/utility/PropertyStream.h>
+#include <beast/utility/Journal.h>
+
+namespace ripple {
+
+/** Holds deterministic fixed-range slices of ledger history.
+
+    History is divided into shards of exactly ledgersPerShard ledgers
+    apiece, so every server agrees on which ledgers belong to which
+    shard. Each shard this server is configured to hold is a
+    self-contained NodeStore database: the headers, transactions and
+    state nodes of its entire ledger range, acquired backwards from the
+    validated chain so each ledger's hash is vouched for by its child.
+
+    A history cluster configures each member to hold a bounded number
+    of randomly chosen shards, spreading full history across the
+    cluster instead of replicating all of it on every server. Completed
+    shards answer local node store misses; see Database::setMissHandler.
+*/
+class HistoryShards
+    : public beast::Stoppable
+    , public beast::PropertyStream::Source
+{
+protected:
+    explicit HistoryShards (Stoppable& parent);
+
+public:
+    /** The number of ledgers every shard spans.
+        This is a protocol-level constant: changing it changes which
+        ledgers belong to which shard and invalidates existing shards.
+    */
+    static std::uint32_t const ledgersPerShard = 16384;
+
+    /** Returns the index of the shard containing a ledger. */
+    static std::uint32_t seqToShardIndex (LedgerIndex seq)
+    {
+        return (seq - 1) / ledgersPerShard;
+    }
+
+    /** Returns the sequence of the first ledger in a shard. */
+    static LedgerIndex firstLedgerSeq (std::uint32_t shardIndex)
+    {
+        return (shardIndex * ledgersPerShard) + 1;
+    }
+
+    /** Returns the sequence of the last ledger in a shard. */
+    static LedgerIndex lastLedgerSeq (std::uint32_t shardIndex)
+    {
+        return (shardIndex + 1) * ledgersPerShard;
+    }
+
+    /** Destroy the object. */
+    virtual ~HistoryShards () = 0;
+
+    /** Returns `true` if the ledger is in a completely acquired shard. */
+    virtual bool hasLedger (LedgerIndex seq) = 0;
+
+    /** Look up a node object in the completely acquired shards.
+
+        Thread safety:
+            Safe to call from any thread at any time.
+
+        @return The object, or nullptr if no held shard contains it.
+    */
+    virtual NodeObject::pointer fetch (uint256 const& hash) = 0;
+};
+
+std::unique_ptr<HistoryShards> make_HistoryShards (beast::Stoppable& parent,
+    beast::Journal journal);
+
+} // ripple
+
+#endif
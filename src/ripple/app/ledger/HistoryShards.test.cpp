@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/HistoryShards.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class HistoryShards_test : public beast::unit_test::suite
+{
+public:
+    void testBoundaries ()
+    {
+        testcase ("shard boundaries");
+
+        std::uint32_t const lps = HistoryShards::ledgersPerShard;
+
+        // The genesis ledger opens shard zero
+        expect (HistoryShards::seqToShardIndex (1) == 0);
+        expect (HistoryShards::firstLedgerSeq (0) == 1);
+        expect (HistoryShards::lastLedgerSeq (0) == lps);
+
+        // Boundaries land on consecutive shards with no gap or overlap
+        expect (HistoryShards::seqToShardIndex (lps) == 0);
+        expect (HistoryShards::seqToShardIndex (lps + 1) == 1);
+        expect (HistoryShards::firstLedgerSeq (1) == lps + 1);
+
+        for (std::uint32_t shard = 0; shard < 5; ++shard)
+        {
+            expect (HistoryShards::lastLedgerSeq (shard) + 1 ==
+                HistoryShards::firstLedgerSeq (shard + 1));
+            expect (HistoryShards::seqToShardIndex (
+                HistoryShards::firstLedgerSeq (shard)) == shard);
+            expect (HistoryShards::seqToShardIndex (
+                HistoryShards::lastLedgerSeq (shard)) == shard);
+        }
+    }
+
+    void run ()
+    {
+        testBoundaries ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HistoryShards,ripple_app,ripple);
+
+} // ripple
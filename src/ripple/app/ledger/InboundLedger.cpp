@@ -20,11 +20,13 @@
 #include <ripple/app/shamap/SHAMapNodeID.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/SyncGovernor.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/nodestore/Database.h>
 #include <boost/foreach.hpp>
+#include <algorithm>
 
 namespace ripple {
 
@@ -38,6 +40,18 @@ enum
 
     // how many timeouts before we get aggressive
     ,ledgerBecomeAggressiveThreshold = 6
+
+    // how many missing nodes to find at a time
+    ,missingNodesFrontier = 512
+
+    // the most nodes we request from one peer at a time
+    ,peerNodeRequestMax = 128
+
+    // the starting per-peer request window
+    ,peerNodeRequestMin = 16
+
+    // how deep into each subtree we ask a peer to go
+    ,ledgerQueryDepth = 3
 };
 
 InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason reason,
@@ -260,6 +274,11 @@ void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
         mAggressive = true;
         mByHash = true;
 
+        // Shrink every peer's request window so the next pass
+        // rebalances toward whoever is still delivering
+        for (auto& it : mPeers)
+            it.second /= 2;
+
         std::size_t pc = getPeerCount ();
         WriteLog (lsDEBUG, InboundLedger) <<
             "No progress(" << pc <<
@@ -423,6 +442,16 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         return;
     }
 
+    if (((mReason == fcHISTORY) || (mReason == fcGENERIC)) &&
+        ! SyncGovernor::mayRequest ())
+    {
+        // Over the configured sync budget. Skip this pass; the
+        // acquire timer will bring us back.
+        if (m_journal.debug) m_journal.debug <<
+            "Deferring acquire of " << mHash << ": over sync budget";
+        return;
+    }
+
     if (m_journal.trace)
     {
         if (peer)
@@ -550,6 +579,7 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             // we need the root node
             tmGL.set_itype (protocol::liAS_NODE);
+            tmGL.set_querydepth (ledgerQueryDepth);
             *tmGL.add_nodeids () = SHAMapNodeID ().getRawString ();
             if (m_journal.trace) m_journal.trace <<
                 "Sending AS root request to " << (peer ? "selected peer" : "all peers");
@@ -560,15 +590,14 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            // VFALCO Why 256? Make this a constant
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            nodeIDs.reserve (missingNodesFrontier);
+            nodeHashes.reserve (missingNodesFrontier);
             AccountStateSF filter (mSeq);
 
             // Release the lock while we process the large state map
             sl.unlock();
             mLedger->peekAccountStateMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, missingNodesFrontier, &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -588,25 +617,21 @@ void InboundLedger::trigger (Peer::ptr const& peer)
                 }
                 else
                 {
-                    // VFALCO Why 128? Make this a constant
                     if (!mAggressive)
                         filterNodes (nodeIDs, nodeHashes, mRecentASNodes,
-                            128, !isProgress ());
+                            missingNodesFrontier, !isProgress ());
 
                     if (!nodeIDs.empty ())
                     {
                         tmGL.set_itype (protocol::liAS_NODE);
-                        BOOST_FOREACH (SHAMapNodeID const& it, nodeIDs)
-                        {
-                            * (tmGL.add_nodeids ()) = it.getRawString ();
-                        }
+                        tmGL.set_querydepth (ledgerQueryDepth);
                         if (m_journal.trace) m_journal.trace <<
                             "Sending AS node " << nodeIDs.size () <<
                                 " request to " << (
-                                    peer ? "selected peer" : "all peers");
+                                    peer ? "selected peer" : "our peers");
                         if (nodeIDs.size () == 1 && m_journal.trace) m_journal.trace <<
                             "AS node: " << nodeIDs[0];
-                        sendRequest (tmGL, peer);
+                        requestNodes (tmGL, nodeIDs, peer);
                         return;
                     }
                     else
@@ -629,6 +654,7 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             // we need the root node
             tmGL.set_itype (protocol::liTX_NODE);
+            tmGL.set_querydepth (ledgerQueryDepth);
             * (tmGL.add_nodeids ()) = SHAMapNodeID ().getRawString ();
             if (m_journal.trace) m_journal.trace <<
                 "Sending TX root request to " << (
@@ -640,11 +666,11 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             std::vector<SHAMapNodeID> nodeIDs;
             std::vector<uint256> nodeHashes;
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            nodeIDs.reserve (missingNodesFrontier);
+            nodeHashes.reserve (missingNodesFrontier);
             TransactionStateSF filter (mSeq);
             mLedger->peekTransactionMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, missingNodesFrontier, &filter);
 
             if (nodeIDs.empty ())
             {
@@ -662,20 +688,17 @@ void InboundLedger::trigger (Peer::ptr const& peer)
             {
                 if (!mAggressive)
                     filterNodes (nodeIDs, nodeHashes, mRecentTXNodes,
-                        128, !isProgress ());
+                        missingNodesFrontier, !isProgress ());
 
                 if (!nodeIDs.empty ())
                 {
                     tmGL.set_itype (protocol::liTX_NODE);
-                    BOOST_FOREACH (SHAMapNodeID const& it, nodeIDs)
-                    {
-                        * (tmGL.add_nodeids ()) = it.getRawString ();
-                    }
+                    tmGL.set_querydepth (ledgerQueryDepth);
                     if (m_journal.trace) m_journal.trace <<
                         "Sending TX node " << nodeIDs.size () <<
                         " request to " << (
-                            peer ? "selected peer" : "all peers");
-                    sendRequest (tmGL, peer);
+                            peer ? "selected peer" : "our peers");
+                    requestNodes (tmGL, nodeIDs, peer);
                     return;
                 }
                 else
@@ -696,6 +719,85 @@ void InboundLedger::trigger (Peer::ptr const& peer)
     }
 }
 
+/** Request a batch of nodes, spreading the work across our peers
+
+    When a specific peer is given (normally one that just sent us useful
+    data), the whole batch goes to it. Otherwise the batch is dealt out
+    across the peers in the set, each receiving a slice sized by how
+    productive that peer has been, so a big fetch keeps every peer's
+    link busy instead of serializing on a single round trip. A peer
+    that goes quiet has its window shrunk by the timer, shifting its
+    share to the others on the next pass.
+*/
+void InboundLedger::requestNodes (protocol::TMGetLedger& tmGL,
+    std::vector<SHAMapNodeID> const& nodeIDs, Peer::ptr const& peer)
+{
+    if (peer)
+    {
+        int count = 0;
+
+        BOOST_FOREACH (SHAMapNodeID const& it, nodeIDs)
+        {
+            * (tmGL.add_nodeids ()) = it.getRawString ();
+
+            if (++count >= peerNodeRequestMax)
+                break;
+        }
+
+        sendRequest (tmGL, peer);
+        return;
+    }
+
+    // Collect the live peers in the set, each with its request window.
+    // A peer earns a larger window by delivering useful nodes.
+    std::vector <std::pair <Peer::ptr, int> > peers;
+    peers.reserve (mPeers.size ());
+
+    for (auto const& it : mPeers)
+    {
+        Peer::ptr iPeer (getApp().overlay ().findPeerByShortID (it.first));
+
+        if (iPeer)
+            peers.push_back (std::make_pair (iPeer,
+                peerNodeRequestMin << std::min (
+                    3, it.second / peerNodeRequestMin)));
+    }
+
+    if (peers.empty ())
+        return;
+
+    // Deal the nodes out round robin until every window is full
+    std::vector <protocol::TMGetLedger> requests (peers.size (), tmGL);
+    std::size_t target = rand () % peers.size ();
+
+    BOOST_FOREACH (SHAMapNodeID const& it, nodeIDs)
+    {
+        std::size_t tries = peers.size ();
+
+        while ((tries != 0) && (peers[target].second == 0))
+        {
+            target = (target + 1) % peers.size ();
+            --tries;
+        }
+
+        if (tries == 0)
+        {
+            // every window is full
+            break;
+        }
+
+        * (requests[target].add_nodeids ()) = it.getRawString ();
+        --peers[target].second;
+        target = (target + 1) % peers.size ();
+    }
+
+    for (std::size_t i = 0; i < peers.size (); ++i)
+    {
+        if (requests[i].nodeids_size () != 0)
+            sendRequest (requests[i], peers[i].first);
+    }
+}
+
 void InboundLedger::filterNodes (std::vector<SHAMapNodeID>& nodeIDs,
     std::vector<uint256>& nodeHashes, std::set<SHAMapNodeID>& recentNodes,
     int max, bool aggressive)
@@ -1164,6 +1266,15 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
             if (m_journal.debug) m_journal.debug <<
                 "Peer sends invalid node data";
 
+        // A productive peer earns a larger share of future requests
+        if (ret.getGood () > 0)
+        {
+            auto it = mPeers.find (peer->id ());
+
+            if (it != mPeers.end ())
+                it->second += ret.getGood ();
+        }
+
         return ret.getGood ();
     }
 
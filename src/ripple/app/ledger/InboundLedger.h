@@ -101,6 +101,9 @@ public:
     void filterNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& nodeHashes,
                              std::set<SHAMapNodeID>& recentNodes, int max, bool aggressive);
 
+    void requestNodes (protocol::TMGetLedger& tmGL,
+        std::vector<SHAMapNodeID> const& nodeIDs, Peer::ptr const& peer);
+
     /** Return a Json::objectValue. */
     Json::Value getJson (int);
     void runData ();
@@ -20,6 +20,7 @@
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/SyncGovernor.h>
 #include <beast/cxx14/memory.h> // <memory>
 
 namespace ripple {
@@ -54,41 +55,48 @@ public:
         // Ensure that any previous IL is destroyed outside the lock
         InboundLedger::pointer oldLedger;
 
+        // Move the consensus or validation pin, remembering which
+        // acquire (if any) just lost its pin
+        uint256 stale;
+
         {
-            ScopedLockType sl (mLock);
+            ScopedLockType sl (mPinLock);
 
-            if (! isStopping ())
+            if (reason == InboundLedger::fcCONSENSUS)
             {
+                if (mConsensusLedger.isNonZero() && (mValidationLedger != mConsensusLedger) && (hash != mConsensusLedger))
+                    stale = mConsensusLedger;
+                mConsensusLedger = hash;
+            }
+            else if (reason == InboundLedger::fcVALIDATION)
+            {
+                if (mValidationLedger.isNonZero() && (mValidationLedger != mConsensusLedger) && (hash != mValidationLedger))
+                    stale = mValidationLedger;
+                mValidationLedger = hash;
+            }
+        }
 
-                if (reason == InboundLedger::fcCONSENSUS)
-                {
-                    if (mConsensusLedger.isNonZero() && (mValidationLedger != mConsensusLedger) && (hash != mConsensusLedger))
-                    {
-                        hash_map<uint256, InboundLedger::pointer>::iterator it = mLedgers.find (mConsensusLedger);
-                        if (it != mLedgers.end ())
-                        {
-                            oldLedger = it->second;
-                            mLedgers.erase (it);
-                        }
-                    }
-                    mConsensusLedger = hash;
-                }
-                else if (reason == InboundLedger::fcVALIDATION)
-                {
-                    if (mValidationLedger.isNonZero() && (mValidationLedger != mConsensusLedger) && (hash != mValidationLedger))
-                    {
-                        hash_map<uint256, InboundLedger::pointer>::iterator it = mLedgers.find (mValidationLedger);
-                        if (it != mLedgers.end ())
-                        {
-                            oldLedger = it->second;
-                            mLedgers.erase (it);
-                       }
-                    }
-                    mValidationLedger = hash;
-                }
+        if (stale.isNonZero ())
+        {
+            Shard& s = shard (stale);
+            ScopedLockType sl (s.lock);
+
+            MapType::iterator it = s.ledgers.find (stale);
+            if (it != s.ledgers.end ())
+            {
+                oldLedger = it->second;
+                s.ledgers.erase (it);
+            }
+        }
+
+        {
+            Shard& s = shard (hash);
+            ScopedLockType sl (s.lock);
 
-                hash_map<uint256, InboundLedger::pointer>::iterator it = mLedgers.find (hash);
-                if (it != mLedgers.end ())
+            if (! isStopping ())
+            {
+                MapType::iterator it = s.ledgers.find (hash);
+                if (it != s.ledgers.end ())
                 {
                     ret = it->second;
                     // FIXME: Should set the sequence if it's not set
@@ -97,7 +105,7 @@ public:
                 {
                     ret = std::make_shared <InboundLedger> (hash, seq, reason, std::ref (m_clock));
                     assert (ret);
-                    mLedgers.insert (std::make_pair (hash, ret));
+                    s.ledgers.insert (std::make_pair (hash, ret));
                     ret->init (sl);
                     ++mCounter;
                 }
@@ -114,10 +122,11 @@ public:
         InboundLedger::pointer ret;
 
         {
-            ScopedLockType sl (mLock);
+            Shard& s = shard (hash);
+            ScopedLockType sl (s.lock);
 
-            hash_map<uint256, InboundLedger::pointer>::iterator it = mLedgers.find (hash);
-            if (it != mLedgers.end ())
+            MapType::iterator it = s.ledgers.find (hash);
+            if (it != s.ledgers.end ())
             {
                 ret = it->second;
             }
@@ -130,16 +139,18 @@ public:
     {
         assert (hash.isNonZero ());
 
-        ScopedLockType sl (mLock);
-        return mLedgers.find (hash) != mLedgers.end ();
+        Shard& s = shard (hash);
+        ScopedLockType sl (s.lock);
+        return s.ledgers.find (hash) != s.ledgers.end ();
     }
 
     void dropLedger (LedgerHash const& hash)
     {
         assert (hash.isNonZero ());
 
-        ScopedLockType sl (mLock);
-        mLedgers.erase (hash);
+        Shard& s = shard (hash);
+        ScopedLockType sl (s.lock);
+        s.ledgers.erase (hash);
 
     }
 
@@ -164,6 +175,8 @@ public:
     {
         protocol::TMLedgerData& packet = *packet_ptr;
 
+        SyncGovernor::onLedgerData (packet.ByteSize ());
+
         WriteLog (lsTRACE, InboundLedger) << "Got data (" << packet.nodes ().size () << ") for acquiring ledger: " << hash;
 
         InboundLedger::pointer ledger = find (hash);
@@ -198,11 +211,11 @@ public:
 
         std::vector<u256_acq_pair> inboundLedgers;
 
+        for (int i = 0; i < shardCount; ++i)
         {
-            ScopedLockType sl (mLock);
+            ScopedLockType sl (mShards[i].lock);
 
-            inboundLedgers.reserve(mLedgers.size());
-            for (auto const& it : mLedgers)
+            for (auto const& it : mShards[i].ledgers)
             {
                 inboundLedgers.push_back(it);
             }
@@ -273,10 +286,13 @@ public:
 
     void clearFailures ()
     {
-        ScopedLockType sl (mLock);
-
         mRecentFailures.clear();
-        mLedgers.clear();
+
+        for (int i = 0; i < shardCount; ++i)
+        {
+            ScopedLockType sl (mShards[i].lock);
+            mShards[i].ledgers.clear();
+        }
     }
 
     Json::Value getInfo()
@@ -284,11 +300,11 @@ public:
         Json::Value ret(Json::objectValue);
 
         std::vector<u256_acq_pair> acquires;
+        for (int i = 0; i < shardCount; ++i)
         {
-            ScopedLockType sl (mLock);
+            ScopedLockType sl (mShards[i].lock);
 
-            acquires.reserve (mLedgers.size ());
-            for (auto const& it : mLedgers)
+            for (auto const& it : mShards[i].ledgers)
             {
                 assert (it.second);
                 acquires.push_back (it);
@@ -310,11 +326,11 @@ public:
     void gotFetchPack (Job&)
     {
         std::vector<InboundLedger::pointer> acquires;
+        for (int i = 0; i < shardCount; ++i)
         {
-            ScopedLockType sl (mLock);
+            ScopedLockType sl (mShards[i].lock);
 
-            acquires.reserve (mLedgers.size ());
-            for (auto const& it : mLedgers)
+            for (auto const& it : mShards[i].ledgers)
             {
                 assert (it.second);
                 acquires.push_back (it.second);
@@ -333,16 +349,17 @@ public:
 
         clock_type::time_point const now (m_clock.now());
 
-        // Make a list of things to sweep, while holding the lock
+        // Make a list of things to sweep, while holding each shard's lock
         std::vector <MapType::mapped_type> stuffToSweep;
-        std::size_t total;
+        std::size_t total = 0;
+
+        for (int i = 0; i < shardCount; ++i)
         {
-            ScopedLockType sl (mLock);
-            MapType::iterator it (mLedgers.begin ());
-            total = mLedgers.size ();
-            stuffToSweep.reserve (total);
+            ScopedLockType sl (mShards[i].lock);
+            MapType::iterator it (mShards[i].ledgers.begin ());
+            total += mShards[i].ledgers.size ();
 
-            while (it != mLedgers.end ())
+            while (it != mShards[i].ledgers.end ())
             {
                 if (it->second->getLastAction () > now)
                 {
@@ -354,7 +371,7 @@ public:
                     stuffToSweep.push_back (it->second);
                     // shouldn't cause the actual final delete
                     // since we are holding a reference in the vector.
-                    it = mLedgers.erase (it);
+                    it = mShards[i].ledgers.erase (it);
                 }
                 else
                 {
@@ -370,9 +387,12 @@ public:
 
     void onStop ()
     {
-        ScopedLockType lock (mLock);
+        for (int i = 0; i < shardCount; ++i)
+        {
+            ScopedLockType sl (mShards[i].lock);
+            mShards[i].ledgers.clear();
+        }
 
-        mLedgers.clear();
         mRecentFailures.clear();
 
         stopped();
@@ -385,11 +405,35 @@ private:
 
     typedef RippleRecursiveMutex LockType;
     typedef std::unique_lock <LockType> ScopedLockType;
-    LockType mLock;
 
-    MapType mLedgers;
+    enum
+    {
+        // Acquires are spread over this many independently locked
+        // shards so data routing during heavy sync doesn't convoy
+        // on a single mutex
+        shardCount = 16
+    };
+
+    /** One lock's worth of the acquisition registry. */
+    struct Shard
+    {
+        LockType lock;
+        MapType ledgers;
+    };
+
+    Shard& shard (uint256 const& hash)
+    {
+        // A ledger hash is uniformly distributed, so any one of its
+        // bytes picks a shard fairly
+        return mShards [*hash.begin () % shardCount];
+    }
+
+    Shard mShards [shardCount];
+
     KeyCache <uint256> mRecentFailures;
 
+    // Guards the consensus and validation pins
+    LockType mPinLock;
     uint256 mConsensusLedger;
     uint256 mValidationLedger;
 
@@ -616,7 +616,7 @@ uint256 Ledger::getHash ()
     return mHash;
 }
 
-bool Ledger::saveValidatedLedger (bool current)
+bool Ledger::saveValidatedLedger (bool current, bool ownTransaction)
 {
     // TODO(tom): Fix this hard-coded SQL!
     WriteLog (lsTRACE, Ledger)
@@ -668,6 +668,11 @@ bool Ledger::saveValidatedLedger (bool current)
             hotLEDGER, mLedgerSeq, std::move (s.modData ()), mHash);
     }
 
+    // Record the hash in the flat table so this sequence resolves
+    // without SQLite. checkAccept covers the live chain; this covers
+    // back-filled history as well.
+    getApp().getLedgerHashIndex ().set (mLedgerSeq, mHash);
+
     AcceptedLedger::pointer aLedger;
     try
     {
@@ -686,6 +691,10 @@ bool Ledger::saveValidatedLedger (bool current)
         return false;
     }
 
+    // Record every transaction's metadata in the packed index
+    getApp().getTxMetaIndex ().addLedger (*aLedger);
+
+    if (!getConfig ().LEDGER_INDEX_NODESTORE)
     {
         auto sl (getApp().getLedgerDB ().lock ());
         getApp().getLedgerDB ().getDB ()->executeSQL (
@@ -695,7 +704,9 @@ bool Ledger::saveValidatedLedger (bool current)
     {
         auto db = getApp().getTxnDB ().getDB ();
         auto dbLock (getApp().getTxnDB ().lock ());
-        db->executeSQL ("BEGIN TRANSACTION;");
+
+        if (ownTransaction)
+            db->executeSQL ("BEGIN TRANSACTION;");
 
         db->executeSQL (boost::str (deleteTrans1 % getLedgerSeq ()));
         db->executeSQL (boost::str (deleteTrans2 % getLedgerSeq ()));
@@ -763,9 +774,13 @@ bool Ledger::saveValidatedLedger (bool current)
                 vt.second->getTxn ()->getMetaSQL (
                     getLedgerSeq (), vt.second->getEscMeta ()) + ";");
         }
-        db->executeSQL ("COMMIT TRANSACTION;");
+        if (ownTransaction)
+            db->executeSQL ("COMMIT TRANSACTION;");
     }
 
+    // With the node store index the Ledgers table is dead weight on
+    // the accept path; SQLite keeps only the transaction history.
+    if (!getConfig ().LEDGER_INDEX_NODESTORE)
     {
         auto sl (getApp().getLedgerDB ().lock ());
 
@@ -777,23 +792,149 @@ bool Ledger::saveValidatedLedger (bool current)
                 to_string (mAccountHash) % to_string (mTransHash)));
     }
 
+    if (ownTransaction)
     {
         // Clients can now trust the database for information about this ledger
-        // sequence.
+        // sequence. In a batch the caller erases after the shared commit.
         StaticScopedLockType sl (sPendingSaveLock);
         sPendingSaves.erase(getLedgerSeq());
     }
     return true;
 }
 
+void Ledger::saveValidatedBatch (Job&)
+{
+    for (;;)
+    {
+        std::vector <std::pair <pointer, bool>> batch;
+        {
+            StaticScopedLockType sl (sPendingSaveLock);
+
+            while (!sSaveQueue.empty () && (batch.size () < saveBatchMax))
+            {
+                batch.push_back (sSaveQueue.front ());
+                sSaveQueue.pop_front ();
+            }
+
+            if (batch.empty ())
+            {
+                sSaveInProgress = false;
+                return;
+            }
+
+            CondLog (sSaveQueue.size () > saveQueueWarn, lsWARNING, Ledger)
+                << "Ledger save queue depth " << sSaveQueue.size ()
+                << ", history writing is falling behind";
+        }
+
+        LoadEvent::autoptr event (getApp().getJobQueue ().getLoadEventAP (
+            jtDISK, "LedgerSave"));
+
+        if (batch.size () == 1)
+        {
+            batch.front ().first->saveValidatedLedger (batch.front ().second);
+            continue;
+        }
+
+        // One SQLite transaction, and so one WAL commit, covers the
+        // whole batch
+        std::vector <std::uint32_t> saved;
+        {
+            auto db = getApp().getTxnDB ().getDB ();
+            auto dbLock (getApp().getTxnDB ().lock ());
+            db->executeSQL ("BEGIN TRANSACTION;");
+
+            for (auto const& entry : batch)
+            {
+                if (entry.first->saveValidatedLedger (entry.second, false))
+                    saved.push_back (entry.first->getLedgerSeq ());
+            }
+
+            db->executeSQL ("COMMIT TRANSACTION;");
+        }
+
+        {
+            // Clients can now trust the database for information about
+            // these ledger sequences.
+            StaticScopedLockType sl (sPendingSaveLock);
+
+            for (auto seq : saved)
+                sPendingSaves.erase (seq);
+        }
+    }
+}
+
+// Load a ledger header out of the node store. Returns null if the
+// header is not resident or does not hash as claimed.
+static Ledger::pointer loadHeaderFromNodeStore (uint256 const& ledgerHash)
+{
+    NodeObject::pointer node = getApp().getNodeStore ().fetch (ledgerHash);
+
+    if (!node)
+        return Ledger::pointer ();
+
+    Ledger::pointer ledger = std::make_shared<Ledger> (
+        strCopy (node->getData ()), true);
+
+    if (ledger->getHash () != ledgerHash)
+    {
+        assert (false);
+        return Ledger::pointer ();
+    }
+
+    return ledger;
+}
+
+// Serve a ledger load from the flat hash table and the node store,
+// never touching SQLite. Returns null on any miss; the caller falls
+// back to the Ledgers table.
+static Ledger::pointer loadByIndexFast (std::uint32_t ledgerIndex)
+{
+    uint256 const hash = getApp().getLedgerHashIndex ().get (ledgerIndex);
+
+    if (hash.isZero ())
+        return Ledger::pointer ();
+
+    Ledger::pointer ledger = loadHeaderFromNodeStore (hash);
+
+    if (ledger)
+    {
+        Ledger::getSQL2 (ledger);
+        ledger->setFull ();
+    }
+
+    return ledger;
+}
+
+static Ledger::pointer loadByHashFast (uint256 const& ledgerHash)
+{
+    Ledger::pointer ledger = loadHeaderFromNodeStore (ledgerHash);
+
+    // The header alone does not establish that this ledger is part of
+    // validated history; the flat table records only ledgers that are.
+    if (ledger &&
+        (getApp().getLedgerHashIndex ().get (
+            ledger->getLedgerSeq ()) == ledgerHash))
+    {
+        Ledger::getSQL2 (ledger);
+        ledger->setFull ();
+        return ledger;
+    }
+
+    return Ledger::pointer ();
+}
+
 #ifndef NO_SQLITE3_PREPARE
 
 Ledger::pointer Ledger::loadByIndex (std::uint32_t ledgerIndex)
 {
+    if (Ledger::pointer ledger = loadByIndexFast (ledgerIndex))
+        return ledger;
+
     Ledger::pointer ledger;
     {
-        auto db = getApp().getLedgerDB ().getDB ();
-        auto sl (getApp().getLedgerDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
+        auto db = reader.getDB ();
 
         SqliteStatement pSt (
             db->getSqliteDB (), "SELECT "
@@ -816,10 +957,13 @@ Ledger::pointer Ledger::loadByIndex (std::uint32_t ledgerIndex)
 
 Ledger::pointer Ledger::loadByHash (uint256 const& ledgerHash)
 {
+    if (Ledger::pointer ledger = loadByHashFast (ledgerHash))
+        return ledger;
+
     Ledger::pointer ledger;
     {
-        auto db = getApp().getLedgerDB ().getDB ();
-        auto sl (getApp().getLedgerDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
+        auto db = reader.getDB ();
 
         SqliteStatement pSt (
             db->getSqliteDB (), "SELECT "
@@ -845,6 +989,9 @@ Ledger::pointer Ledger::loadByHash (uint256 const& ledgerHash)
 
 Ledger::pointer Ledger::loadByIndex (std::uint32_t ledgerIndex)
 {
+    if (Ledger::pointer ledger = loadByIndexFast (ledgerIndex))
+        return ledger;
+
     // This is a low-level function with no caching.
     std::string sql = "SELECT * from Ledgers WHERE LedgerSeq='";
     sql.append (beast::lexicalCastThrow <std::string> (ledgerIndex));
@@ -854,6 +1001,9 @@ Ledger::pointer Ledger::loadByIndex (std::uint32_t ledgerIndex)
 
 Ledger::pointer Ledger::loadByHash (uint256 const& ledgerHash)
 {
+    if (Ledger::pointer ledger = loadByHashFast (ledgerHash))
+        return ledger;
+
     // This is a low-level function with no caching and only gets accepted
     // ledgers.
     std::string sql = "SELECT * from Ledgers WHERE LedgerHash='";
@@ -875,8 +1025,8 @@ Ledger::pointer Ledger::getSQL (std::string const& sql)
     std::string hash;
 
     {
-        auto db = getApp().getLedgerDB ().getDB ();
-        auto sl (getApp().getLedgerDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
+        auto db = reader.getDB ();
 
         if (!db->executeSQL (sql) || !db->startIterRows ())
             return Ledger::pointer ();
@@ -991,7 +1141,10 @@ void Ledger::getSQL2 (Ledger::ref ret)
 
 uint256 Ledger::getHashByIndex (std::uint32_t ledgerIndex)
 {
-    uint256 ret;
+    uint256 ret = getApp().getLedgerHashIndex ().get (ledgerIndex);
+
+    if (ret.isNonZero ())
+        return ret;
 
     std::string sql =
         "SELECT LedgerHash FROM Ledgers INDEXED BY SeqLedger WHERE LedgerSeq='";
@@ -1000,8 +1153,8 @@ uint256 Ledger::getHashByIndex (std::uint32_t ledgerIndex)
 
     std::string hash;
     {
-        auto db = getApp().getLedgerDB ().getDB ();
-        auto sl (getApp().getLedgerDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
+        auto db = reader.getDB ();
 
         if (!db->executeSQL (sql) || !db->startIterRows ())
             return ret;
@@ -1017,12 +1170,26 @@ uint256 Ledger::getHashByIndex (std::uint32_t ledgerIndex)
 bool Ledger::getHashesByIndex (
     std::uint32_t ledgerIndex, uint256& ledgerHash, uint256& parentHash)
 {
+    {
+        auto& table = getApp().getLedgerHashIndex ();
+        uint256 const hash = table.get (ledgerIndex);
+        uint256 const parent = table.get (ledgerIndex - 1);
+
+        // Only validated chains are recorded, so the previous entry
+        // is this ledger's parent
+        if (hash.isNonZero () && parent.isNonZero ())
+        {
+            ledgerHash = hash;
+            parentHash = parent;
+            return true;
+        }
+    }
+
 #ifndef NO_SQLITE3_PREPARE
 
-    auto& con = getApp().getLedgerDB ();
-    auto sl (con.lock ());
+    DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
 
-    SqliteStatement pSt (con.getDB ()->getSqliteDB (),
+    SqliteStatement pSt (reader.getDB ()->getSqliteDB (),
                          "SELECT LedgerHash,PrevHash FROM Ledgers "
                          "INDEXED BY SeqLedger Where LedgerSeq = ?;");
 
@@ -1057,8 +1224,8 @@ bool Ledger::getHashesByIndex (
 
     std::string hash, prevHash;
     {
-        auto db = getApp().getLedgerDB ().getDB ();
-        auto sl (getApp().getLedgerDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
+        auto db = reader.getDB ();
 
         if (!db->executeSQL (sql) || !db->startIterRows ())
             return false;
@@ -1084,6 +1251,30 @@ Ledger::getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq)
 {
     std::map< std::uint32_t, std::pair<uint256, uint256> > ret;
 
+    {
+        // Serve the range from the flat table only when every entry is
+        // there; a partial answer must fall back so history gaps stay
+        // visible to the caller.
+        auto& table = getApp().getLedgerHashIndex ();
+        bool complete = (minSeq <= maxSeq);
+
+        for (std::uint32_t seq = minSeq; complete && (seq <= maxSeq); ++seq)
+        {
+            uint256 const hash = table.get (seq);
+            uint256 const parent = table.get (seq - 1);
+
+            if (hash.isZero () || parent.isZero ())
+                complete = false;
+            else
+                ret[seq] = std::make_pair (hash, parent);
+        }
+
+        if (complete)
+            return ret;
+
+        ret.clear ();
+    }
+
     std::string sql =
         "SELECT LedgerSeq,LedgerHash,PrevHash FROM Ledgers WHERE LedgerSeq >= ";
     sql.append (beast::lexicalCastThrow <std::string> (minSeq));
@@ -1091,10 +1282,9 @@ Ledger::getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq)
     sql.append (beast::lexicalCastThrow <std::string> (maxSeq));
     sql.append (";");
 
-    auto& con = getApp().getLedgerDB ();
-    auto sl (con.lock ());
+    DatabaseCon::ScopedReader reader (getApp().getLedgerDB ());
 
-    SqliteStatement pSt (con.getDB ()->getSqliteDB (), sql);
+    SqliteStatement pSt (reader.getDB ()->getSqliteDB (), sql);
 
     while (pSt.isRow (pSt.step ()))
     {
@@ -1108,6 +1298,20 @@ Ledger::getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq)
 
 Ledger::pointer Ledger::getLastFullLedger ()
 {
+    if (getConfig ().LEDGER_INDEX_NODESTORE)
+    {
+        // The Ledgers table is not being written; find the tip in the
+        // flat table instead, stepping down past any headers the node
+        // store no longer has, within reason.
+        std::uint32_t seq = getApp().getLedgerHashIndex ().highest ();
+
+        for (int tries = 0; (seq != 0) && (tries < 256); ++tries, --seq)
+        {
+            if (Ledger::pointer ledger = loadByIndexFast (seq))
+                return ledger;
+        }
+    }
+
     try
     {
         return getSQL ("SELECT * from Ledgers order by LedgerSeq desc limit 1;");
@@ -1607,12 +1811,12 @@ std::vector<uint256> Ledger::getLedgerAmendments () const
     return usAmendments;
 }
 
-bool Ledger::walkLedger () const
+bool Ledger::walkLedger (int maxDepth) const
 {
     std::vector <SHAMapMissingNode> missingNodes1;
     std::vector <SHAMapMissingNode> missingNodes2;
 
-    mAccountStateMap->walkMap (missingNodes1, 32);
+    mAccountStateMap->walkMap (missingNodes1, 32, maxDepth);
 
     if (ShouldLog (lsINFO, Ledger) && !missingNodes1.empty ())
     {
@@ -1622,7 +1826,7 @@ bool Ledger::walkLedger () const
             << "First: " << missingNodes1[0];
     }
 
-    mTransactionMap->walkMap (missingNodes2, 32);
+    mTransactionMap->walkMap (missingNodes2, 32, maxDepth);
 
     if (ShouldLog (lsINFO, Ledger) && !missingNodes2.empty ())
     {
@@ -1635,6 +1839,22 @@ bool Ledger::walkLedger () const
     return missingNodes1.empty () && missingNodes2.empty ();
 }
 
+void Ledger::prefetchStateNodes () const
+{
+    if (!mAccountStateMap)
+        return;
+
+    WriteLog (lsINFO, Ledger)
+        << "Prefetching state nodes for ledger " << mLedgerSeq;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        getApp().getJobQueue ().addJob (
+            jtADVANCE, "Ledger::prefetch",
+            std::bind (&SHAMap::prefetchBranch, mAccountStateMap, branch));
+    }
+}
+
 bool Ledger::assertSane () const
 {
     if (mHash.isNonZero () &&
@@ -1759,17 +1979,22 @@ bool Ledger::pendSaveValidated (bool isSynchronous, bool isCurrent)
     {
         return saveValidatedLedger(isCurrent);
     }
-    else if (isCurrent)
+
+    // Queue for the batch writer, starting a drain job if one isn't
+    // already running
+    bool startJob;
     {
-        getApp().getJobQueue ().addJob (jtPUBLEDGER, "Ledger::pendSave",
-            std::bind (&Ledger::saveValidatedLedgerAsync, shared_from_this (),
-                       std::placeholders::_1, isCurrent));
+        StaticScopedLockType sl (sPendingSaveLock);
+        sSaveQueue.push_back (std::make_pair (shared_from_this (), isCurrent));
+        startJob = !sSaveInProgress;
+        sSaveInProgress = true;
     }
-    else
+
+    if (startJob)
     {
-        getApp().getJobQueue ().addJob (jtPUBOLDLEDGER, "Ledger::pendOldSave",
-            std::bind (&Ledger::saveValidatedLedgerAsync, shared_from_this (),
-                       std::placeholders::_1, isCurrent));
+        getApp().getJobQueue ().addJob (
+            isCurrent ? jtPUBLEDGER : jtPUBOLDLEDGER, "Ledger::pendSave",
+            std::bind (&Ledger::saveValidatedBatch, std::placeholders::_1));
     }
 
     return true;
@@ -1901,5 +2126,7 @@ std::vector<uint256> Ledger::getNeededAccountStateHashes (
 
 Ledger::StaticLockType Ledger::sPendingSaveLock;
 std::set<std::uint32_t> Ledger::sPendingSaves;
+std::deque <std::pair <Ledger::pointer, bool>> Ledger::sSaveQueue;
+bool Ledger::sSaveInProgress = false;
 
 } // ripple
@@ -28,6 +28,7 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/Book.h>
+#include <deque>
 #include <set>
 
 namespace ripple {
@@ -436,9 +437,20 @@ public:
         return mHash;
     }
 
-    bool walkLedger () const;
+    /** Check the ledger's trees for missing nodes. If maxDepth is
+        nonzero only the top levels are checked, leaving deeper nodes
+        to fault in from the node store on first use.
+    */
+    bool walkLedger (int maxDepth = 0) const;
     bool assertSane () const;
 
+    /** Warm the tree node cache with this ledger's state tree.
+        Schedules one job per top-level branch; the branches cover
+        disjoint subtrees so the node store reads proceed in parallel
+        while the server is already serving.
+    */
+    void prefetchStateNodes () const;
+
 protected:
     SLE::pointer getASNode (
         LedgerStateParms& parms, uint256 const& nodeID, LedgerEntryType let) const;
@@ -446,11 +458,18 @@ protected:
     // returned SLE is immutable
     SLE::pointer getASNodeI (uint256 const& nodeID, LedgerEntryType let) const;
 
-    void saveValidatedLedgerAsync(Job&, bool current)
-    {
-        saveValidatedLedger(current);
-    }
-    bool saveValidatedLedger (bool current);
+    /** Drain the queue of validated ledgers awaiting a save.
+        Runs on a single job and wraps several ledgers' transaction
+        inserts in one SQLite transaction so WAL commits are amortized.
+    */
+    static void saveValidatedBatch (Job&);
+
+    /** Write this ledger's header and transactions to SQLite.
+        When `ownTransaction` is false the caller holds the transaction
+        database lock with a transaction open, and is responsible for
+        removing the sequence from the pending-save set after commit.
+    */
+    bool saveValidatedLedger (bool current, bool ownTransaction = true);
 
 private:
     void initializeFees ();
@@ -497,6 +516,15 @@ private:
     static StaticLockType sPendingSaveLock;
 
     static std::set<std::uint32_t>  sPendingSaves;
+
+    // Ledgers queued for the batch writer, oldest first, with their
+    // `current` flags. Guarded by sPendingSaveLock.
+    static std::deque <std::pair <pointer, bool>> sSaveQueue;
+    static bool sSaveInProgress;
+
+    // Most ledgers a single SQLite transaction will cover, and the
+    // queue depth past which we complain that saving is falling behind
+    enum { saveBatchMax = 8, saveQueueWarn = 64 };
 };
 
 inline LedgerStateParms operator| (
@@ -21,7 +21,10 @@
 #include <ripple/core/LoadFeeTrack.h>
 #include <beast/threads/Thread.h>
 #include <beast/cxx14/memory.h> // <memory>
+#include <algorithm>
+#include <chrono>
 #include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -39,6 +42,18 @@ Cleans up the ledger. Specifically, resolves these issues:
 
 */
 
+enum
+{
+    // Worker threads processing a cleaning range
+    cleanerWorkers = 4
+
+    // Default I/O budget: ledgers processed per second across all workers
+    ,cleanerLedgersPerSecond = 16
+
+    // SQL rewrites accumulated into one SQLite transaction
+    ,cleanerFixBatch = 1000
+};
+
 class LedgerCleanerImp
     : public LedgerCleaner
     , public beast::Thread
@@ -53,6 +68,9 @@ public:
             , checkNodes (false)
             , fixTxns (false)
             , failures (0)
+            , workers (cleanerWorkers)
+            , ledgersPerSecond (cleanerLedgersPerSecond)
+            , stopRequest (false)
         {
         }
 
@@ -61,6 +79,15 @@ public:
         bool         checkNodes;  // Check all state/transaction nodes
         bool         fixTxns;     // Rewrite SQL databases
         int          failures;    // Number of errors encountered since last success
+        int          workers;     // Threads processing the current range
+        int          ledgersPerSecond; // I/O budget, 0 means unthrottled
+        bool         stopRequest; // An explicit stop was requested
+
+        // The next I/O budget slot
+        std::chrono::steady_clock::time_point nextSlot;
+
+        // Ledgers whose SQL rewrite awaits the next batched commit
+        std::vector <Ledger::pointer> saveBatch;
     };
 
     typedef beast::SharedData <State> SharedState;
@@ -125,6 +152,8 @@ public:
             map["max_ledger"] = state->maxRange;
             map["check_nodes"] = state->checkNodes ? "true" : "false";
             map["fix_txns"] = state->fixTxns ? "true" : "false";
+            map["workers"] = state->workers;
+            map["ledgers_per_second"] = state->ledgersPerSecond;
             if (state->failures > 0)
                 map["fail_counts"] = state->failures;
         }
@@ -150,6 +179,9 @@ public:
             state->checkNodes = false;
             state->fixTxns = false;
             state->failures = 0;
+            state->workers = cleanerWorkers;
+            state->ledgersPerSecond = cleanerLedgersPerSecond;
+            state->stopRequest = false;
 
             /*
             JSON Parameters:
@@ -176,6 +208,16 @@ public:
                 "check_nodes"
                     A boolean, when set to true means check the nodes.
 
+                "workers"
+                    An unsigned integer giving the number of threads that
+                    process the range in parallel.
+
+                "max_ledgers_per_second"
+                    An unsigned integer limiting how many ledgers are
+                    processed per second across all workers, so a long
+                    clean does not disturb foreground traffic. Zero means
+                    no limit.
+
                 "stop"
                     A boolean, when set to true informs the cleaner to gracefully
                     stop its current activities if any cleaning is taking place.
@@ -205,8 +247,19 @@ public:
             if (params.isMember("check_nodes"))
                 state->checkNodes = params["check_nodes"].asBool();
 
+            if (params.isMember("workers"))
+                state->workers = std::max (1,
+                    static_cast <int> (params["workers"].asUInt()));
+
+            if (params.isMember("max_ledgers_per_second"))
+                state->ledgersPerSecond = static_cast <int> (
+                    params["max_ledgers_per_second"].asUInt());
+
             if (params.isMember("stop") && params["stop"].asBool())
+            {
                 state->minRange = state->maxRange = 0;
+                state->stopRequest = true;
+            }
         }
 
         notify();
@@ -263,7 +316,7 @@ public:
         @param ledgerHash  The known correct hash of the ledger.
         @param doNodes Ensure all ledger nodes are in the node db.
         @param doTxns Reprocess (account) transactions to SQL databases.
-        @return `true` if the ledger was cleaned.
+        @return `true` if the ledger was cleaned or queued for rewrite.
     */
     bool doLedger(
         LedgerIndex const& ledgerIndex,
@@ -302,13 +355,57 @@ public:
             return false;
         }
 
-        if (doTxns && !nodeLedger->pendSaveValidated(true, false))
+        if (doTxns)
+            queueSave (nodeLedger);
+
+        return true;
+    }
+
+    /** Queue a ledger whose SQL entries need to be rewritten.
+        Rewrites are accumulated and committed in one SQLite transaction
+        per batch, rather than paying for a commit on every ledger.
+    */
+    void queueSave (Ledger::pointer const& ledger)
+    {
+        std::vector <Ledger::pointer> batch;
+
         {
-            m_journal.debug << "Failed to save ledger " << ledgerIndex;
-            return false;
+            SharedState::Access state (m_state);
+            state->saveBatch.push_back (ledger);
+
+            if (state->saveBatch.size () < cleanerFixBatch)
+                return;
+
+            std::swap (batch, state->saveBatch);
         }
 
-        return true;
+        flushSaves (batch);
+    }
+
+    /** Rewrite a batch of ledgers' SQL entries under one transaction. */
+    void flushSaves (std::vector <Ledger::pointer> const& batch)
+    {
+        if (batch.empty ())
+            return;
+
+        if (batch.size () == 1)
+        {
+            batch.front ()->saveValidatedLedger (false);
+            return;
+        }
+
+        auto db = getApp().getTxnDB ().getDB ();
+        auto dbLock (getApp().getTxnDB ().lock ());
+        db->executeSQL ("BEGIN TRANSACTION;");
+
+        for (auto const& ledger : batch)
+        {
+            if (! ledger->saveValidatedLedger (false, false))
+                m_journal.warning << "Failed to save ledger "
+                                  << ledger->getLedgerSeq ();
+        }
+
+        db->executeSQL ("COMMIT TRANSACTION;");
     }
 
     /** Returns the hash of the specified ledger.
@@ -360,26 +457,60 @@ public:
         return ledgerHash;
     }
 
-    /** Run the ledger cleaner. */
-    void doLedgerCleaner()
+    /** Returns `true` if an explicit stop was requested. */
+    bool stopRequested ()
+    {
+        SharedState::Access state (m_state);
+        return state->stopRequest;
+    }
+
+    /** Take the next I/O budget slot, waiting if the budget is spent.
+        The budget is shared: every worker draws its slots from the same
+        schedule, so adding workers does not raise the I/O rate.
+    */
+    void takeSlot ()
+    {
+        std::chrono::steady_clock::time_point wakeAt;
+
+        {
+            SharedState::Access state (m_state);
+
+            if (state->ledgersPerSecond <= 0)
+                return;
+
+            auto const now = std::chrono::steady_clock::now ();
+
+            if (state->nextSlot < now)
+                state->nextSlot = now;
+
+            wakeAt = state->nextSlot;
+            state->nextSlot += std::chrono::milliseconds (
+                1000 / state->ledgersPerSecond);
+        }
+
+        while (! this->threadShouldExit () &&
+               (std::chrono::steady_clock::now () < wakeAt))
+        {
+            std::this_thread::sleep_for (std::chrono::milliseconds (100));
+        }
+    }
+
+    /** One worker: claim ledgers from the shared range until it is empty.
+        The range is partitioned on demand, highest ledger first: each
+        worker claims the next unprocessed ledger, so fast workers simply
+        take more of the range.
+    */
+    void runWorker ()
     {
+        // Each worker keeps its own reference ledger for hash lookups
         Ledger::pointer goodLedger;
 
-        while (! this->threadShouldExit())
+        while (! this->threadShouldExit ())
         {
             LedgerIndex ledgerIndex;
-            LedgerHash ledgerHash;
             bool doNodes;
             bool doTxns;
 
-            while (getApp().getFeeTrack().isLoadedLocal())
-            {
-                m_journal.debug << "Waiting for load to subside";
-                std::this_thread::sleep_for(std::chrono::seconds(5));
-                if (this->threadShouldExit ())
-                    return;
-            }
-
             {
                 SharedState::Access state (m_state);
                 if ((state->minRange > state->maxRange) ||
@@ -391,46 +522,100 @@ public:
                 ledgerIndex = state->maxRange;
                 doNodes = state->checkNodes;
                 doTxns = state->fixTxns;
-            }
 
-            ledgerHash = getHash(ledgerIndex, goodLedger);
-
-            bool fail = false;
-            if (ledgerHash.isZero())
-            {
-                m_journal.info << "Unable to get hash for ledger " << ledgerIndex;
-                fail = true;
-            }
-            else if (!doLedger(ledgerIndex, ledgerHash, doNodes, doTxns))
-            {
-                m_journal.info << "Failed to process ledger " << ledgerIndex;
-                fail = true;
+                if (state->maxRange == state->minRange)
+                    state->minRange = state->maxRange = 0;
+                else
+                    --state->maxRange;
             }
 
-            if (fail)
+            // Retry the claimed ledger until it is processed or we are
+            // told to stop
+            while (! this->threadShouldExit () && ! stopRequested ())
             {
+                while (getApp().getFeeTrack().isLoadedLocal())
+                {
+                    m_journal.debug << "Waiting for load to subside";
+                    std::this_thread::sleep_for(std::chrono::seconds(5));
+                    if (this->threadShouldExit ())
+                        return;
+                }
+
+                takeSlot ();
+
+                if (this->threadShouldExit ())
+                    return;
+
+                LedgerHash const ledgerHash (getHash (ledgerIndex, goodLedger));
+
+                bool fail = false;
+                if (ledgerHash.isZero())
+                {
+                    m_journal.info << "Unable to get hash for ledger " << ledgerIndex;
+                    fail = true;
+                }
+                else if (!doLedger(ledgerIndex, ledgerHash, doNodes, doTxns))
+                {
+                    m_journal.info << "Failed to process ledger " << ledgerIndex;
+                    fail = true;
+                }
+
+                if (!fail)
+                {
+                    SharedState::Access state (m_state);
+                    state->failures = 0;
+                    break;
+                }
+
                 {
                     SharedState::Access state (m_state);
                     ++state->failures;
                 }
+
                 // Wait for acquiring to catch up to us
                 std::this_thread::sleep_for(std::chrono::seconds(2));
             }
-            else
+        }
+    }
+
+    /** Run the ledger cleaner. */
+    void doLedgerCleaner()
+    {
+        int workerCount;
+
+        {
+            SharedState::Access state (m_state);
+            if ((state->minRange > state->maxRange) ||
+                (state->maxRange == 0) || (state->minRange == 0))
             {
-                {
-                    SharedState::Access state (m_state);
-                    if (ledgerIndex == state->minRange)
-                        ++state->minRange;
-                    if (ledgerIndex == state->maxRange)
-                        --state->maxRange;
-                    state->failures = 0;
-                }
-                // Reduce I/O pressure and wait for acquiring to catch up to us
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                state->minRange = state->maxRange = 0;
+                return;
             }
+            workerCount = std::max (1, state->workers);
+            state->nextSlot = std::chrono::steady_clock::now ();
+        }
 
+        std::vector <std::thread> workers;
+        workers.reserve (workerCount - 1);
+
+        for (int i = 1; i < workerCount; ++i)
+            workers.emplace_back (&LedgerCleanerImp::runWorker, this);
+
+        // The cleaner's own thread is the first worker
+        runWorker ();
+
+        for (auto& worker : workers)
+            worker.join ();
+
+        // Write out whatever is left of the final batch
+        std::vector <Ledger::pointer> batch;
+        {
+            SharedState::Access state (m_state);
+            std::swap (batch, state->saveBatch);
         }
+
+        if (! this->threadShouldExit ())
+            flushSaves (batch);
     }
 };
 
@@ -30,6 +30,10 @@ namespace ripple {
 //
 #define DIR_NODE_MAX        32
 
+// A deletion that leaves a page at or below this occupancy tries to
+// absorb the following page, so sparse chains shrink as entries churn
+#define DIR_NODE_MIN        8
+
 void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
                            std::uint32_t ledgerID, TransactionEngineParams params)
 {
@@ -104,7 +108,15 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
         if (!sleEntry)
         {
             assert (action != taaDELETE);
-            sleEntry = mImmutable ? mLedger->getSLEi (index) : mLedger->getSLE (index);
+            sleEntry = mLedger->getSLEi (index);
+
+            if (sleEntry && !mImmutable)
+            {
+                // Take a private mutable copy. Copying is cheaper than
+                // deserializing the entry again, and the shared immutable
+                // copy stays in the SLE cache for other readers.
+                sleEntry = sleEntry->getMutable ();
+            }
 
             if (sleEntry)
                 entryCache (sleEntry);
@@ -116,6 +128,34 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
     return sleEntry;
 }
 
+SLE::pointer LedgerEntrySet::entryCacheI (LedgerEntryType letType, uint256 const& index)
+{
+    assert (mLedger);
+    SLE::pointer sleEntry;
+
+    if (index.isNonZero ())
+    {
+        auto it = mEntries.find (index);
+
+        if (it != mEntries.end ())
+        {
+            // Hand out the working entry without the copy-on-read a
+            // mutable fetch would do after a checkpoint.
+            if (it->second.mAction != taaDELETE)
+                sleEntry = it->second.mEntry;
+        }
+        else
+        {
+            // Not part of the set: share the ledger's immutable entry
+            // rather than making a private mutable copy. Not caching it
+            // here also keeps checkpoints (duplicate) small.
+            sleEntry = mLedger->getSLEi (index);
+        }
+    }
+
+    return sleEntry;
+}
+
 LedgerEntryAction LedgerEntrySet::hasEntry (uint256 const& index) const
 {
     std::map<uint256, LedgerEntrySetEntry>::const_iterator it = mEntries.find (index);
@@ -591,7 +631,7 @@ TER LedgerEntrySet::dirCount (uint256 const& uRootIndex, std::uint32_t& uCount)
 
     do
     {
-        SLE::pointer    sleNode = entryCache (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeDir));
+        SLE::pointer    sleNode = entryCacheI (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeDir));
 
         if (sleNode)
         {
@@ -617,7 +657,7 @@ bool LedgerEntrySet::dirIsEmpty (uint256 const& uRootIndex)
 {
     std::uint64_t  uNodeDir = 0;
 
-    SLE::pointer sleNode = entryCache (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeDir));
+    SLE::pointer sleNode = entryCacheI (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeDir));
 
     if (!sleNode)
         return true;
@@ -724,6 +764,137 @@ TER LedgerEntrySet::dirAdd (
     return tesSUCCESS;
 }
 
+// Which field of an entry holds its page number within the directory
+// rooted at uRootIndex, or nullptr if we can't tell.
+static SField::ptr dirEntryNodeField (SLE::ref sleEntry, uint256 const& uRootIndex)
+{
+    switch (sleEntry->getType ())
+    {
+    case ltOFFER:
+        if (getOwnerDirIndex (sleEntry->getFieldAccount160 (sfAccount)) == uRootIndex)
+            return &sfOwnerNode;
+
+        if (sleEntry->getFieldH256 (sfBookDirectory) == uRootIndex)
+            return &sfBookNode;
+
+        return nullptr;
+
+    case ltRIPPLE_STATE:
+        if (getOwnerDirIndex (sleEntry->getFieldAmount (sfLowLimit).getIssuer ()) == uRootIndex)
+            return &sfLowNode;
+
+        if (getOwnerDirIndex (sleEntry->getFieldAmount (sfHighLimit).getIssuer ()) == uRootIndex)
+            return &sfHighNode;
+
+        return nullptr;
+
+    case ltTICKET:
+        if (getOwnerDirIndex (sleEntry->getFieldAccount160 (sfAccount)) == uRootIndex)
+            return &sfOwnerNode;
+
+        return nullptr;
+
+    default:
+        return nullptr;
+    }
+}
+
+// Move the entries of the page after uNodeCur into it and unlink the
+// emptied page. Appending preserves the directory's overall iteration
+// order, and each moved entry's stored page number is re-pointed; if
+// any entry's reference can't be found, the merge is abandoned before
+// anything is changed.
+bool LedgerEntrySet::dirMergeNext (
+    SLE::ref sleNode, uint256 const& uRootIndex, std::uint64_t uNodeCur)
+{
+    std::uint64_t const uNodeNext = sleNode->getFieldU64 (sfIndexNext);
+
+    if (!uNodeNext)
+        return false;
+
+    SLE::pointer sleNext = entryCache (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeNext));
+
+    if (!sleNext)
+    {
+        assert (false);
+        return false;
+    }
+
+    STVector256 svIndexes = sleNode->getFieldV256 (sfIndexes);
+    STVector256 const svNext = sleNext->getFieldV256 (sfIndexes);
+
+    if (svIndexes.peekValue ().size () + svNext.peekValue ().size () > DIR_NODE_MAX)
+        return false;
+
+    std::vector<SLE::pointer> vsleMoved;
+    std::vector<SField::ptr> vsfNode;
+
+    for (auto const& uEntry : svNext.peekValue ())
+    {
+        // The type argument is not consulted on fetch; directories
+        // don't record the types of their entries
+        SLE::pointer sleEntry = entryCache (ltINVALID, uEntry);
+
+        if (!sleEntry)
+        {
+            assert (false);
+            return false;
+        }
+
+        SField::ptr sfNode = dirEntryNodeField (sleEntry, uRootIndex);
+
+        if (!sfNode)
+            return false;
+
+        vsleMoved.push_back (sleEntry);
+        vsfNode.push_back (sfNode);
+    }
+
+    std::uint64_t const uNodeNewNext = sleNext->getFieldU64 (sfIndexNext);
+
+    // The node whose back link must be fixed: the page after the
+    // absorbed one, or the root's last-page pointer if the absorbed
+    // page was the last.
+    SLE::pointer sleLink;
+
+    if (uNodeNewNext)
+        sleLink = entryCache (ltDIR_NODE, getDirNodeIndex (uRootIndex, uNodeNewNext));
+    else if (uNodeCur)
+        sleLink = entryCache (ltDIR_NODE, uRootIndex);
+    else
+        sleLink = sleNode;  // merging into a root that is now the whole chain
+
+    if (!sleLink)
+    {
+        assert (false);
+        return false;
+    }
+
+    // All checks passed: move the entries and unlink the page.
+    for (std::size_t i = 0; i < vsleMoved.size (); ++i)
+    {
+        svIndexes.peekValue ().push_back (svNext.peekValue ()[i]);
+        vsleMoved[i]->setFieldU64 (*vsfNode[i], uNodeCur);
+        entryModify (vsleMoved[i]);
+    }
+
+    sleNode->setFieldV256 (sfIndexes, svIndexes);
+    sleNode->setFieldU64 (sfIndexNext, uNodeNewNext);
+    entryModify (sleNode);
+
+    sleLink->setFieldU64 (sfIndexPrevious, uNodeCur);
+    entryModify (sleLink);
+
+    entryDelete (sleNext);
+
+    WriteLog (lsTRACE, LedgerEntrySet) << "dirMergeNext:" <<
+        " uRootIndex=" << to_string (uRootIndex) <<
+        " absorbed node " << strHex (uNodeNext) <<
+        " into " << strHex (uNodeCur);
+
+    return true;
+}
+
 // Ledger must be in a state for this to work.
 TER LedgerEntrySet::dirDelete (
     const bool                      bKeepRoot,      // --> True, if we never completely clean up, after we overflow the root node.
@@ -917,12 +1088,52 @@ TER LedgerEntrySet::dirDelete (
             }
         }
     }
+    else if (vuiIndexes.size () <= DIR_NODE_MIN)
+    {
+        // The deletion left this page under-occupied: try to absorb
+        // the following page so walks stay proportional to live
+        // entries instead of to pages the churn left behind. Merging
+        // changes the state a transaction produces, so it stays
+        // dormant until the DirectoryCompaction amendment is enabled
+        // and every validator applies the same rule.
+        static uint256 const directoryCompaction (std::string (
+            "5CF210E3057094F12C167202BD4738EDAA8DCAD6406E83BF8DC094F7E2FA5B90"));
+
+        if (getApp().getAmendmentTable ().isEnabled (directoryCompaction))
+            dirMergeNext (sleNode, uRootIndex, uNodeCur);
+    }
 
     return tesSUCCESS;
 }
 
 // Return the first entry and advance uDirEntry.
 // <-- true, if had a next entry.
+void LedgerEntrySet::dirPrefetch (
+    uint256 const& uRootIndex,  // --> Root of directory
+    SLE::ref sleNode)           // --> Page just loaded
+{
+    // The caller is about to read these entries one at a time; getting
+    // their node store reads started now lets them overlap instead of
+    // costing one round trip each
+    SHAMap::ref stateMap = mLedger->peekAccountStateMap ();
+
+    if (!stateMap)
+        return;
+
+    STVector256 svIndexes = sleNode->getFieldV256 (sfIndexes);
+
+    for (auto const& uEntryIndex : svIndexes.peekValue ())
+    {
+        if (mEntries.find (uEntryIndex) == mEntries.end ())
+            stateMap->prefetchItem (uEntryIndex);
+    }
+
+    std::uint64_t uNodeNext = sleNode->getFieldU64 (sfIndexNext);
+
+    if (uNodeNext)
+        stateMap->prefetchItem (getDirNodeIndex (uRootIndex, uNodeNext));
+}
+
 bool LedgerEntrySet::dirFirst (
     uint256 const& uRootIndex,  // --> Root of directory.
     SLE::pointer& sleNode,      // <-- current node
@@ -934,6 +1145,9 @@ bool LedgerEntrySet::dirFirst (
 
     assert (sleNode);           // Never probe for directories.
 
+    if (sleNode)
+        dirPrefetch (uRootIndex, sleNode);
+
     return LedgerEntrySet::dirNext (uRootIndex, sleNode, uDirEntry, uEntryIndex);
 }
 
@@ -974,6 +1188,7 @@ bool LedgerEntrySet::dirNext (
             }
 
             sleNode = sleNext;
+            dirPrefetch (uRootIndex, sleNode);
             // TODO(tom): make this iterative.
             return dirNext (uRootIndex, sleNode, uDirEntry, uEntryIndex);
         }
@@ -1111,7 +1326,7 @@ STAmount LedgerEntrySet::rippleHolds (
     FreezeHandling zeroIfFrozen)
 {
     STAmount saBalance;
-    SLE::pointer sleRippleState = entryCache (ltRIPPLE_STATE,
+    SLE::pointer sleRippleState = entryCacheI (ltRIPPLE_STATE,
         getRippleStateIndex (account, issuer, currency));
 
     if (!sleRippleState)
@@ -1152,7 +1367,7 @@ STAmount LedgerEntrySet::accountHolds (
 
     if (!currency)
     {
-        SLE::pointer sleAccount = entryCache (ltACCOUNT_ROOT,
+        SLE::pointer sleAccount = entryCacheI (ltACCOUNT_ROOT,
             getAccountRootIndex (account));
         std::uint64_t uReserve = mLedger->getReserve (
             sleAccount->getFieldU32 (sfOwnerCount));
@@ -1191,7 +1406,7 @@ bool LedgerEntrySet::isGlobalFrozen (Account const& issuer)
     if (!enforceFreeze () || isXRP (issuer))
         return false;
 
-    SLE::pointer sle = entryCache (ltACCOUNT_ROOT, getAccountRootIndex (issuer));
+    SLE::pointer sle = entryCacheI (ltACCOUNT_ROOT, getAccountRootIndex (issuer));
     if (sle && sle->isFlag (lsfGlobalFreeze))
         return true;
 
@@ -1208,14 +1423,14 @@ bool LedgerEntrySet::isFrozen(
     if (!enforceFreeze () || isXRP (currency))
         return false;
 
-    SLE::pointer sle = entryCache (ltACCOUNT_ROOT, getAccountRootIndex (issuer));
+    SLE::pointer sle = entryCacheI (ltACCOUNT_ROOT, getAccountRootIndex (issuer));
     if (sle && sle->isFlag (lsfGlobalFreeze))
         return true;
 
     if (issuer != account)
     {
         // Check if the issuer froze the line
-        sle = entryCache (ltRIPPLE_STATE,
+        sle = entryCacheI (ltRIPPLE_STATE,
             getRippleStateIndex (account, issuer, currency));
         if (sle && sle->isFlag ((issuer > account) ? lsfHighFreeze : lsfLowFreeze))
         {
@@ -1703,7 +1918,7 @@ TER LedgerEntrySet::accountSend (
 std::uint32_t
 rippleTransferRate (LedgerEntrySet& ledger, Account const& issuer)
 {
-    SLE::pointer sleAccount (ledger.entryCache (
+    SLE::pointer sleAccount (ledger.entryCacheI (
         ltACCOUNT_ROOT, getAccountRootIndex (issuer)));
 
     std::uint32_t quality = QUALITY_ONE;
@@ -157,6 +157,11 @@ public:
     SLE::pointer entryCreate (LedgerEntryType letType, uint256 const& uIndex);
     SLE::pointer entryCache (LedgerEntryType letType, uint256 const& uIndex);
 
+    // Fetch an entry for inspection only. Never copies: returns the set's
+    // working entry if there is one, otherwise the ledger's shared immutable
+    // entry. The caller must not modify the returned SLE.
+    SLE::pointer entryCacheI (LedgerEntryType letType, uint256 const& uIndex);
+
     // Directory functions.
     TER dirAdd (
         std::uint64_t&                      uNodeDir,      // Node of entry.
@@ -172,6 +177,10 @@ public:
         const bool           bStable,
         const bool           bSoft);
 
+    // Queue background reads for every entry a directory page lists,
+    // and for the next page, before the caller walks them one by one.
+    void dirPrefetch (uint256 const& uRootIndex, SLE::ref sleNode);
+
     bool dirFirst (uint256 const& uRootIndex, SLE::pointer& sleNode,
         unsigned int & uDirEntry, uint256 & uEntryIndex);
     bool dirNext (uint256 const& uRootIndex, SLE::pointer& sleNode,
@@ -300,6 +309,9 @@ private:
         mImmutable (false)
     {}
 
+    bool dirMergeNext (
+        SLE::ref sleNode, uint256 const& uRootIndex, std::uint64_t uNodeCur);
+
     SLE::pointer getForMod (
         uint256 const& node, Ledger::ref ledger,
         NodeToLedgerEntry& newMods);
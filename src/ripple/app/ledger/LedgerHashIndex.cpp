@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Log.h>
+#include <beast/Config.h>
+#include <cstring>
+
+#if ! BEAST_WINDOWS
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+namespace ripple {
+
+LedgerHashIndex::~LedgerHashIndex ()
+{
+    for (auto const& chunk : mChunks)
+    {
+        if (chunk.base == nullptr)
+            continue;
+
+#if ! BEAST_WINDOWS
+        if (chunk.mapped)
+        {
+            ::munmap (chunk.base, chunkLedgers * hashBytes);
+            continue;
+        }
+#endif
+
+        delete [] chunk.base;
+    }
+
+#if ! BEAST_WINDOWS
+    if (mFileDescriptor != -1)
+        ::close (mFileDescriptor);
+#endif
+}
+
+void LedgerHashIndex::open (boost::filesystem::path const& dataDir)
+{
+#if ! BEAST_WINDOWS
+    ScopedLockType sl (mLock);
+
+    if (mOpen || dataDir.empty ())
+        return;
+
+    auto const path = dataDir / "ledgerhashes.tbl";
+
+    mFileDescriptor = ::open (path.string ().c_str (),
+        O_RDWR | O_CREAT, 0644);
+
+    if (mFileDescriptor == -1)
+    {
+        WriteLog (lsWARNING, LedgerHashIndex) <<
+            "Unable to open ledger hash table in " << dataDir;
+        return;
+    }
+
+    mOpen = true;
+
+    // Map every chunk the file already covers
+    off_t const end = ::lseek (mFileDescriptor, 0, SEEK_END);
+    std::uint64_t const size = (end > 0) ? end : 0;
+    std::uint64_t const bytes = chunkLedgers * hashBytes;
+
+    for (std::uint32_t index = 0; ((index + 1) * bytes) <= size; ++index)
+        chunkBase (index, true);
+
+    WriteLog (lsINFO, LedgerHashIndex) <<
+        "Ledger hash table covers " << mChunks.size () << " chunk(s)";
+#endif
+}
+
+char* LedgerHashIndex::chunkBase (std::uint32_t chunkIndex, bool create)
+{
+    if ((chunkIndex < mChunks.size ()) &&
+        (mChunks[chunkIndex].base != nullptr))
+        return mChunks[chunkIndex].base;
+
+    if (!create)
+        return nullptr;
+
+    if (chunkIndex >= mChunks.size ())
+        mChunks.resize (chunkIndex + 1);
+
+    Chunk& chunk = mChunks[chunkIndex];
+    std::size_t const bytes = chunkLedgers * hashBytes;
+
+#if ! BEAST_WINDOWS
+    if (mOpen)
+    {
+        std::uint64_t const end =
+            (static_cast <std::uint64_t> (chunkIndex) + 1) * bytes;
+
+        if (::ftruncate (mFileDescriptor, end) == 0)
+        {
+            void* base = ::mmap (nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_SHARED, mFileDescriptor,
+                static_cast <off_t> (end - bytes));
+
+            if (base != MAP_FAILED)
+            {
+                chunk.base = static_cast <char*> (base);
+                chunk.mapped = true;
+                return chunk.base;
+            }
+        }
+
+        WriteLog (lsWARNING, LedgerHashIndex) <<
+            "Unable to grow the ledger hash table; keeping it in memory";
+        mOpen = false;
+    }
+#endif
+
+    chunk.base = new char [bytes];
+    memset (chunk.base, 0, bytes);
+    return chunk.base;
+}
+
+void LedgerHashIndex::set (std::uint32_t ledgerIndex, uint256 const& ledgerHash)
+{
+    if ((ledgerIndex == 0) || ledgerHash.isZero ())
+        return;
+
+    ScopedLockType sl (mLock);
+
+    char* base = chunkBase (ledgerIndex / chunkLedgers, true);
+
+    if (base != nullptr)
+        memcpy (base + ((ledgerIndex % chunkLedgers) * hashBytes),
+            ledgerHash.begin (), hashBytes);
+}
+
+uint256 LedgerHashIndex::get (std::uint32_t ledgerIndex) const
+{
+    uint256 ledgerHash;
+
+    ScopedLockType sl (mLock);
+
+    std::uint32_t const chunkIndex = ledgerIndex / chunkLedgers;
+
+    if ((chunkIndex < mChunks.size ()) &&
+        (mChunks[chunkIndex].base != nullptr))
+        memcpy (ledgerHash.begin (),
+            mChunks[chunkIndex].base +
+                ((ledgerIndex % chunkLedgers) * hashBytes),
+            hashBytes);
+
+    return ledgerHash;
+}
+
+std::uint32_t LedgerHashIndex::highest () const
+{
+    static char const zero[hashBytes] = {};
+
+    ScopedLockType sl (mLock);
+
+    for (std::uint32_t chunkIndex = mChunks.size (); chunkIndex-- != 0;)
+    {
+        char const* base = mChunks[chunkIndex].base;
+
+        if (base == nullptr)
+            continue;
+
+        for (std::uint32_t slot = chunkLedgers; slot-- != 0;)
+        {
+            if (memcmp (base + (slot * hashBytes), zero, hashBytes) != 0)
+                return (chunkIndex * chunkLedgers) + slot;
+        }
+    }
+
+    return 0;
+}
+
+} // ripple
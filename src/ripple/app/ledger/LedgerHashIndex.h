@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERHASHINDEX_H
+#define RIPPLE_LEDGERHASHINDEX_H
+
+#include <boost/filesystem.hpp>
+#include <vector>
+
+namespace ripple {
+
+/** A flat table of validated ledger hashes indexed by sequence.
+
+    Resolving a ledger sequence to its hash normally means walking
+    skip-list entries out of a reference ledger, costing several node
+    store reads per resolution. This table keeps the hash of every
+    known fully-validated ledger in an array indexed directly by
+    sequence, so a resolution is a single read. It is fed as ledgers
+    are validated and as skip-list walks resolve historical hashes.
+
+    The table is divided into fixed-size chunks. Once a data directory
+    has been given, each chunk is a memory-mapped window of a single
+    backing file, so the table survives restarts and shares pages with
+    the file cache; otherwise chunks live on the heap. An all-zero
+    slot means the hash is not known.
+*/
+class LedgerHashIndex
+{
+public:
+    LedgerHashIndex () = default;
+    ~LedgerHashIndex ();
+
+    LedgerHashIndex (LedgerHashIndex const&) = delete;
+    LedgerHashIndex& operator= (LedgerHashIndex const&) = delete;
+
+    /** Open (creating if needed) the persistent backing file.
+        If this is never called, or the file cannot be used, the table
+        still works but is held entirely in memory.
+    */
+    void open (boost::filesystem::path const& dataDir);
+
+    /** Record the hash of a fully-validated ledger. */
+    void set (std::uint32_t ledgerIndex, uint256 const& ledgerHash);
+
+    /** Look up a validated ledger's hash.
+        @return The hash, or all-bits-zero if it is not known.
+    */
+    uint256 get (std::uint32_t ledgerIndex) const;
+
+    /** The highest sequence with a recorded hash, or zero.
+        Scans the table backwards, so call this rarely (startup).
+    */
+    std::uint32_t highest () const;
+
+private:
+    // Ledgers per chunk; one chunk maps or allocates 32 megabytes
+    static std::uint32_t const chunkLedgers = 1024 * 1024;
+    static std::size_t const hashBytes = 32;
+
+    struct Chunk
+    {
+        char* base = nullptr;
+        bool mapped = false;
+    };
+
+    // Returns the chunk holding ledgerIndex, creating it if asked.
+    // The caller must hold the lock. May return nullptr.
+    char* chunkBase (std::uint32_t chunkIndex, bool create);
+
+    typedef RippleMutex LockType;
+    typedef std::lock_guard <LockType> ScopedLockType;
+
+    mutable LockType mLock;
+
+    bool mOpen = false;
+    int mFileDescriptor = -1;
+    std::vector <Chunk> mChunks;
+};
+
+} // ripple
+
+#endif
@@ -32,6 +32,16 @@ namespace ripple {
 #define CACHED_LEDGER_AGE 120
 #endif
 
+// Compact headers are a few hundred bytes, so the cache can hold
+// orders of magnitude more entries than the full-ledger cache
+#ifndef CACHED_COMPACT_NUM
+#define CACHED_COMPACT_NUM 100000
+#endif
+
+#ifndef CACHED_COMPACT_AGE
+#define CACHED_COMPACT_AGE 3600
+#endif
+
 // FIXME: Need to clean up ledgers by index at some point
 
 LedgerHistory::LedgerHistory (
@@ -42,9 +52,60 @@ LedgerHistory::LedgerHistory (
         get_seconds_clock (), deprecatedLogs().journal("TaggedCache"))
     , m_consensus_validated ("ConsensusValidated", 64, 300,
         get_seconds_clock (), deprecatedLogs().journal("TaggedCache"))
+    , m_compact_ledgers ("CompactLedgerCache", CACHED_COMPACT_NUM,
+        CACHED_COMPACT_AGE, get_seconds_clock (),
+            deprecatedLogs().journal("TaggedCache"))
 {
 }
 
+std::shared_ptr <CompactLedger>
+LedgerHistory::makeCompactLedger (Ledger::ref ledger)
+{
+    auto compact = std::make_shared <CompactLedger> ();
+
+    Serializer s (128);
+    ledger->addRaw (s);
+    compact->header = std::move (s.modData ());
+
+    if (ledger->getTransHash ().isNonZero ())
+    {
+        try
+        {
+            ledger->peekTransactionMap ()->visitLeaves (
+                [&compact] (SHAMapItem::ref item)
+                {
+                    compact->txIDs.push_back (item->getTag ());
+                });
+        }
+        catch (SHAMapMissingNode const&)
+        {
+            // Transaction map not fully available; keep the header only
+            compact->txIDs.clear ();
+        }
+    }
+
+    m_compact_ledgers.canonicalize (ledger->getHash (), compact);
+    return compact;
+}
+
+std::shared_ptr <CompactLedger>
+LedgerHistory::getCompactLedger (LedgerHash const& ledgerHash)
+{
+    auto compact = m_compact_ledgers.fetch (ledgerHash);
+
+    if (compact)
+        return compact;
+
+    // Build from the full ledger if we still have it cached, but
+    // never go to the back end just for a header
+    Ledger::pointer ledger = m_ledgers_by_hash.fetch (ledgerHash);
+
+    if (ledger)
+        return makeCompactLedger (ledger);
+
+    return compact;
+}
+
 bool LedgerHistory::addLedger (Ledger::pointer ledger, bool validated)
 {
     assert (ledger && ledger->isImmutable ());
@@ -56,6 +117,9 @@ bool LedgerHistory::addLedger (Ledger::pointer ledger, bool validated)
     if (validated)
         mLedgersByIndex[ledger->getLedgerSeq()] = ledger->getHash();
 
+    // Retain the compact form past the life of the full ledger
+    makeCompactLedger (ledger);
+
     return alreadyHad;
 }
 
@@ -25,6 +25,19 @@
 
 namespace ripple {
 
+/** Compact form of a tracked ledger.
+
+    Holds the serialized header and the transaction IDs — a few hundred
+    bytes — so tens of thousands of recent ledgers can stay in memory
+    where only a handful of full ledgers (each pinning whole SHAMaps)
+    could.
+*/
+struct CompactLedger
+{
+    Blob header;
+    std::vector <uint256> txIDs;
+};
+
 // VFALCO TODO Rename to OldLedgers ?
 
 /** Retains historical ledgers. */
@@ -47,6 +60,12 @@ public:
         return m_ledgers_by_hash.getHitRate ();
     }
 
+    /** Get the number of ledgers in the ledgers_by_hash cache */
+    int getCacheSize ()
+    {
+        return m_ledgers_by_hash.getCacheSize ();
+    }
+
     /** Get a ledger given its squence number
         @param ledgerIndex The sequence number of the desired ledger
     */
@@ -64,6 +83,11 @@ public:
     */
     Ledger::pointer getLedgerByHash (LedgerHash const& ledgerHash);
 
+    /** Retrieve the compact form of a ledger, if available.
+        Never touches SQLite; builds from the full-ledger cache on miss.
+    */
+    std::shared_ptr <CompactLedger> getCompactLedger (LedgerHash const& ledgerHash);
+
     /** Set the history cache's paramters
         @param size The target size of the cache
         @param age The target age of the cache, in seconds
@@ -76,6 +100,7 @@ public:
     {
         m_ledgers_by_hash.sweep ();
         m_consensus_validated.sweep ();
+        m_compact_ledgers.sweep ();
     }
 
     /** Report that we have locally built a particular ledger
@@ -107,10 +132,18 @@ private:
     beast::insight::Collector::ptr collector_;
     beast::insight::Counter mismatch_counter_;
 
+    /** Build and cache the compact form of a full ledger. */
+    std::shared_ptr <CompactLedger> makeCompactLedger (Ledger::ref ledger);
+
     typedef TaggedCache <LedgerHash, Ledger> LedgersByHash;
 
     LedgersByHash m_ledgers_by_hash;
 
+    // Headers and tx-id lists survive long after the full
+    // ledgers have been swept
+    typedef TaggedCache <LedgerHash, CompactLedger> CompactLedgers;
+    CompactLedgers m_compact_ledgers;
+
     // Maps ledger indexes to the corresponding hashes
     // For debug and logging purposes
     // 1) The hash of a ledger with that index we build
@@ -367,24 +367,66 @@ public:
     }
 
     TER doTransaction (STTx::ref txn, TransactionEngineParams params, bool& didApply)
+    {
+        std::vector <TxnBatchItem> batch (1);
+        batch.front ().txn = txn;
+        batch.front ().params = params;
+
+        doTransactionBatch (batch);
+
+        didApply = batch.front ().didApply;
+        return batch.front ().result;
+    }
+
+    void doTransactionBatch (std::vector <TxnBatchItem>& batch)
     {
         Ledger::pointer ledger;
-        TransactionEngine engine;
-        TER result;
-        didApply = false;
+        int applied = 0;
 
         {
             ScopedLockType sl (m_mutex);
+
             ledger = mCurrentLedger.getMutable ();
-            engine.setLedger (ledger);
-            result = engine.applyTransaction (*txn, params, didApply);
+            TransactionEngine engine (ledger);
+
+            for (auto& item : batch)
+            {
+                item.didApply = false;
+
+                try
+                {
+                    item.result = engine.applyTransaction (
+                        *item.txn, item.params, item.didApply);
+                }
+                catch (...)
+                {
+                    WriteLog (lsWARNING, LedgerMaster) <<
+                        "Batched transaction throws";
+                    item.result = tefEXCEPTION;
+                }
+
+                if (item.didApply)
+                    ++applied;
+            }
+
+            // Install the updated ledger before dropping the lock, as
+            // applyHeldTransactions does: once we unlock, a ledger
+            // close may install the new open ledger, and setting ours
+            // afterwards would roll that back.
+            if (applied != 0)
+                mCurrentLedger.set (ledger);
         }
-        if (didApply)
+
+        if (applied != 0)
         {
-           mCurrentLedger.set (ledger);
-           getApp().getOPs ().pubProposedTransaction (ledger, txn, result);
+            // One publish covers every application in the batch
+            for (auto const& item : batch)
+            {
+                if (item.didApply)
+                    getApp().getOPs ().pubProposedTransaction (
+                        ledger, item.txn, item.result);
+            }
         }
-        return result;
     }
 
     bool haveLedgerRange (std::uint32_t from, std::uint32_t to)
@@ -768,6 +810,13 @@ public:
         ledger->setValidated();
         ledger->setFull();
         setValidLedger(ledger);
+
+        // Feed the flat hash table so this sequence (and its parent's)
+        // resolve without a skip-list walk
+        getApp().getLedgerHashIndex().set (
+            ledger->getLedgerSeq(), ledger->getHash());
+        getApp().getLedgerHashIndex().set (
+            ledger->getLedgerSeq() - 1, ledger->getParentHash());
         if (!mPubLedger)
         {
             ledger->pendSaveValidated(true, true);
@@ -971,6 +1020,28 @@ public:
                                     assert(ledger->getLedgerSeq() == missing);
                                     WriteLog (lsTRACE, LedgerMaster) << "tryAdvance acquired " << ledger->getLedgerSeq();
                                     setFullLedger(ledger, false, false);
+
+                                    // Drain any further history ledgers already acquired, walking
+                                    // the parent hash chain, so one pass stores a contiguous batch
+                                    // instead of rescheduling per ledger
+                                    for (int i = 1; i < ledger_fetch_size_; ++i)
+                                    {
+                                        uint256 const parentHash = ledger->getParentHash();
+                                        Ledger::pointer prevLedger = getLedgerByHash(parentHash);
+                                        if (!prevLedger)
+                                        {
+                                            InboundLedger::pointer prevAcq =
+                                                getApp().getInboundLedgers().find(parentHash);
+                                            if (prevAcq && prevAcq->isComplete() && !prevAcq->isFailed())
+                                                prevLedger = prevAcq->getLedger();
+                                        }
+                                        if (!prevLedger ||
+                                            (prevLedger->getLedgerSeq() != (ledger->getLedgerSeq() - 1)))
+                                            break;
+                                        WriteLog (lsTRACE, LedgerMaster) << "tryAdvance drained " << prevLedger->getLedgerSeq();
+                                        setFullLedger(prevLedger, false, false);
+                                        ledger = prevLedger;
+                                    }
                                     if ((mFillInProgress == 0) && (Ledger::getHashByIndex(ledger->getLedgerSeq() - 1) == ledger->getParentHash()))
                                     { // Previous ledger is in DB
                                         ScopedLockType sl(m_mutex);
@@ -1352,7 +1423,12 @@ public:
 
     uint256 getHashBySeq (std::uint32_t index)
     {
-        uint256 hash = mLedgerHistory.getLedgerHash (index);
+        uint256 hash = getApp().getLedgerHashIndex ().get (index);
+
+        if (hash.isNonZero ())
+            return hash;
+
+        hash = mLedgerHistory.getLedgerHash (index);
 
         if (hash.isNonZero ())
             return hash;
@@ -1384,6 +1460,11 @@ public:
         if (!referenceLedger || (referenceLedger->getLedgerSeq() < index))
             return ledgerHash; // Nothing we can do. No validated ledger.
 
+        // A hash recorded in the flat table saves the whole walk
+        ledgerHash = getApp().getLedgerHashIndex ().get (index);
+        if (ledgerHash.isNonZero ())
+            return ledgerHash;
+
         // See if the hash for the ledger we need is in the reference ledger
         ledgerHash = referenceLedger->getLedgerHash (index);
         if (ledgerHash.isZero())
@@ -1406,6 +1487,11 @@ public:
                 }
             }
         }
+
+        // Remember what the walk resolved so it never repeats
+        if (ledgerHash.isNonZero ())
+            getApp().getLedgerHashIndex ().set (index, ledgerHash);
+
         return ledgerHash;
     }
 
@@ -1447,6 +1533,11 @@ public:
         return Ledger::pointer ();
     }
 
+    std::shared_ptr <CompactLedger> getCompactLedger (uint256 const& hash)
+    {
+        return mLedgerHistory.getCompactLedger (hash);
+    }
+
     void doLedgerCleaner(Json::Value const& parameters)
     {
         mLedgerCleaner->doClean (parameters);
@@ -1472,6 +1563,11 @@ public:
         return mLedgerHistory.getCacheHitRate ();
     }
 
+    int getCacheSize ()
+    {
+        return mLedgerHistory.getCacheSize ();
+    }
+
     void addValidateCallback (callback& c)
     {
         mOnValidate.push_back (c);
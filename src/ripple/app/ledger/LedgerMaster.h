@@ -29,6 +29,8 @@
 
 namespace ripple {
 
+struct CompactLedger;
+
 // Tracks the current ledger and any ledgers in the process of closing
 // Tracks ledger history
 // Tracks held transactions
@@ -77,6 +79,25 @@ public:
         STTx::ref txn,
             TransactionEngineParams params, bool& didApply) = 0;
 
+    /** One open-ledger application within a batch.
+        The caller fills in the transaction and engine parameters;
+        doTransactionBatch fills in the verdict.
+    */
+    struct TxnBatchItem
+    {
+        STTx::pointer txn;
+        TransactionEngineParams params;
+        TER result;
+        bool didApply;
+    };
+
+    /** Apply a group of transactions to the open ledger.
+        The whole batch commits through one mutable snapshot and one
+        publish, so consecutive transactions touching the same accounts
+        share tree-path copies and dirty-node bookkeeping.
+    */
+    virtual void doTransactionBatch (std::vector <TxnBatchItem>& batch) = 0;
+
     virtual int getMinValidations () = 0;
 
     virtual void setMinValidations (int v) = 0;
@@ -113,6 +134,10 @@ public:
 
     virtual Ledger::pointer getLedgerByHash (uint256 const& hash) = 0;
 
+    /** Get the compact (header plus tx IDs) form of a cached ledger. */
+    virtual std::shared_ptr <CompactLedger> getCompactLedger (
+        uint256 const& hash) = 0;
+
     virtual void setLedgerRangePresent (std::uint32_t minV, std::uint32_t maxV) = 0;
 
     virtual uint256 getLedgerHash(std::uint32_t desiredSeq, Ledger::ref knownGoodLedger) = 0;
@@ -129,6 +154,7 @@ public:
     virtual void tune (int size, int age) = 0;
     virtual void sweep () = 0;
     virtual float getCacheHitRate () = 0;
+    virtual int getCacheSize () = 0;
     virtual void addValidateCallback (callback& c) = 0;
 
     virtual void checkAccept (Ledger::ref ledger) = 0;
@@ -90,7 +90,30 @@ uint256 LedgerProposal::computeSuppressionID (
 
 bool LedgerProposal::checkSign (std::string const& signature, uint256 const& signingHash)
 {
-    return mPublicKey.verifyNodePublic (signingHash, signature, ECDSA::not_strict);
+    // Re-checks are common: stored proposals are verified again on
+    // every consensus view change. Key the verdict on the exact
+    // verification inputs so a repeat costs a hash probe instead of
+    // an ECDSA verification.
+    Serializer s (512);
+    s.add256 (signingHash);
+    s.addVL (mPublicKey.getNodePublic ());
+    s.addRaw (signature.data (), signature.size ());
+    uint256 const id = s.getSHA512Half ();
+
+    int const flags = getApp().getHashRouter ().getFlags (id);
+
+    if (flags & SF_SIGGOOD)
+        return true;
+
+    if (flags & SF_BAD)
+        return false;
+
+    bool const sigGood = mPublicKey.verifyNodePublic (
+        signingHash, signature, ECDSA::not_strict);
+
+    getApp().getHashRouter ().setFlag (id, sigGood ? SF_SIGGOOD : SF_BAD);
+
+    return sigGood;
 }
 
 bool LedgerProposal::changePosition (uint256 const& newPosition, std::uint32_t closeTime)
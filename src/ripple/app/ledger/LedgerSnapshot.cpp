@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <fstream>
+#include <stack>
+
+namespace ripple {
+
+// File layout, all integers big-endian:
+//
+//   u32 magic, u32 version
+//   u32 ledger sequence, 256-bit ledger hash
+//   u32 size, ledger header (with the ledgerMaster prefix)
+//   repeated: u32 size, state node (snfPREFIX), in visitNodes pre-order
+//   u32 zero terminator
+//
+static std::uint32_t const snapshotMagic = 0x534E4150;   // 'SNAP'
+static std::uint32_t const snapshotVersion = 1;
+
+// A ledger entry can't come near this; anything bigger is a bad file
+static std::uint32_t const snapshotMaxNodeSize = 32 * 1024 * 1024;
+
+static void snapshotWrite32 (std::ostream& out, std::uint32_t value)
+{
+    unsigned char bytes[4];
+    bytes[0] = (value >> 24) & 0xff;
+    bytes[1] = (value >> 16) & 0xff;
+    bytes[2] = (value >> 8) & 0xff;
+    bytes[3] = value & 0xff;
+    out.write (reinterpret_cast <char const*> (bytes), 4);
+}
+
+static bool snapshotRead32 (std::istream& in, std::uint32_t& value)
+{
+    unsigned char bytes[4];
+
+    if (! in.read (reinterpret_cast <char*> (bytes), 4))
+        return false;
+
+    value = (static_cast <std::uint32_t> (bytes[0]) << 24) |
+            (static_cast <std::uint32_t> (bytes[1]) << 16) |
+            (static_cast <std::uint32_t> (bytes[2]) << 8) |
+             static_cast <std::uint32_t> (bytes[3]);
+    return true;
+}
+
+bool exportLedgerSnapshot (Ledger::pointer const& ledger,
+    std::string const& path, beast::Journal journal)
+{
+    std::ofstream out (path.c_str (),
+        std::ios::binary | std::ios::trunc);
+
+    if (! out)
+    {
+        journal.error << "Cannot open '" << path << "' for writing";
+        return false;
+    }
+
+    snapshotWrite32 (out, snapshotMagic);
+    snapshotWrite32 (out, snapshotVersion);
+    snapshotWrite32 (out, ledger->getLedgerSeq ());
+    out.write (reinterpret_cast <char const*> (
+        ledger->getHash ().begin ()), 32);
+
+    {
+        Serializer s (128);
+        s.add32 (HashPrefix::ledgerMaster);
+        ledger->addRaw (s);
+        snapshotWrite32 (out, s.getLength ());
+        out.write (reinterpret_cast <char const*> (
+            s.peekData ().data ()), s.getLength ());
+    }
+
+    std::uint64_t nodes = 0;
+
+    try
+    {
+        ledger->peekAccountStateMap ()->visitNodes (
+            [&out, &nodes](SHAMapTreeNode& node)
+            {
+                Serializer s;
+                node.addRaw (s, snfPREFIX);
+                snapshotWrite32 (out, s.getLength ());
+                out.write (reinterpret_cast <char const*> (
+                    s.peekData ().data ()), s.getLength ());
+                ++nodes;
+                return false;
+            });
+    }
+    catch (SHAMapMissingNode& mn)
+    {
+        journal.error << "Snapshot export failed, missing node: " << mn;
+        return false;
+    }
+
+    snapshotWrite32 (out, 0);
+    out.close ();
+
+    if (out.fail ())
+    {
+        journal.error << "Error writing '" << path << "'";
+        return false;
+    }
+
+    journal.warning << "Exported ledger " << ledger->getLedgerSeq () <<
+        " (" << nodes << " state nodes) to '" << path << "'";
+    return true;
+}
+
+bool importLedgerSnapshot (std::string const& path,
+    NodeStore::Database& db, beast::Journal journal)
+{
+    std::ifstream in (path.c_str (), std::ios::binary);
+
+    if (! in)
+    {
+        journal.error << "Cannot open '" << path << "' for reading";
+        return false;
+    }
+
+    std::uint32_t magic, version, seq, headerSize;
+    uint256 declaredHash;
+
+    if (! snapshotRead32 (in, magic) || (magic != snapshotMagic) ||
+        ! snapshotRead32 (in, version) || (version != snapshotVersion))
+    {
+        journal.error << "'" << path << "' is not a version " <<
+            snapshotVersion << " snapshot";
+        return false;
+    }
+
+    if (! snapshotRead32 (in, seq) ||
+        ! in.read (reinterpret_cast <char*> (declaredHash.begin ()), 32) ||
+        ! snapshotRead32 (in, headerSize) ||
+        (headerSize == 0) || (headerSize > 4096))
+    {
+        journal.error << "'" << path << "' has a corrupt header";
+        return false;
+    }
+
+    Blob header (headerSize);
+
+    if (! in.read (reinterpret_cast <char*> (header.data ()), headerSize))
+    {
+        journal.error << "'" << path << "' is truncated";
+        return false;
+    }
+
+    // The header must hash to the ledger hash the file declares. From
+    // here down every node is checked against the hash its parent (or
+    // the header) lists for it, so nothing unverified gets stored.
+    uint256 accountHash;
+    {
+        Serializer s (header);
+
+        if (s.getSHA512Half () != declaredHash)
+        {
+            journal.error << "'" << path <<
+                "': header does not match declared ledger hash";
+            return false;
+        }
+
+        SerializerIterator sit (s);
+        sit.get32 ();               // prefix
+        sit.get32 ();               // sequence
+        sit.get64 ();               // total coins
+        sit.get256 ();              // parent hash
+        sit.get256 ();              // transaction hash
+        accountHash = sit.get256 ();
+    }
+
+    std::stack <uint256, std::vector <uint256>> expected;
+
+    if (accountHash.isNonZero ())
+        expected.push (accountHash);
+
+    std::uint64_t nodes = 0;
+
+    for (;;)
+    {
+        std::uint32_t size;
+
+        if (! snapshotRead32 (in, size))
+        {
+            journal.error << "'" << path << "' is truncated";
+            return false;
+        }
+
+        if (size == 0)
+            break;
+
+        if (size > snapshotMaxNodeSize)
+        {
+            journal.error << "'" << path << "' has an oversized node";
+            return false;
+        }
+
+        if (expected.empty ())
+        {
+            journal.error << "'" << path <<
+                "' contains nodes beyond the state tree";
+            return false;
+        }
+
+        Blob data (size);
+
+        if (! in.read (reinterpret_cast <char*> (data.data ()), size))
+        {
+            journal.error << "'" << path << "' is truncated";
+            return false;
+        }
+
+        uint256 const expectedHash = expected.top ();
+        expected.pop ();
+
+        try
+        {
+            SHAMapTreeNode node (data, 0, snfPREFIX, expectedHash, false);
+
+            if (node.getNodeHash () != expectedHash)
+            {
+                journal.error << "'" << path << "': node " << nodes <<
+                    " does not hash to " << expectedHash;
+                return false;
+            }
+
+            if (node.isInner ())
+            {
+                // Pre-order: the last branch pushed is visited first
+                for (int branch = 15; branch >= 0; --branch)
+                {
+                    if (! node.isEmptyBranch (branch))
+                        expected.push (node.getChildHash (branch));
+                }
+            }
+        }
+        catch (std::exception const& e)
+        {
+            journal.error << "'" << path << "': malformed node " <<
+                nodes << ": " << e.what ();
+            return false;
+        }
+
+        db.store (hotACCOUNT_NODE, seq, std::move (data), expectedHash);
+
+        if ((++nodes % 500000) == 0)
+            journal.warning << nodes << " state nodes imported";
+    }
+
+    if (! expected.empty ())
+    {
+        journal.error << "'" << path << "' ended with " <<
+            expected.size () << " nodes still missing";
+        return false;
+    }
+
+    // Everything checked out; the header goes in last so an aborted
+    // import never leaves a findable ledger over a partial state tree
+    db.store (hotLEDGER, seq, std::move (header), declaredHash);
+
+    journal.warning << "Imported ledger " << seq << " (" << nodes <<
+        " state nodes) from '" << path << "'";
+    return true;
+}
+
+} // ripple
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSNAPSHOT_H_INCLUDED
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/nodestore/Database.h>
+#include <beast/utility/Journal.h>
+#include <string>
+
+namespace ripple {
+
+/** Export and import a ledger's complete state as one verifiable file.
+
+    A snapshot holds the ledger header followed by every account state
+    node in snfPREFIX form, written in the pre-order SHAMap::visitNodes
+    produces. Because each inner node lists its children's hashes, an
+    importer can verify the whole file as a stream against nothing but
+    the ledger hash, then bulk-load it into the node store. This turns
+    provisioning a new node from days of overlay acquisition into one
+    file copy.
+*/
+
+/** Write the ledger's header and full state map to a snapshot file.
+    @return `true` if the snapshot was written completely.
+*/
+bool exportLedgerSnapshot (Ledger::pointer const& ledger,
+    std::string const& path, beast::Journal journal);
+
+/** Verify a snapshot file and bulk-load it into the node store.
+    Nothing is trusted until it checks out: the header must hash to
+    the ledger hash the file declares, and every node must hash to
+    the value its parent (or the header) lists for it.
+    @return `true` if the file verified and was loaded completely.
+*/
+bool importLedgerSnapshot (std::string const& path,
+    NodeStore::Database& db, beast::Journal journal);
+
+} // ripple
+
+#endif
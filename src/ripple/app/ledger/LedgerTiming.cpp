@@ -19,9 +19,27 @@
 
 #include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/basics/Log.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 
 namespace ripple {
 
+namespace {
+
+// Adaptive cadence state. The fixed constants assume a loaded public
+// network; a quiet or well-connected one converges much faster, while
+// a struggling one needs more slack. Track how recent rounds actually
+// went and move the consensus wait and the timer tick between fixed
+// safety bounds. Updated once per completed round and read on every
+// timer tick, so plain atomics are enough.
+std::atomic<int> convergeTimeAvg (0);      // EWMA of converge time
+std::atomic<int> convergeDispersion (0);   // EWMA of |sample - avg|
+std::atomic<int> minConsensusTime (LEDGER_MIN_CONSENSUS);
+std::atomic<int> timerGranularity (LEDGER_GRANULARITY);
+
+}
+
 // VFALCO Should rename ContinuousLedgerTiming to LedgerTiming
 
 // NOTE: First and last times must be repeated
@@ -112,7 +130,7 @@ bool ContinuousLedgerTiming::haveConsensus (
         " time=" << currentAgreeTime <<  "/" << previousAgreeTime <<
         (forReal ? "" : "X");
 
-    if (currentAgreeTime <= LEDGER_MIN_CONSENSUS)
+    if (currentAgreeTime <= getMinConsensusTime ())
         return false;
 
     if (currentProposers < (previousProposers * 3 / 4))
@@ -177,4 +195,52 @@ int ContinuousLedgerTiming::getNextLedgerTimeResolution (int previousResolution,
     return previousResolution;
 }
 
+void ContinuousLedgerTiming::onConsensus (
+    int proposers, int previousProposers, int convergeTimeMs)
+{
+    if ((convergeTimeMs <= 0) || (convergeTimeMs > 600000))
+        return; // out of sane range, as in shouldClose
+
+    int avg = convergeTimeAvg.load ();
+
+    if (avg == 0)
+        avg = convergeTimeMs;
+
+    int disp = convergeDispersion.load ();
+
+    // Quarter-weight exponential averages
+    disp += (std::abs (convergeTimeMs - avg) - disp) / 4;
+    avg += (convergeTimeMs - avg) / 4;
+
+    convergeTimeAvg = avg;
+    convergeDispersion = disp;
+
+    // Wait about half the typical converge time, plus a margin that
+    // grows with dispersion. A round that lost proposers keeps the
+    // stock wait as a lower bound: someone may need the time.
+    int wait = (avg / 2) + (2 * disp);
+
+    if (proposers < previousProposers)
+        wait = std::max (wait, LEDGER_MIN_CONSENSUS);
+
+    wait = std::min (std::max (wait, LEDGER_MIN_CONSENSUS_FLOOR),
+        LEDGER_MIN_CONSENSUS_CEILING);
+    minConsensusTime = wait;
+
+    // Tick about four times per wait, so a shortened wait is not
+    // overshot by most of a full granularity
+    timerGranularity = std::min (
+        std::max (wait / 4, LEDGER_GRANULARITY_MIN), LEDGER_GRANULARITY);
+}
+
+int ContinuousLedgerTiming::getMinConsensusTime ()
+{
+    return minConsensusTime.load ();
+}
+
+int ContinuousLedgerTiming::getTimerGranularity ()
+{
+    return timerGranularity.load ();
+}
+
 } // ripple
@@ -37,6 +37,10 @@ const int LEDGER_EARLY_INTERVAL = 180;
 // The number of milliseconds we wait minimum to ensure participation
 const int LEDGER_MIN_CONSENSUS = 2000;
 
+// Safety bounds for the adaptive minimum consensus wait (milliseconds)
+const int LEDGER_MIN_CONSENSUS_FLOOR = 500;
+const int LEDGER_MIN_CONSENSUS_CEILING = 4000;
+
 // The number of milliseconds we wait minimum to ensure others have computed the LCL
 const int LEDGER_MIN_CLOSE = 2000;
 
@@ -52,6 +56,9 @@ const int LEDGER_RES_DECREASE = 1;
 // How often we check state or change positions (in milliseconds)
 const int LEDGER_GRANULARITY = 1000;
 
+// The fastest we let the adaptive timer tick (in milliseconds)
+const int LEDGER_GRANULARITY_MIN = 250;
+
 // The percentage of active trusted validators that must be able to
 // keep up with the network or we consider the network overloaded
 const int LEDGER_NET_RATIO = 70;
@@ -104,6 +111,17 @@ public:
         bool forReal,               bool& failed);
 
     static int getNextLedgerTimeResolution (int previousResolution, bool previousAgree, int ledgerSeq);
+
+    // Record a completed consensus round so the cadence can adapt
+    static void onConsensus (
+        int proposers, int previousProposers, int convergeTimeMs);
+
+    // The current minimum wait for proposals, adapted from observed
+    // rounds within fixed safety bounds
+    static int getMinConsensusTime ();
+
+    // The current timer granularity, faster when rounds finish early
+    static int getTimerGranularity ();
 };
 
 } // ripple
@@ -37,19 +37,18 @@ void OrderBookDB::setup (Ledger::ref ledger)
         ScopedLockType sl (mLock);
         auto seq = ledger->getLedgerSeq ();
 
-        // Do a full update every 256 ledgers
-        if (mSeq != 0)
+        // Once the books have been discovered they are maintained
+        // incrementally from transaction metadata (see processTxn);
+        // the full scan is only needed at startup, after invalidate,
+        // or if we somehow moved backwards.
+        if ((mSeq != 0) && (seq >= mSeq))
         {
-            if (seq == mSeq)
-                return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
-                return;
-            if ((seq < mSeq) && ((mSeq - seq) < 16))
-                return;
+            mSeq = seq;
+            return;
         }
 
         WriteLog (lsDEBUG, OrderBookDB)
-            << "Advancing from " << mSeq << " to " << seq;
+            << "Full book scan at " << seq;
 
         mSeq = seq;
     }
@@ -126,6 +125,10 @@ void OrderBookDB::update (Ledger::pointer ledger)
         mXRPBooks.swap(XRPBooks);
         mSourceMap.swap(sourceMap);
         mDestMap.swap(destMap);
+
+        // A full scan invalidates the incrementally-maintained tips;
+        // they repopulate from metadata as books see activity.
+        mTips.clear ();
     }
     getApp().getLedgerMaster().newOrderBookDB();
 }
@@ -165,6 +168,63 @@ void OrderBookDB::addOrderBook(Book const& book)
         mXRPBooks.insert(book.in);
 }
 
+void OrderBookDB::removeOrderBook (Book const& book)
+{
+    ScopedLockType sl (mLock);
+
+    auto const removeFrom =
+        [&book](IssueToOrderBook& map, Issue const& key)
+        {
+            auto it = map.find (key);
+
+            if (it == map.end ())
+                return;
+
+            auto& list = it->second;
+
+            for (auto lit = list.begin (); lit != list.end (); ++lit)
+            {
+                if ((*lit)->book () == book)
+                {
+                    list.erase (lit);
+                    break;
+                }
+            }
+
+            if (list.empty ())
+                map.erase (it);
+        };
+
+    removeFrom (mSourceMap, book.in);
+    removeFrom (mDestMap, book.out);
+    mTips.erase (book);
+    mSnapshots.erase (book);
+    mHotBooks.erase (book);
+
+    if (isXRP (book.out))
+    {
+        // Only forget the to-XRP flag if no other book from this
+        // issue still goes to XRP
+        bool anotherToXRP = false;
+
+        auto it = mSourceMap.find (book.in);
+        if (it != mSourceMap.end ())
+        {
+            for (auto const& ob : it->second)
+            {
+                if (isXRP (ob->getCurrencyOut ()))
+                {
+                    anotherToXRP = true;
+                    break;
+                }
+            }
+        }
+
+        if (! anotherToXRP)
+            mXRPBooks.erase (book.in);
+    }
+}
+
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List OrderBookDB::getBooksByTakerPays (Issue const& issue)
 {
@@ -196,6 +256,310 @@ BookListeners::pointer OrderBookDB::makeBookListeners (Book const& book)
 
         mListeners [book] = ret;
         assert (getBookListeners (book) == ret);
+
+        // Subscribed books are served from memory: have a snapshot
+        // built when the next ledger is accepted
+        mHotBooks.insert (book);
+    }
+
+    return ret;
+}
+
+// The number of offers remembered per book. Deep books are re-read
+// from the ledger past this point anyway, so there is no benefit to
+// remembering more than a crossing is likely to consume.
+static std::size_t const tipCacheSize = 8;
+
+void OrderBookDB::updateBookTips (Book const& book, uint256 const& dir,
+    uint256 const& offer, bool deleted)
+{
+    // Caller holds mLock
+    auto& tips = mTips [book];
+
+    for (auto it = tips.begin (); it != tips.end (); ++it)
+    {
+        if (it->offer == offer)
+        {
+            tips.erase (it);
+            break;
+        }
+    }
+
+    if (! deleted)
+    {
+        // Directory indexes for one book sort by quality,
+        // best first
+        auto it = tips.begin ();
+        while ((it != tips.end ()) && (it->dir <= dir))
+            ++it;
+        tips.insert (it, TipEntry {dir, offer});
+
+        if (tips.size () > tipCacheSize)
+            tips.resize (tipCacheSize);
+    }
+    else if (tips.empty ())
+        mTips.erase (book);
+}
+
+// The deepest book a snapshot will materialize. Matches the most
+// offers a single book_offers request will return, so anything a
+// snapshot cannot serve would have been a long ledger walk anyway.
+static std::size_t const snapshotDepth = 300;
+
+// Snapshots of books nobody subscribes to are dropped after this many
+// ledgers without a read.
+static std::uint32_t const snapshotIdleLedgers = 64;
+
+// Cap on the number of books kept materialized.
+static std::size_t const snapshotCacheSize = 64;
+
+void OrderBookDB::updateSnapshot (Ledger::ref ledger, Book const& book,
+    STObject const& fields, uint256 const& offerIndex, bool deleted)
+{
+    // Caller holds mLock
+    auto it = mSnapshots.find (book);
+
+    if (it == mSnapshots.end ())
+        return;
+
+    BookSnapshot& snap = *it->second;
+
+    // A snapshot can only be advanced from the state of this ledger's
+    // parent. Anything else means we missed a ledger's metadata and
+    // the book must be rebuilt before it can serve reads again.
+    if (snap.updating != ledger->getHash ())
+    {
+        if (snap.asOf != ledger->getParentHash ())
+        {
+            snap.offers.clear ();
+            snap.asOf.zero ();
+            snap.updating.zero ();
+            return;
+        }
+
+        snap.updating = ledger->getHash ();
+        snap.asOf.zero ();
+    }
+
+    uint256 const dir = fields.getFieldH256 (sfBookDirectory);
+
+    // Offers past the tail of a partial snapshot are not tracked
+    if (!snap.full && (dir > snap.tailDir))
+        return;
+
+    auto const range = snap.offers.equal_range (dir);
+
+    if (deleted)
+    {
+        for (auto oit = range.first; oit != range.second; ++oit)
+        {
+            if (oit->second->getIndex () == offerIndex)
+            {
+                snap.offers.erase (oit);
+                break;
+            }
+        }
+
+        return;
+    }
+
+    SLE::pointer sleOffer = ledger->getSLEi (offerIndex);
+
+    if (!sleOffer)
+    {
+        // The metadata says the offer is in this ledger
+        assert (false);
+        snap.offers.clear ();
+        snap.asOf.zero ();
+        snap.updating.zero ();
+        return;
+    }
+
+    // A consumed offer keeps its place in the directory; a new offer
+    // joins the end of its quality level, just as dirAdd places it.
+    for (auto oit = range.first; oit != range.second; ++oit)
+    {
+        if (oit->second->getIndex () == offerIndex)
+        {
+            oit->second = sleOffer;
+            return;
+        }
+    }
+
+    snap.offers.insert (std::make_pair (dir, sleOffer));
+}
+
+void OrderBookDB::rebuildSnapshot (Ledger::ref ledger, Book const& book,
+    BookSnapshot& snap)
+{
+    // Caller holds mLock
+    snap.offers.clear ();
+    snap.full = true;
+    snap.tailDir.zero ();
+    snap.asOf.zero ();
+    snap.updating.zero ();
+
+    uint256 const uBookEnd = getQualityNext (getBookBase (book));
+    uint256 uTipIndex = getBookBase (book);
+
+    try
+    {
+        LedgerEntrySet les (ledger, tapNONE, true);
+
+        for (;;)
+        {
+            uint256 const dirIndex =
+                ledger->getNextLedgerIndex (uTipIndex, uBookEnd);
+
+            if (dirIndex.isZero ())
+                break;
+
+            uTipIndex = dirIndex;
+
+            if (snap.offers.size () >= snapshotDepth)
+            {
+                // Deeper than we materialize: the directories we did
+                // not visit stay outside the snapshot
+                snap.full = false;
+                break;
+            }
+
+            SLE::pointer sleOfferDir;
+            unsigned int uBookEntry;
+            uint256 offerIndex;
+
+            if (les.dirFirst (uTipIndex, sleOfferDir, uBookEntry, offerIndex))
+            {
+                do
+                {
+                    SLE::pointer sleOffer = ledger->getSLEi (offerIndex);
+
+                    if (sleOffer)
+                        snap.offers.insert (
+                            std::make_pair (uTipIndex, sleOffer));
+                }
+                while (les.dirNext (
+                    uTipIndex, sleOfferDir, uBookEntry, offerIndex));
+            }
+
+            snap.tailDir = uTipIndex;
+        }
+
+        snap.asOf = ledger->getHash ();
+    }
+    catch (const SHAMapMissingNode&)
+    {
+        WriteLog (lsINFO, OrderBookDB)
+            << "Missing node building book snapshot";
+        snap.offers.clear ();
+        snap.asOf.zero ();
+    }
+}
+
+std::vector <OrderBookDB::BookOffer> OrderBookDB::getSnapshotOffers (
+    Book const& book, Ledger::ref ledger, unsigned int iLimit)
+{
+    std::vector <BookOffer> ret;
+    ScopedLockType sl (mLock);
+
+    auto it = mSnapshots.find (book);
+
+    if (it == mSnapshots.end ())
+    {
+        // Not materialized: remember the interest so a snapshot is
+        // built when the next ledger is accepted
+        mHotBooks.insert (book);
+        return ret;
+    }
+
+    BookSnapshot& snap = *it->second;
+    snap.lastUse = ledger->getLedgerSeq ();
+
+    // Only the exact ledger the snapshot was sealed against is served
+    if (snap.asOf != ledger->getHash ())
+        return ret;
+
+    // A partial snapshot can only serve requests it can fill
+    if (!snap.full && (snap.offers.size () < iLimit))
+        return ret;
+
+    ret.reserve (std::min <std::size_t> (iLimit, snap.offers.size ()));
+
+    for (auto const& entry : snap.offers)
+    {
+        if (ret.size () >= iLimit)
+            break;
+
+        ret.push_back (BookOffer {entry.first, entry.second});
+    }
+
+    return ret;
+}
+
+void OrderBookDB::sealBookSnapshots (Ledger::ref ledger)
+{
+    ScopedLockType sl (mLock);
+
+    uint256 const hash = ledger->getHash ();
+    uint256 const parent = ledger->getParentHash ();
+    std::uint32_t const seq = ledger->getLedgerSeq ();
+
+    for (auto const& book : mHotBooks)
+    {
+        if ((mSnapshots.count (book) == 0) &&
+            (mSnapshots.size () < snapshotCacheSize))
+        {
+            auto snap = std::make_shared <BookSnapshot> ();
+            snap->lastUse = seq;
+            mSnapshots.emplace (book, snap);
+        }
+    }
+
+    mHotBooks.clear ();
+
+    for (auto it = mSnapshots.begin (); it != mSnapshots.end ();)
+    {
+        BookSnapshot& snap = *it->second;
+
+        if (snap.updating == hash)
+        {
+            // All of this ledger's metadata has been applied
+            snap.asOf = hash;
+            snap.updating.zero ();
+        }
+        else if (snap.asOf == parent)
+        {
+            // Nothing in this ledger touched the book
+            snap.asOf = hash;
+        }
+        else
+        {
+            // Newly materialized, or continuity was lost
+            rebuildSnapshot (ledger, it->first, snap);
+        }
+
+        // Subscribed books stay; others are dropped when idle
+        if ((mListeners.count (it->first) == 0) &&
+            (snap.lastUse + snapshotIdleLedgers < seq))
+        {
+            it = mSnapshots.erase (it);
+        }
+        else
+            ++it;
+    }
+}
+
+std::vector <uint256> OrderBookDB::getBookTips (Book const& book)
+{
+    std::vector <uint256> ret;
+    ScopedLockType sl (mLock);
+
+    auto it = mTips.find (book);
+    if (it != mTips.end ())
+    {
+        ret.reserve (it->second.size ());
+        for (auto const& tip : it->second)
+            ret.push_back (tip.offer);
     }
 
     return ret;
@@ -256,6 +620,84 @@ void OrderBookDB::processTxn (
 
                             if (listeners)
                                 listeners->publish (jvObj);
+
+                            Book const offerBook (
+                                data->getFieldAmount (sfTakerPays).issue(),
+                                data->getFieldAmount (sfTakerGets).issue());
+
+                            // Maintain the book tip cache from the
+                            // metadata so offer crossing can warm its
+                            // caches without walking the directories.
+                            // Modified offers keep their directory, so
+                            // only creations and deletions matter here.
+                            if ((node.getFName () != sfModifiedNode) &&
+                                data->isFieldPresent (sfBookDirectory))
+                            {
+                                updateBookTips (offerBook,
+                                    data->getFieldH256 (sfBookDirectory),
+                                    node.getFieldH256 (sfLedgerIndex),
+                                    node.getFName () == sfDeletedNode);
+                            }
+
+                            // Keep any materialized snapshot of the
+                            // book current. A modified offer's
+                            // directory comes from its final fields:
+                            // the previous fields only carry what the
+                            // transaction changed.
+                            auto snapFields = data;
+
+                            if (node.getFName () == sfModifiedNode)
+                                snapFields = dynamic_cast<const STObject*> (
+                                    node.peekAtPField (sfFinalFields));
+
+                            if (snapFields &&
+                                snapFields->isFieldPresent (sfBookDirectory))
+                            {
+                                updateSnapshot (ledger, offerBook,
+                                    *snapFields,
+                                    node.getFieldH256 (sfLedgerIndex),
+                                    node.getFName () == sfDeletedNode);
+                            }
+                        }
+                    }
+                }
+                else if (node.getFieldU16 (sfLedgerEntryType) == ltDIR_NODE)
+                {
+                    // Keep the book list current: a created or deleted
+                    // directory that is a book root adds or retires
+                    // that book, with no ledger scan required.
+                    SField const* field = nullptr;
+
+                    if (node.getFName () == sfCreatedNode)
+                        field = &sfNewFields;
+                    else if (node.getFName () == sfDeletedNode)
+                        field = &sfFinalFields;
+
+                    if (field)
+                    {
+                        auto data = dynamic_cast<const STObject*> (
+                            node.peekAtPField (*field));
+
+                        if (data &&
+                            data->isFieldPresent (sfExchangeRate) &&
+                            data->isFieldPresent (sfRootIndex) &&
+                            (data->getFieldH256 (sfRootIndex) ==
+                                node.getFieldH256 (sfLedgerIndex)))
+                        {
+                            Book book;
+                            book.in.currency.copyFrom (
+                                data->getFieldH160 (sfTakerPaysCurrency));
+                            book.in.account.copyFrom (
+                                data->getFieldH160 (sfTakerPaysIssuer));
+                            book.out.currency.copyFrom (
+                                data->getFieldH160 (sfTakerGetsCurrency));
+                            book.out.account.copyFrom (
+                                data->getFieldH160 (sfTakerGetsIssuer));
+
+                            if (node.getFName () == sfCreatedNode)
+                                addOrderBook (book);
+                            else
+                                removeOrderBook (book);
                         }
                     }
                 }
@@ -39,6 +39,9 @@ public:
 
     void addOrderBook(Book const&);
 
+    /** Retire a book whose root directory was deleted. */
+    void removeOrderBook (Book const&);
+
     /** @return a list of all orderbooks that want this issuerID and currencyID.
      */
     OrderBook::List getBooksByTakerPays (Issue const&);
@@ -52,6 +55,42 @@ public:
     BookListeners::pointer getBookListeners (Book const&);
     BookListeners::pointer makeBookListeners (Book const&);
 
+    /** @return the indexes of the best offers cached for this book.
+
+        The tips are maintained from accepted ledger metadata and are
+        ordered best quality first. They are advisory only: entries can
+        be stale with respect to the open ledger, so callers may use
+        them to warm caches but never to decide transaction outcomes.
+    */
+    std::vector <uint256> getBookTips (Book const&);
+
+    /** One offer in a materialized book: the directory it lives in
+        (which encodes its quality) and the immutable entry itself. */
+    struct BookOffer
+    {
+        uint256 dir;
+        SLE::pointer offer;
+    };
+
+    /** Fetch the materialized offers of a book as of a given ledger.
+
+        Returns up to iLimit offers, best quality first, exactly as the
+        book stands in the given ledger. Returns an empty vector if no
+        snapshot can serve the request; the caller then reads the book
+        from the ledger itself. Asking for a book that is not
+        materialized marks it hot, so a snapshot is built when the next
+        ledger is accepted.
+    */
+    std::vector <BookOffer> getSnapshotOffers (Book const&,
+        Ledger::ref ledger, unsigned int iLimit);
+
+    /** Called after all of an accepted ledger's metadata has been
+        processed (see processTxn). Seals updated snapshots at this
+        ledger, builds snapshots for newly hot books and retires
+        snapshots nobody is reading.
+    */
+    void sealBookSnapshots (Ledger::ref ledger);
+
     // see if this txn effects any orderbook
     void processTxn (
         Ledger::ref ledger, const AcceptedLedgerTx& alTx,
@@ -62,6 +101,50 @@ public:
 private:
     void rawAddBook(Book const&);
 
+    void updateBookTips (Book const&, uint256 const& dir,
+        uint256 const& offer, bool deleted);
+
+    // A materialized book, maintained from accepted ledger metadata
+    struct BookSnapshot
+    {
+        typedef std::shared_ptr <BookSnapshot> pointer;
+
+        BookSnapshot ()
+            : full (true)
+            , lastUse (0)
+        {
+        }
+
+        // Offers keyed by book directory index, so iteration goes
+        // best quality first. Offers within one directory keep the
+        // directory's own order.
+        std::multimap <uint256, SLE::pointer> offers;
+
+        // The ledger this snapshot exactly reflects; zero while a new
+        // ledger's metadata is being applied or after continuity with
+        // the published ledger stream was lost.
+        uint256 asOf;
+
+        // The ledger whose metadata is currently being applied
+        uint256 updating;
+
+        // False if the book was deeper than snapshotDepth when built
+        bool full;
+
+        // For a partial snapshot, the last directory that is fully
+        // covered; offers in directories past it are not tracked.
+        uint256 tailDir;
+
+        // Sequence of the last ledger a reader asked for, for eviction
+        std::uint32_t lastUse;
+    };
+
+    void updateSnapshot (Ledger::ref ledger, Book const& book,
+        STObject const& fields, uint256 const& offerIndex, bool deleted);
+
+    void rebuildSnapshot (Ledger::ref ledger, Book const& book,
+        BookSnapshot& snap);
+
     // by ci/ii
     IssueToOrderBook mSourceMap;
 
@@ -80,6 +163,25 @@ private:
 
     BookToListenersMap mListeners;
 
+    // Best offers per book, ordered by directory index
+    // (best quality first), capped at tipCacheSize entries
+    struct TipEntry
+    {
+        uint256 dir;
+        uint256 offer;
+    };
+
+    typedef hash_map <Book, std::vector <TipEntry>> BookToTipsMap;
+
+    BookToTipsMap mTips;
+
+    typedef hash_map <Book, BookSnapshot::pointer> BookToSnapshotMap;
+
+    BookToSnapshotMap mSnapshots;
+
+    // Books readers asked for that have no snapshot yet
+    hash_set <Book> mHotBooks;
+
     std::uint32_t mSeq;
 };
 
@@ -28,6 +28,7 @@ BookDirIterator::BookDirIterator(
             {currencyOut, issuerOut}});
     mEnd = getQualityNext(mBase);
     mIndex = mBase;
+    mQuality = 0;
 }
 
 bool BookDirIterator::nextDirectory (LedgerEntrySet& les)
@@ -50,6 +51,9 @@ bool BookDirIterator::nextDirectory (LedgerEntrySet& les)
     }
     assert (mIndex < mEnd);
 
+    // Decode the quality once per directory page
+    mQuality = getQuality (mIndex);
+
     WriteLog (lsTRACE, Ledger) <<
         "BookDirectoryIterator:: index " << to_string (mIndex);
 
@@ -94,7 +98,7 @@ DirectoryEntryIterator BookDirIterator::getOfferIterator () const
 
 std::uint64_t BookDirIterator::getRate () const
 {
-    return getQuality(mIndex);
+    return mQuality;
 }
 
 bool BookDirIterator::addJson (Json::Value& jv) const
@@ -114,6 +118,7 @@ bool BookDirIterator::setJson(Json::Value const& jv)
     if (!bi.isString ())
         return false;
     mIndex.SetHexExact(bi.asString());
+    mQuality = getQuality (mIndex);
     return true;
 }
 
@@ -29,6 +29,7 @@ class BookDirIterator
 public:
 
     BookDirIterator ()
+        : mQuality (0)
     {
     }
 
@@ -54,6 +55,7 @@ public:
     void setCurrentIndex(uint256 const& index)
     {
         mIndex = index;
+        mQuality = getQuality (mIndex);
     }
 
     /** Get the current exchange rate
@@ -64,10 +66,11 @@ public:
     }
 
     /** Get the current quality
+        Decoded once per directory page; comparisons stay integer.
     */
     std::uint64_t getCurrentQuality () const
     {
-        return getQuality(mIndex);
+        return mQuality;
     }
 
     /** Make this iterator refer to the next book
@@ -114,6 +117,7 @@ private:
     uint256      mBase;     // The first index a directory in the book can have
     uint256      mEnd;      // The first index a directory in the book cannot have
     uint256      mIndex;    // The index we are currently on
+    std::uint64_t mQuality; // The quality decoded from mIndex
     SLE::pointer mOfferDir; // The directory page we are currently on
 };
 
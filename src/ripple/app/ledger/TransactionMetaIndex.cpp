@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Log.h>
+#include <cstring>
+
+namespace ripple {
+
+void TransactionMetaIndex::open (boost::filesystem::path const& dataDir)
+{
+    ScopedLockType sl (mLock);
+
+    if (mOpen || dataDir.empty ())
+        return;
+
+    auto const packPath = dataDir / "txmeta.pack";
+    auto const indexPath = dataDir / "txmeta.index";
+
+    // Make sure both files exist so we can open them for update
+    if (!boost::filesystem::exists (packPath))
+        std::ofstream create (packPath.string ().c_str ());
+
+    if (!boost::filesystem::exists (indexPath))
+        std::ofstream create (indexPath.string ().c_str ());
+
+    mPackFile.open (packPath.string ().c_str (),
+        std::ios::in | std::ios::out | std::ios::binary);
+    mIndexFile.open (indexPath.string ().c_str (),
+        std::ios::in | std::ios::out | std::ios::binary);
+
+    if (!mPackFile.is_open () || !mIndexFile.is_open ())
+    {
+        WriteLog (lsWARNING, TransactionMetaIndex) <<
+            "Unable to open transaction metadata index in " << dataDir;
+        mPackFile.close ();
+        mIndexFile.close ();
+        return;
+    }
+
+    load ();
+    mOpen = true;
+
+    WriteLog (lsINFO, TransactionMetaIndex) <<
+        "Transaction metadata index has " << mIndex.size () << " entries";
+}
+
+void TransactionMetaIndex::load ()
+{
+    mPackFile.seekg (0, std::ios::end);
+    mPackSize = mPackFile.tellg ();
+
+    mIndexFile.seekg (0, std::ios::end);
+    std::uint64_t const records =
+        static_cast <std::uint64_t> (mIndexFile.tellg ()) / recordBytes;
+    mIndexFile.seekg (0);
+
+    unsigned char rec[recordBytes];
+    std::uint64_t good = 0;
+
+    for (std::uint64_t i = 0; i < records; ++i)
+    {
+        mIndexFile.read (reinterpret_cast <char*> (rec), recordBytes);
+
+        if (!mIndexFile)
+            break;
+
+        uint256 txID;
+        Entry e;
+        memcpy (txID.begin (), rec, 32);
+        memcpy (&e.seq, rec + 32, 4);
+        memcpy (&e.offset, rec + 36, 8);
+        memcpy (&e.size, rec + 44, 4);
+
+        // Stop at a record pointing past the packed data (a torn write)
+        if ((e.offset + e.size) > mPackSize)
+            break;
+
+        mIndex[txID] = e;
+        ++good;
+    }
+
+    mIndexFile.clear ();
+
+    // New records overwrite any torn tail
+    mIndexFile.seekp (good * recordBytes);
+}
+
+void TransactionMetaIndex::addLedger (AcceptedLedger const& ledger)
+{
+    ScopedLockType sl (mLock);
+
+    if (!mOpen)
+        return;
+
+    std::uint32_t const seq = ledger.getLedgerSeq ();
+    std::vector <unsigned char> records;
+
+    mPackFile.seekp (mPackSize);
+
+    for (auto const& vt : ledger.getMap ())
+    {
+        Blob const meta = compressTxnMeta (vt.second->getRawMeta ());
+
+        if (meta.empty ())
+            continue;
+
+        uint256 const txID = vt.second->getTransactionID ();
+
+        Entry e;
+        e.seq = seq;
+        e.offset = mPackSize;
+        e.size = static_cast <std::uint32_t> (meta.size ());
+
+        mPackFile.write (
+            reinterpret_cast <char const*> (meta.data ()), meta.size ());
+        mPackSize += e.size;
+
+        unsigned char rec[recordBytes];
+        memcpy (rec, txID.begin (), 32);
+        memcpy (rec + 32, &e.seq, 4);
+        memcpy (rec + 36, &e.offset, 8);
+        memcpy (rec + 44, &e.size, 4);
+        records.insert (records.end (), rec, rec + recordBytes);
+
+        mIndex[txID] = e;
+    }
+
+    if (records.empty ())
+        return;
+
+    // The packed data is flushed before the index records are written,
+    // so a crash can never leave a record pointing at missing data
+    mPackFile.flush ();
+    mIndexFile.write (
+        reinterpret_cast <char const*> (records.data ()), records.size ());
+    mIndexFile.flush ();
+
+    if (!mPackFile || !mIndexFile)
+    {
+        WriteLog (lsWARNING, TransactionMetaIndex) <<
+            "Error writing transaction metadata index; disabling it";
+        mOpen = false;
+    }
+}
+
+bool TransactionMetaIndex::getMeta (
+    uint256 const& txID, std::uint32_t& ledgerSeq, Blob& meta)
+{
+    ScopedLockType sl (mLock);
+
+    if (!mOpen)
+        return false;
+
+    auto const it = mIndex.find (txID);
+
+    if (it == mIndex.end ())
+        return false;
+
+    meta.resize (it->second.size);
+    mPackFile.seekg (it->second.offset);
+    mPackFile.read (reinterpret_cast <char*> (meta.data ()), meta.size ());
+
+    if (!mPackFile)
+    {
+        mPackFile.clear ();
+        return false;
+    }
+
+    try
+    {
+        meta = decompressTxnMeta (meta);
+    }
+    catch (...)
+    {
+        // A torn pack file is a miss; the caller falls back to the ledger
+        return false;
+    }
+
+    ledgerSeq = it->second.seq;
+    return true;
+}
+
+std::size_t TransactionMetaIndex::size () const
+{
+    ScopedLockType sl (mLock);
+    return mIndex.size ();
+}
+
+} // ripple
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TRANSACTIONMETAINDEX_H
+#define RIPPLE_TRANSACTIONMETAINDEX_H
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ripple {
+
+/** An on-disk index of transaction metadata by transaction ID.
+
+    Serving the metadata for a historical transaction normally means
+    loading the whole ledger it was in and walking its transaction map.
+    This index keeps the raw metadata of every transaction in every
+    validated ledger in a packed append-only file, with an index file
+    mapping transaction ID to (ledger sequence, offset, size), so a
+    lookup is one hash probe and one read.
+
+    The index file is loaded into memory at startup and both files are
+    appended to as each ledger is accepted. A missing or truncated
+    index simply produces misses; callers fall back to the ledger. The
+    files are node-local and records are stored in host byte order.
+*/
+class TransactionMetaIndex
+{
+public:
+    TransactionMetaIndex () = default;
+
+    TransactionMetaIndex (TransactionMetaIndex const&) = delete;
+    TransactionMetaIndex& operator= (TransactionMetaIndex const&) = delete;
+
+    /** Open (creating if needed) the packed and index files.
+        Loads the existing index into memory. If this is never called,
+        every lookup misses and nothing is recorded.
+    */
+    void open (boost::filesystem::path const& dataDir);
+
+    /** Record the metadata of every transaction in an accepted ledger. */
+    void addLedger (AcceptedLedger const& ledger);
+
+    /** Look up a transaction's metadata.
+        @return `true`, with the sequence of the ledger the transaction
+                was validated in and its raw metadata, on a hit.
+    */
+    bool getMeta (uint256 const& txID, std::uint32_t& ledgerSeq, Blob& meta);
+
+    /** The number of transactions indexed. */
+    std::size_t size () const;
+
+private:
+    // Where a transaction's metadata lives in the packed file
+    struct Entry
+    {
+        std::uint32_t seq;
+        std::uint64_t offset;
+        std::uint32_t size;
+    };
+
+    // txID (32), seq (4), offset (8), size (4)
+    static std::size_t const recordBytes = 48;
+
+    void load ();
+
+    typedef RippleMutex LockType;
+    typedef std::lock_guard <LockType> ScopedLockType;
+
+    mutable LockType mLock;
+
+    bool mOpen = false;
+    std::fstream mPackFile;
+    std::fstream mIndexFile;
+    std::uint64_t mPackSize = 0;
+
+    hash_map <uint256, Entry> mIndex;
+};
+
+} // ripple
+
+#endif
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <snappy.h>
+
+#include <stdexcept>
+
+namespace ripple {
+
+namespace {
+
+// Marks a compressed blob. A serialized metadata set always begins
+// with a field header whose first byte is nonzero, so a leading zero
+// byte cannot occur in a legacy row.
+unsigned char const metaMarker[2] = { 0x00, 'S' };
+
+// Below this size the marker overhead and the compressor's own framing
+// eat any savings
+std::size_t const compressThreshold = 128;
+
+}
+
+Blob compressTxnMeta (Blob const& meta)
+{
+    if (meta.size () < compressThreshold)
+        return meta;
+
+    std::string compressed;
+    snappy::Compress (reinterpret_cast <char const*> (
+        meta.data ()), meta.size (), &compressed);
+
+    // Only keep the compressed form if it actually saves space
+    if ((compressed.size () + sizeof (metaMarker)) >= meta.size ())
+        return meta;
+
+    Blob out;
+    out.reserve (sizeof (metaMarker) + compressed.size ());
+    out.insert (out.end (), metaMarker, metaMarker + sizeof (metaMarker));
+    out.insert (out.end (), compressed.begin (), compressed.end ());
+    return out;
+}
+
+Blob decompressTxnMeta (Blob const& stored)
+{
+    if ((stored.size () < sizeof (metaMarker)) ||
+            (stored[0] != metaMarker[0]) || (stored[1] != metaMarker[1]))
+        return stored;
+
+    char const* const data = reinterpret_cast <char const*> (
+        stored.data ()) + sizeof (metaMarker);
+    std::size_t const bytes = stored.size () - sizeof (metaMarker);
+
+    std::size_t uncompressedBytes;
+
+    if (!snappy::GetUncompressedLength (data, bytes, &uncompressedBytes))
+        throw std::runtime_error ("Corrupt compressed transaction metadata");
+
+    Blob meta (uncompressedBytes);
+
+    if (!snappy::RawUncompress (data, bytes,
+            reinterpret_cast <char*> (meta.data ())))
+        throw std::runtime_error ("Corrupt compressed transaction metadata");
+
+    return meta;
+}
+
+} // ripple
@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TXNMETACODEC_H
+#define RIPPLE_TXNMETACODEC_H
+
+#include <ripple/basics/Blob.h>
+
+namespace ripple {
+
+/** Compression of transaction metadata for node-local storage.
+
+    The canonical metadata encoding is part of consensus: each entry in
+    a ledger's transaction tree hashes the raw transaction together with
+    its raw metadata, so the serialized form itself cannot change. The
+    copies a server keeps for its own use -- the TxnMeta column of the
+    transaction database and the packed metadata index -- carry no such
+    constraint, and metadata's repetitive before/after field images make
+    it by far the most compressible bulk we store.
+
+    compressTxnMeta produces a blob for local storage: a two byte marker
+    followed by the snappy-compressed metadata, or the input unchanged
+    when compression does not pay. The marker starts with a zero byte,
+    which can never begin a serialized metadata set (the first field
+    header emitted is always nonzero), so legacy rows written before
+    this encoding remain readable and both forms coexist in one table.
+
+    decompressTxnMeta restores the canonical encoding, passing unmarked
+    (legacy or incompressible) blobs through untouched. It throws if a
+    marked blob does not inflate, since such a row is corrupt and would
+    not parse as metadata either way.
+*/
+Blob compressTxnMeta (Blob const& meta);
+
+Blob decompressTxnMeta (Blob const& stored);
+
+} // ripple
+
+#endif
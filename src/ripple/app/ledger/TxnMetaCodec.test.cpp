@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class TxnMetaCodec_test : public beast::unit_test::suite
+{
+    void testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        // Repetitive, like real metadata; must compress
+        Blob meta (4096, 0x20);
+        for (std::size_t i = 0; i < meta.size (); i += 7)
+            meta[i] = static_cast <unsigned char> (i & 0xff);
+
+        Blob const stored = compressTxnMeta (meta);
+        expect (stored.size () < meta.size (), "did not compress");
+        expect (stored.size () >= 2 && stored[0] == 0x00, "missing marker");
+        expect (decompressTxnMeta (stored) == meta, "did not round trip");
+    }
+
+    void testPassThrough ()
+    {
+        testcase ("pass through");
+
+        // Too small to bother compressing
+        Blob small (16, 0x42);
+        expect (compressTxnMeta (small) == small);
+        expect (decompressTxnMeta (small) == small);
+
+        // Incompressible data is stored as-is
+        Blob noise (4096);
+        std::uint32_t x = 0x12345678;
+        for (auto& b : noise)
+        {
+            x = x * 1664525 + 1013904223;
+            b = static_cast <unsigned char> (x >> 24);
+        }
+        expect (compressTxnMeta (noise) == noise);
+        expect (decompressTxnMeta (noise) == noise);
+
+        // A legacy row (no marker) decodes to itself
+        Blob legacy (512, 0x25); // nonzero first byte, as serialized meta
+        expect (decompressTxnMeta (legacy) == legacy);
+
+        Blob const empty;
+        expect (compressTxnMeta (empty).empty ());
+        expect (decompressTxnMeta (empty).empty ());
+    }
+
+    void testCorrupt ()
+    {
+        testcase ("corrupt");
+
+        Blob meta (4096, 0x20);
+        Blob stored = compressTxnMeta (meta);
+        expect (stored.size () > 8);
+
+        // Damage the compressed payload; decoding must throw, not
+        // hand back garbage
+        stored.resize (stored.size () / 2);
+
+        try
+        {
+            decompressTxnMeta (stored);
+            fail ("did not detect corruption");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass ();
+        }
+    }
+
+public:
+    void run ()
+    {
+        testRoundTrip ();
+        testPassThrough ();
+        testCorrupt ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxnMetaCodec,ripple_app,ripple);
+
+} // ripple
@@ -18,8 +18,11 @@
 //==============================================================================
 
 #include <ripple/app/impl/BasicApp.h>
+#include <ripple/app/ledger/HistoryShards.h>
+#include <ripple/app/main/CacheBudget.h>
 #include <ripple/app/main/Tuning.h>
 #include <ripple/app/misc/SHAMapStore.h>
+#include <ripple/app/misc/SignatureVerifier.h>
 #include <ripple/app/paths/FindPaths.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/LoggedTimings.h>
@@ -28,6 +31,8 @@
 #include <ripple/basics/make_SSLContext.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/core/LoadFeeTrack.h>
+#include <ripple/core/TimerWheel.h>
+#include <ripple/crypto/SignatureEngine.h>
 #include <ripple/net/SNTPClient.h>
 #include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/DummyScheduler.h>
@@ -47,6 +52,22 @@ namespace ripple {
 // 204/256 about 80%
 static int const MAJORITY_FRACTION (204);
 
+// Write a list of node hashes to a warm file in the format
+// NodeStore::Database::primeCacheKeys consumes: raw 32 byte keys,
+// back to back. Best effort; a failed write just means a cold start.
+static void saveWarmKeys (std::string const& path,
+    std::vector <uint256> const& keys)
+{
+    std::ofstream out (path.c_str (),
+        std::ios::binary | std::ios::trunc);
+
+    if (! out)
+        return;
+
+    for (auto const& key : keys)
+        out.write (reinterpret_cast <char const*> (key.begin ()), 32);
+}
+
 // This hack lets the s_instance variable remain set during
 // the call to ~Application
 class ApplicationImpBase : public Application
@@ -151,7 +172,10 @@ private:
 public:
     Logs& m_logs;
     beast::Journal m_journal;
-    Application::LockType m_masterMutex;
+    // The decomposed master lock; see MasterLock.h
+    MasterLockDomain m_consensusLock;
+    MasterLockDomain m_openLedgerLock;
+    MasterLockDomain m_netStateLock;
 
     std::unique_ptr <NodeStore::Manager> m_nodeStoreManager;
     NodeStoreScheduler m_nodeStoreScheduler;
@@ -164,7 +188,11 @@ public:
     SLECache m_sleCache;
     LocalCredentials m_localCredentials;
     TransactionMaster m_txMaster;
+    TransactionMetaIndex m_txMetaIndex;
+    LedgerHashIndex m_ledgerHashIndex;
+    TimerWheel m_timerWheel;
 
+    std::unique_ptr <CacheBudget> m_cacheBudget;
     std::unique_ptr <CollectorManager> m_collectorManager;
     std::unique_ptr <Resource::Manager> m_resourceManager;
     std::unique_ptr <FullBelowCache> m_fullBelowCache;
@@ -176,6 +204,7 @@ public:
     OrderBookDB m_orderBookDB;
     std::unique_ptr <PathRequests> m_pathRequests;
     std::unique_ptr <LedgerMaster> m_ledgerMaster;
+    std::unique_ptr <HistoryShards> m_historyShards;
     std::unique_ptr <InboundLedgers> m_inboundLedgers;
     std::unique_ptr <NetworkOPs> m_networkOPs;
     std::unique_ptr <UniqueNodeList> m_deprecatedUNL;
@@ -185,10 +214,24 @@ public:
     std::unique_ptr <AmendmentTable> m_amendmentTable;
     std::unique_ptr <LoadFeeTrack> mFeeTrack;
     std::unique_ptr <IHashRouter> mHashRouter;
+    std::unique_ptr <SignatureVerifier> m_signatureVerifier;
     std::unique_ptr <Validations> mValidations;
     std::unique_ptr <LoadManager> m_loadManager;
     beast::DeadlineTimer m_sweepTimer;
 
+    // Caches are swept one bounded step at a time, staggered across
+    // the sweep interval; see doSweep. Sliced targets return false
+    // until they finish a pass over their cache.
+    enum
+    {
+        // Partitions a sliced cache sweeps per step
+        sweepSlicePartitions = 2
+    };
+    typedef std::pair <char const*, std::function <bool ()>> SweepTarget;
+    std::vector <SweepTarget> m_sweepTargets;
+    std::size_t m_sweepCursor;
+    int m_sweepStepsPerPass;
+
     std::unique_ptr <DatabaseCon> mRpcDB;
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
@@ -219,12 +262,16 @@ public:
         return list;
     }
 
+    // Size one io_service pool: an explicit configuration wins, else
+    // scale with node_size
     static
-    std::size_t numberOfThreads()
+    std::size_t poolThreads (int configured)
     {
     #if RIPPLE_SINGLE_IO_SERVICE_THREAD
         return 1;
     #else
+        if (configured > 0)
+            return configured;
         return (getConfig().NODE_SIZE >= 2) ? 2 : 1;
     #endif
     }
@@ -233,7 +280,9 @@ public:
 
     ApplicationImp (Logs& logs)
         : RootStoppable ("Application")
-        , BasicApp (numberOfThreads())
+        , BasicApp (poolThreads (getConfig ().IO_WORKERS),
+            poolThreads (getConfig ().CLIENT_IO_WORKERS),
+            poolThreads (getConfig ().BACKGROUND_IO_WORKERS))
         , m_logs (logs)
 
         , m_journal (m_logs.journal("Application"))
@@ -292,6 +341,9 @@ public:
             getConfig ().getSize (siLedgerFetch), *m_jobQueue,
             m_collectorManager->collector (), m_logs.journal("LedgerMaster")))
 
+        , m_historyShards (make_HistoryShards (*m_jobQueue,
+            m_logs.journal("HistoryShards")))
+
         // VFALCO NOTE must come before NetworkOPs to prevent a crash due
         //             to dependencies in the destructor.
         //
@@ -307,12 +359,12 @@ public:
         , m_deprecatedUNL (make_UniqueNodeList (*m_jobQueue))
 
         , serverHandler_ (make_ServerHandler (*m_networkOPs,
-            get_io_service(), *m_jobQueue, *m_networkOPs,
+            get_client_io_service(), *m_jobQueue, *m_networkOPs,
                 *m_resourceManager))
 
         , m_sntpClient (SNTPClient::New (*this))
 
-        , m_validators (Validators::make_Manager(*this, get_io_service(),
+        , m_validators (Validators::make_Manager(*this, get_background_io_service(),
             getConfig ().getModuleDatabasePath (), m_logs.journal("UVL")))
 
         , m_amendmentTable (make_AmendmentTable (weeks(2), MAJORITY_FRACTION,
@@ -322,16 +374,23 @@ public:
 
         , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime ()))
 
+        , m_signatureVerifier (make_SignatureVerifier (0,
+            m_logs.journal("SignatureVerifier")))
+
         , mValidations (make_Validations ())
 
         , m_loadManager (make_LoadManager (*this, m_logs.journal("LoadManager")))
 
         , m_sweepTimer (this)
+        , m_sweepCursor (0)
+        , m_sweepStepsPerPass (0)
 
-        , m_signals(get_io_service(), SIGINT)
+        , m_signals(get_background_io_service(), SIGINT)
 
-        , m_resolver (ResolverAsio::New (get_io_service(), m_logs.journal("Resolver")))
+        , m_resolver (ResolverAsio::New (get_background_io_service(), m_logs.journal("Resolver")))
 
+        // Latency is sampled on the network pool: that is the one
+        // whose queueing delays consensus
         , m_io_latency_sampler (m_collectorManager->collector()->make_event ("ios_latency"),
             m_logs.journal("Application"), std::chrono::milliseconds (100), get_io_service())
     {
@@ -357,11 +416,17 @@ public:
 
         add (*m_validators);
         add (m_ledgerMaster->getPropertySource ());
+        add (*m_historyShards);
         add (*serverHandler_);
     }
 
     //--------------------------------------------------------------------------
 
+    CacheBudget& getCacheBudget ()
+    {
+        return *m_cacheBudget;
+    }
+
     CollectorManager& getCollectorManager ()
     {
         return *m_collectorManager;
@@ -377,6 +442,11 @@ public:
         return *m_jobQueue;
     }
 
+    TimerWheel& getTimerWheel ()
+    {
+        return m_timerWheel;
+    }
+
     RPC::Manager& getRPCManager ()
     {
         return *m_rpcManager;
@@ -394,7 +464,10 @@ public:
 
     boost::asio::io_service& getIOService ()
     {
-        return get_io_service();
+        // The remaining callers are outbound fetches and pushes (UNL
+        // refresh, SMS, RPC subscription callbacks), so they belong
+        // on the background pool
+        return get_background_io_service();
     }
 
     std::chrono::milliseconds getIOLatency ()
@@ -409,6 +482,11 @@ public:
         return *m_ledgerMaster;
     }
 
+    HistoryShards& getHistoryShards ()
+    {
+        return *m_historyShards;
+    }
+
     InboundLedgers& getInboundLedgers ()
     {
         return *m_inboundLedgers;
@@ -419,6 +497,16 @@ public:
         return m_txMaster;
     }
 
+    TransactionMetaIndex& getTxMetaIndex ()
+    {
+        return m_txMetaIndex;
+    }
+
+    LedgerHashIndex& getLedgerHashIndex ()
+    {
+        return m_ledgerHashIndex;
+    }
+
     NodeCache& getTempNodeCache ()
     {
         return m_tempNodeCache;
@@ -434,9 +522,24 @@ public:
         return *m_nodeStore;
     }
 
-    Application::LockType& getMasterLock ()
+    NodeStore::Manager& getNodeStoreManager ()
+    {
+        return *m_nodeStoreManager;
+    }
+
+    MasterLockDomain& consensusLock ()
+    {
+        return m_consensusLock;
+    }
+
+    MasterLockDomain& openLedgerLock ()
+    {
+        return m_openLedgerLock;
+    }
+
+    MasterLockDomain& netStateLock ()
     {
-        return m_masterMutex;
+        return m_netStateLock;
     }
 
     LoadManager& getLoadManager ()
@@ -484,6 +587,11 @@ public:
         return *mHashRouter;
     }
 
+    SignatureVerifier& getSignatureVerifier ()
+    {
+        return *m_signatureVerifier;
+    }
+
     Validations& getValidations ()
     {
         return *mValidations;
@@ -550,13 +658,18 @@ public:
         assert (mWalletDB.get () == nullptr);
 
         DatabaseCon::Setup setup = setup_DatabaseCon (getConfig());
-        mRpcDB = std::make_unique <DatabaseCon> (setup, "rpc.db", RpcDBInit,
+
+        // Only the WAL-mode databases with concurrent readers get a pool
+        DatabaseCon::Setup noReaders = setup;
+        noReaders.readers = 0;
+
+        mRpcDB = std::make_unique <DatabaseCon> (noReaders, "rpc.db", RpcDBInit,
                 RpcDBCount);
         mTxnDB = std::make_unique <DatabaseCon> (setup, "transaction.db",
                 TxnDBInit, TxnDBCount);
         mLedgerDB = std::make_unique <DatabaseCon> (setup, "ledger.db",
                 LedgerDBInit, LedgerDBCount);
-        mWalletDB = std::make_unique <DatabaseCon> (setup, "wallet.db",
+        mWalletDB = std::make_unique <DatabaseCon> (noReaders, "wallet.db",
                 WalletDBInit, WalletDBCount);
 
         if (setup.onlineDelete && mTxnDB && mLedgerDB)
@@ -628,6 +741,17 @@ public:
                 m_logs.severity (beast::Journal::kDebug);
         }
 
+        if (!getConfig ().SIGNATURE_ENGINE.empty ())
+        {
+            if (selectSignatureEngine (getConfig ().SIGNATURE_ENGINE))
+                m_journal.info << "Signature engine: " <<
+                    signatureEngine ().name ();
+            else
+                m_journal.warning << "Unknown signature engine '" <<
+                    getConfig ().SIGNATURE_ENGINE << "', using '" <<
+                    signatureEngine ().name () << "'";
+        }
+
         if (!getConfig ().RUN_STANDALONE)
             m_sntpClient->init (getConfig ().SNTP_SERVERS);
 
@@ -637,6 +761,12 @@ public:
             exitWithCode(3);
         }
 
+        if (!getConfig ().RUN_STANDALONE)
+        {
+            m_txMetaIndex.open (getConfig ().DATA_DIR);
+            m_ledgerHashIndex.open (getConfig ().DATA_DIR);
+        }
+
         getApp().getLedgerDB ().getDB ()->executeSQL (boost::str (boost::format ("PRAGMA cache_size=-%d;") %
                 (getConfig ().getSize (siLgrDBCache) * 1024)));
         getApp().getTxnDB ().getDB ()->executeSQL (boost::str (boost::format ("PRAGMA cache_size=-%d;") %
@@ -702,12 +832,44 @@ public:
 
         mValidations->tune (getConfig ().getSize (siValidationsSize), getConfig ().getSize (siValidationsAge));
         m_nodeStore->tune (getConfig ().getSize (siNodeCacheSize), getConfig ().getSize (siNodeCacheAge));
+
+        // History held in completed shards answers node store misses
+        if (! getConfig ().shardDatabase ["path"].isEmpty ())
+        {
+            m_nodeStore->setMissHandler (
+                [this](uint256 const& hash) -> NodeObject::pointer
+                {
+                    return m_historyShards->fetch (hash);
+                });
+        }
+
+        // Rewarm the node object cache from the previous clean shutdown.
+        // Tree nodes are node objects, so the tree node cache's key list
+        // primes through the same fetch path: the reads land in the node
+        // object cache and the first SHAMap walk rebuilds from memory.
+        if (! getConfig ().nodeDatabase ["path"].isEmpty ())
+        {
+            std::string const dir =
+                getConfig ().nodeDatabase ["path"].toStdString ();
+
+            m_nodeStore->primeCacheKeys (dir + "/cache.keys");
+            m_nodeStore->primeCacheKeys (dir + "/treenode.keys");
+        }
+
         m_ledgerMaster->tune (getConfig ().getSize (siLedgerSize), getConfig ().getSize (siLedgerAge));
         m_sleCache.setTargetSize (getConfig ().getSize (siSLECacheSize));
         m_sleCache.setTargetAge (getConfig ().getSize (siSLECacheAge));
         m_treeNodeCache.setTargetSize (getConfig ().getSize (siTreeCacheSize));
         m_treeNodeCache.setTargetAge (getConfig ().getSize (siTreeCacheAge));
 
+        // Tree nodes reachable from the open and recent validated
+        // ledgers are pinned while those ledgers are in memory; only
+        // unreferenced nodes age out
+        m_treeNodeCache.setRetainReferenced (true);
+
+        // With the caches tuned, register them with the budget manager
+        buildCacheBudget ();
+
         //----------------------------------------------------------------------
         //
         // Server
@@ -736,7 +898,8 @@ public:
         {
             if (! port.websockets())
                 continue;
-            auto door = make_WSDoor(port, *m_resourceManager, getOPs());
+            auto door = make_WSDoor(port, *m_resourceManager, getOPs(),
+                get_client_io_service());
             if (door == nullptr)
             {
                 m_journal.fatal << "Could not create Websocket for [" <<
@@ -818,6 +981,17 @@ public:
 
         mValidations->flush ();
 
+        // So the next start can come back with a warm cache
+        if (! getConfig ().nodeDatabase ["path"].isEmpty ())
+        {
+            std::string const dir =
+                getConfig ().nodeDatabase ["path"].toStdString ();
+
+            m_nodeStore->saveCacheKeys (dir + "/cache.keys");
+            saveWarmKeys (dir + "/treenode.keys",
+                m_treeNodeCache.getKeys ());
+        }
+
         RippleAddress::clearCache ();
         stopped ();
     }
@@ -885,14 +1059,18 @@ public:
         {
             // VFALCO TODO Move all this into doSweep
 
-            boost::filesystem::space_info space = boost::filesystem::space (getConfig ().DATA_DIR);
-
-            // VFALCO TODO Give this magic constant a name and move it into a well documented header
-            //
-            if (space.available < (512 * 1024 * 1024))
+            // Once per sweep pass, not on every incremental step
+            if (m_sweepCursor == 0)
             {
-                m_journal.fatal << "Remaining free disk space is less than 512MB";
-                getApp().signalStop ();
+                boost::filesystem::space_info space = boost::filesystem::space (getConfig ().DATA_DIR);
+
+                // VFALCO TODO Give this magic constant a name and move it into a well documented header
+                //
+                if (space.available < (512 * 1024 * 1024))
+                {
+                    m_journal.fatal << "Remaining free disk space is less than 512MB";
+                    getApp().signalStop ();
+                }
             }
 
             m_jobQueue->addJob(jtSWEEP, "sweep",
@@ -901,47 +1079,143 @@ public:
         }
     }
 
-    void doSweep (Job& j)
+    // Rough per-entry footprints for the budget estimate. These are
+    // steady-state averages, not guarantees; the budget manager only
+    // needs relative magnitudes to steer sensibly.
+    enum
+    {
+        treeNodeBytes       = 1024,         // node plus serialized form
+        nodeObjectBytes     = 1024,         // blob plus container overhead
+        cachedLedgerBytes   = 512 * 1024,   // skeleton; tree nodes above
+        transactionBytes    = 2048,         // raw form plus parsed STTx
+        fullBelowBytes      = 96            // key plus table bookkeeping
+    };
+
+    void buildCacheBudget ()
+    {
+        m_cacheBudget = std::make_unique <CacheBudget> (
+            std::uint64_t (getConfig ().MEMORY_BUDGET_MB) * 1024 * 1024);
+
+        m_cacheBudget->addCache ("TreeNodeCache", treeNodeBytes,
+            getConfig ().getSize (siTreeCacheSize),
+            [this]() -> int { return m_treeNodeCache.getCacheSize (); },
+            [this]() -> float { return m_treeNodeCache.getHitRate (); },
+            [this](int size) { m_treeNodeCache.setTargetSize (size); });
+
+        int const nodeCacheAge = getConfig ().getSize (siNodeCacheAge);
+        m_cacheBudget->addCache ("NodeStore", nodeObjectBytes,
+            getConfig ().getSize (siNodeCacheSize),
+            [this]() -> int { return m_nodeStore->getCacheSize (); },
+            [this]() -> float { return m_nodeStore->getCacheHitRate (); },
+            [this, nodeCacheAge](int size)
+                { m_nodeStore->tune (size, nodeCacheAge); });
+
+        int const ledgerAge = getConfig ().getSize (siLedgerAge);
+        m_cacheBudget->addCache ("LedgerHistory", cachedLedgerBytes,
+            getConfig ().getSize (siLedgerSize),
+            [this]() -> int { return m_ledgerMaster->getCacheSize (); },
+            [this]() -> float { return m_ledgerMaster->getCacheHitRate (); },
+            [this, ledgerAge](int size)
+                { m_ledgerMaster->tune (size, ledgerAge); });
+
+        m_cacheBudget->addCache ("TransactionMaster", transactionBytes,
+            m_txMaster.getCache ().getTargetSize (),
+            [this]() -> int
+                { return m_txMaster.getCache ().getCacheSize (); },
+            [this]() -> float
+                { return m_txMaster.getCache ().getHitRate (); },
+            [this](int size)
+                { m_txMaster.getCache ().setTargetSize (size); });
+
+        m_cacheBudget->addCache ("FullBelowCache", fullBelowBytes,
+            static_cast <int> (fullBelowTargetSize),
+            [this]() -> int
+                { return static_cast <int> (m_fullBelowCache->size ()); },
+            [this]() -> float { return m_fullBelowCache->getHitRate (); },
+            [this](int size)
+                { m_fullBelowCache->setTargetSize (size); });
+    }
+
+    void buildSweepTargets ()
     {
         // VFALCO NOTE Does the order of calls matter?
         // VFALCO TODO fix the dependency inversion using an observer,
         //         have listeners register for "onSweep ()" notification.
         //
+        // The big TaggedCaches advance a couple of partitions per step
+        // from their internal cursors; everything else completes in a
+        // single step.
+        int const slicedSteps = TreeNodeCache::partitionCount /
+            sweepSlicePartitions;
+
+        m_sweepTargets.emplace_back ("FullBelowCache::sweep",
+            [this]() -> bool { m_fullBelowCache->sweep (); return true; });
+
+        m_sweepTargets.emplace_back ("TransactionMaster::sweep",
+            [this]() -> bool { m_txMaster.sweep (); return true; });
+
+        m_sweepTargets.emplace_back ("NodeStore::sweepSlice",
+            [this]() -> bool { return m_nodeStore->sweepSlice (
+                sweepSlicePartitions); });
+
+        m_sweepTargets.emplace_back ("LedgerMaster::sweep",
+            [this]() -> bool { m_ledgerMaster->sweep (); return true; });
+
+        m_sweepTargets.emplace_back ("TempNodeCache::sweepSlice",
+            [this]() -> bool { return m_tempNodeCache.sweepSlice (
+                sweepSlicePartitions); });
 
-        m_fullBelowCache->sweep ();
+        m_sweepTargets.emplace_back ("Validations::sweep",
+            [this]() -> bool { mValidations->sweep (); return true; });
 
-        logTimedCall (m_journal.warning, "TransactionMaster::sweep", __FILE__, __LINE__, std::bind (
-            &TransactionMaster::sweep, &m_txMaster));
+        m_sweepTargets.emplace_back ("InboundLedgers::sweep",
+            [this]() -> bool { getInboundLedgers ().sweep (); return true; });
 
-        logTimedCall (m_journal.warning, "NodeStore::sweep", __FILE__, __LINE__, std::bind (
-            &NodeStore::Database::sweep, m_nodeStore.get()));
+        m_sweepTargets.emplace_back ("SLECache::sweepSlice",
+            [this]() -> bool { return m_sleCache.sweepSlice (
+                sweepSlicePartitions); });
 
-        logTimedCall (m_journal.warning, "LedgerMaster::sweep", __FILE__, __LINE__, std::bind (
-            &LedgerMaster::sweep, m_ledgerMaster.get()));
+        m_sweepTargets.emplace_back ("AcceptedLedger::sweep",
+            []() -> bool { AcceptedLedger::sweep (); return true; });
 
-        logTimedCall (m_journal.warning, "TempNodeCache::sweep", __FILE__, __LINE__, std::bind (
-            &NodeCache::sweep, &m_tempNodeCache));
+        m_sweepTargets.emplace_back ("TreeNodeCache::sweepSlice",
+            [this]() -> bool { return m_treeNodeCache.sweepSlice (
+                sweepSlicePartitions); });
 
-        logTimedCall (m_journal.warning, "Validations::sweep", __FILE__, __LINE__, std::bind (
-            &Validations::sweep, mValidations.get ()));
+        m_sweepTargets.emplace_back ("NetworkOPs::sweepFetchPack",
+            [this]() -> bool { m_networkOPs->sweepFetchPack (); return true; });
 
-        logTimedCall (m_journal.warning, "InboundLedgers::sweep", __FILE__, __LINE__, std::bind (
-            &InboundLedgers::sweep, &getInboundLedgers ()));
+        // 4 sliced caches, the rest single-step
+        m_sweepStepsPerPass = static_cast <int> (m_sweepTargets.size ()) -
+            4 + (4 * slicedSteps);
+    }
+
+    void doSweep (Job& j)
+    {
+        // Sweeping is incremental: each job advances one target by one
+        // bounded step and reschedules, so no single pause walks every
+        // cache and the work is staggered across the sweep interval.
+        if (m_sweepTargets.empty ())
+            buildSweepTargets ();
 
-        logTimedCall (m_journal.warning, "SLECache::sweep", __FILE__, __LINE__, std::bind (
-            &SLECache::sweep, &m_sleCache));
+        // At the top of each pass, let the budget manager adjust
+        // cache targets so this pass's sweeps enforce them
+        if ((m_sweepCursor == 0) && m_cacheBudget)
+            m_cacheBudget->enforce ();
 
-        logTimedCall (m_journal.warning, "AcceptedLedger::sweep", __FILE__, __LINE__,
-            &AcceptedLedger::sweep);
+        SweepTarget const& target = m_sweepTargets [m_sweepCursor];
 
-        logTimedCall (m_journal.warning, "SHAMap::sweep", __FILE__, __LINE__,std::bind (
-            &TreeNodeCache::sweep, &m_treeNodeCache));
+        bool stepDone = true;
+        logTimedCall (m_journal.warning, target.first, __FILE__, __LINE__,
+            [&]() { stepDone = target.second (); });
 
-        logTimedCall (m_journal.warning, "NetworkOPs::sweepFetchPack", __FILE__, __LINE__, std::bind (
-            &NetworkOPs::sweepFetchPack, m_networkOPs.get ()));
+        if (stepDone && (++m_sweepCursor >= m_sweepTargets.size ()))
+            m_sweepCursor = 0;
 
         // VFALCO NOTE does the call to sweep() happen on another thread?
-        m_sweepTimer.setExpiration (getConfig ().getSize (siSweepInterval));
+        m_sweepTimer.setExpiration (std::max (0.1,
+            static_cast <double> (getConfig ().getSize (siSweepInterval)) /
+                std::max (1, m_sweepStepsPerPass)));
     }
 
 
@@ -1160,7 +1434,10 @@ bool ApplicationImp::loadOldLedger (
             return false;
         }
 
-        if (!loadLedger->walkLedger ())
+        // Hydrate just the top of the trees now so we can start serving
+        // quickly; deeper nodes fault in from the node store on first
+        // use and a background prefetch warms them underneath us.
+        if (!loadLedger->walkLedger (2))
         {
             m_journal.fatal << "Ledger is missing nodes.";
             assert(false);
@@ -1181,6 +1458,8 @@ bool ApplicationImp::loadOldLedger (
         m_ledgerMaster->forceValid(loadLedger);
         m_networkOPs->setLastCloseTime (loadLedger->getCloseTimeNC ());
 
+        loadLedger->prefetchStateNodes ();
+
         if (replay)
         {
             // inject transaction(s) from the replayLedger into our open ledger
@@ -1322,6 +1601,8 @@ static void addTxnSeqField ()
         }
         else rawMeta.resize (metaSize);
 
+        rawMeta = decompressTxnMeta (rawMeta);
+
         std::string tid;
         db->getStr ("TransID", tid);
         transID.SetHex (tid, true);
@@ -1403,6 +1684,18 @@ void ApplicationImp::updateTables ()
 
         getApp().getNodeStore().import (*source);
     }
+
+    if (! getConfig ().importSnapshotPath.empty ())
+    {
+        if (! importLedgerSnapshot (getConfig ().importSnapshotPath,
+                getApp().getNodeStore (),
+                    deprecatedLogs().journal("LedgerSnapshot")))
+        {
+            WriteLog (lsFATAL, Application) <<
+                "Ledger snapshot import failed";
+            exitWithCode(1);
+        }
+    }
 }
 
 void ApplicationImp::onAnnounceAddress ()
@@ -21,6 +21,7 @@
 #define RIPPLE_APP_APPLICATION_H_INCLUDED
 
 #include <ripple/app/main/FullBelowCache.h>
+#include <ripple/app/main/MasterLock.h>
 #include <ripple/app/shamap/TreeNodeCache.h>
 #include <ripple/basics/TaggedCache.h>
 #include <beast/utility/PropertyStream.h>
@@ -32,12 +33,14 @@ namespace ripple {
 
 namespace Validators { class Manager; }
 namespace Resource { class Manager; }
-namespace NodeStore { class Database; }
+namespace NodeStore { class Database; class Manager; }
 namespace RPC { class Manager; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
 class AmendmentTable;
+class CacheBudget;
 class CollectorManager;
+class HistoryShards;
 class IHashRouter;
 class Logs;
 class LoadFeeTrack;
@@ -51,8 +54,12 @@ class NetworkOPs;
 class OrderBookDB;
 class Overlay;
 class PathRequests;
+class SignatureVerifier;
 class STLedgerEntry;
+class TimerWheel;
+class LedgerHashIndex;
 class TransactionMaster;
+class TransactionMetaIndex;
 class Validations;
 
 class DatabaseCon;
@@ -64,27 +71,12 @@ using SLECache      = TaggedCache <uint256, STLedgerEntry>;
 class Application : public beast::PropertyStream::Source
 {
 public:
-    /* VFALCO NOTE
-
-        The master lock protects:
-
-        - The open ledger
-        - Server global state
-            * What the last closed ledger is
-            * State of the consensus engine
-
-        other things
+    /* The master lock, decomposed by domain. See MasterLock.h for
+       what each domain covers and the acquisition rules.
     */
-    typedef std::recursive_mutex LockType;
-    typedef std::unique_lock <LockType> ScopedLockType;
-    typedef std::unique_ptr <ScopedLockType> ScopedLock;
-
-    virtual LockType& getMasterLock () = 0;
-
-    ScopedLock masterLock()
-    {
-        return std::make_unique<ScopedLockType> (getMasterLock());
-    }
+    virtual MasterLockDomain& consensusLock () = 0;
+    virtual MasterLockDomain& openLedgerLock () = 0;
+    virtual MasterLockDomain& netStateLock () = 0;
 
 public:
     Application ();
@@ -92,9 +84,11 @@ public:
     virtual ~Application () = default;
 
     virtual boost::asio::io_service& getIOService () = 0;
+    virtual CacheBudget&            getCacheBudget () = 0;
     virtual CollectorManager&       getCollectorManager () = 0;
     virtual FullBelowCache&         getFullBelowCache () = 0;
     virtual JobQueue&               getJobQueue () = 0;
+    virtual TimerWheel&             getTimerWheel () = 0;
     virtual RPC::Manager&           getRPCManager () = 0;
     virtual NodeCache&              getTempNodeCache () = 0;
     virtual TreeNodeCache&          getTreeNodeCache () = 0;
@@ -102,17 +96,22 @@ public:
     virtual Validators::Manager&    getValidators () = 0;
     virtual AmendmentTable&         getAmendmentTable() = 0;
     virtual IHashRouter&            getHashRouter () = 0;
+    virtual SignatureVerifier&      getSignatureVerifier () = 0;
     virtual LoadFeeTrack&           getFeeTrack () = 0;
     virtual LoadManager&            getLoadManager () = 0;
     virtual Overlay&                overlay () = 0;
     virtual UniqueNodeList&         getUNL () = 0;
     virtual Validations&            getValidations () = 0;
     virtual NodeStore::Database&    getNodeStore () = 0;
+    virtual NodeStore::Manager&     getNodeStoreManager () = 0;
     virtual InboundLedgers&         getInboundLedgers () = 0;
     virtual LedgerMaster&           getLedgerMaster () = 0;
+    virtual HistoryShards&          getHistoryShards () = 0;
     virtual NetworkOPs&             getOPs () = 0;
     virtual OrderBookDB&            getOrderBookDB () = 0;
     virtual TransactionMaster&      getMasterTransaction () = 0;
+    virtual TransactionMetaIndex&   getTxMetaIndex () = 0;
+    virtual LedgerHashIndex&        getLedgerHashIndex () = 0;
     virtual LocalCredentials&       getLocalCredentials () = 0;
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
@@ -17,11 +17,77 @@
 */
 //==============================================================================
 
+#include <ripple/app/main/BasicFullBelowCache.h>
+
+#include <beast/unit_test/suite.h>
+#include <beast/chrono/manual_clock.h>
+
 namespace ripple {
-namespace RadMap {
 
-// Unit test to go here if the class becomes
-// a non-trivial wrapper for KeyCache.
+class FullBelowCache_test : public beast::unit_test::suite
+{
+public:
+    void run ()
+    {
+        beast::manual_clock <std::chrono::steady_clock> clock;
+        clock.set (0);
+
+        typedef std::string Key;
+        typedef BasicFullBelowCache <Key> Cache;
+
+        // Insert an item, retrieve it, and age it so it gets purged.
+        {
+            Cache c ("test", clock,
+                beast::insight::NullCollector::New (), 1, 2);
+
+            expect (c.size () == 0);
+            c.insert ("one");
+            expect (c.size () == 1);
+            expect (c.touch_if_exists ("one"));
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 1);
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 0);
+            expect (! c.touch_if_exists ("one"));
+        }
+
+        // Invalidating bumps the generation and hides old entries
+        // without touching the table.
+        {
+            Cache c ("test", clock,
+                beast::insight::NullCollector::New (), 2, 2);
+
+            std::uint32_t const gen = c.getGeneration ();
+            c.insert ("one");
+            expect (c.touch_if_exists ("one"));
+            c.clear ();
+            expect (c.getGeneration () == gen + 1);
+            expect (! c.touch_if_exists ("one"));
+
+            // Re-inserting under the new generation makes it current
+            c.insert ("one");
+            expect (c.touch_if_exists ("one"));
+        }
+
+        // Stale-generation entries are reclaimed by sweep.
+        {
+            Cache c ("test", clock,
+                beast::insight::NullCollector::New (), 2, 2);
+
+            c.insert ("one");
+            c.insert ("two");
+            expect (c.size () == 2);
+            c.clear ();
+            c.insert ("three");
+            c.sweep ();
+            expect (c.size () == 1);
+            expect (c.touch_if_exists ("three"));
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FullBelowCache,common,ripple);
 
-}
 }
@@ -20,25 +20,77 @@
 #ifndef RIPPLE_RADMAP_BASICFULLBELOWCACHE_H_INCLUDED
 #define RIPPLE_RADMAP_BASICFULLBELOWCACHE_H_INCLUDED
 
-#include <ripple/basics/KeyCache.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/app/main/Tuning.h>
-#include <beast/insight/Collector.h>
+#include <beast/chrono/abstract_clock.h>
+#include <beast/Insight.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
 
 namespace ripple {
 
 /** Remembers which tree keys have all descendants resident.
     This optimizes the process of acquiring a complete tree.
+
+    Each entry is stamped with the generation that was current when it
+    was inserted. Invalidating the cache (for example, when the node
+    store rotates databases out from under us) just increments the
+    generation counter: stale entries stop matching immediately and are
+    reclaimed lazily by lookups and by @ref sweep. This keeps
+    invalidation O(1) and avoids stalling concurrent sync threads while
+    a large table is torn down.
 */
 template <class Key>
 class BasicFullBelowCache
 {
+public:
+    typedef Key key_type;
+    typedef beast::abstract_clock <std::chrono::steady_clock> clock_type;
+
 private:
-    typedef KeyCache <Key> CacheType;
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            , hits (0)
+            , misses (0)
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+
+        std::size_t hits;
+        std::size_t misses;
+    };
+
+    struct Entry
+    {
+        Entry (clock_type::time_point const& last_access_,
+            std::uint32_t generation_)
+            : last_access (last_access_)
+            , generation (generation_)
+        {
+        }
+
+        clock_type::time_point last_access;
+        std::uint32_t generation;
+    };
+
+    typedef hardened_hash_map <key_type, Entry> map_type;
+    typedef typename map_type::iterator iterator;
+    typedef std::lock_guard <std::mutex> lock_guard;
 
 public:
-    typedef Key key_type;
-    typedef typename CacheType::size_type size_type;
-    typedef typename CacheType::clock_type clock_type;
+    typedef typename map_type::size_type size_type;
 
     /** Construct the cache.
 
@@ -52,8 +104,12 @@ public:
             beast::insight::NullCollector::New (),
         std::size_t target_size = defaultCacheTargetSize,
         std::size_t expiration_seconds = defaultCacheExpirationSeconds)
-        : m_cache (name, clock, collector, target_size,
-            expiration_seconds)
+        : m_stats (name,
+            std::bind (&BasicFullBelowCache::collect_metrics, this),
+                collector)
+        , m_clock (clock)
+        , m_target_size (target_size)
+        , m_target_age (std::chrono::seconds (expiration_seconds))
         , m_gen (1)
     {
     }
@@ -61,7 +117,7 @@ public:
     /** Return the clock associated with the cache. */
     clock_type& clock()
     {
-        return m_cache.clock ();
+        return m_clock;
     }
 
     /** Return the number of elements in the cache.
@@ -70,19 +126,88 @@ public:
     */
     size_type size () const
     {
-        return m_cache.size ();
+        lock_guard lock (m_mutex);
+        return m_map.size ();
+    }
+
+    /** Change the target size.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    void setTargetSize (size_type s)
+    {
+        lock_guard lock (m_mutex);
+        m_target_size = s;
     }
 
-    /** Remove expired cache items.
+    /** Return the percentage of lookups that hit.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    float getHitRate () const
+    {
+        lock_guard lock (m_mutex);
+        auto const total = static_cast <float> (
+            m_stats.hits + m_stats.misses);
+        return m_stats.hits * (100.0f / std::max (1.0f, total));
+    }
+
+    /** Remove expired and stale-generation cache items.
         Thread safety:
             Safe to call from any thread.
     */
     void sweep ()
     {
-        m_cache.sweep ();
+        clock_type::time_point const now (m_clock.now ());
+        clock_type::time_point when_expire;
+        std::uint32_t const generation (
+            m_gen.load (std::memory_order_relaxed));
+
+        lock_guard lock (m_mutex);
+
+        if (m_target_size == 0 ||
+            (m_map.size () <= m_target_size))
+        {
+            when_expire = now - m_target_age;
+        }
+        else
+        {
+            when_expire = now - clock_type::duration (
+                m_target_age.count() * m_target_size / m_map.size ());
+
+            clock_type::duration const minimumAge (
+                std::chrono::seconds (1));
+            if (when_expire > (now - minimumAge))
+                when_expire = now - minimumAge;
+        }
+
+        iterator it = m_map.begin ();
+
+        while (it != m_map.end ())
+        {
+            if (it->second.generation != generation)
+            {
+                it = m_map.erase (it);
+            }
+            else if (it->second.last_access > now)
+            {
+                it->second.last_access = now;
+                ++it;
+            }
+            else if (it->second.last_access <= when_expire)
+            {
+                it = m_map.erase (it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
     }
 
-    /** Refresh the last access time of an item, if it exists.
+    /** Refresh the last access time of an item, if it is current.
+        An entry inserted before the last call to @ref clear is
+        treated as absent.
         Thread safety:
             Safe to call from any thread.
         @param key The key to refresh.
@@ -90,35 +215,89 @@ public:
     */
     bool touch_if_exists (key_type const& key)
     {
-        return m_cache.touch_if_exists (key);
+        std::uint32_t const generation (
+            m_gen.load (std::memory_order_relaxed));
+        lock_guard lock (m_mutex);
+        iterator const iter (m_map.find (key));
+        if (iter == m_map.end ())
+        {
+            ++m_stats.misses;
+            return false;
+        }
+        if (iter->second.generation != generation)
+        {
+            m_map.erase (iter);
+            ++m_stats.misses;
+            return false;
+        }
+        iter->second.last_access = m_clock.now ();
+        ++m_stats.hits;
+        return true;
     }
 
     /** Insert a key into the cache.
-        If the key already exists, the last access time will still
-        be refreshed.
+        If the key already exists, the last access time and the
+        generation stamp are refreshed.
         Thread safety:
             Safe to call from any thread.
         @param key The key to insert.
     */
     void insert (key_type const& key)
     {
-        m_cache.insert (key);
+        std::uint32_t const generation (
+            m_gen.load (std::memory_order_relaxed));
+        lock_guard lock (m_mutex);
+        clock_type::time_point const now (m_clock.now ());
+        std::pair <iterator, bool> result (m_map.emplace (
+            std::piecewise_construct, std::forward_as_tuple (key),
+                std::forward_as_tuple (now, generation)));
+        if (! result.second)
+        {
+            result.first->second.last_access = now;
+            result.first->second.generation = generation;
+        }
     }
 
     /** generation determines whether cached entry is valid */
     std::uint32_t getGeneration (void) const
     {
-        return m_gen;
+        return m_gen.load (std::memory_order_relaxed);
     }
 
+    /** Invalidate all current entries.
+        This takes no locks and does not touch the table; entries
+        stamped with an older generation are reclaimed lazily.
+        Thread safety:
+            Safe to call from any thread.
+    */
     void clear ()
     {
-        m_cache.clear ();
         ++m_gen;
     }
 
 private:
-    KeyCache <Key> m_cache;
+    void collect_metrics ()
+    {
+        m_stats.size.set (size ());
+
+        {
+            beast::insight::Gauge::value_type hit_rate (0);
+            {
+                lock_guard lock (m_mutex);
+                auto const total (m_stats.hits + m_stats.misses);
+                if (total != 0)
+                    hit_rate = (m_stats.hits * 100) / total;
+            }
+            m_stats.hit_rate.set (hit_rate);
+        }
+    }
+
+    std::mutex mutable m_mutex;
+    map_type m_map;
+    Stats mutable m_stats;
+    clock_type& m_clock;
+    size_type m_target_size;
+    clock_type::duration m_target_age;
     std::atomic <std::uint32_t> m_gen;
 };
 
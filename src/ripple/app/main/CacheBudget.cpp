@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/CacheBudget.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace {
+
+// A cache below this share of the budget is not worth squeezing
+int const minimumSharePercent = 5;
+
+// Give memory back only once usage has fallen this far below budget,
+// so steering does not oscillate around the limit
+int const growThresholdPercent = 80;
+
+}
+
+CacheBudget::CacheBudget (std::uint64_t budgetBytes)
+    : m_budget (budgetBytes)
+{
+}
+
+void CacheBudget::addCache (std::string const& name,
+    std::size_t bytesPerEntry, int configuredTarget,
+    std::function <int ()> getSize,
+    std::function <float ()> getHitRate,
+    std::function <void (int)> setTarget)
+{
+    Entry entry;
+    entry.name = name;
+    entry.bytesPerEntry = bytesPerEntry;
+    entry.configuredTarget = configuredTarget;
+    entry.currentTarget = configuredTarget;
+    entry.getSize = getSize;
+    entry.getHitRate = getHitRate;
+    entry.setTarget = setTarget;
+
+    std::lock_guard <std::mutex> lock (m_lock);
+    m_entries.push_back (entry);
+}
+
+int CacheBudget::minimumTarget (Entry const& entry)
+{
+    return std::max (16, entry.configuredTarget / 10);
+}
+
+void CacheBudget::enforce ()
+{
+    std::lock_guard <std::mutex> lock (m_lock);
+
+    if (m_budget == 0 || m_entries.empty ())
+        return;
+
+    std::uint64_t total = 0;
+    std::vector <std::uint64_t> usage;
+    usage.reserve (m_entries.size ());
+
+    for (auto const& entry : m_entries)
+    {
+        std::uint64_t const bytes = static_cast <std::uint64_t> (
+            std::max (0, entry.getSize ())) * entry.bytesPerEntry;
+        usage.push_back (bytes);
+        total += bytes;
+    }
+
+    if (total > m_budget)
+    {
+        // Shrink the least valuable cache one step
+        int victim = -1;
+        float victimRate = 0;
+
+        for (std::size_t i = 0; i < m_entries.size (); ++i)
+        {
+            Entry const& entry = m_entries[i];
+
+            if (entry.currentTarget <= minimumTarget (entry))
+                continue;
+
+            if (usage[i] < ((m_budget * minimumSharePercent) / 100))
+                continue;
+
+            float const rate = entry.getHitRate ();
+
+            if (victim < 0 || rate < victimRate ||
+                (rate == victimRate &&
+                    usage[i] > usage[static_cast <std::size_t> (victim)]))
+            {
+                victim = static_cast <int> (i);
+                victimRate = rate;
+            }
+        }
+
+        if (victim >= 0)
+        {
+            Entry& entry = m_entries[static_cast <std::size_t> (victim)];
+            entry.currentTarget = std::max (
+                minimumTarget (entry), (entry.currentTarget * 9) / 10);
+            entry.setTarget (entry.currentTarget);
+        }
+    }
+    else if (total < ((m_budget * growThresholdPercent) / 100))
+    {
+        // Give memory back to the most valuable reduced cache
+        int best = -1;
+        float bestRate = 0;
+
+        for (std::size_t i = 0; i < m_entries.size (); ++i)
+        {
+            Entry const& entry = m_entries[i];
+
+            if (entry.currentTarget >= entry.configuredTarget)
+                continue;
+
+            float const rate = entry.getHitRate ();
+
+            if (best < 0 || rate > bestRate)
+            {
+                best = static_cast <int> (i);
+                bestRate = rate;
+            }
+        }
+
+        if (best >= 0)
+        {
+            Entry& entry = m_entries[static_cast <std::size_t> (best)];
+            entry.currentTarget = std::min (entry.configuredTarget,
+                std::max (entry.currentTarget + 1,
+                    (entry.currentTarget * 11) / 10));
+            entry.setTarget (entry.currentTarget);
+        }
+    }
+}
+
+Json::Value CacheBudget::getJson () const
+{
+    std::lock_guard <std::mutex> lock (m_lock);
+
+    Json::Value ret (Json::objectValue);
+
+    // Byte figures are reported in kilobytes so they stay inside the
+    // 32 bit integers the JSON layer carries
+    ret["budget_kb"] = static_cast <Json::UInt> (m_budget / 1024);
+    ret["steering"] = (m_budget != 0);
+
+    std::uint64_t total = 0;
+    Json::Value& caches = (ret["caches"] = Json::arrayValue);
+
+    for (auto const& entry : m_entries)
+    {
+        std::uint64_t const bytes = static_cast <std::uint64_t> (
+            std::max (0, entry.getSize ())) * entry.bytesPerEntry;
+        total += bytes;
+
+        Json::Value& cache = caches.append (Json::objectValue);
+        cache["name"] = entry.name;
+        cache["size"] = entry.getSize ();
+        cache["target_size"] = entry.currentTarget;
+        cache["configured_size"] = entry.configuredTarget;
+        cache["bytes_per_entry"] =
+            static_cast <Json::UInt> (entry.bytesPerEntry);
+        cache["estimated_kb"] = static_cast <Json::UInt> (bytes / 1024);
+        cache["hit_rate"] = entry.getHitRate ();
+    }
+
+    ret["estimated_total_kb"] = static_cast <Json::UInt> (total / 1024);
+
+    return ret;
+}
+
+} // ripple
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_CACHEBUDGET_H_INCLUDED
+#define RIPPLE_APP_CACHEBUDGET_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Steers the large caches toward a shared memory budget.
+
+    Each cache has its own target size knob, so a node's total
+    footprint is the sum of independent settings and keeping it inside
+    a container limit is guesswork. Registered caches report their
+    entry count and hit rate along with an estimated per-entry
+    footprint. When the estimated total exceeds the configured budget,
+    a steering step shrinks the target of the cache getting the least
+    value from its memory - the one with the lowest hit rate - and
+    when usage falls well below budget, reduced targets grow back
+    toward their configured sizes.
+
+    One gradual step runs per sweep pass, so a state-growth burst
+    trims caches over minutes instead of flushing them, and an idle
+    server drifts back to its configured targets. With no budget
+    configured the manager only reports.
+*/
+class CacheBudget
+{
+public:
+    /** One steered cache. */
+    struct Entry
+    {
+        std::string name;
+
+        // Estimated footprint of one cached entry, in bytes
+        std::size_t bytesPerEntry;
+
+        // The configured target size, the ceiling to grow back to
+        int configuredTarget;
+
+        // The target size currently in force
+        int currentTarget;
+
+        std::function <int ()> getSize;
+        std::function <float ()> getHitRate;
+        std::function <void (int)> setTarget;
+    };
+
+    /** Create the manager.
+        @param budgetBytes Total cache budget; zero disables steering.
+    */
+    explicit CacheBudget (std::uint64_t budgetBytes);
+
+    /** Register a cache for steering and reporting.
+        The callbacks must be safe to call from the sweep job.
+    */
+    void addCache (std::string const& name, std::size_t bytesPerEntry,
+        int configuredTarget,
+        std::function <int ()> getSize,
+        std::function <float ()> getHitRate,
+        std::function <void (int)> setTarget);
+
+    /** Run one steering step. Called once per sweep pass. */
+    void enforce ();
+
+    /** Report the budget, per-cache usage and steering state. */
+    Json::Value getJson () const;
+
+    std::uint64_t getBudget () const
+    {
+        return m_budget;
+    }
+
+private:
+    // Never steer a target below this; a starved cache thrashes
+    // without freeing meaningful memory
+    static int minimumTarget (Entry const& entry);
+
+    mutable std::mutex m_lock;
+    std::uint64_t const m_budget;
+    std::vector <Entry> m_entries;
+};
+
+} // ripple
+
+#endif
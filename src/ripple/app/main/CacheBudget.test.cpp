@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/main/CacheBudget.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class CacheBudget_test : public beast::unit_test::suite
+{
+public:
+    // A stand-in cache the manager can steer
+    struct FakeCache
+    {
+        int size;
+        int target;
+        float hitRate;
+
+        FakeCache (int size_, int target_, float hitRate_)
+            : size (size_)
+            , target (target_)
+            , hitRate (hitRate_)
+        {
+        }
+    };
+
+    static void addFake (CacheBudget& budget, std::string const& name,
+        std::size_t bytesPerEntry, FakeCache& cache)
+    {
+        budget.addCache (name, bytesPerEntry, cache.target,
+            [&cache]() -> int { return cache.size; },
+            [&cache]() -> float { return cache.hitRate; },
+            [&cache](int s) { cache.target = s; });
+    }
+
+    void testShrinksLowestHitRate ()
+    {
+        testcase ("shrinks lowest hit rate");
+
+        // 1000 entries of 1KB each per cache: 2MB total, 1MB budget
+        CacheBudget budget (1024 * 1024);
+
+        FakeCache valuable (1000, 1000, 90);
+        FakeCache wasteful (1000, 1000, 10);
+
+        addFake (budget, "valuable", 1024, valuable);
+        addFake (budget, "wasteful", 1024, wasteful);
+
+        budget.enforce ();
+
+        expect (valuable.target == 1000, "valuable cache was cut");
+        expect (wasteful.target == 900, "wasteful cache was not cut");
+
+        // Each step keeps shrinking the least valuable cache
+        budget.enforce ();
+        expect (wasteful.target == 810);
+    }
+
+    void testFloor ()
+    {
+        testcase ("never starves a cache");
+
+        CacheBudget budget (1024);
+
+        FakeCache only (1000, 1000, 0);
+        addFake (budget, "only", 1024, only);
+
+        for (int i = 0; i < 100; ++i)
+            budget.enforce ();
+
+        // Steering stops at a tenth of the configured target
+        expect (only.target == 100, "cache starved");
+    }
+
+    void testGrowsBack ()
+    {
+        testcase ("grows back under budget");
+
+        CacheBudget budget (1024 * 1024);
+
+        FakeCache cache (2000, 2000, 50);
+        addFake (budget, "cache", 1024, cache);
+
+        budget.enforce ();      // 2000KB against a 1024KB budget
+        expect (cache.target == 1800, "was not steered down");
+
+        cache.size = 100;       // usage collapses well under budget
+        budget.enforce ();
+        expect (cache.target == 1980, "did not grow back");
+
+        budget.enforce ();
+        expect (cache.target == 2000, "overshot the configured target");
+    }
+
+    void testDisabled ()
+    {
+        testcase ("no budget, no steering");
+
+        CacheBudget budget (0);
+
+        FakeCache cache (1000, 1000, 0);
+        addFake (budget, "cache", 1024, cache);
+
+        budget.enforce ();
+        expect (cache.target == 1000);
+
+        // Reporting still works
+        Json::Value const json = budget.getJson ();
+        expect (! json["steering"].asBool ());
+        expect (json["caches"].size () == 1);
+    }
+
+    void run ()
+    {
+        testShrinksLowestHitRate ();
+        testFloor ();
+        testGrowsBack ();
+        testDisabled ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(CacheBudget,ripple_app,ripple);
+
+} // ripple
@@ -211,6 +211,7 @@ int run (int argc, char** argv)
     ("net", "Get the initial ledger from the network.")
     ("fg", "Run in the foreground.")
     ("import", importText.c_str ())
+    ("import_snapshot", po::value<std::string> (), "Import a ledger state snapshot file (written by the ledger_snapshot command) into the node database.")
     ("version", "Display the build version.")
     ;
 
@@ -316,6 +317,12 @@ int run (int argc, char** argv)
         getConfig ().doImport = true;
     }
 
+    if (vm.count ("import_snapshot"))
+    {
+        getConfig ().importSnapshotPath
+                = vm["import_snapshot"].as<std::string> ();
+    }
+
     if (vm.count ("ledger"))
     {
         getConfig ().START_LEDGER = vm["ledger"].as<std::string> ();
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MAIN_MASTERLOCK_H_INCLUDED
+#define RIPPLE_APP_MAIN_MASTERLOCK_H_INCLUDED
+
+#include <ripple/core/LoadMonitor.h>
+#include <boost/thread/shared_mutex.hpp>
+#include <chrono>
+
+namespace ripple {
+
+/** One domain of the decomposed master lock.
+
+    The old master lock serialized transaction processing, consensus
+    callbacks and many RPC handlers on a single recursive mutex. It is
+    split into domains which can be held independently, each with
+    reader-writer semantics:
+
+        consensusLock   The consensus round in progress: the
+                        LedgerConsensus object, its transaction set
+                        plumbing, and the decision to start a new round.
+        openLedgerLock  Applying transactions to the open ledger and
+                        the submission caches and queues in front of it.
+        netStateLock    Operator-facing network state: peer and UNL
+                        administration, subscriptions, server control.
+
+    The rules:
+
+    * Domains are not recursive. A thread must never re-acquire a
+      domain it already holds, shared or exclusive.
+    * When more than one domain is needed, acquire in the order listed
+      above: consensus, then open ledger, then network state. The
+      canonical multi-domain path is ledger accept, which drains the
+      submission queue (open ledger) while ending the round (consensus).
+    * A shared hold cannot be upgraded in place; release it and take
+      the exclusive hold.
+
+    Every hold is timed and fed to a per-domain LoadMonitor so that
+    get_counts can report where the old master lock's time actually
+    goes and validate the decomposition.
+*/
+class MasterLockDomain
+{
+public:
+    MasterLockDomain ()
+    {
+        // Flag a domain whose holds routinely reach double-digit
+        // milliseconds; that is consensus-accept territory.
+        m_monitor.setTargetLatency (10, 100);
+    }
+
+    MasterLockDomain (MasterLockDomain const&) = delete;
+    MasterLockDomain& operator= (MasterLockDomain const&) = delete;
+
+    /** Hold-time statistics for load reporting. */
+    LoadMonitor::Stats stats ()
+    {
+        return m_monitor.getStats ();
+    }
+
+private:
+    friend class MasterLockGuard;
+    friend class MasterSharedGuard;
+
+    void report (std::chrono::steady_clock::time_point acquired)
+    {
+        m_monitor.addSamples (1,
+            std::chrono::duration_cast <std::chrono::milliseconds> (
+                std::chrono::steady_clock::now () - acquired));
+    }
+
+    boost::shared_mutex m_mutex;
+    LoadMonitor m_monitor;
+};
+
+/** Exclusive hold on one master lock domain. */
+class MasterLockGuard
+{
+public:
+    explicit MasterLockGuard (MasterLockDomain& domain)
+        : m_domain (domain)
+    {
+        m_domain.m_mutex.lock ();
+        m_acquired = std::chrono::steady_clock::now ();
+    }
+
+    ~MasterLockGuard ()
+    {
+        m_domain.m_mutex.unlock ();
+        m_domain.report (m_acquired);
+    }
+
+    MasterLockGuard (MasterLockGuard const&) = delete;
+    MasterLockGuard& operator= (MasterLockGuard const&) = delete;
+
+private:
+    MasterLockDomain& m_domain;
+    std::chrono::steady_clock::time_point m_acquired;
+};
+
+/** Shared (read) hold on one master lock domain. */
+class MasterSharedGuard
+{
+public:
+    explicit MasterSharedGuard (MasterLockDomain& domain)
+        : m_domain (domain)
+    {
+        m_domain.m_mutex.lock_shared ();
+        m_acquired = std::chrono::steady_clock::now ();
+    }
+
+    ~MasterSharedGuard ()
+    {
+        m_domain.m_mutex.unlock_shared ();
+        m_domain.report (m_acquired);
+    }
+
+    MasterSharedGuard (MasterSharedGuard const&) = delete;
+    MasterSharedGuard& operator= (MasterSharedGuard const&) = delete;
+
+private:
+    MasterLockDomain& m_domain;
+    std::chrono::steady_clock::time_point m_acquired;
+};
+
+} // ripple
+
+#endif
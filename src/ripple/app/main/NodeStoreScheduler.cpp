@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/main/NodeStoreScheduler.h>
+#include <ripple/core/SyncGovernor.h>
 
 namespace ripple {
 
@@ -72,6 +73,8 @@ void NodeStoreScheduler::onBatchWrite (NodeStore::BatchWriteReport const& report
 {
     m_jobQueue->addLoadEvents (jtNS_WRITE,
         report.writeCount, report.elapsed);
+
+    SyncGovernor::onBatchWrite (report.writeCount);
 }
 
 } // ripple
@@ -150,6 +150,15 @@ public:
 
     virtual void
     doValidation (Ledger::ref lastClosedLedger, STObject& baseValidation) = 0;
+
+    /** Precompute the amendment votes for a flag ledger.
+        Tallies the validations and serializes any voting transactions
+        so a later doVoting call for the same ledger finds its work
+        already done. May be called from any thread.
+    */
+    virtual void
+    preVote (Ledger::ref lastClosedLedger) = 0;
+
     virtual void
     doVoting (Ledger::ref lastClosedLedger, SHAMap::ref initialPosition) = 0;
 };
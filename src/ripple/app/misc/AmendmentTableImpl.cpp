@@ -44,6 +44,14 @@ protected:
     core::Clock::time_point m_lastReport;  // close time of most recent majority report
     beast::Journal m_journal;
 
+    // Votes precomputed by preVote, keyed by flag ledger hash
+    uint256 m_voteLedger;
+    bool m_voteReady;
+    std::vector <SHAMapItem::pointer> m_voteItems;
+
+    std::vector <SHAMapItem::pointer> makeVoteItems (
+        Ledger::ref lastClosedLedger);
+
     AmendmentState* getCreate (uint256 const& amendment, bool create);
     bool shouldEnable (std::uint32_t closeTime, const AmendmentState& fs);
     void setJson (Json::Value& v, const AmendmentState&);
@@ -57,6 +65,7 @@ public:
         , m_firstReport (0)
         , m_lastReport (0)
         , m_journal (journal)
+        , m_voteReady (false)
     {
     }
 
@@ -84,6 +93,7 @@ public:
     Json::Value getJson (uint256 const&) override;
 
     void doValidation (Ledger::ref lastClosedLedger, STObject& baseValidation) override;
+    void preVote (Ledger::ref lastClosedLedger) override;
     void doVoting (Ledger::ref lastClosedLedger, SHAMap::ref initialPosition) override;
 
     amendmentList_t getVetoed();
@@ -97,6 +107,12 @@ AmendmentTableImpl::addInitial ()
 {
     // For each amendment this version supports, construct the AmendmentState object by calling
     // addKnown. Set any vetoes or defaults. A pointer to the AmendmentState can be stashed
+
+    // SHA512-Half of "DirectoryCompaction": merge under-occupied
+    // directory pages on deletion. Changes ledger state transitions,
+    // so it stays off until the network votes it in.
+    addKnown ("5CF210E3057094F12C167202BD4738EDAA8DCAD6406E83BF8DC094F7E2FA5B90",
+        "DirectoryCompaction", false);
 }
 
 AmendmentState*
@@ -436,13 +452,10 @@ AmendmentTableImpl::doValidation (Ledger::ref lastClosedLedger,
     baseValidation.setFieldV256 (sfAmendments, vAmendments);
 }
 
-void
-AmendmentTableImpl::doVoting (Ledger::ref lastClosedLedger,
-    SHAMap::ref initialPosition)
+std::vector <SHAMapItem::pointer>
+AmendmentTableImpl::makeVoteItems (Ledger::ref lastClosedLedger)
 {
-
-    // LCL must be flag ledger
-    assert((lastClosedLedger->getLedgerSeq () % 256) == 0);
+    std::vector <SHAMapItem::pointer> items;
 
     AmendmentSet amendmentSet (lastClosedLedger->getParentCloseTimeNC ());
 
@@ -481,17 +494,66 @@ AmendmentTableImpl::doVoting (Ledger::ref lastClosedLedger,
         if (m_journal.warning) m_journal.warning <<
             "Vote ID: " << txID;
 
-        // Inject the transaction into our initial proposal
+        // Serialize for injection into our initial proposal
         Serializer s;
         trans.add (s, true);
 #if RIPPLE_PROPOSE_AMENDMENTS
-        SHAMapItem::pointer tItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
-        if (!initialPosition->addGiveItem (tItem, true, false))
+        items.push_back (std::make_shared<SHAMapItem> (txID, s.peekData ()));
+#endif
+    }
+
+    return items;
+}
+
+void
+AmendmentTableImpl::preVote (Ledger::ref lastClosedLedger)
+{
+    std::vector <SHAMapItem::pointer> items (
+        makeVoteItems (lastClosedLedger));
+
+    ScopedLockType sl (mLock);
+    m_voteLedger = lastClosedLedger->getHash ();
+    m_voteItems.swap (items);
+    m_voteReady = true;
+}
+
+void
+AmendmentTableImpl::doVoting (Ledger::ref lastClosedLedger,
+    SHAMap::ref initialPosition)
+{
+    // LCL must be flag ledger
+    assert((lastClosedLedger->getLedgerSeq () % 256) == 0);
+
+    std::vector <SHAMapItem::pointer> items;
+    bool precomputed = false;
+
+    {
+        ScopedLockType sl (mLock);
+        if (m_voteReady && (m_voteLedger == lastClosedLedger->getHash ()))
+        {
+            items = m_voteItems;
+            precomputed = true;
+        }
+    }
+
+    if (! precomputed)
+    {
+        // Pay for the tally on the close path; this only happens if
+        // the flag ledger changed out from under the precompute job.
+        if (m_journal.debug) m_journal.debug <<
+            "Amendment votes not precomputed for "
+            << lastClosedLedger->getHash ();
+        items = makeVoteItems (lastClosedLedger);
+    }
+
+    for (auto const& item : items)
+    {
+        // Inject the transaction into our initial proposal
+        if (!initialPosition->addGiveItem (item, true, false))
         {
             if (m_journal.warning) m_journal.warning <<
                 "Ledger already had amendment transaction";
         }
-#endif
     }
 }
 
@@ -17,6 +17,8 @@
 */
 //==============================================================================
 
+#include <algorithm>
+
 namespace ripple {
 
 bool CanonicalTXSet::Key::operator< (Key const& rhs) const
@@ -71,23 +73,92 @@ bool CanonicalTXSet::Key::operator>= (Key const& rhs)const
     return mTXid >= rhs.mTXid;
 }
 
+static bool keyLess (CanonicalTXSet::value_type const& lhs,
+                     CanonicalTXSet::value_type const& rhs)
+{
+    return lhs.first < rhs.first;
+}
+
 void CanonicalTXSet::push_back (STTx::ref txn)
 {
     uint256 effectiveAccount = mSetHash;
 
     effectiveAccount ^= to256 (txn->getSourceAccount ().getAccountID ());
 
-    mMap.insert (std::make_pair (
-                     Key (effectiveAccount, txn->getSequence (), txn->getTransactionID ()),
-                     txn));
+    Key key (effectiveAccount, txn->getSequence (),
+        txn->getTransactionID ());
+
+    if (mSorted)
+    {
+        // Late arrival: insert in place so canonical order holds
+        value_type entry (key, txn);
+        auto it = std::lower_bound (mTxns.begin (), mTxns.end (),
+            entry, keyLess);
+
+        if ((it != mTxns.end ()) && (it->first == key))
+            return;
+
+        mTxns.insert (it, std::move (entry));
+    }
+    else
+    {
+        mTxns.emplace_back (key, txn);
+    }
+}
+
+void CanonicalTXSet::sortIfNeeded () const
+{
+    if (mSorted)
+        return;
+
+    mSorted = true;
+
+    if (mTxns.size () > 1)
+    {
+        // One counting pass on the leading byte of the salted account
+        // splits the set into uniform buckets (the salt makes that
+        // byte effectively random), then each bucket is comparison
+        // sorted. Transactions from the same account share a salted
+        // account, hence a bucket, so sequence order still holds.
+        std::size_t counts[257] = { 0 };
+
+        for (auto const& entry : mTxns)
+            ++counts[*entry.first.getAccount ().begin () + 1];
+
+        for (int i = 1; i <= 256; ++i)
+            counts[i] += counts[i - 1];
+
+        std::vector <value_type> sorted (mTxns.size (),
+            value_type (Key (uint256 (), 0, uint256 ()), STTx::pointer ()));
+
+        for (auto& entry : mTxns)
+            sorted[counts[*entry.first.getAccount ().begin ()]++] =
+                std::move (entry);
+
+        mTxns.swap (sorted);
+
+        std::size_t start = 0;
+
+        for (int i = 1; i <= 256; ++i)
+        {
+            if (counts[i - 1] - start > 1)
+                std::sort (mTxns.begin () + start,
+                    mTxns.begin () + counts[i - 1], keyLess);
+            start = counts[i - 1];
+        }
+    }
+
+    // Drop duplicate insertions, matching the previous map semantics
+    mTxns.erase (std::unique (mTxns.begin (), mTxns.end (),
+        [] (value_type const& lhs, value_type const& rhs)
+        {
+            return lhs.first == rhs.first;
+        }), mTxns.end ());
 }
 
 CanonicalTXSet::iterator CanonicalTXSet::erase (iterator const& it)
 {
-    iterator tmp = it;
-    ++tmp;
-    mMap.erase (it);
-    return tmp;
+    return mTxns.erase (it);
 }
 
 } // ripple
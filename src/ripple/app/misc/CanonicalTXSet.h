@@ -21,6 +21,8 @@
 #define RIPPLE_CANONICALTXSET_H
 
 #include <ripple/protocol/RippleLedgerHash.h>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -64,14 +66,20 @@ public:
             return mTXid;
         }
 
+        uint256 const& getAccount () const
+        {
+            return mAccount;
+        }
+
     private:
         uint256 mAccount;
         uint256 mTXid;
         std::uint32_t mSeq;
     };
 
-    typedef std::map <Key, STTx::pointer>::iterator iterator;
-    typedef std::map <Key, STTx::pointer>::const_iterator const_iterator;
+    typedef std::pair <Key, STTx::pointer> value_type;
+    typedef std::vector <value_type>::iterator iterator;
+    typedef std::vector <value_type>::const_iterator const_iterator;
 
 public:
     explicit CanonicalTXSet (LedgerHash const& lastClosedLedgerHash)
@@ -86,41 +94,54 @@ public:
     {
         mSetHash = newLastClosedLedgerHash;
 
-        mMap.clear ();
+        mTxns.clear ();
+        mSorted = false;
     }
 
     iterator erase (iterator const& it);
 
     iterator begin ()
     {
-        return mMap.begin ();
+        sortIfNeeded ();
+        return mTxns.begin ();
     }
     iterator end ()
     {
-        return mMap.end ();
+        sortIfNeeded ();
+        return mTxns.end ();
     }
     const_iterator begin ()  const
     {
-        return mMap.begin ();
+        sortIfNeeded ();
+        return mTxns.begin ();
     }
     const_iterator end () const
     {
-        return mMap.end ();
+        sortIfNeeded ();
+        return mTxns.end ();
     }
     size_t size () const
     {
-        return mMap.size ();
+        return mTxns.size ();
     }
     bool empty () const
     {
-        return mMap.empty ();
+        return mTxns.empty ();
     }
 
 private:
+    // Establish canonical order. Called before iteration; until then
+    // push_back just appends, so building the set is cheap.
+    void sortIfNeeded () const;
+
     // Used to salt the accounts so people can't mine for low account numbers
     uint256 mSetHash;
 
-    std::map <Key, STTx::pointer> mMap;
+    // Kept flat; sorted lazily the first time it is iterated. Late
+    // arrivals after that are inserted in place so iterators stay in
+    // canonical order.
+    mutable std::vector <value_type> mTxns;
+    mutable bool mSorted = false;
 };
 
 } // ripple
@@ -58,6 +58,18 @@ public:
     doValidation (Ledger::ref lastClosedLedger,
         STObject& baseValidation) = 0;
 
+    /** Precompute the fee vote for a flag ledger.
+
+        Tallies the validations and serializes the voting transaction
+        ahead of time so a subsequent doVoting call for the same ledger
+        finds its work already done. May be called from any thread.
+
+        @param lastClosedLedger The flag ledger we will vote on top of.
+    */
+    virtual
+    void
+    preVote (Ledger::ref lastClosedLedger) = 0;
+
     /** Cast our local vote on the fee.
 
         @param lastClosedLedger
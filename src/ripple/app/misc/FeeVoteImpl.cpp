@@ -86,6 +86,15 @@ private:
     Setup target_;
     beast::Journal journal_;
 
+    // Vote precomputed by preVote, keyed by flag ledger hash
+    std::mutex mutex_;
+    uint256 voteLedger_;
+    bool voteReady_;
+    SHAMapItem::pointer voteItem_;
+
+    SHAMapItem::pointer
+    makeVoteItem (Ledger::ref lastClosedLedger);
+
 public:
     FeeVoteImpl (Setup const& setup, beast::Journal journal);
 
@@ -93,6 +102,9 @@ public:
     doValidation (Ledger::ref lastClosedLedger,
         STObject& baseValidation) override;
 
+    void
+    preVote (Ledger::ref lastClosedLedger) override;
+
     void
     doVoting (Ledger::ref lastClosedLedger,
         SHAMap::ref initialPosition) override;
@@ -103,6 +115,7 @@ public:
 FeeVoteImpl::FeeVoteImpl (Setup const& setup, beast::Journal journal)
     : target_ (setup)
     , journal_ (journal)
+    , voteReady_ (false)
 {
 }
 
@@ -136,13 +149,9 @@ FeeVoteImpl::doValidation (Ledger::ref lastClosedLedger,
     }
 }
 
-void
-FeeVoteImpl::doVoting (Ledger::ref lastClosedLedger,
-    SHAMap::ref initialPosition)
+SHAMapItem::pointer
+FeeVoteImpl::makeVoteItem (Ledger::ref lastClosedLedger)
 {
-    // LCL must be flag ledger
-    assert ((lastClosedLedger->getLedgerSeq () % 256) == 0);
-
     detail::VotableInteger<std::uint64_t> baseFeeVote (
         lastClosedLedger->getBaseFee (), target_.reference_fee);
 
@@ -196,40 +205,79 @@ FeeVoteImpl::doVoting (Ledger::ref lastClosedLedger,
     std::uint32_t const baseReserve = baseReserveVote.getVotes ();
     std::uint32_t const incReserve = incReserveVote.getVotes ();
 
-    // add transactions to our position
-    if ((baseFee != lastClosedLedger->getBaseFee ()) ||
-            (baseReserve != lastClosedLedger->getReserve (0)) ||
-            (incReserve != lastClosedLedger->getReserveInc ()))
-    {
-        if (journal_.warning) journal_.warning <<
-            "We are voting for a fee change: " << baseFee <<
-            "/" << baseReserve <<
-            "/" << incReserve;
+    // build the transaction for our position, if it changes anything
+    if ((baseFee == lastClosedLedger->getBaseFee ()) &&
+            (baseReserve == lastClosedLedger->getReserve (0)) &&
+            (incReserve == lastClosedLedger->getReserveInc ()))
+        return SHAMapItem::pointer ();
 
-        STTx trans (ttFEE);
-        trans.setFieldAccount (sfAccount, Account ());
-        trans.setFieldU64 (sfBaseFee, baseFee);
-        trans.setFieldU32 (sfReferenceFeeUnits, 10);
-        trans.setFieldU32 (sfReserveBase, baseReserve);
-        trans.setFieldU32 (sfReserveIncrement, incReserve);
+    if (journal_.warning) journal_.warning <<
+        "We are voting for a fee change: " << baseFee <<
+        "/" << baseReserve <<
+        "/" << incReserve;
 
-        uint256 txID = trans.getTransactionID ();
+    STTx trans (ttFEE);
+    trans.setFieldAccount (sfAccount, Account ());
+    trans.setFieldU64 (sfBaseFee, baseFee);
+    trans.setFieldU32 (sfReferenceFeeUnits, 10);
+    trans.setFieldU32 (sfReserveBase, baseReserve);
+    trans.setFieldU32 (sfReserveIncrement, incReserve);
 
-        if (journal_.warning)
-            journal_.warning << "Vote: " << txID;
+    uint256 txID = trans.getTransactionID ();
 
-        Serializer s;
-        trans.add (s, true);
+    if (journal_.warning)
+        journal_.warning << "Vote: " << txID;
 
-        SHAMapItem::pointer tItem = std::make_shared<SHAMapItem> (
-            txID, s.peekData ());
+    Serializer s;
+    trans.add (s, true);
+
+    return std::make_shared<SHAMapItem> (txID, s.peekData ());
+}
 
-        if (!initialPosition->addGiveItem (tItem, true, false))
+void
+FeeVoteImpl::preVote (Ledger::ref lastClosedLedger)
+{
+    SHAMapItem::pointer const item (makeVoteItem (lastClosedLedger));
+
+    std::lock_guard <std::mutex> lock (mutex_);
+    voteLedger_ = lastClosedLedger->getHash ();
+    voteItem_ = item;
+    voteReady_ = true;
+}
+
+void
+FeeVoteImpl::doVoting (Ledger::ref lastClosedLedger,
+    SHAMap::ref initialPosition)
+{
+    // LCL must be flag ledger
+    assert ((lastClosedLedger->getLedgerSeq () % 256) == 0);
+
+    SHAMapItem::pointer item;
+    bool precomputed = false;
+
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (voteReady_ && (voteLedger_ == lastClosedLedger->getHash ()))
         {
-            if (journal_.warning) journal_.warning <<
-                "Ledger already had fee change";
+            item = voteItem_;
+            precomputed = true;
         }
     }
+
+    if (! precomputed)
+    {
+        // The close path pays for the tally; this only happens if the
+        // flag ledger changed out from under the precompute job.
+        if (journal_.debug) journal_.debug <<
+            "Fee vote not precomputed for " << lastClosedLedger->getHash ();
+        item = makeVoteItem (lastClosedLedger);
+    }
+
+    if (item && !initialPosition->addGiveItem (item, true, false))
+    {
+        if (journal_.warning) journal_.warning <<
+            "Ledger already had fee change";
+    }
 }
 
 //------------------------------------------------------------------------------
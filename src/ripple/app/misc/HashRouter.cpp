@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/basics/UptimeTimer.h>
+#include <ripple/core/Config.h>
 #include <boost/foreach.hpp>
 
 namespace ripple {
@@ -87,6 +88,9 @@ private:
 public:
     explicit HashRouter (int holdTime)
         : mHoldTime (holdTime)
+        // A leaf never relays, so the per-hash peer lists that exist
+        // only to compute relay skip sets would be dead weight
+        , mTrackPeers (! getConfig ().PEER_LEAF)
     {
     }
 
@@ -101,30 +105,53 @@ public:
     bool swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag);
 
 private:
-    Entry getEntry (uint256 const& );
-
-    Entry& findCreateEntry (uint256 const& , bool& created);
-
     typedef RippleMutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
-    LockType mLock;
 
-    // Stores all suppressed hashes and their expiration time
-    hash_map <uint256, Entry> mSuppressionMap;
+    enum
+    {
+        // Suppressions are spread over this many independently locked
+        // shards so relay threads don't convoy on one mutex
+        shardCount = 16
+    };
+
+    /** One lock's worth of the suppression table. */
+    struct Shard
+    {
+        LockType lock;
+
+        // Stores suppressed hashes and their entries
+        hash_map <uint256, Entry> suppressionMap;
+
+        // Stores all expiration times and the hashes indexed for them
+        std::map< int, std::list<uint256> > suppressionTimes;
+    };
+
+    Shard& shard (uint256 const& index)
+    {
+        // The index is itself a uniformly distributed hash, so any
+        // byte of it selects a shard fairly
+        return mShards [*index.begin () % shardCount];
+    }
+
+    Entry getEntry (uint256 const& );
+
+    Entry& findCreateEntry (Shard& s, uint256 const& , bool& created);
 
-    // Stores all expiration times and the hashes indexed for them
-    std::map< int, std::list<uint256> > mSuppressionTimes;
+    Shard mShards [shardCount];
 
     int mHoldTime;
+    bool mTrackPeers;
 };
 
 //------------------------------------------------------------------------------
 
-HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& created)
+HashRouter::Entry& HashRouter::findCreateEntry (
+    Shard& shard, uint256 const& index, bool& created)
 {
-    hash_map<uint256, Entry>::iterator fit = mSuppressionMap.find (index);
+    hash_map<uint256, Entry>::iterator fit = shard.suppressionMap.find (index);
 
-    if (fit != mSuppressionMap.end ())
+    if (fit != shard.suppressionMap.end ())
     {
         created = false;
         return fit->second;
@@ -136,70 +163,83 @@ HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& crea
     int expireTime = now - mHoldTime;
 
     // See if any supressions need to be expired
-    std::map< int, std::list<uint256> >::iterator it = mSuppressionTimes.begin ();
+    std::map< int, std::list<uint256> >::iterator it = shard.suppressionTimes.begin ();
 
-    if ((it != mSuppressionTimes.end ()) && (it->first <= expireTime))
+    if ((it != shard.suppressionTimes.end ()) && (it->first <= expireTime))
     {
         BOOST_FOREACH (uint256 const& lit, it->second)
-        mSuppressionMap.erase (lit);
-        mSuppressionTimes.erase (it);
+        shard.suppressionMap.erase (lit);
+        shard.suppressionTimes.erase (it);
     }
 
-    mSuppressionTimes[now].push_back (index);
-    return mSuppressionMap.emplace (index, Entry ()).first->second;
+    shard.suppressionTimes[now].push_back (index);
+    return shard.suppressionMap.emplace (index, Entry ()).first->second;
 }
 
 bool HashRouter::addSuppression (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& s = shard (index);
+    ScopedLockType sl (s.lock);
 
     bool created;
-    findCreateEntry (index, created);
+    findCreateEntry (s, index, created);
     return created;
 }
 
 HashRouter::Entry HashRouter::getEntry (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& s = shard (index);
+    ScopedLockType sl (s.lock);
 
     bool created;
-    return findCreateEntry (index, created);
+    return findCreateEntry (s, index, created);
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer)
 {
-    ScopedLockType sl (mLock);
+    Shard& s = shard (index);
+    ScopedLockType sl (s.lock);
 
     bool created;
-    findCreateEntry (index, created).addPeer (peer);
+    Entry& entry = findCreateEntry (s, index, created);
+
+    if (mTrackPeers)
+        entry.addPeer (peer);
+
     return created;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int& flags)
 {
-    ScopedLockType sl (mLock);
+    Shard& sh = shard (index);
+    ScopedLockType sl (sh.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
-    s.addPeer (peer);
+    Entry& s = findCreateEntry (sh, index, created);
+
+    if (mTrackPeers)
+        s.addPeer (peer);
+
     flags = s.getFlags ();
     return created;
 }
 
 int HashRouter::getFlags (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& s = shard (index);
+    ScopedLockType sl (s.lock);
 
     bool created;
-    return findCreateEntry (index, created).getFlags ();
+    return findCreateEntry (s, index, created).getFlags ();
 }
 
 bool HashRouter::addSuppressionFlags (uint256 const& index, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& s = shard (index);
+    ScopedLockType sl (s.lock);
 
     bool created;
-    findCreateEntry (index, created).setFlag (flag);
+    findCreateEntry (s, index, created).setFlag (flag);
     return created;
 }
 
@@ -212,10 +252,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
     // return: true = changed, false = unchanged
     assert (flag != 0);
 
-    ScopedLockType sl (mLock);
+    Shard& sh = shard (index);
+    ScopedLockType sl (sh.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (sh, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -226,10 +267,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
 
 bool HashRouter::swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& sh = shard (index);
+    ScopedLockType sl (sh.lock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = findCreateEntry (sh, index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
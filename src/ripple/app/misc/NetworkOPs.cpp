@@ -19,6 +19,10 @@
 
 #include <ripple/app/book/Quality.h>
 #include <ripple/app/misc/FeeVote.h>
+#include <ripple/app/misc/SignatureVerifier.h>
+#include <ripple/app/paths/PathFindCache.h>
+#include <ripple/app/ledger/AccountItemsCache.h>
+#include <ripple/app/ledger/LedgerTiming.h>
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/basics/Time.h>
 #include <ripple/basics/StringUtilities.h>
@@ -39,10 +43,175 @@
 #include <beast/module/core/system/SystemStats.h>
 #include <beast/cxx14/memory.h> // <memory>
 #include <boost/foreach.hpp>
+#include <boost/thread/shared_lock_guard.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <tuple>
 
 namespace ripple {
 
+/** One stream's subscribers, dispatched against immutable snapshots.
+
+    Publishers take the current snapshot under a shared lock and send
+    to it with no lock held at all, so a burst of subscribes or
+    unsubscribes never stalls transaction publishing and a slow send
+    never stalls subscription changes. Mutation copies the set and
+    swaps the snapshot in.
+*/
+class StreamSubscribers
+{
+public:
+    typedef std::shared_ptr <NetworkOPs::SubMapType const> Snapshot;
+
+    // <-- bool: true=added, false=already there
+    bool add (std::uint64_t seq, InfoSub::ref listener)
+    {
+        boost::unique_lock <boost::shared_mutex> lock (m_mutex);
+
+        auto subs = m_snapshot
+            ? std::make_shared <NetworkOPs::SubMapType> (*m_snapshot)
+            : std::make_shared <NetworkOPs::SubMapType> ();
+
+        if (! subs->emplace (seq, listener).second)
+            return false;
+
+        m_snapshot = std::move (subs);
+        return true;
+    }
+
+    // <-- bool: true=erased, false=was not there
+    bool remove (std::uint64_t seq)
+    {
+        boost::unique_lock <boost::shared_mutex> lock (m_mutex);
+
+        if (! m_snapshot || m_snapshot->count (seq) == 0)
+            return false;
+
+        auto subs = std::make_shared <NetworkOPs::SubMapType> (*m_snapshot);
+        subs->erase (seq);
+
+        if (subs->empty ())
+            m_snapshot.reset ();
+        else
+            m_snapshot = std::move (subs);
+
+        return true;
+    }
+
+    /** Returns the current subscribers, or an empty pointer if none. */
+    Snapshot get () const
+    {
+        boost::shared_lock_guard <boost::shared_mutex> lock (m_mutex);
+        return m_snapshot;
+    }
+
+private:
+    boost::shared_mutex mutable m_mutex;
+    Snapshot m_snapshot;
+};
+
+/** Per-account subscribers, sharded to spread lock contention.
+
+    Each account's subscriber set is an immutable snapshot dispatched
+    the same way as StreamSubscribers; the account table itself is
+    split into shards so thousands of clients subscribing at once
+    contend on different locks than the publish path, and than each
+    other.
+*/
+class AccountSubscribers
+{
+public:
+    typedef std::shared_ptr <NetworkOPs::SubMapType const> Snapshot;
+
+    void add (Account const& account, std::uint64_t seq,
+        InfoSub::ref listener)
+    {
+        Shard& shard (shardFor (account));
+        boost::unique_lock <boost::shared_mutex> lock (shard.mutex);
+
+        Snapshot& slot (shard.entries[account]);
+
+        auto subs = slot
+            ? std::make_shared <NetworkOPs::SubMapType> (*slot)
+            : std::make_shared <NetworkOPs::SubMapType> ();
+
+        if (! slot)
+            ++m_count;
+
+        (*subs)[seq] = listener;
+        slot = std::move (subs);
+    }
+
+    void remove (Account const& account, std::uint64_t seq)
+    {
+        Shard& shard (shardFor (account));
+        boost::unique_lock <boost::shared_mutex> lock (shard.mutex);
+
+        auto const iter = shard.entries.find (account);
+
+        if (iter == shard.entries.end ())
+            return;
+
+        auto subs = std::make_shared <NetworkOPs::SubMapType> (
+            *iter->second);
+        subs->erase (seq);
+
+        if (subs->empty ())
+        {
+            shard.entries.erase (iter);
+            --m_count;
+        }
+        else
+            iter->second = std::move (subs);
+    }
+
+    /** Returns an account's subscribers, or an empty pointer if none. */
+    Snapshot get (Account const& account) const
+    {
+        Shard const& shard (shardFor (account));
+        boost::shared_lock_guard <boost::shared_mutex> lock (shard.mutex);
+
+        auto const iter = shard.entries.find (account);
+
+        if (iter == shard.entries.end ())
+            return Snapshot ();
+
+        return iter->second;
+    }
+
+    bool empty () const
+    {
+        return m_count.load () == 0;
+    }
+
+private:
+    static int const shardCount = 16;
+
+    struct Shard
+    {
+        boost::shared_mutex mutable mutex;
+        hash_map <Account, Snapshot> entries;
+    };
+
+    Shard& shardFor (Account const& account)
+    {
+        // Account IDs are hashes; any byte spreads evenly
+        return m_shards[*account.begin () % shardCount];
+    }
+
+    Shard const& shardFor (Account const& account) const
+    {
+        return m_shards[*account.begin () % shardCount];
+    }
+
+    Shard m_shards[shardCount];
+    std::atomic <int> m_count {0};
+};
+
 class NetworkOPsImp
     : public NetworkOPs
     , public beast::DeadlineTimer::Listener
@@ -82,8 +251,11 @@ public:
         , mLastCloseConvergeTime (1000 * LEDGER_IDLE_INTERVAL)
         , mLastCloseTime (0)
         , mLastValidationTime (0)
+        , mTxnsInOpenLedger (0)
         , mFetchPack ("FetchPack", 65536, 45, clock,
             deprecatedLogs().journal("TaggedCache"))
+        , mLedgerPacks ("LedgerFetchPack", 24, 300, clock,
+            deprecatedLogs().journal("TaggedCache"))
         , mFetchSeq (0)
         , mLastLoadBase (256)
         , mLastLoadFactor (256)
@@ -216,6 +388,12 @@ public:
         processTransactionCb (p, bAdmin, bLocal, bFailHard, cb);
     }
 
+    void releaseQueuedTransactions ();
+
+    // Run every parked submission through one engine pass.
+    // The caller must hold the master lock.
+    void applyTransactionBatch ();
+
     Transaction::pointer findTransactionByID (uint256 const& transactionID);
 
     int findTransactionsByDestination (
@@ -254,7 +432,8 @@ public:
 
     void getBookPage (bool bAdmin, Ledger::pointer lpLedger, Book const&,
         Account const& uTakerID, const bool bProof, const unsigned int iLimit,
-            Json::Value const& jvMarker, Json::Value& jvResult);
+            Json::Value const& jvMarker, Json::Value& jvResult,
+                std::function <void (void)> const& yield);
 
     // ledger proposal/close functions
     void processTrustedProposal (
@@ -282,6 +461,18 @@ public:
         std::shared_ptr<protocol::TMGetObjectByHash> request,
         uint256 haveLedger, std::uint32_t uUptime);
 
+    // Precomputed fetch pack contents for one ledger: its header plus
+    // the state and transaction nodes not present in the child ledger
+    struct LedgerFetchPack
+    {
+        uint256 childHash;
+        std::vector <std::pair <uint256, Blob>> objects;
+    };
+
+    std::shared_ptr <LedgerFetchPack> getLedgerFetchPack (
+        Ledger::pointer wantLedger, Ledger::pointer haveLedger);
+    void prebuildFetchPack (Job&, uint256 acceptedHash);
+
     bool shouldFetchPack (std::uint32_t seq);
     void gotFetchPack (bool progress, std::uint32_t seq);
     void addFetchPack (uint256 const& hash, std::shared_ptr< Blob >& data);
@@ -367,6 +558,7 @@ public:
     }
     Json::Value getConsensusInfo ();
     Json::Value getServerInfo (bool human, bool admin);
+    Json::Value getFeeInfo ();
     void clearLedgerFetch ();
     Json::Value getLedgerFetchInfo ();
     std::uint32_t acceptLedger ();
@@ -427,6 +619,25 @@ public:
         std::int32_t maxLedger,  bool forward, Json::Value& token,
         int limit, bool bAdmin);
 
+    void visitTxsAccount (
+        RippleAddress const& account, std::int32_t minLedger,
+        std::int32_t maxLedger, bool forward, Json::Value& token,
+        int limit, bool bAdmin,
+        std::function <void (AccountTx const&)> const& visitor);
+
+    void visitTxsAccountB (
+        RippleAddress const& account, std::int32_t minLedger,
+        std::int32_t maxLedger, bool forward, Json::Value& token,
+        int limit, bool bAdmin,
+        std::function <void (txnMetaLedgerType const&)> const& visitor);
+
+    // Generate the SQL for one page of an account's transactions,
+    // seeking directly to the marker on the AcctTxIndex covering index
+    std::string transactionsPageSQL (
+        RippleAddress const& account, std::int32_t minLedger,
+        std::int32_t maxLedger, bool forward, std::uint32_t findLedger,
+        std::uint32_t findSeq, std::uint32_t queryLimit);
+
     std::vector<RippleAddress> getLedgerAffectedAccounts (
         std::uint32_t ledgerSeq);
 
@@ -502,15 +713,17 @@ private:
     void pubAccountTransaction (
         Ledger::ref lpCurrent, const AcceptedLedgerTx& alTransaction,
         bool isAccepted);
+    void pubAcceptedAccountTransactions (AcceptedLedger::ref alpAccepted);
 
     void pubServer ();
 
     std::string getHostId (bool forAdmin);
 
+    Json::Value buildServerInfo (bool human, bool admin);
+
 private:
     clock_type& m_clock;
 
-    typedef hash_map <Account, SubMapType> SubInfoMapType;
     typedef hash_map<std::string, InfoSub::pointer> subRpcMapType;
 
     // XXX Split into more locks.
@@ -556,22 +769,108 @@ private:
     // Recent positions taken
     std::map<uint256, std::pair<int, SHAMap::pointer> > mRecentPositions;
 
-    SubInfoMapType mSubAccount;
-    SubInfoMapType mSubRTAccount;
+    // Engine verdicts for transactions already run against the
+    // current open ledger, so an identical resubmission costs a
+    // lookup instead of another engine pass. Guarded by the master
+    // lock; flushed whenever the open ledger's parent changes.
+    uint256 mSubmitParent;
+    hash_map<uint256, TER> mSubmitResults;
+
+    enum
+    {
+        // Target number of submitted transactions admitted to one open
+        // ledger before admission control starts queueing.
+        targetTxnsPerLedger = 256,
+
+        // Most transactions the admission queue will hold; beyond this
+        // the lowest-fee entry is displaced or the newcomer rejected.
+        maximumQueuedTxns = 8 * targetTxnsPerLedger,
+
+        // Closed ledgers of admitted fees kept for fee estimation.
+        feeHistoryLedgers = 8
+    };
+
+    // Fee-prioritized admission queue, best fee first. Once the open
+    // ledger has its target load, further non-admin submissions wait
+    // here and the best are released into each new open ledger.
+    // Guarded by the master lock, like the open ledger itself.
+    std::multimap <std::uint64_t, Transaction::pointer,
+        std::greater <std::uint64_t>> mTxnQueue;
+    int mTxnsInOpenLedger;
+
+    // Fees paid by transactions admitted to the open ledger, and the
+    // same for the last few closed ledgers, newest first. Feeds the
+    // fee estimation RPC. Guarded by the master lock, like the queue.
+    std::vector <std::uint64_t> mOpenLedgerFees;
+    std::deque <std::vector <std::uint64_t>> mRecentLedgerFees;
+
+    // One parked open-ledger submission. The submitter fills in the
+    // request half before parking; whichever thread next wins the
+    // master lock runs every parked submission through one engine
+    // pass and fills in the verdict half.
+    struct SubmitEntry
+    {
+        Transaction::pointer trans;
+        bool admin;
+        bool failHard;
+
+        TER result;
+        bool didApply;
+        bool fromCache;     // verdict repeated from mSubmitResults
+        bool queued;        // waiting in the fee-ordered admission queue
+        bool rejected;      // turned away by admission control
+        bool done;          // verdict half is valid
+
+        SubmitEntry (Transaction::pointer t, bool a, bool f)
+            : trans (t)
+            , admin (a)
+            , failHard (f)
+            , result (tesSUCCESS)
+            , didApply (false)
+            , fromCache (false)
+            , queued (false)
+            , rejected (false)
+            , done (false)
+        {
+        }
+    };
+
+    // Submissions parked for the next batch application. Under its
+    // own lock so arriving threads never touch the master lock just
+    // to park; `done` is written and read under the master lock.
+    std::mutex mSubmitLock;
+    std::vector <std::shared_ptr <SubmitEntry>> mSubmitParked;
+
+    // Subscription registries keep their own locks: publishing
+    // dispatches against immutable snapshots with no lock held, and
+    // subscription changes never touch the master lock
+    AccountSubscribers mSubAccount;
+    AccountSubscribers mSubRTAccount;
 
     subRpcMapType mRpcSubMap;
 
-    SubMapType mSubLedger;             // accepted ledgers
-    SubMapType mSubServer;             // when server changes connectivity state
-    SubMapType mSubTransactions;       // all accepted transactions
-    SubMapType mSubRTTransactions;     // all proposed and accepted transactions
+    StreamSubscribers mSubLedger;          // accepted ledgers
+    StreamSubscribers mSubServer;          // server connectivity changes
+    StreamSubscribers mSubTransactions;    // all accepted transactions
+    StreamSubscribers mSubRTTransactions;  // all proposed and accepted transactions
 
     TaggedCache<uint256, Blob>  mFetchPack;
+
+    // Reusable per-ledger fetch pack deltas, keyed by ledger hash
+    TaggedCache<uint256, LedgerFetchPack> mLedgerPacks;
     std::uint32_t mFetchSeq;
 
     std::uint32_t mLastLoadBase;
     std::uint32_t mLastLoadFactor;
 
+    // Prebuilt server_info payloads, one per (human, admin) variant.
+    // Monitoring polls server_info continuously fleet-wide; serving a
+    // cached copy rebuilt at most a few times a second keeps those
+    // probes from repeatedly walking application state.
+    std::mutex mServerInfoLock;
+    Json::Value mServerInfoCache [2][2];
+    std::chrono::steady_clock::time_point mServerInfoTime [2][2];
+
     JobQueue& m_job_queue;
 
     // Whether we are in standalone mode
@@ -604,7 +903,8 @@ void NetworkOPsImp::setStateTimer ()
 
 void NetworkOPsImp::setHeartbeatTimer ()
 {
-    m_heartbeatTimer.setExpiration (LEDGER_GRANULARITY / 1000.0);
+    m_heartbeatTimer.setExpiration (
+        ContinuousLedgerTiming::getTimerGranularity () / 1000.0);
 }
 
 void NetworkOPsImp::setClusterTimer ()
@@ -629,7 +929,7 @@ void NetworkOPsImp::onDeadlineTimer (beast::DeadlineTimer& timer)
 void NetworkOPsImp::processHeartbeatTimer ()
 {
     {
-        auto lock = getApp().masterLock();
+        MasterLockGuard lock (getApp ().consensusLock ());
 
         // VFALCO NOTE This is for diagnosing a crash on exit
         Application& app (getApp ());
@@ -871,20 +1171,47 @@ void NetworkOPsImp::submitTransaction (
     {
         try
         {
-            if (!passesLocalChecks (*trans) || !trans->checkSign ())
+            if (!passesLocalChecks (*trans))
             {
-                m_journal.warning << "Submitted transaction has bad signature";
+                m_journal.warning << "Submitted transaction fails local checks";
                 getApp().getHashRouter ().setFlag (suppress, SF_BAD);
                 return;
             }
-
-            getApp().getHashRouter ().setFlag (suppress, SF_SIGGOOD);
         }
         catch (...)
         {
             m_journal.warning << "Exception checking transaction " << suppress;
             return;
         }
+
+        // Verify the signature on the pool so this thread never blocks
+        // on crypto; the job is queued from the verifier's callback.
+        getApp().getSignatureVerifier ().verify (trans,
+            [this, callback] (STTx::pointer tx, bool sigGood)
+            {
+                uint256 const id = tx->getTransactionID ();
+
+                if (!sigGood)
+                {
+                    m_journal.warning <<
+                        "Submitted transaction has bad signature";
+                    getApp().getHashRouter ().setFlag (id, SF_BAD);
+                    return;
+                }
+
+                getApp().getHashRouter ().setFlag (id, SF_SIGGOOD);
+
+                m_job_queue.addJob (jtTRANSACTION, "submitTxn",
+                    std::bind (&NetworkOPsImp::processTransactionCbVoid,
+                               this,
+                               std::make_shared<Transaction> (
+                                   tx, Validate::NO),
+                               false,
+                               false,
+                               false,
+                               callback));
+            });
+        return;
     }
 
     m_job_queue.addJob (jtTRANSACTION, "submitTxn",
@@ -907,7 +1234,7 @@ Transaction::pointer NetworkOPsImp::submitTransactionSync (
     tpTrans->getSTransaction ()->add (s);
 
     auto tpTransNew = Transaction::sharedTransaction (
-        s.getData (), Validate::YES);
+        s.peekData (), Validate::YES);
 
     if (!tpTransNew)
     {
@@ -965,18 +1292,77 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
         getApp().getHashRouter ().setFlag (trans->getID (), SF_SIGGOOD);
     }
 
+    auto entry = std::make_shared <SubmitEntry> (trans, bAdmin, bFailHard);
+
     {
-        auto lock = getApp().masterLock();
+        std::lock_guard <std::mutex> lock (mSubmitLock);
+        mSubmitParked.push_back (entry);
+    }
 
-        bool didApply;
-        TER r = m_ledgerMaster.doTransaction (
-            trans->getSTransaction (),
-            bAdmin ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
-            : (tapOPEN_LEDGER | tapNO_CHECK_SIGN), didApply);
-        trans->setResult (r);
+    {
+        MasterLockGuard lock (getApp ().openLedgerLock ());
 
-        if (isTemMalformed (r)) // malformed, cache bad
-            getApp().getHashRouter ().setFlag (trans->getID (), SF_BAD);
+        // Whichever submitter wins the lock runs everything parked so
+        // far through one engine pass; during bursts a predecessor may
+        // already have handled our entry along with its own.
+        if (!entry->done)
+            applyTransactionBatch ();
+
+        trans = entry->trans;
+
+        if (entry->fromCache)
+        {
+            // Identical transaction already ran against this open
+            // ledger; the verdict was repeated without another engine
+            // pass. Relay was handled the first time.
+            TER const r = entry->result;
+            trans->setResult (r);
+
+            if (r == tesSUCCESS)
+            {
+                trans->setStatus (INCLUDED);
+                getApp().getMasterTransaction ().canonicalize (&trans);
+            }
+            else if (r == tefPAST_SEQ)
+                trans->setStatus (OBSOLETE);
+            else if (isTerRetry (r))
+            {
+                if (!bFailHard)
+                {
+                    trans->setStatus (HELD);
+                    getApp().getMasterTransaction ().canonicalize (&trans);
+                }
+            }
+            else
+                trans->setStatus (INVALID);
+
+            if (callback)
+                callback (trans, r);
+
+            return trans;
+        }
+
+        if (entry->queued)
+        {
+            m_journal.debug << "Transaction queued for next open ledger";
+
+            if (callback)
+                callback (trans, terRETRY);
+
+            return trans;
+        }
+
+        if (entry->rejected)
+        {
+            if (callback)
+                callback (trans, telINSUF_FEE_P);
+
+            return trans;
+        }
+
+        bool didApply = entry->didApply;
+        TER r = entry->result;
+        trans->setResult (r);
 
 #ifdef BEAST_DEBUG
         if (r != tesSUCCESS)
@@ -1037,7 +1423,13 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
                         trans->getSTransaction ());
         }
 
-        if (didApply || ((mMode != omFULL) && !bFailHard && bLocal))
+        // A leaf node relays nothing it heard from the network; its
+        // hubs have already seen it. Its own client submissions must
+        // still go out, or they would never leave this server.
+        bool const mayRelay = bLocal || ! getConfig ().PEER_LEAF;
+
+        if (mayRelay &&
+            (didApply || ((mMode != omFULL) && !bFailHard && bLocal)))
         {
             std::set<Peer::id_t> peers;
 
@@ -1047,13 +1439,16 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
                 protocol::TMTransaction tx;
                 Serializer s;
                 trans->getSTransaction ()->add (s);
-                tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
+                tx.set_rawtransaction (s.peekData ().data (), s.getLength ());
                 tx.set_status (protocol::tsCURRENT);
                 tx.set_receivetimestamp (getNetworkTimeNC ());
+                // The signature was checked before the transaction was
+                // applied, so cluster peers need not check it again
+                tx.set_sigverified (true);
                 // FIXME: This should be when we received it
-                getApp ().overlay ().foreach (send_if_not (
+                getApp ().overlay ().relayTransaction (
                     std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                    peer_in_set(peers)));
+                    std::move (peers));
             }
         }
     }
@@ -1061,6 +1456,180 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
     return trans;
 }
 
+void NetworkOPsImp::applyTransactionBatch ()
+{
+    std::vector <std::shared_ptr <SubmitEntry>> batch;
+
+    {
+        std::lock_guard <std::mutex> lock (mSubmitLock);
+        batch.swap (mSubmitParked);
+    }
+
+    if (batch.empty ())
+        return;
+
+    uint256 const parentHash =
+        m_ledgerMaster.getCurrentLedger ()->getParentHash ();
+
+    if (parentHash != mSubmitParent)
+    {
+        mSubmitResults.clear ();
+        mSubmitParent = parentHash;
+        mTxnsInOpenLedger = 0;
+
+        // Roll the admitted-fee history forward one ledger
+        mRecentLedgerFees.emplace_front (std::move (mOpenLedgerFees));
+        mOpenLedgerFees.clear ();
+        if (mRecentLedgerFees.size () > feeHistoryLedgers)
+            mRecentLedgerFees.pop_back ();
+    }
+
+    // Sort each entry into a repeated verdict, the admission queue,
+    // or the engine batch
+    std::vector <LedgerMaster::TxnBatchItem> items;
+    std::vector <std::shared_ptr <SubmitEntry>> engineEntries;
+    items.reserve (batch.size ());
+    engineEntries.reserve (batch.size ());
+
+    for (auto const& entry : batch)
+    {
+        Transaction::pointer trans = entry->trans;
+
+        if (!entry->admin)
+        {
+            auto const cached = mSubmitResults.find (trans->getID ());
+
+            if (cached != mSubmitResults.end ())
+            {
+                entry->result = cached->second;
+                entry->fromCache = true;
+                entry->done = true;
+                continue;
+            }
+        }
+
+        // Admission control: once the open ledger has its target load,
+        // further non-admin submissions wait in the fee-ordered queue
+        // and are released into the next open ledger, keeping close
+        // times stable under bursts.
+        if (!entry->admin && !entry->failHard &&
+            (mTxnsInOpenLedger >= targetTxnsPerLedger))
+        {
+            std::uint64_t const fee =
+                trans->getSTransaction ()->getTransactionFee ().getNValue ();
+
+            if (mTxnQueue.size () >= maximumQueuedTxns)
+            {
+                // Queue full: displace the lowest fee entry, or if the
+                // newcomer pays no better, reject it outright.
+                auto lowest = std::prev (mTxnQueue.end ());
+
+                if (fee <= lowest->first)
+                {
+                    trans->setStatus (INVALID);
+                    trans->setResult (telINSUF_FEE_P);
+                    entry->result = telINSUF_FEE_P;
+                    entry->rejected = true;
+                    entry->done = true;
+                    continue;
+                }
+
+                lowest->second->setStatus (INVALID);
+                lowest->second->setResult (telINSUF_FEE_P);
+                mTxnQueue.erase (lowest);
+            }
+
+            trans->setStatus (HELD);
+            trans->setResult (terRETRY);
+            getApp().getMasterTransaction ().canonicalize (&trans);
+            mTxnQueue.emplace (fee, trans);
+            entry->trans = trans;
+            entry->result = terRETRY;
+            entry->queued = true;
+            entry->done = true;
+            continue;
+        }
+
+        LedgerMaster::TxnBatchItem item;
+        item.txn = trans->getSTransaction ();
+        item.params = entry->admin
+            ? (tapOPEN_LEDGER | tapNO_CHECK_SIGN | tapADMIN)
+            : (tapOPEN_LEDGER | tapNO_CHECK_SIGN);
+        items.push_back (item);
+        engineEntries.push_back (entry);
+    }
+
+    if (items.empty ())
+        return;
+
+    // One mutable snapshot, one engine pass and one publish for the
+    // whole batch
+    m_ledgerMaster.doTransactionBatch (items);
+
+    for (std::size_t i = 0; i < items.size (); ++i)
+    {
+        auto const& entry = engineEntries[i];
+        TER const r = items[i].result;
+
+        entry->result = r;
+        entry->didApply = items[i].didApply;
+
+        if (isTemMalformed (r)) // malformed, cache bad
+            getApp().getHashRouter ().setFlag (
+                entry->trans->getID (), SF_BAD);
+
+        if (!entry->admin && (r != tefFAILURE))
+            mSubmitResults.emplace (entry->trans->getID (), r);
+
+        if (r == tesSUCCESS)
+        {
+            ++mTxnsInOpenLedger;
+            mOpenLedgerFees.push_back (
+                items[i].txn->getTransactionFee ().getNValue ());
+        }
+
+        entry->done = true;
+    }
+}
+
+void NetworkOPsImp::releaseQueuedTransactions ()
+{
+    // Pull the best-fee queued transactions and resubmit them against
+    // the new open ledger through the normal processing path, which
+    // applies, relays and, if necessary, requeues them.
+    std::vector <Transaction::pointer> release;
+
+    {
+        MasterLockGuard lock (getApp ().openLedgerLock ());
+
+        auto it = mTxnQueue.begin ();
+        while (it != mTxnQueue.end () &&
+            release.size () < std::size_t (targetTxnsPerLedger))
+        {
+            release.push_back (it->second);
+            it = mTxnQueue.erase (it);
+        }
+    }
+
+    if (release.empty ())
+        return;
+
+    m_journal.debug << "Releasing " << release.size ()
+                    << " queued transactions into new open ledger";
+
+    for (auto const& trans : release)
+    {
+        m_job_queue.addJob (jtTRANSACTION, "queuedTxn",
+            std::bind (&NetworkOPsImp::processTransactionCbVoid,
+                       this,
+                       trans,
+                       false,
+                       true,
+                       false,
+                       stCallback ()));
+    }
+}
+
 Transaction::pointer NetworkOPsImp::findTransactionByID (
     uint256 const& transactionID)
 {
@@ -1274,6 +1843,14 @@ void NetworkOPsImp::tryStartConsensus ()
             setMode (omTRACKING);
     }
 
+    // A replica only follows the chain: checkLastClosedLedger has already
+    // pulled us onto the network's ledger, and that is all a replica does.
+    // It never reports omFULL and never starts a consensus round, so each
+    // validated ledger arrives as a header plus state delta and is
+    // installed without re-executing its transactions.
+    if (getConfig ().RUN_REPLICA)
+        return;
+
     if (((mMode == omCONNECTED) || (mMode == omTRACKING)) && !ledgerChange)
     {
         // check if the ledger is good enough to go to omFULL
@@ -1561,10 +2138,10 @@ void NetworkOPsImp::processTrustedProposal (
     std::shared_ptr<protocol::TMProposeSet> set, RippleAddress nodePublic,
     uint256 checkLedger, bool sigGood)
 {
-    {
-        auto lock = getApp().masterLock();
+    bool relay = true;
 
-        bool relay = true;
+    {
+        MasterLockGuard lock (getApp ().consensusLock ());
 
         if (!haveConsensusObject ())
         {
@@ -1598,24 +2175,26 @@ void NetworkOPsImp::processTrustedProposal (
                     << "Proposal processing finished, relay=" << relay;
             }
         }
+    }
 
-        if (relay)
-        {
-            std::set<Peer::id_t> peers;
-            if (getApp().getHashRouter ().swapSet (
-                proposal->getSuppressionID (), peers, SF_RELAYED))
-            {
-                getApp ().overlay ().foreach (send_if_not (
-                    std::make_shared<Message> (
-                        *set, protocol::mtPROPOSE_LEDGER),
-                    peer_in_set(peers)));
-            }
-        }
-        else
+    // The HashRouter and overlay do their own locking, so we can
+    // relay without holding the master lock
+    if (relay && ! getConfig ().PEER_LEAF)
+    {
+        std::set<Peer::id_t> peers;
+        if (getApp().getHashRouter ().swapSet (
+            proposal->getSuppressionID (), peers, SF_RELAYED))
         {
-            m_journal.info << "Not relaying trusted proposal";
+            getApp ().overlay ().foreach (send_if_not (
+                std::make_shared<Message> (
+                    *set, protocol::mtPROPOSE_LEDGER),
+                peer_in_set(peers)));
         }
     }
+    else
+    {
+        m_journal.info << "Not relaying trusted proposal";
+    }
 }
 
 // Must be called while holding the master lock
@@ -1710,6 +2289,12 @@ void NetworkOPsImp::endConsensus (bool correctLCL)
     }
 
     mConsensus = std::shared_ptr<LedgerConsensus> ();
+
+    // Start the next round immediately on the fresh open ledger rather
+    // than waiting for the heartbeat timer; the prior round's save and
+    // publish stages complete on the job queue in parallel.
+    if (correctLCL && !m_standalone)
+        tryStartConsensus ();
 }
 
 void NetworkOPsImp::consensusViewChange ()
@@ -1720,13 +2305,7 @@ void NetworkOPsImp::consensusViewChange ()
 
 void NetworkOPsImp::pubServer ()
 {
-    // VFALCO TODO Don't hold the lock across calls to send...make a copy of the
-    //             list into a local array while holding the lock then release the
-    //             lock and call send on everyone.
-    //
-    ScopedLockType sl (mLock);
-
-    if (!mSubServer.empty ())
+    if (auto const subs = mSubServer.get ())
     {
         Json::Value jvObj (Json::objectValue);
 
@@ -1737,25 +2316,14 @@ void NetworkOPsImp::pubServer ()
         jvObj [jss::load_factor]   =
                 (mLastLoadFactor = getApp().getFeeTrack ().getLoadFactor ());
 
-        std::string sObj = to_string (jvObj);
-
+        auto sObj = std::make_shared <std::string const> (to_string (jvObj));
 
-        for (auto i = mSubServer.begin (); i != mSubServer.end (); )
+        for (auto const& sub : *subs)
         {
-            InfoSub::pointer p = i->second.lock ();
-
-            // VFALCO TODO research the possibility of using thread queues and
-            //             linearizing the deletion of subscribers with the
-            //             sending of JSON data.
-            if (p)
-            {
+            if (InfoSub::pointer p = sub.second.lock ())
                 p->send (jvObj, sObj, true);
-                ++i;
-            }
             else
-            {
-                i = mSubServer.erase (i);
-            }
+                mSubServer.remove (sub.first);
         }
     }
 }
@@ -1889,8 +2457,8 @@ NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
         minLedger, maxLedger, descending, offset, limit, false, false, bAdmin);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -1923,7 +2491,8 @@ NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
             }
 
             ret.emplace_back (txn, std::make_shared<TransactionMetaSet> (
-                txn->getID (), txn->getLedger (), rawMeta.getData ()));
+                txn->getID (), txn->getLedger (),
+                    decompressTxnMeta (rawMeta.peekData ())));
         }
     }
 
@@ -1944,8 +2513,8 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
         bAdmin);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -1973,6 +2542,8 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
             else
                 rawMeta.resize (metaSize);
 
+            rawMeta = decompressTxnMeta (rawMeta);
+
             ret.emplace_back (
                 strHex (rawTxn), strHex (rawMeta), db->getInt ("LedgerSeq"));
         }
@@ -1982,40 +2553,82 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
 }
 
 
-NetworkOPsImp::AccountTxs NetworkOPsImp::getTxsAccount (
+std::string NetworkOPsImp::transactionsPageSQL (
     RippleAddress const& account, std::int32_t minLedger,
-    std::int32_t maxLedger, bool forward, Json::Value& token,
-    int limit, bool bAdmin)
+    std::int32_t maxLedger, bool forward, std::uint32_t findLedger,
+    std::uint32_t findSeq, std::uint32_t queryLimit)
 {
-    AccountTxs ret;
-
-    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    std::uint32_t EXTRA_LENGTH = 100;
+    std::string sql = boost::str (boost::format
+        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
+         "Status,RawTxn,TxnMeta "
+         "FROM AccountTransactions INNER JOIN Transactions "
+         "ON Transactions.TransID = AccountTransactions.TransID "
+         "WHERE AccountTransactions.Account = '%s' "
+         "AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' ")
+             % account.humanAccountID()
+             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
+             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger));
 
-    bool foundResume = token.isNull() || !token.isObject();
+    if (findLedger != 0)
+    {
+        // Seek straight to the marker position on AcctTxIndex instead of
+        // re-scanning the marker's ledger from its first transaction. The
+        // marker row itself is included, matching the old resume behavior.
+        if (forward)
+            sql += boost::str (boost::format
+                ("AND (AccountTransactions.LedgerSeq > '%u' "
+                 "OR AccountTransactions.TxnSeq >= '%u') ")
+                     % findLedger % findSeq);
+        else
+            sql += boost::str (boost::format
+                ("AND (AccountTransactions.LedgerSeq < '%u' "
+                 "OR AccountTransactions.TxnSeq <= '%u') ")
+                     % findLedger % findSeq);
+    }
 
-    std::uint32_t numberOfResults, queryLimit;
+    sql += boost::str (boost::format
+        ("ORDER BY AccountTransactions.LedgerSeq %s, "
+         "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
+         "LIMIT %u;")
+             % (forward ? "ASC" : "DESC")
+             % (forward ? "ASC" : "DESC")
+             % (forward ? "ASC" : "DESC")
+             % queryLimit);
+
+    return sql;
+}
+
+void NetworkOPsImp::visitTxsAccount (
+    RippleAddress const& account, std::int32_t minLedger,
+    std::int32_t maxLedger, bool forward, Json::Value& token,
+    int limit, bool bAdmin,
+    std::function <void (AccountTx const&)> const& visitor)
+{
+    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
+
+    bool const haveMarker = !token.isNull() && token.isObject();
+
+    std::uint32_t numberOfResults;
     if (limit <= 0)
         numberOfResults = NONBINARY_PAGE_LENGTH;
     else if (!bAdmin && (limit > NONBINARY_PAGE_LENGTH))
         numberOfResults = NONBINARY_PAGE_LENGTH;
     else
         numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
 
     std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
+    if (haveMarker)
     {
         try
         {
             if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
+                return;
             findLedger = token[jss::ledger].asInt();
             findSeq = token[jss::seq].asInt();
         }
         catch (...)
         {
-            return ret;
+            return;
         }
     }
 
@@ -2023,35 +2636,15 @@ NetworkOPsImp::AccountTxs NetworkOPsImp::getTxsAccount (
     //         outputs, so we need to clear it in between.
     token = Json::nullValue;
 
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
-         "Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions "
-         "ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' "
-         "AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, "
-         "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
+    std::string sql = transactionsPageSQL (account, minLedger, maxLedger,
+        forward, findLedger, findSeq, numberOfResults + 1);
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
-            if (!foundResume)
-            {
-                foundResume = (findLedger == db->getInt("LedgerSeq") &&
-                               findSeq == db->getInt("TxnSeq"));
-            }
-            else if (numberOfResults == 0)
+            if (numberOfResults == 0)
             {
                 token = Json::objectValue;
                 token[jss::ledger] = db->getInt("LedgerSeq");
@@ -2059,120 +2652,107 @@ NetworkOPsImp::AccountTxs NetworkOPsImp::getTxsAccount (
                 break;
             }
 
-            if (foundResume)
-            {
-                auto txn = Transaction::transactionFromSQL (db, Validate::NO);
+            auto txn = Transaction::transactionFromSQL (db, Validate::NO);
 
-                Serializer rawMeta;
-                int metaSize = 2048;
+            Serializer rawMeta;
+            int metaSize = 2048;
+            rawMeta.resize (metaSize);
+            metaSize = db->getBinary (
+                "TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
+
+            if (metaSize > rawMeta.getLength ())
+            {
                 rawMeta.resize (metaSize);
-                metaSize = db->getBinary (
+                db->getBinary (
                     "TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
+            }
+            else
+                rawMeta.resize (metaSize);
 
-                if (metaSize > rawMeta.getLength ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary (
-                        "TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                if (rawMeta.getLength() == 0)
-                {
-                    // Work around a bug that could leave the metadata missing
-                    auto seq = static_cast<std::uint32_t>(
-                        db->getBigInt("LedgerSeq"));
-                    m_journal.warning << "Recovering ledger " << seq
-                                      << ", txn " << txn->getID();
-                    Ledger::pointer ledger = getLedgerBySeq(seq);
-                    if (ledger)
-                        ledger->pendSaveValidated(false, false);
-                }
+            if (rawMeta.getLength() == 0)
+            {
+                // Work around a bug that could leave the metadata missing
+                auto seq = static_cast<std::uint32_t>(
+                    db->getBigInt("LedgerSeq"));
+                m_journal.warning << "Recovering ledger " << seq
+                                  << ", txn " << txn->getID();
+                Ledger::pointer ledger = getLedgerBySeq(seq);
+                if (ledger)
+                    ledger->pendSaveValidated(false, false);
+            }
 
-                --numberOfResults;
+            --numberOfResults;
 
-                ret.emplace_back (std::move (txn),
-                    std::make_shared<TransactionMetaSet> (
-                        txn->getID (), txn->getLedger (), rawMeta.getData ()));
-            }
+            visitor (AccountTx (std::move (txn),
+                std::make_shared<TransactionMetaSet> (
+                    txn->getID (), txn->getLedger (),
+                        decompressTxnMeta (rawMeta.peekData ()))));
         }
     }
-
-    return ret;
 }
 
-NetworkOPsImp::MetaTxsList NetworkOPsImp::getTxsAccountB (
+NetworkOPsImp::AccountTxs NetworkOPsImp::getTxsAccount (
     RippleAddress const& account, std::int32_t minLedger,
-    std::int32_t maxLedger,  bool forward, Json::Value& token,
+    std::int32_t maxLedger, bool forward, Json::Value& token,
     int limit, bool bAdmin)
 {
-    MetaTxsList ret;
+    AccountTxs ret;
+
+    visitTxsAccount (account, minLedger, maxLedger, forward, token,
+        limit, bAdmin,
+        [&ret] (AccountTx const& accountTx)
+        {
+            ret.push_back (accountTx);
+        });
+
+    return ret;
+}
 
+void NetworkOPsImp::visitTxsAccountB (
+    RippleAddress const& account, std::int32_t minLedger,
+    std::int32_t maxLedger, bool forward, Json::Value& token,
+    int limit, bool bAdmin,
+    std::function <void (txnMetaLedgerType const&)> const& visitor)
+{
     std::uint32_t BINARY_PAGE_LENGTH = 500;
-    std::uint32_t EXTRA_LENGTH = 100;
 
-    bool foundResume = token.isNull() || !token.isObject();
+    bool const haveMarker = !token.isNull() && token.isObject();
 
-    std::uint32_t numberOfResults, queryLimit;
+    std::uint32_t numberOfResults;
     if (limit <= 0)
         numberOfResults = BINARY_PAGE_LENGTH;
     else if (!bAdmin && (limit > BINARY_PAGE_LENGTH))
         numberOfResults = BINARY_PAGE_LENGTH;
     else
         numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
 
     std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
+    if (haveMarker)
     {
         try
         {
             if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
+                return;
             findLedger = token[jss::ledger].asInt();
             findSeq = token[jss::seq].asInt();
         }
         catch (...)
         {
-            return ret;
+            return;
         }
     }
 
     token = Json::nullValue;
 
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,"
-         "Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions "
-         "ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' "
-         "AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, "
-         "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
+    std::string sql = transactionsPageSQL (account, minLedger, maxLedger,
+        forward, findLedger, findSeq, numberOfResults + 1);
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
-            if (!foundResume)
-            {
-                if (findLedger == db->getInt("LedgerSeq") &&
-                    findSeq == db->getInt("TxnSeq"))
-                {
-                    foundResume = true;
-                }
-            }
-            else if (numberOfResults == 0)
+            if (numberOfResults == 0)
             {
                 token = Json::objectValue;
                 token[jss::ledger] = db->getInt("LedgerSeq");
@@ -2180,42 +2760,56 @@ NetworkOPsImp::MetaTxsList NetworkOPsImp::getTxsAccountB (
                 break;
             }
 
-            if (foundResume)
+            int txnSize = 2048;
+            Blob rawTxn (txnSize);
+            txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
+
+            if (txnSize > rawTxn.size ())
             {
-                int txnSize = 2048;
-                Blob rawTxn (txnSize);
-                txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
+                rawTxn.resize (txnSize);
+                db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
+            }
+            else
+                rawTxn.resize (txnSize);
 
-                if (txnSize > rawTxn.size ())
-                {
-                    rawTxn.resize (txnSize);
-                    db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
-                }
-                else
-                    rawTxn.resize (txnSize);
+            int metaSize = 2048;
+            Blob rawMeta (metaSize);
+            metaSize = db->getBinary (
+                "TxnMeta", &rawMeta[0], rawMeta.size ());
 
-                int metaSize = 2048;
-                Blob rawMeta (metaSize);
-                metaSize = db->getBinary (
-                    "TxnMeta", &rawMeta[0], rawMeta.size ());
+            if (metaSize > rawMeta.size ())
+            {
+                rawMeta.resize (metaSize);
+                db->getBinary (
+                    "TxnMeta", &*rawMeta.begin (), rawMeta.size ());
+            }
+            else
+            {
+                rawMeta.resize (metaSize);
+            }
 
-                if (metaSize > rawMeta.size ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary (
-                        "TxnMeta", &*rawMeta.begin (), rawMeta.size ());
-                }
-                else
-                {
-                    rawMeta.resize (metaSize);
-                }
+            rawMeta = decompressTxnMeta (rawMeta);
 
-                ret.emplace_back (strHex (rawTxn), strHex (rawMeta),
-                                  db->getInt ("LedgerSeq"));
-                --numberOfResults;
-            }
+            visitor (txnMetaLedgerType (strHex (rawTxn), strHex (rawMeta),
+                db->getInt ("LedgerSeq")));
+            --numberOfResults;
         }
     }
+}
+
+NetworkOPsImp::MetaTxsList NetworkOPsImp::getTxsAccountB (
+    RippleAddress const& account, std::int32_t minLedger,
+    std::int32_t maxLedger,  bool forward, Json::Value& token,
+    int limit, bool bAdmin)
+{
+    MetaTxsList ret;
+
+    visitTxsAccountB (account, minLedger, maxLedger, forward, token,
+        limit, bAdmin,
+        [&ret] (txnMetaLedgerType const& row)
+        {
+            ret.push_back (row);
+        });
 
     return ret;
 }
@@ -2231,8 +2825,8 @@ NetworkOPsImp::getLedgerAffectedAccounts (std::uint32_t ledgerSeq)
                            % ledgerSeq);
     RippleAddress acct;
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
         SQL_FOREACH (db, sql)
         {
             if (acct.setAccountID (db->getStrBinary ("Account")))
@@ -2262,6 +2856,33 @@ Json::Value NetworkOPsImp::getConsensusInfo ()
 
 
 Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
+{
+    // Serve a prebuilt payload when one is fresh enough. Rebuilds are
+    // rate limited, so the fleet can poll this at 10Hz without the
+    // probes themselves perturbing the server.
+    auto const now = std::chrono::steady_clock::now ();
+
+    {
+        std::lock_guard <std::mutex> lock (mServerInfoLock);
+        Json::Value const& cached = mServerInfoCache [human][admin];
+        if (! cached.isNull () &&
+            (now - mServerInfoTime [human][admin] <
+                std::chrono::milliseconds (250)))
+            return cached;
+    }
+
+    Json::Value info = buildServerInfo (human, admin);
+
+    {
+        std::lock_guard <std::mutex> lock (mServerInfoLock);
+        mServerInfoCache [human][admin] = info;
+        mServerInfoTime [human][admin] = now;
+    }
+
+    return info;
+}
+
+Json::Value NetworkOPsImp::buildServerInfo (bool human, bool admin)
 {
     Json::Value info = Json::objectValue;
 
@@ -2273,6 +2894,9 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
 
     info [jss::server_state] = strOperatingMode ();
 
+    if (getConfig ().RUN_REPLICA)
+        info["replica"] = true;
+
     if (mNeedNetworkLedger)
         info[jss::network_ledger] = jss::waiting;
 
@@ -2426,6 +3050,84 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     return info;
 }
 
+Json::Value NetworkOPsImp::getFeeInfo ()
+{
+    Json::Value info (Json::objectValue);
+
+    // Snapshot the admission state under the lock that guards it,
+    // then do the sorting and scaling on our own copy
+    std::vector <std::uint64_t> fees;
+    std::size_t queueSize;
+    std::uint64_t queueFloor = 0;
+    int openCount;
+    std::size_t historyLedgers;
+
+    {
+        MasterLockGuard lock (getApp ().openLedgerLock ());
+
+        fees = mOpenLedgerFees;
+        for (auto const& ledgerFees : mRecentLedgerFees)
+            fees.insert (fees.end (),
+                ledgerFees.begin (), ledgerFees.end ());
+
+        queueSize = mTxnQueue.size ();
+        if (queueSize >= maximumQueuedTxns)
+            queueFloor = std::prev (mTxnQueue.end ())->first;
+        openCount = mTxnsInOpenLedger;
+        historyLedgers = mRecentLedgerFees.size ();
+    }
+
+    info["current_ledger_size"] = openCount;
+    info["expected_ledger_size"] = Json::UInt (targetTxnsPerLedger);
+    info["current_queue_size"] = Json::UInt (queueSize);
+    info["max_queue_size"] = Json::UInt (maximumQueuedTxns);
+    info["fee_history_ledgers"] = Json::UInt (historyLedgers);
+
+    info[jss::load_base] = getApp().getFeeTrack ().getLoadBase ();
+    info[jss::load_factor] = getApp().getFeeTrack ().getLoadFactor ();
+
+    Ledger::pointer lpCurrent = m_ledgerMaster.getCurrentLedger ();
+
+    Json::Value& drops = (info["drops"] = Json::objectValue);
+
+    if (lpCurrent)
+    {
+        info[jss::ledger_current_index] = lpCurrent->getLedgerSeq ();
+
+        std::uint64_t const feeUnits = getConfig ().TRANSACTION_FEE_BASE;
+        drops["base_fee"] = Json::Value::UInt (
+            lpCurrent->scaleFeeBase (feeUnits));
+        drops["open_ledger_fee"] = Json::Value::UInt (
+            lpCurrent->scaleFeeLoad (feeUnits, false));
+    }
+
+    // When the queue is full a submission must beat the lowest queued
+    // fee or it is rejected outright
+    if (queueFloor != 0)
+        drops["queue_displacement_fee"] = Json::Value::UInt (queueFloor);
+
+    if (! fees.empty ())
+    {
+        std::sort (fees.begin (), fees.end ());
+
+        auto percentile = [&fees] (int p) -> Json::Value::UInt
+        {
+            return fees[((fees.size () - 1) * p) / 100];
+        };
+
+        drops["minimum_fee"] = percentile (0);
+        drops["median_fee"] = percentile (50);
+
+        Json::Value& levels = (info["fee_percentiles"] = Json::objectValue);
+        levels["p25"] = percentile (25);
+        levels["p50"] = percentile (50);
+        levels["p75"] = percentile (75);
+        levels["p90"] = percentile (90);
+    }
+
+    return info;
+}
+
 void NetworkOPsImp::clearLedgerFetch ()
 {
     getApp().getInboundLedgers().clearFailures();
@@ -2456,31 +3158,64 @@ Json::Value NetworkOPsImp::pubBootstrapAccountInfo (
     return jvObj;
 }
 
+// Evaluates a subscriber's transaction stream filter against the
+// pre-extracted data in AcceptedLedgerTx, before any serialization
+// happens on the subscriber's behalf.
+static bool passesTxFilter (InfoSub& subscriber,
+    AcceptedLedgerTx const& alTx)
+{
+    auto const filter = subscriber.getTxFilter ();
+
+    if (! filter)
+        return true;
+
+    if (! filter->types.empty () &&
+        (filter->types.count (alTx.getTxn ()->getTxnType ()) == 0))
+        return false;
+
+    if (! filter->accounts.empty ())
+    {
+        for (auto const& affected : alTx.getAffected ())
+            if (filter->accounts.count (affected.getAccountID ()) != 0)
+                return true;
+
+        return false;
+    }
+
+    return true;
+}
+
 void NetworkOPsImp::pubProposedTransaction (
     Ledger::ref lpCurrent, STTx::ref stTxn, TER terResult)
 {
+    AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
+
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
 
-    {
-        ScopedLockType sl (mLock);
+    // Serialized lazily: when every subscriber filters this
+    // transaction out, it is never rendered at all
+    InfoSub::MessagePtr sObj;
 
-        auto it = mSubRTTransactions.begin ();
-        while (it != mSubRTTransactions.end ())
+    if (auto const subs = mSubRTTransactions.get ())
+    {
+        for (auto const& sub : *subs)
         {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
+            if (InfoSub::pointer p = sub.second.lock ())
             {
-                p->send (jvObj, true);
-                ++it;
+                if (!passesTxFilter (*p, alt))
+                    continue;
+
+                if (! sObj)
+                    sObj = std::make_shared <std::string const> (
+                        to_string (jvObj));
+
+                p->send (jvObj, sObj, true);
             }
             else
-            {
-                it = mSubRTTransactions.erase (it);
-            }
+                mSubRTTransactions.remove (sub.first);
         }
     }
-    AcceptedLedgerTx alt (lpCurrent, stTxn, terResult);
+
     m_journal.trace << "pubProposed: " << alt.getJson ();
     pubAccountTransaction (lpCurrent, alt, false);
 }
@@ -2493,54 +3228,72 @@ void NetworkOPsImp::pubLedger (Ledger::ref accepted)
     auto alpAccepted = AcceptedLedger::makeAcceptedLedger (accepted);
     Ledger::ref lpAccepted = alpAccepted->getLedger ();
 
+    if (auto const subs = mSubLedger.get ())
     {
-        ScopedLockType sl (mLock);
+        Json::Value jvObj (Json::objectValue);
 
-        if (!mSubLedger.empty ())
-        {
-            Json::Value jvObj (Json::objectValue);
+        jvObj[jss::type] = jss::ledgerClosed;
+        jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
+        jvObj[jss::ledger_hash] = to_string (lpAccepted->getHash ());
+        jvObj[jss::ledger_time]
+                = Json::Value::UInt (lpAccepted->getCloseTimeNC ());
 
-            jvObj[jss::type] = jss::ledgerClosed;
-            jvObj[jss::ledger_index] = lpAccepted->getLedgerSeq ();
-            jvObj[jss::ledger_hash] = to_string (lpAccepted->getHash ());
-            jvObj[jss::ledger_time]
-                    = Json::Value::UInt (lpAccepted->getCloseTimeNC ());
+        jvObj[jss::fee_ref]
+                = Json::UInt (lpAccepted->getReferenceFeeUnits ());
+        jvObj[jss::fee_base] = Json::UInt (lpAccepted->getBaseFee ());
+        jvObj[jss::reserve_base] = Json::UInt (lpAccepted->getReserve (0));
+        jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->getReserveInc ());
 
-            jvObj[jss::fee_ref]
-                    = Json::UInt (lpAccepted->getReferenceFeeUnits ());
-            jvObj[jss::fee_base] = Json::UInt (lpAccepted->getBaseFee ());
-            jvObj[jss::reserve_base] = Json::UInt (lpAccepted->getReserve (0));
-            jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->getReserveInc ());
+        jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
 
-            jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
+        if (mMode >= omSYNCING)
+        {
+            jvObj[jss::validated_ledgers]
+                    = getApp().getLedgerMaster ().getCompleteLedgers ();
+        }
 
-            if (mMode >= omSYNCING)
-            {
-                jvObj[jss::validated_ledgers]
-                        = getApp().getLedgerMaster ().getCompleteLedgers ();
-            }
+        auto sObj = std::make_shared <std::string const> (
+            to_string (jvObj));
 
-            auto it = mSubLedger.begin ();
-            while (it != mSubLedger.end ())
-            {
-                InfoSub::pointer p = it->second.lock ();
-                if (p)
-                {
-                    p->send (jvObj, true);
-                    ++it;
-                }
-                else
-                    it = mSubLedger.erase (it);
-            }
+        for (auto const& sub : *subs)
+        {
+            if (InfoSub::pointer p = sub.second.lock ())
+                p->send (jvObj, sObj, true);
+            else
+                mSubLedger.remove (sub.first);
         }
     }
 
+    {
+        // Drop cached path results and account item snapshots that
+        // this ledger made stale
+        hash_set <Account> touched;
+
+        for (auto const& it : alpAccepted->getAffectedIndex ())
+            touched.insert (it.first);
+
+        PathFindCache::instance ().onLedgerAccepted (touched);
+        AccountItemsCache::instance ().onLedgerAccepted (
+            touched, lpAccepted->getHash ());
+    }
+
+    // Precompute this ledger's fetch pack delta off the publish path
+    m_job_queue.addJob (jtPACK, "prebuildFetchPack",
+        std::bind (&NetworkOPsImp::prebuildFetchPack, this,
+                   std::placeholders::_1, lpAccepted->getHash ()));
+
     // Don't lock since pubAcceptedTransaction is locking.
     BOOST_FOREACH (const AcceptedLedger::value_type & vt, alpAccepted->getMap ())
     {
         m_journal.trace << "pubAccepted: " << vt.second->getJson ();
         pubValidatedTransaction (lpAccepted, *vt.second);
     }
+
+    pubAcceptedAccountTransactions (alpAccepted);
+
+    // Every transaction's metadata has been processed: snapshots of
+    // hot order books can now serve reads as of this ledger
+    getApp().getOrderBookDB ().sealBookSnapshots (lpAccepted);
 }
 
 void NetworkOPsImp::reportFeeChange ()
@@ -2608,6 +3361,23 @@ Json::Value NetworkOPsImp::transJson(
     return jvObj;
 }
 
+// Binary subscription envelope for one validated transaction: a one
+// byte message type (1), the ledger sequence, the engine result code,
+// then the transaction and metadata as length-prefixed canonical
+// blobs - the same bytes the ledger stores. Serialized once and
+// shared by every binary subscriber.
+static InfoSub::MessagePtr
+makeBinaryTxMessage (Ledger::ref ledger, AcceptedLedgerTx const& alTx)
+{
+    Serializer s;
+    s.add8 (1);
+    s.add32 (ledger->getLedgerSeq ());
+    s.add8 (static_cast<unsigned char> (alTx.getResult ()));
+    s.addVL (alTx.getTxn ()->getSerialized ());
+    s.addVL (alTx.getRawMeta ());
+    return std::make_shared <std::string const> (s.getString ());
+}
+
 void NetworkOPsImp::pubValidatedTransaction (
     Ledger::ref alAccepted, const AcceptedLedgerTx& alTx)
 {
@@ -2615,42 +3385,54 @@ void NetworkOPsImp::pubValidatedTransaction (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-    std::string sObj = to_string (jvObj);
+    // Each rendering is only built if some subscriber wants it, and
+    // then shared by everyone who does
+    InfoSub::MessagePtr sObj;
+    InfoSub::MessagePtr sBin;
 
+    auto deliver = [&] (InfoSub::pointer const& p)
     {
-        ScopedLockType sl (mLock);
+        if (!passesTxFilter (*p, alTx))
+            return;
 
-        auto it = mSubTransactions.begin ();
-        while (it != mSubTransactions.end ())
+        if (p->getBinaryMode ())
         {
-            InfoSub::pointer p = it->second.lock ();
+            if (! sBin)
+                sBin = makeBinaryTxMessage (alAccepted, alTx);
+            p->sendBinary (jvObj, sBin, true);
+        }
+        else
+        {
+            if (! sObj)
+                sObj = std::make_shared <std::string const> (
+                    to_string (jvObj));
+            p->send (jvObj, sObj, true);
+        }
+    };
 
-            if (p)
-            {
-                p->send (jvObj, sObj, true);
-                ++it;
-            }
+    if (auto const subs = mSubTransactions.get ())
+    {
+        for (auto const& sub : *subs)
+        {
+            if (InfoSub::pointer p = sub.second.lock ())
+                deliver (p);
             else
-                it = mSubTransactions.erase (it);
+                mSubTransactions.remove (sub.first);
         }
+    }
 
-        it = mSubRTTransactions.begin ();
-
-        while (it != mSubRTTransactions.end ())
+    if (auto const subs = mSubRTTransactions.get ())
+    {
+        for (auto const& sub : *subs)
         {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, sObj, true);
-                ++it;
-            }
+            if (InfoSub::pointer p = sub.second.lock ())
+                deliver (p);
             else
-                it = mSubRTTransactions.erase (it);
+                mSubRTTransactions.remove (sub.first);
         }
     }
+
     getApp().getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
-    pubAccountTransaction (alAccepted, alTx, true);
 }
 
 void NetworkOPsImp::pubAccountTransaction (
@@ -2660,61 +3442,47 @@ void NetworkOPsImp::pubAccountTransaction (
     int                             iProposed   = 0;
     int                             iAccepted   = 0;
 
-    {
-        ScopedLockType sl (mLock);
+    if (!bAccepted && mSubRTAccount.empty ()) return;
 
-        if (!bAccepted && mSubRTAccount.empty ()) return;
-
-        if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
+    if (!mSubAccount.empty () || (!mSubRTAccount.empty ()) )
+    {
+        for (auto const& affectedAccount: alTx.getAffected ())
         {
-            for (auto const& affectedAccount: alTx.getAffected ())
+            Account const account (affectedAccount.getAccountID ());
+
+            if (auto const subs = mSubRTAccount.get (account))
             {
-                auto simiIt
-                        = mSubRTAccount.find (affectedAccount.getAccountID ());
-                if (simiIt != mSubRTAccount.end ())
+                for (auto const& sub : *subs)
                 {
-                    auto it = simiIt->second.begin ();
-
-                    while (it != simiIt->second.end ())
+                    if (InfoSub::pointer p = sub.second.lock ())
                     {
-                        InfoSub::pointer p = it->second.lock ();
-
-                        if (p)
-                        {
-                            notify.insert (p);
-                            ++it;
-                            ++iProposed;
-                        }
-                        else
-                            it = simiIt->second.erase (it);
+                        notify.insert (p);
+                        ++iProposed;
                     }
+                    else
+                        mSubRTAccount.remove (account, sub.first);
                 }
+            }
 
-                if (bAccepted)
+            if (bAccepted)
+            {
+                if (auto const subs = mSubAccount.get (account))
                 {
-                    simiIt  = mSubAccount.find (affectedAccount.getAccountID ());
-
-                    if (simiIt != mSubAccount.end ())
+                    for (auto const& sub : *subs)
                     {
-                        auto it = simiIt->second.begin ();
-                        while (it != simiIt->second.end ())
+                        if (InfoSub::pointer p = sub.second.lock ())
                         {
-                            InfoSub::pointer p = it->second.lock ();
-
-                            if (p)
-                            {
-                                notify.insert (p);
-                                ++it;
-                                ++iAccepted;
-                            }
-                            else
-                                it = simiIt->second.erase (it);
+                            notify.insert (p);
+                            ++iAccepted;
                         }
+                        else
+                            mSubAccount.remove (account, sub.first);
                     }
                 }
             }
         }
     }
+
     m_journal.info << "pubAccountTransaction:" <<
         " iProposed=" << iProposed <<
         " iAccepted=" << iAccepted;
@@ -2727,7 +3495,7 @@ void NetworkOPsImp::pubAccountTransaction (
         if (alTx.isApplied ())
             jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
-        std::string sObj = to_string (jvObj);
+        auto sObj = std::make_shared <std::string const> (to_string (jvObj));
 
         BOOST_FOREACH (InfoSub::ref isrListener, notify)
         {
@@ -2736,6 +3504,89 @@ void NetworkOPsImp::pubAccountTransaction (
     }
 }
 
+void NetworkOPsImp::pubAcceptedAccountTransactions (
+    AcceptedLedger::ref alpAccepted)
+{
+    if (mSubAccount.empty () && mSubRTAccount.empty ())
+        return;
+
+    Ledger::ref lpAccepted = alpAccepted->getLedger ();
+
+    // One pass over the ledger's affected-account index: each
+    // account's subscriber lists are consulted once, no matter how
+    // many of the ledger's transactions touched it. Keyed by
+    // transaction index so messages go out in transaction order.
+    std::map <int, hash_set <InfoSub::pointer> > notify;
+    int iProposed = 0;
+    int iAccepted = 0;
+
+    for (auto const& entry : alpAccepted->getAffectedIndex ())
+    {
+        Account const& account = entry.first;
+        hash_set <InfoSub::pointer> listeners;
+
+        if (auto const subs = mSubRTAccount.get (account))
+        {
+            for (auto const& sub : *subs)
+            {
+                if (InfoSub::pointer p = sub.second.lock ())
+                {
+                    listeners.insert (p);
+                    ++iProposed;
+                }
+                else
+                    mSubRTAccount.remove (account, sub.first);
+            }
+        }
+
+        if (auto const subs = mSubAccount.get (account))
+        {
+            for (auto const& sub : *subs)
+            {
+                if (InfoSub::pointer p = sub.second.lock ())
+                {
+                    listeners.insert (p);
+                    ++iAccepted;
+                }
+                else
+                    mSubAccount.remove (account, sub.first);
+            }
+        }
+
+        if (listeners.empty ())
+            continue;
+
+        for (auto const& alTx : entry.second)
+            notify[alTx->getIndex ()].insert (
+                listeners.begin (), listeners.end ());
+    }
+
+    m_journal.info << "pubAcceptedAccountTransactions:" <<
+        " iProposed=" << iProposed <<
+        " iAccepted=" << iAccepted;
+
+    for (auto const& it : notify)
+    {
+        AcceptedLedgerTx::pointer alTx = alpAccepted->getTxn (it.first);
+
+        if (!alTx)
+            continue;
+
+        Json::Value jvObj = transJson (
+            *alTx->getTxn (), alTx->getResult (), true, lpAccepted);
+
+        if (alTx->isApplied ())
+            jvObj[jss::meta] = alTx->getMeta ()->getJson (0);
+
+        auto sObj = std::make_shared <std::string const> (to_string (jvObj));
+
+        BOOST_FOREACH (InfoSub::ref isrListener, it.second)
+        {
+            isrListener->send (jvObj, sObj, true);
+        }
+    }
+}
+
 //
 // Monitoring
 //
@@ -2744,7 +3595,7 @@ void NetworkOPsImp::subAccount (InfoSub::ref isrListener,
     const hash_set<RippleAddress>& vnaAccountIDs,
     std::uint32_t uLedgerIndex, bool rt)
 {
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    AccountSubscribers& subMap = rt ? mSubRTAccount : mSubAccount;
 
     // For the connection, monitor each account.
     BOOST_FOREACH (const RippleAddress & naAccountID, vnaAccountIDs)
@@ -2755,24 +3606,10 @@ void NetworkOPsImp::subAccount (InfoSub::ref isrListener,
         isrListener->insertSubAccountInfo (naAccountID, uLedgerIndex);
     }
 
-    ScopedLockType sl (mLock);
-
     BOOST_FOREACH (const RippleAddress & naAccountID, vnaAccountIDs)
     {
-        auto simIterator = subMap.find (naAccountID.getAccountID ());
-        if (simIterator == subMap.end ())
-        {
-            // Not found, note that account has a new single listner.
-            SubMapType  usisElement;
-            usisElement[isrListener->getSeq ()] = isrListener;
-            subMap.insert (simIterator, make_pair (naAccountID.getAccountID (),
-                                                   usisElement));
-        }
-        else
-        {
-            // Found, note that the account has another listener.
-            simIterator->second[isrListener->getSeq ()] = isrListener;
-        }
+        subMap.add (naAccountID.getAccountID (),
+            isrListener->getSeq (), isrListener);
     }
 }
 
@@ -2781,7 +3618,7 @@ void NetworkOPsImp::unsubAccount (
     hash_set<RippleAddress> const& vnaAccountIDs,
     bool rt)
 {
-    SubInfoMapType& subMap = rt ? mSubRTAccount : mSubAccount;
+    AccountSubscribers& subMap = rt ? mSubRTAccount : mSubAccount;
 
     // For the connection, unmonitor each account.
     // FIXME: Don't we need to unsub?
@@ -2790,24 +3627,8 @@ void NetworkOPsImp::unsubAccount (
     //  isrListener->deleteSubAccountInfo(naAccountID);
     // }
 
-    ScopedLockType sl (mLock);
-
     for (auto const& naAccountID : vnaAccountIDs)
-    {
-        auto simIterator = subMap.find (naAccountID.getAccountID ());
-
-        if (simIterator != subMap.end ())
-        {
-            // Found
-            simIterator->second.erase (uSeq);
-
-            if (simIterator->second.empty ())
-            {
-                // Don't need hash entry.
-                subMap.erase (simIterator);
-            }
-        }
-    }
+        subMap.remove (naAccountID.getAccountID (), uSeq);
 }
 
 bool NetworkOPsImp::subBook (InfoSub::ref isrListener, Book const& book)
@@ -2831,6 +3652,9 @@ void NetworkOPsImp::newLCL (
     int proposers, int convergeTime, uint256 const& ledgerHash)
 {
     assert (convergeTime);
+    ContinuousLedgerTiming::onConsensus (
+        proposers, mLastCloseProposers, convergeTime);
+
     mLastCloseProposers = proposers;
     mLastCloseConvergeTime = convergeTime;
     mLastCloseHash = ledgerHash;
@@ -2839,10 +3663,19 @@ void NetworkOPsImp::newLCL (
 std::uint32_t NetworkOPsImp::acceptLedger ()
 {
     // accept the current transaction tree, return the new ledger's sequence
-    beginConsensus (
-        m_ledgerMaster.getClosedLedger ()->getHash (),
-        m_ledgerMaster.getCurrentLedger ());
-    mConsensus->simulate ();
+    std::shared_ptr<LedgerConsensus> consensus;
+    {
+        MasterLockGuard lock (getApp ().consensusLock ());
+        beginConsensus (
+            m_ledgerMaster.getClosedLedger ()->getHash (),
+            m_ledgerMaster.getCurrentLedger ());
+        consensus = mConsensus;
+    }
+
+    // simulate() runs accept synchronously, which takes the consensus
+    // lock itself; we must not hold it here. Standalone mode has no
+    // competing rounds.
+    consensus->simulate ();
     return m_ledgerMaster.getCurrentLedger ()->getLedgerSeq ();
 }
 
@@ -2881,15 +3714,13 @@ bool NetworkOPsImp::subLedger (InfoSub::ref isrListener, Json::Value& jvResult)
                 = getApp().getLedgerMaster ().getCompleteLedgers ();
     }
 
-    ScopedLockType sl (mLock);
-    return mSubLedger.emplace (isrListener->getSeq (), isrListener).second;
+    return mSubLedger.add (isrListener->getSeq (), isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool NetworkOPsImp::unsubLedger (std::uint64_t uSeq)
 {
-    ScopedLockType sl (mLock);
-    return mSubLedger.erase (uSeq);
+    return mSubLedger.remove (uSeq);
 }
 
 // <-- bool: true=added, false=already there
@@ -2912,45 +3743,37 @@ bool NetworkOPsImp::subServer (InfoSub::ref isrListener, Json::Value& jvResult,
     jvResult[jss::pubkey_node]     = getApp ().getLocalCredentials ().
         getNodePublic ().humanNodePublic ();
 
-    ScopedLockType sl (mLock);
-    return mSubServer.emplace (isrListener->getSeq (), isrListener).second;
+    return mSubServer.add (isrListener->getSeq (), isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool NetworkOPsImp::unsubServer (std::uint64_t uSeq)
 {
-    ScopedLockType sl (mLock);
-    return mSubServer.erase (uSeq);
+    return mSubServer.remove (uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool NetworkOPsImp::subTransactions (InfoSub::ref isrListener)
 {
-    ScopedLockType sl (mLock);
-    return mSubTransactions.emplace (
-        isrListener->getSeq (), isrListener).second;
+    return mSubTransactions.add (isrListener->getSeq (), isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool NetworkOPsImp::unsubTransactions (std::uint64_t uSeq)
 {
-    ScopedLockType sl (mLock);
-    return mSubTransactions.erase (uSeq);
+    return mSubTransactions.remove (uSeq);
 }
 
 // <-- bool: true=added, false=already there
 bool NetworkOPsImp::subRTTransactions (InfoSub::ref isrListener)
 {
-    ScopedLockType sl (mLock);
-    return mSubRTTransactions.emplace (
-        isrListener->getSeq (), isrListener).second;
+    return mSubRTTransactions.add (isrListener->getSeq (), isrListener);
 }
 
 // <-- bool: true=erased, false=was not there
 bool NetworkOPsImp::unsubRTTransactions (std::uint64_t uSeq)
 {
-    ScopedLockType sl (mLock);
-    return mSubRTTransactions.erase (uSeq);
+    return mSubRTTransactions.remove (uSeq);
 }
 
 InfoSub::pointer NetworkOPsImp::findRpcSub (std::string const& strUrl)
@@ -2989,7 +3812,8 @@ void NetworkOPsImp::getBookPage (
     bool const bProof,
     const unsigned int iLimit,
     Json::Value const& jvMarker,
-    Json::Value& jvResult)
+    Json::Value& jvResult,
+    std::function <void (void)> const& yield)
 { // CAUTION: This is the old get book page logic
     Json::Value& jvOffers =
             (jvResult[jss::offers] = Json::Value (Json::arrayValue));
@@ -3026,8 +3850,152 @@ void NetworkOPsImp::getBookPage (
     if (! bAdmin && left > 300)
         left = 300;
 
+    // Format one offer, computing its funded amounts against the
+    // running owner balances. Shared by the snapshot path and the
+    // directory walk below.
+    auto const addOffer =
+        [&] (SLE::ref sleOffer, STAmount const& saDirRate)
+    {
+        auto const uOfferOwnerID =
+                sleOffer->getFieldAccount160 (sfAccount);
+        auto const& saTakerGets =
+                sleOffer->getFieldAmount (sfTakerGets);
+        auto const& saTakerPays =
+                sleOffer->getFieldAmount (sfTakerPays);
+        STAmount saOwnerFunds;
+        bool firstOwnerOffer (true);
+
+        if (book.out.account == uOfferOwnerID)
+        {
+            // If an offer is selling issuer's own IOUs, it is fully
+            // funded.
+            saOwnerFunds    = saTakerGets;
+        }
+        else if (bGlobalFreeze)
+        {
+            // If either asset is globally frozen, consider all offers
+            // that aren't ours to be totally unfunded
+            saOwnerFunds.clear (IssueRef (book.out.currency, book.out.account));
+        }
+        else
+        {
+            auto umBalanceEntry  = umBalance.find (uOfferOwnerID);
+            if (umBalanceEntry != umBalance.end ())
+            {
+                // Found in running balance table.
+
+                saOwnerFunds    = umBalanceEntry->second;
+                firstOwnerOffer = false;
+            }
+            else
+            {
+                // Did not find balance in table.
+
+                saOwnerFunds = lesActive.accountHolds (
+                    uOfferOwnerID, book.out.currency,
+                    book.out.account, fhZERO_IF_FROZEN);
+
+                if (saOwnerFunds < zero)
+                {
+                    // Treat negative funds as zero.
+
+                    saOwnerFunds.clear ();
+                }
+            }
+        }
+
+        Json::Value jvOffer = sleOffer->getJson (0);
+
+        STAmount    saTakerGetsFunded;
+        STAmount    saOwnerFundsLimit;
+        std::uint32_t uOfferRate;
+
+
+        if (uTransferRate != QUALITY_ONE
+            // Have a tranfer fee.
+            && uTakerID != book.out.account
+            // Not taking offers of own IOUs.
+            && book.out.account != uOfferOwnerID)
+            // Offer owner not issuing ownfunds
+        {
+            // Need to charge a transfer fee to offer owner.
+            uOfferRate          = uTransferRate;
+            saOwnerFundsLimit   = divide (
+                saOwnerFunds, STAmount (noIssue(), uOfferRate, -9));
+            // TODO(tom): why -9?
+        }
+        else
+        {
+            uOfferRate          = QUALITY_ONE;
+            saOwnerFundsLimit   = saOwnerFunds;
+        }
+
+        if (saOwnerFundsLimit >= saTakerGets)
+        {
+            // Sufficient funds no shenanigans.
+            saTakerGetsFunded   = saTakerGets;
+        }
+        else
+        {
+            // Only provide, if not fully funded.
+
+            saTakerGetsFunded   = saOwnerFundsLimit;
+
+            saTakerGetsFunded.setJson (jvOffer[jss::taker_gets_funded]);
+            std::min (
+                saTakerPays, multiply (
+                    saTakerGetsFunded, saDirRate, saTakerPays)).setJson
+                    (jvOffer[jss::taker_pays_funded]);
+        }
+
+        STAmount saOwnerPays = (QUALITY_ONE == uOfferRate)
+            ? saTakerGetsFunded
+            : std::min (
+                saOwnerFunds,
+                multiply (
+                    saTakerGetsFunded,
+                    STAmount (noIssue(),
+                              uOfferRate, -9)));
+
+        umBalance[uOfferOwnerID]    = saOwnerFunds - saOwnerPays;
+
+        // Include all offers funded and unfunded
+        Json::Value& jvOf = jvOffers.append (std::move (jvOffer));
+        jvOf[jss::quality] = saDirRate.getText ();
+
+        if (firstOwnerOffer)
+            jvOf[jss::owner_funds] = saOwnerFunds.getText ();
+    };
+
+    unsigned int entriesExamined (0);
+
+    // Hot books are materialized from accepted ledger metadata. When a
+    // snapshot matches this exact ledger, serve it from memory: only
+    // the owner balances are read from the ledger.
+    auto const snapshotOffers (getApp().getOrderBookDB ().
+        getSnapshotOffers (book, lpLedger, left));
+
+    if (!snapshotOffers.empty ())
+    {
+        for (auto const& bookOffer : snapshotOffers)
+        {
+            if (yield && ((++entriesExamined % 64) == 0))
+                yield ();
+
+            addOffer (bookOffer.offer,
+                amountFromQuality (getQuality (bookOffer.dir)));
+        }
+
+        return;
+    }
+
     while (!bDone && left-- > 0)
     {
+        // When running as a coroutine, periodically surrender the thread
+        // so other clients can make progress while our reads complete
+        if (yield && ((++entriesExamined % 64) == 0))
+            yield ();
+
         if (bDirectAdvance)
         {
             bDirectAdvance  = false;
@@ -3061,115 +4029,7 @@ void NetworkOPsImp::getBookPage (
 
             if (sleOffer)
             {
-                auto const uOfferOwnerID =
-                        sleOffer->getFieldAccount160 (sfAccount);
-                auto const& saTakerGets =
-                        sleOffer->getFieldAmount (sfTakerGets);
-                auto const& saTakerPays =
-                        sleOffer->getFieldAmount (sfTakerPays);
-                STAmount saOwnerFunds;
-                bool firstOwnerOffer (true);
-
-                if (book.out.account == uOfferOwnerID)
-                {
-                    // If an offer is selling issuer's own IOUs, it is fully
-                    // funded.
-                    saOwnerFunds    = saTakerGets;
-                }
-                else if (bGlobalFreeze)
-                {
-                    // If either asset is globally frozen, consider all offers
-                    // that aren't ours to be totally unfunded
-                    saOwnerFunds.clear (IssueRef (book.out.currency, book.out.account));
-                }
-                else
-                {
-                    auto umBalanceEntry  = umBalance.find (uOfferOwnerID);
-                    if (umBalanceEntry != umBalance.end ())
-                    {
-                        // Found in running balance table.
-
-                        saOwnerFunds    = umBalanceEntry->second;
-                        firstOwnerOffer = false;
-                    }
-                    else
-                    {
-                        // Did not find balance in table.
-
-                        saOwnerFunds = lesActive.accountHolds (
-                            uOfferOwnerID, book.out.currency,
-                            book.out.account, fhZERO_IF_FROZEN);
-
-                        if (saOwnerFunds < zero)
-                        {
-                            // Treat negative funds as zero.
-
-                            saOwnerFunds.clear ();
-                        }
-                    }
-                }
-
-                Json::Value jvOffer = sleOffer->getJson (0);
-
-                STAmount    saTakerGetsFunded;
-                STAmount    saOwnerFundsLimit;
-                std::uint32_t uOfferRate;
-
-
-                if (uTransferRate != QUALITY_ONE
-                    // Have a tranfer fee.
-                    && uTakerID != book.out.account
-                    // Not taking offers of own IOUs.
-                    && book.out.account != uOfferOwnerID)
-                    // Offer owner not issuing ownfunds
-                {
-                    // Need to charge a transfer fee to offer owner.
-                    uOfferRate          = uTransferRate;
-                    saOwnerFundsLimit   = divide (
-                        saOwnerFunds, STAmount (noIssue(), uOfferRate, -9));
-                    // TODO(tom): why -9?
-                }
-                else
-                {
-                    uOfferRate          = QUALITY_ONE;
-                    saOwnerFundsLimit   = saOwnerFunds;
-                }
-
-                if (saOwnerFundsLimit >= saTakerGets)
-                {
-                    // Sufficient funds no shenanigans.
-                    saTakerGetsFunded   = saTakerGets;
-                }
-                else
-                {
-                    // Only provide, if not fully funded.
-
-                    saTakerGetsFunded   = saOwnerFundsLimit;
-
-                    saTakerGetsFunded.setJson (jvOffer[jss::taker_gets_funded]);
-                    std::min (
-                        saTakerPays, multiply (
-                            saTakerGetsFunded, saDirRate, saTakerPays)).setJson
-                            (jvOffer[jss::taker_pays_funded]);
-                }
-
-                STAmount saOwnerPays = (QUALITY_ONE == uOfferRate)
-                    ? saTakerGetsFunded
-                    : std::min (
-                        saOwnerFunds,
-                        multiply (
-                            saTakerGetsFunded,
-                            STAmount (noIssue(),
-                                      uOfferRate, -9)));
-
-                umBalance[uOfferOwnerID]    = saOwnerFunds - saOwnerPays;
-
-                // Include all offers funded and unfunded
-                Json::Value& jvOf = jvOffers.append (jvOffer);
-                jvOf[jss::quality] = saDirRate.getText ();
-
-                if (firstOwnerOffer)
-                    jvOf[jss::owner_funds] = saOwnerFunds.getText ();
+                addOffer (sleOffer, saDirRate);
             }
             else
             {
@@ -3207,7 +4067,8 @@ void NetworkOPsImp::getBookPage (
     bool const bProof,
     const unsigned int iLimit,
     Json::Value const& jvMarker,
-    Json::Value& jvResult)
+    Json::Value& jvResult,
+    std::function <void (void)> const& yield)
 {
     auto& jvOffers = (jvResult[jss::offers] = Json::Value (Json::arrayValue));
 
@@ -3225,8 +4086,12 @@ void NetworkOPsImp::getBookPage (
     if (! bAdmin && left > 300)
         left = 300;
 
+    unsigned int entriesExamined (0);
+
     while (left-- > 0 && obIterator.nextOffer ())
     {
+        if (yield && ((++entriesExamined % 64) == 0))
+            yield ();
 
         SLE::pointer    sleOffer        = obIterator.getCurrentOffer();
         if (sleOffer)
@@ -3332,7 +4197,7 @@ void NetworkOPsImp::getBookPage (
             if (!saOwnerFunds.isZero () || uOfferOwnerID == uTakerID)
             {
                 // Only provide funded offers and offers of the taker.
-                Json::Value& jvOf   = jvOffers.append (jvOffer);
+                Json::Value& jvOf   = jvOffers.append (std::move (jvOffer));
                 jvOf[jss::quality]     = saDirRate.getText ();
             }
 
@@ -3355,6 +4220,62 @@ static void fpAppender (
     newObj.set_data (&blob[0], blob.size ());
 }
 
+std::shared_ptr <NetworkOPsImp::LedgerFetchPack>
+NetworkOPsImp::getLedgerFetchPack (
+    Ledger::pointer wantLedger, Ledger::pointer haveLedger)
+{
+    auto pack = mLedgerPacks.fetch (wantLedger->getHash ());
+
+    // The delta depends on which child it was computed against. On the
+    // validated chain that child is unique, so this almost always hits.
+    if (pack && (pack->childHash == haveLedger->getHash ()))
+        return pack;
+
+    pack = std::make_shared <LedgerFetchPack> ();
+    pack->childHash = haveLedger->getHash ();
+
+    {
+        Serializer s (256);
+        s.add32 (HashPrefix::ledgerMaster);
+        wantLedger->addRaw (s);
+        pack->objects.emplace_back (wantLedger->getHash (),
+            std::move (s.modData ()));
+    }
+
+    auto appender = [&pack] (uint256 const& hash, Blob&& blob)
+        {
+            pack->objects.emplace_back (hash, std::move (blob));
+        };
+
+    wantLedger->peekAccountStateMap ()->getFetchPack (
+        haveLedger->peekAccountStateMap ().get (), true, 1024, appender);
+
+    if (wantLedger->getTransHash ().isNonZero ())
+        wantLedger->peekTransactionMap ()->getFetchPack (
+            nullptr, true, 256, appender);
+
+    mLedgerPacks.canonicalize (wantLedger->getHash (), pack, true);
+    return pack;
+}
+
+void NetworkOPsImp::prebuildFetchPack (Job&, uint256 acceptedHash)
+{
+    // Compute the delta between the newly accepted ledger and its parent
+    // once, so a burst of syncing peers is answered from the cache
+    Ledger::pointer accepted = getLedgerByHash (acceptedHash);
+
+    if (!accepted)
+        return;
+
+    Ledger::pointer parent = getLedgerByHash (accepted->getParentHash ());
+
+    if (parent && parent->isClosed () &&
+        (parent->getLedgerSeq () >= m_ledgerMaster.getEarliestFetch ()))
+    {
+        getLedgerFetchPack (parent, accepted);
+    }
+}
+
 void NetworkOPsImp::makeFetchPack (
     Job&, std::weak_ptr<Peer> wPeer,
     std::shared_ptr<protocol::TMGetObjectByHash> request,
@@ -3440,24 +4361,12 @@ void NetworkOPsImp::makeFetchPack (
         {
             std::uint32_t lSeq = wantLedger->getLedgerSeq ();
 
-            protocol::TMIndexedObject& newObj = *reply.add_objects ();
-            newObj.set_hash (wantLedger->getHash ().begin (), 256 / 8);
-            Serializer s (256);
-            s.add32 (HashPrefix::ledgerMaster);
-            wantLedger->addRaw (s);
-            newObj.set_data (s.getDataPtr (), s.getLength ());
-            newObj.set_ledgerseq (lSeq);
-
-            wantLedger->peekAccountStateMap ()->getFetchPack
-                (haveLedger->peekAccountStateMap ().get (), true, 1024,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
-
-            if (wantLedger->getTransHash ().isNonZero ())
-                wantLedger->peekTransactionMap ()->getFetchPack (
-                    nullptr, true, 256,
-                    std::bind (fpAppender, &reply, lSeq, std::placeholders::_1,
-                               std::placeholders::_2));
+            // Serving a precomputed delta is a sequence of buffer copies;
+            // only the first request for a ledger pays for the tree walk.
+            auto pack = getLedgerFetchPack (wantLedger, haveLedger);
+
+            for (auto const& obj : pack->objects)
+                fpAppender (&reply, lSeq, obj.first, obj.second);
 
             if (reply.objects ().size () >= 256)
                 break;
@@ -3483,6 +4392,7 @@ void NetworkOPsImp::makeFetchPack (
 void NetworkOPsImp::sweepFetchPack ()
 {
     mFetchPack.sweep ();
+    mLedgerPacks.sweep ();
 }
 
 void NetworkOPsImp::addFetchPack (
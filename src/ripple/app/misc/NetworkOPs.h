@@ -24,6 +24,7 @@
 #include <ripple/net/InfoSub.h>
 #include <beast/cxx14/memory.h> // <memory>
 #include <beast/threads/Stoppable.h>
+#include <functional>
 #include <tuple>
 
 namespace ripple {
@@ -149,6 +150,12 @@ public:
         bool bAdmin, bool bLocal, bool bFailHard, stCallback) = 0;
     virtual Transaction::pointer processTransaction (Transaction::pointer transaction,
         bool bAdmin, bool bLocal, bool bFailHard) = 0;
+
+    /** Release the best queued transactions into a new open ledger.
+        Called as each new open ledger is built; transactions that were
+        held back by admission control re-enter processing in fee order.
+    */
+    virtual void releaseQueuedTransactions () = 0;
     virtual Transaction::pointer findTransactionByID (uint256 const& transactionID) = 0;
     virtual int findTransactionsByDestination (std::list<Transaction::pointer>&,
         RippleAddress const& destinationAccount, std::uint32_t startLedgerSeq,
@@ -194,7 +201,8 @@ public:
         bool const bProof,
         const unsigned int iLimit,
         Json::Value const& jvMarker,
-        Json::Value& jvResult) = 0;
+        Json::Value& jvResult,
+        std::function <void (void)> const& yield) = 0;
 
     //--------------------------------------------------------------------------
 
@@ -259,6 +267,11 @@ public:
 
     virtual Json::Value getConsensusInfo () = 0;
     virtual Json::Value getServerInfo (bool human, bool admin) = 0;
+
+    /** Fee levels needed for open-ledger inclusion, computed from the
+        fees of recently admitted transactions, the admission queue and
+        the current load escalation. */
+    virtual Json::Value getFeeInfo () = 0;
     virtual void clearLedgerFetch () = 0;
     virtual Json::Value getLedgerFetchInfo () = 0;
     virtual std::uint32_t acceptLedger () = 0;
@@ -312,6 +325,24 @@ public:
         std::int32_t minLedger, std::int32_t maxLedger,  bool forward,
         Json::Value& token, int limit, bool bAdmin) = 0;
 
+    /** Visit an account's transactions one row at a time.
+
+        Each decoded row is handed to `visitor` as it is read from the
+        database, so a page is never fully materialized in memory. The
+        marker semantics match getTxsAccount.
+    */
+    virtual void visitTxsAccount (
+        RippleAddress const& account,
+        std::int32_t minLedger, std::int32_t maxLedger, bool forward,
+        Json::Value& token, int limit, bool bAdmin,
+        std::function <void (AccountTx const&)> const& visitor) = 0;
+
+    virtual void visitTxsAccountB (
+        RippleAddress const& account,
+        std::int32_t minLedger, std::int32_t maxLedger, bool forward,
+        Json::Value& token, int limit, bool bAdmin,
+        std::function <void (txnMetaLedgerType const&)> const& visitor) = 0;
+
     virtual std::vector<RippleAddress> getLedgerAffectedAccounts (
         std::uint32_t ledgerSeq) = 0;
 
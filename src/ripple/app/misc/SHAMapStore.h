@@ -42,6 +42,7 @@ public:
         std::uint32_t ledgerHistory = 0;
         beast::StringPairArray nodeDatabase;
         beast::StringPairArray ephemeralNodeDatabase;
+        beast::StringPairArray hotNodeDatabase;
         std::string databasePath;
         std::uint32_t deleteBatch = 100;
         std::uint32_t backOff = 100;
@@ -19,6 +19,7 @@
 
 #include <ripple/app/misc/SHAMapStoreImp.h>
 #include <beast/cxx14/memory.h> // <memory>
+#include <fstream>
 
 namespace ripple {
 
@@ -232,6 +233,10 @@ SHAMapStoreImp::makeDatabase (std::string const& name,
 
     if (setup_.deleteInterval)
     {
+        if (setup_.hotNodeDatabase.size())
+            journal_.warning << "online_delete takes precedence; the "
+                    "[hot_db] section is ignored";
+
         SavedState state = state_db_.getState();
 
         std::shared_ptr <NodeStore::Backend> writableBackend (
@@ -252,6 +257,12 @@ SHAMapStoreImp::makeDatabase (std::string const& name,
         database_ = dbr.get();
         db.reset (dynamic_cast <NodeStore::Database*>(dbr.release()));
     }
+    else if (setup_.hotNodeDatabase.size())
+    {
+        db = manager_.make_DatabaseTiered (name, scheduler_,
+                nodeStoreJournal_, readThreads, setup_.nodeDatabase,
+                setup_.hotNodeDatabase);
+    }
     else
     {
         db = manager_.make_Database (name, scheduler_, nodeStoreJournal_,
@@ -287,6 +298,56 @@ SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
     return false;
 }
 
+bool
+SHAMapStoreImp::copyStateToWritable()
+{
+    if (! stateCopy_)
+    {
+        if (! validatedLedger_)
+            return false;
+
+        stateCopy_ = validatedLedger_->peekAccountStateMap()->snapShot (
+                false);
+    }
+
+    std::uint64_t nodeCount = 0;
+    stateCopy_->visitNodes (
+            std::bind (&SHAMapStoreImp::copyNode, this,
+            std::ref(nodeCount), std::placeholders::_1));
+    if (health() != Health::ok)
+    {
+        journal_.warning << "state copy interrupted at " << nodeCount
+                << " nodes, will resume";
+        return false;
+    }
+
+    journal_.debug << "copied state map, nodecount " << nodeCount;
+    stateCopy_.reset();
+    setStateCopyComplete();
+
+    return true;
+}
+
+bool
+SHAMapStoreImp::stateCopyComplete() const
+{
+    boost::filesystem::path marker =
+            database_->getWritableBackend()->getName();
+    marker /= copiedMarker_;
+
+    return boost::filesystem::exists (marker);
+}
+
+void
+SHAMapStoreImp::setStateCopyComplete()
+{
+    boost::filesystem::path marker =
+            database_->getWritableBackend()->getName();
+    marker /= copiedMarker_;
+
+    std::ofstream (marker.string().c_str());
+}
+
 void
 SHAMapStoreImp::run()
 {
@@ -298,6 +359,11 @@ SHAMapStoreImp::run()
     transactionDb_ = &getApp().getTxnDB();
     ledgerDb_ = &getApp().getLedgerDB();
 
+    // A process that exited with a rotation's state copy unfinished
+    // left no completion marker in the writable backend. The copy must
+    // be redone before the archive can be retired again.
+    bool copyPending = ! stateCopyComplete();
+
     while (1)
     {
         healthy_ = true;
@@ -326,6 +392,23 @@ SHAMapStoreImp::run()
         if (setup_.advisoryDelete)
             canDelete = state_db_.getCanDelete();
 
+        // The archive may not be retired while it is the only complete
+        // copy of part of the state, so finish any pending state copy
+        // before considering another rotation.
+        if (copyPending)
+        {
+            if (! copyStateToWritable())
+            {
+                if (health() == Health::stopping)
+                {
+                    stopped();
+                    return;
+                }
+                continue;
+            }
+            copyPending = false;
+        }
+
         // will delete up to (not including) lastRotated)
         if (validatedSeq >= lastRotated + setup_.deleteInterval
                 && canDelete >= lastRotated - 1)
@@ -359,25 +442,6 @@ SHAMapStoreImp::run()
                     ;
             }
 
-            std::uint64_t nodeCount = 0;
-            validatedLedger_->peekAccountStateMap()->snapShot (
-                    false)->visitNodes (
-                    std::bind (&SHAMapStoreImp::copyNode, this,
-                    std::ref(nodeCount), std::placeholders::_1));
-            journal_.debug << "copied ledger " << validatedSeq
-                    << " nodecount " << nodeCount;
-            switch (health())
-            {
-                case Health::stopping:
-                    stopped();
-                    return;
-                case Health::unhealthy:
-                    continue;
-                case Health::ok:
-                default:
-                    ;
-            }
-
             freshenCaches();
             journal_.debug << validatedSeq << " freshened caches";
             switch (health())
@@ -425,6 +489,15 @@ SHAMapStoreImp::run()
             journal_.debug << "finished rotation " << validatedSeq;
 
             oldBackend->setDeletePath();
+
+            // The retired backend held nothing newer than the previous
+            // lastRotated, but the new archive is now the only
+            // complete copy of the current state. Migrate the
+            // rotation-time state into the fresh writable backend in
+            // the background; the next rotation waits for this.
+            stateCopy_ = validatedLedger_->peekAccountStateMap()->
+                    snapShot (false);
+            copyPending = true;
         }
     }
 }
@@ -573,6 +646,7 @@ SHAMapStoreImp::clearCaches (LedgerIndex validatedSeq)
 {
     ledgerMaster_->clearLedgerCachePrior (validatedSeq);
     fullBelowCache_->clear();
+    transactionMaster_.clearCommitted (validatedSeq);
 }
 
 void
@@ -696,6 +770,7 @@ setup_SHAMapStore (Config const& c)
     setup.ledgerHistory = c.LEDGER_HISTORY;
     setup.nodeDatabase = c.nodeDatabase;
     setup.ephemeralNodeDatabase = c.ephemeralNodeDatabase;
+    setup.hotNodeDatabase = c.hotNodeDatabase;
     setup.databasePath = c.DATABASE_PATH;
     if (c.nodeDatabase["delete_batch"].isNotEmpty())
         setup.deleteBatch = c.nodeDatabase["delete_batch"].getIntValue();
@@ -75,6 +75,9 @@ private:
     std::string const dbName_ = "state.db";
     // prefix of on-disk nodestore backend instances
     std::string const dbPrefix_ = "rippledb";
+    // marker file placed in a writable backend once the post-rotation
+    // state copy into it has completed
+    std::string const copiedMarker_ = ".state-copied";
     // check health/stop status as records are copied
     std::uint64_t const checkHealthInterval_ = 1000;
     // minimum # of ledgers to maintain for health of network
@@ -99,6 +102,9 @@ private:
     // as of onPrepare() or before
     NetworkOPs* netOPs_ = nullptr;
     LedgerMaster* ledgerMaster_ = nullptr;
+    // state map snapshot taken at rotation, pending migration into the
+    // writable backend. Rotation is deferred while this is set.
+    std::shared_ptr <SHAMap> stateCopy_;
     FullBelowCache* fullBelowCache_ = nullptr;
     TreeNodeCache* treeNodeCache_ = nullptr;
     DatabaseCon* transactionDb_ = nullptr;
@@ -158,6 +164,15 @@ public:
 private:
     // callback for visitNodes
     bool copyNode (std::uint64_t& nodeCount, SHAMapTreeNode const &node);
+    /** Copy the pending state snapshot into the writable backend.
+     *  Interruptible: returns false if stopped by health or shutdown,
+     *  in which case it must be called again before the next rotation.
+     *  Places the completion marker on success.
+     */
+    bool copyStateToWritable();
+    // whether the writable backend carries the completion marker
+    bool stateCopyComplete() const;
+    void setStateCopyComplete();
     void run();
     void dbPaths();
     std::shared_ptr <NodeStore::Backend> makeBackendRotating (
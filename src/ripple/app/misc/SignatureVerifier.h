@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SIGNATUREVERIFIER_H_INCLUDED
+#define RIPPLE_SIGNATUREVERIFIER_H_INCLUDED
+
+#include <ripple/protocol/STTx.h>
+#include <beast/utility/Journal.h>
+#include <functional>
+#include <memory>
+
+namespace ripple {
+
+/** Pool of threads dedicated to checking transaction signatures.
+
+    ECDSA verification dominates CPU on the transaction intake path, and
+    doing it inline on JobQueue threads starves the other job types. The
+    pool accepts work from any thread, verifies signatures in batches on
+    its own threads, and reports each verdict through a callback. Callers
+    must never assume the callback runs on the submitting thread.
+*/
+class SignatureVerifier
+{
+public:
+    /** Receives the transaction and `true` if the signature is valid. */
+    typedef std::function <void (STTx::pointer, bool)> Callback;
+
+    virtual ~SignatureVerifier () = default;
+
+    /** Queue one transaction for verification.
+
+        The callback is invoked exactly once, on a pool thread, after
+        the signature has been checked. Exceptions thrown by checkSign
+        are treated as verification failure.
+    */
+    virtual void verify (STTx::pointer tx, Callback callback) = 0;
+
+    /** Number of transactions queued but not yet checked. */
+    virtual int backlog () const = 0;
+};
+
+/** Create the verification pool.
+
+    @param threadCount Number of worker threads, or 0 to use one thread
+                       per available hardware core.
+*/
+std::unique_ptr <SignatureVerifier>
+make_SignatureVerifier (int threadCount, beast::Journal journal);
+
+} // ripple
+
+#endif
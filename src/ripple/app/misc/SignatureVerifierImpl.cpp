@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/SignatureVerifier.h>
+#include <ripple/basics/ThreadName.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class SignatureVerifierImp : public SignatureVerifier
+{
+private:
+    struct Entry
+    {
+        STTx::pointer tx;
+        Callback callback;
+    };
+
+    // Each worker drains up to this many entries per lock acquisition
+    // so a burst of submissions doesn't turn into a burst of wakeups.
+    static int const batchSize = 16;
+
+    beast::Journal m_journal;
+    std::mutex mutable m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque <Entry> m_work;
+    std::vector <std::thread> m_threads;
+    bool m_stop;
+
+public:
+    SignatureVerifierImp (int threadCount, beast::Journal journal)
+        : m_journal (journal)
+        , m_stop (false)
+    {
+        if (threadCount <= 0)
+            threadCount = std::max <int> (
+                1, std::thread::hardware_concurrency ());
+
+        m_journal.info << "Signature verification pool with " <<
+            threadCount << " threads";
+
+        for (int i = 0; i < threadCount; ++i)
+            m_threads.emplace_back (
+                &SignatureVerifierImp::run, this);
+    }
+
+    ~SignatureVerifierImp ()
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_all ();
+
+        for (auto& t : m_threads)
+            t.join ();
+    }
+
+    void verify (STTx::pointer tx, Callback callback) override
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            m_work.push_back (Entry { tx, callback });
+        }
+        m_wakeup.notify_one ();
+    }
+
+    int backlog () const override
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_work.size ();
+    }
+
+private:
+    void run ()
+    {
+        setCallingThreadName ("sigverify");
+
+        std::vector <Entry> batch;
+        batch.reserve (batchSize);
+
+        for (;;)
+        {
+            {
+                std::unique_lock <std::mutex> lock (m_mutex);
+
+                while (m_work.empty () && ! m_stop)
+                    m_wakeup.wait (lock);
+
+                if (m_stop && m_work.empty ())
+                    return;
+
+                while (! m_work.empty () &&
+                       batch.size () < batchSize)
+                {
+                    batch.push_back (std::move (m_work.front ()));
+                    m_work.pop_front ();
+                }
+            }
+
+            for (auto& entry : batch)
+            {
+                bool sigGood = false;
+
+                try
+                {
+                    sigGood = entry.tx->checkSign ();
+                }
+                catch (...)
+                {
+                    m_journal.warning << "Exception checking signature " <<
+                        entry.tx->getTransactionID ();
+                }
+
+                entry.callback (entry.tx, sigGood);
+            }
+
+            batch.clear ();
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr <SignatureVerifier>
+make_SignatureVerifier (int threadCount, beast::Journal journal)
+{
+    return std::make_unique <SignatureVerifierImp> (threadCount, journal);
+}
+
+} // ripple
@@ -21,11 +21,30 @@
 #include <ripple/basics/seconds_clock.h>
 #include <ripple/core/JobQueue.h>
 #include <beast/cxx14/memory.h> // <memory>
+#include <bitset>
+#include <deque>
 #include <mutex>
 #include <thread>
 
 namespace ripple {
 
+/** The validations we hold for one ledger, together with an agreement
+    bitset maintained as each validation arrives. Every entry in the set
+    was trusted and current when inserted, so the bitset's popcount gives
+    the trusted validation count without walking the map.
+*/
+struct LedgerValidations
+{
+    ValidationSet set;
+
+    // One bit per indexed trusted validator that validated this ledger
+    std::bitset <256> agreement;
+
+    // Set if a validator arrived after every bit index was taken,
+    // in which case the bitset undercounts and callers must walk
+    bool overflow = false;
+};
+
 class ValidationsImp : public Validations
 {
 private:
@@ -34,36 +53,83 @@ private:
     typedef beast::GenericScopedUnlock <LockType> ScopedUnlockType;
     std::mutex mutable mLock;
 
-    TaggedCache<uint256, ValidationSet> mValidations;
+    TaggedCache<uint256, LedgerValidations> mValidations;
     ValidationSet mCurrentValidations;
     ValidationVector mStaleValidations;
 
+    // Bit position assigned to each trusted validator on first sight
+    hash_map<NodeID, std::size_t> mValidatorIndex;
+
+    // Ring of the most recently seen ledgers, holding their validation
+    // sets alive so consensus-path reads for the recent window always
+    // hit memory instead of finding an expired cache entry
+    std::deque<std::pair<uint256, std::shared_ptr<LedgerValidations>>> mRecentWindow;
+
     bool mWriting;
+    std::uint32_t mLastPrune;
+
+    static std::size_t const maxTrackedValidators = 256;
+
+    // Number of recent ledgers whose validation sets stay pinned
+    static std::size_t const recentWindowSize = 128;
+
+    // Stale validations to accumulate before scheduling a write;
+    // sweep() pushes out anything that never fills a batch
+    static std::size_t const writeBatchSize = 256;
+
+    // Seconds between prunes of aged-out database rows
+    static std::uint32_t const pruneInterval = 3600;
 
 private:
-    std::shared_ptr<ValidationSet> findCreateSet (uint256 const& ledgerHash)
+    std::shared_ptr<LedgerValidations> findCreateSet (uint256 const& ledgerHash)
     {
         auto j = mValidations.fetch (ledgerHash);
 
         if (!j)
         {
-            j = std::make_shared<ValidationSet> ();
+            j = std::make_shared<LedgerValidations> ();
             mValidations.canonicalize (ledgerHash, j);
+
+            // Pin this ledger's set for the recent window; the cache
+            // keeps a weak reference, so our strong one is what allows
+            // later fetches to succeed after the cache entry expires
+            mRecentWindow.emplace_back (ledgerHash, j);
+
+            if (mRecentWindow.size () > recentWindowSize)
+                mRecentWindow.pop_front ();
         }
 
         return j;
     }
 
-    std::shared_ptr<ValidationSet> findSet (uint256 const& ledgerHash)
+    std::shared_ptr<LedgerValidations> findSet (uint256 const& ledgerHash)
     {
         return mValidations.fetch (ledgerHash);
     }
 
+    // Returns this validator's bit position, assigning one on first use
+    std::size_t validatorIndex (NodeID const& node)
+    {
+        auto it = mValidatorIndex.find (node);
+
+        if (it != mValidatorIndex.end ())
+            return it->second;
+
+        std::size_t const index = mValidatorIndex.size ();
+
+        if (index >= maxTrackedValidators)
+            return maxTrackedValidators;
+
+        mValidatorIndex.emplace (node, index);
+        return index;
+    }
+
 public:
     ValidationsImp ()
         : mValidations ("Validations", 128, 600, get_seconds_clock (),
             deprecatedLogs().journal("TaggedCache"))
         , mWriting (false)
+        , mLastPrune (0)
     {
         mStaleValidations.reserve (512);
     }
@@ -98,9 +164,18 @@ private:
         {
             ScopedLockType sl (mLock);
 
-            if (!findCreateSet (hash)->insert (std::make_pair (node, val)).second)
+            auto lv = findCreateSet (hash);
+
+            if (!lv->set.insert (std::make_pair (node, val)).second)
                 return false;
 
+            std::size_t const index = validatorIndex (node);
+
+            if (index < maxTrackedValidators)
+                lv->agreement.set (index);
+            else
+                lv->overflow = true;
+
             auto it = mCurrentValidations.find (node);
 
             if (it == mCurrentValidations.end ())
@@ -154,7 +229,7 @@ private:
             auto set = findSet (ledger);
 
             if (set)
-                return *set;
+                return set->set;
         }
         return ValidationSet ();
     }
@@ -168,7 +243,7 @@ private:
         if (set)
         {
             std::uint32_t now = getApp().getOPs ().getNetworkTimeNC ();
-            for (auto& it: *set)
+            for (auto& it: set->set)
             {
                 bool isTrusted = it.second->isTrusted ();
 
@@ -202,7 +277,7 @@ private:
 
         if (set)
         {
-            for (auto& it:*set)
+            for (auto& it: set->set)
             {
                 if (it.second->isTrusted ())
                 {
@@ -220,17 +295,23 @@ private:
 
     int getTrustedValidationCount (uint256 const& ledger)
     {
-        int trusted = 0;
         ScopedLockType sl (mLock);
         auto set = findSet (ledger);
 
-        if (set)
+        if (!set)
+            return 0;
+
+        // Every entry was trusted when inserted, so the agreement
+        // bitset's popcount answers this without walking the map
+        if (!set->overflow)
+            return static_cast<int> (set->agreement.count ());
+
+        int trusted = 0;
+
+        for (auto& it: set->set)
         {
-            for (auto& it: *set)
-            {
-                if (it.second->isTrusted ())
-                    ++trusted;
-            }
+            if (it.second->isTrusted ())
+                ++trusted;
         }
 
         return trusted;
@@ -244,7 +325,7 @@ private:
         auto const set = findSet (ledger);
         if (set)
         {
-            for (auto const& v : *set)
+            for (auto const& v : set->set)
             {
                 if (v.second->isTrusted())
                 {
@@ -393,8 +474,8 @@ private:
         }
         mCurrentValidations.clear ();
 
-        if (anyNew)
-            condWrite ();
+        if (anyNew || !mStaleValidations.empty ())
+            scheduleWrite ();
 
         while (mWriting)
         {
@@ -405,7 +486,17 @@ private:
         WriteLog (lsDEBUG, Validations) << "Validations flushed";
     }
 
+    // Schedules a write only once a full batch has accumulated, so the
+    // disk sees one transaction per batch instead of one per stale
+    // validation. Anything short of a batch goes out with the next
+    // sweep or flush.
     void condWrite ()
+    {
+        if (mStaleValidations.size () >= writeBatchSize)
+            scheduleWrite ();
+    }
+
+    void scheduleWrite ()
     {
         if (mWriting)
             return;
@@ -453,13 +544,49 @@ private:
             }
         }
 
+        pruneOld ();
+
         mWriting = false;
     }
 
+    // Deletes validations that have aged out of the configured ledger
+    // history so the table stays bounded. Requires the lock; runs at
+    // most once per pruneInterval, on the write job.
+    void pruneOld ()
+    {
+        std::uint32_t const now = getApp().getOPs ().getNetworkTimeNC ();
+
+        if (now < mLastPrune + pruneInterval)
+            return;
+
+        mLastPrune = now;
+
+        // Assume ledgers close no slower than the idle interval; an
+        // over-estimate only keeps validations a little longer
+        std::uint64_t const keep = std::uint64_t (
+            getConfig ().LEDGER_HISTORY) * LEDGER_IDLE_INTERVAL;
+
+        // A full-history or standalone configuration never prunes
+        if (keep == 0 || keep >= now)
+            return;
+
+        ScopedUnlockType sul (mLock);
+        auto db = getApp().getLedgerDB ().getDB ();
+        auto dbl (getApp().getLedgerDB ().lock ());
+
+        db->executeSQL (boost::str (boost::format (
+            "DELETE FROM Validations WHERE SignTime < %u;") %
+                (now - keep)));
+    }
+
     void sweep ()
     {
         ScopedLockType sl (mLock);
         mValidations.sweep ();
+
+        // Push out any stale validations that never filled a batch
+        if (!mStaleValidations.empty ())
+            scheduleWrite ();
     }
 };
 
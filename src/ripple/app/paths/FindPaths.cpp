@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/paths/FindPaths.h>
+#include <ripple/app/paths/PathFindCache.h>
 #include <ripple/app/paths/Pathfinder.h>
 
 namespace ripple {
@@ -36,7 +37,9 @@ public:
               dstAccount_ (dstAccount),
               dstAmount_ (dstAmount),
               searchLevel_ (searchLevel),
-              maxPaths_ (maxPaths)
+              maxPaths_ (maxPaths),
+              timeBudget_ (0),
+              suspended_ (false)
     {
     }
 
@@ -46,41 +49,94 @@ public:
         STPathSet& pathsInOut,
         STPath& fullLiquidityPath)
     {
+        suspended_ = false;
+
+        auto& cache = PathFindCache::instance ();
+        uint256 const key = PathFindCache::makeKey (
+            srcAccount_, dstAccount_, issue, dstAmount_,
+            searchLevel_, maxPaths_, pathsInOut);
+
+        if (cache.fetch (key, pathsInOut, fullLiquidityPath))
+            return true;
+
         if (auto& pathfinder = getPathFinder (issue.currency))
         {
+            if (!pathfinder->isComplete ())
+            {
+                // Out of this slice's budget; the search is
+                // checkpointed inside the pathfinder for next time.
+                suspended_ = true;
+                return false;
+            }
+
             pathsInOut = pathfinder->getBestPaths (
                 maxPaths_,  fullLiquidityPath, pathsInOut, issue.account);
+            cache.insert (key, srcAccount_, dstAccount_, issue,
+                pathsInOut, fullLiquidityPath);
             return true;
         }
-        assert (false);
         return false;
     }
 
+    void setTimeBudget (std::chrono::milliseconds budget)
+    {
+        timeBudget_ = budget;
+    }
+
+    void setInterrupt (std::function<bool ()> interrupt)
+    {
+        interrupt_ = std::move (interrupt);
+    }
+
+    bool suspended () const
+    {
+        return suspended_;
+    }
+
 private:
     hash_map<Currency, std::unique_ptr<Pathfinder>> currencyMap_;
 
-    RippleLineCache::ref cache_;
+    // Held by value: a suspended search can outlive the stack frame
+    // that created it.
+    RippleLineCache::pointer cache_;
     Account const srcAccount_;
     Account const dstAccount_;
     STAmount const dstAmount_;
     int const searchLevel_;
     unsigned int const maxPaths_;
 
+    std::chrono::milliseconds timeBudget_;
+    std::function<bool ()> interrupt_;
+    bool suspended_;
+
     std::unique_ptr<Pathfinder> const& getPathFinder (Currency const& currency)
     {
         auto i = currencyMap_.find (currency);
-        if (i != currencyMap_.end ())
+
+        if (i == currencyMap_.end ())
+        {
+            i = currencyMap_.emplace (currency,
+                std::make_unique<Pathfinder> (
+                    cache_, srcAccount_, dstAccount_,
+                    currency, dstAmount_)).first;
+        }
+        else if (!i->second || i->second->isComplete ())
+        {
+            // Already searched, or already proved to be a bad request.
             return i->second;
-        auto pathfinder = std::make_unique<Pathfinder> (
-            cache_, srcAccount_, dstAccount_, currency, dstAmount_);
-        if (pathfinder->findPaths (searchLevel_))
+        }
+        // Otherwise this is a checkpointed search being resumed.
+
+        auto& pathfinder = i->second;
+        pathfinder->setTimeSlice (timeBudget_);
+        pathfinder->setInterrupt (interrupt_);
+
+        if (!pathfinder->findPaths (searchLevel_))
+            pathfinder.reset ();  // Bad request or interrupted - clear it.
+        else if (pathfinder->isComplete ())
             pathfinder->computePathRanks (maxPaths_);
-        else
-            pathfinder.reset ();  // It's a bad request - clear it.
-        return currencyMap_[currency] = std::move (pathfinder);
 
-        // TODO(tom): why doesn't this faster way compile?
-        // return currencyMap_.insert (i, std::move (pathfinder)).second;
+        return pathfinder;
     }
 };
 
@@ -106,6 +162,21 @@ bool FindPaths::findPathsForIssue (
     return impl_->findPathsForIssue (issue, pathsInOut, fullLiquidityPath);
 }
 
+void FindPaths::setTimeBudget (std::chrono::milliseconds budget)
+{
+    impl_->setTimeBudget (budget);
+}
+
+void FindPaths::setInterrupt (std::function<bool ()> interrupt)
+{
+    impl_->setInterrupt (std::move (interrupt));
+}
+
+bool FindPaths::suspended () const
+{
+    return impl_->suspended ();
+}
+
 bool findPathsForOneIssuer (
     RippleLineCache::ref cache,
     Account const& srcAccount,
@@ -117,6 +188,14 @@ bool findPathsForOneIssuer (
     STPathSet& pathsInOut,
     STPath& fullLiquidityPath)
 {
+    auto& pathCache = PathFindCache::instance ();
+    uint256 const key = PathFindCache::makeKey (
+        srcAccount, dstAccount, srcIssue, dstAmount,
+        searchLevel, maxPaths, pathsInOut);
+
+    if (pathCache.fetch (key, pathsInOut, fullLiquidityPath))
+        return true;
+
     Pathfinder pf (
         cache,
         srcAccount,
@@ -130,6 +209,8 @@ bool findPathsForOneIssuer (
 
     pf.computePathRanks (maxPaths);
     pathsInOut = pf.getBestPaths(maxPaths, fullLiquidityPath, pathsInOut, srcIssue.account);
+    pathCache.insert (key, srcAccount, dstAccount, srcIssue,
+        pathsInOut, fullLiquidityPath);
     return true;
 }
 
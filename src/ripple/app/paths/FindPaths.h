@@ -20,6 +20,9 @@
 #ifndef RIPPLED_RIPPLE_APP_PATHS_FINDPATHS_H
 #define RIPPLED_RIPPLE_APP_PATHS_FINDPATHS_H
 
+#include <chrono>
+#include <functional>
+
 namespace ripple {
 
 class FindPaths
@@ -54,6 +57,20 @@ public:
             path that can move the entire liquidity requested. */
         STPath& fullLiquidityPath);
 
+    /** Limit how long each findPathsForIssue call may search.
+
+        When the budget expires mid-search the pathfinder checkpoints
+        its frontier, findPathsForIssue returns false and suspended()
+        reports true; a later call for the same issue resumes the
+        search.  A zero budget, the default, disables slicing. */
+    void setTimeBudget (std::chrono::milliseconds budget);
+
+    /** Stop any search as soon as the callback returns true. */
+    void setInterrupt (std::function<bool ()> interrupt);
+
+    /** Whether the last findPathsForIssue ran out of its time budget. */
+    bool suspended () const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -31,6 +31,10 @@ class NodeDirectory {
     // for the current order book.
     uint256 next;
 
+    // The quality decoded from the current directory, kept ready so
+    // consumers compare integers instead of re-deriving it per step.
+    std::uint64_t quality;
+
     // TODO(tom): directory.current and directory.next should be of type
     // Directory.
 
@@ -54,6 +58,7 @@ class NodeDirectory {
 
         current.copyFrom (getBookBase (book));
         next.copyFrom (getQualityNext (current));
+        quality = getQuality (current);
 
         // TODO(tom): it seems impossible that any actual offers with
         // quality == 0 could occur - we should disallow them, and clear
@@ -87,6 +92,7 @@ class NodeDirectory {
         if (current == zero)
             return END_ADVANCE;
 
+        quality = getQuality (current);
         ledgerEntry = les.entryCache (ltDIR_NODE, current);
         return NEW_QUALITY;
     }
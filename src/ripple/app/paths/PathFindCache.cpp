@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/PathFindCache.h>
+#include <ripple/protocol/Serializer.h>
+
+namespace ripple {
+
+PathFindCache& PathFindCache::instance ()
+{
+    static PathFindCache cache;
+    return cache;
+}
+
+uint256 PathFindCache::makeKey (
+    Account const& srcAccount,
+    Account const& dstAccount,
+    Issue const& issue,
+    STAmount const& dstAmount,
+    int searchLevel,
+    unsigned int maxPaths,
+    STPathSet const& pathsIn)
+{
+    Serializer s;
+    s.add160 (srcAccount);
+    s.add160 (dstAccount);
+    s.add160 (issue.currency);
+    s.add160 (issue.account);
+    dstAmount.add (s);
+    s.add32 (searchLevel);
+    s.add32 (maxPaths);
+    pathsIn.add (s);
+    return s.getSHA512Half ();
+}
+
+bool PathFindCache::fetch (uint256 const& key,
+    STPathSet& paths, STPath& fullLiquidityPath) const
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    auto const iter = m_entries.find (key);
+
+    if (iter == m_entries.end ())
+        return false;
+
+    paths = iter->second.paths;
+    fullLiquidityPath = iter->second.fullLiquidityPath;
+    return true;
+}
+
+void PathFindCache::insert (uint256 const& key,
+    Account const& srcAccount,
+    Account const& dstAccount,
+    Issue const& issue,
+    STPathSet const& paths,
+    STPath const& fullLiquidityPath)
+{
+    Entry entry;
+    entry.paths = paths;
+    entry.fullLiquidityPath = fullLiquidityPath;
+
+    // The result is stale once any account it rides is touched
+    entry.accounts.insert (srcAccount);
+    entry.accounts.insert (dstAccount);
+    if (! isXRP (issue.account))
+        entry.accounts.insert (issue.account);
+
+    for (auto const& path : paths)
+    {
+        for (auto const& element : path)
+        {
+            if (! isXRP (element.getAccountID ()))
+                entry.accounts.insert (element.getAccountID ());
+            if (! isXRP (element.getIssuerID ()))
+                entry.accounts.insert (element.getIssuerID ());
+        }
+    }
+
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    if (m_entries.size () >= maxEntries)
+        m_entries.clear ();
+
+    entry.generation = m_generation;
+    m_entries[key] = std::move (entry);
+}
+
+void PathFindCache::onLedgerAccepted (hash_set <Account> const& touched)
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    ++m_generation;
+
+    for (auto iter = m_entries.begin (); iter != m_entries.end ();)
+    {
+        bool stale =
+            (m_generation - iter->second.generation) > maxGenerations;
+
+        if (! stale)
+        {
+            for (auto const& account : iter->second.accounts)
+            {
+                if (touched.count (account) != 0)
+                {
+                    stale = true;
+                    break;
+                }
+            }
+        }
+
+        if (stale)
+            iter = m_entries.erase (iter);
+        else
+            ++iter;
+    }
+}
+
+} // ripple
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PATHFINDCACHE_H
+#define RIPPLE_PATHFINDCACHE_H
+
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STPathSet.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <mutex>
+
+namespace ripple {
+
+/** Cross-request cache of computed path sets.
+
+    Popular corridors get quoted over and over with identical
+    parameters; a full breadth-first search for each quote is wasted
+    work if nothing relevant changed. Results are keyed by a digest of
+    the complete query (source, destination, issue, amount, search
+    level, path limit, and any caller-supplied paths) and are dropped
+    when an accepted ledger touches an account involved in the result,
+    or after a few ledgers regardless — offer book changes do not
+    always show up as touches on path accounts.
+
+    Thread safe.
+*/
+class PathFindCache
+{
+private:
+    struct Entry
+    {
+        STPathSet paths;
+        STPath fullLiquidityPath;
+        hash_set <Account> accounts;
+        std::uint32_t generation;
+    };
+
+    // Entries this old (in accepted ledgers) are stale regardless
+    static std::uint32_t const maxGenerations = 6;
+
+    // Sweep everything rather than grow without bound
+    static std::size_t const maxEntries = 10000;
+
+    std::mutex mutable m_mutex;
+    hash_map <uint256, Entry> m_entries;
+    std::uint32_t m_generation;
+
+    PathFindCache ()
+        : m_generation (0)
+    {
+    }
+
+public:
+    static PathFindCache& instance ();
+
+    /** Compute the cache key for one complete path query. */
+    static uint256 makeKey (
+        Account const& srcAccount,
+        Account const& dstAccount,
+        Issue const& issue,
+        STAmount const& dstAmount,
+        int searchLevel,
+        unsigned int maxPaths,
+        STPathSet const& pathsIn);
+
+    /** Look up a previously computed result.
+        @return `true` if the result was found and copied out.
+    */
+    bool fetch (uint256 const& key,
+        STPathSet& paths, STPath& fullLiquidityPath) const;
+
+    /** Remember a computed result along with the accounts it rides. */
+    void insert (uint256 const& key,
+        Account const& srcAccount,
+        Account const& dstAccount,
+        Issue const& issue,
+        STPathSet const& paths,
+        STPath const& fullLiquidityPath);
+
+    /** Apply one accepted ledger's touched accounts.
+        Invalidates every entry involving a touched account and ages
+        out entries beyond the generation limit.
+    */
+    void onLedgerAccepted (hash_set <Account> const& touched);
+};
+
+} // ripple
+
+#endif
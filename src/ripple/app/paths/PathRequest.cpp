@@ -19,13 +19,16 @@
 
 #include <ripple/app/paths/AccountCurrencies.h>
 #include <ripple/app/paths/FindPaths.h>
+#include <ripple/app/paths/Tuning.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/LoadFeeTrack.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/Indexes.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/log/trivial.hpp>
+#include <chrono>
 #include <tuple>
 
 namespace ripple {
@@ -42,6 +45,7 @@ PathRequest::PathRequest (
         , bValid (false)
         , mLastIndex (0)
         , mInProgress (false)
+        , mWatchLedger (0)
         , iLastLevel (0)
         , bLastSuccess (false)
         , iIdentifier (id)
@@ -125,6 +129,25 @@ bool PathRequest::needsUpdate (bool newOnly, LedgerIndex index)
     return true;
 }
 
+bool PathRequest::isAffected (hash_set<uint256> const& changedNodes,
+    LedgerIndex firstCovered)
+{
+    ScopedLockType sl (mIndexLock);
+
+    // No dependency information, or the window of tracked
+    // modifications does not reach back to our last result
+    if ((mWatchLedger == 0) || (mWatchLedger < firstCovered))
+        return true;
+
+    for (auto const& node : mWatchedNodes)
+    {
+        if (changedNodes.count (node) != 0)
+            return true;
+    }
+
+    return false;
+}
+
 void PathRequest::updateComplete ()
 {
     ScopedLockType sl (mIndexLock);
@@ -133,6 +156,12 @@ void PathRequest::updateComplete ()
     mInProgress = false;
 }
 
+bool PathRequest::isSuspended ()
+{
+    ScopedLockType sl (mLock);
+    return mSuspended != nullptr;
+}
+
 bool PathRequest::isValid (RippleLineCache::ref crCache)
 {
     ScopedLockType sl (mLock);
@@ -367,7 +396,8 @@ void PathRequest::resetLevel (int l)
         iLastLevel = l;
 }
 
-Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
+Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast,
+    std::function<bool ()> const& shouldCancel)
 {
     m_journal.debug << iIdentifier << " update " << (fast ? "fast" : "normal");
 
@@ -377,25 +407,6 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
         return jvStatus;
     jvStatus = Json::objectValue;
 
-    auto sourceCurrencies = sciSourceCurrencies;
-
-    if (sourceCurrencies.empty ())
-    {
-        auto usCurrencies =
-                accountSourceCurrencies (raSrcAccount, cache, true);
-        bool sameAccount = raSrcAccount == raDstAccount;
-        for (auto const& c: usCurrencies)
-        {
-            if (!sameAccount || (c != saDstAmount.getCurrency ()))
-            {
-                if (c.isZero ())
-                    sourceCurrencies.insert ({c, xrpAccount()});
-                else
-                    sourceCurrencies.insert ({c, raSrcAccount.getAccountID ()});
-            }
-        }
-    }
-
     jvStatus["source_account"] = raSrcAccount.humanAccountID ();
     jvStatus["destination_account"] = raDstAccount.humanAccountID ();
     jvStatus["destination_amount"] = saDstAmount.getJson (0);
@@ -403,55 +414,161 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
     if (!jvId.isNull ())
         jvStatus["id"] = jvId;
 
-    Json::Value jvArray = Json::arrayValue;
-
-    int iLevel = iLastLevel;
-    bool loaded = getApp().getFeeTrack().isLoadedLocal();
-
-    if (iLevel == 0)
-    {
-        // first pass
-        if (loaded || fast)
-            iLevel = getConfig().PATH_SEARCH_FAST;
-        else
-            iLevel = getConfig().PATH_SEARCH;
-    }
-    else if ((iLevel == getConfig().PATH_SEARCH_FAST) && !fast)
+    // The working state of this update: either fresh, or checkpointed
+    // from a previous pass that ran out of its time slice.
+    std::set<Issue> sourceCurrencies;
+    std::unique_ptr<FindPaths> fp;
+    RippleLineCache::pointer searchCache;
+    Json::Value jvArray;
+    hash_set<uint256> watchedNodes;
+    int iLevel;
+    bool found;
+
+    if (mSuspended)
     {
-        // leaving fast pathfinding
-        iLevel = getConfig().PATH_SEARCH;
-        if (loaded && (iLevel > getConfig().PATH_SEARCH_FAST))
-            --iLevel;
-    }
-    else if (bLastSuccess)
-    {
-        // decrement, if possible
-        if (iLevel > getConfig().PATH_SEARCH ||
-            (loaded && (iLevel > getConfig().PATH_SEARCH_FAST)))
-            --iLevel;
+        // Resume against the snapshot the search started on, so the
+        // alternatives already computed stay consistent with the new
+        // ones.
+        sourceCurrencies = std::move (mSuspended->issues);
+        fp = std::move (mSuspended->search);
+        searchCache = mSuspended->cache;
+        jvArray = mSuspended->alternatives;
+        watchedNodes = std::move (mSuspended->watchedNodes);
+        iLevel = mSuspended->level;
+        found = mSuspended->found;
+        mSuspended.reset ();
     }
     else
     {
-        // adjust as needed
-        if (!loaded && (iLevel < getConfig().PATH_SEARCH_MAX))
-            ++iLevel;
-        if (loaded && (iLevel > getConfig().PATH_SEARCH_FAST))
-            --iLevel;
+        sourceCurrencies = sciSourceCurrencies;
+
+        if (sourceCurrencies.empty ())
+        {
+            auto usCurrencies =
+                    accountSourceCurrencies (raSrcAccount, cache, true);
+            bool sameAccount = raSrcAccount == raDstAccount;
+            for (auto const& c: usCurrencies)
+            {
+                if (!sameAccount || (c != saDstAmount.getCurrency ()))
+                {
+                    if (c.isZero ())
+                        sourceCurrencies.insert ({c, xrpAccount()});
+                    else
+                        sourceCurrencies.insert (
+                            {c, raSrcAccount.getAccountID ()});
+                }
+            }
+        }
+
+        searchCache = cache;
+        jvArray = Json::arrayValue;
+        found = false;
+
+        // The ledger nodes this result will depend on, starting with
+        // the endpoint accounts themselves
+        watchedNodes.insert (getAccountRootIndex (raSrcAccount));
+        watchedNodes.insert (getAccountRootIndex (raDstAccount));
+
+        iLevel = iLastLevel;
+        bool loaded = getApp().getFeeTrack().isLoadedLocal();
+
+        if (iLevel == 0)
+        {
+            // first pass
+            if (loaded || fast)
+                iLevel = getConfig().PATH_SEARCH_FAST;
+            else
+                iLevel = getConfig().PATH_SEARCH;
+        }
+        else if ((iLevel == getConfig().PATH_SEARCH_FAST) && !fast)
+        {
+            // leaving fast pathfinding
+            iLevel = getConfig().PATH_SEARCH;
+            if (loaded && (iLevel > getConfig().PATH_SEARCH_FAST))
+                --iLevel;
+        }
+        else if (bLastSuccess)
+        {
+            // decrement, if possible
+            if (iLevel > getConfig().PATH_SEARCH ||
+                (loaded && (iLevel > getConfig().PATH_SEARCH_FAST)))
+                --iLevel;
+        }
+        else
+        {
+            // adjust as needed
+            if (!loaded && (iLevel < getConfig().PATH_SEARCH_MAX))
+                ++iLevel;
+            if (loaded && (iLevel > getConfig().PATH_SEARCH_FAST))
+                --iLevel;
+        }
+
+        fp = std::make_unique<FindPaths> (
+            searchCache,
+            raSrcAccount.getAccountID (),
+            raDstAccount.getAccountID (),
+            saDstAmount,
+            iLevel,
+            4);  // iMaxPaths
     }
 
     m_journal.debug << iIdentifier << " processing at level " << iLevel;
 
-    bool found = false;
+    // A search whose client has vanished is abandoned mid-frontier;
+    // nobody will read the result.
+    fp->setInterrupt ([this, shouldCancel] () {
+        return wpSubscriber.expired () ||
+            (shouldCancel && shouldCancel ());
+    });
+
+    // Full updates run on a shared job thread: search for at most one
+    // time slice per pass so concurrent requests interleave.
+    auto const sliceEnd = std::chrono::steady_clock::now () +
+        std::chrono::milliseconds (PATHFINDER_SLICE_MILLISECONDS);
 
-    FindPaths fp (
-        cache,
-        raSrcAccount.getAccountID (),
-        raDstAccount.getAccountID (),
-        saDstAmount,
-        iLevel,
-        4);  // iMaxPaths
-    for (auto const& currIssuer: sourceCurrencies)
+    // Checkpoint everything needed to resume from this currency on.
+    auto checkpoint = [&] (std::set<Issue>::iterator issueIter)
     {
+        mSuspended = std::make_unique<SuspendedUpdate> ();
+        mSuspended->search = std::move (fp);
+        mSuspended->cache = searchCache;
+        mSuspended->issues.insert (issueIter, sourceCurrencies.end ());
+        mSuspended->alternatives = jvArray;
+        mSuspended->watchedNodes = std::move (watchedNodes);
+        mSuspended->level = iLevel;
+        mSuspended->found = found;
+    };
+
+    for (auto issueIter = sourceCurrencies.begin ();
+        issueIter != sourceCurrencies.end (); ++issueIter)
+    {
+        Issue const& currIssuer = *issueIter;
+
+        if (wpSubscriber.expired () || (shouldCancel && shouldCancel ()))
+        {
+            // The client is gone or we are shutting down
+            m_journal.debug << iIdentifier << " abandoned";
+            return jvStatus;
+        }
+
+        if (!fast)
+        {
+            auto const now = std::chrono::steady_clock::now ();
+
+            if (now >= sliceEnd)
+            {
+                checkpoint (issueIter);
+                break;
+            }
+
+            // Whatever remains of the slice bounds this search.
+            auto msLeft = std::chrono::duration_cast<
+                std::chrono::milliseconds> (sliceEnd - now);
+            if (msLeft.count () == 0)
+                msLeft = std::chrono::milliseconds (1);
+            fp->setTimeBudget (msLeft);
+        }
+
         {
             STAmount test (currIssuer, 1);
             if (m_journal.debug)
@@ -463,16 +580,25 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
         }
         STPathSet& spsPaths = mContext[currIssuer];
         STPath fullLiquidityPath;
-        auto valid = fp.findPathsForIssue (
+        auto valid = fp->findPathsForIssue (
             currIssuer,
             spsPaths,
             fullLiquidityPath);
+
+        if (!valid && fp->suspended ())
+        {
+            // Out of time mid-search; the frontier is checkpointed
+            // inside the pathfinder.
+            checkpoint (issueIter);
+            break;
+        }
+
         CondLog (!valid, lsDEBUG, PathRequest)
                 << iIdentifier << " PF request not valid";
 
         if (valid)
         {
-            LedgerEntrySet lesSandbox (cache->getLedger (), tapNONE);
+            LedgerEntrySet lesSandbox (searchCache->getLedger (), tapNONE);
             auto& sourceAccount = !isXRP (currIssuer.account)
                     ? currIssuer.account
                     : isXRP (currIssuer.currency)
@@ -483,13 +609,20 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
             saMaxAmount.negate ();
             m_journal.debug << iIdentifier
                             << " Paths found, calling rippleCalc";
+
+            // If the first calculation falls short and we retry with a
+            // covering path, the paths already expanded are reused.
+            path::RippleCalc::PathStateTable expandedPaths;
+
             auto rc = path::RippleCalc::rippleCalculate (
                 lesSandbox,
                 saMaxAmount,
                 saDstAmount,
                 raDstAccount.getAccountID (),
                 raSrcAccount.getAccountID (),
-                spsPaths);
+                spsPaths,
+                nullptr,
+                &expandedPaths);
 
             if (!fullLiquidityPath.empty() &&
                 (rc.result () == terNO_LINE || rc.result () == tecPATH_PARTIAL))
@@ -504,7 +637,9 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
                     saDstAmount,
                     raDstAccount.getAccountID (),
                     raSrcAccount.getAccountID (),
-                    spsPaths);
+                    spsPaths,
+                    nullptr,
+                    &expandedPaths);
                 if (rc.result () != tesSUCCESS)
                     m_journal.warning
                         << iIdentifier << " Failed with covering path "
@@ -515,6 +650,10 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
                         << transHuman (rc.result ());
             }
 
+            // Everything the calculation touched is a dependency
+            for (auto const& les : lesSandbox)
+                watchedNodes.insert (les.first);
+
             if (rc.result () == tesSUCCESS)
             {
                 Json::Value jvEntry (Json::objectValue);
@@ -537,9 +676,37 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
         }
     }
 
+    if (mSuspended)
+    {
+        // Don't report anything yet; updateAll keeps us queued and a
+        // later pass picks up from the checkpoint.
+        m_journal.debug << iIdentifier << " suspended, " <<
+            mSuspended->issues.size () << " currencies left";
+        return jvStatus;
+    }
+
     iLastLevel = iLevel;
     bLastSuccess = found;
 
+    {
+        // Remember what this result depended on, so updateAll can skip
+        // us when an accepted ledger touches none of it. A request
+        // that found nothing keeps retrying on every ledger: new
+        // liquidity can come from nodes we never visited.
+        ScopedLockType ml (mIndexLock);
+
+        if (found)
+        {
+            mWatchedNodes.swap (watchedNodes);
+            mWatchLedger = searchCache->getLedger ()->getLedgerSeq ();
+        }
+        else
+        {
+            mWatchedNodes.clear ();
+            mWatchLedger = 0;
+        }
+    }
+
     if (fast && ptQuickReply.is_not_a_date_time())
     {
         ptQuickReply = boost::posix_time::microsec_clock::universal_time();
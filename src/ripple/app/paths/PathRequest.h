@@ -21,6 +21,7 @@
 #define RIPPLE_PATHREQUEST_H
 
 #include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/json/json_value.h>
 
 namespace ripple {
@@ -28,6 +29,7 @@ namespace ripple {
 // A pathfinding request submitted by a client
 // The request issuer must maintain a strong pointer
 
+class FindPaths;
 class RippleLineCache;
 class PathRequests;
 
@@ -61,7 +63,25 @@ public:
     bool        isValid ();
     bool        isNew ();
     bool        needsUpdate (bool newOnly, LedgerIndex index);
+
+    /** Whether a set of modified ledger nodes can affect our result.
+        @param changedNodes nodes modified by every accepted ledger
+                            after firstCovered.
+        @param firstCovered the sequence of the ledger just before the
+                            window of tracked modifications.
+        @return `false` only if the last result is known to still stand.
+    */
+    bool        isAffected (hash_set<uint256> const& changedNodes,
+                            LedgerIndex firstCovered);
+
     void        updateComplete ();
+
+    /** Whether the last update ran out of its time slice.
+        A suspended request stays queued and a later pass resumes the
+        checkpointed search instead of starting over.
+    */
+    bool        isSuspended ();
+
     Json::Value getStatus ();
 
     Json::Value doCreate (
@@ -73,7 +93,8 @@ public:
     Json::Value doStatus (Json::Value const&);
 
     // update jvStatus
-    Json::Value doUpdate (const std::shared_ptr<RippleLineCache>&, bool fast);
+    Json::Value doUpdate (const std::shared_ptr<RippleLineCache>&, bool fast,
+        std::function<bool ()> const& shouldCancel = std::function<bool ()> ());
     InfoSub::pointer getSubscriber ();
 
 private:
@@ -103,12 +124,32 @@ private:
     std::set<Issue> sciSourceCurrencies;
     std::map<Issue, STPathSet> mContext;
 
+    // State of a full update that ran out of its time slice,
+    // checkpointed so a later pass resumes it instead of starting over.
+    struct SuspendedUpdate
+    {
+        std::unique_ptr<FindPaths> search;  // checkpointed pathfinders
+        RippleLineCache::pointer cache;     // snapshot the search runs on
+        std::set<Issue> issues;             // source currencies left to try
+        Json::Value alternatives;           // results already computed
+        hash_set<uint256> watchedNodes;     // dependencies seen so far
+        int level;
+        bool found;
+    };
+    std::unique_ptr<SuspendedUpdate> mSuspended;
+
     bool bValid;
 
     LockType mIndexLock;
     LedgerIndex mLastIndex;
     bool mInProgress;
 
+    // The ledger nodes the last successful result depended on, and the
+    // ledger it was computed against. Zero means no dependency
+    // information; the request is then updated on every pass.
+    hash_set<uint256> mWatchedNodes;
+    LedgerIndex mWatchLedger;
+
     int iLastLevel;
     bool bLastSuccess;
 
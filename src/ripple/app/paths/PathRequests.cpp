@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/resource/Fees.h>
@@ -39,8 +40,22 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
          (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
          (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
     {
+        // If the delta window covers every ledger since the old cache,
+        // carry forward the accounts whose lines cannot have changed
+        // so only touched accounts get rescanned
+        bool const haveDelta =
+            mLineCache && ledger->isClosed () && (lgrSeq > lineSeq) &&
+            updateLedgerDelta (ledger) && (mDeltaFirst <= lineSeq);
+
+        RippleLineCache::pointer previous = mLineCache;
+
         ledger = std::make_shared<Ledger>(*ledger, false); // Take a snapshot of the ledger
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+
+        if (haveDelta)
+            mLineCache = std::make_shared<RippleLineCache> (
+                ledger, *previous, mDeltaNodes);
+        else
+            mLineCache = std::make_shared<RippleLineCache> (ledger);
     }
     else
     {
@@ -49,6 +64,45 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
     return mLineCache;
 }
 
+bool PathRequests::updateLedgerDelta (Ledger::ref ledger)
+{
+    LedgerIndex const seq = ledger->getLedgerSeq ();
+
+    if ((mDeltaFirst != 0) && (seq == mDeltaLast))
+    {
+        // Already merged (another pass over the same ledger)
+        return true;
+    }
+
+    if ((mDeltaFirst == 0) || (seq != (mDeltaLast + 1)) ||
+            ((seq - mDeltaFirst) > deltaMaxLedgers))
+    {
+        // Start a fresh window covering just this ledger
+        mDeltaNodes.clear ();
+        mDeltaFirst = seq - 1;
+    }
+
+    AcceptedLedger::pointer alLedger =
+        AcceptedLedger::makeAcceptedLedger (ledger);
+
+    for (auto const& alTx : alLedger->getMap ())
+    {
+        for (auto& node : alTx.second->getMeta ()->getNodes ())
+            mDeltaNodes.insert (node.getFieldH256 (sfLedgerIndex));
+    }
+
+    if (mDeltaNodes.size () > deltaMaxNodes)
+    {
+        // Too much history to be worth filtering against
+        mDeltaNodes.clear ();
+        mDeltaFirst = 0;
+        return false;
+    }
+
+    mDeltaLast = seq;
+    return true;
+}
+
 void PathRequests::updateAll (Ledger::ref inLedger,
                               Job::CancelCallback shouldCancel)
 {
@@ -65,15 +119,37 @@ void PathRequests::updateAll (Ledger::ref inLedger,
         cache = getLineCache (ledger, true);
     }
 
+    // The nodes modified since shortly before each request's last
+    // update. When the window is valid, requests whose last result
+    // depended on none of them are skipped entirely.
+    hash_set<uint256> changedNodes;
+    LedgerIndex firstCovered = 0;
+    bool haveDelta = false;
+
+    if (inLedger->isClosed ())
+    {
+        ScopedLockType sl (mLock);
+
+        if (updateLedgerDelta (inLedger))
+        {
+            changedNodes = mDeltaNodes;
+            firstCovered = mDeltaFirst;
+            haveDelta = true;
+        }
+    }
+
     bool newRequests = getApp().getLedgerMaster().isNewPathRequest();
     bool mustBreak = false;
 
     mJournal.trace << "updateAll seq=" << ledger->getLedgerSeq() << ", " <<
         requests.size() << " requests";
-    int processed = 0, removed = 0;
+    int processed = 0, skipped = 0, removed = 0, suspended = 0;
+    bool resumePending = false;
 
     do
     {
+        resumePending = false;
+
         BOOST_FOREACH (PathRequest::wref wRequest, requests)
         {
             if (shouldCancel())
@@ -84,7 +160,14 @@ void PathRequests::updateAll (Ledger::ref inLedger,
 
             if (pRequest)
             {
-                if (!pRequest->needsUpdate (newRequests, ledger->getLedgerSeq ()))
+                if (haveDelta && !pRequest->isSuspended () &&
+                    !pRequest->isAffected (changedNodes, firstCovered))
+                {
+                    // Nothing the last result depended on has changed
+                    remove = false;
+                    ++skipped;
+                }
+                else if (!pRequest->needsUpdate (newRequests, ledger->getLedgerSeq ()))
                     remove = false;
                 else
                 {
@@ -94,12 +177,31 @@ void PathRequests::updateAll (Ledger::ref inLedger,
                         ipSub->getConsumer ().charge (Resource::feePathFindUpdate);
                         if (!ipSub->getConsumer ().warn ())
                         {
-                            Json::Value update = pRequest->doUpdate (cache, false);
+                            // Release our reference during the search
+                            // so a client disconnect can interrupt it
+                            // mid-frontier
+                            ipSub.reset ();
+
+                            Json::Value update =
+                                pRequest->doUpdate (cache, false, shouldCancel);
                             pRequest->updateComplete ();
-                            update["type"] = "path_find";
-                            ipSub->send (update, false);
-                            remove = false;
-                            ++processed;
+
+                            if (pRequest->isSuspended ())
+                            {
+                                // Ran out of its time slice; stay
+                                // queued so a later pass resumes the
+                                // checkpointed search
+                                remove = false;
+                                resumePending = true;
+                                ++suspended;
+                            }
+                            else if ((ipSub = pRequest->getSubscriber ()))
+                            {
+                                update["type"] = "path_find";
+                                ipSub->send (update, false);
+                                remove = false;
+                                ++processed;
+                            }
                         }
                     }
                 }
@@ -143,8 +245,8 @@ void PathRequests::updateAll (Ledger::ref inLedger,
         else
         { // check if there are any new requests, otherwise we are done
             newRequests = getApp().getLedgerMaster().isNewPathRequest();
-            if (!newRequests) // We did a full pass and there are no new requests
-                return;
+            if (!newRequests && !resumePending)
+                return; // We did a full pass, nothing new, nothing suspended
         }
 
         {
@@ -161,7 +263,8 @@ void PathRequests::updateAll (Ledger::ref inLedger,
     }
     while (!shouldCancel ());
 
-    mJournal.debug << "updateAll complete " << processed << " process and " <<
+    mJournal.debug << "updateAll complete " << processed << " processed, " <<
+        skipped << " skipped, " << suspended << " suspended slices and " <<
         removed << " removed";
 }
 
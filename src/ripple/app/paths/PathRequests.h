@@ -33,6 +33,8 @@ public:
     PathRequests (beast::Journal journal, beast::insight::Collector::ptr const& collector)
         : mJournal (journal)
         , mLastIdentifier (0)
+        , mDeltaFirst (0)
+        , mDeltaLast (0)
     {
         mFast = collector->make_event ("pathfind_fast");
         mFull = collector->make_event ("pathfind_full");
@@ -60,6 +62,13 @@ public:
     }
 
 private:
+    /** Merge an accepted ledger's modified nodes into the delta window.
+        Must be called with mLock held.
+        @return `true` if the window now covers every ledger after
+                mDeltaFirst.
+    */
+    bool updateLedgerDelta (Ledger::ref ledger);
+
     beast::Journal                   mJournal;
 
     beast::insight::Event            mFast;
@@ -71,6 +80,19 @@ private:
     // Use a RippleLineCache
     RippleLineCache::pointer         mLineCache;
 
+    // Nodes modified by a run of consecutive accepted ledgers
+    // (mDeltaFirst, mDeltaLast], consulted to skip requests whose last
+    // result depended on none of them. Bounded so the window resets
+    // rather than growing without limit.
+    enum
+    {
+        deltaMaxLedgers = 32,
+        deltaMaxNodes   = 65536
+    };
+    hash_set<uint256>                mDeltaNodes;
+    LedgerIndex                      mDeltaFirst;
+    LedgerIndex                      mDeltaLast;
+
     std::atomic<int>                 mLastIdentifier;
 
     typedef RippleRecursiveMutex     LockType;
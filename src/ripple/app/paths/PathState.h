@@ -43,6 +43,21 @@ class PathState : public CountedObject <PathState>
 
     explicit PathState (const PathState& psSrc) = default;
 
+    /** Construct from an already-expanded path, rebinding the requested
+        amounts. The expanded nodes and status carry over; all
+        per-increment state starts fresh.
+    */
+    PathState (PathState const& psExpanded,
+               STAmount const& saSend, STAmount const& saSendMax)
+        : terStatus (psExpanded.terStatus)
+        , nodes_ (psExpanded.nodes_)
+        , mIndex (0)
+        , uQuality (0)
+        , saInReq (saSendMax)
+        , saOutReq (saSend)
+    {
+    }
+
     void reset(STAmount const& in, STAmount const& out);
 
     TER expandPath (
@@ -174,7 +174,12 @@ Pathfinder::Pathfinder (
         mSrcIssuer (uSrcIssuer),
         mSrcAmount ({uSrcCurrency, uSrcIssuer}, 1u, 0, true),
         mLedger (cache->getLedger ()),
-        mRLCache (cache)
+        mRLCache (cache),
+        mTimeBudget (0),
+        mStopped (false),
+        mInterrupted (false),
+        mComplete (false),
+        mFrontierOffset (0)
 {
     assert (isXRP(uSrcCurrency) == isXRP(uSrcIssuer));
 }
@@ -195,7 +200,12 @@ Pathfinder::Pathfinder (
             isXRP (uSrcCurrency) ? xrpAccount () : uSrcAccount
         }, 1u, 0, true),
         mLedger (cache->getLedger ()),
-        mRLCache (cache)
+        mRLCache (cache),
+        mTimeBudget (0),
+        mStopped (false),
+        mInterrupted (false),
+        mComplete (false),
+        mFrontierOffset (0)
 {
 }
 
@@ -203,6 +213,35 @@ Pathfinder::~Pathfinder()
 {
 }
 
+void Pathfinder::setTimeSlice (std::chrono::milliseconds budget)
+{
+    mTimeBudget = budget;
+}
+
+void Pathfinder::setInterrupt (std::function<bool ()> interrupt)
+{
+    mInterrupt = std::move (interrupt);
+}
+
+bool Pathfinder::outOfTime ()
+{
+    if (mStopped)
+        return true;
+
+    if (mInterrupt && mInterrupt ())
+    {
+        mInterrupted = true;
+        mStopped = true;
+    }
+    else if ((mTimeBudget.count () != 0) &&
+        (std::chrono::steady_clock::now () >= mSliceDeadline))
+    {
+        mStopped = true;
+    }
+
+    return mStopped;
+}
+
 bool Pathfinder::findPaths (int searchLevel)
 {
     if (mDstAmount == zero)
@@ -315,7 +354,13 @@ bool Pathfinder::findPaths (int searchLevel)
         paymentType = pt_nonXRP_to_nonXRP;
     }
 
-    // Now iterate over all paths for that paymentType.
+    // Start (or resume) a time slice.
+    mStopped = false;
+    if (mTimeBudget.count () != 0)
+        mSliceDeadline = std::chrono::steady_clock::now () + mTimeBudget;
+
+    // Now iterate over all paths for that paymentType.  Types already
+    // built by an earlier slice are served from mPaths.
     for (auto const& costedPath : mPathTable[paymentType])
     {
         // Only use paths with at most the current search level.
@@ -323,6 +368,9 @@ bool Pathfinder::findPaths (int searchLevel)
         {
             addPathsForType (costedPath.type);
 
+            if (mStopped)
+                break;
+
             // TODO(tom): we might be missing other good paths with this
             // arbitrary cut off.
             if (mCompletePaths.size () > PATHFINDER_MAX_COMPLETE_PATHS)
@@ -330,6 +378,26 @@ bool Pathfinder::findPaths (int searchLevel)
         }
     }
 
+    if (mInterrupted)
+    {
+        // Whoever was waiting for this search is gone.
+        WriteLog (lsDEBUG, Pathfinder) << "findPaths interrupted";
+        return false;
+    }
+
+    if (mStopped)
+    {
+        // Out of budget.  The frontier is checkpointed; the next call
+        // picks up where this slice stopped.
+        WriteLog (lsDEBUG, Pathfinder)
+                << "findPaths: slice expired in '"
+                << pathTypeToString (mIncompleteType) << "'";
+        mComplete = false;
+        return true;
+    }
+
+    mComplete = true;
+
     WriteLog (lsDEBUG, Pathfinder)
             << mCompletePaths.size () << " complete paths found";
 
@@ -363,7 +431,8 @@ TER Pathfinder::getPathLiquidity (
             mDstAccount,
             mSrcAccount,
             pathSet,
-            &rcInput);
+            &rcInput,
+            &mExpandedPaths);
 
         // If we can't get even the minimum liquidity requested, we're done.
         if (rc.result () != tesSUCCESS)
@@ -381,7 +450,8 @@ TER Pathfinder::getPathLiquidity (
             mDstAccount,
             mSrcAccount,
             pathSet,
-            &rcInput);
+            &rcInput,
+            &mExpandedPaths);
 
         // If we found further liquidity, add it into the result.
         if (rc.result () == tesSUCCESS)
@@ -427,7 +497,8 @@ void Pathfinder::computePathRanks (int maxPaths)
             mDstAccount,
             mSrcAccount,
             STPathSet(),
-            &rcInput);
+            &rcInput,
+            &mExpandedPaths);
 
         if (rc.result () == tesSUCCESS)
         {
@@ -739,15 +810,27 @@ void Pathfinder::addLinks (
     WriteLog (lsDEBUG, Pathfinder)
         << "addLink< on " << currentPaths.size ()
         << " source(s), flags=" << addFlags;
-    for (auto const& path: currentPaths)
-        addLink (path, incompletePaths, addFlags);
+    for (std::size_t i = mFrontierOffset; i < currentPaths.size (); ++i)
+    {
+        if (outOfTime ())
+        {
+            // Checkpoint the frontier so a resumed search picks up
+            // exactly where this slice stopped.
+            mFrontierOffset = i;
+            return;
+        }
+
+        addLink (currentPaths[i], incompletePaths, addFlags);
+    }
 }
 
 STPathSet& Pathfinder::addPathsForType (PathType const& pathType)
 {
-    // See if the set of paths for this type already exists.
+    // See if the set of paths for this type already exists.  A type cut
+    // short by an expired time slice is not complete; it falls through
+    // to be resumed.
     auto it = mPaths.find (pathType);
-    if (it != mPaths.end ())
+    if (it != mPaths.end () && pathType != mIncompleteType)
         return it->second;
 
     // Otherwise, if the type has no nodes, return the empty path.
@@ -760,6 +843,15 @@ STPathSet& Pathfinder::addPathsForType (PathType const& pathType)
     parentPathType.pop_back ();
 
     STPathSet const& parentPaths = addPathsForType (parentPathType);
+
+    if (mStopped)
+    {
+        // The slice expired while (re)building the parent.  Don't
+        // start extending a partial frontier; the next slice finishes
+        // the parent first and comes back here.
+        return mPaths[parentPathType];
+    }
+
     STPathSet& pathsOut = mPaths[pathType];
 
     WriteLog (lsDEBUG, Pathfinder)
@@ -769,6 +861,13 @@ STPathSet& Pathfinder::addPathsForType (PathType const& pathType)
 
     int initialSize = mCompletePaths.size ();
 
+    // Resume from the checkpointed frontier when this is the type that
+    // ran out of time, otherwise start from the first parent path.
+    if (pathType == mIncompleteType)
+        mIncompleteType.clear ();
+    else
+        mFrontierOffset = 0;
+
     // Add the last NodeType to the lists.
     auto nodeType = pathType.back ();
     switch (nodeType)
@@ -803,6 +902,13 @@ STPathSet& Pathfinder::addPathsForType (PathType const& pathType)
         break;
     }
 
+    if (mStopped)
+    {
+        // Checkpoint: pathsOut only covers the parent paths up to
+        // mFrontierOffset, so it must not be served as complete.
+        mIncompleteType = pathType;
+    }
+
     CondLog (mCompletePaths.size () != initialSize, lsDEBUG, Pathfinder)
         << (mCompletePaths.size () - initialSize)
         << " complete paths added";
@@ -20,6 +20,9 @@
 #ifndef RIPPLE_PATHFINDER_H
 #define RIPPLE_PATHFINDER_H
 
+#include <chrono>
+#include <functional>
+
 namespace ripple {
 
 /** Calculates payment paths.
@@ -54,6 +57,26 @@ public:
 
     bool findPaths (int searchLevel);
 
+    /** Limit how long a single findPaths call may run.
+
+        A search that exhausts its budget checkpoints the frontier it
+        was expanding and returns normally; calling findPaths again
+        resumes from the checkpoint.  A zero budget, the default,
+        disables slicing.
+    */
+    void setTimeSlice (std::chrono::milliseconds budget);
+
+    /** Stop searching as soon as the callback returns true.
+        An interrupted search is abandoned, not checkpointed.
+    */
+    void setInterrupt (std::function<bool ()> interrupt);
+
+    /** Whether the search has covered every path type for its level. */
+    bool isComplete () const
+    {
+        return mComplete;
+    }
+
     /** Compute the rankings of the paths. */
     void computePathRanks (int maxPaths);
 
@@ -168,6 +191,10 @@ private:
         STPathSet const& paths,
         std::vector <PathRank>& rankedPaths);
 
+    // Whether this slice of the search should stop, either because the
+    // time budget expired or the interrupt callback fired.
+    bool outOfTime ();
+
     Account mSrcAccount;
     Account mDstAccount;
     STAmount mDstAmount;
@@ -189,6 +216,23 @@ private:
 
     hash_map<Issue, int> mPathsOutCountMap;
 
+    // Time-slice bookkeeping.  When a budget is set and expires, the
+    // search records which path type it was extending and how far
+    // through the parent frontier it had gotten, then unwinds.
+    std::chrono::milliseconds mTimeBudget;
+    std::chrono::steady_clock::time_point mSliceDeadline;
+    std::function<bool ()> mInterrupt;
+    bool mStopped;                // The current slice is over
+    bool mInterrupted;            // The interrupt callback fired
+    bool mComplete;               // Every path type has been covered
+    PathType mIncompleteType;     // The type in progress when time ran out
+    std::size_t mFrontierOffset;  // Parent paths already extended
+
+    // Paths already expanded while checking liquidity.  All checks run
+    // against fresh sandboxes over the same ledger snapshot with the
+    // same endpoints, so the expansions stay valid for this pathfinder.
+    mutable path::RippleCalc::PathStateTable mExpandedPaths;
+
     // Add ripple paths
     static std::uint32_t const afADD_ACCOUNTS = 0x001;
 
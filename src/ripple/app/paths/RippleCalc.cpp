@@ -19,6 +19,7 @@
 
 #include <ripple/app/paths/RippleCalc.h>
 #include <ripple/app/paths/cursor/PathCursor.h>
+#include <ripple/basics/LatencyProbes.h>
 
 namespace ripple {
 namespace path {
@@ -36,6 +37,24 @@ TER deleteOffers (
     return tesSUCCESS;
 }
 
+// Key an expanded path by its elements.  The implied source and
+// destination nodes are fixed per table, so the elements alone
+// identify the expansion.
+uint256 expandedPathKey (STPath const& path)
+{
+    Serializer s;
+
+    for (auto const& element: path)
+    {
+        s.add8 (element.getNodeType ());
+        s.add160 (element.getAccountID ());
+        s.add160 (element.getCurrency ());
+        s.add160 (element.getIssuerID ());
+    }
+
+    return s.getSHA512Half ();
+}
+
 } // namespace
 
 RippleCalc::Output RippleCalc::rippleCalculate (
@@ -62,8 +81,13 @@ RippleCalc::Output RippleCalc::rippleCalculate (
     // A set of paths that are included in the transaction that we'll
     // explore for liquidity.
     STPathSet const& spsPaths,
-    Input const* const pInputs)
+    Input const* const pInputs,
+    PathStateTable* const pExpandedPaths)
 {
+    static std::size_t const probeIndex (
+        LatencyProbes::getInstance ().probe ("ripplecalc"));
+    ScopedLatencyProbe probe (probeIndex);
+
     RippleCalc rc (
         activeLedger,
         saMaxAmountReq,
@@ -71,6 +95,7 @@ RippleCalc::Output RippleCalc::rippleCalculate (
         uDstAccountID,
         uSrcAccountID,
         spsPaths);
+    rc.expandedPaths_ = pExpandedPaths;
     if (pInputs != nullptr)
     {
         rc.inputFlags = *pInputs;
@@ -88,26 +113,49 @@ RippleCalc::Output RippleCalc::rippleCalculate (
 
 bool RippleCalc::addPathState(STPath const& path, TER& resultCode)
 {
-    auto pathState = std::make_shared<PathState> (
-        saDstAmountReq_, saMaxAmountReq_);
+    PathState::Ptr pathState;
 
-    if (!pathState)
+    if (expandedPaths_)
     {
-        resultCode = temUNKNOWN;
-        return false;
+        auto it = expandedPaths_->find (expandedPathKey (path));
+
+        if (it != expandedPaths_->end ())
+            pathState = std::make_shared<PathState> (
+                *it->second, saDstAmountReq_, saMaxAmountReq_);
     }
 
-    pathState->expandPath (
-        mActiveLedger,
-        path,
-        uDstAccountID_,
-        uSrcAccountID_);
+    if (!pathState)
+    {
+        pathState = std::make_shared<PathState> (
+            saDstAmountReq_, saMaxAmountReq_);
+
+        if (!pathState)
+        {
+            resultCode = temUNKNOWN;
+            return false;
+        }
 
-    if (pathState->status() == tesSUCCESS)
-        pathState->checkNoRipple (uDstAccountID_, uSrcAccountID_);
+        pathState->expandPath (
+            mActiveLedger,
+            path,
+            uDstAccountID_,
+            uSrcAccountID_);
 
-    if (pathState->status() == tesSUCCESS && mActiveLedger.enforceFreeze ())
-        pathState->checkFreeze ();
+        if (pathState->status() == tesSUCCESS)
+            pathState->checkNoRipple (uDstAccountID_, uSrcAccountID_);
+
+        if (pathState->status() == tesSUCCESS && mActiveLedger.enforceFreeze ())
+            pathState->checkFreeze ();
+
+        if (expandedPaths_ && pathState->status() == tesSUCCESS)
+        {
+            // Save a pristine copy, before any increment runs over it.
+            // The copy's requested amount references are never read;
+            // reuse goes through the rebinding constructor.
+            (*expandedPaths_)[expandedPathKey (path)] =
+                std::make_shared<PathState> (*pathState);
+        }
+    }
 
     pathState->setIndex (pathStateList_.size ());
 
@@ -31,6 +31,15 @@ namespace path {
 class RippleCalc
 {
 public:
+    /** Expanded path states, keyed by path.
+
+        A caller making several calculations over the same ledger
+        snapshot with the same endpoints and issues can pass the same
+        table to each call, and paths already expanded are reused
+        instead of being rebuilt from the ledger.
+    */
+    typedef hash_map <uint256, PathState::Ptr> PathStateTable;
+
     struct Input
     {
         bool partialPaymentAllowed = false;
@@ -91,7 +100,11 @@ public:
         // A set of paths that are included in the transaction that we'll
         // explore for liquidity.
         STPathSet const& spsPaths,
-        Input const* const pInputs = nullptr);
+        Input const* const pInputs = nullptr,
+
+        // Table of expanded paths to reuse and add to.  Only valid
+        // while the expansion-relevant ledger entries are unchanged.
+        PathStateTable* const pExpandedPaths = nullptr);
 
     /** The active ledger. */
     LedgerEntrySet& mActiveLedger;
@@ -149,6 +162,9 @@ private:
     // and goes through other acounts or order books.
     PathState::List pathStateList_;
 
+    // Expanded paths shared across calculations, or nullptr.
+    PathStateTable* expandedPaths_ = nullptr;
+
     Input inputFlags;
 };
 
@@ -24,6 +24,81 @@ RippleLineCache::RippleLineCache (Ledger::ref l)
 {
 }
 
+// Whether any page of the account's owner directory is in the delta.
+// A line extended to the account only adds an entry to one of those
+// pages: trustCreate charges the owner count to the creating side, so
+// neither the account root nor any previously scanned line changes.
+// Page numbers can be sparse, but probing a number with no page is
+// just a wasted hash, so scan up to the old last-page number; a chain
+// too long to probe cheaply simply loses the carry-forward.
+static bool ownerDirChanged (Ledger::ref ledger, Account const& account,
+    hash_set<uint256> const& changedNodes)
+{
+    std::uint64_t const uScanLimit = 256;
+
+    uint256 const uRootIndex = getOwnerDirIndex (account);
+
+    if (changedNodes.count (uRootIndex) != 0)
+        return true;
+
+    SLE::pointer sleRoot = ledger->getSLEi (uRootIndex);
+
+    if (!sleRoot)
+    {
+        // No directory in the old ledger; creating one in the new
+        // ledger puts the root index in the delta, handled above.
+        return false;
+    }
+
+    std::uint64_t const uNodeLast = sleRoot->getFieldU64 (sfIndexPrevious);
+
+    if (uNodeLast > uScanLimit)
+        return true;
+
+    for (std::uint64_t uNode = 1; uNode <= uNodeLast; ++uNode)
+    {
+        if (changedNodes.count (getDirNodeIndex (uRootIndex, uNode)) != 0)
+            return true;
+    }
+
+    return false;
+}
+
+RippleLineCache::RippleLineCache (Ledger::ref l,
+    RippleLineCache& previous, hash_set<uint256> const& changedNodes)
+    : mLedger (l)
+{
+    // An account's lines are unchanged if its account root, its owner
+    // directory, and each line it was scanned as holding are all
+    // absent from the delta; only then can it keep its scanned vector.
+    ScopedLockType sl (previous.mLock);
+
+    for (auto const& entry : previous.mRLMap)
+    {
+        if (changedNodes.count (
+                getAccountRootIndex (entry.first.account_)) != 0)
+            continue;
+
+        if (ownerDirChanged (previous.mLedger, entry.first.account_,
+                changedNodes))
+            continue;
+
+        bool stale = false;
+
+        for (auto const& line : entry.second)
+        {
+            if (changedNodes.count (line->peekSLE ().getIndex ()) != 0)
+            {
+                stale = true;
+                break;
+            }
+        }
+
+        if (!stale)
+            mRLMap.insert (entry);
+    }
+}
+
 RippleLineCache::RippleStateVector const&
 RippleLineCache::getRippleLines (Account const& accountID)
 {
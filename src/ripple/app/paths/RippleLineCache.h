@@ -21,13 +21,17 @@
 #define RIPPLE_RIPPLELINECACHE_H
 
 #include <ripple/app/paths/RippleState.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <cstddef>
 #include <memory>
 #include <vector>
 
 namespace ripple {
 
-// Used by Pathfinder
+// Used by Pathfinder. Scans are lazy and cached per account; when the
+// ledger advances, PathRequests carries unchanged accounts' scans into
+// the new cache and falls back to a cold rebuild when it cannot prove
+// which accounts changed.
 class RippleLineCache
 {
 public:
@@ -37,6 +41,14 @@ public:
 
     explicit RippleLineCache (Ledger::ref l);
 
+    /** Build a cache for a newer ledger from its predecessor.
+        Accounts none of whose nodes appear in `changedNodes` (the
+        ledger entries modified between the two ledgers) carry their
+        line vectors forward instead of being rescanned.
+    */
+    RippleLineCache (Ledger::ref l, RippleLineCache& previous,
+        hash_set<uint256> const& changedNodes);
+
     Ledger::ref getLedger () // VFALCO TODO const?
     {
         return mLedger;
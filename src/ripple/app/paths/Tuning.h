@@ -29,6 +29,10 @@ int const PATHFINDER_MAX_PATHS = 50;
 int const PATHFINDER_MAX_COMPLETE_PATHS = 1000;
 int const PATHFINDER_MAX_PATHS_FROM_SOURCE = 10;
 
+// How long one jtPATH_FIND pass may search a single request before
+// checkpointing its frontier so other requests get a turn.
+int const PATHFINDER_SLICE_MILLISECONDS = 100;
+
 } // ripple
 
 #endif
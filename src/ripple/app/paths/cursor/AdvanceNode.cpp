@@ -104,7 +104,7 @@ TER PathCursor::advanceNode (bool const bReverse) const
             // Our quality changed since last iteration.
             // Use the rate from the directory.
             node().saOfrRate = amountFromQuality (
-                getQuality (node().directory.current));
+                node().directory.quality);
             // For correct ratio
             node().uEntry = 0;
             node().bEntryAdvance   = true;
@@ -0,0 +1,615 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/app/transactors/Transactor.h>
+#include <ripple/basics/seconds_clock.h>
+#include <ripple/protocol/RippleAddress.h>
+#include <ripple/protocol/STParsedJSON.h>
+#include <ripple/protocol/TxFlags.h>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace ripple {
+
+/** Benchmark driver for the path engine.
+
+    Builds an in-memory ledger with gateways, trust lines and order
+    books, synthesizes a deterministic corpus of path-heavy cross
+    currency payments over it, and replays the corpus through the
+    engine one phase at a time:
+
+        find     Pathfinder, via findPathsForOneIssuer
+        expand   rippleCalculate against a fresh sandbox, expanding
+                 every path from the ledger
+        assess   the same calculation with the expanded path states
+                 reused, isolating the liquidity pass
+        apply    the complete signed payment through the
+                 TransactionEngine on a scratch open ledger
+
+    reporting latency percentiles per phase, so path engine changes
+    land with before/after numbers. Build with `scons bench` and run
+    manually:
+
+        rippled --unittest=PathsBenchmark
+            --unittest-arg="accounts=20,payments=200"
+
+    Accepts a semicolon delimited list of configurations, each a comma
+    delimited list of key=value pairs:
+
+        accounts    user accounts holding issued currency (default 20)
+        currencies  currencies, one gateway each       (default 4)
+        makers      market maker accounts              (default 4)
+        depth       offers per order book              (default 8)
+        payments    payments in the corpus             (default 200)
+        level       pathfinder search level            (default 7)
+
+    Each currency has books to its neighbor currency and to XRP, so
+    most payments only connect through multi-step paths. Every payment
+    applies to its own scratch ledger, so the corpus replays against
+    one unchanging ledger state.
+*/
+class PathsBenchmark_test : public beast::unit_test::suite
+{
+public:
+    using TestAccount = std::pair<RippleAddress, unsigned>;
+    using bench_clock = std::chrono::steady_clock;
+
+    //--------------------------------------------------------------------------
+    //
+    // Fixture helpers, modeled on Ledger_test
+    //
+
+    STTx
+    parseTransaction (TestAccount& account, Json::Value const& tx_json)
+    {
+        STParsedJSONObject parsed ("tx_json", tx_json);
+        std::unique_ptr<STObject> sopTrans = std::move (parsed.object);
+        expect (sopTrans != nullptr);
+        sopTrans->setFieldVL (sfSigningPubKey,
+            account.first.getAccountPublic ());
+        return STTx (*sopTrans);
+    }
+
+    void
+    applyTransaction (Ledger::pointer const& ledger, STTx const& tx)
+    {
+        TransactionEngine engine (ledger);
+        bool didApply = false;
+        auto r = engine.applyTransaction (tx,
+            tapOPEN_LEDGER | tapNO_CHECK_SIGN, didApply);
+        expect (r == tesSUCCESS);
+        expect (didApply);
+    }
+
+    Ledger::pointer
+    createGenesisLedger (std::uint64_t start_amount_drops,
+        TestAccount const& master)
+    {
+        Ledger::pointer ledger = std::make_shared<Ledger> (master.first,
+            start_amount_drops);
+        ledger->updateHash ();
+        ledger->setClosed ();
+        expect (ledger->assertSane ());
+        return ledger;
+    }
+
+    TestAccount
+    createAccount ()
+    {
+        static RippleAddress const seed
+                = RippleAddress::createSeedGeneric ("masterpassphrase");
+        static RippleAddress const generator
+                = RippleAddress::createGeneratorPublic (seed);
+        static int iSeq = -1;
+        ++iSeq;
+        return std::make_pair (
+            RippleAddress::createAccountPublic (generator, iSeq),
+            std::uint64_t (0));
+    }
+
+    Json::Value
+    getAmountJson (double value, std::string const& currency,
+        TestAccount const& issuer)
+    {
+        Json::Value amount;
+        amount["currency"] = currency;
+        amount["issuer"] = issuer.first.humanAccountID ();
+        amount["value"] = std::to_string (value);
+        return amount;
+    }
+
+    void
+    makePayment (TestAccount& from, TestAccount const& to,
+        std::uint64_t amountDrops, Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["Account"] = from.first.humanAccountID ();
+        tx_json["Amount"] = std::to_string (amountDrops);
+        tx_json["Destination"] = to.first.humanAccountID ();
+        tx_json["TransactionType"] = "Payment";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Sequence"] = ++from.second;
+        tx_json["Flags"] = tfUniversal;
+        STTx tx = parseTransaction (from, tx_json);
+        applyTransaction (ledger, tx);
+    }
+
+    void
+    makePayment (TestAccount& from, TestAccount const& to,
+        std::string const& currency, double value,
+        TestAccount const& issuer, Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["Account"] = from.first.humanAccountID ();
+        tx_json["Amount"] = getAmountJson (value, currency, issuer);
+        tx_json["Destination"] = to.first.humanAccountID ();
+        tx_json["TransactionType"] = "Payment";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Sequence"] = ++from.second;
+        tx_json["Flags"] = tfUniversal;
+        STTx tx = parseTransaction (from, tx_json);
+        applyTransaction (ledger, tx);
+    }
+
+    void
+    makeTrustSet (TestAccount& from, TestAccount const& issuer,
+        std::string const& currency, double amount,
+        Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["Account"] = from.first.humanAccountID ();
+        Json::Value& limitAmount = tx_json["LimitAmount"];
+        limitAmount["currency"] = currency;
+        limitAmount["issuer"] = issuer.first.humanAccountID ();
+        limitAmount["value"] = std::to_string (amount);
+        tx_json["TransactionType"] = "TrustSet";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Sequence"] = ++from.second;
+        tx_json["Flags"] = tfClearNoRipple;
+        STTx tx = parseTransaction (from, tx_json);
+        applyTransaction (ledger, tx);
+    }
+
+    void
+    createOffer (TestAccount& from, Json::Value const& takerPays,
+        Json::Value const& takerGets, Ledger::pointer const& ledger)
+    {
+        Json::Value tx_json;
+        tx_json["TransactionType"] = "OfferCreate";
+        tx_json["Fee"] = std::to_string (10);
+        tx_json["Account"] = from.first.humanAccountID ();
+        tx_json["TakerPays"] = takerPays;
+        tx_json["TakerGets"] = takerGets;
+        tx_json["Sequence"] = ++from.second;
+        STTx tx = parseTransaction (from, tx_json);
+        applyTransaction (ledger, tx);
+    }
+
+    Ledger::pointer
+    close_and_advance (Ledger::pointer ledger, Ledger::pointer LCL)
+    {
+        SHAMap::pointer set = ledger->peekTransactionMap ();
+        CanonicalTXSet retriableTransactions (set->getHash ());
+        Ledger::pointer newLCL = std::make_shared<Ledger> (false, *LCL);
+        applyTransactions (set, newLCL, newLCL, retriableTransactions, false);
+        newLCL->updateSkipList ();
+        newLCL->setClosed ();
+        newLCL->peekAccountStateMap ()->flushDirty (hotACCOUNT_NODE,
+            newLCL->getLedgerSeq ());
+        newLCL->peekTransactionMap ()->flushDirty (hotTRANSACTION_NODE,
+            newLCL->getLedgerSeq ());
+        using namespace std::chrono;
+        auto const epoch_offset = days (10957);  // 2000-01-01
+        std::uint32_t closeTime = time_point_cast<seconds>
+            (system_clock::now () - epoch_offset).time_since_epoch ().count ();
+        int CloseResolution = seconds (LEDGER_TIME_ACCURACY).count ();
+        newLCL->setAccepted (closeTime, CloseResolution, true);
+        return newLCL;
+    }
+
+    //--------------------------------------------------------------------------
+
+    static std::uint64_t percentile (
+        std::vector<std::uint64_t> const& sorted, double p)
+    {
+        if (sorted.empty ())
+            return 0;
+        return sorted[static_cast<std::size_t> (
+            p * (sorted.size () - 1) + 0.5)];
+    }
+
+    void report (std::string const& label, std::vector<std::uint64_t>& v,
+        double elapsed, char const* unit)
+    {
+        if (v.empty ())
+            return;
+
+        std::sort (v.begin (), v.end ());
+
+        std::stringstream out;
+        out << std::setw (8) << label << ":"
+            << " n=" << v.size ()
+            << " ops/s=" << std::uint64_t (v.size () / elapsed)
+            << " p50=" << percentile (v, 0.50) << unit
+            << " p90=" << percentile (v, 0.90) << unit
+            << " p99=" << percentile (v, 0.99) << unit
+            << " p99.9=" << percentile (v, 0.999) << unit
+            << " max=" << v.back () << unit;
+        log << out.str ();
+    }
+
+    static std::uint64_t sinceUs (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds> (
+            bench_clock::now () - t0).count ();
+    }
+
+    static double sinceSeconds (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<
+            std::chrono::duration<double>> (
+                bench_clock::now () - t0).count ();
+    }
+
+    static std::string currencyCode (int i)
+    {
+        return std::string (3, static_cast<char> ('A' + (i % 26)));
+    }
+
+    //--------------------------------------------------------------------------
+
+    void benchmark (std::string const& name, int numAccounts,
+        int numCurrencies, int numMakers, int depth, int numPayments,
+        int searchLevel)
+    {
+        testcase (name);
+
+        std::uint64_t const xrp = std::mega::num;
+
+        // One gateway per currency; each user account holds the
+        // currency matching its index and trusts its neighbor's, so
+        // most payments cross at least one order book.
+        auto master = createAccount ();
+        Ledger::pointer LCL = createGenesisLedger (10000000 * xrp, master);
+        Ledger::pointer ledger = std::make_shared<Ledger> (false, *LCL);
+
+        std::vector<TestAccount> gateways;
+        std::vector<TestAccount> makers;
+        std::vector<TestAccount> accounts;
+
+        for (int i = 0; i < numCurrencies; ++i)
+        {
+            gateways.push_back (createAccount ());
+            makePayment (master, gateways.back (), 10000 * xrp, ledger);
+        }
+
+        for (int i = 0; i < numMakers; ++i)
+        {
+            makers.push_back (createAccount ());
+            makePayment (master, makers.back (), 10000 * xrp, ledger);
+        }
+
+        for (int i = 0; i < numAccounts; ++i)
+        {
+            accounts.push_back (createAccount ());
+            makePayment (master, accounts.back (), 1000 * xrp, ledger);
+        }
+
+        LCL = close_and_advance (ledger, LCL);
+        ledger = std::make_shared<Ledger> (false, *LCL);
+
+        // Market makers hold every currency; user accounts hold their
+        // own currency and trust their neighbor's.
+        for (auto& maker : makers)
+        {
+            for (int i = 0; i < numCurrencies; ++i)
+            {
+                makeTrustSet (maker, gateways[i], currencyCode (i),
+                    1000000000, ledger);
+                makePayment (gateways[i], maker, currencyCode (i),
+                    100000, gateways[i], ledger);
+            }
+        }
+
+        for (int k = 0; k < numAccounts; ++k)
+        {
+            int const i = k % numCurrencies;
+            int const j = (k + 1) % numCurrencies;
+
+            makeTrustSet (accounts[k], gateways[i], currencyCode (i),
+                1000000000, ledger);
+            if (j != i)
+                makeTrustSet (accounts[k], gateways[j], currencyCode (j),
+                    1000000000, ledger);
+            makePayment (gateways[i], accounts[k], currencyCode (i),
+                1000, gateways[i], ledger);
+        }
+
+        LCL = close_and_advance (ledger, LCL);
+        ledger = std::make_shared<Ledger> (false, *LCL);
+
+        // Books between each currency and its neighbor, and between
+        // each currency and XRP, several offers deep with worsening
+        // quality. Makers take the books round-robin.
+        std::size_t nextMaker = 0;
+
+        for (int i = 0; i < numCurrencies; ++i)
+        {
+            int const j = (i + 1) % numCurrencies;
+
+            for (int d = 0; d < depth; ++d)
+            {
+                double const pays = 50 + 5 * d;
+                auto& maker = makers[nextMaker++ % makers.size ()];
+
+                if (j != i)
+                {
+                    createOffer (maker,
+                        getAmountJson (pays, currencyCode (i), gateways[i]),
+                        getAmountJson (50, currencyCode (j), gateways[j]),
+                        ledger);
+                    createOffer (maker,
+                        getAmountJson (pays, currencyCode (j), gateways[j]),
+                        getAmountJson (50, currencyCode (i), gateways[i]),
+                        ledger);
+                }
+
+                Json::Value native = std::to_string (
+                    std::uint64_t (50 * xrp));
+                createOffer (maker,
+                    getAmountJson (pays, currencyCode (i), gateways[i]),
+                    native, ledger);
+                createOffer (maker,
+                    std::to_string (std::uint64_t (pays * xrp)),
+                    getAmountJson (50, currencyCode (i), gateways[i]),
+                    ledger);
+            }
+        }
+
+        LCL = close_and_advance (ledger, LCL);
+
+        // The order book directory is normally fed by ledger close;
+        // point it at the fixture so the pathfinder sees the books.
+        getApp ().getOrderBookDB ().setup (LCL);
+
+        //----------------------------------------------------------------------
+        //
+        // Synthesize the payment corpus, timing the pathfinder as we go.
+        //
+
+        struct CorpusEntry
+        {
+            Account src;
+            Account dst;
+            STAmount sendMax;
+            STAmount amount;
+            STPathSet paths;
+        };
+
+        std::mt19937_64 rng (7);
+        std::vector<CorpusEntry> corpus;
+        std::vector<STTx> txs;
+        std::vector<std::uint64_t> lat;
+        int pathsFound = 0;
+
+        auto cache = std::make_shared<RippleLineCache> (LCL);
+        auto started = bench_clock::now ();
+
+        for (int n = 0; n < numPayments; ++n)
+        {
+            std::size_t const a = rng () % accounts.size ();
+            std::size_t b = rng () % accounts.size ();
+            while (b == a)
+                b = (b + 1) % accounts.size ();
+
+            int const i = a % numCurrencies;
+            int const j = b % numCurrencies;
+
+            CorpusEntry entry;
+            entry.src = accounts[a].first.getAccountID ();
+            entry.dst = accounts[b].first.getAccountID ();
+
+            double const value = 1 + int (rng () % 5);
+            entry.amount = STAmount (
+                Issue (to_currency (currencyCode (j)),
+                    gateways[j].first.getAccountID ()),
+                std::int64_t (value), 0);
+            entry.sendMax = STAmount (
+                Issue (to_currency (currencyCode (i)),
+                    gateways[i].first.getAccountID ()),
+                std::int64_t (value * 4), 0);
+
+            STPath fullLiquidityPath;
+
+            auto const t0 = bench_clock::now ();
+            findPathsForOneIssuer (cache, entry.src, entry.dst,
+                Issue (to_currency (currencyCode (i)),
+                    gateways[i].first.getAccountID ()),
+                entry.amount, searchLevel, 4, entry.paths,
+                fullLiquidityPath);
+            lat.push_back (sinceUs (t0));
+
+            if (!entry.paths.empty ())
+                ++pathsFound;
+
+            Json::Value tx_json;
+            tx_json["Account"] = accounts[a].first.humanAccountID ();
+            tx_json["Amount"] = getAmountJson (value, currencyCode (j),
+                gateways[j]);
+            tx_json["SendMax"] = getAmountJson (value * 4, currencyCode (i),
+                gateways[i]);
+            tx_json["Destination"] = accounts[b].first.humanAccountID ();
+            tx_json["TransactionType"] = "Payment";
+            tx_json["Fee"] = std::to_string (10);
+            tx_json["Sequence"] = accounts[a].second + 1;
+            tx_json["Flags"] = tfUniversal | tfPartialPayment;
+
+            STTx tx = parseTransaction (accounts[a], tx_json);
+            if (!entry.paths.empty ())
+                tx.setFieldPathSet (sfPaths, entry.paths);
+
+            corpus.push_back (entry);
+            txs.push_back (tx);
+        }
+
+        report ("find", lat, sinceSeconds (started), "us");
+
+        std::stringstream out;
+        out << "  corpus: payments=" << numPayments
+            << " with_paths=" << pathsFound;
+        log << out.str ();
+
+        //----------------------------------------------------------------------
+        //
+        // Expansion, then assessment with the expansion reused.
+        //
+
+        std::vector<std::uint64_t> assessLat;
+        int calcSuccess = 0;
+        lat.clear ();
+        started = bench_clock::now ();
+
+        for (auto const& entry : corpus)
+        {
+            path::RippleCalc::Input rcInput;
+            rcInput.partialPaymentAllowed = true;
+
+            path::RippleCalc::PathStateTable expanded;
+
+            {
+                LedgerEntrySet sandbox (LCL, tapNONE);
+
+                auto const t0 = bench_clock::now ();
+                auto rc = path::RippleCalc::rippleCalculate (sandbox,
+                    entry.sendMax, entry.amount, entry.dst, entry.src,
+                    entry.paths, &rcInput, &expanded);
+                lat.push_back (sinceUs (t0));
+
+                if (rc.result () == tesSUCCESS)
+                    ++calcSuccess;
+            }
+
+            {
+                LedgerEntrySet sandbox (LCL, tapNONE);
+
+                auto const t0 = bench_clock::now ();
+                path::RippleCalc::rippleCalculate (sandbox,
+                    entry.sendMax, entry.amount, entry.dst, entry.src,
+                    entry.paths, &rcInput, &expanded);
+                assessLat.push_back (sinceUs (t0));
+            }
+        }
+
+        double const calcElapsed = sinceSeconds (started);
+        expect (calcSuccess > 0, "no payment found liquidity");
+        report ("expand", lat, calcElapsed, "us");
+        report ("assess", assessLat, calcElapsed, "us");
+
+        //----------------------------------------------------------------------
+        //
+        // Full application, each payment on its own scratch ledger.
+        //
+
+        int applied = 0;
+        lat.clear ();
+        started = bench_clock::now ();
+
+        for (auto const& tx : txs)
+        {
+            Ledger::pointer scratch = std::make_shared<Ledger> (false, *LCL);
+            TransactionEngine engine (scratch);
+            bool didApply = false;
+
+            auto const t0 = bench_clock::now ();
+            auto const r = engine.applyTransaction (tx,
+                tapOPEN_LEDGER | tapNO_CHECK_SIGN, didApply);
+            lat.push_back (sinceUs (t0));
+
+            if (r == tesSUCCESS)
+                ++applied;
+        }
+
+        expect (applied > 0, "no payment applied");
+        report ("apply", lat, sinceSeconds (started), "us");
+
+        out.str ("");
+        out << "  results: calc_success=" << calcSuccess
+            << " applied=" << applied;
+        log << out.str ();
+    }
+
+    void run ()
+    {
+        // Unit tests skip Application::setup, which normally builds
+        // the pathfinder's type table.
+        initializePathfinding ();
+
+        auto args = arg ();
+
+        if (args.empty ())
+            args = "accounts=20";
+
+        std::vector<std::string> configs;
+        boost::split (configs, args, boost::algorithm::is_any_of (";"));
+
+        for (auto& config : configs)
+        {
+            auto params = parseDelimitedKeyValueString (config, ',');
+
+            int accounts = 20;
+            int currencies = 4;
+            int makers = 4;
+            int depth = 8;
+            int payments = 200;
+            int level = 7;
+
+            if (!params["accounts"].isEmpty ())
+                accounts = std::max (2, params["accounts"].getIntValue ());
+
+            if (!params["currencies"].isEmpty ())
+                currencies = std::min (26,
+                    std::max (1, params["currencies"].getIntValue ()));
+
+            if (!params["makers"].isEmpty ())
+                makers = std::max (1, params["makers"].getIntValue ());
+
+            if (!params["depth"].isEmpty ())
+                depth = std::max (1, params["depth"].getIntValue ());
+
+            if (!params["payments"].isEmpty ())
+                payments = std::max (1, params["payments"].getIntValue ());
+
+            if (!params["level"].isEmpty ())
+                level = std::max (1, params["level"].getIntValue ());
+
+            benchmark (config, accounts, currencies, makers, depth,
+                payments, level);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(PathsBenchmark,bench,ripple);
+
+} // ripple
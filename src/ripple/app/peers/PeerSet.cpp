@@ -18,7 +18,6 @@
 //==============================================================================
 
 #include <ripple/overlay/Overlay.h>
-#include <beast/asio/placeholders.h>
 
 namespace ripple {
 
@@ -43,7 +42,6 @@ PeerSet::PeerSet (uint256 const& hash, int interval, bool txnData,
     , mAggressive (false)
     , mTxnData (txnData)
     , mProgress (false)
-    , mTimer (getApp().getIOService ())
 {
     mLastAction = m_clock.now();
     assert ((mTimerInterval > 10) && (mTimerInterval < 30000));
@@ -72,8 +70,8 @@ void PeerSet::badPeer (Peer::ptr const& ptr)
 
 void PeerSet::setTimer ()
 {
-    mTimer.expires_from_now (boost::posix_time::milliseconds (mTimerInterval));
-    mTimer.async_wait (std::bind (&PeerSet::TimerEntry, pmDowncast (), beast::asio::placeholders::error));
+    getApp().getTimerWheel ().schedule (mTimer, mTimerInterval,
+        std::bind (&PeerSet::TimerEntry, pmDowncast ()));
 }
 
 void PeerSet::invokeOnTimer ()
@@ -99,11 +97,8 @@ void PeerSet::invokeOnTimer ()
         setTimer ();
 }
 
-void PeerSet::TimerEntry (std::weak_ptr<PeerSet> wptr, const boost::system::error_code& result)
+void PeerSet::TimerEntry (std::weak_ptr<PeerSet> wptr)
 {
-    if (result == boost::asio::error::operation_aborted)
-        return;
-
     std::shared_ptr<PeerSet> ptr = wptr.lock ();
 
     if (ptr)
@@ -20,8 +20,8 @@
 #ifndef RIPPLE_PEERSET_H
 #define RIPPLE_PEERSET_H
 
+#include <ripple/core/TimerWheel.h>
 #include <ripple/overlay/Peer.h>
-#include <boost/asio/deadline_timer.hpp>
 
 namespace ripple {
 
@@ -104,7 +104,7 @@ public:
     }
 
 private:
-    static void TimerEntry (std::weak_ptr<PeerSet>, const boost::system::error_code& result);
+    static void TimerEntry (std::weak_ptr<PeerSet>);
     static void TimerJobEntry (Job&, std::shared_ptr<PeerSet>);
 
 protected:
@@ -150,8 +150,8 @@ protected:
     bool mProgress;
 
 
-    // VFALCO TODO move the responsibility for the timer to a higher level
-    boost::asio::deadline_timer             mTimer;
+    // All peer sets share the application's timer wheel
+    TimerWheel::Timer mTimer;
 
     // VFALCO TODO Verify that these are used in the way that the names suggest.
     typedef Peer::id_t PeerIdentifier;
@@ -17,7 +17,16 @@
 */
 //==============================================================================
 
+#include <beast/unit_test/suite.h>
+#include <beast/chrono/manual_clock.h>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <random>
+#include <sstream>
 
 namespace ripple {
 namespace RadixMap {
@@ -45,5 +54,283 @@ void add_random_items (std::size_t n, Table& t, beast::Random& r)
     }
 }
 
+//------------------------------------------------------------------------------
+
+uint256 item_tag (std::uint64_t key)
+{
+    std::mt19937_64 rng (key + 1);
+
+    uint256 tag;
+    std::generate_n (reinterpret_cast<std::uint64_t*> (tag.begin ()),
+        tag.size () / sizeof (std::uint64_t), rng);
+    return tag;
+}
+
+std::shared_ptr <Item> make_item (
+    std::uint64_t key, std::uint32_t generation)
+{
+    std::mt19937_64 rng (key + 1);
+
+    uint256 tag;
+    std::generate_n (reinterpret_cast<std::uint64_t*> (tag.begin ()),
+        tag.size () / sizeof (std::uint64_t), rng);
+
+    rng.seed (rng () + generation);
+
+    std::size_t const size = 128 + (rng () % 65) * 8;   // 128..640
+
+    Blob data (size);
+    std::generate_n (reinterpret_cast<std::uint64_t*> (data.data ()),
+        size / sizeof (std::uint64_t), rng);
+
+    return std::make_shared <Item> (tag, data);
+}
+
+//------------------------------------------------------------------------------
+
+/** Microbenchmark driver for RadixMap::Table (a.k.a. SHAMap).
+
+    Builds a tree sized like the live state and times the operations
+    ledger building leans on — inserts, updates, full walks, the flush
+    walk, and mutation while a snapshot is outstanding — reporting
+    latency percentiles so SHAMap changes land with before/after
+    numbers. Build with `scons bench` and run manually:
+
+        rippled --unittest=RadixMapBenchmark
+            --unittest-arg="items=1000000,ops=100000"
+
+    Accepts a semicolon delimited list of configurations, each a comma
+    delimited list of key=value pairs:
+
+        items     leaves in the base tree            (default 100000)
+        ops       updates timed against it           (default 50000)
+        chunk     updates between flush walks        (default 1024)
+        snaps     snapshot/diverge iterations        (default 64)
+
+    The tree is unbacked, so the flush walk runs without the node
+    store writes; their cost is the NodeStore benchmark's business.
+*/
+class RadixMapBenchmark_test : public beast::unit_test::suite
+{
+public:
+    using bench_clock = std::chrono::steady_clock;
+
+    static std::uint64_t percentile (
+        std::vector<std::uint64_t> const& sorted, double p)
+    {
+        if (sorted.empty ())
+            return 0;
+        return sorted[static_cast<std::size_t> (
+            p * (sorted.size () - 1) + 0.5)];
+    }
+
+    void report (std::string const& label, std::vector<std::uint64_t>& v,
+        double elapsed, char const* unit)
+    {
+        if (v.empty ())
+            return;
+
+        std::sort (v.begin (), v.end ());
+
+        std::stringstream out;
+        out << std::setw (8) << label << ":"
+            << " n=" << v.size ()
+            << " ops/s=" << std::uint64_t (v.size () / elapsed)
+            << " p50=" << percentile (v, 0.50) << unit
+            << " p90=" << percentile (v, 0.90) << unit
+            << " p99=" << percentile (v, 0.99) << unit
+            << " p99.9=" << percentile (v, 0.999) << unit
+            << " max=" << v.back () << unit;
+        log << out.str ();
+    }
+
+    static std::uint64_t sinceNs (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (
+            bench_clock::now () - t0).count ();
+    }
+
+    static double sinceSeconds (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<
+            std::chrono::duration<double>> (
+                bench_clock::now () - t0).count ();
+    }
+
+    void benchmark (std::string const& name, std::int64_t items,
+        std::int64_t ops, std::int64_t chunk, std::int64_t snaps)
+    {
+        testcase (name);
+
+        beast::manual_clock <std::chrono::steady_clock> clock;
+        beast::Journal const j;
+
+        FullBelowCache fullBelowCache ("bench.full_below", clock);
+        TreeNodeCache treeNodeCache (
+            "bench.tree_node_cache", 65536, 60, clock, j);
+
+        Table map (smtFREE, fullBelowCache, treeNodeCache);
+        map.setUnbacked ();
+
+        std::vector<std::uint64_t> lat;
+        lat.reserve (std::max (items, ops));
+        int failures = 0;
+
+        // Build the base tree one timed insert at a time
+        auto started = bench_clock::now ();
+
+        for (std::int64_t i = 0; i < items; ++i)
+        {
+            auto item = make_item (i, 0);
+
+            auto const t0 = bench_clock::now ();
+            if (!map.addGiveItem (item, false, false))
+                ++failures;
+            lat.push_back (sinceNs (t0));
+        }
+
+        expect (failures == 0, "failed inserts");
+        report ("insert", lat, sinceSeconds (started), "ns");
+
+        // Update random existing leaves in place
+        std::mt19937_64 rng (7);
+        lat.clear ();
+        started = bench_clock::now ();
+
+        for (std::int64_t i = 0; i < ops; ++i)
+        {
+            auto item = make_item (rng () % items, 1);
+
+            auto const t0 = bench_clock::now ();
+            if (!map.updateGiveItem (item, false, false))
+                ++failures;
+            lat.push_back (sinceNs (t0));
+        }
+
+        expect (failures == 0, "failed updates");
+        report ("update", lat, sinceSeconds (started), "ns");
+
+        // Walk every leaf in tag order
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            std::size_t leaves = 0;
+
+            auto const t0 = bench_clock::now ();
+            map.visitLeaves ([&leaves] (SHAMapItem::ref)
+            {
+                ++leaves;
+            });
+            std::uint64_t const ns = sinceNs (t0);
+
+            expect (leaves == std::size_t (items), "missed leaves");
+
+            std::stringstream out;
+            out << "    walk: pass=" << pass
+                << " leaves=" << leaves
+                << " total=" << (ns / 1000000) << "ms"
+                << " per_leaf=" << (ns / std::max<std::size_t> (leaves, 1))
+                << "ns";
+            log << out.str ();
+        }
+
+        // The flush walk, after every chunk of updates. Unbacked maps
+        // never mark nodes shared, so each walk covers the whole tree;
+        // the numbers compare walk and hash-check cost, not I/O.
+        lat.clear ();
+        started = bench_clock::now ();
+
+        for (std::int64_t done = 0; done < ops; done += chunk)
+        {
+            for (std::int64_t i = 0; i < chunk; ++i)
+            {
+                if (!map.updateGiveItem (
+                        make_item (rng () % items, 2), false, false))
+                    ++failures;
+            }
+
+            auto const t0 = bench_clock::now ();
+            map.unshare ();
+            lat.push_back (sinceNs (t0) / 1000);
+        }
+
+        expect (failures == 0, "failed chunk updates");
+        report ("flush", lat, sinceSeconds (started), "us");
+
+        // Take a snapshot, then keep modifying the original so
+        // every touched path is copied instead of changed in place --
+        // the open ledger's life while consensus holds the closed one
+        std::vector<std::uint64_t> snapLat;
+        std::deque<Table::pointer> held;
+        lat.clear ();
+        started = bench_clock::now ();
+
+        for (std::int64_t s = 0; s < snaps; ++s)
+        {
+            auto const t0 = bench_clock::now ();
+            auto snap = map.snapShot (false);
+            snapLat.push_back (sinceNs (t0));
+
+            held.push_back (snap);
+            if (held.size () > 4)
+                held.pop_front ();
+
+            for (int i = 0; i < 16; ++i)
+            {
+                auto item = make_item (rng () % items, 3 + s);
+
+                auto const t1 = bench_clock::now ();
+                if (!map.updateGiveItem (item, false, false))
+                    ++failures;
+                lat.push_back (sinceNs (t1));
+            }
+
+            expect (held.back ()->getHash () != map.getHash (),
+                "snapshot tracked the original");
+        }
+
+        double const elapsed = sinceSeconds (started);
+        expect (failures == 0, "failed diverging updates");
+        report ("snap", snapLat, elapsed, "ns");
+        report ("diverge", lat, elapsed, "ns");
+    }
+
+    void run ()
+    {
+        auto args = arg ();
+
+        if (args.empty ())
+            args = "items=100000";
+
+        std::vector<std::string> configs;
+        boost::split (configs, args, boost::algorithm::is_any_of (";"));
+
+        for (auto& config : configs)
+        {
+            auto params = parseDelimitedKeyValueString (config, ',');
+
+            std::int64_t items = 100000;
+            std::int64_t ops = 50000;
+            std::int64_t chunk = 1024;
+            std::int64_t snaps = 64;
+
+            if (!params["items"].isEmpty ())
+                items = std::max (1, params["items"].getIntValue ());
+
+            if (!params["ops"].isEmpty ())
+                ops = std::max (1, params["ops"].getIntValue ());
+
+            if (!params["chunk"].isEmpty ())
+                chunk = std::max (1, params["chunk"].getIntValue ());
+
+            if (!params["snaps"].isEmpty ())
+                snaps = std::max (0, params["snaps"].getIntValue ());
+
+            benchmark (config, items, ops, chunk, snaps);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(RadixMapBenchmark,bench,ripple);
+
 }
 }
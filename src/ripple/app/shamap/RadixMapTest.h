@@ -26,6 +26,7 @@ typedef SHAMap Table;
 typedef SHAMapItem Item;
 
 // Utility functions for RadixMap::Table (a.k.a. SHAMap) unit tests
+// and benchmarks
 
 /** Returns a pseudo random Table item. */
 std::shared_ptr <Item> make_random_item (beast::Random& r);
@@ -37,5 +38,17 @@ std::shared_ptr <Item> make_random_item (beast::Random& r);
 */
 void add_random_items (std::size_t n, Table& t, beast::Random& r);
 
+/** Returns the deterministic tag derived from a key. */
+uint256 item_tag (std::uint64_t key);
+
+/** Returns a Table item with a deterministic tag.
+    Items made from the same key share a tag, so a later generation
+    updates the leaf an earlier generation created. The payload is
+    sized like a live account state node and varies with the
+    generation.
+*/
+std::shared_ptr <Item> make_item (
+    std::uint64_t key, std::uint32_t generation);
+
 }
 }
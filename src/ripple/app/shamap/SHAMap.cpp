@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/LatencyProbes.h>
 #include <ripple/basics/Log.h>
 #include <ripple/nodestore/Database.h>
 #include <beast/unit_test/suite.h>
@@ -48,7 +49,7 @@ SHAMap::SHAMap (
 {
     assert (mSeq != 0);
 
-    root = std::make_shared<SHAMapTreeNode> (mSeq);
+    root = SHAMapTreeNode::makeNode (mSeq);
     root->makeInner ();
 }
 
@@ -67,7 +68,7 @@ SHAMap::SHAMap (
     , mBacked (true)
     , m_missing_node_handler (missing_node_handler)
 {
-    root = std::make_shared<SHAMapTreeNode> (mSeq);
+    root = SHAMapTreeNode::makeNode (mSeq);
     root->makeInner ();
 }
 
@@ -91,10 +92,15 @@ SHAMap::pointer SHAMap::snapShot (bool isMutable)
     newMap.mSeq = mSeq + 1;
     newMap.root = root;
 
-    if ((mState != smsImmutable) || !isMutable)
+    if (mState != smsImmutable)
     {
-        // If either map may change, they cannot share nodes
-        newMap.unshare ();
+        // This map can still change. Advance our generation past the
+        // snapshot's so no existing node carries our current sequence;
+        // every future modification then goes through unshareNode and
+        // copies the path instead of touching nodes the snapshot can
+        // see. Sharing stays lazy: unmodified subtrees are never
+        // duplicated, no matter how many snapshots are outstanding.
+        mSeq = newMap.mSeq + 1;
     }
 
     return ret;
@@ -199,7 +205,7 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeFromDB (uint256 const& hash)
         {
             try
             {
-                node = std::make_shared <SHAMapTreeNode> (obj->getData(),
+                node = SHAMapTreeNode::makeNode (obj->getData(),
                     0, snfPREFIX, hash, true);
                 canonicalize (hash, node);
             }
@@ -230,7 +236,7 @@ SHAMapTreeNode::pointer SHAMap::checkFilter (
 
     if (filter->haveNode (id, hash, nodeData))
     {
-        node = std::make_shared <SHAMapTreeNode> (
+        node = SHAMapTreeNode::makeNode (
             nodeData, 0, snfPREFIX, hash, true);
 
        filter->gotNode (true, id, hash, nodeData, node->getType ());
@@ -402,7 +408,7 @@ SHAMapTreeNode* SHAMap::descendAsync (SHAMapTreeNode* parent, int branch,
             if (!obj)
                 return nullptr;
 
-            ptr = std::make_shared <SHAMapTreeNode> (obj->getData(), 0, snfPREFIX, hash, true);
+            ptr = SHAMapTreeNode::makeNode (obj->getData(), 0, snfPREFIX, hash, true);
 
             if (mBacked)
                 canonicalize (hash, ptr);
@@ -415,6 +421,59 @@ SHAMapTreeNode* SHAMap::descendAsync (SHAMapTreeNode* parent, int branch,
     return ptr.get ();
 }
 
+void SHAMap::prefetchChildren (SHAMapTreeNode* node, int max)
+{
+    // Queue background reads for children a traversal is about to
+    // need, so the node store works ahead of the iterator
+    if (!mBacked || !node->isInner ())
+        return;
+
+    for (int i = 0; (i < 16) && (max > 0); ++i)
+    {
+        if (!node->isEmptyBranch (i) && !node->getChildPointer (i))
+        {
+            uint256 const& hash = node->getChildHash (i);
+
+            if (!getCache (hash))
+            {
+                NodeObject::pointer obj;
+
+                if (!getApp().getNodeStore ().asyncFetch (hash, obj))
+                    --max;
+            }
+        }
+    }
+}
+
+void SHAMap::prefetchItem (uint256 const& id)
+{
+    if (!mBacked)
+        return;
+
+    SHAMapTreeNode* node = root.get ();
+    SHAMapNodeID nodeID;
+
+    while (node->isInner ())
+    {
+        int const branch = nodeID.selectBranch (id);
+
+        if (node->isEmptyBranch (branch))
+            return;
+
+        bool pending;
+        node = descendAsync (node, branch,
+            nodeID.getChildNodeID (branch), nullptr, pending);
+
+        // If the node wasn't in memory its read is now queued (or the
+        // node is missing); either way this path is as warm as we can
+        // make it without blocking
+        if (!node)
+            return;
+
+        nodeID = nodeID.getChildNodeID (branch);
+    }
+}
+
 void
 SHAMap::unshareNode (SHAMapTreeNode::pointer& node, SHAMapNodeID const& nodeID)
 {
@@ -427,7 +486,7 @@ SHAMap::unshareNode (SHAMapTreeNode::pointer& node, SHAMapNodeID const& nodeID)
         // have a CoW
         assert (mState != smsImmutable);
 
-        node = std::make_shared<SHAMapTreeNode> (*node, mSeq); // here's to the new node, same as the old node
+        node = SHAMapTreeNode::makeNode (*node, mSeq); // here's to the new node, same as the old node
         assert (node->isValid ());
 
         if (nodeID.isRoot ())
@@ -446,6 +505,12 @@ SHAMap::firstBelow (SHAMapTreeNode* node)
         if (node->hasItem ())
             return node;
 
+        // An iterator that lands here will visit the siblings next,
+        // so get their reads started before we descend
+        if (mBacked)
+            prefetchChildren (node,
+                getApp().getNodeStore ().getDesiredAsyncReadCount ());
+
         // Walk down the tree
         bool foundNode = false;
         for (int i = 0; i < 16; ++i)
@@ -795,7 +860,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         int branch = nodeID.selectBranch (tag);
         assert (node->isEmptyBranch (branch));
         SHAMapTreeNode::pointer newNode =
-            std::make_shared<SHAMapTreeNode> (item, type, mSeq);
+            SHAMapTreeNode::makeNode (item, type, mSeq);
         if (! node->setChild (branch, newNode->getNodeHash (), newNode))
         {
             assert (false);
@@ -818,7 +883,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
 
             // we need a new inner node, since both go on same branch at this level
             nodeID = nodeID.getChildNodeID (b1);
-            node = std::make_shared<SHAMapTreeNode> (mSeq);
+            node = SHAMapTreeNode::makeNode (mSeq);
             node->makeInner ();
         }
 
@@ -826,14 +891,14 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         assert (node->isInner ());
 
         SHAMapTreeNode::pointer newNode =
-            std::make_shared<SHAMapTreeNode> (item, type, mSeq);
+            SHAMapTreeNode::makeNode (item, type, mSeq);
         assert (newNode->isValid () && newNode->isLeaf ());
         if (!node->setChild (b1, newNode->getNodeHash (), newNode))
         {
             assert (false);
         }
 
-        newNode = std::make_shared<SHAMapTreeNode> (otherItem, type, mSeq);
+        newNode = SHAMapTreeNode::makeNode (otherItem, type, mSeq);
         assert (newNode->isValid () && newNode->isLeaf ());
         if (!node->setChild (b2, newNode->getNodeHash (), newNode))
         {
@@ -955,7 +1020,7 @@ void SHAMap::preFlushNode (SHAMapTreeNode::pointer& node)
     {
         // Node is not uniquely ours, so unshare it before
         // possibly modifying it
-        node = std::make_shared <SHAMapTreeNode> (*node, mSeq);
+        node = SHAMapTreeNode::makeNode (*node, mSeq);
     }
 }
 
@@ -968,6 +1033,10 @@ int SHAMap::unshare ()
 // If requested, write them to the node store
 int SHAMap::flushDirty (NodeObjectType t, std::uint32_t seq)
 {
+    static std::size_t const probeIndex (
+        LatencyProbes::getInstance ().probe ("shamap.flush"));
+    ScopedLatencyProbe probe (probeIndex);
+
     return walkSubTree (true, t, seq);
 }
 
@@ -1105,6 +1174,55 @@ bool SHAMap::getPath (uint256 const& index, std::vector< Blob >& nodes, SHANodeF
     return true;
 }
 
+bool SHAMap::getProofPath (uint256 const& index, std::vector<Blob>& proof)
+{
+    return getPath (index, proof, snfPREFIX);
+}
+
+bool SHAMap::verifyProofPath (uint256 const& rootHash,
+    uint256 const& index, std::vector<Blob> const& proof)
+{
+    if (proof.empty ())
+        return false;
+
+    try
+    {
+        uint256 expected = rootHash;
+        SHAMapNodeID nodeID;
+
+        for (std::size_t i = 0; i < proof.size (); ++i)
+        {
+            // Recompute the hash from the raw node rather than trusting
+            // the one supplied
+            SHAMapTreeNode node (proof[i], 0, snfPREFIX, uint256 (), false);
+
+            if (node.getNodeHash () != expected)
+                return false;
+
+            if (node.isLeaf ())
+            {
+                // A leaf must be the last node on the path
+                return ((i + 1) == proof.size ()) &&
+                    (node.getTag () == index);
+            }
+
+            int const branch = nodeID.selectBranch (index);
+
+            if (node.isEmptyBranch (branch))
+                return false;
+
+            expected = node.getChildHash (branch);
+            nodeID = nodeID.getChildNodeID (branch);
+        }
+    }
+    catch (...)
+    {
+        // A malformed node is not a valid proof
+    }
+
+    return false;
+}
+
 void SHAMap::dump (bool hash)
 {
     int leafCount = 0;
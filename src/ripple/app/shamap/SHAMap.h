@@ -121,6 +121,41 @@ public:
     typedef std::map<uint256, DeltaItem> Delta;
     typedef hash_map<SHAMapNodeID, SHAMapTreeNode::pointer, SHAMapNode_hash> NodeMap;
 
+    /** Memoizes per-branch compare results across compares.
+
+        Consensus diffs the same transaction sets pairwise many times in
+        one round and positions share most of their content, so the same
+        pairs of differing subtrees come up over and over. A fragment
+        depends only on the contents of the two subtrees, so it is keyed
+        by their hashes (zero for an empty branch) and is valid for any
+        pair of maps. Use one cache per consensus round; the compare
+        using it provides the synchronization.
+    */
+    class DeltaCache
+    {
+    public:
+        std::shared_ptr <Delta const> fetch (
+            uint256 const& first, uint256 const& second) const
+        {
+            auto it = mFragments.find (std::make_pair (first, second));
+
+            if (it == mFragments.end ())
+                return std::shared_ptr <Delta const> ();
+
+            return it->second;
+        }
+
+        void insert (uint256 const& first, uint256 const& second,
+            std::shared_ptr <Delta const> const& fragment)
+        {
+            mFragments.emplace (std::make_pair (first, second), fragment);
+        }
+
+    private:
+        std::map <std::pair <uint256, uint256>,
+            std::shared_ptr <Delta const>> mFragments;
+    };
+
     typedef std::stack<std::pair<SHAMapTreeNode::pointer, SHAMapNodeID>> SharedPtrNodeStack;
 
 public:
@@ -182,11 +217,20 @@ public:
     void visitNodes (std::function<bool (SHAMapTreeNode&)> const&);
     void visitLeaves(std::function<void (SHAMapItem::ref)> const&);
 
+    // How deep getNodeFat will descend and how many bytes one fat
+    // reply may carry
+    enum
+    {
+        fatQueryDepthMax = 5,
+        fatReplyBudget   = 256 * 1024
+    };
+
     // comparison/sync functions
     void getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
                           SHAMapSyncFilter * filter);
     bool getNodeFat (SHAMapNodeID node, std::vector<SHAMapNodeID>& nodeIDs,
-                     std::list<Blob >& rawNode, bool fatRoot, bool fatLeaves);
+                     std::list<Blob >& rawNode, bool fatRoot, bool fatLeaves,
+                     int depth = 1, int maxBytes = fatReplyBudget);
     bool getRootNode (Serializer & s, SHANodeFormat format);
     std::vector<uint256> getNeededHashes (int max, SHAMapSyncFilter * filter);
     SHAMapAddNode addRootNode (uint256 const& hash, Blob const& rootNode, SHANodeFormat format,
@@ -223,16 +267,56 @@ public:
     // return value: true=successfully completed, false=too different
     bool compare (SHAMap::ref otherMap, Delta & differences, int maxCount);
 
+    // As above, but differing top-level branches are diffed through the
+    // cache, and uncached branches are computed in parallel on the job
+    // queue. Both maps must be immutable.
+    bool compare (SHAMap::ref otherMap, Delta & differences, int maxCount,
+                  DeltaCache & cache);
+
     int flushDirty (NodeObjectType t, std::uint32_t seq);
     int unshare ();
 
-    void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing);
+    // Walk the tree looking for missing nodes. If maxDepth is nonzero,
+    // only the top maxDepth levels of inner nodes are visited; anything
+    // deeper faults in from the backing store on first use. Nodes not in
+    // memory are read through the node store's asynchronous read pool,
+    // many at a time, rather than one synchronous read each.
+    void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing,
+                  int maxDepth = 0);
+
+    // Fetch the subtree under one top-level branch out of the backing
+    // store, canonicalizing its nodes into the tree node cache. Missing
+    // nodes are tolerated. Only shared, locked structures are touched,
+    // so distinct branches can be prefetched from parallel jobs.
+    void prefetchBranch (int branch);
+
+    // Queue background reads for the nodes on the path to this item,
+    // so a later peekItem doesn't pay one synchronous read per level.
+    void prefetchItem (uint256 const& id);
 
     bool deepCompare (SHAMap & other);
 
+    /** Get the Merkle path from the root to the specified item.
+        Nodes are returned in snfPREFIX form, so each one hashes to the
+        hash its parent lists for it. A partial path, ending at an inner
+        node whose relevant branch is empty, proves the item's absence.
+        @return true if the item is present.
+    */
+    bool getProofPath (uint256 const& index, std::vector<Blob>& proof);
+
+    /** Verify a proof path against a root hash.
+        Standalone: needs neither a SHAMap nor database access, so a
+        client holding the root hash can check a proof by itself.
+        @return true if every node hashes to the hash its parent lists,
+                the first node hashes to `rootHash`, and the last node
+                is a leaf with tag `index`.
+    */
+    static bool verifyProofPath (uint256 const& rootHash,
+        uint256 const& index, std::vector<Blob> const& proof);
+
     typedef std::pair <uint256, Blob> fetchPackEntry_t;
 
-    void getFetchPack (SHAMap * have, bool includeLeaves, int max, std::function<void (uint256 const&, const Blob&)>);
+    void getFetchPack (SHAMap * have, bool includeLeaves, int max, std::function<void (uint256 const&, Blob&&)>);
 
     void setUnbacked ()
     {
@@ -301,6 +385,16 @@ private:
     SHAMapTreeNode* descendAsync (SHAMapTreeNode* parent, int branch,
         SHAMapNodeID const& childID, SHAMapSyncFilter* filter, bool& pending);
 
+    /** Scan one subtree for nodes that should be present but aren't.
+
+        The workhorse of getMissingNodes; `max` bounds how many missing
+        nodes the scan reports. Only shared, locked structures are
+        touched, so disjoint subtrees can be scanned from parallel jobs.
+    */
+    void scanMissing (SHAMapTreeNode* start, SHAMapNodeID const& startID,
+        std::uint32_t generation, int max, SHAMapSyncFilter* filter,
+        std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes);
+
     std::pair <SHAMapTreeNode*, SHAMapNodeID>
         descend (SHAMapTreeNode* parent, SHAMapNodeID const& parentID,
         int branch, SHAMapSyncFilter* filter);
@@ -312,6 +406,9 @@ private:
     /** If there is only one leaf below this node, get its contents */
     SHAMapItem::pointer onlyBelow (SHAMapTreeNode*);
 
+    /** Queue background reads for up to `max` unresolved children */
+    void prefetchChildren (SHAMapTreeNode* node, int max);
+
     bool hasInnerNode (SHAMapNodeID const& nodeID, uint256 const& hash);
     bool hasLeafNode (uint256 const& tag, uint256 const& hash);
 
@@ -319,6 +416,10 @@ private:
                      SHAMapItem::ref otherMapItem, bool isFirstMap,
                      Delta & differences, int & maxCount);
 
+    bool comparePair (SHAMapTreeNode* ourNode, SHAMap & otherMap,
+                      SHAMapTreeNode* otherNode,
+                      Delta & differences, int & maxCount);
+
     void visitLeavesInternal (std::function<void (SHAMapItem::ref item)>& function);
 
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
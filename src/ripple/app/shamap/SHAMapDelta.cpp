@@ -17,6 +17,9 @@
 */
 //==============================================================================
 
+#include <condition_variable>
+#include <mutex>
+
 namespace ripple {
 
 // This code is used to compare another node's transaction tree
@@ -109,26 +112,21 @@ bool SHAMap::walkBranch (SHAMapTreeNode* node,
     return true;
 }
 
-bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
+bool SHAMap::comparePair (SHAMapTreeNode* ourNode, SHAMap& otherMap,
+                          SHAMapTreeNode* otherNode,
+                          Delta& differences, int& maxCount)
 {
-    // compare two hash trees, add up to maxCount differences to the difference table
-    // return value: true=complete table of differences given, false=too many differences
-    // throws on corrupt tables or missing nodes
-    // CAUTION: otherMap is not locked and must be immutable
-
-    assert (isValid () && otherMap && otherMap->isValid ());
+    // Diff the subtrees rooted at a pair of corresponding nodes, one
+    // from each map. Returns false once maxCount differences are found.
 
     using StackEntry = std::pair <SHAMapTreeNode*, SHAMapTreeNode*>;
     std::stack <StackEntry, std::vector<StackEntry>> nodeStack; // track nodes we've pushed
 
-    if (getHash () == otherMap->getHash ())
-        return true;
-
-    nodeStack.push ({root.get(), otherMap->root.get()});
+    nodeStack.push ({ourNode, otherNode});
     while (!nodeStack.empty ())
     {
-        SHAMapTreeNode* ourNode = nodeStack.top().first;
-        SHAMapTreeNode* otherNode = nodeStack.top().second;
+        ourNode = nodeStack.top().first;
+        otherNode = nodeStack.top().second;
         nodeStack.pop ();
 
         if (!ourNode || !otherNode)
@@ -174,8 +172,8 @@ bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
         }
         else if (ourNode->isLeaf () && otherNode->isInner ())
         {
-            if (!otherMap->walkBranch (otherNode, ourNode->peekItem (),
-                                       false, differences, maxCount))
+            if (!otherMap.walkBranch (otherNode, ourNode->peekItem (),
+                                      false, differences, maxCount))
                 return false;
         }
         else if (ourNode->isInner () && otherNode->isInner ())
@@ -196,15 +194,15 @@ bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
                     {
                         // The other tree has a branch, we do not
                         SHAMapTreeNode* iNode =
-                            otherMap->descendThrow(otherNode, i);
-                        if (!otherMap->walkBranch (iNode,
-                                                   SHAMapItem::pointer(),
-                                                   false, differences, maxCount))
+                            otherMap.descendThrow(otherNode, i);
+                        if (!otherMap.walkBranch (iNode,
+                                                  SHAMapItem::pointer(),
+                                                  false, differences, maxCount))
                             return false;
                     }
                     else // The two trees have different non-empty branches
                         nodeStack.push ({descendThrow (ourNode, i),
-                                        otherMap->descendThrow (otherNode, i)});
+                                        otherMap.descendThrow (otherNode, i)});
                 }
         }
         else
@@ -214,15 +212,321 @@ bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
     return true;
 }
 
-void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
+bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
 {
-    std::stack <SHAMapTreeNode::pointer,
-        std::vector <SHAMapTreeNode::pointer>> nodeStack;
+    // compare two hash trees, add up to maxCount differences to the difference table
+    // return value: true=complete table of differences given, false=too many differences
+    // throws on corrupt tables or missing nodes
+    // CAUTION: otherMap is not locked and must be immutable
+
+    assert (isValid () && otherMap && otherMap->isValid ());
+
+    if (getHash () == otherMap->getHash ())
+        return true;
+
+    return comparePair (root.get (), *otherMap, otherMap->root.get (),
+                        differences, maxCount);
+}
+
+bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount,
+                      DeltaCache& cache)
+{
+    // As above, but the walk is split across the top-level branches: a
+    // delta fragment is computed (or recalled from the cache) per pair
+    // of differing branches and the fragments are merged at the end.
+    // CAUTION: both maps must be immutable
+
+    assert (isValid () && otherMap && otherMap->isValid ());
+
+    if (getHash () == otherMap->getHash ())
+        return true;
+
+    SHAMapTreeNode* ourRoot = root.get ();
+    SHAMapTreeNode* otherRoot = otherMap->root.get ();
+
+    if (!ourRoot->isInner () || !otherRoot->isInner ())
+        return comparePair (ourRoot, *otherMap, otherRoot,
+                            differences, maxCount);
+
+    // One task per pair of differing top-level branches
+    struct BranchTask
+    {
+        int branch;
+        uint256 ourHash;                         // zero if empty
+        uint256 otherHash;                       // zero if empty
+        std::shared_ptr <Delta const> fragment;  // the branch's delta
+        bool complete;                           // ran out of maxCount?
+    };
+
+    std::vector <BranchTask> tasks;
+    std::size_t misses = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (ourRoot->getChildHash (i) != otherRoot->getChildHash (i))
+        {
+            BranchTask task;
+            task.branch = i;
+            task.ourHash = ourRoot->getChildHash (i);
+            task.otherHash = otherRoot->getChildHash (i);
+            task.fragment = cache.fetch (task.ourHash, task.otherHash);
+            task.complete = (task.fragment != nullptr);
+
+            if (!task.fragment)
+                ++misses;
+
+            tasks.push_back (task);
+        }
+    }
+
+    if (misses != 0)
+    {
+        // Tasks are handed out through this shared state. The calling
+        // thread pumps tasks along with the helper jobs, so progress
+        // never depends on job queue capacity; a job that starts after
+        // the compare has finished finds no work and touches nothing
+        // else.
+        struct CompareState
+        {
+            std::mutex lock;
+            std::condition_variable done;
+            std::size_t next;
+            std::size_t count;
+            int busy;
+            bool failed;
+        };
+
+        auto state = std::make_shared <CompareState> ();
+        state->next = 0;
+        state->count = tasks.size ();
+        state->busy = 0;
+        state->failed = false;
+
+        auto tasksPtr = &tasks;
+
+        auto const compute =
+            [this, otherMap, ourRoot, otherRoot, maxCount] (BranchTask& task)
+        {
+            int budget = maxCount;
+            auto fragment = std::make_shared <Delta> ();
+
+            if (task.otherHash.isZero ())
+            {
+                // We have the branch, the other tree does not
+                task.complete = walkBranch (
+                    descendThrow (ourRoot, task.branch),
+                    SHAMapItem::pointer (), true, *fragment, budget);
+            }
+            else if (task.ourHash.isZero ())
+            {
+                // The other tree has the branch, we do not
+                task.complete = otherMap->walkBranch (
+                    otherMap->descendThrow (otherRoot, task.branch),
+                    SHAMapItem::pointer (), false, *fragment, budget);
+            }
+            else
+            {
+                task.complete = comparePair (
+                    descendThrow (ourRoot, task.branch), *otherMap,
+                    otherMap->descendThrow (otherRoot, task.branch),
+                    *fragment, budget);
+            }
+
+            task.fragment = fragment;
+        };
+
+        auto const pump = [state, tasksPtr, compute] ()
+        {
+            for (;;)
+            {
+                BranchTask* task = nullptr;
+
+                {
+                    std::lock_guard <std::mutex> sl (state->lock);
+
+                    while ((state->next < state->count) &&
+                           (*tasksPtr)[state->next].fragment)
+                        ++state->next;   // already cached
+
+                    if (state->next >= state->count)
+                        return;
+
+                    task = &(*tasksPtr)[state->next++];
+                    ++state->busy;
+                }
+
+                bool missing = false;
+
+                try
+                {
+                    compute (*task);
+                }
+                catch (...)
+                {
+                    missing = true;
+                }
+
+                {
+                    std::lock_guard <std::mutex> sl (state->lock);
+
+                    if (missing)
+                        state->failed = true;
+
+                    --state->busy;
+                }
+
+                state->done.notify_all ();
+            }
+        };
+
+        if (misses > 1)
+        {
+            auto const helpers =
+                std::min <std::size_t> (misses - 1, 4);
+
+            for (std::size_t i = 0; i < helpers; ++i)
+                getApp().getJobQueue ().addJob (jtTXN_DATA,
+                    "compareTxSets", std::bind (pump));
+        }
+
+        pump ();
+
+        {
+            std::unique_lock <std::mutex> sl (state->lock);
+
+            while (state->busy != 0)
+                state->done.wait (sl);
+        }
+
+        if (state->failed)
+            throw SHAMapMissingNode (mType, uint256 ());
+    }
+
+    bool complete = true;
+
+    for (auto const& task : tasks)
+    {
+        if (task.complete)
+            cache.insert (task.ourHash, task.otherHash, task.fragment);
+        else
+            complete = false;
+
+        for (auto const& entry : *task.fragment)
+        {
+            differences.insert (entry);
+
+            if (--maxCount <= 0)
+                return false;
+        }
+    }
+
+    return complete;
+}
+
+void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing,
+                      int maxDepth)
+{
+    std::stack <std::pair <SHAMapTreeNode::pointer, int>,
+        std::vector <std::pair <SHAMapTreeNode::pointer, int>>> nodeStack;
 
     if (!root->isInner ())  // root is only node, and we have it
         return;
 
-    nodeStack.push (root);
+    // A child whose backing store read is in flight
+    struct Deferred
+    {
+        SHAMapTreeNode::pointer parent;
+        int branch;
+        int depth;
+    };
+
+    std::vector <Deferred> deferred;
+
+    // Visit one child. Children not in memory are fetched through the node
+    // store's asynchronous read pool so a whole batch of reads is
+    // outstanding at once instead of one synchronous read per node.
+    auto const visit = [&] (SHAMapTreeNode::pointer const& parent,
+        int branch, int depth) -> bool
+    {
+        bool pending = false;
+        SHAMapTreeNode* nextNode = descendAsync (
+            parent.get (), branch, SHAMapNodeID (), nullptr, pending);
+
+        if (pending)
+        {
+            deferred.push_back ({parent, branch, depth});
+        }
+        else if (nextNode)
+        {
+            if (nextNode->isInner () &&
+                    ((maxDepth == 0) || (depth < maxDepth)))
+                nodeStack.push ({parent->getChild (branch), depth + 1});
+        }
+        else
+        {
+            missingNodes.emplace_back (mType, parent->getChildHash (branch));
+            if (--maxMissing <= 0)
+                return false;
+        }
+
+        return true;
+    };
+
+    nodeStack.push ({root, 1});
+
+    while (!nodeStack.empty () || !deferred.empty ())
+    {
+        while (!nodeStack.empty ())
+        {
+            SHAMapTreeNode::pointer node = std::move (nodeStack.top().first);
+            int const depth = nodeStack.top().second;
+            nodeStack.pop ();
+
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!node->isEmptyBranch (i) && !visit (node, i, depth))
+                    return;
+            }
+        }
+
+        if (!deferred.empty ())
+        {
+            // Let the read pool resolve the whole batch, then revisit.
+            // A revisit finds the object in the node store's cache, so
+            // it can only be deferred again if the cache was swept.
+            getApp().getNodeStore ().waitReads ();
+
+            std::vector <Deferred> retry;
+            std::swap (retry, deferred);
+
+            for (auto const& entry : retry)
+            {
+                if (!visit (entry.parent, entry.branch, entry.depth))
+                    return;
+            }
+        }
+    }
+}
+
+void SHAMap::prefetchBranch (int branch)
+{
+    if (!root->isInner () || root->isEmptyBranch (branch))
+        return;
+
+    std::stack <SHAMapTreeNode::pointer,
+        std::vector <SHAMapTreeNode::pointer>> nodeStack;
+
+    {
+        SHAMapTreeNode::pointer top = root->getChild (branch);
+
+        if (!top)
+            top = fetchNodeNT (root->getChildHash (branch));
+
+        if (!top || !top->isInner ())
+            return;
+
+        nodeStack.push (std::move (top));
+    }
 
     while (!nodeStack.empty ())
     {
@@ -233,19 +537,15 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
         {
             if (!node->isEmptyBranch (i))
             {
-                SHAMapTreeNode::pointer nextNode = descendNoStore (node, i);
+                SHAMapTreeNode::pointer nextNode = node->getChild (i);
 
-                if (nextNode)
-                {
-                    if (nextNode->isInner ())
-                        nodeStack.push (std::move (nextNode));
-                }
-                else
-                {
-                    missingNodes.emplace_back (mType, node->getChildHash (i));
-                    if (--maxMissing <= 0)
-                        return;
-                }
+                if (!nextNode)
+                    nextNode = fetchNodeNT (node->getChildHash (i));
+
+                // A missing node is not fatal here: whoever actually
+                // needs it will fault it in and report it missing
+                if (nextNode && nextNode->isInner ())
+                    nodeStack.push (std::move (nextNode));
             }
         }
     }
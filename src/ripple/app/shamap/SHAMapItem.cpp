@@ -27,6 +27,12 @@ SHAMapItem::SHAMapItem (uint256 const& tag, Blob const& data)
 {
 }
 
+SHAMapItem::SHAMapItem (uint256 const& tag, Blob&& data)
+    : mTag (tag)
+    , mData (std::move (data))
+{
+}
+
 SHAMapItem::SHAMapItem (uint256 const& tag, const Serializer& data)
     : mTag (tag)
     , mData (data.peekData ())
@@ -44,6 +44,7 @@ public:
     }
     explicit SHAMapItem (Blob const & data); // tag by hash
     SHAMapItem (uint256 const& tag, Blob const & data);
+    SHAMapItem (uint256 const& tag, Blob&& data);
     SHAMapItem (uint256 const& tag, const Serializer & s);
 
     uint256 const& getTag () const
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SHAMAPNODEALLOCATOR_H
+#define RIPPLE_SHAMAPNODEALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace ripple {
+
+/** Recycling slab pool for tree node allocations.
+
+    A busy server creates and destroys millions of SHAMapTreeNode objects
+    per hour. Routing every one of them through the global allocator both
+    serializes on the heap lock and fragments memory over long uptimes.
+
+    The pool carves fixed-size blocks out of large slabs and keeps freed
+    blocks on a free list for reuse. Slabs are never returned to the
+    operating system; the pool's high-water mark matches the node working
+    set rather than tracking churn. All blocks in one pool have the same
+    size, so requests for any size up to blockSize can be satisfied.
+
+    Thread safe.
+*/
+class SHAMapNodeSlabPool
+{
+private:
+    // Blocks per slab. Large enough to amortize the slab allocation,
+    // small enough not to overshoot badly on small maps.
+    static std::size_t const slabBlocks = 256;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    std::size_t const m_blockSize;
+    std::mutex m_mutex;
+    FreeBlock* m_freeList;
+    std::vector <std::unique_ptr <char[]>> m_slabs;
+
+public:
+    explicit SHAMapNodeSlabPool (std::size_t blockSize)
+        : m_blockSize (std::max (blockSize, sizeof (FreeBlock)))
+        , m_freeList (nullptr)
+    {
+    }
+
+    SHAMapNodeSlabPool (SHAMapNodeSlabPool const&) = delete;
+    SHAMapNodeSlabPool& operator= (SHAMapNodeSlabPool const&) = delete;
+
+    std::size_t blockSize () const
+    {
+        return m_blockSize;
+    }
+
+    void* allocate ()
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        if (! m_freeList)
+            grow ();
+
+        FreeBlock* const block = m_freeList;
+        m_freeList = block->next;
+        return block;
+    }
+
+    void deallocate (void* p)
+    {
+        FreeBlock* const block = static_cast <FreeBlock*> (p);
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+
+private:
+    // Caller holds the lock
+    void grow ()
+    {
+        m_slabs.emplace_back (new char [m_blockSize * slabBlocks]);
+        char* base = m_slabs.back ().get ();
+
+        for (std::size_t i = 0; i < slabBlocks; ++i)
+        {
+            FreeBlock* const block =
+                reinterpret_cast <FreeBlock*> (base + i * m_blockSize);
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Standard allocator that draws single objects from a shared slab pool.
+
+    Intended for use with std::allocate_shared so the node and its
+    reference counts land in one pooled block, the way make_shared
+    combines them in one heap allocation. Array and oversized requests
+    fall back to the global allocator.
+*/
+template <class T>
+class SHAMapNodeAllocator
+{
+private:
+    template <class U>
+    friend class SHAMapNodeAllocator;
+
+    // One pool per rebound type; sized on first use for that type
+    // (allocate_shared rebinds to its internal node type).
+    static SHAMapNodeSlabPool& pool ()
+    {
+        static SHAMapNodeSlabPool instance (sizeof (T));
+        return instance;
+    }
+
+public:
+    typedef T value_type;
+
+    SHAMapNodeAllocator () = default;
+
+    template <class U>
+    SHAMapNodeAllocator (SHAMapNodeAllocator <U> const&)
+    {
+    }
+
+    T* allocate (std::size_t n)
+    {
+        if (n == 1)
+            return static_cast <T*> (pool ().allocate ());
+
+        return static_cast <T*> (::operator new (n * sizeof (T)));
+    }
+
+    void deallocate (T* p, std::size_t n)
+    {
+        if (n == 1)
+            pool ().deallocate (p);
+        else
+            ::operator delete (p);
+    }
+
+    friend bool operator== (SHAMapNodeAllocator const&,
+                            SHAMapNodeAllocator const&)
+    {
+        return true;
+    }
+
+    friend bool operator!= (SHAMapNodeAllocator const&,
+                            SHAMapNodeAllocator const&)
+    {
+        return false;
+    }
+};
+
+} // ripple
+
+#endif
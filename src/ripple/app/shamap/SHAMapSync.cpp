@@ -20,6 +20,9 @@
 #include <ripple/nodestore/Database.h>
 #include <beast/unit_test/suite.h>
 #include <openssl/rand.h> // DEPRECATED
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 namespace ripple {
 
@@ -57,12 +60,18 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function)
     if (!root->isInner ())
         return;
 
+    int const readAhead = mBacked ?
+        getApp().getNodeStore ().getDesiredAsyncReadCount () : 0;
+
     using StackEntry = std::pair <int, SHAMapTreeNode::pointer>;
     std::stack <StackEntry, std::vector <StackEntry>> stack;
 
     SHAMapTreeNode::pointer node = root;
     int pos = 0;
 
+    if (readAhead != 0)
+        prefetchChildren (node.get (), readAhead);
+
     while (1)
     {
         while (pos < 16)
@@ -91,6 +100,9 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function)
                     // descend to the child's first position
                     node = child;
                     pos = 0;
+
+                    if (readAhead != 0)
+                        prefetchChildren (node.get (), readAhead);
                 }
             }
             else
@@ -107,29 +119,10 @@ void SHAMap::visitNodes(std::function<bool (SHAMapTreeNode&)> const& function)
     }
 }
 
-/** Get a list of node IDs and hashes for nodes that are part of this SHAMap
-    but not available locally.  The filter can hold alternate sources of
-    nodes that are not permanently stored locally
-*/
-void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
-                              SHAMapSyncFilter* filter)
+void SHAMap::scanMissing (SHAMapTreeNode* start, SHAMapNodeID const& startID,
+    std::uint32_t generation, int max, SHAMapSyncFilter* filter,
+    std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes)
 {
-    assert (root->isValid ());
-    assert (root->getNodeHash().isNonZero ());
-
-    std::uint32_t generation = m_fullBelowCache.getGeneration();
-    if (root->isFullBelow (generation))
-    {
-        clearSynching ();
-        return;
-    }
-
-    if (!root->isInner ())
-    {
-        WriteLog (lsWARNING, SHAMap) << "synching empty tree";
-        return;
-    }
-
     int const maxDefer = getApp().getNodeStore().getDesiredAsyncReadCount ();
 
     // Track the missing hashes we have found so far
@@ -144,10 +137,10 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
         using StackEntry = std::tuple<SHAMapTreeNode*, SHAMapNodeID, int, int, bool>;
         std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-        // Traverse the map without blocking
+        // Traverse the subtree without blocking
 
-        SHAMapTreeNode *node = root.get ();
-        SHAMapNodeID nodeID;
+        SHAMapTreeNode *node = start;
+        SHAMapNodeID nodeID = startID;
 
         // The firstChild value is selected randomly so if multiple threads
         // are traversing the map, each thread will start at a different
@@ -264,9 +257,216 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<ui
         }
 
     }
+}
+
+/** Get a list of node IDs and hashes for nodes that are part of this SHAMap
+    but not available locally.  The filter can hold alternate sources of
+    nodes that are not permanently stored locally
+*/
+void SHAMap::getMissingNodes (std::vector<SHAMapNodeID>& nodeIDs, std::vector<uint256>& hashes, int max,
+                              SHAMapSyncFilter* filter)
+{
+    assert (root->isValid ());
+    assert (root->getNodeHash().isNonZero ());
+
+    std::uint32_t generation = m_fullBelowCache.getGeneration();
+    if (root->isFullBelow (generation))
+    {
+        clearSynching ();
+        return;
+    }
+
+    if (!root->isInner ())
+    {
+        WriteLog (lsWARNING, SHAMap) << "synching empty tree";
+        return;
+    }
+
+    // One scan task per top-level branch that is not already known full
+    // below. The root's children are resolved here, serially - they are
+    // nearly always in memory - and any that are missing themselves go
+    // straight onto the found list.
+    struct BranchTask
+    {
+        SHAMapTreeNode* node;
+        SHAMapNodeID nodeID;
+        std::vector <SHAMapNodeID> foundIDs;
+        std::vector <uint256> foundHashes;
+    };
+
+    std::vector <BranchTask> tasks;
+    tasks.reserve (16);
+
+    std::vector <SHAMapNodeID> rootMissingIDs;
+    std::vector <uint256> rootMissingHashes;
+
+    SHAMapNodeID rootID;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (root->isEmptyBranch (branch))
+            continue;
+
+        uint256 const& childHash = root->getChildHash (branch);
+
+        if (mBacked && m_fullBelowCache.touch_if_exists (childHash))
+            continue;
+
+        SHAMapNodeID const childID = rootID.getChildNodeID (branch);
+
+        bool pending = false;
+        SHAMapTreeNode* d = descendAsync (
+            root.get (), branch, childID, filter, pending);
+
+        if (!d && pending)
+        {
+            getApp().getNodeStore().waitReads ();
+
+            SHAMapTreeNode::pointer ptr =
+                fetchNodeNT (childID, childHash, filter);
+
+            if (ptr)
+            {
+                if (mBacked)
+                    canonicalize (childHash, ptr);
+                root->canonicalizeChild (branch, ptr);
+                d = ptr.get ();
+            }
+        }
+
+        if (!d)
+        {
+            rootMissingIDs.push_back (childID);
+            rootMissingHashes.push_back (childHash);
+        }
+        else if (d->isInner () && !d->isFullBelow (generation))
+        {
+            BranchTask task;
+            task.node = d;
+            task.nodeID = childID;
+            tasks.push_back (std::move (task));
+        }
+    }
+
+    if (! tasks.empty ())
+    {
+        // Tasks are handed out through this shared state, as in the
+        // parallel transaction set compare: the calling thread pumps
+        // tasks along with the helper jobs, so progress never depends
+        // on job queue capacity, and a job that starts after the scan
+        // has finished finds no work and touches nothing else.
+        struct ScanState
+        {
+            std::mutex lock;
+            std::condition_variable done;
+            std::size_t next;
+            std::size_t count;
+            int busy;
+        };
+
+        auto state = std::make_shared <ScanState> ();
+        state->next = 0;
+        state->count = tasks.size ();
+        state->busy = 0;
+
+        auto tasksPtr = &tasks;
+        int const taskMax = max;
+
+        auto const pump =
+            [this, state, tasksPtr, taskMax, generation, filter] ()
+        {
+            for (;;)
+            {
+                BranchTask* task = nullptr;
+
+                {
+                    std::lock_guard <std::mutex> sl (state->lock);
+
+                    if (state->next >= state->count)
+                        return;
+
+                    task = &(*tasksPtr)[state->next++];
+                    ++state->busy;
+                }
+
+                scanMissing (task->node, task->nodeID, generation, taskMax,
+                    filter, task->foundIDs, task->foundHashes);
+
+                {
+                    std::lock_guard <std::mutex> sl (state->lock);
+                    --state->busy;
+                }
+
+                state->done.notify_all ();
+            }
+        };
+
+        if (tasks.size () > 1)
+        {
+            auto const helpers =
+                std::min <std::size_t> (tasks.size () - 1, 4);
+
+            for (std::size_t i = 0; i < helpers; ++i)
+                getApp().getJobQueue ().addJob (jtLEDGER_DATA,
+                    "getMissingNodes", std::bind (pump));
+        }
+
+        pump ();
+
+        {
+            std::unique_lock <std::mutex> sl (state->lock);
+
+            while (state->busy != 0)
+                state->done.wait (sl);
+        }
+    }
+
+    // Merge, shallowest first: fetching a shallow missing node uncovers
+    // more of the frontier for the next round than a deep one does.
+    struct Found
+    {
+        SHAMapNodeID id;
+        uint256 hash;
+    };
+
+    std::vector <Found> found;
+
+    std::size_t total = rootMissingIDs.size ();
+    for (auto const& task : tasks)
+        total += task.foundIDs.size ();
+    found.reserve (total);
+
+    for (std::size_t i = 0; i < rootMissingIDs.size (); ++i)
+        found.push_back ({rootMissingIDs[i], rootMissingHashes[i]});
+
+    for (auto const& task : tasks)
+        for (std::size_t i = 0; i < task.foundIDs.size (); ++i)
+            found.push_back ({task.foundIDs[i], task.foundHashes[i]});
+
+    std::stable_sort (found.begin (), found.end (),
+        [] (Found const& lhs, Found const& rhs)
+        {
+            return lhs.id.getDepth () < rhs.id.getDepth ();
+        });
+
+    for (auto const& f : found)
+    {
+        nodeIDs.push_back (f.id);
+        hashes.push_back (f.hash);
+
+        if (--max <= 0)
+            break;
+    }
 
     if (nodeIDs.empty ())
+    {
+        // Every branch proved complete
+        root->setFullBelowGen (generation);
+        if (mBacked)
+            m_fullBelowCache.insert (root->getNodeHash ());
+
         clearSynching ();
+    }
 }
 
 std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
@@ -282,9 +482,11 @@ std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
 }
 
 bool SHAMap::getNodeFat (SHAMapNodeID wanted, std::vector<SHAMapNodeID>& nodeIDs,
-                         std::list<Blob >& rawNodes, bool fatRoot, bool fatLeaves)
+                         std::list<Blob >& rawNodes, bool fatRoot, bool fatLeaves,
+                         int depth, int maxBytes)
 {
-    // Gets a node and some of its children
+    // Gets a node and as much of its subtree as the depth and byte
+    // budget allow
 
     SHAMapTreeNode* node = root.get ();
 
@@ -309,51 +511,49 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted, std::vector<SHAMapNodeID>& nodeIDs
         return false;
     }
 
-    int count;
-    bool skipNode = false;
-    do
-    {
+    // Walk the subtree in preorder so a node is always serialized
+    // before its children: the receiver can then link every node to
+    // a parent it already has, no matter how deep the reply goes.
+    std::vector<std::pair<SHAMapTreeNode*,
+        std::pair<SHAMapNodeID, int>>> stack;
+    stack.push_back (std::make_pair (node,
+        std::make_pair (wanted, depth)));
 
-        if (skipNode)
-            skipNode = false;
-        else
+    int bytes = 0;
+
+    while (!stack.empty () && (bytes < maxBytes))
+    {
+        node = stack.back ().first;
+        nodeID = stack.back ().second.first;
+        int remaining = stack.back ().second.second;
+        stack.pop_back ();
+
+        // Don't send leaves unless the request wants them, but always
+        // send the node that was actually asked for
+        if ((nodeID == wanted) || node->isInner () || fatLeaves)
         {
             Serializer s;
             node->addRaw (s, snfWIRE);
-            nodeIDs.push_back (wanted);
+            nodeIDs.push_back (nodeID);
+            bytes += s.getLength ();
             rawNodes.push_back (std::move (s.peekData ()));
         }
 
-        if ((!fatRoot && wanted.isRoot ()) || node->isLeaf ()) // don't get a fat root, can't get a fat leaf
-            return true;
+        // don't get a fat root, can't get a fat leaf
+        if ((!fatRoot && nodeID.isRoot ()) || node->isLeaf ())
+            continue;
 
-        SHAMapTreeNode* nextNode = nullptr;
-        SHAMapNodeID nextNodeID;
+        if (remaining <= 0)
+            continue;
 
-        count = 0;
-        for (int i = 0; i < 16; ++i)
+        for (int i = 15; i >= 0; --i)
         {
             if (!node->isEmptyBranch (i))
-            {
-                SHAMapNodeID nextNodeID = wanted.getChildNodeID (i);
-                nextNode = descendThrow (node, i);
-                ++count;
-                if (fatLeaves || nextNode->isInner ())
-                {
-                    Serializer s;
-                    nextNode->addRaw (s, snfWIRE);
-                    nodeIDs.push_back (nextNodeID);
-                    rawNodes.push_back (std::move (s.peekData ()));
-                    skipNode = true; // Don't add this node again if we loop
-                }
-            }
+                stack.push_back (std::make_pair (descendThrow (node, i),
+                    std::make_pair (nodeID.getChildNodeID (i),
+                        remaining - 1)));
         }
-
-        node = nextNode;
-        wanted = nextNodeID;
-
-    // So long as there's exactly one inner node, we take it
-    } while ((count == 1) && node->isInner());
+    }
 
     return true;
 }
@@ -376,7 +576,7 @@ SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode, SHANodeFormat format,
 
     assert (mSeq >= 1);
     SHAMapTreeNode::pointer node =
-        std::make_shared<SHAMapTreeNode> (rootNode, 0,
+        SHAMapTreeNode::makeNode (rootNode, 0,
                                           format, uZero, false);
 
     if (!node)
@@ -418,7 +618,7 @@ SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SH
 
     assert (mSeq >= 1);
     SHAMapTreeNode::pointer node =
-        std::make_shared<SHAMapTreeNode> (rootNode, 0,
+        SHAMapTreeNode::makeNode (rootNode, 0,
                                           format, uZero, false);
 
     if (!node || node->getNodeHash () != hash)
@@ -494,7 +694,7 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Blob const& rawNode,
             }
 
             SHAMapTreeNode::pointer newNode =
-                std::make_shared<SHAMapTreeNode> (rawNode, 0, snfWIRE,
+                SHAMapTreeNode::makeNode (rawNode, 0, snfWIRE,
                                                   uZero, false);
 
             if (!newNode->isInBounds (iNodeID))
@@ -662,7 +862,7 @@ Note: a caller should set includeLeaves to false for transaction trees.
 There's no point in including the leaves of transaction trees.
 */
 void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
-                           std::function<void (uint256 const&, const Blob&)> func)
+                           std::function<void (uint256 const&, Blob&&)> func)
 {
     if (root->getNodeHash ().isZero ())
         return;
@@ -677,7 +877,7 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
         {
             Serializer s;
             root->addRaw (s, snfPREFIX);
-            func (std::cref(root->getNodeHash ()), std::cref(s.peekData ()));
+            func (root->getNodeHash (), std::move (s.modData ()));
             --max;
         }
 
@@ -699,7 +899,7 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
         // 1) Add this node to the pack
         Serializer s;
         node->addRaw (s, snfPREFIX);
-        func (std::cref(node->getNodeHash ()), std::cref(s.peekData ()));
+        func (node->getNodeHash (), std::move (s.modData ()));
         --max;
 
         // 2) push non-matching child inner nodes
@@ -740,7 +940,7 @@ std::list <Blob> SHAMap::getTrustedPath (uint256 const& index)
     while (!stack.empty ())
     {
         stack.top ().first->addRaw (s, snfWIRE);
-        path.push_back (s.getData ());
+        path.push_back (std::move (s.modData ()));
         s.erase ();
         stack.pop ();
     }
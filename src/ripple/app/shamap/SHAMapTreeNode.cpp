@@ -90,7 +90,8 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
         if (type == 0)
         {
             // transaction
-            mItem = std::make_shared<SHAMapItem> (s.getPrefixHash (HashPrefix::transactionID), s.peekData ());
+            uint256 const txID = s.getPrefixHash (HashPrefix::transactionID);
+            mItem = std::make_shared<SHAMapItem> (txID, std::move (s.modData ()));
             mType = tnTRANSACTION_NM;
         }
         else if (type == 1)
@@ -105,7 +106,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 
             if (u.isZero ()) throw std::runtime_error ("invalid AS node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, std::move (s.modData ()));
             mType = tnACCOUNT_STATE;
         }
         else if (type == 2)
@@ -155,7 +156,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             if (u.isZero ())
                 throw std::runtime_error ("invalid TM node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, std::move (s.modData ()));
             mType = tnTRANSACTION_MD;
         }
     }
@@ -179,7 +180,8 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
 
         if (prefix == HashPrefix::transactionID)
         {
-            mItem = std::make_shared<SHAMapItem> (Serializer::getSHA512Half (rawNode), s.peekData ());
+            uint256 const txID = Serializer::getSHA512Half (rawNode);
+            mItem = std::make_shared<SHAMapItem> (txID, std::move (s.modData ()));
             mType = tnTRANSACTION_NM;
         }
         else if (prefix == HashPrefix::leafNode)
@@ -197,7 +199,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
                 throw std::runtime_error ("invalid PLN node");
             }
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, std::move (s.modData ()));
             mType = tnACCOUNT_STATE;
         }
         else if (prefix == HashPrefix::innerNode)
@@ -224,7 +226,7 @@ SHAMapTreeNode::SHAMapTreeNode (Blob const& rawNode,
             uint256 txID;
             s.get256 (txID, s.getLength () - 32);
             s.chop (32);
-            mItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (txID, std::move (s.modData ()));
             mType = tnTRANSACTION_MD;
         }
         else
@@ -280,19 +282,17 @@ bool SHAMapTreeNode::updateHash ()
     }
     else if (mType == tnACCOUNT_STATE)
     {
-        Serializer s (mItem->peekSerializer ().getDataLength () + (256 + 32) / 8);
-        s.add32 (HashPrefix::leafNode);
-        s.addRaw (mItem->peekData ());
-        s.add256 (mItem->getTag ());
-        nh = s.getSHA512Half ();
+        // Stream prefix, data and tag straight into the hash;
+        // no scratch buffer to assemble and free per node
+        nh = Serializer::getPrefixHash (HashPrefix::leafNode,
+            mItem->peekData ().data (), mItem->peekData ().size (),
+            mItem->getTag ());
     }
     else if (mType == tnTRANSACTION_MD)
     {
-        Serializer s (mItem->peekSerializer ().getDataLength () + (256 + 32) / 8);
-        s.add32 (HashPrefix::txNode);
-        s.addRaw (mItem->peekData ());
-        s.add256 (mItem->getTag ());
-        nh = s.getSHA512Half ();
+        nh = Serializer::getPrefixHash (HashPrefix::txNode,
+            mItem->peekData ().data (), mItem->peekData ().size (),
+            mItem->getTag ());
     }
     else
         assert (false);
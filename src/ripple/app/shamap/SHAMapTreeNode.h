@@ -20,6 +20,7 @@
 #ifndef RIPPLE_SHAMAPTREENODE_H
 #define RIPPLE_SHAMAPTREENODE_H
 
+#include <ripple/app/shamap/SHAMapNodeAllocator.h>
 #include <ripple/app/shamap/SHAMapNodeID.h>
 #include <ripple/app/shamap/TreeNodeCache.h>
 #include <ripple/basics/CountedObject.h>
@@ -67,6 +68,19 @@ public:
                     SHANodeFormat format, uint256 const& hash, bool hashValid);
     void addRaw (Serializer&, SHANodeFormat format);
 
+    /** Construct a node in a pooled block shared with its refcounts.
+
+        All node creation should come through here; it keeps node churn
+        off the global allocator. Takes any constructor argument list.
+    */
+    template <class... Args>
+    static pointer makeNode (Args&&... args)
+    {
+        return std::allocate_shared <SHAMapTreeNode> (
+            SHAMapNodeAllocator <SHAMapTreeNode> (),
+            std::forward <Args> (args)...);
+    }
+
     virtual bool isPopulated () const
     {
         return true;
@@ -350,6 +350,18 @@ public:
             // empty (fully crossed), or something in-between.
             core::Amounts place_offer;
 
+            // Warm the ledger caches with the likely tip of the book
+            // before crossing starts. The tip cache is advisory only:
+            // crossing below reads the book through the ledger as
+            // always, so a stale hint costs nothing but the prefetch.
+            for (auto const& index :
+                    getApp().getOrderBookDB ().getBookTips (
+                        Book (taker_amount.in.issue (),
+                            taker_amount.out.issue ())))
+            {
+                mEngine->getLedger ()->getSLEi (index);
+            }
+
             std::tie(terResult, place_offer) = crossOffers (view, taker_amount);
 
             if (terResult == tecFAILED_PROCESSING && bOpenLedger)
@@ -41,6 +41,9 @@ test-applied to all new open ledgers until seen in a fully-
 validated ledger
 */
 
+#include <beast/intrusive/LockFreeStack.h>
+
+#include <atomic>
 
 namespace ripple {
 
@@ -102,17 +105,39 @@ private:
 
 class LocalTxsImp : public LocalTxs
 {
+private:
+    // A submission waiting to be folded into the hold list. Submissions
+    // are pushed lock-free so RPC threads never contend with consensus.
+    struct Pending : beast::LockFreeStack <Pending>::Node
+    {
+        Pending (LedgerIndex index_, STTx::ref txn_)
+            : index (index_)
+            , txn (txn_)
+        {
+        }
+
+        LedgerIndex index;
+        STTx::pointer txn;
+    };
+
 public:
 
     LocalTxsImp()
-    { }
+        : m_count (0)
+    {
+    }
+
+    ~LocalTxsImp()
+    {
+        while (Pending* p = m_pending.pop_front ())
+            delete p;
+    }
 
     // Add a new transaction to the set of local transactions
     void push_back (LedgerIndex index, STTx::ref txn) override
     {
-        std::lock_guard <std::mutex> lock (m_lock);
-
-        m_txns.emplace_back (index, txn);
+        m_pending.push_front (new Pending (index, txn));
+        ++m_count;
     }
 
     bool can_remove (LocalTx& txn, Ledger::ref ledger)
@@ -145,6 +170,8 @@ public:
         {
             std::lock_guard <std::mutex> lock (m_lock);
 
+            drain ();
+
             for (auto& it : m_txns)
                 tset.push_back (it.getTX());
         }
@@ -153,7 +180,10 @@ public:
         {
             try
             {
-                TransactionEngineParams parms = tapOPEN_LEDGER;
+                // The signature was checked when the transaction was
+                // first submitted, so don't pay for it on every re-apply
+                TransactionEngineParams parms =
+                    tapOPEN_LEDGER | tapNO_CHECK_SIGN;
                 bool didApply;
                 engine.applyTransaction (*it.second, parms, didApply);
             }
@@ -173,10 +203,15 @@ public:
     {
         std::lock_guard <std::mutex> lock (m_lock);
 
+        drain ();
+
         for (auto it = m_txns.begin (); it != m_txns.end (); )
         {
             if (can_remove (*it, validLedger))
+            {
                 it = m_txns.erase (it);
+                --m_count;
+            }
             else
                 ++it;
         }
@@ -184,15 +219,27 @@ public:
 
     std::size_t size () override
     {
-        std::lock_guard <std::mutex> lock (m_lock);
-
-        return m_txns.size ();
+        return m_count.load ();
     }
 
 private:
 
+    // Fold pending submissions into the hold list. Callers must hold
+    // m_lock: serializing consumers this way also makes the lock-free
+    // pops safe from the ABA problem, since nodes are never pushed back.
+    void drain ()
+    {
+        while (Pending* p = m_pending.pop_front ())
+        {
+            m_txns.emplace_back (p->index, p->txn);
+            delete p;
+        }
+    }
+
     std::mutex m_lock;
     std::list <LocalTx> m_txns;
+    beast::LockFreeStack <Pending> m_pending;
+    std::atomic <std::size_t> m_count;
 };
 
 std::unique_ptr <LocalTxs> LocalTxs::New()
@@ -155,8 +155,8 @@ Transaction::pointer Transaction::transactionFromSQL (std::string const& sql)
     rawTxn.resize (txSize);
 
     {
-        auto sl (getApp().getTxnDB ().lock ());
-        auto db = getApp().getTxnDB ().getDB ();
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         if (!db->executeSQL (sql, true) || !db->startIterRows ())
             return Transaction::pointer ();
@@ -19,6 +19,7 @@
 
 #include <ripple/overlay/Overlay.h>
 #include <boost/foreach.hpp>
+#include <algorithm>
 
 namespace ripple {
 
@@ -47,7 +48,7 @@ TransactionAcquire::~TransactionAcquire ()
 static void TACompletionHandler (uint256 hash, SHAMap::pointer map)
 {
     {
-        Application::ScopedLockType lock (getApp ().getMasterLock ());
+        MasterLockGuard lock (getApp ().consensusLock ());
 
         getApp().getOPs ().mapComplete (hash, map);
 
@@ -83,7 +84,7 @@ void TransactionAcquire::onTimer (bool progress, ScopedLockType& psl)
         WriteLog (lsWARNING, TransactionAcquire) << "Ten timeouts on TX set " << getHash ();
         psl.unlock();
         {
-            auto lock = getApp().masterLock();
+            MasterLockGuard lock (getApp ().consensusLock ());
 
             if (getApp().getOPs ().stillNeedTXSet (mHash))
             {
@@ -152,6 +153,7 @@ void TransactionAcquire::trigger (Peer::ptr const& peer)
         protocol::TMGetLedger tmGL;
         tmGL.set_ledgerhash (mHash.begin (), mHash.size ());
         tmGL.set_itype (protocol::liTS_CANDIDATE);
+        tmGL.set_querydepth (2);
 
         if (getTimeouts () != 0)
             tmGL.set_querytype (protocol::qtINDIRECT);
@@ -183,18 +185,92 @@ void TransactionAcquire::trigger (Peer::ptr const& peer)
             return;
         }
 
-        protocol::TMGetLedger tmGL;
-        tmGL.set_ledgerhash (mHash.begin (), mHash.size ());
-        tmGL.set_itype (protocol::liTS_CANDIDATE);
+        requestNodes (nodeIDs, peer);
+    }
+}
 
-        if (getTimeouts () != 0)
-            tmGL.set_querytype (protocol::qtINDIRECT);
+void TransactionAcquire::requestNodes (
+    std::vector<SHAMapNodeID> const& nodeIDs, Peer::ptr const& peer)
+{
+    // Stripe the missing nodes across every peer that announced this
+    // set: each peer is asked for a disjoint slice, so the whole set
+    // can arrive in one round trip instead of one chunk per response.
+    // Once we've timed out, redundancy beats efficiency and whoever we
+    // ask gets the full list.
+    ScopedLockType sl (mLock);
+
+    protocol::TMGetLedger tmGL;
+    tmGL.set_ledgerhash (mHash.begin (), mHash.size ());
+    tmGL.set_itype (protocol::liTS_CANDIDATE);
+    tmGL.set_querydepth (2);
+
+    if (getTimeouts () != 0)
+        tmGL.set_querytype (protocol::qtINDIRECT);
+
+    std::vector<Peer::id_t> ids;
+    ids.reserve (mPeers.size ());
+    for (auto const& p : mPeers)
+        ids.push_back (p.first);
+    std::sort (ids.begin (), ids.end ());
+
+    // Which stripes to send: all of them, or just the stripe belonging
+    // to the peer that triggered us (its previous request completed;
+    // the other stripes are already in flight elsewhere)
+    std::size_t first = 0;
+    std::size_t count = ids.size ();
+
+    if (peer)
+    {
+        auto const it = std::find (ids.begin (), ids.end (), peer->id ());
 
-        for (SHAMapNodeID& it : nodeIDs)
+        if (it != ids.end ())
+        {
+            first = it - ids.begin ();
+            count = 1;
+        }
+        else
         {
-            *tmGL.add_nodeids () = it.getRawString ();
+            // An unannounced peer gave us nodes; ask it for everything
+            ids.assign (1, peer->id ());
+            first = 0;
+            count = 1;
         }
+    }
+
+    if (ids.empty () || getTimeouts () > 1)
+    {
+        // No peers to stripe across, or we're struggling: send the
+        // full list the old way
+        for (auto const& nodeID : nodeIDs)
+            *tmGL.add_nodeids () = nodeID.getRawString ();
+
         sendRequest (tmGL, peer);
+        return;
+    }
+
+    for (std::size_t i = first; i < first + count; ++i)
+    {
+        Peer::ptr target = (peer && peer->id () == ids[i]) ? peer
+            : getApp().overlay ().findPeerByShortID (ids[i]);
+
+        if (!target)
+            continue;
+
+        protocol::TMGetLedger req (tmGL);
+
+        for (std::size_t j = i; j < nodeIDs.size (); j += ids.size ())
+            *req.add_nodeids () = nodeIDs[j].getRawString ();
+
+        if (req.nodeids_size () == 0)
+        {
+            // The tail of the acquisition: fewer nodes are missing
+            // than we have peers, so just ask for all of them
+            for (auto const& nodeID : nodeIDs)
+                *req.add_nodeids () = nodeID.getRawString ();
+        }
+
+        target->send (
+            std::make_shared<Message> (req, protocol::mtGET_LEDGER));
     }
 }
 
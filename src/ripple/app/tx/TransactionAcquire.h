@@ -60,6 +60,8 @@ private:
 
     void done ();
     void trigger (Peer::ptr const&);
+    void requestNodes (std::vector<SHAMapNodeID> const& nodeIDs,
+        Peer::ptr const& peer);
     std::weak_ptr<PeerSet> pmDowncast ();
 };
 
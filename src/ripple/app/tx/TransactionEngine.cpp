@@ -196,6 +196,25 @@ TER TransactionEngine::applyTransaction (
             didApply = false;
             terResult = tefINTERNAL;
         }
+        else if (params & tapOPEN_LEDGER)
+        {
+            // Provisional application: the metadata would just be
+            // discarded, so don't pay to assemble it or to thread the
+            // transaction to the nodes it affected. The apply that
+            // builds the closed ledger does the real bookkeeping.
+            txnWrite ();
+
+            Serializer s;
+            txn.add (s);
+
+            if (!mLedger->addTransaction (txID, s))
+            {
+                WriteLog (lsFATAL, TransactionEngine) <<
+                    "Tried to add transaction to open ledger that already had it";
+                assert (false);
+                throw std::runtime_error ("Duplicate transaction applied");
+            }
+        }
         else
         {
             // Transaction succeeded fully or (retries are not allowed and the
@@ -208,30 +227,17 @@ TER TransactionEngine::applyTransaction (
             Serializer s;
             txn.add (s);
 
-            if (params & tapOPEN_LEDGER)
+            if (!mLedger->addTransaction (txID, s, m))
             {
-                if (!mLedger->addTransaction (txID, s))
-                {
-                    WriteLog (lsFATAL, TransactionEngine) <<
-                        "Tried to add transaction to open ledger that already had it";
-                    assert (false);
-                    throw std::runtime_error ("Duplicate transaction applied");
-                }
+                WriteLog (lsFATAL, TransactionEngine) <<
+                    "Tried to add transaction to ledger that already had it";
+                assert (false);
+                throw std::runtime_error ("Duplicate transaction applied to closed ledger");
             }
-            else
-            {
-                if (!mLedger->addTransaction (txID, s, m))
-                {
-                    WriteLog (lsFATAL, TransactionEngine) <<
-                        "Tried to add transaction to ledger that already had it";
-                    assert (false);
-                    throw std::runtime_error ("Duplicate transaction applied to closed ledger");
-                }
 
-                // Charge whatever fee they specified.
-                STAmount saPaid = txn.getTransactionFee ();
-                mLedger->destroyCoins (saPaid.getNValue ());
-            }
+            // Charge whatever fee they specified.
+            STAmount saPaid = txn.getTransactionFee ();
+            mLedger->destroyCoins (saPaid.getNValue ());
         }
     }
 
@@ -117,6 +117,19 @@ void TransactionMaster::sweep (void)
     mCache.sweep ();
 }
 
+void TransactionMaster::clearCommitted (std::uint32_t validatedSeq)
+{
+    for (auto const& tid : mCache.getKeys ())
+    {
+        Transaction::pointer txn = mCache.fetch (tid);
+
+        if (txn && (txn->getStatus () == COMMITTED) &&
+                (txn->getLedger () != 0) &&
+                (txn->getLedger () <= validatedSeq))
+            mCache.del (tid, false);
+    }
+}
+
 TaggedCache <uint256, Transaction>& TransactionMaster::getCache()
 {
     return mCache;
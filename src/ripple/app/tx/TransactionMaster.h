@@ -37,6 +37,14 @@ public:
     bool inLedger (uint256 const& hash, std::uint32_t ledger);
     bool canonicalize (Transaction::pointer* pTransaction);
     void sweep (void);
+
+    /** Evict transactions whose ledger has been validated.
+
+        Once a ledger is validated and persisted, the canonical copy of
+        its transactions is on disk and entries pinned in the cache only
+        add to the steady-state footprint.
+    */
+    void clearCommitted (std::uint32_t validatedSeq);
     TaggedCache <uint256, Transaction>& getCache();
 
 private:
@@ -103,7 +103,7 @@ std::vector<RippleAddress> TransactionMetaSet::getAffectedAccounts ()
 
             if (inner)
             {
-                BOOST_FOREACH (const STBase & field, inner->peekData ())
+                for (const STBase& field : *inner)
                 {
                     const STAccount* sa = dynamic_cast<const STAccount*> (&field);
 
@@ -20,7 +20,9 @@
 #ifndef RIPPLE_WSCONNECTION_H
 #define RIPPLE_WSCONNECTION_H
 
+#include <ripple/basics/Log.h>
 #include <ripple/core/Config.h>
+#include <ripple/protocol/JsonFields.h>
 #include <ripple/resource/Manager.h>
 #include <ripple/server/Port.h>
 #include <ripple/json/to_string.h>
@@ -99,9 +101,93 @@ public:
     typedef WSServerHandler <endpoint_type> server_type;
 
 private:
+    enum
+    {
+        // Broadcast backlog (bytes buffered for the socket) where we
+        // start shedding stream traffic for this client
+        sendQueueSoftLimit = 1024 * 1024,
+
+        // Backlog that counts as persistently over budget
+        sendQueueHardLimit = 4 * 1024 * 1024,
+
+        // Consecutive over-budget broadcasts before eviction
+        evictionStrikes = 10
+    };
+
     server_type& m_serverHandler;
     weak_connection_ptr m_connection;
 
+    // Conflated ledger stream entry awaiting a drained client, and the
+    // over-budget strike count. Guarded by the InfoSub lock.
+    Json::Value m_pendingLedgerClose;
+    bool m_hasPendingLedgerClose;
+    int m_overBudgetStrikes;
+
+    /** Apply backpressure policy to one broadcast message.
+        Returns true if the message should be delivered now. When the
+        client is backlogged, ledger stream entries are conflated (only
+        the latest close is kept), other stream messages are shed, and
+        a client persistently over budget is disconnected. Replies to
+        the client's own requests are never gated.
+    */
+    bool gateBroadcast (connection_ptr const& ptr, Json::Value const& jvObj)
+    {
+        std::uint64_t const buffered = ptr->buffered_amount ();
+
+        bool evict = false;
+        bool flush = false;
+        Json::Value pending;
+
+        {
+            ScopedLockType sl (mLock);
+
+            if (buffered >= sendQueueSoftLimit)
+            {
+                if ((buffered >= sendQueueHardLimit) &&
+                    (++m_overBudgetStrikes >= evictionStrikes))
+                    evict = true;
+
+                // The latest ledger close supersedes any the client
+                // has not yet read
+                if (jvObj.isMember (jss::type) &&
+                    (jvObj[jss::type] == jss::ledgerClosed))
+                {
+                    m_pendingLedgerClose = jvObj;
+                    m_hasPendingLedgerClose = true;
+                }
+
+                if (! evict)
+                    return false;
+            }
+            else
+            {
+                m_overBudgetStrikes = 0;
+
+                if (m_hasPendingLedgerClose)
+                {
+                    pending = std::move (m_pendingLedgerClose);
+                    m_pendingLedgerClose = Json::Value ();
+                    m_hasPendingLedgerClose = false;
+                    flush = true;
+                }
+            }
+        }
+
+        if (evict)
+        {
+            WriteLog (lsWARNING, WSConnection)
+                << "Ws:: Evicting slow client, " << buffered
+                << " bytes buffered";
+            disconnect ();
+            return false;
+        }
+
+        if (flush)
+            m_serverHandler.send (ptr, pending, true);
+
+        return true;
+    }
+
 public:
     WSConnectionType (Resource::Manager& resourceManager,
                       InfoSub::Source& source,
@@ -118,6 +204,8 @@ public:
             cpConnection->get_io_service ())
         , m_serverHandler (serverHandler)
         , m_connection (cpConnection)
+        , m_hasPendingLedgerClose (false)
+        , m_overBudgetStrikes (0)
     {
         setPingTimer ();
     }
@@ -144,7 +232,7 @@ public:
     {
         connection_ptr ptr = m_connection.lock ();
 
-        if (ptr)
+        if (ptr && (!broadcast || gateBroadcast (ptr, jvObj)))
             m_serverHandler.send (ptr, jvObj, broadcast);
     }
 
@@ -152,10 +240,28 @@ public:
     {
         connection_ptr ptr = m_connection.lock ();
 
-        if (ptr)
+        if (ptr && (!broadcast || gateBroadcast (ptr, jvObj)))
             m_serverHandler.send (ptr, sObj, broadcast);
     }
 
+    void send (Json::Value const& jvObj, InfoSub::MessagePtr const& spObj,
+               bool broadcast)
+    {
+        connection_ptr ptr = m_connection.lock ();
+
+        if (ptr && (!broadcast || gateBroadcast (ptr, jvObj)))
+            m_serverHandler.send (ptr, spObj, broadcast);
+    }
+
+    void sendBinary (Json::Value const& jvObj,
+                     InfoSub::MessagePtr const& spObj, bool broadcast)
+    {
+        connection_ptr ptr = m_connection.lock ();
+
+        if (ptr && (!broadcast || gateBroadcast (ptr, jvObj)))
+            m_serverHandler.sendBinary (ptr, spObj, broadcast);
+    }
+
     void disconnect ()
     {
         connection_ptr ptr = m_connection.lock ();
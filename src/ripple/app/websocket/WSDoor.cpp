@@ -40,7 +40,6 @@ namespace ripple {
 
 class WSDoorImp
     : public WSDoor
-    , protected beast::Thread
     , beast::LeakChecked <WSDoorImp>
 {
 private:
@@ -55,23 +54,11 @@ private:
 
 public:
     WSDoorImp (HTTP::Port const& port, Resource::Manager& resourceManager,
-        InfoSub::Source& source)
+        InfoSub::Source& source, boost::asio::io_service& io_service)
         : WSDoor (source)
-        , Thread ("websocket")
         , port_(std::make_shared<HTTP::Port>(port))
         , m_resourceManager (resourceManager)
         , m_source (source)
-    {
-        startThread ();
-    }
-
-    ~WSDoorImp ()
-    {
-        stopThread ();
-    }
-
-private:
-    void run ()
     {
         WriteLog (lsINFO, WSDoor) <<
             "Websocket: '" << port_->name << "' listening on " <<
@@ -82,50 +69,29 @@ private:
             new WSServerHandler <websocketpp::server_autotls> (
                 port_, m_resourceManager, m_source));
 
-        {
-            ScopedLockType lock (m_endpointLock);
-
-            m_endpoint = std::make_shared<websocketpp::server_autotls> (
-                handler);
-        }
-
-        // Call the main-event-loop of the websocket server.
-        try
-        {
-            m_endpoint->listen (port_->ip, port_->port);
-        }
-        catch (websocketpp::exception& e)
-        {
-            WriteLog (lsWARNING, WSDoor) << "websocketpp exception: "
-                                         << e.what ();
-
-            // temporary workaround for websocketpp throwing exceptions on
-            // access/close races
-            for (;;)
-            {
-                // https://github.com/zaphoyd/websocketpp/issues/98
-                try
-                {
-                    m_endpoint->get_io_service ().run ();
-                    break;
-                }
-                catch (websocketpp::exception& e)
-                {
-                    WriteLog (lsWARNING, WSDoor) << "websocketpp exception: "
-                                                 << e.what ();
-                }
-            }
-        }
+        // The endpoint is hosted on the server's shared io_service pool
+        // rather than a thread of its own; every websocket door and its
+        // connections share the pool's threads.
+        std::shared_ptr<websocketpp::server_autotls> endpoint (
+            std::make_shared<websocketpp::server_autotls> (
+                handler, io_service));
 
         {
             ScopedLockType lock (m_endpointLock);
 
-            m_endpoint.reset();
+            m_endpoint = endpoint;
         }
 
-        stopped ();
+        // Binds and begins accepting; the handlers run on the pool.
+        endpoint->start_listen_external (
+            boost::asio::ip::tcp::endpoint (port_->ip, port_->port));
     }
 
+    ~WSDoorImp ()
+    {
+    }
+
+private:
     void onStop ()
     {
         std::shared_ptr<websocketpp::server_autotls> endpoint;
@@ -133,16 +99,29 @@ private:
         {
             ScopedLockType lock (m_endpointLock);
 
-             endpoint = m_endpoint;
+            endpoint = m_endpoint;
+            m_endpoint.reset();
         }
 
-        // VFALCO NOTE we probably dont want to block here
-        //             but websocketpp is deficient and broken.
-        //
         if (endpoint)
+        {
+            // Refuse new connections, close existing ones cleanly, and
+            // close the acceptor. The connections wind down on the shared
+            // io_service, which keeps running for the rest of the server.
             endpoint->stop ();
 
-        signalThreadShouldExit ();
+            try
+            {
+                endpoint->stop_listen (false);
+            }
+            catch (websocketpp::exception& e)
+            {
+                WriteLog (lsWARNING, WSDoor) << "websocketpp exception: "
+                                             << e.what ();
+            }
+        }
+
+        stopped ();
     }
 };
 
@@ -157,13 +136,14 @@ WSDoor::WSDoor (Stoppable& parent)
 
 std::unique_ptr<WSDoor>
 make_WSDoor (HTTP::Port const& port, Resource::Manager& resourceManager,
-    InfoSub::Source& source)
+    InfoSub::Source& source, boost::asio::io_service& io_service)
 {
     std::unique_ptr<WSDoor> door;
 
     try
     {
-        door = std::make_unique <WSDoorImp> (port, resourceManager, source);
+        door = std::make_unique <WSDoorImp> (
+            port, resourceManager, source, io_service);
     }
     catch (...)
     {
@@ -21,6 +21,7 @@
 #define RIPPLE_WSDOOR_H_INCLUDED
 
 #include <ripple/server/Port.h>
+#include <boost/asio/io_service.hpp>
 
 namespace ripple {
 
@@ -39,7 +40,7 @@ public:
 
 std::unique_ptr<WSDoor>
 make_WSDoor (HTTP::Port const& port, Resource::Manager& resourceManager,
-    InfoSub::Source& source);
+    InfoSub::Source& source, boost::asio::io_service& io_service);
 
 }
 
@@ -138,6 +138,12 @@ public:
                 cpClient, mpMessage));
     }
 
+    static void ssendp (connection_ptr cpClient,
+                        InfoSub::MessagePtr const& spMessage, bool broadcast)
+    {
+        ssendb (cpClient, *spMessage, broadcast);
+    }
+
     void send (connection_ptr cpClient, std::string const& strMessage,
                bool broadcast)
     {
@@ -147,6 +153,46 @@ public:
                 broadcast));
     }
 
+    // The shared buffer crosses to the connection's strand by reference
+    // count; nothing is copied per subscriber until the socket write.
+    void send (connection_ptr cpClient, InfoSub::MessagePtr const& spMessage,
+               bool broadcast)
+    {
+        cpClient->get_strand ().post (
+            std::bind (
+                &WSServerHandler<endpoint_type>::ssendp, cpClient, spMessage,
+                broadcast));
+    }
+
+    static void ssendbin (connection_ptr cpClient,
+                          InfoSub::MessagePtr const& spMessage, bool broadcast)
+    {
+        try
+        {
+            WriteLog (broadcast ? lsTRACE : lsDEBUG, WSServerHandlerLog)
+                    << "Ws:: Sending binary, " << spMessage->size ()
+                    << " bytes";
+
+            cpClient->send (*spMessage, websocketpp::frame::opcode::BINARY);
+        }
+        catch (...)
+        {
+            cpClient->close (websocketpp::close::status::value (crTooSlow),
+                             std::string ("Client is too slow."));
+        }
+    }
+
+    // Deliver a shared buffer as a binary frame, for subscribers that
+    // negotiated binary transaction delivery.
+    void sendBinary (connection_ptr cpClient,
+                     InfoSub::MessagePtr const& spMessage, bool broadcast)
+    {
+        cpClient->get_strand ().post (
+            std::bind (
+                &WSServerHandler<endpoint_type>::ssendbin, cpClient,
+                spMessage, broadcast));
+    }
+
     void send (connection_ptr cpClient, Json::Value const& jvObj, bool broadcast)
     {
         send (cpClient, to_string (jvObj), broadcast);
@@ -22,6 +22,9 @@
 
 #include <beast/utility/LeakChecked.h>
 #include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -50,19 +53,24 @@ public:
 
         virtual ~CounterBase ();
 
-        int increment () noexcept
+        void increment () noexcept
         {
-            return ++m_count;
+            cell ().fetch_add (1, std::memory_order_relaxed);
         }
 
-        int decrement () noexcept
+        void decrement () noexcept
         {
-            return --m_count;
+            cell ().fetch_sub (1, std::memory_order_relaxed);
         }
 
         int getCount () const noexcept
         {
-            return m_count.load ();
+            int count (0);
+
+            for (int i = 0; i < cellCount; ++i)
+                count += m_cells [i].count.load (std::memory_order_relaxed);
+
+            return count;
         }
 
         CounterBase* getNext () const noexcept
@@ -75,8 +83,28 @@ public:
     private:
         virtual void checkPureVirtual () const = 0;
 
+        // Each thread updates the cell its id hashes to, so counting a
+        // hot type doesn't bounce one cache line between every thread.
+        // The true count is the sum over the cells; a single cell can
+        // go negative when an object is freed on a different thread
+        // than the one that made it.
+        enum { cellCount = 16 };
+
+        struct Cell
+        {
+            std::atomic <int> count;
+            char pad [64 - sizeof (std::atomic <int>)];
+        };
+
+        std::atomic <int>& cell () noexcept
+        {
+            return m_cells [std::hash <std::thread::id> () (
+                std::this_thread::get_id ()) % cellCount].count;
+        }
+
+        Cell m_cells [cellCount];
+
     protected:
-        std::atomic <int> m_count;
         CounterBase* m_next;
     };
 
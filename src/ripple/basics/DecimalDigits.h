@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_DECIMALDIGITS_H_INCLUDED
+#define RIPPLE_BASICS_DECIMALDIGITS_H_INCLUDED
+
+#include <cstdint>
+
+namespace ripple {
+
+/** Fast decimal formatting into caller-provided buffers.
+
+    std::to_string and the sprintf family dominate the profile when
+    serializing amount-rich JSON: they divide one digit at a time and
+    allocate or parse a format string on every call. These kernels emit
+    two digits per division from a lookup table and write straight into
+    the caller's buffer, so the only allocation left is the string the
+    caller builds from the result.
+*/
+
+/** Returns the table of all two-digit pairs, "00" through "99". */
+inline
+char const*
+digitPairs ()
+{
+    static char const pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    return pairs;
+}
+
+/** Returns the number of decimal digits in value. */
+inline
+unsigned
+numDecimalDigits (std::uint64_t value)
+{
+    unsigned digits = 1;
+
+    for (;;)
+    {
+        if (value < 10)
+            return digits;
+        if (value < 100)
+            return digits + 1;
+        if (value < 1000)
+            return digits + 2;
+        if (value < 10000)
+            return digits + 3;
+        value /= 10000;
+        digits += 4;
+    }
+}
+
+/** Write value in decimal into out.
+
+    The buffer must hold at least 20 characters. No terminator is
+    written.
+
+    @return One past the last character written.
+*/
+inline
+char*
+writeDecimal (char* out, std::uint64_t value)
+{
+    char const* const pairs = digitPairs ();
+    char* const end = out + numDecimalDigits (value);
+    char* pos = end;
+
+    while (value >= 100)
+    {
+        unsigned const pair = unsigned (value % 100) * 2;
+        value /= 100;
+        *--pos = pairs[pair + 1];
+        *--pos = pairs[pair];
+    }
+
+    if (value >= 10)
+    {
+        unsigned const pair = unsigned (value) * 2;
+        *--pos = pairs[pair + 1];
+        *--pos = pairs[pair];
+    }
+    else
+    {
+        *--pos = static_cast<char> ('0' + value);
+    }
+
+    return end;
+}
+
+/** Write value in decimal into out, with a leading minus if negative.
+
+    The buffer must hold at least 21 characters. No terminator is
+    written.
+
+    @return One past the last character written.
+*/
+inline
+char*
+writeDecimal (char* out, std::int64_t value)
+{
+    std::uint64_t magnitude = static_cast<std::uint64_t> (value);
+
+    if (value < 0)
+    {
+        *out++ = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    return writeDecimal (out, magnitude);
+}
+
+} // ripple
+
+#endif
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_LATENCYPROBES_H_INCLUDED
+#define RIPPLE_BASICS_LATENCYPROBES_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Always-on latency histograms for hot paths.
+
+    A probe is registered once by name and afterwards recorded into with
+    a single clock read and a relaxed atomic increment, cheap enough to
+    leave enabled in production. Samples land in power-of-two microsecond
+    buckets, so a snapshot shows the shape of each stage's latency, not
+    just its mean, without attaching an external profiler.
+
+    This deliberately mirrors @ref CountedObjects: a process-wide
+    registry that reporting code (see doGetCounts) snapshots on demand.
+*/
+class LatencyProbes
+{
+public:
+    enum
+    {
+        // Bucket n counts samples in [2^(n-1), 2^n) microseconds;
+        // the last bucket counts everything at or above ~4.3 minutes.
+        numBuckets = 28
+
+        // Registration is rare (startup, first use) and bounded; a
+        // fixed table keeps record() free of locks and reallocation.
+        ,maxProbes = 64
+    };
+
+    struct Snapshot
+    {
+        std::string name;
+        std::uint64_t count;
+        std::uint64_t totalMicroseconds;
+        std::uint64_t buckets [numBuckets];
+    };
+
+    typedef std::vector <Snapshot> List;
+
+    static LatencyProbes& getInstance ();
+
+    /** Register a probe, returning its index.
+        Registering the same name twice returns the same index.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    std::size_t probe (std::string const& name);
+
+    /** Record one sample for a probe.
+        Thread safety:
+            Safe to call from any thread, lock free.
+    */
+    void record (std::size_t index, std::uint64_t microseconds);
+
+    template <class Rep, class Period>
+    void record (std::size_t index,
+        std::chrono::duration <Rep, Period> const& elapsed)
+    {
+        record (index, static_cast <std::uint64_t> (std::max <std::int64_t> (
+            0, std::chrono::duration_cast <std::chrono::microseconds> (
+                elapsed).count ())));
+    }
+
+    /** Return a snapshot of every registered probe. */
+    List getCounts () const;
+
+private:
+    LatencyProbes ();
+
+    struct Slot
+    {
+        Slot ()
+            : count (0)
+            , total (0)
+        {
+            for (auto& bucket : buckets)
+                bucket.store (0, std::memory_order_relaxed);
+        }
+
+        std::string name;
+        std::atomic <std::uint64_t> count;
+        std::atomic <std::uint64_t> total;
+        std::atomic <std::uint64_t> buckets [numBuckets];
+    };
+
+    std::mutex mutable m_mutex;
+    std::atomic <std::size_t> m_used;
+    Slot m_slots [maxProbes];
+};
+
+//------------------------------------------------------------------------------
+
+/** Records the lifetime of the object into a probe. */
+class ScopedLatencyProbe
+{
+public:
+    explicit ScopedLatencyProbe (std::size_t index)
+        : m_index (index)
+        , m_start (std::chrono::steady_clock::now ())
+    {
+    }
+
+    ScopedLatencyProbe (ScopedLatencyProbe const&) = delete;
+    ScopedLatencyProbe& operator= (ScopedLatencyProbe const&) = delete;
+
+    ~ScopedLatencyProbe ()
+    {
+        LatencyProbes::getInstance ().record (m_index,
+            std::chrono::steady_clock::now () - m_start);
+    }
+
+private:
+    std::size_t m_index;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}
+
+#endif
@@ -25,8 +25,12 @@
 #include <beast/utility/Journal.h>
 #include <beast/utility/noexcept.h>
 #include <boost/filesystem.hpp>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
 #include <map>
 #include <mutex>
+#include <thread>
 #include <utility>
 
 namespace ripple {
@@ -140,14 +144,39 @@ private:
         boost::filesystem::path m_path;
     };
 
+    /** One queued log line, captured cheaply on the logging thread.
+        The timestamp is taken at enqueue; formatting and file I/O are
+        deferred to the writer thread so hot paths only pay for the
+        message string and a queue push.
+    */
+    struct Message
+    {
+        beast::Journal::Severity level;
+        std::string partition;
+        std::string text;
+        std::time_t when;
+    };
+
     std::mutex mutable mutex_;
     std::map <std::string, Sink, beast::ci_less> sinks_;
     beast::Journal::Severity level_;
     File file_;
 
+    // The writer thread and its bounded queue. When the queue is full
+    // further lines are counted and reported rather than blocking the
+    // logging thread.
+    std::mutex queueMutex_;
+    std::condition_variable queueCond_;
+    std::deque <Message> queue_;
+    std::size_t dropped_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+
 public:
     Logs();
 
+    ~Logs();
+
     Logs (Logs const&) = delete;
     Logs& operator= (Logs const&) = delete;
 
@@ -176,6 +205,10 @@ public:
     write (beast::Journal::Severity level, std::string const& partition,
         std::string const& text, bool console);
 
+    /** Block until every queued message has been written out. */
+    void
+    flush ();
+
     std::string
     rotate();
 
@@ -201,9 +234,15 @@ private:
     {
         // Maximum line length for log messages.
         // If the message exceeds this length it will be truncated with elipses.
-        maximumMessageCharacters = 12 * 1024
+        maximumMessageCharacters = 12 * 1024,
+
+        // Maximum number of queued messages awaiting the writer thread.
+        maximumQueuedMessages = 16 * 1024
     };
 
+    void
+    writeThread ();
+
     static
     std::string
     scrub (std::string s);
@@ -211,7 +250,8 @@ private:
     static
     void
     format (std::string& output, std::string const& message,
-        beast::Journal::Severity severity, std::string const& partition);
+        beast::Journal::Severity severity, std::string const& partition,
+        std::time_t when);
 };
 
 //------------------------------------------------------------------------------
@@ -223,8 +263,20 @@ deprecatedLogs()
     static Logs logs;
     return logs;
 }
+/** Compile-time log floor.
+    Statements below this severity compile out entirely: the constant
+    comparison folds to false and the dead stream expression - including
+    evaluation of its operands - is eliminated. Build with
+    -DRIPPLE_COMPILED_LOG_SEVERITY=2 (lsINFO) to make hot-path trace and
+    debug statements free on production builds.
+*/
+#ifndef RIPPLE_COMPILED_LOG_SEVERITY
+#define RIPPLE_COMPILED_LOG_SEVERITY 0 // lsTRACE: keep everything
+#endif
+
 // VFALCO DEPRECATED Inject beast::Journal instead
-#define ShouldLog(s, k) deprecatedLogs()[#k].active(Logs::toSeverity(s))
+#define ShouldLog(s, k) (((s) >= RIPPLE_COMPILED_LOG_SEVERITY) && \
+    deprecatedLogs()[#k].active(Logs::toSeverity(s)))
 #define WriteLog(s, k) if (!ShouldLog (s, k)) do {} while (0); else \
     beast::Journal::Stream(deprecatedLogs()[#k], Logs::toSeverity(s))
 #define CondLog(c, s, k) if (!ShouldLog (s, k) || !(c)) do {} while(0); else \
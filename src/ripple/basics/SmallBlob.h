@@ -0,0 +1,326 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SMALLBLOB_H_INCLUDED
+#define RIPPLE_BASICS_SMALLBLOB_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+namespace ripple {
+
+/** Storage for small binary data without heap allocation.
+
+    Most variable length fields are tiny — signatures run 72 bytes,
+    public keys 33, account IDs 20 — yet Blob heap-allocates for every
+    one. SmallBlob keeps payloads up to inlineBytes in an internal
+    buffer and only spills to the heap beyond that.
+*/
+class SmallBlob
+{
+public:
+    enum
+    {
+        // Large enough for a DER signature with slack to spare
+        inlineBytes = 80
+    };
+
+    typedef unsigned char        value_type;
+    typedef unsigned char*       iterator;
+    typedef unsigned char const* const_iterator;
+    typedef std::size_t          size_type;
+
+    SmallBlob ()
+        : m_data (m_inline)
+        , m_size (0)
+        , m_capacity (inlineBytes)
+    {
+    }
+
+    explicit SmallBlob (size_type size)
+        : m_data (m_inline)
+        , m_size (0)
+        , m_capacity (inlineBytes)
+    {
+        resize (size);
+    }
+
+    SmallBlob (unsigned char const* first, unsigned char const* last)
+        : m_data (m_inline)
+        , m_size (0)
+        , m_capacity (inlineBytes)
+    {
+        assign (first, last);
+    }
+
+    SmallBlob (Blob const& b)
+        : m_data (m_inline)
+        , m_size (0)
+        , m_capacity (inlineBytes)
+    {
+        assign (b.begin (), b.end ());
+    }
+
+    SmallBlob (SmallBlob const& other)
+        : m_data (m_inline)
+        , m_size (0)
+        , m_capacity (inlineBytes)
+    {
+        assign (other.begin (), other.end ());
+    }
+
+    SmallBlob (SmallBlob&& other)
+        : m_data (m_inline)
+        , m_size (other.m_size)
+        , m_capacity (inlineBytes)
+    {
+        if (other.m_data != other.m_inline)
+        {
+            // Steal the heap buffer
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.m_inline;
+            other.m_capacity = inlineBytes;
+        }
+        else if (m_size != 0)
+        {
+            memcpy (m_inline, other.m_inline, m_size);
+        }
+
+        other.m_size = 0;
+    }
+
+    SmallBlob& operator= (SmallBlob const& other)
+    {
+        if (this != &other)
+            assign (other.begin (), other.end ());
+        return *this;
+    }
+
+    SmallBlob& operator= (SmallBlob&& other)
+    {
+        if (this != &other)
+        {
+            clear ();
+
+            if (other.m_data != other.m_inline)
+            {
+                if (m_data != m_inline)
+                    delete [] m_data;
+                m_data = other.m_data;
+                m_capacity = other.m_capacity;
+                other.m_data = other.m_inline;
+                other.m_capacity = inlineBytes;
+            }
+            else if (other.m_size != 0)
+            {
+                memcpy (m_data, other.m_inline, other.m_size);
+            }
+
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    SmallBlob& operator= (Blob const& b)
+    {
+        assign (b.begin (), b.end ());
+        return *this;
+    }
+
+    ~SmallBlob ()
+    {
+        if (m_data != m_inline)
+            delete [] m_data;
+    }
+
+    unsigned char* data ()
+    {
+        return m_data;
+    }
+
+    unsigned char const* data () const
+    {
+        return m_data;
+    }
+
+    size_type size () const
+    {
+        return m_size;
+    }
+
+    bool empty () const
+    {
+        return m_size == 0;
+    }
+
+    iterator begin ()
+    {
+        return m_data;
+    }
+
+    const_iterator begin () const
+    {
+        return m_data;
+    }
+
+    iterator end ()
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator end () const
+    {
+        return m_data + m_size;
+    }
+
+    unsigned char& operator[] (size_type i)
+    {
+        return m_data[i];
+    }
+
+    unsigned char operator[] (size_type i) const
+    {
+        return m_data[i];
+    }
+
+    unsigned char& front ()
+    {
+        return m_data[0];
+    }
+
+    unsigned char front () const
+    {
+        return m_data[0];
+    }
+
+    /** Empty the container. The buffer is retained. */
+    void clear ()
+    {
+        m_size = 0;
+    }
+
+    void reserve (size_type n)
+    {
+        if (n > m_capacity)
+            grow (n);
+    }
+
+    /** Change the size; any added bytes are zero filled. */
+    void resize (size_type n)
+    {
+        reserve (n);
+
+        if (n > m_size)
+            memset (m_data + m_size, 0, n - m_size);
+
+        m_size = n;
+    }
+
+    void push_back (unsigned char c)
+    {
+        if (m_size == m_capacity)
+            grow (m_size + 1);
+
+        m_data[m_size++] = c;
+    }
+
+    template <class InputIt>
+    void assign (InputIt first, InputIt last)
+    {
+        m_size = 0;
+        append (first, last);
+    }
+
+    template <class InputIt>
+    void append (InputIt first, InputIt last)
+    {
+        size_type const n (std::distance (first, last));
+        reserve (m_size + n);
+        std::copy (first, last, m_data + m_size);
+        m_size += n;
+    }
+
+    /** Insert a range before pos, vector style. */
+    template <class InputIt>
+    iterator insert (iterator pos, InputIt first, InputIt last)
+    {
+        size_type const at (pos - m_data);
+        size_type const n (std::distance (first, last));
+
+        assert (at <= m_size);
+
+        reserve (m_size + n);
+        memmove (m_data + at + n, m_data + at, m_size - at);
+        std::copy (first, last, m_data + at);
+        m_size += n;
+
+        return m_data + at;
+    }
+
+    /** Return a copy of the contents as a Blob. */
+    Blob to_blob () const
+    {
+        return Blob (begin (), end ());
+    }
+
+private:
+    void grow (size_type need)
+    {
+        size_type newCapacity (m_capacity * 2);
+
+        if (newCapacity < need)
+            newCapacity = need;
+
+        unsigned char* newData (new unsigned char [newCapacity]);
+
+        if (m_size != 0)
+            memcpy (newData, m_data, m_size);
+
+        if (m_data != m_inline)
+            delete [] m_data;
+
+        m_data = newData;
+        m_capacity = newCapacity;
+    }
+
+    unsigned char* m_data;
+    size_type m_size;
+    size_type m_capacity;
+    unsigned char m_inline [inlineBytes];
+};
+
+inline bool operator== (SmallBlob const& lhs, SmallBlob const& rhs)
+{
+    return (lhs.size () == rhs.size ()) &&
+        (memcmp (lhs.data (), rhs.data (), lhs.size ()) == 0);
+}
+
+inline bool operator!= (SmallBlob const& lhs, SmallBlob const& rhs)
+{
+    return ! (lhs == rhs);
+}
+
+}
+
+#endif
@@ -24,6 +24,7 @@
 #include <ripple/basics/Blob.h>
 #include <ripple/basics/strHex.h>
 #include <boost/format.hpp>
+#include <boost/utility/string_ref.hpp>
 #include <beast/module/core/text/StringPairArray.h>
 #include <string>
 
@@ -96,6 +97,16 @@ inline static std::string sqlEscape (Blob const& vecSrc)
     return j;
 }
 
+/** Decode a hex string into `out`.
+
+    Works over a view and decodes straight into the result with one
+    reservation, so callers can hand over any substring without
+    copying it into a fresh string first. An odd-length input is
+    treated as having a leading zero nibble. Returns false, leaving
+    `out` empty, if the input contains a non-hex character.
+*/
+bool strUnHex (Blob& out, boost::string_ref in);
+
 int strUnHex (std::string& strDst, std::string const& strSrc);
 
 uint64_t uintFromHex (std::string const& strSrc);
@@ -43,6 +43,10 @@ struct TaggedCacheLog;
     If it stays in memory even after it is ejected from the cache,
     the map will track it.
 
+    The map is sharded into partitions selected by key hash, each with
+    its own lock, so concurrent operations on different keys do not
+    convoy on a single mutex. Operations on a single key remain atomic.
+
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
 */
@@ -69,6 +73,12 @@ public:
     typedef std::shared_ptr <mapped_type> mapped_ptr;
     typedef beast::abstract_clock <std::chrono::steady_clock> clock_type;
 
+    enum
+    {
+        // Number of internal partitions, must be a power of two
+        partitionCount = 16
+    };
+
 public:
     // VFALCO TODO Change expiration_seconds to clock_type::duration
     TaggedCache (std::string const& name, int size,
@@ -82,10 +92,13 @@ public:
         , m_name (name)
         , m_target_size (size)
         , m_target_age (std::chrono::seconds (expiration_seconds))
-        , m_cache_count (0)
-        , m_hits (0)
-        , m_misses (0)
+        , m_retain_referenced (false)
+        , m_sweep_cursor (0)
     {
+        // Size the bucket arrays up front. The big caches hold millions
+        // of entries; growing to that size incrementally means a long
+        // series of rehashes and page faults right after a restart.
+        rehashPartitions (size);
     }
 
 public:
@@ -103,11 +116,12 @@ public:
 
     void setTargetSize (int s)
     {
-        lock_guard lock (m_mutex);
-        m_target_size = s;
+        {
+            lock_guard lock (m_mutex);
+            m_target_size = s;
+        }
 
-        if (s > 0)
-            m_cache.rehash (static_cast<std::size_t> ((s + (s >> 2)) / m_cache.max_load_factor () + 1));
+        rehashPartitions (s);
 
         if (m_journal.debug) m_journal.debug <<
             m_name << " target size set to " << s;
@@ -119,6 +133,22 @@ public:
         return m_target_age.count();
     }
 
+    /** Retain entries that are still referenced outside the cache.
+
+        When set, sweep will not evict an expired entry whose object is
+        shared: such an entry is pinned by a live ledger (for tree nodes,
+        reachable from the open or a recent validated ledger), evicting
+        it frees no memory, and the next fetch would have to promote it
+        back from a weak pointer or refetch it from the node store.
+        Entries become evictable as soon as the last outside reference
+        goes away.
+    */
+    void setRetainReferenced (bool retain)
+    {
+        lock_guard lock (m_mutex);
+        m_retain_referenced = retain;
+    }
+
     void setTargetAge (clock_type::rep s)
     {
         lock_guard lock (m_mutex);
@@ -129,79 +159,142 @@ public:
 
     int getCacheSize ()
     {
-        lock_guard lock (m_mutex);
-        return m_cache_count;
+        int count = 0;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            count += p.cache_count;
+        }
+        return count;
     }
 
     int getTrackSize ()
     {
-        lock_guard lock (m_mutex);
-        return m_cache.size ();
+        int count = 0;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            count += p.cache.size ();
+        }
+        return count;
     }
 
     float getHitRate ()
     {
-        lock_guard lock (m_mutex);
-        auto const total = static_cast<float> (m_hits + m_misses);
-        return m_hits * (100.0f / std::max (1.0f, total));
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            hits += p.hits;
+            misses += p.misses;
+        }
+        auto const total = static_cast<float> (hits + misses);
+        return hits * (100.0f / std::max (1.0f, total));
     }
 
     void clearStats ()
     {
-        lock_guard lock (m_mutex);
-        m_hits = 0;
-        m_misses = 0;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            p.hits = 0;
+            p.misses = 0;
+        }
     }
 
     void clear ()
     {
-        lock_guard lock (m_mutex);
-        m_cache.clear ();
-        m_cache_count = 0;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            p.cache.clear ();
+            p.cache_count = 0;
+        }
     }
 
     void sweep ()
+    {
+        sweepSlice (partitionCount);
+    }
+
+    /** Sweep expired entries from a bounded slice of the cache.
+
+        Walks at most @a maxPartitions partitions, resuming from a
+        persistent cursor, so no single call holds any lock for longer
+        than one partition walk. Callers invoke this repeatedly from a
+        timer to cover the whole cache over a sweep interval instead of
+        paying for a full walk in one pause.
+
+        @return `true` if this call finished a pass over the cache (the
+                cursor reached the last partition and wrapped).
+    */
+    bool sweepSlice (int maxPartitions = 1)
     {
         int cacheRemovals = 0;
         int mapRemovals = 0;
-        int cc = 0;
 
         // Keep references to all the stuff we sweep
         // so that we can destroy them outside the lock.
         //
         std::vector <mapped_ptr> stuffToSweep;
 
-        {
-            clock_type::time_point const now (m_clock.now());
-            clock_type::time_point when_expire;
+        clock_type::time_point const now (m_clock.now());
 
+        int target_size;
+        clock_type::duration target_age;
+        bool retain_referenced;
+        int cursor;
+        {
             lock_guard lock (m_mutex);
+            target_size = m_target_size;
+            target_age = m_target_age;
+            retain_referenced = m_retain_referenced;
 
-            if (m_target_size == 0 ||
-                (static_cast<int> (m_cache.size ()) <= m_target_size))
-            {
-                when_expire = now - m_target_age;
-            }
-            else
-            {
-                when_expire = now - clock_type::duration (
-                    m_target_age.count() * m_target_size / m_cache.size ());
+            if (maxPartitions > partitionCount)
+                maxPartitions = partitionCount;
 
-                clock_type::duration const minimumAge (
-                    std::chrono::seconds (1));
-                if (when_expire > (now - minimumAge))
-                    when_expire = now - minimumAge;
+            cursor = m_sweep_cursor;
+            m_sweep_cursor = (m_sweep_cursor + maxPartitions) %
+                partitionCount;
+        }
 
-                if (m_journal.trace) m_journal.trace <<
-                    m_name << " is growing fast " << m_cache.size () << " of " << m_target_size <<
-                        " aging at " << (now - when_expire) << " of " << m_target_age;
-            }
+        int const trackSize = getTrackSize ();
 
-            stuffToSweep.reserve (m_cache.size ());
+        clock_type::time_point when_expire;
 
-            cache_iterator cit = m_cache.begin ();
+        if (target_size == 0 || (trackSize <= target_size))
+        {
+            when_expire = now - target_age;
+        }
+        else
+        {
+            when_expire = now - clock_type::duration (
+                target_age.count() * target_size / trackSize);
+
+            clock_type::duration const minimumAge (
+                std::chrono::seconds (1));
+            if (when_expire > (now - minimumAge))
+                when_expire = now - minimumAge;
+
+            if (m_journal.trace) m_journal.trace <<
+                m_name << " is growing fast " << trackSize << " of " << target_size <<
+                    " aging at " << (now - when_expire) << " of " << target_age;
+        }
+
+        // Each partition is swept under its own lock so other threads
+        // only stall on the shard currently being walked.
+        for (int i = 0; i < maxPartitions; ++i)
+        {
+            Partition& p = m_partitions [(cursor + i) % partitionCount];
 
-            while (cit != m_cache.end ())
+            lock_guard lock (p.mutex);
+
+            stuffToSweep.reserve (stuffToSweep.size () + p.cache.size ());
+
+            cache_iterator cit = p.cache.begin ();
+
+            while (cit != p.cache.end ())
             {
                 if (cit->second.isWeak ())
                 {
@@ -209,7 +302,7 @@ public:
                     if (cit->second.isExpired ())
                     {
                         ++mapRemovals;
-                        cit = m_cache.erase (cit);
+                        cit = p.cache.erase (cit);
                     }
                     else
                     {
@@ -218,47 +311,57 @@ public:
                 }
                 else if (cit->second.last_access <= when_expire)
                 {
-                    // strong, expired
-                    --m_cache_count;
-                    ++cacheRemovals;
-                    if (cit->second.ptr.unique ())
+                    if (retain_referenced && !cit->second.ptr.unique ())
                     {
-                        stuffToSweep.push_back (cit->second.ptr);
-                        ++mapRemovals;
-                        cit = m_cache.erase (cit);
+                        // strong, expired, but pinned by a live ledger
+                        ++cit;
                     }
                     else
                     {
-                        // remains weakly cached
-                        cit->second.ptr.reset ();
-                        ++cit;
+                        // strong, expired
+                        --p.cache_count;
+                        ++cacheRemovals;
+                        if (cit->second.ptr.unique ())
+                        {
+                            stuffToSweep.push_back (cit->second.ptr);
+                            ++mapRemovals;
+                            cit = p.cache.erase (cit);
+                        }
+                        else
+                        {
+                            // remains weakly cached
+                            cit->second.ptr.reset ();
+                            ++cit;
+                        }
                     }
                 }
                 else
                 {
                     // strong, not expired
-                    ++cc;
                     ++cit;
                 }
             }
         }
 
         if (m_journal.trace && (mapRemovals || cacheRemovals)) m_journal.trace <<
-            m_name << ": cache = " << m_cache.size () << "-" << cacheRemovals <<
-                ", map-=" << mapRemovals;
+            m_name << ": cache -= " << cacheRemovals <<
+                ", map -= " << mapRemovals;
 
         // At this point stuffToSweep will go out of scope outside the lock
         // and decrement the reference count on each strong pointer.
+
+        return (cursor + maxPartitions) >= partitionCount;
     }
 
     bool del (const key_type& key, bool valid)
     {
         // Remove from cache, if !valid, remove from map too. Returns true if removed from cache
-        lock_guard lock (m_mutex);
+        Partition& p = partition (key);
+        lock_guard lock (p.mutex);
 
-        cache_iterator cit = m_cache.find (key);
+        cache_iterator cit = p.cache.find (key);
 
-        if (cit == m_cache.end ())
+        if (cit == p.cache.end ())
             return false;
 
         Entry& entry = cit->second;
@@ -267,13 +370,13 @@ public:
 
         if (entry.isCached ())
         {
-            --m_cache_count;
+            --p.cache_count;
             entry.ptr.reset ();
             ret = true;
         }
 
         if (!valid || entry.isExpired ())
-            m_cache.erase (cit);
+            p.cache.erase (cit);
 
         return ret;
     }
@@ -295,16 +398,17 @@ public:
     {
         // Return canonical value, store if needed, refresh in cache
         // Return values: true=we had the data already
-        lock_guard lock (m_mutex);
+        Partition& p = partition (key);
+        lock_guard lock (p.mutex);
 
-        cache_iterator cit = m_cache.find (key);
+        cache_iterator cit = p.cache.find (key);
 
-        if (cit == m_cache.end ())
+        if (cit == p.cache.end ())
         {
-            m_cache.emplace (std::piecewise_construct,
+            p.cache.emplace (std::piecewise_construct,
                 std::forward_as_tuple(key),
                 std::forward_as_tuple(m_clock.now(), data));
-            ++m_cache_count;
+            ++p.cache_count;
             return false;
         }
 
@@ -341,13 +445,13 @@ public:
                 data = cachedData;
             }
 
-            ++m_cache_count;
+            ++p.cache_count;
             return true;
         }
 
         entry.ptr = data;
         entry.weak_ptr = data;
-        ++m_cache_count;
+        ++p.cache_count;
 
         return false;
     }
@@ -355,13 +459,14 @@ public:
     std::shared_ptr<T> fetch (const key_type& key)
     {
         // fetch us a shared pointer to the stored data object
-        lock_guard lock (m_mutex);
+        Partition& p = partition (key);
+        lock_guard lock (p.mutex);
 
-        cache_iterator cit = m_cache.find (key);
+        cache_iterator cit = p.cache.find (key);
 
-        if (cit == m_cache.end ())
+        if (cit == p.cache.end ())
         {
-            ++m_misses;
+            ++p.misses;
             return mapped_ptr ();
         }
 
@@ -370,7 +475,7 @@ public:
 
         if (entry.isCached ())
         {
-            ++m_hits;
+            ++p.hits;
             return entry.ptr;
         }
 
@@ -379,12 +484,12 @@ public:
         if (entry.isCached ())
         {
             // independent of cache size, so not counted as a hit
-            ++m_cache_count;
+            ++p.cache_count;
             return entry.ptr;
         }
 
-        m_cache.erase (cit);
-        ++m_misses;
+        p.cache.erase (cit);
+        ++p.misses;
         return mapped_ptr ();
     }
 
@@ -426,11 +531,12 @@ public:
         bool found = false;
 
         // If present, make current in cache
-        lock_guard lock (m_mutex);
+        Partition& p = partition (key);
+        lock_guard lock (p.mutex);
 
-        cache_iterator cit = m_cache.find (key);
+        cache_iterator cit = p.cache.find (key);
 
-        if (cit != m_cache.end ())
+        if (cit != p.cache.end ())
         {
             Entry& entry = cit->second;
 
@@ -442,7 +548,7 @@ public:
                 if (entry.isCached ())
                 {
                     // We just put the object back in cache
-                    ++m_cache_count;
+                    ++p.cache_count;
                     entry.touch (m_clock.now());
                     found = true;
                 }
@@ -450,7 +556,7 @@ public:
                 {
                     // Couldn't get strong pointer,
                     // object fell out of the cache so remove the entry.
-                    m_cache.erase (cit);
+                    p.cache.erase (cit);
                 }
             }
             else
@@ -468,6 +574,13 @@ public:
         return found;
     }
 
+    /** Return a mutex serializing compound operations.
+
+        Individual operations lock only the partition for their key;
+        this mutex exists so callers performing multi-step sequences
+        (check then insert, for example) can serialize against each
+        other. It is not taken by the cache's own member functions.
+    */
     mutex_type& peekMutex ()
     {
         return m_mutex;
@@ -477,10 +590,11 @@ public:
     {
         std::vector <key_type> v;
 
+        v.reserve (getTrackSize ());
+        for (Partition& p : m_partitions)
         {
-            lock_guard lock (m_mutex);
-            v.reserve (m_cache.size());
-            for (auto const& _ : m_cache)
+            lock_guard lock (p.mutex);
+            for (auto const& _ : p.cache)
                 v.push_back (_.first);
         }
 
@@ -495,10 +609,17 @@ private:
         {
             beast::insight::Gauge::value_type hit_rate (0);
             {
-                lock_guard lock (m_mutex);
-                auto const total (m_hits + m_misses);
+                std::uint64_t hits = 0;
+                std::uint64_t misses = 0;
+                for (Partition& p : m_partitions)
+                {
+                    lock_guard lock (p.mutex);
+                    hits += p.hits;
+                    misses += p.misses;
+                }
+                auto const total (hits + misses);
                 if (total != 0)
-                    hit_rate = (m_hits * 100) / total;
+                    hit_rate = (hits * 100) / total;
             }
             m_stats.hit_rate.set (hit_rate);
         }
@@ -545,10 +666,42 @@ private:
     typedef hardened_hash_map <key_type, Entry, Hash, KeyEqual> cache_type;
     typedef typename cache_type::iterator cache_iterator;
 
+    struct Partition
+    {
+        mutex_type mutable mutex;
+        cache_type cache;           // Hold strong reference to recent objects
+        int cache_count = 0;        // Number of items cached
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    Partition& partition (key_type const& key)
+    {
+        return m_partitions [m_hash (key) & (partitionCount - 1)];
+    }
+
+    // Reserve enough buckets in every partition to hold the target
+    // number of entries without further rehashing.
+    void rehashPartitions (int s)
+    {
+        if (s <= 0)
+            return;
+
+        int const perPartition = (s / partitionCount) + 1;
+        for (Partition& p : m_partitions)
+        {
+            lock_guard lock (p.mutex);
+            p.cache.rehash (static_cast<std::size_t> (
+                (perPartition + (perPartition >> 2)) /
+                    p.cache.max_load_factor () + 1));
+        }
+    }
+
     beast::Journal m_journal;
     clock_type& m_clock;
     Stats m_stats;
 
+    // Serializes compound operations by callers, see peekMutex
     mutex_type mutable m_mutex;
 
     // Used for logging
@@ -560,11 +713,14 @@ private:
     // Desired maximum cache age
     clock_type::duration m_target_age;
 
-    // Number of items cached
-    int m_cache_count;
-    cache_type m_cache;  // Hold strong reference to recent objects
-    std::uint64_t m_hits;
-    std::uint64_t m_misses;
+    // Keep expired entries strong while referenced outside the cache
+    bool m_retain_referenced;
+
+    // Next partition sweepSlice will walk
+    int m_sweep_cursor;
+
+    Hash m_hash;
+    Partition m_partitions [partitionCount];
 };
 
 }
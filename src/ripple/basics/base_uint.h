@@ -34,6 +34,8 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
 
 using beast::zero;
@@ -96,9 +98,80 @@ public:
     const_iterator cend()   const { return data()+bytes; }
 
     /** Value hashing function.
-        The seed prevents crafted inputs from causing degenarate parent containers.
+        The seed prevents crafted inputs from causing degenarate parent
+        containers. Unlike the generic byte-streaming hardened_hash, this
+        runs a reduced-round SipHash directly over the value's 64-bit
+        limbs: the width is fixed, so there is no buffering or length
+        bookkeeping per block.
     */
-    typedef beast::hardened_hash <> hasher;
+    class hasher
+    {
+    public:
+        typedef std::size_t result_type;
+
+        std::size_t
+        operator() (base_uint const& value) const noexcept
+        {
+            static beast::seed_pair const seeds (beast::get_seed_pair<> ());
+
+            std::uint64_t v0 = seeds.first  ^ 0x736f6d6570736575ULL;
+            std::uint64_t v1 = seeds.second ^ 0x646f72616e646f6dULL;
+            std::uint64_t v2 = seeds.first  ^ 0x6c7967656e657261ULL;
+            std::uint64_t v3 = seeds.second ^ 0x7465646279746573ULL;
+
+            std::size_t i = 0;
+
+            for (; i + 8 <= bytes; i += 8)
+            {
+                std::uint64_t m;
+                std::memcpy (&m, value.data () + i, 8);
+                v3 ^= m;
+                sipround (v0, v1, v2, v3);
+                v0 ^= m;
+            }
+
+            // The final block carries any leftover bytes and the width,
+            // as in the reference SipHash construction.
+            std::uint64_t last = std::uint64_t (bytes & 0xff) << 56;
+
+            if (i < bytes)
+            {
+                std::uint64_t tail = 0;
+                std::memcpy (&tail, value.data () + i, bytes - i);
+                last |= tail;
+            }
+
+            v3 ^= last;
+            sipround (v0, v1, v2, v3);
+            v0 ^= last;
+
+            v2 ^= 0xff;
+            sipround (v0, v1, v2, v3);
+            sipround (v0, v1, v2, v3);
+            sipround (v0, v1, v2, v3);
+
+            return static_cast<std::size_t> (v0 ^ v1 ^ v2 ^ v3);
+        }
+
+    private:
+        static
+        std::uint64_t
+        rotl (std::uint64_t x, int b) noexcept
+        {
+            return (x << b) | (x >> (64 - b));
+        }
+
+        static
+        void
+        sipround (std::uint64_t& v0, std::uint64_t& v1,
+            std::uint64_t& v2, std::uint64_t& v3) noexcept
+        {
+            v0 += v1; v1 = rotl (v1, 13); v1 ^= v0; v0 = rotl (v0, 32);
+            v2 += v3; v3 = rotl (v3, 16); v3 ^= v2;
+            v0 += v3; v3 = rotl (v3, 21); v3 ^= v0;
+            v2 += v1; v1 = rotl (v1, 17); v1 ^= v2; v2 = rotl (v2, 32);
+        }
+    };
 
     /** Container equality testing function. */
     class key_equal
@@ -413,17 +486,32 @@ template <std::size_t Bits, class Tag>
 inline int compare (
     base_uint<Bits, Tag> const& a, base_uint<Bits, Tag> const& b)
 {
-    auto ret = std::mismatch (a.cbegin (), a.cend (), b.cbegin ());
+    // The value is stored big-endian, so walking it in 64-bit limbs
+    // from the most significant end compares in numeric order.
+    std::size_t i = 0;
 
-    if (ret.first == a.cend ())
-        return 0;
+    for (; i + 8 <= base_uint<Bits, Tag>::bytes; i += 8)
+    {
+        std::uint64_t wa, wb;
+        std::memcpy (&wa, a.data () + i, 8);
+        std::memcpy (&wb, b.data () + i, 8);
 
-    // a > b
-    if (*ret.first > *ret.second)
-        return 1;
+        if (wa != wb)
+            return (be64toh (wa) < be64toh (wb)) ? -1 : 1;
+    }
+
+    // Widths that are not a multiple of 64 bits leave one 32-bit limb.
+    if (i < base_uint<Bits, Tag>::bytes)
+    {
+        std::uint32_t wa, wb;
+        std::memcpy (&wa, a.data () + i, 4);
+        std::memcpy (&wb, b.data () + i, 4);
+
+        if (wa != wb)
+            return (be32toh (wa) < be32toh (wb)) ? -1 : 1;
+    }
 
-    // a < b
-    return -1;
+    return 0;
 }
 
 template <std::size_t Bits, class Tag>
@@ -458,14 +546,15 @@ template <std::size_t Bits, class Tag>
 inline bool operator== (
     base_uint<Bits, Tag> const& a, base_uint<Bits, Tag> const& b)
 {
-    return compare (a, b) == 0;
+    return std::memcmp (a.data (), b.data (),
+        base_uint<Bits, Tag>::bytes) == 0;
 }
 
 template <std::size_t Bits, class Tag>
 inline bool operator!= (
     base_uint<Bits, Tag> const& a, base_uint<Bits, Tag> const& b)
 {
-    return compare (a, b) != 0;
+    return ! (a == b);
 }
 
 //------------------------------------------------------------------------------
@@ -537,7 +626,7 @@ struct hash<ripple::base_uint<Bits, Tag>>
     std::size_t
     operator()(argument_type const& u) const
     {
-        return beast::hardened_hash<>{}(u);
+        return typename argument_type::hasher{}(u);
     }
 };
 
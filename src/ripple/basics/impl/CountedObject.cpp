@@ -52,12 +52,15 @@ CountedObjects::List CountedObjects::getCounts (int minimumThreshold) const
 
     while (counter != nullptr)
     {
-        if (counter->getCount () >= minimumThreshold)
+        // Folding the per-thread cells isn't free, so do it once
+        int const objectCount = counter->getCount ();
+
+        if (objectCount >= minimumThreshold)
         {
             Entry entry;
 
             entry.first = counter->getName ();
-            entry.second = counter->getCount ();
+            entry.second = objectCount;
 
             counts.push_back (entry);
         }
@@ -71,8 +74,10 @@ CountedObjects::List CountedObjects::getCounts (int minimumThreshold) const
 //------------------------------------------------------------------------------
 
 CountedObjects::CounterBase::CounterBase ()
-    : m_count (0)
 {
+    for (int i = 0; i < cellCount; ++i)
+        m_cells [i].count.store (0, std::memory_order_relaxed);
+
     // Insert ourselves at the front of the lock-free linked list
 
     CountedObjects& instance = CountedObjects::getInstance ();
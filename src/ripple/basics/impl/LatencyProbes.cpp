@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/LatencyProbes.h>
+#include <cassert>
+
+namespace ripple {
+
+LatencyProbes& LatencyProbes::getInstance ()
+{
+    static LatencyProbes instance;
+
+    return instance;
+}
+
+LatencyProbes::LatencyProbes ()
+    : m_used (0)
+{
+}
+
+std::size_t LatencyProbes::probe (std::string const& name)
+{
+    std::lock_guard <std::mutex> lock (m_mutex);
+
+    std::size_t const used = m_used.load ();
+
+    for (std::size_t i = 0; i < used; ++i)
+    {
+        if (m_slots [i].name == name)
+            return i;
+    }
+
+    assert (used < maxProbes);
+    if (used >= maxProbes)
+        return maxProbes - 1;
+
+    m_slots [used].name = name;
+
+    // The name must be visible before record() can see the new size
+    m_used.store (used + 1);
+
+    return used;
+}
+
+void LatencyProbes::record (std::size_t index, std::uint64_t microseconds)
+{
+    if (index >= m_used.load (std::memory_order_relaxed))
+        return;
+
+    Slot& slot (m_slots [index]);
+
+    std::size_t bucket = 0;
+    std::uint64_t us = microseconds;
+    while ((us > 0) && (bucket < (numBuckets - 1)))
+    {
+        us >>= 1;
+        ++bucket;
+    }
+
+    slot.buckets [bucket].fetch_add (1, std::memory_order_relaxed);
+    slot.count.fetch_add (1, std::memory_order_relaxed);
+    slot.total.fetch_add (microseconds, std::memory_order_relaxed);
+}
+
+LatencyProbes::List LatencyProbes::getCounts () const
+{
+    List list;
+
+    std::size_t const used = m_used.load ();
+    list.reserve (used);
+
+    for (std::size_t i = 0; i < used; ++i)
+    {
+        Slot const& slot (m_slots [i]);
+        Snapshot entry;
+
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            entry.name = slot.name;
+        }
+        entry.count = slot.count.load (std::memory_order_relaxed);
+        entry.totalMicroseconds = slot.total.load (std::memory_order_relaxed);
+        for (std::size_t b = 0; b < numBuckets; ++b)
+            entry.buckets [b] = slot.buckets [b].load (
+                std::memory_order_relaxed);
+
+        list.push_back (entry);
+    }
+
+    return list;
+}
+
+}
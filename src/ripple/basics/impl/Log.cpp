@@ -111,6 +111,18 @@ Logs::Logs()
 {
 }
 
+Logs::~Logs()
+{
+    {
+        std::lock_guard <std::mutex> lock (queueMutex_);
+        stop_ = true;
+        queueCond_.notify_all ();
+    }
+
+    if (thread_.joinable ())
+        thread_.join ();
+}
+
 bool
 Logs::open (boost::filesystem::path const& pathToLogFile)
 {
@@ -170,14 +182,90 @@ void
 Logs::write (beast::Journal::Severity level, std::string const& partition,
     std::string const& text, bool console)
 {
-    std::string s;
-    format (s, text, level, partition);
-    std::lock_guard <std::mutex> lock (mutex_);
-    file_.writeln (s);
-    std::cerr << s << '\n';
-    // VFALCO TODO Fix console output
-    //if (console)
-    //    out_.write_console(s);
+    // Capture the line and hand it to the writer thread. Formatting
+    // and file I/O happen there; the logging thread pays only for the
+    // copies and a queue push.
+    Message m;
+    m.level = level;
+    m.partition = partition;
+    m.text = text;
+    m.when = time (nullptr);
+
+    {
+        std::lock_guard <std::mutex> lock (queueMutex_);
+
+        if (! thread_.joinable ())
+            thread_ = std::thread (&Logs::writeThread, this);
+
+        if (queue_.size () >= maximumQueuedMessages)
+            ++dropped_;
+        else
+            queue_.emplace_back (std::move (m));
+
+        queueCond_.notify_all ();
+    }
+
+    // A fatal message is likely the last thing this process says;
+    // don't leave it sitting in the queue.
+    if (level == beast::Journal::kFatal)
+        flush ();
+}
+
+void
+Logs::flush ()
+{
+    std::unique_lock <std::mutex> lock (queueMutex_);
+    queueCond_.wait (lock, [this] { return queue_.empty (); });
+}
+
+void
+Logs::writeThread ()
+{
+    std::unique_lock <std::mutex> lock (queueMutex_);
+
+    for (;;)
+    {
+        queueCond_.wait (lock, [this] { return stop_ || ! queue_.empty (); });
+
+        while (! queue_.empty ())
+        {
+            std::deque <Message> work;
+            std::swap (work, queue_);
+            std::size_t const dropped = dropped_;
+            dropped_ = 0;
+            lock.unlock ();
+
+            std::string s;
+            for (Message const& m : work)
+            {
+                format (s, m.text, m.level, m.partition, m.when);
+                std::lock_guard <std::mutex> fileLock (mutex_);
+                file_.writeln (s);
+                std::cerr << s << '\n';
+                // VFALCO TODO Fix console output
+                //if (console)
+                //    out_.write_console(s);
+            }
+
+            if (dropped != 0)
+            {
+                format (s, "Log queue overflowed; dropped " +
+                    std::to_string (dropped) + " messages",
+                    beast::Journal::kWarning, "Log", time (nullptr));
+                std::lock_guard <std::mutex> fileLock (mutex_);
+                file_.writeln (s);
+                std::cerr << s << '\n';
+            }
+
+            lock.lock ();
+        }
+
+        // Wake any flush() waiters now that the queue has drained
+        queueCond_.notify_all ();
+
+        if (stop_)
+            break;
+    }
 }
 
 std::string
@@ -294,12 +382,15 @@ Logs::scrub (std::string s)
 
 void
 Logs::format (std::string& output, std::string const& message,
-    beast::Journal::Severity severity, std::string const& partition)
+    beast::Journal::Severity severity, std::string const& partition,
+    std::time_t when)
 {
     output.reserve (message.size() + partition.size() + 100);
 
+    // The timestamp was captured when the message was queued, not when
+    // the writer thread got around to it.
     output = boost::posix_time::to_simple_string (
-        boost::posix_time::second_clock::universal_time ());
+        boost::posix_time::from_time_t (when));
 
     output += " ";
     if (! partition.empty ())
@@ -22,64 +22,98 @@
 #include <beast/unit_test/suite.h>
 #include <boost/asio/ip/address.hpp>
 #include <boost/regex.hpp>
+#include <algorithm>
 #include <cstdarg>
+#include <iterator>
 
 #include <ripple/basics/ToString.h>
 
 namespace ripple {
 
-// NIKB NOTE: This function is only used by strUnHex (std::string const& strSrc)
-// which results in a pointless copy from std::string into std::vector. Should
-// we just scrap this function altogether?
-int strUnHex (std::string& strDst, std::string const& strSrc)
+namespace {
+
+// Indexing a local table avoids an out-of-line call per nibble.
+struct UnHexTab
 {
-    std::string tmp;
+    signed char tab[256];
+
+    UnHexTab ()
+    {
+        std::fill (std::begin (tab), std::end (tab),
+            static_cast<signed char> (-1));
 
-    tmp.reserve ((strSrc.size () + 1) / 2);
+        for (int i = 0; i < 10; ++i)
+            tab['0' + i] = i;
 
-    auto iter = strSrc.cbegin ();
+        for (int i = 0; i < 6; ++i)
+        {
+            tab['A' + i] = 10 + i;
+            tab['a' + i] = 10 + i;
+        }
+    }
 
-    if (strSrc.size () & 1)
+    int operator[] (char c) const
     {
-        int c = charUnHex (*iter);
+        return tab[static_cast<unsigned char> (c)];
+    }
+};
+
+UnHexTab const unHexTab;
+
+}
+
+bool strUnHex (Blob& out, boost::string_ref in)
+{
+    out.clear ();
+    out.reserve ((in.size () + 1) / 2);
+
+    std::size_t i = 0;
+
+    if (in.size () & 1)
+    {
+        int const c = unHexTab[in[0]];
 
         if (c < 0)
-            return -1;
+            return false;
 
-        tmp.push_back(c);
-        ++iter;
+        out.push_back (c);
+        i = 1;
     }
 
-    while (iter != strSrc.cend ())
+    for (; i < in.size (); i += 2)
     {
-        int cHigh = charUnHex (*iter);
-        ++iter;
+        int const hi = unHexTab[in[i]];
+        int const lo = unHexTab[in[i + 1]];
 
-        if (cHigh < 0)
-            return -1;
+        // Either nibble failing decodes as a negative value
+        if ((hi | lo) < 0)
+        {
+            out.clear ();
+            return false;
+        }
 
-        int cLow = charUnHex (*iter);
-        ++iter;
+        out.push_back ((hi << 4) | lo);
+    }
 
-        if (cLow < 0)
-            return -1;
+    return true;
+}
 
-        tmp.push_back (static_cast<char>((cHigh << 4) | cLow));
-    }
+int strUnHex (std::string& strDst, std::string const& strSrc)
+{
+    Blob out;
 
-    strDst = std::move(tmp);
+    if (! strUnHex (out, strSrc))
+        return -1;
 
+    strDst.assign (out.begin (), out.end ());
     return strDst.size ();
 }
 
 std::pair<Blob, bool> strUnHex (std::string const& strSrc)
 {
-    std::string strTmp;
-
-    if (strUnHex (strTmp, strSrc) == -1)
-        return std::make_pair (Blob (), false);
-
-    return std::make_pair(strCopy (strTmp), true);
+    std::pair<Blob, bool> result;
+    result.second = strUnHex (result.first, strSrc);
+    return result;
 }
 
 uint64_t uintFromHex (std::string const& strSrc)
@@ -303,6 +337,22 @@ public:
         testUnHexFailure ("123X");
         testUnHexFailure ("V");
         testUnHexFailure ("XRP");
+
+        // The view overload decodes substrings without copying them out
+        std::string const wrapped ("xx0D0Axx");
+        Blob out;
+
+        expect (strUnHex (out, boost::string_ref (wrapped).substr (2, 4)),
+            "strUnHex: parsing correct view failed");
+
+        expect (out == Blob ({0x0d, 0x0a}),
+            "strUnHex: view doesn't produce expected result");
+
+        expect (! strUnHex (out, boost::string_ref (wrapped)),
+            "strUnHex: parsing incorrect view succeeded");
+
+        expect (out.empty (),
+            "strUnHex: parsing incorrect view returned data");
     }
 
     void testParseUrl ()
@@ -143,6 +143,26 @@ public:
             expect (c.getCacheSize() == 0);
             expect (c.getTrackSize() == 0);
         }
+
+        // Sweep incrementally: one slice per call must cover every
+        // partition in one full pass, wrapping exactly once.
+        {
+            for (int i = 0; i < 64; ++i)
+                c.insert (100 + i, "expired");
+
+            expect (c.getTrackSize() == 64);
+
+            ++clock;
+
+            int wraps = 0;
+            for (int i = 0; i < Cache::partitionCount; ++i)
+                if (c.sweepSlice ())
+                    ++wraps;
+
+            expect (wraps == 1);
+            expect (c.getCacheSize() == 0);
+            expect (c.getTrackSize() == 0);
+        }
     }
 };
 
@@ -291,13 +291,25 @@ initCommon (boost::asio::ssl::context& context)
         boost::asio::ssl::context::no_sslv3 |
         boost::asio::ssl::context::single_dh_use);
 
-    SSL_CTX_set_tmp_dh_callback (
-        context.native_handle (),
-        tmp_dh_handler);
+    SSL_CTX* const ctx = context.native_handle ();
 
-    SSL_CTX_set_info_callback (
-        context.native_handle (),
-        info_handler);
+    // Use our cipher order (AEAD suites first), not the client's
+    SSL_CTX_set_options (ctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+    // Let reconnecting peers resume with an abbreviated handshake,
+    // via tickets or the server side session cache, instead of all
+    // repeating the full key exchange at once after a network blip
+    SSL_CTX_clear_options (ctx, SSL_OP_NO_TICKET);
+    SSL_CTX_set_session_cache_mode (ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_timeout (ctx, 60 * 60);
+
+    static unsigned char const sessionContext[] = "rippled";
+    SSL_CTX_set_session_id_context (ctx,
+        sessionContext, sizeof (sessionContext) - 1);
+
+    SSL_CTX_set_tmp_dh_callback (ctx, tmp_dh_handler);
+
+    SSL_CTX_set_info_callback (ctx, info_handler);
 }
 
 static
@@ -469,9 +481,14 @@ make_SSLContext()
     std::shared_ptr<boost::asio::ssl::context> context =
         std::make_shared<boost::asio::ssl::context> (
             boost::asio::ssl::context::sslv23);
-    // By default, allow anonymous DH.
+    // By default, allow anonymous DH. The AES-GCM suites lead so that
+    // machines with AES instructions get an AEAD cipher; @STRENGTH's
+    // sort is stable, so they stay ahead of CBC at equal key length.
     openssl::detail::initAnonymous (
-        *context, "ALL:!LOW:!EXP:!MD5:@STRENGTH");
+        *context,
+        "AES256-GCM-SHA384:AES128-GCM-SHA256:"
+        "ADH-AES256-GCM-SHA384:ADH-AES128-GCM-SHA256:"
+        "ALL:!LOW:!EXP:!MD5:@STRENGTH");
     // VFALCO NOTE, It seems the WebSocket context never has
     // set_verify_mode called, for either setting of WEBSOCKET_SECURE
     context->set_verify_mode (boost::asio::ssl::verify_none);
@@ -54,6 +54,9 @@ charUnHex (char c)
 template<class Iterator>
 std::string strHex (Iterator first, int iSize)
 {
+    // Indexing a local table avoids an out-of-line call per nibble.
+    static char const xdigits[] = "0123456789ABCDEF";
+
     std::string strDst;
 
     strDst.resize (iSize * 2);
@@ -62,8 +65,8 @@ std::string strHex (Iterator first, int iSize)
     {
         unsigned char c = *first++;
 
-        strDst[i * 2]     = charHex (c >> 4);
-        strDst[i * 2 + 1] = charHex (c & 15);
+        strDst[i * 2]     = xdigits[c >> 4];
+        strDst[i * 2 + 1] = xdigits[c & 15];
     }
 
     return strDst;
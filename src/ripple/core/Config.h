@@ -192,6 +192,32 @@ public:
     */
     beast::StringPairArray ephemeralNodeDatabase;
 
+    /** Parameters for the hot tier of a tiered NodeStore database.
+
+        If present, recent-ledger nodes are written here and aged into
+        the database specified by @ref nodeDatabase in the background.
+        Place this on fast storage; unlike @ref ephemeralNodeDatabase
+        the contents must persist between launches.
+
+        The format is the same as that for @ref nodeDatabase
+
+        @see Database
+    */
+    beast::StringPairArray hotNodeDatabase;
+
+    /** Parameters for the history shard store.
+
+        If present, the server acquires and keeps a configurable number
+        of deterministic fixed-range history shards, each a
+        self-contained NodeStore database under the given path. The
+        'path' key is required; 'max_shards' bounds how many shards this
+        server holds and 'type' selects the backend, defaulting to the
+        type used by @ref nodeDatabase.
+
+        @see HistoryShards
+    */
+    beast::StringPairArray shardDatabase;
+
     /** Parameters for importing an old database in to the current node database.
         If this is not empty, then it specifies the key/value parameters for
         another node database from which to import all data into the current
@@ -203,6 +229,12 @@ public:
     bool doImport;
     beast::StringPairArray importNodeDatabase;
 
+    /** Path of a ledger state snapshot file to bulk-load at startup.
+        Written by the ledger_snapshot RPC on another node. Empty
+        means no snapshot import.
+    */
+    std::string importSnapshotPath;
+
     //
     //
     //--------------------------------------------------------------------------
@@ -251,12 +283,34 @@ public:
     */
     bool                        RUN_STANDALONE;
 
+    /** Operate as a read replica.
+
+        A replica follows the validated chain instead of arbitrating it.
+        Each ledger is acquired from peers as a header plus the changed
+        state-tree nodes and installed directly, so no consensus rounds
+        run and no transactions are re-executed locally. Transactions
+        submitted by this server's own clients are still forwarded to
+        the network, but transactions relayed by peers are ignored.
+    */
+    bool                        RUN_REPLICA;
+
+    /** Keep the ledger seq/hash index out of SQLite.
+
+        Ledger headers always go to the node store and the seq-to-hash
+        table is kept in a memory-mapped file, so with this set the
+        SQLite Ledgers table is not written at all and SQLite remains
+        in use only for transaction history. Lookups served by the
+        table and the node store never touch SQLite either way.
+    */
+    bool                        LEDGER_INDEX_NODESTORE;
+
     // Note: The following parameters do not relate to the UNL or trust at all
     std::size_t                 NETWORK_QUORUM;         // Minimum number of nodes to consider the network present
     int                         VALIDATION_QUORUM;      // Minimum validations to consider ledger authoritative
 
     // Peer networking parameters
     bool                        PEER_PRIVATE;           // True to ask peers not to relay current IP.
+    bool                        PEER_LEAF;              // True to receive but never relay; see [peer_leaf].
     unsigned int                PEERS_MAX;
 
     int                         WEBSOCKET_PING_FREQ;
@@ -294,6 +348,14 @@ public:
     std::uint32_t                      FETCH_DEPTH;
     int                         NODE_SIZE;
 
+    // Total cache memory budget in megabytes; 0 disables steering
+    std::uint32_t               MEMORY_BUDGET_MB;
+
+    // Background sync budgets; 0 disables the corresponding limit
+    int                         SYNC_FETCH_LIMIT;   // MB/s of peer ledger data
+    int                         SYNC_WRITE_LIMIT;   // node store writes per second
+    int                         SYNC_JOB_LIMIT;     // concurrent ledger data jobs
+
     // Client behavior
     int                         ACCOUNT_PROBE_MAX;      // How far to scan for accounts.
 
@@ -301,6 +363,25 @@ public:
     std::string                 SSL_VERIFY_FILE;
     std::string                 SSL_VERIFY_DIR;
 
+    std::string                 SIGNATURE_ENGINE;       // Signature verification backend.
+
+    int                         SQLITE_READERS;         // Pooled read connections per SQLite database.
+
+    // Thread placement. Each is a CPU list such as "0,2,8-15"; empty
+    // means the threads migrate freely. On multi socket hosts, keeping
+    // a group on one node keeps its working set on that node's memory.
+    std::string                 WORKERS_AFFINITY;       // Job queue workers.
+    std::string                 IO_WORKERS_AFFINITY;    // io_service threads.
+    std::string                 NODESTORE_AFFINITY;     // Node store read threads.
+
+    // io_service pool sizes. Peer sockets, client-facing servers and
+    // timers/background services each run on their own pool, so a
+    // burst of client traffic never queues ahead of consensus
+    // critical peer messages. 0 sizes a pool from node_size.
+    int                         IO_WORKERS;             // Peer overlay pool.
+    int                         CLIENT_IO_WORKERS;      // RPC and websocket pool.
+    int                         BACKGROUND_IO_WORKERS;  // Timers and fetches.
+
     std::string                 SMS_FROM;
     std::string                 SMS_KEY;
     std::string                 SMS_SECRET;
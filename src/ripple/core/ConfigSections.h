@@ -27,6 +27,8 @@ struct ConfigSection
 {
     static std::string nodeDatabase ()       { return "node_db"; }
     static std::string tempNodeDatabase ()   { return "temp_db"; }
+    static std::string hotNodeDatabase ()    { return "hot_db"; }
+    static std::string shardDatabase ()      { return "shard_db"; }
     static std::string importNodeDatabase () { return "import_db"; }
 };
 
@@ -43,6 +45,8 @@ struct ConfigSection
 #define SECTION_FEE_OWNER_RESERVE       "fee_owner_reserve"
 #define SECTION_FETCH_DEPTH             "fetch_depth"
 #define SECTION_LEDGER_HISTORY          "ledger_history"
+#define SECTION_LEDGER_INDEX_NODESTORE  "ledger_index_nodestore"
+#define SECTION_MEMORY_BUDGET_MB        "memory_budget_mb"
 #define SECTION_INSIGHT                 "insight"
 #define SECTION_IPS                     "ips"
 #define SECTION_IPS_FIXED               "ips_fixed"
@@ -53,16 +57,29 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX         "path_search_max"
+#define SECTION_PEER_LEAF               "peer_leaf"
 #define SECTION_PEER_PRIVATE            "peer_private"
 #define SECTION_PEERS_MAX               "peers_max"
+#define SECTION_SYNC_FETCH_LIMIT        "sync_fetch_limit"
+#define SECTION_SYNC_WRITE_LIMIT        "sync_write_limit"
+#define SECTION_SYNC_JOB_LIMIT          "sync_job_limit"
+#define SECTION_REPLICA                 "replica"
 #define SECTION_RPC_ADMIN_ALLOW         "rpc_admin_allow"
 #define SECTION_RPC_STARTUP             "rpc_startup"
+#define SECTION_SIGNATURE_ENGINE        "signature_engine"
 #define SECTION_SMS_FROM                "sms_from"
 #define SECTION_SMS_KEY                 "sms_key"
 #define SECTION_SMS_SECRET              "sms_secret"
 #define SECTION_SMS_TO                  "sms_to"
 #define SECTION_SMS_URL                 "sms_url"
 #define SECTION_SNTP                    "sntp_servers"
+#define SECTION_SQLITE_READERS          "sqlite_readers"
+#define SECTION_WORKERS_AFFINITY        "workers_affinity"
+#define SECTION_IO_WORKERS_AFFINITY     "io_workers_affinity"
+#define SECTION_NODESTORE_AFFINITY      "node_store_affinity"
+#define SECTION_IO_WORKERS              "io_workers"
+#define SECTION_CLIENT_IO_WORKERS       "client_io_workers"
+#define SECTION_BACKGROUND_IO_WORKERS   "background_io_workers"
 #define SECTION_SSL_VERIFY              "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE         "ssl_verify_file"
 #define SECTION_SSL_VERIFY_DIR          "ssl_verify_dir"
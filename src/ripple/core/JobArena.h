@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_JOBARENA_H_INCLUDED
+#define RIPPLE_CORE_JOBARENA_H_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+namespace ripple {
+
+/** A monotonic allocator for job-scoped scratch memory.
+
+    Allocation bumps a pointer within a chain of large blocks.
+    Individual frees are no-ops; memory is reclaimed wholesale by
+    reset(), which keeps the largest block so a steady-state worker
+    stops calling malloc altogether. Request-scoped temporaries then
+    cost a pointer bump each instead of a malloc/free pair.
+
+    Each JobQueue worker owns one arena and makes it active while it
+    runs a job, resetting it when the job finishes. An RPC coroutine
+    carries its own arena instead, so allocations made inside the
+    coroutine survive suspension even though the workers that resume
+    it reset their arenas between jobs.
+
+    Anything allocated from an arena must not outlive the job (or
+    coroutine) that allocated it.
+
+    Not thread safe. An arena may only be used from one thread at a
+    time; a coroutine's arena moves between workers, but only one
+    worker runs the coroutine at once.
+*/
+class JobArena
+{
+public:
+    enum
+    {
+        // Default size of each block. Big enough that a typical job
+        // never chains a second block, small enough that a parked
+        // worker doesn't hold a meaningful amount of memory.
+        blockBytes = 256 * 1024
+    };
+
+    JobArena () = default;
+    ~JobArena ();
+
+    JobArena (JobArena const&) = delete;
+    JobArena& operator= (JobArena const&) = delete;
+
+    /** Allocate `bytes` of uninitialized storage.
+
+        The result is aligned for any ordinary type. There is no
+        matching free; the storage lasts until reset().
+    */
+    void* allocate (std::size_t bytes);
+
+    /** Reclaim every allocation at once.
+
+        The largest block is kept for reuse so a worker in steady
+        state touches the heap only when a job outgrows it.
+    */
+    void reset ();
+
+    /** Bytes handed out since the last reset(). */
+    std::size_t used () const
+    {
+        return used_;
+    }
+
+    /** The arena installed on this thread, or nullptr. */
+    static JobArena* active ();
+
+    /** Makes an arena active on this thread for a scope.
+
+        Restores the previously active arena (usually none) on
+        destruction. Scopes may nest.
+    */
+    class ScopedActive
+    {
+    public:
+        explicit ScopedActive (JobArena& arena);
+        ~ScopedActive ();
+
+        ScopedActive (ScopedActive const&) = delete;
+        ScopedActive& operator= (ScopedActive const&) = delete;
+
+    private:
+        JobArena* saved_;
+    };
+
+    /** A std::allocator drop-in drawing from the active arena.
+
+        The arena (possibly none) is captured when the allocator is
+        constructed, so a container built inside a job keeps using
+        that job's arena no matter where it is touched afterwards.
+        With no active arena it falls back to the global heap, which
+        keeps arena-aware containers usable from any thread.
+    */
+    template <class T>
+    class allocator
+    {
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = T const*;
+        using reference = T&;
+        using const_reference = T const&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = allocator<U>;
+        };
+
+        allocator ()
+            : arena_ (JobArena::active ())
+        {
+        }
+
+        template <class U>
+        allocator (allocator<U> const& other)
+            : arena_ (other.arena ())
+        {
+        }
+
+        T* allocate (std::size_t n)
+        {
+            if (arena_)
+                return static_cast<T*> (
+                    arena_->allocate (n * sizeof (T)));
+            return static_cast<T*> (::operator new (n * sizeof (T)));
+        }
+
+        void deallocate (T* p, std::size_t)
+        {
+            if (! arena_)
+                ::operator delete (p);
+        }
+
+        JobArena* arena () const
+        {
+            return arena_;
+        }
+
+        template <class U>
+        bool operator== (allocator<U> const& other) const
+        {
+            return arena_ == other.arena ();
+        }
+
+        template <class U>
+        bool operator!= (allocator<U> const& other) const
+        {
+            return arena_ != other.arena ();
+        }
+
+    private:
+        JobArena* arena_;
+    };
+
+private:
+    struct Block;
+
+    // Start a new block with room for at least `bytes` and make it
+    // the head of the chain.
+    Block* grow (std::size_t bytes);
+
+    Block* head_ = nullptr;
+    std::size_t used_ = 0;
+};
+
+/** A string whose storage comes from the active job arena. */
+using ArenaString = std::basic_string <
+    char, std::char_traits<char>, JobArena::allocator<char>>;
+
+}
+
+#endif
@@ -20,7 +20,9 @@
 #ifndef RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
+#include <ripple/basics/LatencyProbes.h>
 #include <ripple/core/JobTypeInfo.h>
+#include <deque>
 
 namespace ripple
 {
@@ -37,6 +39,9 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
+    /* Waiting jobs of this type, oldest first */
+    std::deque <Job> jobs;
+
     /* The number of jobs waiting */
     int waiting;
 
@@ -46,17 +51,26 @@ public:
     /* And the number we deferred executing because of job limits */
     int deferred;
 
+    /* Jobs dropped unrun because they outlived their queue budget */
+    int shed;
+
     /* Notification callbacks */
     beast::insight::Event dequeue;
     beast::insight::Event execute;
 
+    /* Execution latency histogram (see doGetCounts) */
+    std::size_t probe;
+
     explicit JobTypeData (JobTypeInfo const& info_,
-            beast::insight::Collector::ptr const& collector) noexcept
+            beast::insight::Collector::ptr const& collector)
         : m_collector (collector)
         , info (info_)
         , waiting (0)
         , running (0)
         , deferred (0)
+        , shed (0)
+        , probe (LatencyProbes::getInstance ().probe (
+            "job." + info_.name ()))
     {
         m_load.setTargetLatency (
             info.getAverageLatency (),
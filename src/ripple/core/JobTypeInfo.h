@@ -43,12 +43,19 @@ private:
     std::uint64_t const m_avgLatency;
     std::uint64_t const m_peakLatency;
 
+    /** Queue time budget in milliseconds. A job of this type that waits
+        longer than this is shed instead of run; 0 means never shed.
+        Only meaningful for jobs whose work is re-obtainable.
+    */
+    std::uint64_t const m_queueBudget;
+
 public:
     // Not default constructible
     JobTypeInfo () = delete;
 
     JobTypeInfo (JobType type, std::string name, int limit,
-            bool skip, bool special, std::uint64_t avgLatency, std::uint64_t peakLatency)
+            bool skip, bool special, std::uint64_t avgLatency,
+            std::uint64_t peakLatency, std::uint64_t queueBudget = 0)
         : m_type (type)
         , m_name (name)
         , m_limit (limit)
@@ -56,6 +63,7 @@ public:
         , m_special (special)
         , m_avgLatency (avgLatency)
         , m_peakLatency (peakLatency)
+        , m_queueBudget (queueBudget)
     {
 
     }
@@ -94,6 +102,11 @@ public:
     {
         return m_peakLatency;
     }
+
+    std::uint64_t getQueueBudget () const
+    {
+        return m_queueBudget;
+    }
 };
 
 }
@@ -39,9 +39,15 @@ public:
     {
         int maxLimit = std::numeric_limits <int>::max ();
 
+        // The final column, where present, is the queue time budget in
+        // milliseconds: a job that waits longer than its budget is shed
+        // at dispatch instead of run. Budgets are only given to jobs
+        // whose input is re-obtainable or goes stale on its own, so a
+        // flood of them cannot hold threads away from consensus work.
+
         // Make a fetch pack for a peer
         add (jtPACK,          "makeFetchPack",
-            1,        true,   false, 0,     0);
+            1,        true,   false, 0,     0,    10000);
 
         // An old ledger has been accepted
         add (jtPUBOLDLEDGER,  "publishAcqLedger",
@@ -49,11 +55,11 @@ public:
 
         // A validation from an untrusted source
         add (jtVALIDATION_ut, "untrustedValidation",
-            maxLimit, true,   false, 2000,  5000);
+            maxLimit, true,   false, 2000,  5000, 5000);
 
         // A proof of work demand from another server
         add (jtPROOFWORK,     "proofOfWork",
-            maxLimit, true,   false, 2000,  5000);
+            maxLimit, true,   false, 2000,  5000, 5000);
 
         // A local transaction
         add (jtTRANSACTION_l, "localTransaction",
@@ -61,11 +67,12 @@ public:
 
         // A proposal from an untrusted source
         add (jtPROPOSAL_ut,   "untrustedProposal",
-            maxLimit, true,   false, 500,   1250);
+            maxLimit, true,   false, 500,   1250, 2500);
 
-        // Received data for a ledger we're acquiring
+        // Received data for a ledger we're acquiring; safe to shed
+        // because the acquire re-requests on its own timer
         add (jtLEDGER_DATA,   "ledgerData",
-            2,        true,   false, 0,     0);
+            2,        true,   false, 0,     0,    10000);
 
         // Update pathfinding requests
         add (jtUPDATE_PF,     "updatePaths",
@@ -210,7 +217,8 @@ public:
 
 private:
     void add(JobType jt, std::string name, int limit,
-        bool skip, bool special, std::uint64_t avgLatency, std::uint64_t peakLatency)
+        bool skip, bool special, std::uint64_t avgLatency,
+        std::uint64_t peakLatency, std::uint64_t queueBudget = 0)
     {
         assert (m_map.find (jt) == m_map.end ());
 
@@ -218,7 +226,7 @@ private:
             std::piecewise_construct,
             std::forward_as_tuple (jt),
             std::forward_as_tuple (jt, name, limit, skip, special,
-                avgLatency, peakLatency)));
+                avgLatency, peakLatency, queueBudget)));
 
         assert (result.second == true);
         (void) result.second;
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_SYNCGOVERNOR_H_INCLUDED
+#define RIPPLE_CORE_SYNCGOVERNOR_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+
+namespace ripple {
+
+/** Budgets background ledger acquisition.
+
+    A node that falls behind will spend every spare cycle catching up:
+    acquires fan requests out to every peer, the replies flood
+    jtLEDGER_DATA, and the node store write queue grows without bound,
+    all of it competing with the client service the node exists to
+    provide. The governor meters that pipeline against budgets from
+    the config (sync_fetch_limit, sync_write_limit, sync_job_limit)
+    and can be switched to express mode when a fast catch-up is wanted
+    and foreground latency is not.
+
+    Only background acquisition — history and generic fetches — is
+    governed. Ledgers needed for consensus or validation are always
+    fetched at full speed.
+*/
+class SyncGovernor
+{
+public:
+    /** Account ledger data received from peers. */
+    static void onLedgerData (std::size_t bytes);
+
+    /** Account a node store batch write, via the scheduler hook. */
+    static void onBatchWrite (int writeCount);
+
+    /** Returns true if background acquisition may send more requests. */
+    static bool mayRequest ();
+
+    /** The concurrency limit for ledger data jobs.
+        @param stockLimit the job type's built-in limit
+    */
+    static int ledgerDataJobLimit (int stockLimit);
+
+    /** Switch express mode on or off. */
+    static void setExpress (bool express);
+    static bool isExpress ();
+
+    /** Retune the budgets at runtime. Zero disables a budget. */
+    static void setFetchLimit (int mbPerSecond);
+    static void setWriteLimit (int writesPerSecond);
+
+    /** Report budgets and the rates seen over the last second. */
+    static Json::Value getInfo ();
+};
+
+} // ripple
+
+#endif
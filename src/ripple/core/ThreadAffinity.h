@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_THREADAFFINITY_H_INCLUDED
+#define RIPPLE_CORE_THREADAFFINITY_H_INCLUDED
+
+#include <string>
+
+namespace ripple {
+
+/** Pin the calling thread to a set of CPUs.
+
+    `cpuList` names the CPUs in the usual list syntax, for example
+    "0,2,8-15". On multi socket hosts, giving each thread group the
+    CPUs of one node keeps the group's working set (which is first
+    touched by those threads) on that node's memory.
+
+    An empty list is a no-op and succeeds. Returns false if the list
+    is malformed or the platform doesn't support thread affinity.
+*/
+bool setCurrentThreadAffinity (std::string const& cpuList);
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_TIMERWHEEL_H_INCLUDED
+#define RIPPLE_CORE_TIMERWHEEL_H_INCLUDED
+
+#include <beast/module/core/thread/DeadlineTimer.h>
+#include <functional>
+#include <memory>
+
+namespace ripple {
+
+struct TimerWheelItem;
+
+/** A hierarchical timer wheel for coarse, frequently rescheduled timers.
+
+    Subsystems that keep many timers in flight at once (ledger and
+    transaction set acquisition, peer liveness) register callbacks here
+    instead of arming individual kernel timers. The wheel is driven by a
+    single recurring tick, so scheduling and cancelling are O(1) list
+    operations regardless of how many timers exist.
+
+    Deadlines are rounded up to the tick resolution and callbacks may
+    fire up to one tick late; this is a wheel for timeouts, not for
+    precise scheduling. Callbacks run on the deadline timer's auxiliary
+    thread and must be cheap -- typically they enqueue a job or post to
+    a strand.
+
+    The wheel must outlive every Timer handle registered with it.
+*/
+class TimerWheel : private beast::DeadlineTimer::Listener
+{
+public:
+    typedef std::function <void ()> Callback;
+
+    /** Handle to a scheduled callback.
+
+        Destroying or cancelling the handle guarantees the callback will
+        not be invoked afterwards, except for an invocation already in
+        progress on the tick thread. A handle may be rescheduled freely;
+        each schedule replaces the previous one. Handles are not safe
+        for concurrent use from multiple threads.
+    */
+    class Timer
+    {
+    public:
+        Timer () = default;
+        Timer (Timer const&) = delete;
+        Timer& operator= (Timer const&) = delete;
+        ~Timer ();
+
+        /** Cancel the pending callback, if any. */
+        void cancel ();
+
+    private:
+        friend class TimerWheel;
+        TimerWheel* m_wheel = nullptr;
+        std::shared_ptr <TimerWheelItem> m_item;
+    };
+
+    /** Resolution of the wheel; deadlines are rounded up to this. */
+    static int const tickMilliseconds = 128;
+
+    TimerWheel ();
+    ~TimerWheel ();
+
+    /** Schedule a callback, replacing any previous schedule of the timer.
+
+        @param milliseconds Delay before the callback fires, rounded up
+                            to the tick resolution. Must be positive.
+    */
+    void schedule (Timer& timer, int milliseconds, Callback callback);
+
+    /** Returns the number of callbacks currently scheduled. */
+    std::size_t size () const;
+
+private:
+    void onDeadlineTimer (beast::DeadlineTimer&) override;
+    void cancelItem (std::shared_ptr <TimerWheelItem> const& item);
+
+    class Impl;
+    std::unique_ptr <Impl> m_impl;
+    beast::DeadlineTimer m_timer;
+};
+
+} // ripple
+
+#endif
@@ -234,6 +234,7 @@ Config::Config ()
     RPC_ADMIN_ALLOW.push_back (beast::IP::Endpoint::from_string("127.0.0.1"));
 
     PEER_PRIVATE            = false;
+    PEER_LEAF               = false;
     PEERS_MAX               = 0;    // indicates "use default"
 
     TRANSACTION_FEE_BASE    = DEFAULT_TRANSACTION_FEE_BASE;
@@ -241,6 +242,12 @@ Config::Config ()
     NETWORK_QUORUM          = 0;    // Don't need to see other nodes
     VALIDATION_QUORUM       = 1;    // Only need one node to vouch
 
+    SQLITE_READERS          = 4;
+
+    IO_WORKERS              = 0;    // indicates "use node_size"
+    CLIENT_IO_WORKERS       = 0;
+    BACKGROUND_IO_WORKERS   = 0;
+
     FEE_ACCOUNT_RESERVE     = DEFAULT_FEE_ACCOUNT_RESERVE;
     FEE_OWNER_RESERVE       = DEFAULT_FEE_OWNER_RESERVE;
     FEE_OFFER               = DEFAULT_FEE_OFFER;
@@ -249,6 +256,11 @@ Config::Config ()
 
     LEDGER_HISTORY          = 256;
     FETCH_DEPTH             = 1000000000;
+    MEMORY_BUDGET_MB        = 0;
+
+    SYNC_FETCH_LIMIT        = 0;
+    SYNC_WRITE_LIMIT        = 0;
+    SYNC_JOB_LIMIT          = 0;
 
     // An explanation of these magical values would be nice.
     PATH_SEARCH_OLD         = 7;
@@ -264,6 +276,8 @@ Config::Config ()
 
     ELB_SUPPORT             = false;
     RUN_STANDALONE          = false;
+    RUN_REPLICA             = false;
+    LEDGER_INDEX_NODESTORE  = false;
     doImport                = false;
     START_UP                = NORMAL;
 }
@@ -468,9 +482,18 @@ void Config::load ()
             if (getSingleSection (secConfig, SECTION_PEER_PRIVATE, strTemp))
                 PEER_PRIVATE        = beast::lexicalCastThrow <bool> (strTemp);
 
+            if (getSingleSection (secConfig, SECTION_PEER_LEAF, strTemp))
+                PEER_LEAF           = beast::lexicalCastThrow <bool> (strTemp);
+
             if (getSingleSection (secConfig, SECTION_PEERS_MAX, strTemp))
                 PEERS_MAX           = beast::lexicalCastThrow <int> (strTemp);
 
+            if (getSingleSection (secConfig, SECTION_REPLICA, strTemp))
+                RUN_REPLICA         = beast::lexicalCastThrow <bool> (strTemp);
+
+            if (getSingleSection (secConfig, SECTION_LEDGER_INDEX_NODESTORE, strTemp))
+                LEDGER_INDEX_NODESTORE = beast::lexicalCastThrow <bool> (strTemp);
+
             smtTmp = getIniFileSection (secConfig, SECTION_RPC_ADMIN_ALLOW);
 
             if (smtTmp)
@@ -491,6 +514,12 @@ void Config::load ()
             ephemeralNodeDatabase = parseKeyValueSection (
                 secConfig, ConfigSection::tempNodeDatabase ());
 
+            hotNodeDatabase = parseKeyValueSection (
+                secConfig, ConfigSection::hotNodeDatabase ());
+
+            shardDatabase = parseKeyValueSection (
+                secConfig, ConfigSection::shardDatabase ());
+
             importNodeDatabase = parseKeyValueSection (
                 secConfig, ConfigSection::importNodeDatabase ());
 
@@ -526,6 +555,24 @@ void Config::load ()
             getSingleSection (secConfig, SECTION_SSL_VERIFY_FILE, SSL_VERIFY_FILE);
             getSingleSection (secConfig, SECTION_SSL_VERIFY_DIR, SSL_VERIFY_DIR);
 
+            getSingleSection (secConfig, SECTION_SIGNATURE_ENGINE, SIGNATURE_ENGINE);
+
+            if (getSingleSection (secConfig, SECTION_SQLITE_READERS, strTemp))
+                SQLITE_READERS      = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
+            getSingleSection (secConfig, SECTION_WORKERS_AFFINITY, WORKERS_AFFINITY);
+            getSingleSection (secConfig, SECTION_IO_WORKERS_AFFINITY, IO_WORKERS_AFFINITY);
+            getSingleSection (secConfig, SECTION_NODESTORE_AFFINITY, NODESTORE_AFFINITY);
+
+            if (getSingleSection (secConfig, SECTION_IO_WORKERS, strTemp))
+                IO_WORKERS          = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
+            if (getSingleSection (secConfig, SECTION_CLIENT_IO_WORKERS, strTemp))
+                CLIENT_IO_WORKERS   = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
+            if (getSingleSection (secConfig, SECTION_BACKGROUND_IO_WORKERS, strTemp))
+                BACKGROUND_IO_WORKERS = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
             if (getSingleSection (secConfig, SECTION_SSL_VERIFY, strTemp))
                 SSL_VERIFY          = beast::lexicalCastThrow <bool> (strTemp);
 
@@ -598,6 +645,18 @@ void Config::load ()
                     FETCH_DEPTH = 10;
             }
 
+            if (getSingleSection (secConfig, SECTION_MEMORY_BUDGET_MB, strTemp))
+                MEMORY_BUDGET_MB = beast::lexicalCastThrow <std::uint32_t> (strTemp);
+
+            if (getSingleSection (secConfig, SECTION_SYNC_FETCH_LIMIT, strTemp))
+                SYNC_FETCH_LIMIT = beast::lexicalCastThrow <int> (strTemp);
+
+            if (getSingleSection (secConfig, SECTION_SYNC_WRITE_LIMIT, strTemp))
+                SYNC_WRITE_LIMIT = beast::lexicalCastThrow <int> (strTemp);
+
+            if (getSingleSection (secConfig, SECTION_SYNC_JOB_LIMIT, strTemp))
+                SYNC_JOB_LIMIT = beast::lexicalCastThrow <int> (strTemp);
+
             if (getSingleSection (secConfig, SECTION_PATH_SEARCH_OLD, strTemp))
                 PATH_SEARCH_OLD     = beast::lexicalCastThrow <int> (strTemp);
             if (getSingleSection (secConfig, SECTION_PATH_SEARCH, strTemp))
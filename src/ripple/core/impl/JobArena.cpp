@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/JobArena.h>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace ripple {
+
+namespace {
+
+// Every allocation is rounded up to this, and block payloads start on
+// such a boundary, so anything handed out is aligned for any ordinary
+// type.
+std::size_t const arenaAlignment = 16;
+
+std::size_t alignUp (std::size_t bytes)
+{
+    return (bytes + arenaAlignment - 1) & ~(arenaAlignment - 1);
+}
+
+// VS2013 has no thread_local keyword, so spell out this POD pointer
+// with the compiler-specific storage class.
+#ifdef _MSC_VER
+__declspec(thread) JobArena* activeArena = nullptr;
+#else
+__thread JobArena* activeArena = nullptr;
+#endif
+
+}
+
+// Blocks are carved from a single malloc: the header, padding up to
+// the alignment boundary, then `size` bytes of payload.
+struct JobArena::Block
+{
+    Block* next;
+    std::size_t size;
+    std::size_t used;
+
+    char* payload ()
+    {
+        return reinterpret_cast<char*> (this) + alignUp (sizeof (Block));
+    }
+};
+
+JobArena::~JobArena ()
+{
+    while (head_ != nullptr)
+    {
+        Block* const next = head_->next;
+        std::free (head_);
+        head_ = next;
+    }
+}
+
+void* JobArena::allocate (std::size_t bytes)
+{
+    bytes = alignUp (bytes ? bytes : 1);
+
+    if (head_ == nullptr || head_->used + bytes > head_->size)
+        grow (bytes);
+
+    char* const result = head_->payload () + head_->used;
+    head_->used += bytes;
+    used_ += bytes;
+    return result;
+}
+
+void JobArena::reset ()
+{
+    // Keep the largest block; free the rest. A worker in steady state
+    // has exactly one block and this is just three stores.
+    Block* largest = nullptr;
+    Block* block = head_;
+
+    while (block != nullptr)
+    {
+        Block* const next = block->next;
+
+        if (largest == nullptr || block->size > largest->size)
+            std::swap (largest, block);
+
+        if (block != nullptr)
+            std::free (block);
+
+        block = next;
+    }
+
+    if (largest != nullptr)
+    {
+        largest->next = nullptr;
+        largest->used = 0;
+    }
+
+    head_ = largest;
+    used_ = 0;
+}
+
+JobArena::Block* JobArena::grow (std::size_t bytes)
+{
+    std::size_t const size = std::max<std::size_t> (bytes, blockBytes);
+    Block* const block = static_cast<Block*> (
+        std::malloc (alignUp (sizeof (Block)) + size));
+
+    if (block == nullptr)
+        throw std::bad_alloc ();
+
+    block->next = head_;
+    block->size = size;
+    block->used = 0;
+    head_ = block;
+    return block;
+}
+
+JobArena* JobArena::active ()
+{
+    return activeArena;
+}
+
+JobArena::ScopedActive::ScopedActive (JobArena& arena)
+    : saved_ (activeArena)
+{
+    activeArena = &arena;
+}
+
+JobArena::ScopedActive::~ScopedActive ()
+{
+    activeArena = saved_;
+}
+
+}
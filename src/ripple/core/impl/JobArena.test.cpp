@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/JobArena.h>
+#include <beast/unit_test/suite.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ripple {
+
+class JobArena_test : public beast::unit_test::suite
+{
+public:
+    void testAllocate ()
+    {
+        testcase ("allocate");
+
+        JobArena arena;
+        expect (arena.used () == 0);
+
+        char* const a = static_cast<char*> (arena.allocate (100));
+        char* const b = static_cast<char*> (arena.allocate (100));
+        expect (a != nullptr && b != nullptr);
+
+        // Allocations must not overlap, and must be aligned for any
+        // ordinary type.
+        std::memset (a, 0xaa, 100);
+        std::memset (b, 0xbb, 100);
+        expect (a[99] == char (0xaa));
+        expect (reinterpret_cast<std::uintptr_t> (a) % 16 == 0);
+        expect (reinterpret_cast<std::uintptr_t> (b) % 16 == 0);
+        expect (arena.used () >= 200);
+
+        // An oversized request gets its own block
+        void* const big = arena.allocate (2 * JobArena::blockBytes);
+        expect (big != nullptr);
+        std::memset (big, 0xcc, 2 * JobArena::blockBytes);
+    }
+
+    void testReset ()
+    {
+        testcase ("reset");
+
+        JobArena arena;
+        arena.allocate (100);
+        arena.reset ();
+        expect (arena.used () == 0);
+
+        // The retained block is reused: steady state never grows
+        void* const first = arena.allocate (100);
+        arena.reset ();
+        expect (arena.allocate (100) == first);
+    }
+
+    void testActive ()
+    {
+        testcase ("active");
+
+        expect (JobArena::active () == nullptr);
+
+        JobArena outer;
+        JobArena inner;
+        {
+            JobArena::ScopedActive scope (outer);
+            expect (JobArena::active () == &outer);
+            {
+                JobArena::ScopedActive nested (inner);
+                expect (JobArena::active () == &inner);
+            }
+            expect (JobArena::active () == &outer);
+        }
+        expect (JobArena::active () == nullptr);
+    }
+
+    void testAllocator ()
+    {
+        testcase ("allocator");
+
+        // With no active arena the allocator uses the heap
+        {
+            std::vector <int, JobArena::allocator<int>> v;
+            v.assign (1000, 7);
+            expect (v[999] == 7);
+        }
+
+        JobArena arena;
+        {
+            JobArena::ScopedActive scope (arena);
+
+            std::vector <int, JobArena::allocator<int>> v;
+            v.assign (1000, 7);
+            expect (v[999] == 7);
+            expect (arena.used () >= 1000 * sizeof (int));
+
+            ArenaString s;
+            for (int i = 0; i < 100; ++i)
+                s += "some job-scoped text";
+            expect (s.size () == 100 * 20);
+        }
+        arena.reset ();
+        expect (arena.used () == 0);
+    }
+
+    void run ()
+    {
+        testAllocate ();
+        testReset ();
+        testActive ();
+        testAllocator ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(JobArena,core,ripple);
+
+}
@@ -17,15 +17,21 @@
 */
 //==============================================================================
 
+#include <ripple/core/Config.h>
+#include <ripple/core/JobArena.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/JobTypes.h>
+#include <ripple/core/ThreadAffinity.h>
 #include <ripple/core/JobTypeInfo.h>
 #include <ripple/core/JobTypeData.h>
+#include <ripple/core/SyncGovernor.h>
 
 #include <beast/cxx14/memory.h>
 #include <beast/chrono/chrono_util.h>
 #include <beast/module/core/thread/Workers.h>
 
+#include <boost/thread/tss.hpp>
+
 #include <chrono>
 #include <mutex>
 #include <set>
@@ -33,19 +39,29 @@
 
 namespace ripple {
 
+namespace {
+
+// Each worker thread gets a scratch arena on first use and keeps it
+// for the life of the thread. It is active while a job runs and reset
+// when the job finishes.
+boost::thread_specific_ptr <JobArena> workerArena;
+
+}
+
 class JobQueueImp
     : public JobQueue
     , private beast::Workers::Callback
 {
 public:
-    typedef std::set <Job> JobSet;
     typedef std::map <JobType, JobTypeData> JobDataMap;
     typedef std::lock_guard <std::mutex> ScopedLock;
 
     beast::Journal m_journal;
     std::mutex m_mutex;
     std::uint64_t m_lastJob;
-    JobSet m_jobSet;
+    // Waiting jobs live on per-type queues inside m_jobData;
+    // this tracks the total across all of them.
+    int m_queuedCount;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
@@ -74,6 +90,7 @@ public:
         : JobQueue ("JobQueue", parent)
         , m_journal (journal)
         , m_lastJob (0)
+        , m_queuedCount (0)
         , m_invalidJobData (getJobTypes ().getInvalid (), collector)
         , m_processCount (0)
         , m_workers (*this, "JobQueue", 0)
@@ -110,7 +127,7 @@ public:
     void collect ()
     {
         ScopedLock lock (m_mutex);
-        job_count = m_jobSet.size ();
+        job_count = m_queuedCount;
     }
 
     void addJob (JobType type, std::string const& name,
@@ -145,7 +162,7 @@ public:
             ScopedLock lock (m_mutex);
             assert (! isStopped() && (
                 m_processCount>0 ||
-                ! m_jobSet.empty () ||
+                m_queuedCount > 0 ||
                 ! areChildrenStopped()));
         }
 
@@ -162,10 +179,9 @@ public:
         {
             ScopedLock lock (m_mutex);
 
-            std::pair <std::set <Job>::iterator, bool> result (
-                m_jobSet.insert (Job (type, name, ++m_lastJob,
-                    data.load (), jobFunc, m_cancelCallback)));
-            queueJob (*result.first, lock);
+            data.jobs.push_back (Job (type, name, ++m_lastJob,
+                data.load (), jobFunc, m_cancelCallback));
+            queueJob (data, lock);
         }
     }
 
@@ -304,9 +320,11 @@ public:
 
             int waiting (data.waiting);
             int running (data.running);
+            int shed (data.shed);
 
             if ((stats.count != 0) || (waiting != 0) ||
-                (stats.latencyPeak != 0) || (running != 0))
+                (stats.latencyPeak != 0) || (running != 0) ||
+                (shed != 0))
             {
                 Json::Value& pri = priorities.append (Json::objectValue);
 
@@ -329,6 +347,9 @@ public:
 
                 if (running != 0)
                     pri["in_progress"] = running;
+
+                if (shed != 0)
+                    pri["shed"] = shed;
             }
         }
 
@@ -368,7 +389,7 @@ private:
         if (isStopping() &&
             areChildrenStopped() &&
             (m_processCount == 0) &&
-            m_jobSet.empty())
+            (m_queuedCount == 0))
         {
             stopped();
         }
@@ -380,8 +401,7 @@ private:
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
-    //  The Job must not have previously been queued.
+    //  The Job must have been pushed onto the type's queue.
     //
     // Post-conditions:
     //  Count of waiting jobs of that type will be incremented.
@@ -390,13 +410,11 @@ private:
     // Invariants:
     //  The calling thread owns the JobLock
     //
-    void queueJob (Job const& job, ScopedLock const& lock)
+    void queueJob (JobTypeData& data, ScopedLock const& lock)
     {
-        JobType const type (job.getType ());
+        JobType const type (data.type ());
         assert (type != jtINVALID);
-        assert (m_jobSet.find (job) != m_jobSet.end ());
-
-        JobTypeData& data (getJobTypeData (type));
+        assert (! data.jobs.empty ());
 
         if (data.waiting + data.running < getJobLimit (type))
         {
@@ -409,6 +427,7 @@ private:
             ++data.deferred;
         }
         ++data.waiting;
+        ++m_queuedCount;
     }
 
     //------------------------------------------------------------------------------
@@ -416,15 +435,15 @@ private:
     // Returns the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A queued Job whose slots count for its type is greater than zero.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  At least one Job is queued.
+    //  At least one queued Job is a RunnableJob.
     //
     // Post-conditions:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from its type's queue.
     //  Waiting job count of it's type is decremented
     //  Running job count of it's type is incremented
     //
@@ -433,35 +452,41 @@ private:
     //
     void getNextJob (Job& job, ScopedLock const& lock)
     {
-        assert (! m_jobSet.empty ());
-
-        JobSet::const_iterator iter;
-        for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+        assert (m_queuedCount > 0);
+
+        // Check the types from highest priority to lowest. Workers are
+        // not dedicated to a type: whichever type has the most urgent
+        // runnable job gets this thread, so a flood of one type cannot
+        // serialize dispatch of the others once its limit is reached.
+        JobDataMap::reverse_iterator iter;
+        for (iter = m_jobData.rbegin (); iter != m_jobData.rend (); ++iter)
         {
-            JobTypeData& data (getJobTypeData (iter->getType ()));
+            JobTypeData& data (iter->second);
 
             assert (data.running <= getJobLimit (data.type ()));
 
-            // Run this job if we're running below the limit.
-            if (data.running < getJobLimit (data.type ()))
+            // Run a job of this type if one is queued and we're
+            // running below the limit.
+            if (! data.jobs.empty () &&
+                (data.running < getJobLimit (data.type ())))
             {
                 assert (data.waiting > 0);
                 break;
             }
         }
 
-        assert (iter != m_jobSet.end ());
+        assert (iter != m_jobData.rend ());
 
-        JobType const type = iter->getType ();
-        JobTypeData& data (getJobTypeData (type));
+        JobTypeData& data (iter->second);
 
-        assert (type != jtINVALID);
+        assert (data.type () != jtINVALID);
 
-        job = *iter;
-        m_jobSet.erase (iter);
+        job = data.jobs.front ();
+        data.jobs.pop_front ();
 
         --data.waiting;
         ++data.running;
+        --m_queuedCount;
     }
 
     //------------------------------------------------------------------------------
@@ -469,7 +494,7 @@ private:
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not be on any type's queue.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -483,7 +508,6 @@ private:
     {
         JobType const type = job.getType ();
 
-        assert (m_jobSet.find (job) == m_jobSet.end ());
         assert (type != jtINVALID);
 
         JobTypeData& data (getJobTypeData (type));
@@ -521,12 +545,25 @@ private:
             getJobTypeData (type).execute.notify (ms);
     }
 
+    //--------------------------------------------------------------------------
+
+    void threadStarted ()
+    {
+        if (! setCurrentThreadAffinity (getConfig ().WORKERS_AFFINITY) &&
+            ! getConfig ().WORKERS_AFFINITY.empty ())
+        {
+            m_journal.warning <<
+                "Could not apply workers_affinity '" <<
+                getConfig ().WORKERS_AFFINITY << "'";
+        }
+    }
+
     //--------------------------------------------------------------------------
     //
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must be queued
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -552,14 +589,50 @@ private:
         if (!isStopping() || !data.info.skip ())
         {
             beast::Thread::setCurrentThreadName (data.name ());
-            m_journal.trace << "Doing " << data.name () << " job";
 
             Job::clock_type::time_point const start_time (
                 Job::clock_type::now());
 
-            on_dequeue (job.getType (), start_time - job.queue_time ());
-            job.doJob ();
-            on_execute (job.getType (), Job::clock_type::now() - start_time);
+            auto const queued (start_time - job.queue_time ());
+            std::uint64_t const budget (data.info.getQueueBudget ());
+
+            on_dequeue (job.getType (), queued);
+
+            if ((budget != 0) &&
+                (queued >= std::chrono::milliseconds (budget)))
+            {
+                // The job outlived its queue budget; its input is stale
+                // or re-obtainable, so shed it rather than spend a
+                // thread on it now
+                {
+                    ScopedLock lock (m_mutex);
+                    ++data.shed;
+                }
+
+                m_journal.warning << "Shed " << data.name () <<
+                    " job queued for " <<
+                    ceil <std::chrono::milliseconds> (queued).count () <<
+                    "ms (budget " << budget << "ms)";
+            }
+            else
+            {
+                m_journal.trace << "Doing " << data.name () << " job";
+
+                if (workerArena.get () == nullptr)
+                    workerArena.reset (new JobArena);
+
+                {
+                    JobArena::ScopedActive active (*workerArena);
+                    job.doJob ();
+                }
+
+                // Reclaim the job's scratch allocations in one sweep
+                workerArena->reset ();
+
+                auto const run_time (Job::clock_type::now() - start_time);
+                on_execute (job.getType (), run_time);
+                LatencyProbes::getInstance ().record (data.probe, run_time);
+            }
         }
         else
         {
@@ -600,6 +673,11 @@ private:
         JobTypeInfo const& j (getJobTypes ().get (type));
         assert (j.type () != jtINVALID);
 
+        // The sync governor can trade ledger data concurrency for
+        // foreground responsiveness, or raise it in express mode
+        if (type == jtLEDGER_DATA)
+            return SyncGovernor::ledgerDataJobLimit (j.limit ());
+
         return j.limit ();
     }
 
@@ -22,6 +22,7 @@
 
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/core/LoadFeeTrack.h>
+#include <atomic>
 #include <mutex>
 
 namespace ripple {
@@ -50,17 +51,20 @@ public:
         else                    // normal fee, multiply first for accuracy
             fee *= baseFee;
 
-        std::uint32_t feeFactor = std::max (mLocalTxnLoadFee, mRemoteTxnLoadFee);
+        // Fee state is read lock-free; this path runs for every
+        // transaction we admit.
+        std::uint32_t const localFee = mLocalTxnLoadFee.load ();
+        std::uint32_t const remoteFee = mRemoteTxnLoadFee.load ();
+        std::uint32_t const clusterFee = mClusterTxnLoadFee.load ();
+
+        std::uint32_t feeFactor = std::max (localFee, remoteFee);
 
         // Let admins pay the normal fee until the local load exceeds four times the remote
-        std::uint32_t uRemFee = std::max(mRemoteTxnLoadFee, mClusterTxnLoadFee);
+        std::uint32_t uRemFee = std::max(remoteFee, clusterFee);
         if (bAdmin && (feeFactor > uRemFee) && (feeFactor < (4 * uRemFee)))
             feeFactor = uRemFee;
 
-        {
-            ScopedLockType sl (mLock);
-            fee = mulDiv (fee, feeFactor, lftNormalFee);
-        }
+        fee = mulDiv (fee, feeFactor, lftNormalFee);
 
         if (big)                // Fee was big to start, must now multiply
             fee *= baseFee;
@@ -78,14 +82,12 @@ public:
 
     std::uint32_t getRemoteFee ()
     {
-        ScopedLockType sl (mLock);
-        return mRemoteTxnLoadFee;
+        return mRemoteTxnLoadFee.load ();
     }
 
     std::uint32_t getLocalFee ()
     {
-        ScopedLockType sl (mLock);
-        return mLocalTxnLoadFee;
+        return mLocalTxnLoadFee.load ();
     }
 
     std::uint32_t getLoadBase ()
@@ -95,91 +97,85 @@ public:
 
     std::uint32_t getLoadFactor ()
     {
-        ScopedLockType sl (mLock);
-        return std::max(mClusterTxnLoadFee, std::max (mLocalTxnLoadFee, mRemoteTxnLoadFee));
+        return std::max(mClusterTxnLoadFee.load (),
+            std::max (mLocalTxnLoadFee.load (), mRemoteTxnLoadFee.load ()));
     }
 
     void setClusterFee (std::uint32_t fee)
     {
-        ScopedLockType sl (mLock);
-        mClusterTxnLoadFee = fee;
+        mClusterTxnLoadFee.store (fee);
     }
 
     std::uint32_t getClusterFee ()
     {
-        ScopedLockType sl (mLock);
-        return mClusterTxnLoadFee;
+        return mClusterTxnLoadFee.load ();
     }
 
     bool isLoadedLocal ()
     {
-        // VFALCO TODO This could be replaced with a SharedData and
-        //             using a read/write lock instead of a critical section.
-        //
-        //        NOTE This applies to all the locking in this class.
-        //
-        //
-        ScopedLockType sl (mLock);
-        return (raiseCount != 0) || (mLocalTxnLoadFee != lftNormalFee);
+        return (raiseCount.load () != 0) ||
+            (mLocalTxnLoadFee.load () != lftNormalFee);
     }
 
     bool isLoadedCluster ()
     {
-        // VFALCO TODO This could be replaced with a SharedData and
-        //             using a read/write lock instead of a critical section.
-        //
-        //        NOTE This applies to all the locking in this class.
-        //
-        //
-        ScopedLockType sl (mLock);
-        return (raiseCount != 0) || (mLocalTxnLoadFee != lftNormalFee) || (mClusterTxnLoadFee != lftNormalFee);
+        return (raiseCount.load () != 0) ||
+            (mLocalTxnLoadFee.load () != lftNormalFee) ||
+            (mClusterTxnLoadFee.load () != lftNormalFee);
     }
 
     void setRemoteFee (std::uint32_t f)
     {
-        ScopedLockType sl (mLock);
-        mRemoteTxnLoadFee = f;
+        mRemoteTxnLoadFee.store (f);
     }
 
     bool raiseLocalFee ()
     {
+        // The lock serializes writers; readers never take it.
         ScopedLockType sl (mLock);
 
         if (++raiseCount < 2)
             return false;
 
-        std::uint32_t origFee = mLocalTxnLoadFee;
+        std::uint32_t const origFee = mLocalTxnLoadFee.load ();
+        std::uint32_t fee = origFee;
 
-        if (mLocalTxnLoadFee < mRemoteTxnLoadFee) // make sure this fee takes effect
-            mLocalTxnLoadFee = mRemoteTxnLoadFee;
+        if (fee < mRemoteTxnLoadFee.load ()) // make sure this fee takes effect
+            fee = mRemoteTxnLoadFee.load ();
 
-        mLocalTxnLoadFee += (mLocalTxnLoadFee / lftFeeIncFraction); // increment by 1/16th
+        fee += (fee / lftFeeIncFraction); // increment by 1/16th
 
-        if (mLocalTxnLoadFee > lftFeeMax)
-            mLocalTxnLoadFee = lftFeeMax;
+        if (fee > lftFeeMax)
+            fee = lftFeeMax;
 
-        if (origFee == mLocalTxnLoadFee)
+        if (origFee == fee)
             return false;
 
-        m_journal.debug << "Local load fee raised from " << origFee << " to " << mLocalTxnLoadFee;
+        mLocalTxnLoadFee.store (fee);
+
+        m_journal.debug << "Local load fee raised from " << origFee << " to " << fee;
         return true;
     }
 
     bool lowerLocalFee ()
     {
         ScopedLockType sl (mLock);
-        std::uint32_t origFee = mLocalTxnLoadFee;
+
+        std::uint32_t const origFee = mLocalTxnLoadFee.load ();
+        std::uint32_t fee = origFee;
         raiseCount = 0;
 
-        mLocalTxnLoadFee -= (mLocalTxnLoadFee / lftFeeDecFraction ); // reduce by 1/4
+        fee -= (fee / lftFeeDecFraction ); // reduce by 1/4
 
-        if (mLocalTxnLoadFee < lftNormalFee)
-            mLocalTxnLoadFee = lftNormalFee;
+        if (fee < lftNormalFee)
+            fee = lftNormalFee;
 
-        if (origFee == mLocalTxnLoadFee)
+        if (origFee == fee)
             return false;
 
-        m_journal.debug << "Local load fee lowered from " << origFee << " to " << mLocalTxnLoadFee;
+        mLocalTxnLoadFee.store (fee);
+
+        m_journal.debug << "Local load fee lowered from " << origFee << " to " << fee;
         return true;
     }
 
@@ -187,16 +183,13 @@ public:
     {
         Json::Value j (Json::objectValue);
 
-        {
-            ScopedLockType sl (mLock);
+        // base_fee = The cost to send a "reference" transaction under no load, in millionths of a Ripple
+        j[jss::base_fee] = Json::Value::UInt (baseFee);
 
-            // base_fee = The cost to send a "reference" transaction under no load, in millionths of a Ripple
-            j[jss::base_fee] = Json::Value::UInt (baseFee);
-
-            // load_fee = The cost to send a "reference" transaction now, in millionths of a Ripple
-            j[jss::load_fee] = Json::Value::UInt (
-                                mulDiv (baseFee, std::max (mLocalTxnLoadFee, mRemoteTxnLoadFee), lftNormalFee));
-        }
+        // load_fee = The cost to send a "reference" transaction now, in millionths of a Ripple
+        j[jss::load_fee] = Json::Value::UInt (
+                            mulDiv (baseFee, std::max (mLocalTxnLoadFee.load (),
+                                mRemoteTxnLoadFee.load ()), lftNormalFee));
 
         return j;
     }
@@ -223,14 +216,20 @@ private:
     static const int lftFeeMax = lftNormalFee * 1000000;
 
     beast::Journal m_journal;
+
+    // Writers serialize on the lock; every field is published atomically
+    // so the read paths (transaction admission, fee queries) are
+    // lock-free. The fees are independent scale factors combined with
+    // max(), so readers do not need a single consistent snapshot of all
+    // three.
     typedef std::mutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
     LockType mLock;
 
-    std::uint32_t mLocalTxnLoadFee;        // Scale factor, lftNormalFee = normal fee
-    std::uint32_t mRemoteTxnLoadFee;       // Scale factor, lftNormalFee = normal fee
-    std::uint32_t mClusterTxnLoadFee;      // Scale factor, lftNormalFee = normal fee
-    int raiseCount;
+    std::atomic <std::uint32_t> mLocalTxnLoadFee;   // Scale factor, lftNormalFee = normal fee
+    std::atomic <std::uint32_t> mRemoteTxnLoadFee;  // Scale factor, lftNormalFee = normal fee
+    std::atomic <std::uint32_t> mClusterTxnLoadFee; // Scale factor, lftNormalFee = normal fee
+    std::atomic <int> raiseCount;
 };
 
 } // ripple
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/SyncGovernor.h>
+#include <ripple/core/Config.h>
+#include <atomic>
+#include <ctime>
+
+namespace ripple {
+
+namespace {
+
+// Budgets, resolved from the config on first use. Zero disables a
+// budget. Everything is atomic: charges come in from network and job
+// threads while the acquire timers run the checks.
+std::atomic<bool> setupDone (false);
+std::atomic<int> fetchBudget (0);     // bytes of peer data per second
+std::atomic<int> writeBudget (0);     // node store writes per second
+std::atomic<int> jobBudget (0);       // jtLEDGER_DATA concurrency
+std::atomic<bool> expressMode (false);
+
+// One second accounting windows
+std::atomic<std::time_t> windowStart (0);
+std::atomic<int> windowBytes (0);
+std::atomic<int> windowWrites (0);
+
+// The rates over the last complete window, for reporting
+std::atomic<int> lastBytes (0);
+std::atomic<int> lastWrites (0);
+
+void ensureSetup ()
+{
+    if (setupDone.load ())
+        return;
+
+    fetchBudget = getConfig ().SYNC_FETCH_LIMIT * 1024 * 1024;
+    writeBudget = getConfig ().SYNC_WRITE_LIMIT;
+    jobBudget = getConfig ().SYNC_JOB_LIMIT;
+    setupDone = true;
+}
+
+void rollWindow ()
+{
+    std::time_t const now = std::time (nullptr);
+    std::time_t prev = windowStart.load ();
+
+    if ((prev != now) && windowStart.compare_exchange_strong (prev, now))
+    {
+        lastBytes = windowBytes.exchange (0);
+        lastWrites = windowWrites.exchange (0);
+    }
+}
+
+}
+
+void SyncGovernor::onLedgerData (std::size_t bytes)
+{
+    ensureSetup ();
+    rollWindow ();
+    windowBytes += static_cast<int> (bytes);
+}
+
+void SyncGovernor::onBatchWrite (int writeCount)
+{
+    ensureSetup ();
+    rollWindow ();
+    windowWrites += writeCount;
+}
+
+bool SyncGovernor::mayRequest ()
+{
+    ensureSetup ();
+
+    if (expressMode.load ())
+        return true;
+
+    rollWindow ();
+
+    int const fetch = fetchBudget.load ();
+
+    if ((fetch != 0) && (windowBytes.load () >= fetch))
+        return false;
+
+    // Every batch write counts here, including the ones ledger
+    // acceptance produces. That is deliberate: when the store is busy
+    // doing foreground work, acquisition is the load to shed.
+    int const writes = writeBudget.load ();
+
+    if ((writes != 0) && (windowWrites.load () >= writes))
+        return false;
+
+    return true;
+}
+
+int SyncGovernor::ledgerDataJobLimit (int stockLimit)
+{
+    ensureSetup ();
+
+    if (expressMode.load ())
+        return stockLimit * 2;
+
+    int const limit = jobBudget.load ();
+
+    if (limit > 0)
+        return limit;
+
+    return stockLimit;
+}
+
+void SyncGovernor::setExpress (bool express)
+{
+    ensureSetup ();
+    expressMode = express;
+}
+
+bool SyncGovernor::isExpress ()
+{
+    return expressMode.load ();
+}
+
+void SyncGovernor::setFetchLimit (int mbPerSecond)
+{
+    ensureSetup ();
+    fetchBudget = mbPerSecond * 1024 * 1024;
+}
+
+void SyncGovernor::setWriteLimit (int writesPerSecond)
+{
+    ensureSetup ();
+    writeBudget = writesPerSecond;
+}
+
+Json::Value SyncGovernor::getInfo ()
+{
+    ensureSetup ();
+    rollWindow ();
+
+    Json::Value ret (Json::objectValue);
+    ret["express"] = expressMode.load ();
+    ret["fetch_limit_mb"] = fetchBudget.load () / (1024 * 1024);
+    ret["write_limit"] = writeBudget.load ();
+    ret["job_limit"] = jobBudget.load ();
+    ret["fetch_bytes_per_sec"] = lastBytes.load ();
+    ret["writes_per_sec"] = lastWrites.load ();
+    return ret;
+}
+
+} // ripple
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/ThreadAffinity.h>
+#include <beast/module/core/text/LexicalCast.h>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ripple {
+
+bool setCurrentThreadAffinity (std::string const& cpuList)
+{
+    if (cpuList.empty ())
+        return true;
+
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO (&cpus);
+
+    bool any (false);
+
+    std::stringstream ss (cpuList);
+    std::string token;
+
+    while (std::getline (ss, token, ','))
+    {
+        if (token.empty ())
+            continue;
+
+        int first, last;
+
+        std::size_t const dash (token.find ('-'));
+
+        if (dash == std::string::npos)
+        {
+            if (! beast::lexicalCastChecked (first, token))
+                return false;
+            last = first;
+        }
+        else
+        {
+            if (! beast::lexicalCastChecked (
+                    first, token.substr (0, dash)) ||
+                ! beast::lexicalCastChecked (
+                    last, token.substr (dash + 1)))
+                return false;
+        }
+
+        if ((first < 0) || (last < first) || (last >= CPU_SETSIZE))
+            return false;
+
+        for (int i = first; i <= last; ++i)
+            CPU_SET (i, &cpus);
+
+        any = true;
+    }
+
+    if (! any)
+        return false;
+
+    return pthread_setaffinity_np (
+        pthread_self (), sizeof (cpus), &cpus) == 0;
+#else
+    // Thread placement isn't supported on this platform
+    return false;
+#endif
+}
+
+}
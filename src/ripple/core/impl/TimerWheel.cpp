@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/TimerWheel.h>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Wheel bookkeeping for one scheduled callback. */
+struct TimerWheelItem
+{
+    typedef std::list <std::shared_ptr <TimerWheelItem>> Slot;
+
+    TimerWheel::Callback callback;
+
+    // Absolute tick on which the callback fires
+    std::uint64_t deadline = 0;
+
+    // Where the item currently sits, or nullptr once fired or cancelled
+    Slot* slot = nullptr;
+    Slot::iterator iter;
+};
+
+//------------------------------------------------------------------------------
+
+/** The wheel proper.
+
+    Two levels of 256 slots each. Level zero holds deadlines within the
+    next 256 ticks, hashed by deadline modulo the wheel size. Deadlines
+    beyond that sit in level one, whose slots each span a full level
+    zero revolution; when the level zero cursor wraps, the next level
+    one slot is cascaded down. Everything here runs under one mutex;
+    callbacks are collected under the lock and invoked outside it.
+*/
+class TimerWheel::Impl
+{
+private:
+    static int const wheelBits = 8;
+    static int const wheelSize = 1 << wheelBits;
+
+    typedef TimerWheelItem Item;
+    typedef TimerWheelItem::Slot Slot;
+    typedef std::chrono::steady_clock clock_type;
+
+    std::mutex mutable m_mutex;
+    Slot m_level0 [wheelSize];
+    Slot m_level1 [wheelSize];
+    std::uint64_t m_ticks = 0;
+    std::size_t m_count = 0;
+    clock_type::time_point m_lastTick;
+
+public:
+    Impl ()
+        : m_lastTick (clock_type::now ())
+    {
+    }
+
+    void schedule (std::shared_ptr <Item> const& item,
+        int milliseconds, Callback callback)
+    {
+        assert (milliseconds > 0);
+
+        int ticks = (milliseconds + tickMilliseconds - 1) / tickMilliseconds;
+
+        if (ticks < 1)
+            ticks = 1;
+
+        // Past two revolutions the hashing would collide with itself
+        if (ticks > wheelSize * wheelSize - 1)
+            ticks = wheelSize * wheelSize - 1;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        remove (item);
+        item->callback = std::move (callback);
+        item->deadline = m_ticks + ticks;
+        insert (item);
+        ++m_count;
+    }
+
+    void cancel (std::shared_ptr <Item> const& item)
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        if (remove (item))
+            item->callback = nullptr;
+    }
+
+    std::size_t size () const
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_count;
+    }
+
+    void tick ()
+    {
+        std::vector <Callback> expired;
+
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+
+            auto const now = clock_type::now ();
+            auto const interval = std::chrono::milliseconds (tickMilliseconds);
+
+            // Catch up if notifications stalled
+            while (now - m_lastTick >= interval)
+            {
+                m_lastTick += interval;
+                advance (expired);
+            }
+        }
+
+        for (auto& callback : expired)
+            callback ();
+    }
+
+private:
+    // Caller holds the lock
+    bool remove (std::shared_ptr <Item> const& item)
+    {
+        if (item->slot == nullptr)
+            return false;
+
+        item->slot->erase (item->iter);
+        item->slot = nullptr;
+        --m_count;
+        return true;
+    }
+
+    // Caller holds the lock; m_count is adjusted by the caller
+    void insert (std::shared_ptr <Item> const& item)
+    {
+        Slot* slot;
+
+        if (item->deadline - m_ticks < wheelSize)
+            slot = &m_level0 [item->deadline % wheelSize];
+        else
+            slot = &m_level1 [(item->deadline >> wheelBits) % wheelSize];
+
+        slot->push_back (item);
+        item->slot = slot;
+        item->iter = std::prev (slot->end ());
+    }
+
+    // Caller holds the lock
+    void advance (std::vector <Callback>& expired)
+    {
+        ++m_ticks;
+
+        // When level zero wraps, pull the next level one slot down
+        if (m_ticks % wheelSize == 0)
+        {
+            Slot pending;
+            pending.swap (m_level1 [(m_ticks >> wheelBits) % wheelSize]);
+
+            for (auto& item : pending)
+            {
+                item->slot = nullptr;
+                insert (item);
+            }
+        }
+
+        Slot& slot = m_level0 [m_ticks % wheelSize];
+
+        for (auto iter = slot.begin (); iter != slot.end ();)
+        {
+            auto& item = *iter;
+
+            if (item->deadline <= m_ticks)
+            {
+                item->slot = nullptr;
+                --m_count;
+                expired.push_back (std::move (item->callback));
+                item->callback = nullptr;
+                iter = slot.erase (iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+TimerWheel::TimerWheel ()
+    : m_impl (std::make_unique <Impl> ())
+    , m_timer (this)
+{
+    m_timer.setRecurringExpiration (tickMilliseconds / 1000.0);
+}
+
+TimerWheel::~TimerWheel ()
+{
+    // No notifications occur after cancel returns
+    m_timer.cancel ();
+}
+
+void TimerWheel::schedule (Timer& timer, int milliseconds, Callback callback)
+{
+    if (! timer.m_item)
+    {
+        timer.m_wheel = this;
+        timer.m_item = std::make_shared <TimerWheelItem> ();
+    }
+
+    assert (timer.m_wheel == this);
+    m_impl->schedule (timer.m_item, milliseconds, std::move (callback));
+}
+
+std::size_t TimerWheel::size () const
+{
+    return m_impl->size ();
+}
+
+void TimerWheel::onDeadlineTimer (beast::DeadlineTimer&)
+{
+    m_impl->tick ();
+}
+
+void TimerWheel::cancelItem (std::shared_ptr <TimerWheelItem> const& item)
+{
+    m_impl->cancel (item);
+}
+
+//------------------------------------------------------------------------------
+
+TimerWheel::Timer::~Timer ()
+{
+    cancel ();
+}
+
+void TimerWheel::Timer::cancel ()
+{
+    if (m_item)
+        m_wheel->cancelItem (m_item);
+}
+
+} // ripple
@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/core/TimerWheel.h>
+#include <beast/unit_test/suite.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+
+class TimerWheel_test : public beast::unit_test::suite
+{
+public:
+    typedef std::chrono::milliseconds milliseconds_type;
+
+    // Wait for a condition with a generous deadline; the wheel only
+    // promises to fire within a tick or so of the requested delay.
+    template <class Predicate>
+    bool within (int milliseconds, Predicate pred)
+    {
+        using namespace std::chrono;
+        auto const deadline = steady_clock::now () +
+            milliseconds_type (milliseconds);
+
+        while (! pred ())
+        {
+            if (steady_clock::now () >= deadline)
+                return false;
+            std::this_thread::sleep_for (milliseconds_type (5));
+        }
+
+        return true;
+    }
+
+    void testFire ()
+    {
+        testcase ("fire");
+
+        TimerWheel wheel;
+        TimerWheel::Timer timer;
+        std::atomic <int> fired (0);
+
+        wheel.schedule (timer, 1, [&fired]() { ++fired; });
+        expect (wheel.size () == 1);
+
+        expect (within (2000, [&fired]() { return fired.load () == 1; }));
+        expect (wheel.size () == 0);
+
+        // Once fired, the timer does not fire again until rescheduled
+        std::this_thread::sleep_for (milliseconds_type (
+            3 * TimerWheel::tickMilliseconds));
+        expect (fired.load () == 1);
+    }
+
+    void testCancel ()
+    {
+        testcase ("cancel");
+
+        TimerWheel wheel;
+        TimerWheel::Timer timer;
+        std::atomic <int> fired (0);
+
+        wheel.schedule (timer, 60 * 1000, [&fired]() { ++fired; });
+        expect (wheel.size () == 1);
+
+        timer.cancel ();
+        expect (wheel.size () == 0);
+
+        // Cancelling twice is harmless
+        timer.cancel ();
+
+        std::this_thread::sleep_for (milliseconds_type (
+            3 * TimerWheel::tickMilliseconds));
+        expect (fired.load () == 0);
+    }
+
+    void testReschedule ()
+    {
+        testcase ("reschedule");
+
+        TimerWheel wheel;
+        TimerWheel::Timer timer;
+        std::atomic <int> slow (0);
+        std::atomic <int> fast (0);
+
+        // The second schedule replaces the first
+        wheel.schedule (timer, 60 * 1000, [&slow]() { ++slow; });
+        wheel.schedule (timer, 1, [&fast]() { ++fast; });
+        expect (wheel.size () == 1);
+
+        expect (within (2000, [&fast]() { return fast.load () == 1; }));
+        expect (slow.load () == 0);
+    }
+
+    void testDestroy ()
+    {
+        testcase ("destroy");
+
+        TimerWheel wheel;
+        std::atomic <int> fired (0);
+
+        {
+            TimerWheel::Timer timer;
+            wheel.schedule (timer, 60 * 1000, [&fired]() { ++fired; });
+        }
+
+        // The handle cancelled itself on destruction
+        expect (wheel.size () == 0);
+        expect (fired.load () == 0);
+    }
+
+    void run ()
+    {
+        testFire ();
+        testCancel ();
+        testReschedule ();
+        testDestroy ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TimerWheel,ripple_core,ripple);
+
+} // ripple
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CRYPTO_ED25519_H
+#define RIPPLE_CRYPTO_ED25519_H
+
+#include <ripple/basics/Blob.h>
+#include <cstddef>
+
+namespace ripple {
+
+/** Ed25519 signature verification.
+
+    Ed25519 public keys travel in the same serialized slots as
+    secp256k1 keys, distinguished by length and a leading type byte:
+    a 33 byte blob beginning with 0xED carries a 32 byte Ed25519 key.
+    That byte cannot begin a valid SEC1 compressed point (those start
+    with 0x02 or 0x03), so the key type is self-describing and needs
+    no separate negotiation.
+
+    Verification is backed by the linked OpenSSL when it is new enough
+    to provide Ed25519; otherwise every Ed25519 signature is reported
+    invalid, which peers experience as an ordinary verification
+    failure.
+*/
+
+/** Returns `true` if this build can verify Ed25519 signatures. */
+bool ed25519Available ();
+
+/** Returns `true` if the blob is a serialized Ed25519 public key. */
+bool isEd25519PublicKey (Blob const& pubkey);
+
+/** Verify an Ed25519 signature over a message.
+
+    @param pubkey The 32 byte public key, without the 0xED type byte.
+    @param msg The signed material.
+    @param sig The 64 byte signature.
+*/
+bool ed25519Verify (unsigned char const* pubkey,
+    void const* msg, std::size_t msgBytes, Blob const& sig);
+
+} // ripple
+
+#endif
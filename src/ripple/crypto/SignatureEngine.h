@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CRYPTO_SIGNATUREENGINE_H
+#define RIPPLE_CRYPTO_SIGNATUREENGINE_H
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Blob.h>
+#include <string>
+
+namespace ripple {
+
+/** Backend performing secp256k1 signature verification.
+
+    Signature verification is the server's largest single CPU cost:
+    every transaction, validation and proposal is checked here. The
+    backend is pluggable so a dedicated secp256k1 implementation can
+    be selected at startup without touching the call sites.
+*/
+class SignatureEngine
+{
+public:
+    virtual ~SignatureEngine () = default;
+
+    /** The name used to select this engine from the configuration. */
+    virtual std::string name () const = 0;
+
+    /** Verify a DER-encoded signature over the given hash.
+
+        The caller is responsible for canonicality checks; engines
+        only decide whether the signature is mathematically valid
+        for the serialized public key.
+    */
+    virtual bool verify (Blob const& pubkey, uint256 const& hash,
+        Blob const& sig) const = 0;
+};
+
+/** Returns the engine currently performing verification. */
+SignatureEngine& signatureEngine ();
+
+/** Selects the engine with the given name.
+
+    Returns `false`, leaving the current engine in place, if no
+    engine with that name is available.
+*/
+bool selectSignatureEngine (std::string const& name);
+
+} // ripple
+
+#endif
@@ -18,10 +18,12 @@
 //==============================================================================
 
 #include <ripple/crypto/Base58.h>
-#include <ripple/crypto/CAutoBN_CTX.h>
-#include <ripple/crypto/CBigNum.h>
+#include <ripple/basics/base_uint.h>
 #include <openssl/sha.h>
 
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -66,35 +68,140 @@ Base58::Alphabet const& Base58::getRippleAlphabet ()
     return alphabet;
 }
 
+//------------------------------------------------------------------------------
+
+// Multi-limb base conversion helpers. Values are held as arrays of 32 bit
+// limbs, least significant limb first. Everything we encode or decode
+// (account IDs, seeds and keys, plus version and check bytes) is small
+// enough that the arithmetic runs in a fixed workspace with no bignum
+// allocations.
+
+namespace {
+
+// 58^5, the largest power of 58 that fits in 32 bits. Dividing or
+// multiplying by it converts five base 58 digits per limb pass.
+std::uint32_t const base58to5 = 58 * 58 * 58 * 58 * 58;
+
+// Accumulate a base 58 string into limbs. Returns false if the value
+// does not fit in maxLimbs limbs. nLimbs receives the number of
+// significant limbs.
+bool accumulate_limbs (char const* first, char const* last,
+    Base58::Alphabet const& alphabet, std::uint32_t* limbs,
+    std::size_t maxLimbs, std::size_t& nLimbs)
+{
+    nLimbs = 0;
+
+    char const* p = first;
+    while (p != last)
+    {
+        // Gather up to five digits into one multiplier and addend
+        std::uint32_t group = 0;
+        std::uint32_t factor = 1;
+
+        for (int i = 0; i < 5 && p != last; ++i, ++p)
+        {
+            int const digit (alphabet.from_char (*p));
+            if (digit == -1)
+                return false;
+            group = group * 58 + digit;
+            factor *= 58;
+        }
+
+        std::uint64_t carry = group;
+
+        for (std::size_t i = 0; i < nLimbs; ++i)
+        {
+            std::uint64_t const cur (
+                std::uint64_t (limbs[i]) * factor + carry);
+            limbs[i] = static_cast <std::uint32_t> (cur);
+            carry = cur >> 32;
+        }
+
+        while (carry != 0)
+        {
+            if (nLimbs == maxLimbs)
+                return false;
+            limbs[nLimbs++] = static_cast <std::uint32_t> (carry);
+            carry >>= 32;
+        }
+    }
+
+    return true;
+}
+
+// The number of bytes needed to hold the value big endian
+std::size_t limb_bytes (std::uint32_t const* limbs, std::size_t nLimbs)
+{
+    if (nLimbs == 0)
+        return 0;
+
+    std::size_t bytes = 4 * (nLimbs - 1);
+
+    for (std::uint32_t top = limbs[nLimbs - 1]; top != 0; top >>= 8)
+        ++bytes;
+
+    return bytes;
+}
+
+} // namespace
+
 std::string Base58::raw_encode (unsigned char const* begin,
     unsigned char const* end, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn0 = 0;
-
-    // Convert little endian data to bignum
-    CBigNum bn (begin, end);
     std::size_t const size (std::distance (begin, end));
 
-    // Convert bignum to std::string
+    // Gather the little endian input into limbs
+    std::uint32_t stackLimbs [16] = {0};
+    std::vector <std::uint32_t> heapLimbs;
+    std::uint32_t* limbs = stackLimbs;
+    std::size_t nLimbs ((size + 3) / 4);
+
+    if (nLimbs > 16)
+    {
+        heapLimbs.resize (nLimbs, 0);
+        limbs = &heapLimbs.front ();
+    }
+
+    for (std::size_t i = 0; i < size; ++i)
+        limbs[i / 4] |= std::uint32_t (begin[i]) << (8 * (i % 4));
+
+    while (nLimbs > 0 && limbs[nLimbs - 1] == 0)
+        --nLimbs;
+
+    // Convert the limbs to a std::string
     std::string str;
     // Expected size increase from base58 conversion is approximately 137%
     // use 138% to be safe
     str.reserve (size * 138 / 100 + 1);
-    CBigNum dv;
-    CBigNum rem;
 
-    while (bn > bn0)
+    while (nLimbs > 0)
     {
-        if (!BN_div (&dv, &rem, &bn, &bn58, pctx))
-            throw std::runtime_error ("EncodeBase58 : BN_div failed");
+        // One short division yields five base 58 digits
+        std::uint64_t rem = 0;
+
+        for (std::size_t i = nLimbs; i-- > 0;)
+        {
+            std::uint64_t const cur ((rem << 32) | limbs[i]);
+            limbs[i] = static_cast <std::uint32_t> (cur / base58to5);
+            rem = cur % base58to5;
+        }
 
-        bn = dv;
-        unsigned int c = rem.getuint ();
-        str += alphabet [c];
+        while (nLimbs > 0 && limbs[nLimbs - 1] == 0)
+            --nLimbs;
+
+        std::uint32_t digits (static_cast <std::uint32_t> (rem));
+
+        for (int i = 0; i < 5; ++i)
+        {
+            str += alphabet [digits % 58];
+            digits /= 58;
+        }
     }
 
+    // Remove high order zero digits left by the batched division
+    while (!str.empty () && str.back () == alphabet [0])
+        str.pop_back ();
+
     for (const unsigned char* p = end-2; p >= begin && *p == 0; p--)
         str += alphabet [0];
 
@@ -108,33 +215,21 @@ std::string Base58::raw_encode (unsigned char const* begin,
 bool Base58::raw_decode (char const* first, char const* last, void* dest,
     std::size_t size, bool checked, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
+    std::uint32_t stackLimbs [16];
+    std::vector <std::uint32_t> heapLimbs;
+    std::uint32_t* limbs = stackLimbs;
+    std::size_t const maxLimbs ((size + 3) / 4);
 
-    // Convert big endian string to bignum
-    for (char const* p = first; p != last; ++p)
+    if (maxLimbs > 16)
     {
-        int i (alphabet.from_char (*p));
-        if (i == -1)
-            return false;
-        bnChar.setuint ((unsigned int) i);
-
-        int const success (BN_mul (&bn, &bn, &bn58, pctx));
-
-        assert (success);
-        (void) success;
-
-        bn += bnChar;
+        heapLimbs.resize (maxLimbs);
+        limbs = &heapLimbs.front ();
     }
 
-    // Get bignum as little endian data
-    Blob vchTmp = bn.getvch ();
-
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
+    // Convert big endian string to limbs
+    std::size_t nLimbs;
+    if (!accumulate_limbs (first, last, alphabet, limbs, maxLimbs, nLimbs))
+        return false;
 
     char* const out (static_cast <char*> (dest));
 
@@ -144,15 +239,17 @@ bool Base58::raw_decode (char const* first, char const* last, void* dest,
         nLeadingZeros++;
 
     // Verify that the size is correct
-    if (vchTmp.size() + nLeadingZeros != size)
+    std::size_t const bytes (limb_bytes (limbs, nLimbs));
+    if (bytes + nLeadingZeros != size)
         return false;
 
     // Fill the leading zeros
     memset (out, 0, nLeadingZeros);
 
-    // Copy little endian data to big endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (),
-        out + nLeadingZeros);
+    // Copy the value big endian
+    for (std::size_t i = 0; i < bytes; ++i)
+        out[nLeadingZeros + bytes - 1 - i] =
+            static_cast <char> (limbs[i / 4] >> (8 * (i % 4)));
 
     if (checked)
     {
@@ -167,59 +264,48 @@ bool Base58::raw_decode (char const* first, char const* last, void* dest,
 
 bool Base58::decode (const char* psz, Blob& vchRet, Alphabet const& alphabet)
 {
-    CAutoBN_CTX pctx;
     vchRet.clear ();
-    CBigNum bn58 = 58;
-    CBigNum bn = 0;
-    CBigNum bnChar;
 
     while (isspace (*psz))
         psz++;
 
-    // Convert big endian string to bignum
-    for (const char* p = psz; *p; p++)
-    {
-        // VFALCO TODO Make this use the inverse table!
-        //             Or better yet ditch this and call raw_decode
-        //
-        const char* p1 = strchr (alphabet.chars(), *p);
-
-        if (p1 == nullptr)
-        {
-            while (isspace (*p))
-                p++;
-
-            if (*p != '\0')
-                return false;
-
-            break;
-        }
-
-        bnChar.setuint (p1 - alphabet.chars());
+    // The value spans the leading run of alphabet characters; anything
+    // after it other than trailing whitespace is an error
+    char const* first = psz;
+    char const* last = first;
 
-        if (!BN_mul (&bn, &bn, &bn58, pctx))
-            throw std::runtime_error ("DecodeBase58 : BN_mul failed");
+    while (*last != '\0' && alphabet.from_char (*last) != -1)
+        ++last;
 
-        bn += bnChar;
+    for (char const* p = last; *p != '\0'; ++p)
+    {
+        if (!isspace (*p))
+            return false;
     }
 
-    // Get bignum as little endian data
-    Blob vchTmp = bn.getvch ();
+    // Convert big endian string to limbs. Each digit carries slightly
+    // under six bits, so this bound cannot be exceeded.
+    std::size_t const len (std::distance (first, last));
+    std::vector <std::uint32_t> limbs (len / 5 + 1);
+    std::size_t nLimbs;
 
-    // Trim off sign byte if present
-    if (vchTmp.size () >= 2 && vchTmp.end ()[-1] == 0 && vchTmp.end ()[-2] >= 0x80)
-        vchTmp.erase (vchTmp.end () - 1);
+    if (!accumulate_limbs (first, last, alphabet, &limbs.front (),
+            limbs.size (), nLimbs))
+        return false;
 
     // Restore leading zeros
     int nLeadingZeros = 0;
-
-    for (const char* p = psz; *p == alphabet.chars()[0]; p++)
+    for (char const* p = first; p != last && *p == alphabet[0]; p++)
         nLeadingZeros++;
 
-    vchRet.assign (nLeadingZeros + vchTmp.size (), 0);
+    std::size_t const bytes (limb_bytes (&limbs.front (), nLimbs));
+    vchRet.assign (nLeadingZeros + bytes, 0);
+
+    // Copy the value big endian
+    for (std::size_t i = 0; i < bytes; ++i)
+        vchRet[nLeadingZeros + bytes - 1 - i] =
+            static_cast <unsigned char> (limbs[i / 4] >> (8 * (i % 4)));
 
-    // Convert little endian data to big endian
-    std::reverse_copy (vchTmp.begin (), vchTmp.end (), vchRet.end () - vchTmp.size ());
     return true;
 }
 
@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/crypto/Ed25519.h>
+#include <openssl/opensslv.h>
+
+// OpenSSL grew Ed25519 in 1.1.1
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+#define RIPPLE_OPENSSL_ED25519 1
+#include <openssl/evp.h>
+#else
+#define RIPPLE_OPENSSL_ED25519 0
+#endif
+
+namespace ripple {
+
+bool ed25519Available ()
+{
+    return RIPPLE_OPENSSL_ED25519 != 0;
+}
+
+bool isEd25519PublicKey (Blob const& pubkey)
+{
+    return (pubkey.size () == 33) && (pubkey[0] == 0xED);
+}
+
+bool ed25519Verify (unsigned char const* pubkey,
+    void const* msg, std::size_t msgBytes, Blob const& sig)
+{
+#if RIPPLE_OPENSSL_ED25519
+    if (sig.size () != 64)
+        return false;
+
+    EVP_PKEY* const key = EVP_PKEY_new_raw_public_key (
+        EVP_PKEY_ED25519, nullptr, pubkey, 32);
+
+    if (key == nullptr)
+        return false;
+
+    bool ok = false;
+
+    EVP_MD_CTX* const ctx = EVP_MD_CTX_new ();
+
+    if (ctx != nullptr)
+    {
+        ok = (EVP_DigestVerifyInit (ctx,
+                nullptr, nullptr, nullptr, key) == 1) &&
+            (EVP_DigestVerify (ctx, sig.data (), sig.size (),
+                reinterpret_cast <unsigned char const*> (msg),
+                    msgBytes) == 1);
+
+        EVP_MD_CTX_free (ctx);
+    }
+
+    EVP_PKEY_free (key);
+
+    return ok;
+#else
+    (void) pubkey;
+    (void) msg;
+    (void) msgBytes;
+    (void) sig;
+
+    return false;
+#endif
+}
+
+} // ripple
@@ -18,13 +18,125 @@
 //==============================================================================
 
 #include <ripple/crypto/RandomNumbers.h>
+#include <openssl/aes.h>
 #include <openssl/rand.h>
+#include <boost/thread/tss.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <random>
 #include <stdexcept>
 
 namespace ripple {
 
+namespace {
+
+/** Per-thread counter-mode generator built on AES-256.
+
+    Random bytes are drawn on connection setup, key generation and
+    cookie creation, sometimes from io threads. OpenSSL's RAND machinery
+    serializes all of those callers on a process-global lock; giving
+    each thread its own generator removes that lock from every hot path.
+
+    The generator seeds itself from the system entropy source and from
+    OpenSSL's pool (one locked RAND_bytes call per reseed, off the hot
+    path) and takes a fresh seed after a fixed output budget.
+*/
+class ThreadGenerator
+{
+public:
+    ThreadGenerator ()
+    {
+        reseed (nullptr, 0);
+    }
+
+    /** Take a fresh seed, folding in optional caller-supplied entropy. */
+    void reseed (void const* buffer, int count)
+    {
+        std::uint32_t seed[8];
+
+        // In all our supported platforms, std::random_device is
+        // non-deterministic
+        std::random_device rd;
+        for (auto& x : seed)
+            x = rd ();
+
+        // Mix in OpenSSL's pool so we are no weaker than RAND_bytes.
+        // This is the only place the global lock is taken.
+        std::uint32_t pool[8];
+        if (RAND_bytes (reinterpret_cast <unsigned char*> (pool),
+                sizeof (pool)) == 1)
+        {
+            for (int i = 0; i < 8; ++i)
+                seed[i] ^= pool[i];
+        }
+
+        if (buffer != nullptr && count > 0)
+        {
+            auto const* p = static_cast <unsigned char const*> (buffer);
+            auto* s = reinterpret_cast <unsigned char*> (seed);
+            for (int i = 0; i < count; ++i)
+                s[i % sizeof (seed)] ^= p[i];
+        }
+
+        AES_set_encrypt_key (reinterpret_cast <unsigned char*> (seed),
+            256, &m_key);
+        std::memset (m_counter, 0, sizeof (m_counter));
+        m_remaining = reseedBytes;
+    }
+
+    void generate (unsigned char* buffer, int count)
+    {
+        while (count > 0)
+        {
+            if (m_remaining == 0)
+                reseed (nullptr, 0);
+
+            unsigned char block[16];
+            increment ();
+            AES_encrypt (m_counter, block, &m_key);
+
+            int const n = std::min (count, 16);
+            std::memcpy (buffer, block, n);
+            buffer += n;
+            count -= n;
+            m_remaining -= std::min<std::uint64_t> (m_remaining, 16);
+        }
+    }
+
+private:
+    void increment ()
+    {
+        for (int i = 15; i >= 0; --i)
+            if (++m_counter[i] != 0)
+                break;
+    }
+
+    // Output budget between reseeds
+    static std::uint64_t const reseedBytes = 1024 * 1024;
+
+    AES_KEY m_key;
+    unsigned char m_counter[16];
+    std::uint64_t m_remaining;
+};
+
+boost::thread_specific_ptr <ThreadGenerator> threadGenerator;
+
+ThreadGenerator& generator ()
+{
+    ThreadGenerator* g = threadGenerator.get ();
+    if (g == nullptr)
+    {
+        g = new ThreadGenerator;
+        threadGenerator.reset (g);
+    }
+    return *g;
+}
+
+}
+
 void add_entropy (void* buffer, int count)
 {
     assert (buffer == nullptr || count != 0);
@@ -45,14 +157,19 @@ void add_entropy (void* buffer, int count)
     // In all our supported platforms, std::random_device is non-deterministic
     // but we conservatively estimate it has around 4 bits of entropy per byte.
     RAND_add (rdbuf, sizeof (rdbuf), sizeof (rdbuf) / 2.0);
+
+    // Reseed the calling thread's generator so the new entropy takes
+    // effect there immediately; other threads pick it up via the pool
+    // on their next scheduled reseed.
+    generator ().reseed (buffer, count);
 }
 
 void random_fill (void* buffer, int count)
 {
     assert (count > 0);
 
-    if (RAND_bytes (reinterpret_cast <unsigned char*> (buffer), count) != 1)
-        throw std::runtime_error ("Insufficient entropy in pool.");
+    generator ().generate (
+        reinterpret_cast <unsigned char*> (buffer), count);
 }
 
 }
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/crypto/SignatureEngine.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+/** OpenSSL engine sharing one secp256k1 group across verifications.
+
+    EC_KEY_new_by_curve_name builds a fresh group for every key. All
+    our keys live on the same curve, so we build the group once and
+    precompute multiples of the generator, which speeds up the u1*G
+    half of every ECDSA verification.
+*/
+class OpenSSLSignatureEngine : public SignatureEngine
+{
+private:
+    EC_GROUP* group_;
+
+public:
+    OpenSSLSignatureEngine ()
+        : group_ (EC_GROUP_new_by_curve_name (NID_secp256k1))
+    {
+        if (group_ == nullptr)
+            throw std::runtime_error (
+                "OpenSSLSignatureEngine: EC_GROUP_new_by_curve_name failed");
+
+        EC_GROUP_set_point_conversion_form (group_,
+            POINT_CONVERSION_COMPRESSED);
+
+        BN_CTX* ctx = BN_CTX_new ();
+
+        if (ctx != nullptr)
+        {
+            EC_GROUP_precompute_mult (group_, ctx);
+            BN_CTX_free (ctx);
+        }
+    }
+
+    std::string name () const override
+    {
+        return "openssl";
+    }
+
+    bool verify (Blob const& pubkey, uint256 const& hash,
+        Blob const& sig) const override
+    {
+        if (pubkey.empty ())
+            return false;
+
+        EC_KEY* key = EC_KEY_new ();
+
+        if (key == nullptr)
+            return false;
+
+        bool good = false;
+
+        if (EC_KEY_set_group (key, group_))
+        {
+            std::uint8_t const* begin = pubkey.data ();
+
+            if (o2i_ECPublicKey (&key, &begin, pubkey.size ()) != nullptr)
+            {
+                // -1 = error, 0 = bad sig, 1 = good
+                good = ECDSA_verify (0, hash.begin (), hash.size (),
+                    sig.data (), sig.size (), key) > 0;
+            }
+        }
+
+        EC_KEY_free (key);
+
+        return good;
+    }
+};
+
+// A libsecp256k1-backed engine registers here once the library is
+// brought into the tree.
+std::vector<SignatureEngine*> const& engines ()
+{
+    static OpenSSLSignatureEngine openssl;
+    static std::vector<SignatureEngine*> const list ({ &openssl });
+
+    return list;
+}
+
+std::atomic<SignatureEngine*> currentEngine (nullptr);
+
+} // namespace
+
+SignatureEngine& signatureEngine ()
+{
+    SignatureEngine* engine = currentEngine.load ();
+
+    if (engine == nullptr)
+    {
+        engine = engines ().front ();
+        currentEngine = engine;
+    }
+
+    return *engine;
+}
+
+bool selectSignatureEngine (std::string const& name)
+{
+    for (auto* engine : engines ())
+    {
+        if (engine->name () == name)
+        {
+            currentEngine = engine;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // ripple
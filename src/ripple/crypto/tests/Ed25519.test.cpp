@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/crypto/Ed25519.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class Ed25519_test : public beast::unit_test::suite
+{
+public:
+    void run ()
+    {
+        // Key type detection needs no crypto backend
+        Blob edKey (33, 0);
+        edKey[0] = 0xED;
+        expect (isEd25519PublicKey (edKey));
+
+        Blob secpKey (33, 0);
+        secpKey[0] = 0x02;
+        expect (! isEd25519PublicKey (secpKey));
+        expect (! isEd25519PublicKey (Blob (32, 0xED)));
+
+        if (! ed25519Available ())
+        {
+            log << "Ed25519 not available in this build; skipping";
+            pass ();
+            return;
+        }
+
+        // RFC 8032, test vector 1 (empty message)
+        Blob const pubkey (strUnHex (
+            "d75a980182b10ab7d54bfed3c964073a"
+            "0ee172f3daa62325af021a68f707511a").first);
+        Blob sig (strUnHex (
+            "e5564300c360ac729086e2cc806e828a"
+            "84877f1eb8e5d974d873e06522490155"
+            "5fb8821590a33bacc61e39701cf9b46b"
+            "d25bf5f0595bbe24655141438e7a100b").first);
+
+        expect (pubkey.size () == 32);
+        expect (sig.size () == 64);
+
+        expect (ed25519Verify (pubkey.data (), "", 0, sig),
+            "test vector did not verify");
+
+        // A damaged signature must not verify
+        sig[0] ^= 1;
+        expect (! ed25519Verify (pubkey.data (), "", 0, sig));
+        sig[0] ^= 1;
+
+        // Nor a signature over different material
+        expect (! ed25519Verify (pubkey.data (), "x", 1, sig));
+
+        // Nor a truncated signature
+        Blob const shortSig (sig.begin (), sig.begin () + 63);
+        expect (! ed25519Verify (pubkey.data (), "", 0, shortSig));
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Ed25519,sslutil,ripple);
+
+} // ripple
@@ -136,12 +136,29 @@ public:
         pass ();
     }
 
+    void
+    test_move_append ()
+    {
+        Json::Value element (Json::objectValue);
+        element["key"] = "value";
+
+        Json::Value array (Json::arrayValue);
+        Json::Value& appended = array.append (std::move (element));
+
+        expect (element.isNull ());
+        expect (array.size () == 1);
+        expect (appended["key"] == "value");
+
+        pass ();
+    }
+
     void run ()
     {
         test_bad_json ();
         test_edge_cases ();
         test_copy ();
         test_move ();
+        test_move_append ();
     }
 };
 
@@ -20,6 +20,7 @@
 #include <beast/module/core/text/LexicalCast.h>
 #include <ripple/json/to_string.h>
 #include <ripple/json/json_writer.h>
+#include <utility>
 
 namespace Json {
 
@@ -1302,6 +1303,12 @@ Value::append ( const Value& value )
     return (*this)[size ()] = value;
 }
 
+Value&
+Value::append ( Value&& value )
+{
+    return (*this)[size ()] = std::move ( value );
+}
+
 
 Value
 Value::get ( const char* key,
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/DecimalDigits.h>
 #include <utility>
 
 namespace Json
@@ -37,45 +38,19 @@ static bool containsControlCharacter ( const char* str )
 
     return false;
 }
-static void uintToString ( unsigned int value,
-                           char*& current )
-{
-    *--current = 0;
-
-    do
-    {
-        *--current = (value % 10) + '0';
-        value /= 10;
-    }
-    while ( value != 0 );
-}
-
 std::string valueToString ( Int value )
 {
     char buffer[32];
-    char* current = buffer + sizeof (buffer);
-    bool isNegative = value < 0;
-
-    if ( isNegative )
-        value = -value;
-
-    uintToString ( UInt (value), current );
-
-    if ( isNegative )
-        *--current = '-';
-
-    assert ( current >= buffer );
-    return current;
+    return std::string (buffer,
+        ripple::writeDecimal (buffer, std::int64_t (value)));
 }
 
 
 std::string valueToString ( UInt value )
 {
     char buffer[32];
-    char* current = buffer + sizeof (buffer);
-    uintToString ( value, current );
-    assert ( current >= buffer );
-    return current;
+    return std::string (buffer,
+        ripple::writeDecimal (buffer, std::uint64_t (value)));
 }
 
 std::string valueToString( double value )
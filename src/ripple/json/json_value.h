@@ -310,6 +310,9 @@ public:
     /// Equivalent to jsonvalue[jsonvalue.size()] = value;
     Value& append ( const Value& value );
 
+    /// \brief Append value to array at the end, taking over its contents.
+    Value& append ( Value&& value );
+
     /// Access an object value by name, create a null member if it does not exist.
     Value& operator[] ( const char* key );
     /// Access an object value by name, returns null if there is no member with that name.
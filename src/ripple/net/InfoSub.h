@@ -22,10 +22,12 @@
 
 #include <ripple/basics/CountedObject.h>
 #include <ripple/protocol/RippleAddress.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/resource/Consumer.h>
 #include <ripple/protocol/Book.h>
 #include <beast/threads/Stoppable.h>
 #include <mutex>
+#include <set>
 
 namespace ripple {
 
@@ -51,6 +53,24 @@ public:
 
     typedef Resource::Consumer Consumer;
 
+    /** One serialization of a published event, shared by all of its
+        subscribers. Publishers serialize once and fan the buffer out;
+        only the reference count is copied per subscriber.
+    */
+    typedef std::shared_ptr <std::string const> MessagePtr;
+
+    /** Server-side filter for the transaction streams.
+
+        A transaction passes when it matches every criterion given; an
+        empty criterion matches everything. Accounts are matched
+        against the transaction's affected-account set.
+    */
+    struct TxFilter
+    {
+        std::set <TxType> types;
+        hash_set <Account> accounts;
+    };
+
 public:
     /** Abstracts the source of subscription data.
     */
@@ -107,6 +127,29 @@ public:
     virtual void send (
         Json::Value const& jvObj, std::string const& sObj, bool broadcast);
 
+    virtual void send (
+        Json::Value const& jvObj, MessagePtr const& spObj, bool broadcast);
+
+    /** Deliver a transaction event as a canonical serialized blob.
+        The buffer holds the same bytes the ledger stores, wrapped in a
+        compact binary envelope. The base class falls back to the JSON
+        rendering; transports that can carry binary frames override
+        this for subscribers that asked for binary delivery.
+    */
+    virtual void sendBinary (
+        Json::Value const& jvObj, MessagePtr const& spObj, bool broadcast);
+
+    /** Whether this subscriber asked for binary transaction events. */
+    bool getBinaryMode () const;
+
+    void setBinaryMode (bool mode);
+
+    /** The transaction stream filter, or null when unfiltered. */
+    std::shared_ptr <TxFilter const> getTxFilter ();
+
+    /** Set or clear the transaction stream filter. */
+    void setTxFilter (std::shared_ptr <TxFilter const> filter);
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
@@ -131,6 +174,8 @@ private:
     hash_set <RippleAddress>      mSubAccountTransaction;
     std::shared_ptr <PathRequest> mPathRequest;
     std::uint64_t                 mSeq;
+    bool                          mBinaryMode;
+    std::shared_ptr <TxFilter const> mTxFilter;
 };
 
 } // ripple
@@ -45,6 +45,7 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 InfoSub::InfoSub (Source& source, Consumer consumer)
     : m_consumer (consumer)
     , m_source (source)
+    , mBinaryMode (false)
 {
     static std::atomic <int> s_seq_id (0);
     mSeq = ++s_seq_id;
@@ -71,6 +72,41 @@ void InfoSub::send (
     send (jvObj, broadcast);
 }
 
+void InfoSub::send (
+    Json::Value const& jvObj, MessagePtr const& spObj, bool broadcast)
+{
+    send (jvObj, *spObj, broadcast);
+}
+
+void InfoSub::sendBinary (
+    Json::Value const& jvObj, MessagePtr const& spObj, bool broadcast)
+{
+    // Transports without binary frames deliver the JSON rendering
+    send (jvObj, broadcast);
+}
+
+bool InfoSub::getBinaryMode () const
+{
+    return mBinaryMode;
+}
+
+void InfoSub::setBinaryMode (bool mode)
+{
+    mBinaryMode = mode;
+}
+
+std::shared_ptr <InfoSub::TxFilter const> InfoSub::getTxFilter ()
+{
+    ScopedLockType sl (mLock);
+    return mTxFilter;
+}
+
+void InfoSub::setTxFilter (std::shared_ptr <TxFilter const> filter)
+{
+    ScopedLockType sl (mLock);
+    mTxFilter = std::move (filter);
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
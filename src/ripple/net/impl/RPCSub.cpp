@@ -19,6 +19,8 @@
 
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/net/RPCSub.h>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/date_time/posix_time/posix_time_duration.hpp>
 
 namespace ripple {
 
@@ -39,6 +41,8 @@ public:
         , mUsername (strUsername)
         , mPassword (strPassword)
         , mSending (false)
+        , mFlushPending (false)
+        , mTimer (io_service)
     {
         std::string strScheme;
 
@@ -69,6 +73,8 @@ public:
 
     ~RPCSubImp ()
     {
+        boost::system::error_code ec;
+        mTimer.cancel (ec);
     }
 
     void send (Json::Value const& jvObj, bool broadcast)
@@ -87,15 +93,23 @@ public:
 
         mDeque.push_back (std::make_pair (mSeq++, jvObj));
 
-        if (!mSending)
-        {
-            // Start a sending thread.
-            mSending    = true;
+        if (mSending)
+            return; // The drain job will pick this event up
 
-            WriteLog (lsINFO, RPCSub) << "RPCCall::fromNetwork start";
+        if (mDeque.size () >= batchMax)
+        {
+            // A full batch is ready; flush it now
+            startSending ();
+        }
+        else if (!mFlushPending)
+        {
+            // Wait briefly for more events to share the request
+            mFlushPending = true;
 
-            m_jobQueue.addJob (
-                jtCLIENT, "RPCSub::sendThread", std::bind (&RPCSubImp::sendThread, this));
+            mTimer.expires_from_now (
+                boost::posix_time::milliseconds (flushMilliseconds));
+            mTimer.async_wait (std::bind (&RPCSubImp::onFlushTimer,
+                this, std::placeholders::_1));
         }
     }
 
@@ -114,7 +128,30 @@ public:
     }
 
 private:
-    // XXX Could probably create a bunch of send jobs in a single get of the lock.
+    // Requires the lock
+    void startSending ()
+    {
+        mSending = true;
+
+        WriteLog (lsINFO, RPCSub) << "RPCCall::fromNetwork start";
+
+        m_jobQueue.addJob (
+            jtCLIENT, "RPCSub::sendThread", std::bind (&RPCSubImp::sendThread, this));
+    }
+
+    void onFlushTimer (boost::system::error_code const& ec)
+    {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+
+        ScopedLockType sl (mLock);
+
+        mFlushPending = false;
+
+        if (!mSending && !mDeque.empty ())
+            startSending ();
+    }
+
     void sendThread ()
     {
         Json::Value jvEvent;
@@ -131,8 +168,9 @@ private:
                     mSending    = false;
                     bSend       = false;
                 }
-                else
+                else if (mDeque.size () == 1)
                 {
+                    // A lone event keeps the original wire format
                     std::pair<int, Json::Value> pEvent  = mDeque.front ();
 
                     mDeque.pop_front ();
@@ -140,6 +178,24 @@ private:
                     jvEvent     = pEvent.second;
                     jvEvent["seq"]  = pEvent.first;
 
+                    bSend       = true;
+                }
+                else
+                {
+                    // Gather a batch into one request
+                    jvEvent = Json::Value (Json::arrayValue);
+
+                    while (!mDeque.empty () &&
+                        (jvEvent.size () < batchMax))
+                    {
+                        Json::Value jvEntry =
+                            std::move (mDeque.front ().second);
+                        jvEntry["seq"] = mDeque.front ().first;
+                        mDeque.pop_front ();
+
+                        jvEvent.append (jvEntry);
+                    }
+
                     bSend       = true;
                 }
             }
@@ -173,7 +229,16 @@ private:
 // VFALCO TODO replace this macro with a language constant
     enum
     {
-        eventQueueMax = 32
+        // Big enough to ride out a burst while a batch is in flight;
+        // with batched delivery the queue drains batchMax per request
+        // instead of one, so this cap is rarely reached.
+        eventQueueMax = 1024,
+
+        // Most events to pack into one request
+        batchMax = 64,
+
+        // How long a lone event waits for company before it is flushed
+        flushMilliseconds = 50
     };
 
     boost::asio::io_service& m_io_service;
@@ -190,6 +255,9 @@ private:
     int                     mSeq;                       // Next id to allocate.
 
     bool                    mSending;                   // Sending threead is active.
+    bool                    mFlushPending;              // Flush timer is set.
+
+    boost::asio::deadline_timer mTimer;
 
     std::deque<std::pair<int, Json::Value> >    mDeque;
 };
@@ -60,6 +60,18 @@ public:
     */
     virtual Status fetch (void const* key, NodeObject::Ptr* pObject) = 0;
 
+    /** Fetch a batch of objects in one backend operation.
+
+        Results are positional: results[i] corresponds to hashes[i] and
+        is null if that key was not found or could not be decoded. The
+        base class implementation performs serial point reads; backends
+        with a native batched read (such as RocksDB's MultiGet) should
+        override it.
+        @note This may be called concurrently.
+    */
+    virtual void fetchBatch (std::vector <uint256> const& hashes,
+        std::vector <NodeObject::Ptr>& results);
+
     /** Store a single object.
         Depending on the implementation this may happen immediately
         or deferred using a scheduled task.
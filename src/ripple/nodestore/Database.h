@@ -66,6 +66,16 @@ public:
     */
     virtual NodeObject::pointer fetch (uint256 const& hash) = 0;
 
+    /** Set a handler consulted when a fetch misses every backend.
+
+        The history shard store installs its lookup here so that node
+        objects held in completed shards resolve through the regular
+        fetch path. Objects the handler supplies are cached like any
+        other hit. Set this during startup, before fetch traffic begins.
+    */
+    virtual void setMissHandler (
+        std::function <NodeObject::pointer (uint256 const&)> handler) = 0;
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -125,6 +135,9 @@ public:
     /** Get the positive cache hits to total attempts ratio. */
     virtual float getCacheHitRate () = 0;
 
+    /** Get the number of entries in the positive cache. */
+    virtual int getCacheSize () = 0;
+
     /** Set the maximum number of entries and maximum cache age for both caches.
 
         @param size Number of cache entries (0 = ignore)
@@ -135,6 +148,27 @@ public:
     /** Remove expired entries from the positive and negative caches. */
     virtual void sweep () = 0;
 
+    /** Remove expired entries from a bounded slice of the caches.
+
+        @see TaggedCache::sweepSlice
+        @return `true` if a full pass over the caches completed.
+    */
+    virtual bool sweepSlice (int maxPartitions = 1) = 0;
+
+    /** Write the positive cache's key list to a file.
+
+        The cache contents die with the process, but the key list is
+        tiny and is enough to rebuild them. Called on clean shutdown so
+        a planned restart can come back warm instead of refilling the
+        cache from scratch under production load.
+    */
+    virtual void saveCacheKeys (std::string const& path) = 0;
+
+    /** Queue background fetches for a key list saved by saveCacheKeys.
+        Consumes the file; one key list is only good for one restart.
+    */
+    virtual void primeCacheKeys (std::string const& path) = 0;
+
     /** Gather statistics pertaining to read and write activities.
         Return the reads and writes, and total read and written bytes.
      */
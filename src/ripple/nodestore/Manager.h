@@ -85,6 +85,25 @@ public:
             std::shared_ptr <Backend> archiveBackend,
             std::unique_ptr <Backend> fastBackend,
             beast::Journal journal) = 0;
+
+    /** Construct a tiered NodeStore database.
+
+        Recent ledgers are written to the hot backend and aged into the
+        cold backend in the background; see DatabaseTieredImp. The hot
+        parameters understand two extra keys: 'hot_ledgers', the number
+        of ledgers the hot tier keeps before rotation, and 'filter_mb',
+        the size of the cold tier absence filter in megabytes.
+
+        @param coldParameters The parameter string for the history backend.
+        @param hotParameters The parameter string for the recent backend.
+    */
+    virtual std::unique_ptr <Database> make_DatabaseTiered (
+            std::string const& name,
+            Scheduler& scheduler,
+            beast::Journal journal,
+            int readThreads,
+            Parameters const& coldParameters,
+            Parameters const& hotParameters) = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,320 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#if RIPPLE_MMAPARCHIVE_AVAILABLE
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Append-only memory-mapped archive of node objects.
+
+    Records are laid out back to back inside fixed-size data files that
+    are mapped read-write for their whole lifetime:
+
+        [ 32-byte hash ][ 32-bit payload size ][ payload ]
+
+    The payload is the standard flattened NodeObject encoding (see
+    DecodedBlob). A zero hash marks the end of the written region. At
+    open the files are scanned once to rebuild the hash -> location
+    index; after that every fetch resolves entirely inside the mapping.
+    Objects are immutable so records are never rewritten.
+*/
+class MmapArchiveBackend : public Backend
+{
+private:
+    struct MappedFile
+    {
+        int fd = -1;
+        char* base = nullptr;
+        std::size_t used = 0;
+    };
+
+    struct Location
+    {
+        char const* data;
+        std::uint32_t size;
+    };
+
+    // Capacity of one data file
+    static std::size_t const fileBytes = 256 * 1024 * 1024;
+
+    beast::Journal m_journal;
+    std::size_t const m_keyBytes;
+    std::string const m_path;
+    std::mutex mutable m_mutex;
+    std::map <uint256 const, Location> m_index;
+    std::vector <MappedFile> m_files;
+    bool m_deletePath;
+
+public:
+    MmapArchiveBackend (std::size_t keyBytes, Parameters const& keyValues,
+        Scheduler& scheduler, beast::Journal journal)
+        : m_journal (journal)
+        , m_keyBytes (keyBytes)
+        , m_path (keyValues ["path"].toStdString ())
+        , m_deletePath (false)
+    {
+        boost::filesystem::create_directories (m_path);
+
+        // Map and scan existing archive files in order
+        for (int index = 0;; ++index)
+        {
+            if (! boost::filesystem::exists (fileName (index)))
+                break;
+
+            openFile (index);
+        }
+
+        if (m_files.empty ())
+            openFile (0);
+    }
+
+    ~MmapArchiveBackend ()
+    {
+        for (auto& file : m_files)
+        {
+            if (file.base != nullptr)
+                ::munmap (file.base, fileBytes);
+            if (file.fd != -1)
+                ::close (file.fd);
+        }
+
+        if (m_deletePath)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all (m_path, ec);
+        }
+    }
+
+    std::string
+    getName ()
+    {
+        return m_path;
+    }
+
+    //--------------------------------------------------------------------------
+
+    Status
+    fetch (void const* key, NodeObject::Ptr* pObject)
+    {
+        pObject->reset ();
+
+        Location location;
+
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            auto const iter = m_index.find (uint256::fromVoid (key));
+
+            if (iter == m_index.end ())
+                return notFound;
+
+            location = iter->second;
+        }
+
+        DecodedBlob decoded (key, location.data, location.size);
+
+        if (! decoded.wasOk ())
+            return dataCorrupt;
+
+        *pObject = decoded.createObject ();
+        return ok;
+    }
+
+    void
+    store (NodeObject::ref object)
+    {
+        EncodedBlob encoded;
+        encoded.prepare (object);
+
+        std::size_t const recordBytes =
+            m_keyBytes + sizeof (std::uint32_t) + encoded.getSize ();
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        if (m_index.count (object->getHash ()) != 0)
+            return;
+
+        MappedFile* file = &m_files.back ();
+
+        // Leave room for the end-of-data marker
+        if (file->used + recordBytes + m_keyBytes > fileBytes)
+        {
+            openFile (m_files.size ());
+            file = &m_files.back ();
+        }
+
+        char* p = file->base + file->used;
+        std::memcpy (p, encoded.getKey (), m_keyBytes);
+        std::uint32_t const size = encoded.getSize ();
+        std::memcpy (p + m_keyBytes, &size, sizeof (size));
+        std::memcpy (p + m_keyBytes + sizeof (size),
+            encoded.getData (), size);
+
+        file->used += recordBytes;
+
+        m_index.emplace (object->getHash (),
+            Location { p + m_keyBytes + sizeof (size), size });
+    }
+
+    void
+    storeBatch (Batch const& batch)
+    {
+        for (auto const& e : batch)
+            store (e);
+    }
+
+    void
+    for_each (std::function <void (NodeObject::Ptr)> f)
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        for (auto const& entry : m_index)
+        {
+            DecodedBlob decoded (entry.first.begin (),
+                entry.second.data, entry.second.size);
+
+            if (decoded.wasOk ())
+                f (decoded.createObject ());
+        }
+    }
+
+    int
+    getWriteLoad ()
+    {
+        return 0;
+    }
+
+    void
+    setDeletePath () override
+    {
+        m_deletePath = true;
+    }
+
+private:
+    std::string
+    fileName (int index) const
+    {
+        return m_path + "/archive-" + std::to_string (index) + ".dat";
+    }
+
+    // Caller holds the lock (or is the constructor)
+    void
+    openFile (std::size_t index)
+    {
+        MappedFile file;
+
+        file.fd = ::open (fileName (index).c_str (),
+            O_RDWR | O_CREAT, 0644);
+
+        if (file.fd == -1)
+            throw std::runtime_error (
+                "mmaparchive: cannot open " + fileName (index));
+
+        if (::ftruncate (file.fd, fileBytes) == -1)
+        {
+            ::close (file.fd);
+            throw std::runtime_error (
+                "mmaparchive: cannot size " + fileName (index));
+        }
+
+        void* const base = ::mmap (nullptr, fileBytes,
+            PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+
+        if (base == MAP_FAILED)
+        {
+            ::close (file.fd);
+            throw std::runtime_error (
+                "mmaparchive: cannot map " + fileName (index));
+        }
+
+        file.base = static_cast <char*> (base);
+
+        // Index the records already present
+        while (file.used + m_keyBytes + sizeof (std::uint32_t) < fileBytes)
+        {
+            char const* p = file.base + file.used;
+
+            uint256 const hash = uint256::fromVoid (p);
+            if (hash.isZero ())
+                break;
+
+            std::uint32_t size;
+            std::memcpy (&size, p + m_keyBytes, sizeof (size));
+
+            if (file.used + m_keyBytes + sizeof (size) + size > fileBytes)
+            {
+                m_journal.error << "mmaparchive: truncated record in " <<
+                    fileName (index);
+                break;
+            }
+
+            m_index.emplace (hash,
+                Location { p + m_keyBytes + sizeof (size), size });
+
+            file.used += m_keyBytes + sizeof (size) + size;
+        }
+
+        m_files.push_back (file);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class MmapArchiveFactory : public Factory
+{
+public:
+    std::string
+    getName () const
+    {
+        return "MmapArchive";
+    }
+
+    std::unique_ptr <Backend>
+    createInstance (
+        size_t keyBytes,
+        Parameters const& keyValues,
+        Scheduler& scheduler,
+        beast::Journal journal)
+    {
+        return std::make_unique <MmapArchiveBackend> (
+            keyBytes, keyValues, scheduler, journal);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr <Factory>
+make_MmapArchiveFactory ()
+{
+    return std::make_unique <MmapArchiveFactory> ();
+}
+
+}
+}
+
+#endif
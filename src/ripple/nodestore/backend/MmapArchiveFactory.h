@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_MMAPARCHIVEFACTORY_H_INCLUDED
+#define RIPPLE_NODESTORE_MMAPARCHIVEFACTORY_H_INCLUDED
+
+#include <ripple/nodestore/Factory.h>
+#include <beast/Config.h>
+
+// The archive backend maps its data files with POSIX mmap
+#if ! BEAST_WINDOWS
+# define RIPPLE_MMAPARCHIVE_AVAILABLE 1
+#else
+# define RIPPLE_MMAPARCHIVE_AVAILABLE 0
+#endif
+
+#if RIPPLE_MMAPARCHIVE_AVAILABLE
+
+namespace ripple {
+namespace NodeStore {
+
+/** Factory to produce a memory-mapped append-only archive backend.
+
+    Suited to immutable history nodes: reads are satisfied straight
+    from the mapped pages with no syscalls after warmup, and the OS
+    page cache holding them survives rippled restarts.
+    @see Database
+*/
+std::unique_ptr <Factory> make_MmapArchiveFactory ();
+
+}
+}
+
+#endif
+
+#endif
@@ -90,6 +90,14 @@ public:
     std::string m_name;
     std::unique_ptr <rocksdb::DB> m_db;
 
+    // The state column holds ledger headers and account state nodes,
+    // the hot set that point reads hammer. Transaction and transaction
+    // tree nodes are written once and read rarely, so they live in
+    // their own column family with their own compaction, keeping their
+    // files and cache blocks out of the state nodes' way.
+    rocksdb::ColumnFamilyHandle* m_stateColumn = nullptr;
+    rocksdb::ColumnFamilyHandle* m_txColumn = nullptr;
+
     RocksDBBackend (int keyBytes, Parameters const& keyValues,
         Scheduler& scheduler, beast::Journal journal, RocksDBEnv* env)
         : m_deletePath (false)
@@ -184,26 +192,72 @@ public:
             }
         }
 
+        // Keys are uniformly distributed hashes and every read is a
+        // point Get, the case whole-key bloom filters exist for. They
+        // also make probing the wrong column family nearly free.
+        table_options.whole_key_filtering = true;
+
         options.table_factory.reset(NewBlockBasedTableFactory(table_options));
 
+        // A database from before the split knows only the default
+        // family; this creates the transaction family on first open.
+        options.create_missing_column_families = true;
+
+        // Transaction nodes are immutable and append-only, so compact
+        // that family for write amplification, not read locality.
+        rocksdb::ColumnFamilyOptions txOptions (options);
+        txOptions.compaction_style = rocksdb::kCompactionStyleUniversal;
+        txOptions.min_write_buffer_number_to_merge = 2;
+        txOptions.max_write_buffer_number = 6;
+
+        std::vector <rocksdb::ColumnFamilyDescriptor> families;
+        families.emplace_back (rocksdb::kDefaultColumnFamilyName,
+            rocksdb::ColumnFamilyOptions (options));
+        families.emplace_back ("transactions", txOptions);
+
+        std::vector <rocksdb::ColumnFamilyHandle*> handles;
         rocksdb::DB* db = nullptr;
-        rocksdb::Status status = rocksdb::DB::Open (options, m_name, &db);
-        if (!status.ok () || !db)
+        rocksdb::Status status = rocksdb::DB::Open (
+            rocksdb::DBOptions (options), m_name, families, &handles, &db);
+        if (!status.ok () || !db || (handles.size () != 2))
             throw std::runtime_error (std::string("Unable to open/create RocksDB: ") + status.ToString());
 
         m_db.reset (db);
+        m_stateColumn = handles[0];
+        m_txColumn = handles[1];
     }
 
     ~RocksDBBackend ()
     {
+        close ();
+
         if (m_deletePath)
         {
-            m_db.reset();
             boost::filesystem::path dir = m_name;
             boost::filesystem::remove_all (dir);
         }
     }
 
+    void
+    close ()
+    {
+        // The handles must be released before the database
+        delete m_stateColumn;
+        m_stateColumn = nullptr;
+        delete m_txColumn;
+        m_txColumn = nullptr;
+        m_db.reset ();
+    }
+
+    rocksdb::ColumnFamilyHandle*
+    column (NodeObjectType type) const
+    {
+        if ((type == hotTRANSACTION) || (type == hotTRANSACTION_NODE))
+            return m_txColumn;
+
+        return m_stateColumn;
+    }
+
     std::string
     getName()
     {
@@ -224,7 +278,14 @@ public:
 
         std::string string;
 
-        rocksdb::Status getStatus = m_db->Get (options, slice, &string);
+        // The caller only has the hash, not the type, so probe the
+        // state family first and fall back to the transaction family.
+        // The whole-key bloom filter makes the wrong probe nearly free.
+        rocksdb::Status getStatus =
+            m_db->Get (options, m_stateColumn, slice, &string);
+
+        if (getStatus.IsNotFound ())
+            getStatus = m_db->Get (options, m_txColumn, slice, &string);
 
         if (getStatus.ok ())
         {
@@ -262,6 +323,81 @@ public:
         return status;
     }
 
+    void
+    fetchBatch (std::vector <uint256> const& hashes,
+        std::vector <NodeObject::Ptr>& results) override
+    {
+        results.clear ();
+        results.resize (hashes.size ());
+
+        std::vector <rocksdb::Slice> keys;
+        keys.reserve (hashes.size ());
+
+        for (auto const& hash : hashes)
+            keys.emplace_back (reinterpret_cast <char const*> (
+                hash.begin ()), m_keyBytes);
+
+        std::vector <std::string> values;
+        rocksdb::ReadOptions const options;
+
+        std::vector <rocksdb::Status> const statuses = m_db->MultiGet (
+            options, std::vector <rocksdb::ColumnFamilyHandle*> (
+                keys.size (), m_stateColumn), keys, &values);
+
+        // Whatever the state family doesn't have may be a transaction
+        // or transaction tree node; retry those in one batch.
+        std::vector <std::size_t> retries;
+        std::vector <rocksdb::Slice> retryKeys;
+
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            if (statuses[i].ok ())
+            {
+                DecodedBlob decoded (hashes[i].begin (),
+                    values[i].data (), values[i].size ());
+
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject ();
+            }
+            else if (statuses[i].IsNotFound ())
+            {
+                retries.push_back (i);
+                retryKeys.push_back (keys[i]);
+            }
+            else
+            {
+                m_journal.error << statuses[i].ToString ();
+            }
+        }
+
+        if (retries.empty ())
+            return;
+
+        std::vector <std::string> retryValues;
+
+        std::vector <rocksdb::Status> const retryStatuses = m_db->MultiGet (
+            options, std::vector <rocksdb::ColumnFamilyHandle*> (
+                retryKeys.size (), m_txColumn), retryKeys, &retryValues);
+
+        for (std::size_t i = 0; i < retries.size (); ++i)
+        {
+            if (! retryStatuses[i].ok ())
+            {
+                if (! retryStatuses[i].IsNotFound ())
+                    m_journal.error << retryStatuses[i].ToString ();
+                continue;
+            }
+
+            std::size_t const pos = retries[i];
+
+            DecodedBlob decoded (hashes[pos].begin (),
+                retryValues[i].data (), retryValues[i].size ());
+
+            if (decoded.wasOk ())
+                results[pos] = decoded.createObject ();
+        }
+    }
+
     void
     store (NodeObject::ref object)
     {
@@ -280,6 +416,7 @@ public:
             encoded.prepare (e);
 
             wb.Put (
+                column (e->getType ()),
                 rocksdb::Slice (reinterpret_cast <char const*> (
                     encoded.getKey ()), m_keyBytes),
                 rocksdb::Slice (reinterpret_cast <char const*> (
@@ -296,10 +433,19 @@ public:
 
     void
     for_each (std::function <void(NodeObject::Ptr)> f)
+    {
+        for_each_column (m_stateColumn, f);
+        for_each_column (m_txColumn, f);
+    }
+
+    void
+    for_each_column (rocksdb::ColumnFamilyHandle* cf,
+        std::function <void(NodeObject::Ptr)> const& f)
     {
         rocksdb::ReadOptions const options;
 
-        std::unique_ptr <rocksdb::Iterator> it (m_db->NewIterator (options));
+        std::unique_ptr <rocksdb::Iterator> it (
+            m_db->NewIterator (options, cf));
 
         for (it->SeekToFirst (); it->Valid (); it->Next ())
         {
@@ -24,5 +24,17 @@ Backend::~Backend ()
 {
 }
 
+void
+Backend::fetchBatch (std::vector <uint256> const& hashes,
+    std::vector <NodeObject::Ptr>& results)
+{
+    // Generic fallback: serial point reads
+    results.clear ();
+    results.resize (hashes.size ());
+
+    for (std::size_t i = 0; i < hashes.size (); ++i)
+        fetch (hashes[i].begin (), &results[i]);
+}
+
 }
 }
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+std::size_t const canonicalInnerSize = 4 + 16 * 32;
+
+bool innerPrefix (unsigned char const* bytes)
+{
+    std::uint32_t const prefix = HashPrefix::innerNode;
+
+    return (bytes[0] == ((prefix >> 24) & 0xff)) &&
+           (bytes[1] == ((prefix >> 16) & 0xff)) &&
+           (bytes[2] == ((prefix >> 8) & 0xff)) &&
+           (bytes[3] == (prefix & 0xff));
+}
+
+bool zeroHash (unsigned char const* hash)
+{
+    for (int i = 0; i < 32; ++i)
+        if (hash[i] != 0)
+            return false;
+
+    return true;
+}
+
+} // namespace
+
+bool compactInnerNode (void const* data, std::size_t size, Blob& out)
+{
+    auto bytes = static_cast <unsigned char const*> (data);
+
+    if ((size != canonicalInnerSize) || !innerPrefix (bytes))
+        return false;
+
+    int bitmap = 0;
+    int branches = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (!zeroHash (bytes + 4 + i * 32))
+        {
+            bitmap |= (1 << i);
+            ++branches;
+        }
+    }
+
+    // A full node gains nothing; an empty node should not exist
+    if ((branches == 16) || (branches == 0))
+        return false;
+
+    out.clear ();
+    out.reserve (6 + branches * 32);
+    out.insert (out.end (), bytes, bytes + 4);
+    out.push_back ((bitmap >> 8) & 0xff);
+    out.push_back (bitmap & 0xff);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (bitmap & (1 << i))
+            out.insert (out.end (), bytes + 4 + i * 32, bytes + 4 + (i + 1) * 32);
+    }
+
+    return true;
+}
+
+bool isCompactInnerNode (void const* data, std::size_t size)
+{
+    auto bytes = static_cast <unsigned char const*> (data);
+
+    if ((size < 6 + 32) || (size == canonicalInnerSize) ||
+            ((size - 6) % 32) != 0 || !innerPrefix (bytes))
+        return false;
+
+    int const bitmap = (bytes[4] << 8) | bytes[5];
+    int branches = 0;
+
+    for (int i = 0; i < 16; ++i)
+        if (bitmap & (1 << i))
+            ++branches;
+
+    return (size - 6) == branches * 32u;
+}
+
+bool expandInnerNode (void const* data, std::size_t size, Blob& out)
+{
+    if (!isCompactInnerNode (data, size))
+        return false;
+
+    auto bytes = static_cast <unsigned char const*> (data);
+    int const bitmap = (bytes[4] << 8) | bytes[5];
+
+    out.assign (canonicalInnerSize, 0);
+    std::memcpy (out.data (), bytes, 4);
+
+    unsigned char const* hash = bytes + 6;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (bitmap & (1 << i))
+        {
+            std::memcpy (out.data () + 4 + i * 32, hash, 32);
+            hash += 32;
+        }
+    }
+
+    return true;
+}
+
+}
+}
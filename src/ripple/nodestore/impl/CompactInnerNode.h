@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_COMPACTINNERNODE_H_INCLUDED
+#define RIPPLE_NODESTORE_COMPACTINNERNODE_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <cstddef>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Sparse encoding of inner nodes for on-disk storage.
+
+    An inner node in prefix form is always 516 bytes: the four byte
+    HashPrefix::innerNode followed by sixteen 32-byte child hashes, with
+    empty branches spelled out as zeroes. Most inner nodes are sparse,
+    so the compact form stores a branch bitmap and only the non-empty
+    hashes:
+
+        4 bytes     HashPrefix::innerNode (unchanged)
+        2 bytes     branch bitmap, big endian, bit i set for branch i
+        n * 32      the non-empty child hashes, lowest branch first
+
+    Detection needs no marker byte: the canonical form is exactly 516
+    bytes, while a compact record is 6 + 32 * popcount (bitmap) bytes
+    with at most fifteen branches, which can never equal 516. Fully
+    populated nodes gain nothing and are stored canonically.
+*/
+
+/** Produce the compact form of a prefix-format inner node.
+    @return `true` if `out` holds the compact encoding.
+*/
+bool compactInnerNode (void const* data, std::size_t size, Blob& out);
+
+/** Returns `true` if the bytes are a well-formed compact inner node. */
+bool isCompactInnerNode (void const* data, std::size_t size);
+
+/** Recover the canonical 516-byte serialization of a compact inner node.
+    @return `true` if `out` holds the canonical encoding.
+*/
+bool expandInnerNode (void const* data, std::size_t size, Blob& out);
+
+}
+}
+
+#endif
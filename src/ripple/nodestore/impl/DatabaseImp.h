@@ -21,10 +21,16 @@
 #define RIPPLE_NODESTORE_DATABASEIMP_H_INCLUDED
 
 #include <beast/threads/Thread.h>
+#include <ripple/basics/LatencyProbes.h>
 #include <ripple/basics/Log.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/ThreadAffinity.h>
 #include <ripple/nodestore/Database.h>
 #include <chrono>
 #include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
 #include <set>
 #include <thread>
 
@@ -49,6 +55,9 @@ public:
     // Negative cache
     KeyCache <uint256> m_negCache;
 
+    // Consulted when every backend misses; see setMissHandler
+    std::function <NodeObject::pointer (uint256 const&)> m_missHandler;
+
     std::mutex                m_readLock;
     std::condition_variable   m_readCondVar;
     std::condition_variable   m_readGenCondVar;
@@ -159,8 +168,13 @@ public:
 
         auto const before = std::chrono::steady_clock::now();
         NodeObject::Ptr ret = doFetch (hash, report);
+        auto const elapsed = std::chrono::steady_clock::now() - before;
         report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
-            (std::chrono::steady_clock::now() - before);
+            (elapsed);
+
+        static std::size_t const probe (
+            LatencyProbes::getInstance ().probe ("nodestore.fetch"));
+        LatencyProbes::getInstance ().record (probe, elapsed);
 
         report.wasFound = (ret != nullptr);
         m_scheduler.onFetch (report);
@@ -206,6 +220,11 @@ public:
             ++m_fetchTotalCount;
         }
 
+        // Give the miss handler (the history shard store) a chance
+        // before declaring the object absent.
+        if ((obj == nullptr) && m_missHandler)
+            obj = m_missHandler (hash);
+
         if (obj == nullptr)
         {
 
@@ -251,6 +270,12 @@ public:
         return fetchInternal (*m_backend, hash);
     }
 
+    void setMissHandler (
+        std::function <NodeObject::pointer (uint256 const&)> handler)
+    {
+        m_missHandler = std::move (handler);
+    }
+
     NodeObject::Ptr fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -331,6 +356,11 @@ public:
         return m_cache.getHitRate ();
     }
 
+    int getCacheSize ()
+    {
+        return m_cache.getCacheSize ();
+    }
+
     void tune (int size, int age)
     {
         m_cache.setTargetSize (size);
@@ -345,6 +375,72 @@ public:
         m_negCache.sweep ();
     }
 
+    bool sweepSlice (int maxPartitions = 1) override
+    {
+        bool const done = m_cache.sweepSlice (maxPartitions);
+
+        // The negative cache is small; sweep it whole once per pass
+        if (done)
+            m_negCache.sweep ();
+
+        return done;
+    }
+
+    void saveCacheKeys (std::string const& path) override
+    {
+        std::vector <uint256> const keys = m_cache.getKeys ();
+
+        std::ofstream out (path.c_str (),
+            std::ios::binary | std::ios::trunc);
+
+        if (! out)
+        {
+            m_journal.warning << "Cannot write cache keys to '" <<
+                path << "'";
+            return;
+        }
+
+        for (auto const& key : keys)
+            out.write (reinterpret_cast <char const*> (key.begin ()), 32);
+
+        out.close ();
+
+        if (out.fail ())
+            m_journal.warning << "Error writing cache keys to '" <<
+                path << "'";
+        else
+            m_journal.info << "Saved " << keys.size () <<
+                " cache keys to '" << path << "'";
+    }
+
+    void primeCacheKeys (std::string const& path) override
+    {
+        std::ifstream in (path.c_str (), std::ios::binary);
+
+        if (! in)
+            return;     // Nothing saved, e.g. a first start
+
+        std::size_t count = 0;
+        uint256 hash;
+        NodeObject::pointer object;
+
+        while (in.read (reinterpret_cast <char*> (hash.begin ()), 32))
+        {
+            // The read threads fetch and canonicalize in the background
+            asyncFetch (hash, object);
+            ++count;
+        }
+
+        in.close ();
+
+        // A key list reflects one moment's working set; don't replay
+        // it again on the restart after an unplanned exit.
+        std::remove (path.c_str ());
+
+        m_journal.info << "Priming cache with " << count <<
+            " saved keys from '" << path << "'";
+    }
+
     std::int32_t getWriteLoad() const override
     {
         return m_backend->getWriteLoad();
@@ -356,9 +452,14 @@ public:
     void threadEntry ()
     {
         beast::Thread::setCurrentThreadName ("prefetch");
+        setCurrentThreadAffinity (getConfig ().NODESTORE_AFFINITY);
+
+        std::vector <uint256> hashes;
+        hashes.reserve (readBatchSize);
+
         while (1)
         {
-            uint256 hash;
+            hashes.clear ();
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -373,7 +474,9 @@ public:
                 if (m_readShut)
                     break;
 
-                // Read in key order to make the back end more efficient
+                // Drain a contiguous run of keys so the backend sees
+                // one batched read instead of serialized point reads.
+                // Read in key order to make the back end more efficient.
                 std::set <uint256>::iterator it = m_readSet.lower_bound (m_readLast);
                 if (it == m_readSet.end ())
                 {
@@ -384,16 +487,86 @@ public:
                     m_readGenCondVar.notify_all ();
                 }
 
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
+                while ((it != m_readSet.end ()) &&
+                       (hashes.size () < readBatchSize))
+                {
+                    hashes.push_back (*it);
+                    it = m_readSet.erase (it);
+                }
+                m_readLast = hashes.back ();
             }
 
             // Perform the read
-            doTimedFetch (hash, true);
+            if (hashes.size () == 1)
+                doTimedFetch (hashes.front (), true);
+            else
+                doBatchFetch (hashes);
          }
      }
 
+    /** Fetch a set of cache misses through one backend batch read. */
+    void doBatchFetch (std::vector <uint256> const& hashes)
+    {
+        // With a fast backend in play the two-level lookup is per-key;
+        // there is no batched path through it.
+        if (m_fastBackend != nullptr)
+        {
+            for (auto const& hash : hashes)
+                doTimedFetch (hash, true);
+            return;
+        }
+
+        // Another thread may have satisfied some of these already
+        std::vector <uint256> needed;
+        needed.reserve (hashes.size ());
+
+        for (auto const& hash : hashes)
+        {
+            if ((m_cache.fetch (hash) == nullptr) &&
+                    ! m_negCache.touch_if_exists (hash))
+                needed.push_back (hash);
+        }
+
+        if (needed.empty ())
+            return;
+
+        FetchReport report;
+        report.isAsync = true;
+        report.wentToDisk = true;
+        report.wasFound = false;
+
+        auto const before = std::chrono::steady_clock::now();
+
+        std::vector <NodeObject::Ptr> results;
+        m_backend->fetchBatch (needed, results);
+
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before);
+
+        for (std::size_t i = 0; i < needed.size (); ++i)
+        {
+            ++m_fetchTotalCount;
+
+            NodeObject::Ptr obj = results[i];
+
+            if (obj == nullptr)
+            {
+                // Just in case a write occurred
+                obj = m_cache.fetch (needed[i]);
+
+                if (obj == nullptr)
+                    m_negCache.insert (needed[i]);
+            }
+            else
+            {
+                report.wasFound = true;
+                m_cache.canonicalize (needed[i], obj);
+            }
+        }
+
+        m_scheduler.onFetch (report);
+    }
+
     //------------------------------------------------------------------------------
 
     void for_each (std::function <void(NodeObject::Ptr)> f) override
@@ -406,28 +579,134 @@ public:
         importInternal (source, *m_backend.get());
     }
 
+    /** Copy every object in the source database into the destination.
+
+        The copy runs as a pipeline: the source is iterated on the
+        calling thread and handed off in batches to worker threads,
+        which verify each object's hash and write through storeBatch.
+        This keeps the destination disk saturated instead of a single
+        core. Objects whose contents do not match their key are dropped
+        with a warning. Writes are idempotent, so an import that is
+        interrupted can simply be run again.
+    */
     void importInternal (Database& source, Backend& dest)
     {
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+        std::deque <Batch> work;
+        bool finished = false;
+
+        int const threadCount (std::max (2u,
+            std::thread::hardware_concurrency ()));
+        std::size_t const maxDepth (threadCount * 4);
+
+        std::atomic <std::uint64_t> imported (0);
+        std::atomic <std::uint64_t> rejected (0);
+
+        auto worker = [&]()
+        {
+            beast::Thread::setCurrentThreadName ("import");
+
+            for (;;)
+            {
+                Batch b;
+
+                {
+                    std::unique_lock <std::mutex> lock (mutex);
+
+                    while (work.empty () && ! finished)
+                        notEmpty.wait (lock);
+
+                    if (work.empty ())
+                        return;
+
+                    b = std::move (work.front ());
+                    work.pop_front ();
+                    notFull.notify_one ();
+                }
+
+                // Drop anything whose contents don't match its key
+                Batch verified;
+                verified.reserve (b.size ());
+
+                for (auto const& object : b)
+                {
+                    if (object == nullptr)
+                        continue;
+
+                    if (object->getHash () !=
+                        Serializer::getSHA512Half (object->getData ()))
+                    {
+                        ++rejected;
+                        if (m_journal.warning) m_journal.warning <<
+                            "Import skipped corrupt object " <<
+                            object->getHash ();
+                        continue;
+                    }
+
+                    verified.push_back (object);
+                    ++m_storeCount;
+                    m_storeSize += object->getData ().size ();
+                }
+
+                if (! verified.empty ())
+                    dest.storeBatch (verified);
+
+                std::uint64_t const total = (imported += verified.size ());
+
+                // Progress, roughly every million objects
+                if ((total >> 20) != ((total - verified.size ()) >> 20))
+                {
+                    if (m_journal.info) m_journal.info <<
+                        "Import: " << total << " objects copied";
+                }
+            }
+        };
+
+        std::vector <std::thread> threads;
+        threads.reserve (threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            threads.emplace_back (worker);
+
         Batch b;
         b.reserve (batchWritePreallocationSize);
 
         source.for_each ([&](NodeObject::Ptr object)
         {
+            b.push_back (object);
+
             if (b.size() >= batchWritePreallocationSize)
             {
-                dest.storeBatch (b);
+                std::unique_lock <std::mutex> lock (mutex);
+
+                while (work.size () >= maxDepth)
+                    notFull.wait (lock);
+
+                work.push_back (std::move (b));
+                notEmpty.notify_one ();
+
                 b.clear();
                 b.reserve (batchWritePreallocationSize);
             }
-
-            b.push_back (object);
-            ++m_storeCount;
-            if (object)
-                m_storeSize += object->getData().size();
         });
 
-        if (! b.empty())
-            dest.storeBatch (b);
+        {
+            std::lock_guard <std::mutex> lock (mutex);
+
+            if (! b.empty())
+                work.push_back (std::move (b));
+
+            finished = true;
+            notEmpty.notify_all ();
+        }
+
+        for (auto& t : threads)
+            t.join ();
+
+        if (m_journal.info) m_journal.info <<
+            "Import complete: " << imported << " objects copied, " <<
+            rejected << " rejected";
     }
 
     std::uint32_t getStoreCount () const override
@@ -455,7 +734,7 @@ public:
         return m_fetchSize;
     }
 
-private:
+protected:
     std::atomic <std::uint32_t> m_storeCount;
     std::atomic <std::uint32_t> m_fetchTotalCount;
     std::atomic <std::uint32_t> m_fetchHitCount;
@@ -0,0 +1,389 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+#define RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+
+#include <ripple/nodestore/impl/DatabaseImp.h>
+#include <ripple/nodestore/impl/PresenceFilter.h>
+#include <limits>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A two tier node store: a hot tier for recent ledgers, a cold tier
+    for history.
+
+    New nodes are written only to the hot tier, which is meant to sit
+    on fast storage. The ledger sequence already passed to store()
+    drives aging: once the network advances a configured number of
+    ledgers past the last rotation, a fresh hot generation is opened
+    and the previous one is migrated in the background -- nodes still
+    inside the hot window move to the new generation, the rest move to
+    the cold tier and the old generation is deleted from disk. This is
+    the same aging-by-rotation scheme the online delete path uses,
+    applied between tiers instead of to the whole store.
+
+    Cold tier absence is tracked by a Bloom filter so that the common
+    miss (a node that does not exist anywhere) does not pay a cold
+    disk seek. The filter is primed from the cold backend on a
+    background thread at startup and is consulted only once fully
+    primed; until then cold lookups proceed normally.
+*/
+class DatabaseTieredImp : public DatabaseImp
+{
+public:
+    /** Opens the backend for the named generation slot, "a" or "b". */
+    typedef std::function <std::unique_ptr <Backend> (
+        std::string const&)> BackendFactory;
+
+    DatabaseTieredImp (std::string const& name,
+                       Scheduler& scheduler,
+                       int readThreads,
+                       std::unique_ptr <Backend> coldBackend,
+                       std::unique_ptr <Backend> hotBackend,
+                       std::unique_ptr <Backend> leftoverBackend,
+                       std::string const& hotSlot,
+                       BackendFactory hotFactory,
+                       int hotLedgers,
+                       int filterMegabytes,
+                       beast::Journal journal)
+        : DatabaseImp (name, scheduler, readThreads,
+            std::move (coldBackend), std::unique_ptr <Backend> (), journal)
+        , m_hotFactory (std::move (hotFactory))
+        , m_hotLedgers (hotLedgers)
+        , m_hotSlot (hotSlot)
+        , m_hotBackend (std::move (hotBackend))
+        , m_coolingBackend (std::move (leftoverBackend))
+        , m_coldFilter (filterMegabytes)
+        , m_filterComplete (false)
+        , m_coldSkipCount (0)
+        , m_maxSeq (0)
+        , m_lastRotation (0)
+        , m_tierShut (false)
+    {
+        m_primeThread = std::thread (
+            &DatabaseTieredImp::primeEntry, this);
+        m_tierThread = std::thread (
+            &DatabaseTieredImp::tierEntry, this);
+    }
+
+    ~DatabaseTieredImp ()
+    {
+        {
+            std::unique_lock <std::mutex> lock (m_tierLock);
+            m_tierShut = true;
+            m_tierCondVar.notify_all ();
+        }
+
+        m_primeThread.join ();
+        m_tierThread.join ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void store (NodeObjectType type,
+                std::uint32_t index,
+                Blob&& data,
+                uint256 const& hash) override
+    {
+        NodeObject::Ptr object = NodeObject::createObject (type, index,
+                std::move (data), hash);
+
+        #if RIPPLE_VERIFY_NODEOBJECT_KEYS
+        assert (hash == Serializer::getSHA512Half (data));
+        #endif
+
+        m_cache.canonicalize (hash, object, true);
+
+        for (;;)
+        {
+            std::shared_ptr <Backend> const hot = getTiers ().hot;
+            hot->store (object);
+
+            if (getTiers ().hot == hot)
+                break;
+
+            // A rotation swapped generations mid-store and the
+            // migration scan may already have passed this key;
+            // write it again into the new generation.
+        }
+
+        ++m_storeCount;
+        m_storeSize += object->getData ().size ();
+
+        m_negCache.erase (hash);
+
+        noteLedger (index);
+    }
+
+    NodeObject::Ptr fetchFrom (uint256 const& hash) override
+    {
+        Tiers const tiers = getTiers ();
+
+        NodeObject::Ptr obj = fetchInternal (*tiers.hot, hash);
+
+        if (obj == nullptr && tiers.cooling != nullptr)
+            obj = fetchInternal (*tiers.cooling, hash);
+
+        if (obj == nullptr)
+        {
+            if (m_filterComplete &&
+                ! m_coldFilter.maybeContains (hash))
+            {
+                // Definitely not in the cold tier; skip the seek
+                ++m_coldSkipCount;
+                return obj;
+            }
+
+            obj = fetchInternal (*m_backend, hash);
+
+            // Keep the filter warm while it is still being primed
+            if (obj != nullptr)
+                m_coldFilter.insert (hash);
+        }
+
+        return obj;
+    }
+
+    void for_each (std::function <void(NodeObject::Ptr)> f) override
+    {
+        Tiers const tiers = getTiers ();
+
+        m_backend->for_each (f);
+        if (tiers.cooling != nullptr)
+            tiers.cooling->for_each (f);
+        tiers.hot->for_each (f);
+    }
+
+    std::int32_t getWriteLoad () const override
+    {
+        return m_backend->getWriteLoad () + getTiers ().hot->getWriteLoad ();
+    }
+
+    /** Open a new hot generation and migrate the previous one.
+
+        Normally driven by the background thread when the ledger
+        sequence passes the end of the hot window; exposed so tests
+        can exercise the migration deterministically.
+    */
+    void rotateAndMigrate ()
+    {
+        std::uint32_t const maxSeq = m_maxSeq.load ();
+        std::uint32_t const cutoff =
+            (maxSeq > std::uint32_t (m_hotLedgers))
+                ? maxSeq - m_hotLedgers : 0;
+
+        std::string const newSlot ((m_hotSlot == "a") ? "b" : "a");
+
+        std::shared_ptr <Backend> cooling;
+        std::shared_ptr <Backend> hot (m_hotFactory (newSlot));
+
+        {
+            std::lock_guard <std::mutex> lock (m_tierMutex);
+
+            cooling = m_hotBackend;
+            m_hotBackend = hot;
+            m_coolingBackend = cooling;
+            m_hotSlot = newSlot;
+        }
+
+        m_lastRotation = maxSeq;
+
+        if (m_journal.info) m_journal.info <<
+            "Rotating hot tier at ledger " << maxSeq;
+
+        migrateCooling (*cooling, *hot, cutoff);
+    }
+
+    /** Returns the number of cold seeks avoided by the filter. */
+    std::uint32_t getColdSkipCount () const
+    {
+        return m_coldSkipCount;
+    }
+
+private:
+    struct Tiers
+    {
+        std::shared_ptr <Backend> hot;
+        std::shared_ptr <Backend> cooling;
+    };
+
+    Tiers getTiers () const
+    {
+        std::lock_guard <std::mutex> lock (m_tierMutex);
+        return Tiers {m_hotBackend, m_coolingBackend};
+    }
+
+    void noteLedger (std::uint32_t index)
+    {
+        if (index == 0)
+            return;
+
+        std::uint32_t prev = m_maxSeq.load ();
+        while (index > prev && ! m_maxSeq.compare_exchange_weak (prev, index))
+        {
+        }
+
+        // The first sequence seen anchors the rotation window
+        std::uint32_t expected = 0;
+        m_lastRotation.compare_exchange_strong (expected, index);
+
+        if (rotationDue ())
+        {
+            std::lock_guard <std::mutex> lock (m_tierLock);
+            m_tierCondVar.notify_one ();
+        }
+    }
+
+    bool rotationDue () const
+    {
+        std::uint32_t const last = m_lastRotation.load ();
+        return last != 0 && m_maxSeq.load () >= last + m_hotLedgers;
+    }
+
+    /** Move the cooling generation's contents to their new homes.
+
+        Nodes at or past the cutoff go to the new hot generation, the
+        rest to the cold tier; afterwards the generation's directory
+        is deleted, freeing its slot.
+    */
+    void migrateCooling (Backend& cooling, Backend& hot,
+        std::uint32_t cutoff)
+    {
+        Batch toHot;
+        Batch toCold;
+
+        auto flush = [this](Batch& b, Backend& dest, bool cold)
+        {
+            if (b.empty ())
+                return;
+
+            dest.storeBatch (b);
+
+            if (cold)
+            {
+                for (auto const& object : b)
+                    m_coldFilter.insert (object->getHash ());
+            }
+
+            b.clear ();
+        };
+
+        cooling.for_each ([&](NodeObject::Ptr object)
+        {
+            if (std::uint32_t (object->getLedgerIndex ()) >= cutoff)
+                toHot.push_back (object);
+            else
+                toCold.push_back (object);
+
+            if (toHot.size () >= batchWritePreallocationSize)
+                flush (toHot, hot, false);
+            if (toCold.size () >= batchWritePreallocationSize)
+                flush (toCold, *m_backend, true);
+        });
+
+        flush (toHot, hot, false);
+        flush (toCold, *m_backend, true);
+
+        cooling.setDeletePath ();
+
+        {
+            std::lock_guard <std::mutex> lock (m_tierMutex);
+            m_coolingBackend.reset ();
+        }
+    }
+
+    // Builds the cold absence filter once at startup
+    void primeEntry ()
+    {
+        beast::Thread::setCurrentThreadName ("tierprime");
+
+        std::size_t count = 0;
+
+        m_backend->for_each ([&](NodeObject::Ptr object)
+        {
+            m_coldFilter.insert (object->getHash ());
+            ++count;
+        });
+
+        m_filterComplete = true;
+
+        if (m_journal.info) m_journal.info <<
+            "Cold tier filter primed with " << count << " keys";
+    }
+
+    // Rotates the hot tier as the ledger sequence advances
+    void tierEntry ()
+    {
+        beast::Thread::setCurrentThreadName ("tiermigrate");
+
+        // A generation left over from an interrupted migration has an
+        // unknown age span; send all of it to the cold tier. Anything
+        // hot in it will be pulled back up on demand.
+        {
+            Tiers const tiers = getTiers ();
+
+            if (tiers.cooling != nullptr)
+                migrateCooling (*tiers.cooling, *tiers.hot,
+                    std::numeric_limits <std::uint32_t>::max ());
+        }
+
+        while (1)
+        {
+            {
+                std::unique_lock <std::mutex> lock (m_tierLock);
+
+                while (! m_tierShut && ! rotationDue ())
+                    m_tierCondVar.wait (lock);
+
+                if (m_tierShut)
+                    break;
+            }
+
+            rotateAndMigrate ();
+        }
+    }
+
+    BackendFactory m_hotFactory;
+    int const m_hotLedgers;
+
+    std::mutex mutable m_tierMutex;
+    std::string m_hotSlot;
+    std::shared_ptr <Backend> m_hotBackend;
+    std::shared_ptr <Backend> m_coolingBackend;
+
+    PresenceFilter m_coldFilter;
+    std::atomic <bool> m_filterComplete;
+    std::atomic <std::uint32_t> m_coldSkipCount;
+
+    std::atomic <std::uint32_t> m_maxSeq;
+    std::atomic <std::uint32_t> m_lastRotation;
+
+    std::mutex                m_tierLock;
+    std::condition_variable   m_tierCondVar;
+    bool                      m_tierShut;
+    std::thread               m_primeThread;
+    std::thread               m_tierThread;
+};
+
+}
+}
+
+#endif
@@ -85,7 +85,27 @@ NodeObject::Ptr DecodedBlob::createObject ()
 
     if (m_success)
     {
-        Blob data(m_objectData, m_objectData + m_dataBytes);
+        Blob data;
+
+        // State leaves and inner nodes may be stored in compact form;
+        // in memory a NodeObject always holds the canonical serialization
+        if ((m_objectType == hotACCOUNT_NODE) &&
+                isCompactStateLeaf (m_objectData, m_dataBytes))
+        {
+            if (!expandStateLeaf (m_objectData, m_dataBytes, data))
+                return object;
+        }
+        else if (((m_objectType == hotACCOUNT_NODE) ||
+                  (m_objectType == hotTRANSACTION_NODE)) &&
+                isCompactInnerNode (m_objectData, m_dataBytes))
+        {
+            if (!expandInnerNode (m_objectData, m_dataBytes, data))
+                return object;
+        }
+        else
+        {
+            data.assign (m_objectData, m_objectData + m_dataBytes);
+        }
 
         object = NodeObject::createObject (
             m_objectType, m_ledgerIndex, std::move(data), uint256::fromVoid(m_key));
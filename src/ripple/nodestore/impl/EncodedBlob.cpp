@@ -25,8 +25,22 @@ EncodedBlob::prepare (NodeObject::Ptr const& object)
 {
     m_key = object->getHash ().begin ();
 
+    Blob const* data = &object->getData ();
+
+    // Account-state leaves and sparse inner nodes go to disk in
+    // compact form; everything else is stored as-is
+    Blob compact;
+
+    if ((object->getType () == hotACCOUNT_NODE) &&
+            compactStateLeaf (data->data (), data->size (), compact))
+        data = &compact;
+    else if (((object->getType () == hotACCOUNT_NODE) ||
+              (object->getType () == hotTRANSACTION_NODE)) &&
+            compactInnerNode (data->data (), data->size (), compact))
+        data = &compact;
+
     // This is how many bytes we need in the flat data
-    m_size = object->getData ().size () + 9;
+    m_size = data->size () + 9;
 
     m_data.ensureSize (m_size);
 
@@ -46,7 +60,7 @@ EncodedBlob::prepare (NodeObject::Ptr const& object)
 
         buf [8] = static_cast <unsigned char> (object->getType ());
 
-        memcpy (&buf [9], object->getData ().data (), object->getData ().size ());
+        memcpy (&buf [9], data->data (), data->size ());
     }
 }
 
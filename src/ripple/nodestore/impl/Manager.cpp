@@ -20,6 +20,7 @@
 #include <ripple/nodestore/Manager.h>
 
 #include <beast/utility/ci_char_traits.h>
+#include <boost/filesystem.hpp>
 
 namespace ripple {
 namespace NodeStore {
@@ -57,6 +58,10 @@ public:
         add_factory (make_MemoryFactory ());
         add_factory (make_NullFactory ());
 
+    #if RIPPLE_MMAPARCHIVE_AVAILABLE
+        add_factory (make_MmapArchiveFactory ());
+    #endif
+
     #if RIPPLE_HYPERLEVELDB_AVAILABLE
         add_factory (make_HyperDBFactory ());
     #endif
@@ -155,6 +160,80 @@ public:
                 readThreads, writableBackend, archiveBackend,
                 std::move (fastBackend), journal);
     }
+
+    std::unique_ptr <Database>
+    make_DatabaseTiered (
+            std::string const& name,
+            Scheduler& scheduler,
+            beast::Journal journal,
+            int readThreads,
+            Parameters const& coldParameters,
+            Parameters const& hotParameters)
+    {
+        std::unique_ptr <Backend> coldBackend (make_Backend (
+            coldParameters, scheduler, journal));
+
+        int const hotLedgers (
+            hotParameters ["hot_ledgers"].isNotEmpty ()
+                ? hotParameters ["hot_ledgers"].getIntValue ()
+                : defaultHotLedgers);
+
+        int const filterMegabytes (
+            hotParameters ["filter_mb"].isNotEmpty ()
+                ? hotParameters ["filter_mb"].getIntValue ()
+                : defaultFilterMegabytes);
+
+        // Hot generations alternate between two directories under the
+        // configured path; a generation's directory is deleted once it
+        // has been migrated, freeing the slot for the next rotation.
+        namespace fs = boost::filesystem;
+
+        fs::path const base (hotParameters ["path"].toStdString ());
+
+        ManagerImp* const manager (this);
+        Parameters const parameters (hotParameters);
+
+        auto hotFactory =
+            [manager, parameters, base, &scheduler, journal]
+            (std::string const& slot)
+        {
+            Parameters generation (parameters);
+            generation.set ("path", (base / ("hot." + slot)).string ());
+
+            return manager->make_Backend (
+                generation, scheduler, journal);
+        };
+
+        bool const aExists = fs::exists (base / "hot.a");
+        bool const bExists = fs::exists (base / "hot.b");
+
+        std::string hotSlot = "a";
+
+        if (aExists && bExists)
+        {
+            // A migration was interrupted; resume with the most
+            // recently written generation as the hot one.
+            if (fs::last_write_time (base / "hot.b") >
+                    fs::last_write_time (base / "hot.a"))
+                hotSlot = "b";
+        }
+        else if (bExists)
+        {
+            hotSlot = "b";
+        }
+
+        std::unique_ptr <Backend> hotBackend (hotFactory (hotSlot));
+
+        std::unique_ptr <Backend> leftoverBackend (
+            (aExists && bExists)
+                ? hotFactory (hotSlot == "a" ? "b" : "a")
+                : nullptr);
+
+        return std::make_unique <DatabaseTieredImp> (name, scheduler,
+            readThreads, std::move (coldBackend), std::move (hotBackend),
+            std::move (leftoverBackend), hotSlot, hotFactory,
+            hotLedgers, filterMegabytes, journal);
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_PRESENCEFILTER_H_INCLUDED
+#define RIPPLE_NODESTORE_PRESENCEFILTER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A Bloom filter over node object keys.
+
+    Answers "might this key be in the backend" without touching disk,
+    so a miss in one tier does not pay a seek in the next. A negative
+    answer is definitive; a positive answer may be a false positive.
+
+    Node object keys are SHA-512 halves, so four 32-bit words of the
+    key itself serve as the independent hash functions; no additional
+    hashing is required. Insertions and queries are lock-free.
+
+    Keys cannot be removed; the filter only ever accumulates, which is
+    fine for a tier whose contents only grow.
+*/
+class PresenceFilter
+{
+public:
+    /** Create a filter occupying the given amount of memory. */
+    explicit PresenceFilter (int megabytes)
+    {
+        if (megabytes < 1)
+            megabytes = 1;
+
+        std::size_t bits = std::size_t (megabytes) * 1024 * 1024 * 8;
+
+        // Round down to a power of two so we can mask instead of mod
+        std::size_t rounded = 1;
+        while (rounded * 2 <= bits)
+            rounded *= 2;
+
+        m_mask = rounded - 1;
+        m_words = std::vector <std::atomic <std::uint64_t>> (rounded / 64);
+
+        for (auto& word : m_words)
+            word.store (0, std::memory_order_relaxed);
+    }
+
+    PresenceFilter (PresenceFilter const&) = delete;
+    PresenceFilter& operator= (PresenceFilter const&) = delete;
+
+    void insert (uint256 const& key)
+    {
+        for (int i = 0; i < numProbes; ++i)
+        {
+            std::size_t const bit = probe (key, i);
+            m_words [bit / 64].fetch_or (
+                std::uint64_t (1) << (bit % 64),
+                std::memory_order_relaxed);
+        }
+    }
+
+    /** Returns false only if the key was never inserted. */
+    bool maybeContains (uint256 const& key) const
+    {
+        for (int i = 0; i < numProbes; ++i)
+        {
+            std::size_t const bit = probe (key, i);
+            std::uint64_t const word = m_words [bit / 64].load (
+                std::memory_order_relaxed);
+
+            if ((word & (std::uint64_t (1) << (bit % 64))) == 0)
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    static int const numProbes = 4;
+
+    std::size_t probe (uint256 const& key, int i) const
+    {
+        std::uint32_t word;
+        std::memcpy (&word, key.begin () + i * sizeof (word), sizeof (word));
+        return word & m_mask;
+    }
+
+    std::size_t m_mask;
+    std::vector <std::atomic <std::uint64_t>> m_words;
+};
+
+}
+}
+
+#endif
@@ -33,6 +33,15 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Most keys a read thread drains per backend batch fetch
+    ,readBatchSize = 32
+
+    // Ledgers the hot tier keeps before rotating a generation out
+    ,defaultHotLedgers = 256
+
+    // Size of the cold tier absence filter
+    ,defaultFilterMegabytes = 64
 };
 
 }
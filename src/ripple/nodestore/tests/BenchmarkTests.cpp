@@ -0,0 +1,296 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Workload driver for qualifying backends and option changes.
+
+    Runs a mixed read/write workload with concurrent workers against
+    any registered backend factory and reports latency percentiles,
+    so option changes can be compared offline instead of A/B tested
+    on live servers. Build with `scons bench` and run manually:
+
+        rippled --unittest=NodeStoreBenchmark
+            --unittest-arg="type=rocksdb,threads=8,read_pct=90"
+
+    Accepts a semicolon delimited list of configurations, each a
+    comma delimited list of key=value pairs, like the timing suite.
+    Keys the driver consumes (everything else goes to the backend):
+
+        num_objects   keys preloaded into the store  (default 100000)
+        ops           operations timed               (default 200000)
+        read_pct      share of ops that are fetches  (default 80)
+        threads       concurrent workers             (default 4)
+
+    Generated objects follow the live mix: mostly account state
+    nodes, then transaction nodes, with occasional ledger headers.
+*/
+class NodeStoreBenchmark_test : public TestBase
+{
+public:
+    // Everything about an object is derived from its key, so a
+    // reader only has to recompute the hash
+    static uint256 keyHash (std::uint64_t key)
+    {
+        std::mt19937_64 rng (key + 1);
+
+        uint256 hash;
+        std::generate_n (reinterpret_cast<std::uint64_t*> (hash.begin ()),
+            hash.size () / sizeof (std::uint64_t), rng);
+        return hash;
+    }
+
+    static NodeObject::Ptr makeObject (std::uint64_t key)
+    {
+        std::mt19937_64 rng (key + 1);
+
+        uint256 hash;
+        std::generate_n (reinterpret_cast<std::uint64_t*> (hash.begin ()),
+            hash.size () / sizeof (std::uint64_t), rng);
+
+        std::uint64_t const pick = rng () % 100;
+        NodeObjectType type;
+        std::size_t size;
+
+        if (pick < 60)
+        {
+            type = hotACCOUNT_NODE;
+            size = 128 + (rng () % 65) * 8;     // 128..640
+        }
+        else if (pick < 90)
+        {
+            type = hotTRANSACTION_NODE;
+            size = 256 + (rng () % 97) * 8;     // 256..1024
+        }
+        else
+        {
+            type = hotLEDGER;
+            size = 120;
+        }
+
+        Blob data (size);
+        std::generate_n (reinterpret_cast<std::uint64_t*> (data.data ()),
+            size / sizeof (std::uint64_t), rng);
+
+        return NodeObject::createObject (type,
+            rng () % 10000000, std::move (data), hash);
+    }
+
+    struct WorkerResult
+    {
+        // per-operation latencies in microseconds
+        std::vector<std::uint64_t> reads;
+        std::vector<std::uint64_t> writes;
+    };
+
+    static std::uint64_t percentile (
+        std::vector<std::uint64_t> const& sorted, double p)
+    {
+        if (sorted.empty ())
+            return 0;
+        return sorted[static_cast<std::size_t> (
+            p * (sorted.size () - 1) + 0.5)];
+    }
+
+    void report (std::string const& label, std::vector<std::uint64_t>& v,
+        double elapsed)
+    {
+        if (v.empty ())
+            return;
+
+        std::sort (v.begin (), v.end ());
+
+        std::stringstream out;
+        out << std::setw (6) << label << ":"
+            << " n=" << v.size ()
+            << " ops/s=" << std::uint64_t (v.size () / elapsed)
+            << " p50=" << percentile (v, 0.50) << "us"
+            << " p90=" << percentile (v, 0.90) << "us"
+            << " p99=" << percentile (v, 0.99) << "us"
+            << " p99.9=" << percentile (v, 0.999) << "us"
+            << " max=" << v.back () << "us";
+        log << out.str ();
+    }
+
+    void benchmarkBackend (std::string const& name,
+        beast::StringPairArray const& params, std::int64_t numObjects,
+        std::int64_t numOps, int readPct, int threads)
+    {
+        testcase (name);
+
+        auto manager = make_Manager ();
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        auto backend = manager->make_Backend (params, scheduler, j);
+
+        // Preload the keyspace the readers will draw from
+        Batch batch;
+        for (std::int64_t i = 0; i < numObjects; ++i)
+        {
+            batch.emplace_back (makeObject (i));
+
+            if (batch.size () >= 128)
+            {
+                backend->storeBatch (batch);
+                batch.clear ();
+            }
+        }
+        if (!batch.empty ())
+            backend->storeBatch (batch);
+
+        std::vector<WorkerResult> results (threads);
+        std::vector<std::thread> workers;
+        std::atomic<std::uint64_t> failures (0);
+        std::int64_t const opsPerThread = numOps / threads;
+
+        using clock = std::chrono::steady_clock;
+        auto const started = clock::now ();
+
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back ([&, t] ()
+            {
+                std::mt19937_64 rng (t + 7);
+                WorkerResult& out = results[t];
+                out.reads.reserve (opsPerThread);
+                out.writes.reserve (opsPerThread);
+
+                // Writers get a private key range so they never collide
+                std::uint64_t nextKey = numObjects + t * opsPerThread;
+
+                for (std::int64_t i = 0; i < opsPerThread; ++i)
+                {
+                    if (static_cast<int> (rng () % 100) < readPct)
+                    {
+                        uint256 const hash = keyHash (rng () % numObjects);
+                        NodeObject::Ptr got;
+
+                        auto const t0 = clock::now ();
+                        Status const status =
+                            backend->fetch (hash.cbegin (), &got);
+                        out.reads.push_back (
+                            std::chrono::duration_cast<
+                                std::chrono::microseconds> (
+                                    clock::now () - t0).count ());
+
+                        if (status != ok)
+                            ++failures;
+                    }
+                    else
+                    {
+                        auto node = makeObject (nextKey++);
+
+                        auto const t0 = clock::now ();
+                        backend->store (node);
+                        out.writes.push_back (
+                            std::chrono::duration_cast<
+                                std::chrono::microseconds> (
+                                    clock::now () - t0).count ());
+                    }
+                }
+            });
+        }
+
+        for (auto& w : workers)
+            w.join ();
+
+        double const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>> (clock::now () - started).count ();
+
+        expect (failures == 0, "failed fetches of preloaded objects");
+
+        std::vector<std::uint64_t> reads, writes;
+        for (auto& r : results)
+        {
+            reads.insert (reads.end (), r.reads.begin (), r.reads.end ());
+            writes.insert (writes.end (), r.writes.begin (), r.writes.end ());
+        }
+
+        std::stringstream out;
+        out << "objects=" << numObjects
+            << " ops=" << (opsPerThread * threads)
+            << " read_pct=" << readPct
+            << " threads=" << threads
+            << " elapsed=" << std::fixed << std::setprecision (2)
+            << elapsed << "s";
+        log << out.str ();
+
+        report ("read", reads, elapsed);
+        report ("write", writes, elapsed);
+    }
+
+    void run ()
+    {
+        std::string const defaultArguments =
+            "type=rocksdb,open_files=2000,filter_bits=12,cache_mb=256;"
+            "type=leveldb";
+
+        auto args = arg ();
+
+        if (args.empty ())
+            args = defaultArguments;
+
+        std::vector<std::string> configs;
+        boost::split (configs, args, boost::algorithm::is_any_of (";"));
+
+        for (auto& config : configs)
+        {
+            auto params = parseDelimitedKeyValueString (config, ',');
+
+            std::int64_t numObjects = 100000;
+            std::int64_t numOps = 200000;
+            int readPct = 80;
+            int threads = 4;
+
+            if (!params["num_objects"].isEmpty ())
+                numObjects = params["num_objects"].getIntValue ();
+
+            if (!params["ops"].isEmpty ())
+                numOps = params["ops"].getIntValue ();
+
+            if (!params["read_pct"].isEmpty ())
+                readPct = std::min (100,
+                    std::max (0, params["read_pct"].getIntValue ()));
+
+            if (!params["threads"].isEmpty ())
+                threads = std::max (1, params["threads"].getIntValue ());
+
+            if (params["type"].isEmpty ())
+                params.set ("type", "rocksdb");
+
+            beast::UnitTestUtilities::TempDirectory path ("node_db");
+            params.set ("path", path.getFullPathName ());
+
+            benchmarkBackend (config, params, numObjects, numOps,
+                readPct, threads);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(NodeStoreBenchmark,bench,ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+namespace NodeStore {
+
+class NodeStoreTiered_test : public TestBase
+{
+public:
+    void testPresenceFilter (std::int64_t seedValue)
+    {
+        testcase ("presence filter");
+
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        PresenceFilter filter (1);
+
+        // Insert the first half only
+        int const half = batch.size () / 2;
+
+        for (int i = 0; i < half; ++i)
+            filter.insert (batch [i]->getHash ());
+
+        // Everything inserted must be reported present
+        for (int i = 0; i < half; ++i)
+            expect (filter.maybeContains (batch [i]->getHash ()),
+                "Should maybe contain");
+
+        // Nothing we left out should be reported present; with a
+        // megabyte of bits and this few keys, false positives are
+        // vanishingly unlikely.
+        int falsePositives = 0;
+
+        for (int i = half; i < batch.size (); ++i)
+            if (filter.maybeContains (batch [i]->getHash ()))
+                ++falsePositives;
+
+        expect (falsePositives == 0, "Should not be present");
+    }
+
+    void testTiered (std::string const& type, std::int64_t seedValue)
+    {
+        testcase ("tiered store/fetch '" + type + "'");
+
+        DummyScheduler scheduler;
+        beast::Journal j;
+
+        beast::UnitTestUtilities::TempDirectory cold_db ("cold_db");
+        beast::UnitTestUtilities::TempDirectory hot_db ("hot_db");
+
+        beast::StringPairArray coldParams;
+        coldParams.set ("type", type);
+        coldParams.set ("path", cold_db.getFullPathName ());
+
+        beast::StringPairArray hotParams;
+        hotParams.set ("type", type);
+        hotParams.set ("path", hot_db.getFullPathName ());
+        hotParams.set ("hot_ledgers", "16");
+        hotParams.set ("filter_mb", "1");
+
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        std::unique_ptr <Database> db (manager->make_DatabaseTiered (
+            "test", scheduler, j, 2, coldParams, hotParams));
+
+        // Store a batch: the first half as history, the second half
+        // well past the hot window so a rotation comes due.
+        Batch batch;
+        createPredictableBatch (batch, numObjectsToTest, seedValue);
+
+        int const half = batch.size () / 2;
+
+        for (int i = 0; i < batch.size (); ++i)
+        {
+            Blob data (batch [i]->getData ());
+
+            db->store (batch [i]->getType (),
+                       (i < half) ? 5 : 100,
+                       std::move (data),
+                       batch [i]->getHash ());
+        }
+
+        // Drive a migration deterministically
+        DatabaseTieredImp& tiered (
+            dynamic_cast <DatabaseTieredImp&> (*db));
+        tiered.rotateAndMigrate ();
+
+        // Reopen so fetches go to the backends rather than the cache
+        db.reset ();
+        db = manager->make_DatabaseTiered (
+            "test", scheduler, j, 2, coldParams, hotParams);
+
+        // Everything must remain fetchable, wherever it now lives
+        Batch copy;
+        fetchCopyOfBatch (*db, &copy, batch);
+        expect (areBatchesEqual (batch, copy), "Should be equal");
+
+        // A key that was never stored comes back null
+        uint256 absent;
+        absent.SetHex (
+            "deadbeefdeadbeefdeadbeefdeadbeefdeadbeef"
+            "deadbeefdeadbeefdeadbeef");
+        expect (db->fetch (absent) == nullptr, "Should be absent");
+    }
+
+    void run ()
+    {
+        std::int64_t const seedValue = 85;
+
+        testPresenceFilter (seedValue);
+        testTiered ("leveldb", seedValue);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(NodeStoreTiered,ripple_core,ripple);
+
+} // NodeStore
+} // ripple
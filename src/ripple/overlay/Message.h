@@ -54,15 +54,47 @@ public:
     */
     static size_t const kHeaderBytes = 6;
 
+    enum
+    {
+        /** Set in the type field of frames carrying a compressed payload.
+            Only sent to peers that advertised the codec in their hello.
+        */
+        typeCompressed = 0x8000
+
+        /** Codec bits advertised in TMHello::compression. */
+        ,compressSnappy = 0x0001
+
+        /** Don't bother compressing payloads smaller than this. */
+        ,compressThreshold = 1024
+    };
+
     Message (::google::protobuf::Message const& message, int type);
 
-    /** Retrieve the packed message data. */
+    /** Retrieve the packed message data.
+
+        When `compressionEnabled` is set the compressed form is
+        returned if one was built; either buffer parses to the
+        identical message.
+    */
     std::vector <uint8_t> const&
-    getBuffer () const
+    getBuffer (bool compressionEnabled = false) const
     {
+        if (compressionEnabled && ! mCompressedBuffer.empty ())
+            return mCompressedBuffer;
         return mBuffer;
     }
 
+    /** Expand a compressed payload into a synthetic frame.
+
+        On success `out` holds kHeaderBytes of zeroes followed by the
+        uncompressed payload, ready for the parse path which skips the
+        header anyway.
+
+        @return `false` if the payload is corrupt or unreasonably large.
+    */
+    static bool uncompress (void const* in, std::size_t inBytes,
+        std::vector <std::uint8_t>& out);
+
     /** Determine bytewise equality. */
     bool operator == (Message const& other) const;
 
@@ -145,9 +177,14 @@ private:
 
         // Encodes the size and type into a header at the beginning of buf
     //
-    void encodeHeader (unsigned size, int type);
+    static void encodeHeader (std::vector <uint8_t>& buf,
+        unsigned size, int type);
 
     std::vector <uint8_t> mBuffer;
+
+    // The same payload compressed, empty if compression
+    // was not worthwhile
+    std::vector <uint8_t> mCompressedBuffer;
 };
 
 }
@@ -27,6 +27,7 @@
 #include <beast/threads/Stoppable.h>
 #include <beast/utility/PropertyStream.h>
 #include <memory>
+#include <set>
 #include <beast/cxx14/type_traits.h> // <type_traits>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -120,6 +121,18 @@ public:
     Peer::ptr
     findPeerByShortID (Peer::id_t const& id) = 0;
 
+    /** Relay a transaction to a scored subset of peers not in `skip`.
+
+        Peers are ranked by measured link latency and by how often
+        they have already seen what we relay; the transaction goes to
+        the best links plus a random sample of the rest. Peers left
+        out learn of it through transaction set reconciliation.
+    */
+    virtual
+    void
+    relayTransaction (Message::pointer const& message,
+        std::set<Peer::id_t>&& skip) = 0;
+
     /** Visit every active peer and return a value
         The functor must:
         - Be callable as:
@@ -19,10 +19,21 @@
 
 #include <ripple/overlay/Message.h>
 
+#include <snappy.h>
+
 #include <cstdint>
+#include <cstring>
 
 namespace ripple {
 
+namespace {
+
+// Largest payload we are willing to inflate a compressed frame to.
+// Matches the practical upper bound of uncompressed protocol messages.
+std::size_t const maxUncompressedBytes = 64 * 1024 * 1024;
+
+}
+
 Message::Message (::google::protobuf::Message const& message, int type)
 {
     unsigned const messageBytes = message.ByteSize ();
@@ -31,12 +42,49 @@ Message::Message (::google::protobuf::Message const& message, int type)
 
     mBuffer.resize (kHeaderBytes + messageBytes);
 
-    encodeHeader (messageBytes, type);
+    encodeHeader (mBuffer, messageBytes, type);
 
     if (messageBytes != 0)
     {
         message.SerializeToArray (&mBuffer [Message::kHeaderBytes], messageBytes);
     }
+
+    if (messageBytes >= compressThreshold)
+    {
+        std::string compressed;
+        snappy::Compress (reinterpret_cast <char const*> (
+            &mBuffer [kHeaderBytes]), messageBytes, &compressed);
+
+        // Only keep the compressed form if it actually saves wire bytes
+        if (compressed.size () < messageBytes)
+        {
+            mCompressedBuffer.resize (kHeaderBytes + compressed.size ());
+            encodeHeader (mCompressedBuffer,
+                static_cast <unsigned> (compressed.size ()),
+                    type | typeCompressed);
+            std::memcpy (&mCompressedBuffer [kHeaderBytes],
+                compressed.data (), compressed.size ());
+        }
+    }
+}
+
+bool Message::uncompress (void const* in, std::size_t inBytes,
+    std::vector <std::uint8_t>& out)
+{
+    char const* const data = reinterpret_cast <char const*> (in);
+
+    std::size_t uncompressedBytes;
+    if (! snappy::GetUncompressedLength (data, inBytes, &uncompressedBytes))
+        return false;
+
+    if (uncompressedBytes > maxUncompressedBytes)
+        return false;
+
+    out.resize (kHeaderBytes + uncompressedBytes);
+    std::memset (&out [0], 0, kHeaderBytes);
+
+    return snappy::RawUncompress (data, inBytes,
+        reinterpret_cast <char*> (&out [kHeaderBytes]));
 }
 
 bool Message::operator== (Message const& other) const
@@ -77,15 +125,16 @@ int Message::getType (std::vector<uint8_t> const& buf)
     return ret;
 }
 
-void Message::encodeHeader (unsigned size, int type)
+void Message::encodeHeader (std::vector <uint8_t>& buf,
+    unsigned size, int type)
 {
-    assert (mBuffer.size () >= Message::kHeaderBytes);
-    mBuffer[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
-    mBuffer[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
-    mBuffer[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
-    mBuffer[3] = static_cast<std::uint8_t> (size & 0xFF);
-    mBuffer[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
-    mBuffer[5] = static_cast<std::uint8_t> (type & 0xFF);
+    assert (buf.size () >= Message::kHeaderBytes);
+    buf[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
+    buf[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
+    buf[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
+    buf[3] = static_cast<std::uint8_t> (size & 0xFF);
+    buf[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
+    buf[5] = static_cast<std::uint8_t> (type & 0xFF);
 }
 
 }
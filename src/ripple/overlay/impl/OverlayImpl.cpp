@@ -24,11 +24,13 @@
 #include <ripple/overlay/impl/OverlayImpl.h>
 #include <ripple/overlay/impl/PeerImp.h>
 #include <ripple/overlay/impl/TMHello.h>
+#include <ripple/overlay/impl/Tuning.h>
 #include <ripple/peerfinder/make_Manager.h>
 #include <beast/ByteOrder.h>
 #include <beast/http/rfc2616.h>
 #include <beast/utility/ci_char_traits.h>
 #include <beast/utility/WrappedSink.h>
+#include <algorithm>
 
 namespace ripple {
 
@@ -105,6 +107,12 @@ OverlayImpl::Timer::on_timer (error_code ec)
     overlay_.sendEndpoints();
     overlay_.autoConnect();
 
+    if ((++tick_ % Tuning::pingIntervalSeconds) == 0)
+        overlay_.sendPings();
+
+    if ((tick_ % Tuning::linkCheckSeconds) == 0)
+        overlay_.checkLinkQuality();
+
     timer_.expires_from_now (std::chrono::seconds(1));
     timer_.async_wait(overlay_.strand_.wrap(std::bind(
         &Timer::on_timer, shared_from_this(),
@@ -125,6 +133,7 @@ OverlayImpl::OverlayImpl (
     , io_service_ (io_service)
     , work_ (boost::in_place(std::ref(io_service_)))
     , strand_ (io_service_)
+    , relayTimer_ (io_service_)
     , setup_(setup)
     , journal_ (deprecatedLogs().journal("Overlay"))
     , serverHandler_(serverHandler)
@@ -658,6 +667,7 @@ OverlayImpl::stop()
     if (work_)
     {
         work_ = boost::none;
+        relayTimer_.cancel();
         for (auto& _ : list_)
         {
             auto const child = _.second.lock();
@@ -676,24 +686,257 @@ OverlayImpl::autoConnect()
         connect (addr);
 }
 
+std::shared_ptr<PeerImp>
+OverlayImpl::findPeerBySlot (PeerFinder::Slot::ptr const& slot)
+{
+    std::lock_guard <decltype(mutex_)> lock (mutex_);
+    auto const iter = m_peers.find (slot);
+    if (iter != m_peers.end())
+        return iter->second.lock();
+    return nullptr;
+}
+
 void
 OverlayImpl::sendEndpoints()
 {
-    auto const result = m_peerFinder->buildEndpointsForPeers();
-    for (auto const& e : result)
+    auto const gossip = m_peerFinder->buildEndpointsForPeers();
+
+    // The shared list is serialized once; the same refcounted message
+    // goes to every slot receiving it verbatim.
+    if (! gossip.shared.empty())
     {
-        std::shared_ptr<PeerImp> peer;
+        Message::pointer const msg = makeEndpointsMessage (
+            gossip.list.begin(), gossip.list.end());
+        for (auto const& slot : gossip.shared)
         {
-            std::lock_guard <decltype(mutex_)> lock (mutex_);
-            auto const iter = m_peers.find (e.first);
-            if (iter != m_peers.end())
-                peer = iter->second.lock();
+            if (auto const peer = findPeerBySlot (slot))
+                peer->send (msg);
         }
-        if (peer)
+    }
+
+    for (auto const& e : gossip.custom)
+    {
+        if (auto const peer = findPeerBySlot (e.first))
             peer->sendEndpoints (e.second.begin(), e.second.end());
     }
 }
 
+void
+OverlayImpl::sendPings()
+{
+    std::vector<std::shared_ptr<PeerImp>> peers;
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        peers.reserve (m_peers.size());
+        for (auto const& e : m_peers)
+        {
+            auto const peer = e.second.lock();
+            if (peer)
+                peers.push_back (peer);
+        }
+    }
+
+    for (auto const& peer : peers)
+        peer->sendPing();
+}
+
+int
+OverlayImpl::markValidation (uint256 const& key)
+{
+    auto const now = clock_type::now();
+    std::lock_guard <decltype(mutex_)> lock (mutex_);
+
+    // Keep the table bounded; stamps older than a minute no longer
+    // correspond to validations still circulating
+    if (firstSeen_.size() > 4096)
+    {
+        auto const cutoff = now - std::chrono::minutes (1);
+        for (auto iter = firstSeen_.begin(); iter != firstSeen_.end();)
+        {
+            if (iter->second < cutoff)
+                iter = firstSeen_.erase (iter);
+            else
+                ++iter;
+        }
+    }
+
+    auto const result = firstSeen_.emplace (key, now);
+    if (result.second)
+        return 0;
+    return static_cast<int> (std::chrono::duration_cast<
+        std::chrono::milliseconds> (now - result.first->second).count());
+}
+
+void
+OverlayImpl::checkLinkQuality()
+{
+    std::shared_ptr<PeerImp> worst;
+    PeerFinder::Slot::ptr worstSlot;
+    int worstScore = -1;
+    std::vector<int> scores;
+
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        for (auto const& e : m_peers)
+        {
+            auto const peer = e.second.lock();
+            if (! peer)
+                continue;
+
+            // Only automatic outbound links are ours to replace
+            auto const& slot = e.first;
+            if (slot->inbound() || slot->fixed() || slot->cluster())
+                continue;
+
+            int const score = peer->getLinkScore();
+            if (score < 0)
+                continue;
+
+            scores.push_back (score);
+            if (score > worstScore)
+            {
+                worstScore = score;
+                worst = peer;
+                worstSlot = slot;
+            }
+        }
+    }
+
+    // Need a field to judge against
+    if (scores.size() < 4)
+        return;
+
+    std::nth_element (scores.begin(),
+        scores.begin() + scores.size() / 2, scores.end());
+    int const median = scores[scores.size() / 2];
+
+    // Replace only a clear outlier, so a uniformly healthy (or
+    // uniformly distant) set of links is left alone
+    if (worstScore < 2 * median + 100)
+        return;
+
+    if (journal_.info) journal_.info <<
+        "Replacing slow link " << worst->getRemoteAddress() <<
+        " score " << worstScore << " (median " << median << ")";
+
+    // Demote the address so reconnection prefers other candidates,
+    // then close; autoconnect will dial a replacement
+    m_peerFinder->on_sluggish (worstSlot);
+    worst->stop();
+}
+
+void
+OverlayImpl::relayTransaction (Message::pointer const& message,
+    std::set<Peer::id_t>&& skip)
+{
+    std::vector<std::shared_ptr<PeerImp>> eligible;
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        eligible.reserve (m_peers.size());
+        for (auto const& e : m_peers)
+        {
+            auto const peer = e.second.lock();
+            if (peer && ! skip.count (peer->id()))
+                eligible.push_back (peer);
+        }
+    }
+
+    std::size_t const target = std::max<std::size_t> (
+        Tuning::relayMinPeers,
+        eligible.size() / Tuning::relayFanoutDivisor);
+
+    if (eligible.size() <= target)
+    {
+        for (auto const& peer : eligible)
+            peer->send (message);
+        return;
+    }
+
+    // Cluster members always get the transaction. Everyone else is
+    // scored by link quality: the smoothed ping round trip plus a
+    // penalty for the share of our past relays the peer already had.
+    std::vector<std::pair<int, std::shared_ptr<PeerImp>>> ranked;
+    ranked.reserve (eligible.size());
+    for (auto const& peer : eligible)
+    {
+        if (peer->cluster())
+        {
+            peer->send (message);
+            continue;
+        }
+
+        int const latency = peer->getLatency();
+        int score = (latency < 0) ?
+            int (Tuning::relayUnknownLatency) : latency;
+        score += (peer->getDuplicateRate() *
+            Tuning::relayDuplicatePenalty) / 100;
+        ranked.emplace_back (score, peer);
+    }
+
+    std::sort (ranked.begin(), ranked.end(),
+        [] (std::pair<int, std::shared_ptr<PeerImp>> const& lhs,
+            std::pair<int, std::shared_ptr<PeerImp>> const& rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+    // The best links get it outright; the rest of the budget goes to
+    // a random sample of the others, so remote corners of the
+    // topology still hear new transactions firsthand and freshly
+    // connected peers get a chance to earn a score.
+    std::size_t const best = (target * 3) / 4;
+
+    if (ranked.size() > best)
+        std::random_shuffle (ranked.begin() + best, ranked.end());
+
+    std::size_t const count = std::min (target, ranked.size());
+    for (std::size_t i = 0; i < count; ++i)
+        ranked[i].second->send (message);
+}
+
+void
+OverlayImpl::relayValidation (Message::pointer const& message,
+    std::set<Peer::id_t>&& skip)
+{
+    std::lock_guard <decltype(mutex_)> lock (mutex_);
+
+    pendingValidations_.emplace_back (message, std::move (skip));
+
+    if (! validationFlushPending_)
+    {
+        validationFlushPending_ = true;
+        relayTimer_.expires_from_now (std::chrono::milliseconds (
+            Tuning::validationRelayMilliseconds));
+        relayTimer_.async_wait (strand_.wrap (
+            [this] (error_code ec)
+            {
+                if (ec != boost::asio::error::operation_aborted)
+                    flushValidations();
+            }));
+    }
+}
+
+void
+OverlayImpl::flushValidations()
+{
+    decltype(pendingValidations_) pending;
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        validationFlushPending_ = false;
+        std::swap (pending, pendingValidations_);
+    }
+
+    if (pending.empty())
+        return;
+
+    // One pass over the peer list delivers everything that accumulated;
+    // back to back sends to a peer coalesce into a single socket write.
+    for (auto const& peer : getActivePeers())
+        for (auto const& v : pending)
+            if (v.second.count (peer->id()) == 0)
+                peer->send (v.first);
+}
+
 
 //------------------------------------------------------------------------------
 
@@ -39,6 +39,7 @@
 #include <condition_variable>
 #include <beast/cxx14/memory.h> // <memory>
 #include <mutex>
+#include <set>
 #include <unordered_map>
 
 namespace ripple {
@@ -74,6 +75,7 @@ private:
         , std::enable_shared_from_this<Timer>
     {
         boost::asio::basic_waitable_timer <clock_type> timer_;
+        std::size_t tick_ = 0;
 
         explicit
         Timer (OverlayImpl& overlay);
@@ -95,6 +97,17 @@ private:
     std::recursive_mutex mutex_; // VFALCO use std::mutex
     std::condition_variable_any cond_;
     std::weak_ptr<Timer> timer_;
+
+    // Validations waiting for the relay flush timer, with the peers
+    // each one must not be sent back to
+    std::vector<std::pair<Message::pointer,
+        std::set<Peer::id_t>>> pendingValidations_;
+    bool validationFlushPending_ = false;
+    boost::asio::basic_waitable_timer<clock_type> relayTimer_;
+
+    // First-delivery stamps for circulating validations, keyed by
+    // suppression hash; measures how far each peer trails the field
+    hash_map<uint256, clock_type::time_point> firstSeen_;
     boost::container::flat_map<
         Child*, std::weak_ptr<Child>> list_;
 
@@ -188,6 +201,33 @@ public:
     void
     onPeerDeactivate (Peer::id_t id, RippleAddress const& publicKey);
 
+    /** Relay a validation to every peer not in `skip`.
+
+        Validations accumulate for a few milliseconds and are fanned
+        out in one pass over the peer list; consecutive sends to each
+        peer coalesce into a single socket write. The Message buffer
+        is shared across all peers.
+    */
+    void
+    relayValidation (Message::pointer const& message,
+        std::set<Peer::id_t>&& skip);
+
+    /** Stamp a validation delivery.
+        @return Milliseconds since the first peer delivered it, or
+                zero if this is the first delivery.
+    */
+    int
+    markValidation (uint256 const& key);
+
+    /** Relay a transaction to a scored subset of peers not in `skip`.
+
+        Cluster members always receive it; other peers are ranked by
+        ping latency and duplicate rate (see Overlay::relayTransaction).
+    */
+    void
+    relayTransaction (Message::pointer const& message,
+        std::set<Peer::id_t>&& skip) override;
+
     static
     bool
     isPeerUpgrade (beast::http::message const& request);
@@ -252,8 +292,22 @@ private:
     void
     autoConnect();
 
+    std::shared_ptr<PeerImp>
+    findPeerBySlot (PeerFinder::Slot::ptr const& slot);
+
     void
     sendEndpoints();
+
+    void
+    sendPings();
+
+    void
+    flushValidations();
+
+    /** Close the worst-scoring automatic outbound link, if it is a
+        clear outlier against the rest. */
+    void
+    checkLinkQuality();
 };
 
 } // ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/misc/SignatureVerifier.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/basics/UptimeTimer.h>
 #include <ripple/core/JobQueue.h>
@@ -27,6 +28,8 @@
 #include <ripple/resource/Fees.h>
 #include <ripple/server/ServerHandler.h>
 #include <ripple/protocol/BuildInfo.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/Indexes.h>
 #include <beast/streams/debug_ostream.h>
 #include <beast/weak_fn.h>
 #include <functional>
@@ -51,7 +54,6 @@ PeerImp::PeerImp (id_t id, endpoint_type remote_endpoint,
     , socket_ (ssl_bundle_->socket)
     , stream_ (ssl_bundle_->stream)
     , strand_ (socket_.get_io_service())
-    , timer_ (socket_.get_io_service())
     , remote_address_ (
         beast::IPAddressConversion::from_asio(remote_endpoint))
     , overlay_ (overlay)
@@ -156,20 +158,83 @@ PeerImp::send (Message::pointer const& m)
         return;
     if(detaching_)
         return;
-    send_queue_.push(m);
-    if(send_queue_.size() > 1)
+    bool const busy = sendQueueSize() > 0;
+    send_lanes_[messageLane(m)].push_back(m);
+    if (busy)
         return;
     setTimer();
-    boost::asio::async_write (stream_, boost::asio::buffer(
-        send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-            &PeerImp::onWriteMessage, shared_from_this(),
-                beast::asio::placeholders::error,
-                    beast::asio::placeholders::bytes_transferred)));
+    startWriteMessages();
+}
+
+int
+PeerImp::messageLane (Message::pointer const& m)
+{
+    switch (Message::getType (m->getBuffer()))
+    {
+    case protocol::mtPROPOSE_LEDGER:
+    case protocol::mtVALIDATION:
+    case protocol::mtSTATUS_CHANGE:
+        return laneConsensus;
+
+    case protocol::mtTRANSACTION:
+        return laneTransaction;
+
+    default:
+        return laneBulk;
+    }
+}
+
+std::size_t
+PeerImp::sendQueueSize () const
+{
+    std::size_t n = 0;
+    for (auto const& lane : send_lanes_)
+        n += lane.size();
+    return n;
+}
+
+void
+PeerImp::startWriteMessages ()
+{
+    // Coalesce the queued messages into one scatter-gather write so a
+    // burst of small messages costs one syscall instead of one each.
+    // Lanes drain in priority order: megabytes of queued ledger data
+    // can't hold up a proposal, but bulk traffic still fills whatever
+    // room a write has left.
+    assert(strand_.running_in_this_thread());
+    assert(sendQueueSize() != 0);
+
+    bool const compress = compressionEnabled();
+    std::vector<boost::asio::const_buffer> buffers;
+    std::size_t count = 0;
+    for (int lane = 0; lane < laneCount; ++lane)
+    {
+        write_counts_[lane] = 0;
+        for (auto const& m : send_lanes_[lane])
+        {
+            if (count >= Tuning::sendQueueCoalesce)
+                break;
+            buffers.emplace_back(boost::asio::buffer(
+                m->getBuffer(compress)));
+            ++write_counts_[lane];
+            ++count;
+        }
+    }
+
+    boost::asio::async_write (stream_, buffers, strand_.wrap(std::bind(
+        &PeerImp::onWriteMessage, shared_from_this(),
+            beast::asio::placeholders::error,
+                beast::asio::placeholders::bytes_transferred)));
 }
 
 void
 PeerImp::charge (Resource::Charge const& fee)
 {
+    // Cluster links are trusted and never metered; charging them can
+    // only disconnect our own cluster under load.
+    if (cluster())
+        return;
+
     if ((usage_.charge(fee) == Resource::drop) && usage_.disconnect())
         fail("charge: Resources");
 }
@@ -293,6 +358,14 @@ PeerImp::supportsVersion (int version)
     return hello_.has_protoversion () && (hello_.protoversion () >= version);
 }
 
+bool
+PeerImp::compressionEnabled () const
+{
+    // The peer told us in its hello which codecs it will accept
+    return hello_.has_compression () &&
+        ((hello_.compression () & Message::compressSnappy) != 0);
+}
+
 bool
 PeerImp::hasRange (std::uint32_t uMin, std::uint32_t uMax)
 {
@@ -309,7 +382,7 @@ PeerImp::close()
     {
         detaching_ = true; // DEPRECATED
         error_code ec;
-        timer_.cancel(ec);
+        timer_.cancel();
         socket_.close(ec);
         if(m_inbound)
         {
@@ -351,12 +424,7 @@ PeerImp::gracefulClose()
     assert(socket_.is_open());
     assert(! gracefulClose_);
     gracefulClose_ = true;
-#if 0
-    // Flush messages
-    while(send_queue_.size() > 1)
-        send_queue_.pop_back();
-#endif
-    if (send_queue_.size() > 0)
+    if (sendQueueSize() > 0)
         return;
     setTimer();
     stream_.async_shutdown(strand_.wrap(std::bind(&PeerImp::onShutdown,
@@ -366,24 +434,22 @@ PeerImp::gracefulClose()
 void
 PeerImp::setTimer()
 {
-    error_code ec;
-    timer_.expires_from_now(std::chrono::seconds(15), ec);
-    if (ec)
-    {
-        if (journal_.error) journal_.error <<
-            "setTimer: " << ec.message();
-        return;
-    }
-    timer_.async_wait(strand_.wrap(std::bind(&PeerImp::onTimer,
-        shared_from_this(), beast::asio::placeholders::error)));
+    // The wheel fires on its own thread; bounce the timeout
+    // onto our strand before acting on it.
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    getApp().getTimerWheel().schedule (timer_, 15 * 1000,
+        [weak]()
+        {
+            if (auto const peer = weak.lock())
+                peer->strand_.post (std::bind (
+                    &PeerImp::onTimer, peer));
+        });
 }
 
-// convenience for ignoring the error code
 void
 PeerImp::cancelTimer()
 {
-    error_code ec;
-    timer_.cancel(ec);
+    timer_.cancel();
 }
 
 //------------------------------------------------------------------------------
@@ -419,22 +485,12 @@ PeerImp::makeRequest(boost::asio::ip::address const& remote_address)
 }
 
 void
-PeerImp::onTimer (error_code const& ec)
+PeerImp::onTimer ()
 {
+    // A cancel may have raced with the wheel firing
     if (! socket_.is_open())
         return;
 
-    if (ec == boost::asio::error::operation_aborted)
-        return;
-
-    if (ec)
-    {
-        // This should never happen
-        if (journal_.error) journal_.error <<
-            "onTimer: " << ec.message();
-        return close();
-    }
-
     fail("Timeout");
 }
 
@@ -619,17 +675,41 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
 
     read_buffer_.commit (bytes_transferred);
 
+    // Let consensus-critical messages jump any bulk data queued
+    // ahead of them in this read
+    std::vector<std::size_t> dispatched;
+    std::tie(dispatched, ec) = invokePriorityMessages(
+        read_buffer_.data(), *this);
+    if (ec)
+        return fail("onReadMessage", ec);
+    if (! stream_.next_layer().is_open())
+        return;
+
+    std::size_t offset = 0;
+    auto skip = dispatched.begin();
+
     while (read_buffer_.size() > 0)
     {
         std::size_t bytes_consumed;
-        std::tie(bytes_consumed, ec) = invokeProtocolMessage(
-            read_buffer_.data(), *this);
-        if (ec)
-            return fail("onReadMessage", ec);
-        if (! stream_.next_layer().is_open())
-            return;
-        if (bytes_consumed == 0)
-            break;
+        if (skip != dispatched.end() && *skip == offset)
+        {
+            // Already dispatched ahead of order; just consume it
+            bytes_consumed = Message::kHeaderBytes +
+                Message::size(read_buffer_.data());
+            ++skip;
+        }
+        else
+        {
+            std::tie(bytes_consumed, ec) = invokeProtocolMessage(
+                read_buffer_.data(), *this);
+            if (ec)
+                return fail("onReadMessage", ec);
+            if (! stream_.next_layer().is_open())
+                return;
+            if (bytes_consumed == 0)
+                break;
+        }
+        offset += bytes_consumed;
         read_buffer_.consume (bytes_consumed);
     }
     if(gracefulClose_)
@@ -659,17 +739,18 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
             "onWriteMessage";
     }
 
-    assert(! send_queue_.empty());
-    send_queue_.pop();
-    if (! send_queue_.empty())
+    for (int lane = 0; lane < laneCount; ++lane)
+    {
+        assert(send_lanes_[lane].size() >= write_counts_[lane]);
+        send_lanes_[lane].erase(send_lanes_[lane].begin(),
+            send_lanes_[lane].begin() + write_counts_[lane]);
+        write_counts_[lane] = 0;
+    }
+    if (sendQueueSize() != 0)
     {
         // Timeout on writes only
         setTimer();
-        return boost::asio::async_write (stream_, boost::asio::buffer(
-            send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-                &PeerImp::onWriteMessage, shared_from_this(),
-                    beast::asio::placeholders::error,
-                        beast::asio::placeholders::bytes_transferred)));
+        return startWriteMessages();
     }
 
     if (gracefulClose_)
@@ -854,6 +935,20 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMPing> const& m)
         m->set_type (protocol::TMPing::ptPONG);
         send (std::make_shared<Message> (*m, protocol::mtPING));
     }
+    else if (m->type () == protocol::TMPing::ptPONG)
+    {
+        if (m->has_seq () && (m->seq () == pingSeq_))
+        {
+            auto const now = std::chrono::duration_cast<
+                std::chrono::milliseconds> (
+                    clock_type::now ().time_since_epoch ()).count ();
+            int const sample = static_cast<int> (now - pingSent_);
+            int const average = latency_;
+
+            latency_ = (average < 0) ? sample :
+                (average * 7 + sample) / 8;
+        }
+    }
 }
 
 void
@@ -980,21 +1075,40 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         return;
     }
 
+    if (getConfig ().RUN_REPLICA)
+    {
+        // A replica neither applies nor relays network transactions;
+        // every ledger arrives from upstream already closed. Only
+        // transactions submitted by our own clients matter here, and
+        // those do not come in over the peer protocol.
+        return;
+    }
+
     Serializer s (m->rawtransaction ());
 
     try
     {
-        SerializerIterator sit (s);
-        STTx::pointer stx = std::make_shared <
-            STTx> (std::ref (sit));
-        uint256 txID = stx->getTransactionID ();
+        // The canonical transaction ID is the hash of the prefixed,
+        // canonically serialized transaction, and honest peers relay
+        // canonical bytes, so the ID can be computed straight off the
+        // wire. At relay volume most copies are duplicates, and this
+        // drops them before paying for a deserialization.
+        Serializer prefixed;
+        prefixed.add32 (HashPrefix::transactionID);
+        prefixed.addRaw (m->rawtransaction ().data (),
+            m->rawtransaction ().size ());
+        uint256 txID = prefixed.getSHA512Half ();
 
         int flags;
 
+        ++txReceived_;
+
         if (! getApp().getHashRouter ().addSuppressionPeer (
             txID, id_, flags))
         {
             // we have seen this transaction recently
+            ++txDuplicate_;
+
             if (flags & SF_BAD)
             {
                 charge (Resource::feeInvalidSignature);
@@ -1005,6 +1119,34 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
                 return;
         }
 
+        SerializerIterator sit (s);
+        STTx::pointer stx = std::make_shared <
+            STTx> (std::ref (sit));
+
+        if (stx->getTransactionID () != txID)
+        {
+            // A non-canonical encoding hashes to something other
+            // than the real ID. Repeat the checks under the real ID
+            // so a peer cannot sneak repeats past the router by
+            // permuting fields.
+            txID = stx->getTransactionID ();
+
+            if (! getApp().getHashRouter ().addSuppressionPeer (
+                txID, id_, flags))
+            {
+                ++txDuplicate_;
+
+                if (flags & SF_BAD)
+                {
+                    charge (Resource::feeInvalidSignature);
+                    return;
+                }
+
+                if (!(flags & SF_RETRY))
+                    return;
+            }
+        }
+
         p_journal_.debug <<
             "Got tx " << txID;
 
@@ -1017,7 +1159,13 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
                 flags |= SF_TRUSTED;
             }
 
-            if (! getConfig().VALIDATION_PRIV.isSet())
+            if (m->has_sigverified () && m->sigverified ())
+            {
+                // A cluster member attests it already verified the
+                // signature; don't verify it on every cluster node
+                flags |= SF_SIGGOOD;
+            }
+            else if (! getConfig().VALIDATION_PRIV.isSet())
             {
                 // For now, be paranoid and have each validator
                 // check each transaction, regardless of source
@@ -1029,11 +1177,45 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             p_journal_.info << "Transaction queue is full";
         else if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
             p_journal_.trace << "No new transactions until synchronized";
-        else
+        else if (flags & SF_SIGGOOD)
+        {
+            prefetchTxState (stx);
             getApp().getJobQueue ().addJob (jtTRANSACTION,
                 "recvTransaction->checkTransaction",
                 std::bind(beast::weak_fn(&PeerImp::checkTransaction,
                 shared_from_this()), std::placeholders::_1, flags, stx));
+        }
+        else
+        {
+            prefetchTxState (stx);
+
+            // Check the signature on the dedicated pool so the
+            // jtTRANSACTION job lanes never block on crypto.
+            std::weak_ptr <PeerImp> weak = shared_from_this ();
+            getApp().getSignatureVerifier ().verify (stx,
+                [weak, flags] (STTx::pointer tx, bool sigGood)
+                {
+                    if (! sigGood)
+                    {
+                        getApp().getHashRouter ().setFlag (
+                            tx->getTransactionID (), SF_BAD);
+                        if (auto peer = weak.lock ())
+                            peer->charge (Resource::feeInvalidSignature);
+                        return;
+                    }
+
+                    getApp().getHashRouter ().setFlag (
+                        tx->getTransactionID (), SF_SIGGOOD);
+
+                    if (auto peer = weak.lock ())
+                        getApp().getJobQueue ().addJob (jtTRANSACTION,
+                            "recvTransaction->checkTransaction",
+                            std::bind (beast::weak_fn (
+                                &PeerImp::checkTransaction, peer),
+                                std::placeholders::_1,
+                                flags | SF_SIGGOOD, tx));
+                });
+        }
     }
     catch (...)
     {
@@ -1176,7 +1358,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
     uint256 consensusLCL;
 
     {
-        Application::ScopedLockType lock (getApp ().getMasterLock ());
+        MasterLockGuard lock (getApp ().consensusLock ());
         consensusLCL = getApp().getOPs ().getConsensusLCL ();
     }
 
@@ -1279,7 +1461,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMHaveTransactionSet> const& m)
         addTxSet (hash);
 
     {
-        Application::ScopedLockType lock (getApp ().getMasterLock ());
+        MasterLockGuard lock (getApp ().consensusLock ());
 
         if (!getApp().getOPs ().hasTXSet (
                 shared_from_this (), hash, m->status ()))
@@ -1314,10 +1496,29 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
             return;
         }
 
+        uint256 const suppression = s.getSHA512Half();
+
+        // How far this peer trailed the first to deliver the
+        // validation; feeds the link quality score
+        {
+            int const sample = overlay_.markValidation (suppression);
+            int const average = validationLag_;
+
+            validationLag_ = (average < 0) ? sample :
+                (average * 7 + sample) / 8;
+        }
+
+        int sflags;
+
         if (! getApp().getHashRouter ().addSuppressionPeer (
-            s.getSHA512Half(), id_))
+            suppression, id_, sflags))
         {
-            p_journal_.trace << "Validation: duplicate";
+            // A peer replaying a validation we already know is bad
+            // only costs us this probe
+            if (sflags & SF_BAD)
+                charge (Resource::feeInvalidRequest);
+            else
+                p_journal_.trace << "Validation: duplicate";
             return;
         }
 
@@ -1328,7 +1529,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
                 jtVALIDATION_t : jtVALIDATION_ut, "recvValidation->checkValidation",
                     std::bind(beast::weak_fn(&PeerImp::checkValidation,
                         shared_from_this()), std::placeholders::_1, val,
-                            isTrusted, m));
+                            suppression, isTrusted, m));
         }
         else
         {
@@ -1483,6 +1684,46 @@ PeerImp::sendGetPeers ()
     send (packet);
 }
 
+void
+PeerImp::sendPing ()
+{
+    protocol::TMPing msg;
+
+    msg.set_type (protocol::TMPing::ptPING);
+    msg.set_seq (++pingSeq_);
+
+    pingSent_ = std::chrono::duration_cast<std::chrono::milliseconds> (
+        clock_type::now ().time_since_epoch ()).count ();
+
+    send (std::make_shared<Message> (msg, protocol::mtPING));
+}
+
+int
+PeerImp::getLinkScore () const
+{
+    int const rtt = latency_.load ();
+    int const lag = validationLag_.load ();
+
+    if ((rtt < 0) || (lag < 0))
+        return -1;
+
+    // Validation lag is what actually delays consensus, so it
+    // dominates the raw round trip
+    return rtt + 4 * lag;
+}
+
+int
+PeerImp::getDuplicateRate () const
+{
+    std::uint32_t const received = txReceived_;
+
+    // Too small a sample to judge the peer by
+    if (received < 32)
+        return 0;
+
+    return (txDuplicate_.load () * 100) / received;
+}
+
 bool
 PeerImp::sendHello()
 {
@@ -1561,6 +1802,66 @@ PeerImp::doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet
                 packet, hash, UptimeTimer::getInstance ().getElapsedSeconds ()));
 }
 
+void
+PeerImp::prefetchTxState (STTx::ref stx)
+{
+    // Use the last closed ledger: it is immutable, so it can be
+    // walked from this thread, and it shares its unchanged state
+    // nodes and the tree node cache with the open ledger the engine
+    // will apply against.
+    auto const ledger = getApp().getLedgerMaster ().getClosedLedger ();
+
+    if (! ledger)
+        return;
+
+    auto const& stateMap = ledger->peekAccountStateMap ();
+
+    if (! stateMap)
+        return;
+
+    Account const account = stx->getFieldAccount160 (sfAccount);
+    stateMap->prefetchItem (getAccountRootIndex (account));
+
+    Account dest;
+    bool const hasDest = stx->isFieldPresent (sfDestination);
+
+    if (hasDest)
+    {
+        dest = stx->getFieldAccount160 (sfDestination);
+        stateMap->prefetchItem (getAccountRootIndex (dest));
+    }
+
+    // Issued amounts name their issuer; the trust lines between the
+    // parties and that issuer are the likely next entries touched
+    for (auto const field : { &sfAmount, &sfSendMax,
+        &sfTakerPays, &sfTakerGets })
+    {
+        if (! stx->isFieldPresent (*field))
+            continue;
+
+        STAmount const amount = stx->getFieldAmount (*field);
+
+        if (amount.isNative ())
+            continue;
+
+        stateMap->prefetchItem (getRippleStateIndex (
+            account, amount.getIssuer (), amount.getCurrency ()));
+
+        if (hasDest)
+            stateMap->prefetchItem (getRippleStateIndex (
+                dest, amount.getIssuer (), amount.getCurrency ()));
+    }
+
+    auto const type = stx->getTxnType ();
+
+    if (type == ttOFFER_CREATE)
+        stateMap->prefetchItem (getOwnerDirIndex (account));
+    else if (type == ttOFFER_CANCEL &&
+             stx->isFieldPresent (sfOfferSequence))
+        stateMap->prefetchItem (getOfferIndex (
+            account, stx->getFieldU32 (sfOfferSequence)));
+}
+
 void
 PeerImp::checkTransaction (Job&, int flags,
     STTx::pointer stx)
@@ -1655,7 +1956,8 @@ PeerImp::checkPropose (Job& job,
         getApp().getOPs ().processTrustedProposal (
             proposal, packet, publicKey_, prevLedger, sigGood);
     }
-    else if (sigGood && (prevLedger == consensusLCL))
+    else if (sigGood && (prevLedger == consensusLCL) &&
+        ! getConfig ().PEER_LEAF)
     {
         // relay untrusted proposal
         p_journal_.trace <<
@@ -1678,19 +1980,43 @@ PeerImp::checkPropose (Job& job,
 }
 
 void
-PeerImp::checkValidation (Job&, STValidation::pointer val,
+PeerImp::checkValidation (Job&, STValidation::pointer val, uint256 suppression,
     bool isTrusted, std::shared_ptr<protocol::TMValidation> const& packet)
 {
     try
     {
         // VFALCO Which functions throw?
         uint256 signingHash = val->getSigningHash();
-        if (! cluster() && !val->isValid (signingHash))
+
+        if (! cluster())
         {
-            p_journal_.warning <<
-                "Validation is invalid";
-            charge (Resource::feeInvalidRequest);
-            return;
+            // The verdict lives on the suppression entry, so anything
+            // that sees this validation again within the hold window
+            // gets the answer with a probe instead of an ECDSA verify
+            int const sflags = getApp().getHashRouter ().getFlags (
+                suppression);
+
+            if (sflags & SF_BAD)
+            {
+                p_journal_.warning <<
+                    "Validation is invalid";
+                charge (Resource::feeInvalidRequest);
+                return;
+            }
+
+            if (! (sflags & SF_SIGGOOD))
+            {
+                if (! val->isValid (signingHash))
+                {
+                    getApp().getHashRouter ().setFlag (suppression, SF_BAD);
+                    p_journal_.warning <<
+                        "Validation is invalid";
+                    charge (Resource::feeInvalidRequest);
+                    return;
+                }
+
+                getApp().getHashRouter ().setFlag (suppression, SF_SIGGOOD);
+            }
         }
 
     #if RIPPLE_HOOK_VALIDATORS
@@ -1699,12 +2025,15 @@ PeerImp::checkValidation (Job&, STValidation::pointer val,
 
         std::set<Peer::id_t> peers;
         if (getApp().getOPs ().recvValidation (val, std::to_string(id())) &&
+                ! getConfig ().PEER_LEAF &&
                 getApp().getHashRouter ().swapSet (
                     signingHash, peers, SF_RELAYED))
         {
-            overlay_.foreach (send_if_not (
+            // Relay through the overlay's accumulation window so a
+            // burst of validations fans out in one pass over the peers
+            overlay_.relayValidation (
                 std::make_shared<Message> (*packet, protocol::mtVALIDATION),
-                peer_in_set(peers)));
+                std::move (peers));
         }
     }
     catch (...)
@@ -1724,6 +2053,12 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
     protocol::TMLedgerData reply;
     bool fatLeaves = true, fatRoot = false;
 
+    // Peers that ask for a query depth get whole subtrees back, up
+    // to the reply byte budget. Legacy peers get two levels, close
+    // to what the old one-level-plus-leaves walk returned.
+    int const queryDepth = packet.has_querydepth () ?
+        std::min<int> (packet.querydepth (), SHAMap::fatQueryDepthMax) : 2;
+
     if (packet.has_requestcookie ())
         reply.set_requestcookie (packet.requestcookie ());
 
@@ -1746,7 +2081,7 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
         memcpy (txHash.begin (), packet.ledgerhash ().data (), 32);
 
         {
-            Application::ScopedLockType lock (getApp ().getMasterLock ());
+            MasterLockGuard lock (getApp ().consensusLock ());
             map = getApp().getOPs ().getTXMap (txHash);
         }
 
@@ -2010,7 +2345,10 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
     p_journal_.trace <<
         "GetLeder: " << logMe;
 
-    for (int i = 0; i < packet.nodeids ().size (); ++i)
+    int replyBytes = 0;
+
+    for (int i = 0; (i < packet.nodeids ().size ()) &&
+        (replyBytes < SHAMap::fatReplyBudget); ++i)
     {
         SHAMapNodeID mn (packet.nodeids (i).data (), packet.nodeids (i).size ());
 
@@ -2027,7 +2365,8 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
 
         try
         {
-            if (map->getNodeFat (mn, nodeIDs, rawNodes, fatRoot, fatLeaves))
+            if (map->getNodeFat (mn, nodeIDs, rawNodes, fatRoot, fatLeaves,
+                    queryDepth, SHAMap::fatReplyBudget - replyBytes))
             {
                 assert (nodeIDs.size () == rawNodes.size ());
                 p_journal_.trace <<
@@ -2046,6 +2385,7 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
                     node->set_nodeid (nID.getDataPtr (), nID.getLength ());
                     node->set_nodedata (&rawNodeIterator->front (),
                         rawNodeIterator->size ());
+                    replyBytes += rawNodeIterator->size ();
                 }
             }
             else
@@ -2108,7 +2448,7 @@ PeerImp::peerTXData (Job&, uint256 const& hash,
 
     SHAMapAddNode san;
     {
-        Application::ScopedLockType lock (getApp ().getMasterLock ());
+        MasterLockGuard lock (getApp ().consensusLock ());
 
         san =  getApp().getOPs().gotTXData (shared_from_this(),
             hash, nodeIDs, nodeData);
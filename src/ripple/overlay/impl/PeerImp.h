@@ -24,8 +24,10 @@
 #include <ripple/overlay/predicates.h>
 #include <ripple/overlay/impl/ProtocolMessage.h>
 #include <ripple/overlay/impl/OverlayImpl.h>
+#include <ripple/overlay/impl/RecyclingAllocator.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/LoadFeeTrack.h>
+#include <ripple/core/TimerWheel.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/validators/Manager.h>
 #include <ripple/unity/app.h> // VFALCO REMOVE
@@ -37,8 +39,9 @@
 #include <beast/http/message.h>
 #include <beast/http/parser.h>
 #include <beast/utility/WrappedSink.h>
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <deque>
 
 namespace ripple {
 
@@ -99,8 +102,7 @@ private:
     socket_type& socket_;
     stream_type& stream_;
     boost::asio::io_service::strand strand_;
-    boost::asio::basic_waitable_timer<
-        std::chrono::steady_clock> timer_;
+    TimerWheel::Timer timer_;
 
     //Type type_ = Type::legacy;
 
@@ -141,14 +143,42 @@ private:
     Resource::Consumer usage_;
     PeerFinder::Slot::ptr slot_;
 
-    beast::asio::streambuf read_buffer_;
+    // Inbound protocol data is parsed in place from these buffers
+    // (see invokeProtocolMessage); the blocks themselves recycle
+    // through the shared BufferRecycler instead of the heap.
+    beast::asio::basic_streambuf <
+        RecyclingAllocator <char>> read_buffer_;
     beast::http::message http_message_;
     boost::optional <beast::http::parser> http_parser_;
     beast::http::body http_body_;
     beast::asio::streambuf write_buffer_;
-    std::queue<Message::pointer> send_queue_;
+
+    // Outbound messages queue into priority lanes so bulk sync data
+    // never delays time-critical consensus traffic
+    enum
+    {
+        laneConsensus = 0,  // proposals, validations, status changes
+        laneTransaction,    // transaction relay
+        laneBulk,           // ledger and object sync, everything else
+        laneCount
+    };
+
+    std::deque<Message::pointer> send_lanes_[laneCount];
+    // Per-lane number of queued messages covered by the write in flight
+    std::size_t write_counts_[laneCount] = {};
     bool gracefulClose_ = false;
 
+    // Link quality, consulted by OverlayImpl::relayTransaction.
+    // Latency comes from timed pings sent off the overlay timer; the
+    // transaction counters track how often this peer sends us
+    // something we had already seen.
+    std::atomic<std::uint32_t> pingSeq_ {0};
+    std::atomic<std::uint64_t> pingSent_ {0};   // milliseconds
+    std::atomic<int> latency_ {-1};             // smoothed, milliseconds
+    std::atomic<int> validationLag_ {-1};       // smoothed ms behind first delivery
+    std::atomic<std::uint32_t> txReceived_ {0};
+    std::atomic<std::uint32_t> txDuplicate_ {0};
+
     std::unique_ptr <LoadEvent> load_event_;
 
     std::unique_ptr<Validators::Connection> validatorsConnection_;
@@ -276,6 +306,38 @@ public:
     bool
     hasRange (std::uint32_t uMin, std::uint32_t uMax) override;
 
+    /** Whether the peer accepts compressed frames from us. */
+    bool
+    compressionEnabled () const;
+
+    /** Send a timed ping to refresh the latency estimate. */
+    void
+    sendPing ();
+
+    /** Smoothed round trip time in milliseconds, or -1 if unmeasured. */
+    int
+    getLatency () const
+    {
+        return latency_;
+    }
+
+    /** Smoothed lag behind the first peer to deliver each validation. */
+    int
+    getValidationLag () const
+    {
+        return validationLag_;
+    }
+
+    /** Combined link quality score in milliseconds; -1 if unmeasured.
+        Lower is better.
+    */
+    int
+    getLinkScore () const;
+
+    /** Percentage of received transactions that were duplicates. */
+    int
+    getDuplicateRate () const;
+
 private:
     void
     close();
@@ -303,9 +365,9 @@ private:
     beast::http::message
     makeRequest (boost::asio::ip::address const& remote_address);
 
-    // Called when the timer wait completes
+    // Called on our strand when the timer fires
     void
-    onTimer (boost::system::error_code const& ec);
+    onTimer ();
 
     // Called when SSL shutdown completes
     void
@@ -337,6 +399,19 @@ private:
     void
     onReadMessage (error_code ec, std::size_t bytes_transferred);
 
+    // The lane a message queues into, by protocol message type
+    static
+    int
+    messageLane (Message::pointer const& m);
+
+    // Total number of queued outbound messages across all lanes
+    std::size_t
+    sendQueueSize () const;
+
+    // Start a write covering as many queued messages as possible
+    void
+    startWriteMessages ();
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage (error_code ec, std::size_t bytes_transferred);
@@ -418,6 +493,12 @@ private:
     void
     doFetchPack (const std::shared_ptr<protocol::TMGetObjectByHash>& packet);
 
+    // Queue background reads for the state entries a relayed
+    // transaction will touch, hiding fetch latency behind the
+    // queue delay the transaction pays anyway
+    static void
+    prefetchTxState (STTx::ref stx);
+
     void
     checkTransaction (Job&, int flags, STTx::pointer stx);
 
@@ -427,7 +508,7 @@ private:
             LedgerProposal::pointer proposal, uint256 consensusLCL);
 
     void
-    checkValidation (Job&, STValidation::pointer val,
+    checkValidation (Job&, STValidation::pointer val, uint256 suppression,
         bool isTrusted, std::shared_ptr<protocol::TMValidation> const& packet);
 
     void
@@ -457,7 +538,6 @@ PeerImp::PeerImp (id_t id, endpoint_type remote_endpoint,
     , socket_ (ssl_bundle_->socket)
     , stream_ (ssl_bundle_->stream)
     , strand_ (socket_.get_io_service())
-    , timer_ (socket_.get_io_service())
     , remote_address_ (
         beast::IPAddressConversion::from_asio(remote_endpoint))
     , overlay_ (overlay)
@@ -486,7 +566,6 @@ PeerImp::PeerImp (std::unique_ptr<beast::asio::ssl_bundle>&& ssl_bundle,
     , socket_ (ssl_bundle_->socket)
     , stream_ (ssl_bundle_->stream)
     , strand_ (socket_.get_io_service())
-    , timer_ (socket_.get_io_service())
     , remote_address_ (slot->remote_endpoint())
     , overlay_ (overlay)
     , m_inbound (false)
@@ -501,9 +580,15 @@ PeerImp::PeerImp (std::unique_ptr<beast::asio::ssl_bundle>&& ssl_bundle,
         boost::asio::buffer_size(buffers)), buffers));
 }
 
-template <class FwdIt, class>
-void
-PeerImp::sendEndpoints (FwdIt first, FwdIt last)
+/** Build an endpoints protocol message from a PeerFinder list.
+    The returned message is refcounted and may be sent to any
+    number of peers.
+*/
+template <class FwdIt, class = typename std::enable_if_t<std::is_same<
+    typename std::iterator_traits<FwdIt>::value_type,
+        PeerFinder::Endpoint>::value>>
+Message::pointer
+makeEndpointsMessage (FwdIt first, FwdIt last)
 {
     protocol::TMEndpoints tm;
     for (;first != last; ++first)
@@ -520,7 +605,14 @@ PeerImp::sendEndpoints (FwdIt first, FwdIt last)
     }
     tm.set_version (1);
 
-    send (std::make_shared <Message> (tm, protocol::mtENDPOINTS));
+    return std::make_shared <Message> (tm, protocol::mtENDPOINTS);
+}
+
+template <class FwdIt, class>
+void
+PeerImp::sendEndpoints (FwdIt first, FwdIt last)
+{
+    send (makeEndpointsMessage (first, last));
 }
 
 //------------------------------------------------------------------------------
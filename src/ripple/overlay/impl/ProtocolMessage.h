@@ -26,6 +26,7 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -62,6 +63,26 @@ protocolMessageName (int type)
     return "unknown";
 }
 
+/** Returns true for messages that keep our consensus view current.
+    These are dispatched ahead of any bulk data queued before them
+    on the same socket.
+*/
+template <class = void>
+bool
+isPriorityMessage (int type)
+{
+    switch (type & ~Message::typeCompressed)
+    {
+    case protocol::mtPROPOSE_LEDGER:
+    case protocol::mtSTATUS_CHANGE:
+    case protocol::mtVALIDATION:
+        return true;
+    default:
+        break;
+    };
+    return false;
+}
+
 namespace detail {
 
 template <class T, class Buffers, class Handler>
@@ -88,26 +109,14 @@ invoke (int type, Buffers const& buffers,
 
 }
 
-/** Calls the handler for up to one protocol message in the passed buffers.
-
-    If there is insufficient data to produce a complete protocol
-    message, zero is returned for the number of bytes consumed.
+namespace detail {
 
-    @return The number of bytes consumed, or the error code if any.
-*/
+/** Dispatch one complete message in the buffers to the handler. */
 template <class Buffers, class Handler>
-std::pair <std::size_t, boost::system::error_code>
-invokeProtocolMessage (Buffers const& buffers, Handler& handler)
+boost::system::error_code
+dispatch (int type, Buffers const& buffers, Handler& handler)
 {
-    std::pair<std::size_t,boost::system::error_code> result = { 0, {} };
-    boost::system::error_code& ec = result.second;
-
-    auto const type = Message::type(buffers);
-    if (type == 0)
-        return result;
-    auto const size = Message::kHeaderBytes + Message::size(buffers);
-    if (boost::asio::buffer_size(buffers) < size)
-        return result;
+    boost::system::error_code ec;
 
     switch (type)
     {
@@ -129,12 +138,148 @@ invokeProtocolMessage (Buffers const& buffers, Handler& handler)
         ec = handler.onMessageUnknown (type);
         break;
     }
+
+    return ec;
+}
+
+/** Dispatch one complete frame, expanding a compressed payload. */
+template <class Buffers, class Handler>
+boost::system::error_code
+dispatchFrame (int rawType, std::size_t payloadSize,
+    Buffers const& buffers, Handler& handler)
+{
+    if ((rawType & Message::typeCompressed) != 0)
+    {
+        // Expand the payload into a synthetic frame and parse that.
+        // Sent only by peers we negotiated compression with, but
+        // accepting them unconditionally is harmless: the expansion
+        // is size-capped and the parse path is the same.
+        std::vector<std::uint8_t> payload (payloadSize);
+        auto first = boost::asio::buffers_iterator<Buffers,
+            std::uint8_t>::begin (buffers) + Message::kHeaderBytes;
+        std::copy (first, first + payloadSize, payload.begin());
+
+        std::vector<std::uint8_t> frame;
+        if (! Message::uncompress (payload.data(), payload.size(), frame))
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        }
+
+        return detail::dispatch (rawType & ~Message::typeCompressed,
+            boost::asio::const_buffers_1 (frame.data(), frame.size()),
+                handler);
+    }
+
+    return detail::dispatch (rawType, buffers, handler);
+}
+
+}
+
+/** Calls the handler for up to one protocol message in the passed buffers.
+
+    If there is insufficient data to produce a complete protocol
+    message, zero is returned for the number of bytes consumed.
+
+    @return The number of bytes consumed, or the error code if any.
+*/
+template <class Buffers, class Handler>
+std::pair <std::size_t, boost::system::error_code>
+invokeProtocolMessage (Buffers const& buffers, Handler& handler)
+{
+    std::pair<std::size_t,boost::system::error_code> result = { 0, {} };
+    boost::system::error_code& ec = result.second;
+
+    auto const rawType = Message::type(buffers);
+    if (rawType == 0)
+        return result;
+    auto const payloadSize = Message::size(buffers);
+    auto const size = Message::kHeaderBytes + payloadSize;
+    if (boost::asio::buffer_size(buffers) < size)
+        return result;
+
+    ec = detail::dispatchFrame (rawType, payloadSize, buffers, handler);
+
     if (! ec)
         result.first = size;
 
     return result;
 }
 
+/** Calls the handler for complete priority messages in the buffers.
+
+    A peer can queue a critical proposal behind megabytes of sync data
+    on the same socket; this scans the complete frames on hand and
+    dispatches the consensus-critical ones (see isPriorityMessage)
+    ahead of the bulk data. Priority frames are small, so each is
+    copied out and handled from a flat buffer, the way compressed
+    payloads already are. Frames at the front of the buffer, with no
+    bulk data before them, are left for the ordinary pass, which must
+    skip the offsets returned here.
+
+    The scan stops where the sequential pass would: at an incomplete
+    frame or an unreadable header.
+
+    @return The buffer offsets of the messages dispatched, in order,
+            and the error code if any.
+*/
+template <class Buffers, class Handler>
+std::pair <std::vector<std::size_t>, boost::system::error_code>
+invokePriorityMessages (Buffers const& buffers, Handler& handler)
+{
+    std::pair<std::vector<std::size_t>,
+        boost::system::error_code> result;
+    boost::system::error_code& ec = result.second;
+
+    auto const total = boost::asio::buffer_size (buffers);
+    auto const begin = boost::asio::buffers_iterator<Buffers,
+        std::uint8_t>::begin (buffers);
+    auto const end = boost::asio::buffers_iterator<Buffers,
+        std::uint8_t>::end (buffers);
+
+    std::size_t offset = 0;
+    bool jumping = false;
+
+    while (offset + Message::kHeaderBytes <= total)
+    {
+        auto const it = begin + offset;
+        auto const rawType = Message::type (it, end);
+
+        if (rawType == 0)
+            break;
+
+        auto const payloadSize = Message::size (it, end);
+        auto const size = Message::kHeaderBytes + payloadSize;
+
+        if (total - offset < size)
+            break;
+
+        if (! isPriorityMessage (rawType))
+        {
+            // Anything after this point is jumping the queue
+            jumping = true;
+        }
+        else if (jumping)
+        {
+            std::vector<std::uint8_t> frame (size);
+            std::copy (it, it + size, frame.begin ());
+
+            ec = detail::dispatchFrame (rawType, payloadSize,
+                boost::asio::const_buffers_1 (
+                    frame.data (), frame.size ()), handler);
+
+            if (ec)
+                return result;
+
+            result.first.push_back (offset);
+        }
+
+        offset += size;
+    }
+
+    return result;
+}
+
 /** Write a protocol message to a streambuf. */
 template <class Streambuf>
 void
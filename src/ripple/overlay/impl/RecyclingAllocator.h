@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_RECYCLINGALLOCATOR_H_INCLUDED
+#define RIPPLE_OVERLAY_RECYCLINGALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+
+/** Process-wide pool of recycled raw buffers, bucketed by size.
+
+    Every peer read commits blocks into its streambuf and frees them as
+    messages are consumed, so a busy overlay allocates and releases the
+    same handful of block sizes thousands of times per second. Blocks
+    are rounded up to a power of two and parked here on free; each
+    bucket keeps a bounded number so a sync burst cannot pin memory
+    forever. Thread safe.
+*/
+class BufferRecycler
+{
+private:
+    // Most blocks a bucket retains; beyond this, blocks go to the heap
+    static std::size_t const bucketLimit = 64;
+
+    std::mutex m_mutex;
+    std::unordered_map <std::size_t, std::vector <void*>> m_buckets;
+
+public:
+    static BufferRecycler& instance ()
+    {
+        static BufferRecycler recycler;
+        return recycler;
+    }
+
+    ~BufferRecycler ()
+    {
+        for (auto& bucket : m_buckets)
+            for (void* block : bucket.second)
+                ::operator delete (block);
+    }
+
+    static std::size_t roundUp (std::size_t bytes)
+    {
+        std::size_t size = 64;
+        while (size < bytes)
+            size <<= 1;
+        return size;
+    }
+
+    void* allocate (std::size_t size)
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            auto const iter = m_buckets.find (size);
+
+            if (iter != m_buckets.end () && ! iter->second.empty ())
+            {
+                void* const block = iter->second.back ();
+                iter->second.pop_back ();
+                return block;
+            }
+        }
+
+        return ::operator new (size);
+    }
+
+    void deallocate (void* block, std::size_t size)
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            auto& bucket = m_buckets[size];
+
+            if (bucket.size () < bucketLimit)
+            {
+                bucket.push_back (block);
+                return;
+            }
+        }
+
+        ::operator delete (block);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Standard allocator drawing from the shared buffer recycler.
+
+    Intended as the streambuf allocator on the peer receive path so
+    read blocks are reused across messages instead of being reallocated
+    for every commit/consume cycle.
+*/
+template <class T>
+class RecyclingAllocator
+{
+public:
+    typedef T value_type;
+
+    RecyclingAllocator () = default;
+
+    template <class U>
+    RecyclingAllocator (RecyclingAllocator <U> const&)
+    {
+    }
+
+    T* allocate (std::size_t n)
+    {
+        return static_cast <T*> (BufferRecycler::instance ().allocate (
+            BufferRecycler::roundUp (n * sizeof (T))));
+    }
+
+    void deallocate (T* p, std::size_t n)
+    {
+        BufferRecycler::instance ().deallocate (p,
+            BufferRecycler::roundUp (n * sizeof (T)));
+    }
+
+    friend bool operator== (RecyclingAllocator const&,
+                            RecyclingAllocator const&)
+    {
+        return true;
+    }
+
+    friend bool operator!= (RecyclingAllocator const&,
+                            RecyclingAllocator const&)
+    {
+        return false;
+    }
+};
+
+} // ripple
+
+#endif
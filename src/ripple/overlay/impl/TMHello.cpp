@@ -19,6 +19,7 @@
 
 #include <ripple/app/main/Application.h>
 #include <ripple/protocol/BuildInfo.h>
+#include <ripple/overlay/Message.h>
 #include <ripple/overlay/impl/TMHello.h>
 #include <beast/crypto/base64.h>
 #include <beast/http/rfc2616.h>
@@ -117,6 +118,9 @@ buildHello (uint256 const& sharedValue, Application& app)
     // h.set_ipv4port (portNumber); // ignored now
     h.set_testnet (false);
 
+    // Codecs we are willing to receive compressed frames in
+    h.set_compression (Message::compressSnappy);
+
     // We always advertise ourselves as private in the HELLO message. This
     // suppresses the old peer advertising code and allows PeerFinder to
     // take over the functionality.
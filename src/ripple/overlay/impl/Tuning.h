@@ -28,7 +28,31 @@ namespace Tuning
 enum
 {
     /** Size of buffer used to read from the socket. */
-    readBufferBytes     = 4096
+    readBufferBytes     = 4096,
+
+    /** Maximum queued messages coalesced into one socket write. */
+    sendQueueCoalesce   = 16,
+
+    /** How long relayed validations accumulate before fan-out. */
+    validationRelayMilliseconds = 2,
+
+    /** Seconds between latency measurement pings to each peer. */
+    pingIntervalSeconds = 8,
+
+    /** Seconds between checks for a slow outbound link to replace. */
+    linkCheckSeconds    = 120,
+
+    /** Floor on how many peers receive a relayed transaction. */
+    relayMinPeers       = 10,
+
+    /** Above the floor, relay to one eligible peer in this many. */
+    relayFanoutDivisor  = 4,
+
+    /** Latency, in milliseconds, assumed for unmeasured links. */
+    relayUnknownLatency = 250,
+
+    /** Score penalty, in milliseconds, for a 100% duplicate rate. */
+    relayDuplicatePenalty = 500
 };
 
 } // Tuning
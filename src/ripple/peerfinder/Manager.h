@@ -103,6 +103,22 @@ bool operator< (Endpoint const& lhs, Endpoint const& rhs);
 /** A set of Endpoint used for connecting. */
 typedef std::vector <Endpoint> Endpoints;
 
+/** The endpoint gossip for one broadcast interval.
+
+    The list is built once from the Livecache. Slots in `shared` receive
+    it verbatim, so the caller can serialize it a single time and send
+    the same message to each of them. Slots that must see a different
+    list -- because an entry names the slot itself, or was already sent
+    to it recently -- appear in `custom` with their delta. Slots with
+    nothing new this interval appear in neither.
+*/
+struct EndpointGossip
+{
+    std::vector <Endpoint> list;
+    std::vector <Slot::ptr> shared;
+    std::vector <std::pair <Slot::ptr, std::vector <Endpoint>>> custom;
+};
+
 //------------------------------------------------------------------------------
 
 /** Possible results from activating a slot. */
@@ -188,6 +204,12 @@ public:
     */
     virtual void on_closed (Slot::ptr const& slot) = 0;
 
+    /** Called when the overlay measures persistently poor link quality.
+        The slot's address is demoted in the bootcache so that future
+        connection choices prefer better candidates.
+    */
+    virtual void on_sluggish (Slot::ptr const& slot) = 0;
+
     /** Called when we received redirect IPs from a busy peer. */
     virtual
     void
@@ -224,8 +246,11 @@ public:
     std::vector <beast::IP::Endpoint>
     autoconnect() = 0;
 
+    /** Build the periodic endpoint gossip.
+        The result is empty except once per broadcast interval.
+    */
     virtual
-    std::vector<std::pair<Slot::ptr, std::vector<Endpoint>>>
+    EndpointGossip
     buildEndpointsForPeers() = 0;
 
     /** Perform periodic activity.
@@ -184,6 +184,35 @@ Bootcache::on_failure (beast::IP::Endpoint const& endpoint)
     flagForUpdate();
 }
 
+void
+Bootcache::on_sluggish (beast::IP::Endpoint const& endpoint)
+{
+    auto result (m_map.insert (
+        value_type (endpoint, 0)));
+    if (result.second)
+    {
+        prune();
+    }
+    else
+    {
+        // The address works, so demote it rather than punish it:
+        // halving the accumulated valence ranks faster addresses
+        // ahead of it without making it look unreachable.
+        Entry entry (result.first->right);
+        if (entry.valence() > 0)
+            entry.valence() /= 2;
+        m_map.erase (result.first);
+        result = m_map.insert (
+            value_type (endpoint, entry));
+        assert (result.second);
+    }
+    Entry const& entry (result.first->right);
+    if (m_journal.debug) m_journal.debug << beast::leftw (18) <<
+        "Bootcache sluggish " << endpoint <<
+        " demoted to " << entry.valence();
+    flagForUpdate();
+}
+
 void
 Bootcache::periodicActivity ()
 {
@@ -149,6 +149,9 @@ public:
     /** Called when an outbound connection attempt fails to handshake. */
     void on_failure (beast::IP::Endpoint const& endpoint);
 
+    /** Called when a connected address proves persistently slow. */
+    void on_sluggish (beast::IP::Endpoint const& endpoint);
+
     /** Stores the cache in the persistent database on a timer. */
     void periodicActivity ();
 
@@ -179,13 +179,15 @@ RedirectHandouts::try_insert (Endpoint const& ep)
 
 //------------------------------------------------------------------------------
 
-/** Receives endpoints for a slot during periodic handouts. */
-class SlotHandouts
+/** Receives the handout broadcast to every active slot.
+    This target is built once per interval and is not tied to a slot;
+    per-slot exclusions are applied afterwards to form deltas.
+*/
+class SharedHandouts
 {
 public:
     template <class = void>
-    explicit
-    SlotHandouts (SlotImp::ptr const& slot);
+    SharedHandouts ();
 
     template <class = void>
     bool try_insert (Endpoint const& ep);
@@ -195,36 +197,24 @@ public:
         return list_.size() >= Tuning::numberOfEndpoints;
     }
 
-    void insert (Endpoint const& ep)
-    {
-        list_.push_back (ep);
-    }
-
-    SlotImp::ptr const& slot () const
-    {
-        return slot_;
-    }
-
     std::vector <Endpoint> const& list() const
     {
         return list_;
     }
 
 private:
-    SlotImp::ptr slot_;
     std::vector <Endpoint> list_;
 };
 
 template <class>
-SlotHandouts::SlotHandouts (SlotImp::ptr const& slot)
-    : slot_ (slot)
+SharedHandouts::SharedHandouts ()
 {
     list_.reserve (Tuning::numberOfEndpoints);
 }
 
 template <class>
 bool
-SlotHandouts::try_insert (Endpoint const& ep)
+SharedHandouts::try_insert (Endpoint const& ep)
 {
     if (full ())
         return false;
@@ -232,14 +222,6 @@ SlotHandouts::try_insert (Endpoint const& ep)
     if (ep.hops > Tuning::maxHops)
         return false;
 
-    if (slot_->recent.filter (ep.address, ep.hops))
-        return false;
-
-    // Don't send them their own address
-    if (slot_->remote_endpoint().address() ==
-        ep.address.address())
-        return false;
-
     // Make sure the address isn't already in our list
     if (std::any_of (list_.begin(), list_.end(),
         [&ep](Endpoint const& other)
@@ -251,13 +233,6 @@ SlotHandouts::try_insert (Endpoint const& ep)
 
     list_.emplace_back (ep.address, ep.hops);
 
-    // Insert into this slot's recent table. Although the endpoint
-    // didn't come from the slot, adding it to the slot's table
-    // prevents us from sending it again until it has expired from
-    // the other end's cache.
-    //
-    slot_->recent.insert (ep.address, ep.hops);
-
     return true;
 }
 
@@ -588,38 +588,25 @@ public:
         return none;
     }
 
-    std::vector<std::pair<Slot::ptr, std::vector<Endpoint>>>
+    EndpointGossip
     buildEndpointsForPeers()
     {
-        std::vector<std::pair<Slot::ptr, std::vector<Endpoint>>> result;
+        EndpointGossip gossip;
 
         typename SharedState::Access state (m_state);
 
         clock_type::time_point const now = m_clock.now();
         if (m_whenBroadcast <= now)
         {
-            std::vector <SlotHandouts> targets;
-
-            {
-                // build list of active slots
-                std::vector <SlotImp::ptr> slots;
-                slots.reserve (state->slots.size());
-                std::for_each (state->slots.cbegin(), state->slots.cend(),
-                    [&slots](Slots::value_type const& value)
-                    {
-                        if (value.second->state() == Slot::active)
-                            slots.emplace_back (value.second);
-                    });
-                std::random_shuffle (slots.begin(), slots.end());
-
-                // build target vector
-                targets.reserve (slots.size());
-                std::for_each (slots.cbegin(), slots.cend(),
-                    [&targets](SlotImp::ptr const& slot)
-                    {
-                        targets.emplace_back (slot);
-                    });
-            }
+            // Build one shared handout from the Livecache. Every slot
+            // receives the same selection this interval, so the caller
+            // serializes it once instead of building a message per peer.
+            state->livecache.hops.shuffle();
+            SharedHandouts h;
+            handout (&h, (&h)+1,
+                state->livecache.hops.begin(),
+                    state->livecache.hops.end());
+            gossip.list = h.list();
 
             /* VFALCO NOTE
                 This is a temporary measure. Once we know our own IP
@@ -641,32 +628,63 @@ public:
                 ep.address = beast::IP::Endpoint (
                     beast::IP::AddressV4 ()).at_port (
                         state->config.listeningPort);
-                for (auto& t : targets)
-                    t.insert (ep);
+                gossip.list.insert (gossip.list.begin(), ep);
             }
 
-            // build sequence of endpoints by hops
-            state->livecache.hops.shuffle();
-            handout (targets.begin(), targets.end(),
-                state->livecache.hops.begin(),
-                    state->livecache.hops.end());
-
-            // broadcast
-            for (auto const& t : targets)
+            if (! gossip.list.empty())
             {
-                SlotImp::ptr const& slot = t.slot();
-                auto const& list = t.list();
-                if (m_journal.trace) m_journal.trace << beast::leftw (18) <<
-                    "Logic sending " << slot->remote_endpoint() <<
-                    " with " << list.size() <<
-                    ((list.size() == 1) ? " endpoint" : " endpoints");
-                result.push_back (std::make_pair (slot, list));
+                for (auto const& entry : state->slots)
+                {
+                    SlotImp::ptr const& slot = entry.second;
+                    if (slot->state() != Slot::active)
+                        continue;
+
+                    // Compute this slot's delta: drop entries it was
+                    // sent recently or that name the slot itself. Our
+                    // own hops 0 entry always goes out (see note above).
+                    std::vector <Endpoint> list;
+                    list.reserve (gossip.list.size());
+                    for (auto const& ep : gossip.list)
+                    {
+                        if (ep.hops != 0 &&
+                            slot->recent.filter (ep.address, ep.hops))
+                            continue;
+                        if (slot->remote_endpoint().address() ==
+                                ep.address.address())
+                            continue;
+                        list.push_back (ep);
+                    }
+
+                    if (list.empty())
+                        continue;
+
+                    // Remember what we sent to this slot so we
+                    // don't repeat it until it has expired from the
+                    // other end's cache.
+                    for (auto const& ep : list)
+                    {
+                        if (ep.hops != 0)
+                            slot->recent.insert (ep.address, ep.hops);
+                    }
+
+                    if (list.size() == gossip.list.size())
+                        gossip.shared.push_back (slot);
+                    else
+                        gossip.custom.push_back (std::make_pair (
+                            slot, std::move (list)));
+                }
             }
 
+            if (m_journal.trace) m_journal.trace << beast::leftw (18) <<
+                "Logic gossip " << gossip.list.size() <<
+                ((gossip.list.size() == 1) ? " endpoint, " : " endpoints, ") <<
+                gossip.shared.size() << " shared, " <<
+                gossip.custom.size() << " custom";
+
             m_whenBroadcast = now + Tuning::secondsPerMessage;
         }
 
-        return result;
+        return gossip;
     }
 
     void once_per_second()
@@ -924,6 +942,16 @@ public:
         }
     }
 
+    void on_sluggish (SlotImp::ptr const& slot)
+    {
+        typename SharedState::Access state (m_state);
+
+        if (m_journal.debug) m_journal.debug << beast::leftw (18) <<
+            "Logic sluggish " << slot->remote_endpoint ();
+
+        state->bootcache.on_sluggish (slot->remote_endpoint ());
+    }
+
     // Insert a set of redirect IP addresses into the Bootcache
     template <class FwdIter>
     void
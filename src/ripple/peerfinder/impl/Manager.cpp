@@ -149,6 +149,13 @@ public:
         m_logic.on_closed (impl);
     }
 
+    void
+    on_sluggish (Slot::ptr const& slot)  override
+    {
+        SlotImp::ptr impl (std::dynamic_pointer_cast <SlotImp> (slot));
+        m_logic.on_sluggish (impl);
+    }
+
     void
     onRedirects (boost::asio::ip::tcp::endpoint const& remote_address,
         std::vector<boost::asio::ip::tcp::endpoint> const& eps) override
@@ -193,7 +200,7 @@ public:
         m_logic.once_per_second();
     }
 
-    std::vector<std::pair<Slot::ptr, std::vector<Endpoint>>>
+    EndpointGossip
     buildEndpointsForPeers() override
     {
         return m_logic.buildEndpointsForPeers();
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_COMPACTLEDGERENTRY_H_INCLUDED
+#define RIPPLE_PROTOCOL_COMPACTLEDGERENTRY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <cstddef>
+
+namespace ripple {
+
+/** Template-driven compact encoding of account-state leaf nodes.
+
+    A state leaf in prefix form spells out a field identifier in front of
+    every field payload, even though the set of fields an entry may carry
+    is fixed by its LedgerFormats template. The compact form drops the
+    identifiers and keeps a presence bitmap over the template's fields
+    (in canonical fieldCode order, matching the serialization order)
+    instead, so only the field payloads themselves are stored:
+
+        4 bytes     HashPrefix::leafNode (unchanged)
+        1 byte      0x00 marker
+        1 byte      LedgerEntryType
+        n bytes     presence bitmap, one bit per template field
+        ...         field payloads in canonical order, without field IDs
+                    (variable length fields keep their length prefix)
+        32 bytes    item tag (unchanged)
+
+    The marker byte cannot occur in a raw leaf: every ledger entry's
+    first serialized field is sfLedgerEntryType, whose field ID byte
+    is never zero.
+
+    The encoding is strictly reversible. compactStateLeaf verifies that
+    expanding its own output reproduces the input byte for byte before
+    accepting it, and refuses entries with fields outside the template
+    (or of types it cannot size), so a caller can always fall back to
+    storing the raw form.
+*/
+
+/** Try to produce the compact form of a prefix-format state leaf.
+    @return `true` if `out` now holds the compact encoding.
+*/
+bool compactStateLeaf (void const* data, std::size_t size, Blob& out);
+
+/** Determine whether these bytes hold a compacted state leaf. */
+bool isCompactStateLeaf (void const* data, std::size_t size);
+
+/** Reconstruct the original prefix-format leaf from its compact form.
+    @return `true` if `out` now holds the original serialization.
+*/
+bool expandStateLeaf (void const* data, std::size_t size, Blob& out);
+
+} // ripple
+
+#endif
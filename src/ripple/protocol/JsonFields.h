@@ -43,6 +43,7 @@ JSS ( accountState );
 JSS ( accountTreeHash );
 JSS ( affected );
 JSS ( age );
+JSS ( alternatives );
 JSS ( amendment_blocked );
 JSS ( asks );
 JSS ( authorized );
@@ -69,6 +70,8 @@ JSS ( currency );
 JSS ( data );
 JSS ( date );
 JSS ( delivered_amount );
+JSS ( destination_account );
+JSS ( destination_currencies );
 JSS ( engine_result );
 JSS ( engine_result_code );
 JSS ( engine_result_message );
@@ -144,6 +147,7 @@ JSS ( reserve_inc );
 JSS ( reserve_inc_xrp );
 JSS ( response );
 JSS ( result );
+JSS ( retry_after );
 JSS ( ripple_lines );
 JSS ( seq );
 JSS ( seqNum );
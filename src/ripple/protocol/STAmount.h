@@ -104,12 +104,13 @@ public:
 
     //--------------------------------------------------------------------------
 
-private:
+public:
+    // Read an amount from wire format, returning by value so callers
+    // can construct in place
     static
-    std::unique_ptr<STAmount>
+    STAmount
     construct (SerializerIterator&, SField::ref name);
 
-public:
     static
     STAmount
     createFromInt64 (SField::ref n, std::int64_t v);
@@ -119,7 +120,7 @@ public:
     deserialize (
         SerializerIterator& sit, SField::ref name)
     {
-        return construct (sit, name);
+        return std::make_unique <STAmount> (construct (sit, name));
     }
 
     static
@@ -260,6 +261,18 @@ public:
     //
     //--------------------------------------------------------------------------
 
+    STBase*
+    copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase*
+    move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     SerializedTypeID
     getSType() const override
     {
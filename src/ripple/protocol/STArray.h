@@ -67,8 +67,34 @@ public:
         ;
     }
 
+    STArray (STArray const& other) = default;
+    STArray& operator= (STArray const& other) = default;
+
+    STArray (STArray&& other)
+        : STBase (other)
+    {
+        value.swap (other.value);
+    }
+
+    STArray& operator= (STArray&& other)
+    {
+        STBase::operator= (other);
+        value.swap (other.value);
+        return *this;
+    }
+
     virtual ~STArray () { }
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     static std::unique_ptr<STBase>
     deserialize (SerializerIterator & sit, SField::ref name);
 
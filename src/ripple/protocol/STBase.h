@@ -22,9 +22,13 @@
 
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/Serializer.h>
+#include <cstddef>
+#include <new>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
+#include <utility>
 
 namespace ripple {
 
@@ -129,6 +133,28 @@ public:
     std::unique_ptr<STBase>
     clone() const;
 
+    /** Copy this object into raw storage.
+        The object is placement-constructed in `buf` if it fits in
+        `n` bytes, and heap-allocated otherwise. Returns the copy.
+        Derived classes override this by emplacing their own type.
+    */
+    virtual
+    STBase*
+    copy (std::size_t n, void* buf) const
+    {
+        return emplace (n, buf, *this);
+    }
+
+    /** Move this object into raw storage.
+        Same contract as copy(). The source is left moved-from.
+    */
+    virtual
+    STBase*
+    move (std::size_t n, void* buf)
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     void
     addFieldID (Serializer& s) const;
 
@@ -137,6 +163,19 @@ public:
     deserialize (SField::ref name);
 
 protected:
+    template <class D>
+    static
+    STBase*
+    emplace (std::size_t n, void* buf, D&& val)
+    {
+        using T = typename std::decay<D>::type;
+
+        if (sizeof (T) > n)
+            return new T (std::forward<D> (val));
+
+        return new (buf) T (std::forward<D> (val));
+    }
+
     SField::ptr fName;
 
 private:
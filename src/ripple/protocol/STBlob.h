@@ -20,6 +20,7 @@
 #ifndef RIPPLE_PROTOCOL_STBLOB_H_INCLUDED
 #define RIPPLE_PROTOCOL_STBLOB_H_INCLUDED
 
+#include <ripple/basics/SmallBlob.h>
 #include <ripple/protocol/STBase.h>
 #include <memory>
 
@@ -51,6 +52,16 @@ public:
         return std::unique_ptr<STBase> (construct (sit, name));
     }
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     virtual SerializedTypeID getSType () const
     {
         return STI_VL;
@@ -64,17 +75,17 @@ public:
         s.addVL (value);
     }
 
-    Blob const& peekValue () const
+    SmallBlob const& peekValue () const
     {
         return value;
     }
-    Blob& peekValue ()
+    SmallBlob& peekValue ()
     {
         return value;
     }
     Blob getValue () const
     {
-        return value;
+        return value.to_blob ();
     }
     void setValue (Blob const& v)
     {
@@ -83,7 +94,7 @@ public:
 
     operator Blob () const
     {
-        return value;
+        return value.to_blob ();
     }
     virtual bool isEquivalent (const STBase& t) const;
     virtual bool isDefault () const
@@ -92,7 +103,8 @@ public:
     }
 
 private:
-    Blob value;
+    // Inline storage: most values are signatures, keys and account IDs
+    SmallBlob value;
 
     virtual STBlob* duplicate () const
     {
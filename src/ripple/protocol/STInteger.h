@@ -42,6 +42,16 @@ public:
         return std::unique_ptr<STBase> (construct (sit, name));
     }
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     SerializedTypeID getSType () const
     {
         return STI_UINT8;
@@ -25,7 +25,10 @@
 #include <ripple/protocol/STPathSet.h>
 #include <ripple/protocol/STVector256.h>
 #include <ripple/protocol/SOTemplate.h>
-#include <boost/ptr_container/ptr_vector.hpp>
+#include <ripple/protocol/STVar.h>
+#include <cstddef>
+#include <iterator>
+#include <vector>
 
 namespace ripple {
 
@@ -36,6 +39,8 @@ class STObject
     , public CountedObject <STObject>
 {
 public:
+    typedef std::vector <detail::STVar> list_type;
+
     static char const* getCountedObjectName () { return "STObject"; }
 
     STObject () : mType (nullptr)
@@ -63,10 +68,22 @@ public:
         setType (type);
     }
 
-    STObject (SField::ref name, boost::ptr_vector<STBase>& data)
-        : STBase (name), mType (nullptr)
+    STObject (STObject const&) = default;
+    STObject& operator= (STObject const&) = default;
+
+    STObject (STObject&& other)
+        : STBase (other)
+        , mData (std::move (other.mData))
+        , mType (other.mType)
     {
-        mData.swap (data);
+    }
+
+    STObject& operator= (STObject&& other)
+    {
+        STBase::operator= (other);
+        mData = std::move (other.mData);
+        mType = other.mType;
+        return *this;
     }
 
     std::unique_ptr <STObject> oClone () const
@@ -90,6 +107,16 @@ public:
     void set (const SOTemplate&);
     bool set (SerializerIterator & u, int depth = 0);
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     virtual SerializedTypeID getSType () const override
     {
         return STI_OBJECT;
@@ -125,42 +152,33 @@ public:
 
     int addObject (const STBase & t)
     {
-        mData.push_back (t.clone ().release ());
+        mData.push_back (detail::STVar (t));
         return mData.size () - 1;
     }
     int giveObject (std::unique_ptr<STBase> t)
     {
-        mData.push_back (t.release ());
+        mData.push_back (detail::STVar (std::move (*t)));
         return mData.size () - 1;
     }
     int giveObject (STBase * t)
     {
-        mData.push_back (t);
-        return mData.size () - 1;
-    }
-    const boost::ptr_vector<STBase>& peekData () const
-    {
-        return mData;
-    }
-    boost::ptr_vector<STBase>& peekData ()
-    {
-        return mData;
+        return giveObject (std::unique_ptr<STBase> (t));
     }
     STBase& front ()
     {
-        return mData.front ();
+        return mData.front ().get ();
     }
     const STBase& front () const
     {
-        return mData.front ();
+        return mData.front ().get ();
     }
     STBase& back ()
     {
-        return mData.back ();
+        return mData.back ().get ();
     }
     const STBase& back () const
     {
-        return mData.back ();
+        return mData.back ().get ();
     }
 
     int getCount () const
@@ -178,19 +196,19 @@ public:
 
     const STBase& peekAtIndex (int offset) const
     {
-        return mData[offset];
+        return mData[offset].get ();
     }
     STBase& getIndex (int offset)
     {
-        return mData[offset];
+        return mData[offset].get ();
     }
     const STBase* peekAtPIndex (int offset) const
     {
-        return & (mData[offset]);
+        return &mData[offset].get ();
     }
     STBase* getPIndex (int offset)
     {
-        return & (mData[offset]);
+        return &mData[offset].get ();
     }
 
     int getFieldIndex (SField::ref field) const;
@@ -285,24 +303,127 @@ public:
         return makeDefaultObject (name.fieldType, name);
     }
 
-    // field iterator stuff
-    typedef boost::ptr_vector<STBase>::iterator iterator;
-    typedef boost::ptr_vector<STBase>::const_iterator const_iterator;
+    // Field iterators, presenting the stored variants as STBase
+
+    class iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef STBase value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef STBase* pointer;
+        typedef STBase& reference;
+
+        iterator () = default;
+
+        STBase& operator* () const
+        {
+            return it_->get ();
+        }
+        STBase* operator-> () const
+        {
+            return &it_->get ();
+        }
+        iterator& operator++ ()
+        {
+            ++it_;
+            return *this;
+        }
+        iterator operator++ (int)
+        {
+            iterator tmp (*this);
+            ++it_;
+            return tmp;
+        }
+        iterator& operator-- ()
+        {
+            --it_;
+            return *this;
+        }
+        bool operator== (iterator const& other) const
+        {
+            return it_ == other.it_;
+        }
+        bool operator!= (iterator const& other) const
+        {
+            return it_ != other.it_;
+        }
+
+    private:
+        friend class STObject;
+        explicit iterator (list_type::iterator it) : it_ (it)
+        {
+        }
+        list_type::iterator it_;
+    };
+
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef STBase value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef STBase const* pointer;
+        typedef STBase const& reference;
+
+        const_iterator () = default;
+
+        STBase const& operator* () const
+        {
+            return it_->get ();
+        }
+        STBase const* operator-> () const
+        {
+            return &it_->get ();
+        }
+        const_iterator& operator++ ()
+        {
+            ++it_;
+            return *this;
+        }
+        const_iterator operator++ (int)
+        {
+            const_iterator tmp (*this);
+            ++it_;
+            return tmp;
+        }
+        const_iterator& operator-- ()
+        {
+            --it_;
+            return *this;
+        }
+        bool operator== (const_iterator const& other) const
+        {
+            return it_ == other.it_;
+        }
+        bool operator!= (const_iterator const& other) const
+        {
+            return it_ != other.it_;
+        }
+
+    private:
+        friend class STObject;
+        explicit const_iterator (list_type::const_iterator it) : it_ (it)
+        {
+        }
+        list_type::const_iterator it_;
+    };
+
     iterator begin ()
     {
-        return mData.begin ();
+        return iterator (mData.begin ());
     }
     iterator end ()
     {
-        return mData.end ();
+        return iterator (mData.end ());
     }
     const_iterator begin () const
     {
-        return mData.begin ();
+        return const_iterator (mData.begin ());
     }
     const_iterator end () const
     {
-        return mData.end ();
+        return const_iterator (mData.end ());
     }
     bool empty () const
     {
@@ -418,8 +539,8 @@ private:
     }
 
 private:
-    boost::ptr_vector<STBase>   mData;
-    const SOTemplate*                   mType;
+    list_type mData;
+    const SOTemplate* mType;
 };
 
 } // ripple
@@ -217,6 +217,16 @@ public:
     void add (Serializer& s) const;
     virtual Json::Value getJson (int) const;
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     SerializedTypeID getSType () const
     {
         return STI_PATHSET;
@@ -68,6 +68,9 @@ public:
 
     uint256 getSigningHash () const;
 
+    /** The transaction's canonical serialization, computed once. */
+    Blob const& getSerialized () const;
+
     TxType getTxnType () const
     {
         return tx_type_;
@@ -79,6 +82,7 @@ public:
     void setTransactionFee (const STAmount & fee)
     {
         setFieldAmount (sfFee, fee);
+        dirtyDigests ();
     }
 
     RippleAddress getSourceAccount () const
@@ -98,7 +102,8 @@ public:
     }
     void setSequence (std::uint32_t seq)
     {
-        return setFieldU32 (sfSequence, seq);
+        setFieldU32 (sfSequence, seq);
+        dirtyDigests ();
     }
 
     std::vector<RippleAddress> getMentionedAccounts () const;
@@ -149,8 +154,26 @@ private:
         return new STTx (*this);
     }
 
+    // Forget the cached serialization and digests. Called from our
+    // own mutators; code that changes fields through the base
+    // STObject interface must not have fetched a digest first.
+    void dirtyDigests ()
+    {
+        serialized_.clear ();
+        txid_.zero ();
+        signing_hash_.zero ();
+    }
+
     TxType tx_type_;
 
+    // The serialization and digests are computed on first use and
+    // kept, since a transaction is effectively immutable once built
+    // (the same assumption sig_state_ makes) but its ID is asked for
+    // again and again: relaying, canonical set keys, SQL, JSON.
+    mutable Blob serialized_;
+    mutable uint256 txid_;
+    mutable uint256 signing_hash_;
+
     mutable boost::tribool sig_state_;
 };
 
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STVAR_H_INCLUDED
+#define RIPPLE_PROTOCOL_STVAR_H_INCLUDED
+
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STBase.h>
+#include <ripple/protocol/Serializer.h>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ripple {
+namespace detail {
+
+struct defaultObject_t { };
+struct nonPresentObject_t { };
+
+extern defaultObject_t defaultObject;
+extern nonPresentObject_t nonPresentObject;
+
+/** Holds any serialized type, with inline storage for the small ones.
+
+    Field objects small enough to fit in the internal buffer — the
+    integers, hashes, accounts, amounts and blobs that make up almost
+    every transaction — are placement-constructed there instead of
+    each getting its own heap allocation.
+*/
+class STVar
+{
+private:
+    // Big enough for the largest common field type (STAmount)
+    static std::size_t const max_size = 80;
+
+    std::aligned_storage <max_size>::type d_;
+    STBase* p_ = nullptr;
+
+public:
+    ~STVar ()
+    {
+        destroy ();
+    }
+
+    STVar (STVar const& other)
+    {
+        if (other.p_ != nullptr)
+            p_ = other.p_->copy (max_size, &d_);
+    }
+
+    STVar (STVar&& other)
+    {
+        if (other.on_heap ())
+        {
+            p_ = other.p_;
+            other.p_ = nullptr;
+        }
+        else
+        {
+            p_ = other.p_->move (max_size, &d_);
+            other.destroy ();
+        }
+    }
+
+    STVar& operator= (STVar const& rhs);
+    STVar& operator= (STVar&& rhs);
+
+    STVar (STBase const& t)
+    {
+        p_ = t.copy (max_size, &d_);
+    }
+
+    STVar (STBase&& t)
+    {
+        p_ = t.move (max_size, &d_);
+    }
+
+    STVar (defaultObject_t, SField::ref name);
+    STVar (nonPresentObject_t, SField::ref name);
+    STVar (SerializerIterator& sit, SField::ref name);
+
+    STBase& get ()
+    {
+        return *p_;
+    }
+
+    STBase const& get () const
+    {
+        return *p_;
+    }
+
+    STBase* get_ptr ()
+    {
+        return p_;
+    }
+
+    STBase const* get_ptr () const
+    {
+        return p_;
+    }
+
+private:
+    STVar () = default;
+
+    STVar (SerializedTypeID id, SField::ref name);
+
+    template <class T, class... Args>
+    void construct (Args&&... args)
+    {
+        if (sizeof (T) > max_size)
+            p_ = new T (std::forward<Args> (args)...);
+        else
+            p_ = new (&d_) T (std::forward<Args> (args)...);
+    }
+
+    bool on_heap () const
+    {
+        return static_cast<void const*> (p_) !=
+            static_cast<void const*> (&d_);
+    }
+
+    void destroy ();
+};
+
+} // detail
+} // ripple
+
+#endif
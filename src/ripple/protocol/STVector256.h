@@ -38,6 +38,16 @@ public:
         : mValue (vector)
     { }
 
+    STBase* copy (std::size_t n, void* buf) const override
+    {
+        return emplace (n, buf, *this);
+    }
+
+    STBase* move (std::size_t n, void* buf) override
+    {
+        return emplace (n, buf, std::move (*this));
+    }
+
     SerializedTypeID getSType () const
     {
         return STI_VECTOR256;
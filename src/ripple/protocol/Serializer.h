@@ -21,6 +21,7 @@
 #define RIPPLE_PROTOCOL_SERIALIZER_H_INCLUDED
 
 #include <ripple/basics/byte_view.h>
+#include <ripple/basics/SmallBlob.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/basics/base_uint.h>
 #include <iomanip>
@@ -30,6 +31,41 @@ namespace ripple {
 
 class CKey; // forward declaration
 
+/** Incrementally computes the SHA-512 half of prefixed material.
+
+    Every protocol hash is SHA-512 over a four byte HashPrefix followed
+    by the serialized material, truncated to 256 bits. Constructing a
+    hasher from a prefix clones a precomputed context that has already
+    absorbed the prefix bytes, instead of initializing a fresh context
+    and feeding it the prefix for every hash. Material can then be
+    appended in pieces, so callers need not assemble a contiguous
+    buffer just to hash it.
+*/
+class SHA512HalfHasher
+{
+public:
+    explicit SHA512HalfHasher (std::uint32_t prefix);
+
+    /** Append material to the hash. */
+    void update (void const* data, std::size_t bytes);
+
+    void update (Blob const& data)
+    {
+        if (!data.empty ())
+            update (data.data (), data.size ());
+    }
+
+    /** Complete the computation and return the hash.
+        The hasher may not be reused afterwards.
+    */
+    uint256 finish ();
+
+private:
+    // Opaque storage for a SHA512_CTX, sized and checked in the
+    // implementation; keeps OpenSSL out of this header.
+    std::uint64_t m_ctx [32];
+};
+
 class Serializer
 {
 public:
@@ -47,6 +83,10 @@ public:
     {
         ;
     }
+    Serializer (Blob&& data) : mData (std::move (data))
+    {
+        ;
+    }
     Serializer (std::string const& data) : mData (data.data (), (data.data ()) + data.size ())
     {
         ;
@@ -93,6 +133,7 @@ public:
     int addZeros (size_t uBytes);
 
     int addVL (Blob const& vector);
+    int addVL (SmallBlob const& blob);
     int addVL (std::string const& string);
     int addVL (const void* ptr, int len);
 
@@ -140,9 +181,11 @@ public:
     }
 
     bool getRaw (Blob&, int offset, int length) const;
+    bool getRaw (SmallBlob&, int offset, int length) const;
     Blob getRaw (int offset, int length) const;
 
     bool getVL (Blob& objectVL, int offset, int& length) const;
+    bool getVL (SmallBlob& objectVL, int offset, int& length) const;
     bool getVLLength (int& length, int offset) const;
 
     bool getFieldID (int& type, int& name, int offset) const;
@@ -162,6 +205,9 @@ public:
 
     // prefix hash functions
     static uint256 getPrefixHash (std::uint32_t prefix, const unsigned char* data, int len);
+    // Hash prefix || data || tag without assembling a buffer
+    static uint256 getPrefixHash (std::uint32_t prefix, const unsigned char* data, int len,
+                                  uint256 const& tag);
     uint256 getPrefixHash (std::uint32_t prefix) const
     {
         return getPrefixHash (prefix, & (mData.front ()), mData.size ());
@@ -372,6 +418,14 @@ public:
     Blob getRaw (int iLength);
 
     Blob getVL ();
+
+    // Fills a small-buffer container without the heap allocation
+    void getVL (SmallBlob& out);
+
+    // Locates the next VL field in place and advances past it.  The
+    // returned pointer aliases the underlying serializer, so it is
+    // only good for the serializer's lifetime.
+    unsigned char const* getVLDirect (int& dataLength);
 };
 
 } // ripple
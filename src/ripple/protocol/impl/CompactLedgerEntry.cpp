@@ -0,0 +1,352 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/protocol/CompactLedgerEntry.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/Serializer.h>
+#include <algorithm>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// A compacted leaf is at least prefix, marker, entry type and tag
+std::size_t const minCompactSize = 4 + 2 + 32;
+
+// Decode the field identifier at data[pos].
+// @return the number of bytes it occupies, or -1 if it is malformed.
+int readFieldID (unsigned char const* data, std::size_t size,
+    std::size_t pos, int& type, int& name)
+{
+    if (pos >= size)
+        return -1;
+
+    type = data[pos] >> 4;
+    name = data[pos] & 15;
+    int len = 1;
+
+    if (type == 0)
+    {
+        // uncommon type
+        if ((pos + len) >= size)
+            return -1;
+
+        type = data[pos + len++];
+
+        if (type < 16)
+            return -1;
+    }
+
+    if (name == 0)
+    {
+        // uncommon name
+        if ((pos + len) >= size)
+            return -1;
+
+        name = data[pos + len++];
+
+        if (name < 16)
+            return -1;
+    }
+
+    return len;
+}
+
+// The size of the field payload starting at data[pos], including any
+// variable length prefix.
+// @return the payload size, or -1 if the field cannot be sized.
+int payloadLength (unsigned char const* data, std::size_t size,
+    std::size_t pos, int type)
+{
+    switch (type)
+    {
+    case STI_UINT8:
+        return 1;
+
+    case STI_UINT16:
+        return 2;
+
+    case STI_UINT32:
+        return 4;
+
+    case STI_UINT64:
+        return 8;
+
+    case STI_HASH128:
+        return 16;
+
+    case STI_HASH160:
+        return 20;
+
+    case STI_HASH256:
+        return 32;
+
+    case STI_AMOUNT:
+        if (pos >= size)
+            return -1;
+
+        return (data[pos] & 0x80) ? 48 : 8;
+
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+    {
+        if (pos >= size)
+            return -1;
+
+        try
+        {
+            int const lenLen = Serializer::decodeLengthLength (data[pos]);
+
+            if ((pos + lenLen) > size)
+                return -1;
+
+            int dataLen;
+
+            if (lenLen == 1)
+                dataLen = Serializer::decodeVLLength (data[pos]);
+            else if (lenLen == 2)
+                dataLen = Serializer::decodeVLLength (
+                    data[pos], data[pos + 1]);
+            else
+                dataLen = Serializer::decodeVLLength (
+                    data[pos], data[pos + 1], data[pos + 2]);
+
+            return lenLen + dataLen;
+        }
+        catch (...)
+        {
+            return -1;
+        }
+    }
+
+    default:
+        // Nested objects, arrays and path sets don't occur in the
+        // entries we compact
+        return -1;
+    }
+}
+
+// The template's fields in canonical fieldCode order, which is the order
+// STObject serializes them in.
+std::vector <SField const*> sortedFields (SOTemplate const& tmpl)
+{
+    std::vector <SField const*> fields;
+    fields.reserve (tmpl.peek ().size ());
+
+    for (auto const& element : tmpl.peek ())
+        fields.push_back (&element->e_field);
+
+    std::sort (fields.begin (), fields.end (),
+        [](SField const* lhs, SField const* rhs)
+        {
+            return lhs->fieldCode < rhs->fieldCode;
+        });
+
+    return fields;
+}
+
+bool compactNoVerify (unsigned char const* data, std::size_t size, Blob& out)
+{
+    // prefix, a minimal entry, and the item tag
+    if (size < (4 + 3 + 32))
+        return false;
+
+    std::uint32_t const prefix =
+        (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+
+    if (prefix != HashPrefix::leafNode)
+        return false;
+
+    unsigned char const* const entry = data + 4;
+    std::size_t const entrySize = size - 4 - 32;
+
+    // Every entry serializes sfLedgerEntryType first; it tells us
+    // which template applies
+    int type, name;
+    int idLen = readFieldID (entry, entrySize, 0, type, name);
+
+    if ((idLen < 0) || (type != STI_UINT16) ||
+            (name != sfLedgerEntryType.fieldValue) ||
+            (entrySize < (idLen + 2)))
+        return false;
+
+    int const entryType = (entry[idLen] << 8) | entry[idLen + 1];
+
+    if ((entryType <= 0) || (entryType > 255))
+        return false;
+
+    auto const* const format = LedgerFormats::getInstance ().findByType (
+        static_cast <LedgerEntryType> (entryType));
+
+    if (format == nullptr)
+        return false;
+
+    auto const fields = sortedFields (format->elements);
+
+    std::size_t const bitmapBytes = (fields.size () + 7) / 8;
+    Blob bitmap (bitmapBytes, 0);
+
+    Blob payloads;
+    payloads.reserve (entrySize);
+
+    std::size_t pos = 0;
+    std::size_t next = 0;
+
+    while (pos < entrySize)
+    {
+        idLen = readFieldID (entry, entrySize, pos, type, name);
+
+        if (idLen < 0)
+            return false;
+
+        // Fields are serialized in ascending fieldCode order, so a
+        // single forward scan over the template finds each one
+        int const code = field_code (type, name);
+
+        while ((next < fields.size ()) && (fields[next]->fieldCode < code))
+            ++next;
+
+        if ((next == fields.size ()) || (fields[next]->fieldCode != code))
+            return false; // field not in the template; keep the raw form
+
+        bitmap[next / 8] |= (0x80 >> (next % 8));
+        ++next;
+
+        pos += idLen;
+
+        int const pLen = payloadLength (entry, entrySize, pos, type);
+
+        if ((pLen < 0) || ((pos + pLen) > entrySize))
+            return false;
+
+        payloads.insert (payloads.end (), entry + pos, entry + pos + pLen);
+        pos += pLen;
+    }
+
+    out.clear ();
+    out.reserve (4 + 2 + bitmapBytes + payloads.size () + 32);
+    out.insert (out.end (), data, data + 4);
+    out.push_back (0);
+    out.push_back (static_cast <unsigned char> (entryType));
+    out.insert (out.end (), bitmap.begin (), bitmap.end ());
+    out.insert (out.end (), payloads.begin (), payloads.end ());
+    out.insert (out.end (), data + size - 32, data + size);
+
+    return out.size () < size;
+}
+
+} // namespace
+
+bool compactStateLeaf (void const* data, std::size_t size, Blob& out)
+{
+    auto const* const bytes = static_cast <unsigned char const*> (data);
+
+    if (!compactNoVerify (bytes, size, out))
+        return false;
+
+    // Never trust a compact form that doesn't provably round trip
+    Blob check;
+
+    if (!expandStateLeaf (out.data (), out.size (), check) ||
+            (check.size () != size) ||
+            !std::equal (check.begin (), check.end (), bytes))
+    {
+        out.clear ();
+        return false;
+    }
+
+    return true;
+}
+
+bool isCompactStateLeaf (void const* data, std::size_t size)
+{
+    auto const* const bytes = static_cast <unsigned char const*> (data);
+
+    if (size < minCompactSize)
+        return false;
+
+    std::uint32_t const prefix =
+        (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+
+    // A raw leaf's first entry byte is sfLedgerEntryType's field ID,
+    // which is never zero, so the marker is unambiguous
+    return (prefix == HashPrefix::leafNode) && (bytes[4] == 0);
+}
+
+bool expandStateLeaf (void const* data, std::size_t size, Blob& out)
+{
+    auto const* const bytes = static_cast <unsigned char const*> (data);
+
+    if (!isCompactStateLeaf (data, size))
+        return false;
+
+    auto const* const format = LedgerFormats::getInstance ().findByType (
+        static_cast <LedgerEntryType> (bytes[5]));
+
+    if (format == nullptr)
+        return false;
+
+    auto const fields = sortedFields (format->elements);
+
+    std::size_t const bitmapBytes = (fields.size () + 7) / 8;
+
+    if (size < (4 + 2 + bitmapBytes + 32))
+        return false;
+
+    unsigned char const* const bitmap = bytes + 6;
+    unsigned char const* const stream = bytes + 6 + bitmapBytes;
+    std::size_t const streamSize = size - 6 - bitmapBytes - 32;
+
+    Serializer s (static_cast <int> (size + 64));
+    s.addRaw (bytes, 4);
+
+    std::size_t pos = 0;
+
+    for (std::size_t i = 0; i < fields.size (); ++i)
+    {
+        if ((bitmap[i / 8] & (0x80 >> (i % 8))) == 0)
+            continue;
+
+        SField const& field = *fields[i];
+
+        int const pLen = payloadLength (
+            stream, streamSize, pos, field.fieldType);
+
+        if ((pLen < 0) || ((pos + pLen) > streamSize))
+            return false;
+
+        s.addFieldID (field.fieldType, field.fieldValue);
+        s.addRaw (stream + pos, pLen);
+        pos += pLen;
+    }
+
+    // The payload stream must account for every byte
+    if (pos != streamSize)
+        return false;
+
+    s.addRaw (bytes + size - 32, 32);
+
+    out = s.peekData ();
+    return true;
+}
+
+} // ripple
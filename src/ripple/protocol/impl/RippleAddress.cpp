@@ -21,9 +21,11 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/crypto/ECDSA.h>
 #include <ripple/crypto/ECIES.h>
+#include <ripple/crypto/Ed25519.h>
 #include <ripple/crypto/GenerateDeterministicKey.h>
 #include <ripple/crypto/RandomNumbers.h>
 #include <ripple/crypto/RFC1751.h>
+#include <ripple/crypto/SignatureEngine.h>
 #include <ripple/protocol/RippleAddress.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/RipplePublicKey.h>
@@ -67,14 +69,22 @@ static Blob getPublicKey (openssl::ec_key const& key)
 
 static bool verifySignature (Blob const& pubkey, uint256 const& hash, Blob const& sig, ECDSA fullyCanonical)
 {
+	// An Ed25519 key is self-describing (leading 0xED cannot begin a
+	// compressed secp256k1 point). The signed message is the same
+	// hash ECDSA signs; DER canonicality does not apply to the fixed
+	// length Ed25519 signature form.
+	if (isEd25519PublicKey (pubkey))
+	{
+		return ed25519Verify (
+			pubkey.data () + 1, hash.begin (), hash.size (), sig);
+	}
+
 	if (! isCanonicalECDSASig (sig, fullyCanonical))
 	{
 		return false;
 	}
-	
-	openssl::ec_key key = ECDSAPublicKey (pubkey);
-	
-	return key.valid() && ECDSAVerify (hash, sig, key);
+
+	return signatureEngine ().verify (pubkey, hash, sig);
 }
 
 RippleAddress::RippleAddress ()
@@ -342,12 +352,20 @@ typedef std::lock_guard <StaticLockType> StaticScopedLockType;
 static StaticLockType s_lock;
 static hash_map <Blob, std::string> rncMapOld, rncMapNew;
 
+// Decoding an account from its base58 form costs two SHA-256 passes
+// for the checksum alone, and clients resend the same handful of
+// accounts constantly, so successful decodes are cached like the
+// encodes above.
+static hash_map <std::string, Blob> radMapOld, radMapNew;
+
 void RippleAddress::clearCache ()
 {
     StaticScopedLockType sl (s_lock);
 
     rncMapOld.clear ();
     rncMapNew.clear ();
+    radMapOld.clear ();
+    radMapNew.clear ();
 }
 
 std::string RippleAddress::humanAccountID () const
@@ -419,10 +437,53 @@ bool RippleAddress::setAccountID (
         setAccountID (Account ());
 
         mIsValid    = true;
+        return mIsValid;
     }
-    else
+
+    // Only the standard alphabet is cached; the bitcoin alphabet only
+    // comes up on a failure diagnostic path.
+    bool const standard = (&alphabet == &Base58::getRippleAlphabet ());
+
+    if (standard)
+    {
+        StaticScopedLockType sl (s_lock);
+
+        auto it = radMapNew.find (strAccountID);
+
+        if (it == radMapNew.end ())
+        {
+            it = radMapOld.find (strAccountID);
+
+            if (it != radMapOld.end ())
+            {
+                it = radMapNew.emplace (*it).first;
+                radMapOld.erase (strAccountID);
+            }
+        }
+
+        if (it != radMapNew.end ())
+        {
+            nVersion = VER_ACCOUNT_ID;
+            vchData = it->second;
+            mIsValid = true;
+            return mIsValid;
+        }
+    }
+
+    mIsValid = SetString (strAccountID, VER_ACCOUNT_ID, alphabet);
+
+    if (mIsValid && standard)
     {
-        mIsValid = SetString (strAccountID, VER_ACCOUNT_ID, alphabet);
+        StaticScopedLockType sl (s_lock);
+
+        if (radMapNew.size () >= 128000)
+        {
+            radMapOld = std::move (radMapNew);
+            radMapNew.clear ();
+            radMapNew.reserve (128000);
+        }
+
+        radMapNew[strAccountID] = vchData;
     }
 
     return mIsValid;
@@ -37,6 +37,31 @@ int SField::num = 0;
 
 typedef std::lock_guard <std::mutex> StaticScopedLockType;
 
+enum
+{
+    fieldTableTypes  = STI_VECTOR256 + 1,
+
+    // Special fields use values 257 and 258
+    fieldTableValues = 259
+};
+
+// Every known field in the binary-encodable range also lands in this
+// dense table, so getField(int) resolves the hot path with an indexed
+// load instead of a map probe. Zero-initialized before the file-scope
+// SFields below are constructed, so registration only fills slots.
+static SField::ptr fieldTable [fieldTableTypes][fieldTableValues];
+
+static void registerField (SField const& result, SField::ptr p)
+{
+    knownCodeToField[result.fieldCode] = p;
+
+    if ((result.fieldType >= 0) && (result.fieldType < fieldTableTypes) &&
+        (result.fieldValue >= 0) && (result.fieldValue < fieldTableValues))
+    {
+        fieldTable[result.fieldType][result.fieldValue] = p;
+    }
+}
+
 // Give this translation unit only, permission to construct SFields
 struct SField::make
 {
@@ -45,7 +70,7 @@ struct SField::make
     static SField one(SField const* p, Args&& ...args)
     {
         SField result(std::forward<Args>(args)...);
-        knownCodeToField[result.fieldCode] = p;
+        registerField (result, p);
         return result;
     }
 #else  // remove this when VS gets variadic templates
@@ -53,7 +78,7 @@ struct SField::make
     static SField one(SField const* p, A0&& arg0)
     {
         SField result(std::forward<A0>(arg0));
-        knownCodeToField[result.fieldCode] = p;
+        registerField (result, p);
         return result;
     }
 
@@ -62,7 +87,7 @@ struct SField::make
     {
         SField result(std::forward<A0>(arg0), std::forward<A1>(arg1),
                       std::forward<A2>(arg2));
-        knownCodeToField[result.fieldCode] = p;
+        registerField (result, p);
         return result;
     }
 
@@ -72,7 +97,7 @@ struct SField::make
     {
         SField result(std::forward<A0>(arg0), std::forward<A1>(arg1),
                       std::forward<A2>(arg2), std::forward<A3>(arg3));
-        knownCodeToField[result.fieldCode] = p;
+        registerField (result, p);
         return result;
     }
 
@@ -83,7 +108,7 @@ struct SField::make
         SField result(std::forward<A0>(arg0), std::forward<A1>(arg1),
                       std::forward<A2>(arg2), std::forward<A3>(arg3),
                       std::forward<A4>(arg4));
-        knownCodeToField[result.fieldCode] = p;
+        registerField (result, p);
         return result;
     }
 #endif
@@ -300,16 +325,26 @@ SField::SField (SerializedTypeID tid, int fv)
 
 SField::ref SField::getField (int code)
 {
-    auto it = knownCodeToField.find (code);
+    int const type = code >> 16;
+    int const field = code & 0xffff;
 
-    if (it != knownCodeToField.end ())
+    if ((code > 0) && (type < fieldTableTypes) && (field < fieldTableValues))
     {
-        // 99+% of the time, it will be a valid, known field
-        return * (it->second);
+        // 99+% of the time, it will be a valid, known field: two
+        // bounds checks and an indexed load, no map walk, no lock
+        SField::ptr const known = fieldTable[type][field];
+
+        if (known != nullptr)
+            return *known;
     }
+    else
+    {
+        // High-level types and the special codes live only in the map
+        auto it = knownCodeToField.find (code);
 
-    int type = code >> 16;
-    int field = code & 0xffff;
+        if (it != knownCodeToField.end ())
+            return * (it->second);
+    }
 
     // Don't dynamically extend types that have no binary encoding.
     if ((field > 255) || (code < 0))
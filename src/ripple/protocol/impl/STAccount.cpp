@@ -36,7 +36,9 @@ std::string STAccount::getText () const
 STAccount*
 STAccount::construct (SerializerIterator& u, SField::ref name)
 {
-    return new STAccount (name, u.getVL ());
+    STAccount* ret = new STAccount (name);
+    u.getVL (ret->peekValue ());
+    return ret;
 }
 
 STAccount::STAccount (SField::ref n, Account const& v) : STBlob (n)
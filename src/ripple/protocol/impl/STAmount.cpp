@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/DecimalDigits.h>
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/crypto/CBigNum.h>
@@ -24,9 +25,10 @@
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/UintTypes.h>
 #include <beast/module/core/text/LexicalCast.h>
-#include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <beast/cxx14/iterator.h> // <iterator>
+#include <algorithm>
+#include <limits>
 
 namespace ripple {
 
@@ -131,7 +133,7 @@ STAmount::STAmount (Issue const& issue,
 {
 }
 
-std::unique_ptr<STAmount>
+STAmount
 STAmount::construct (SerializerIterator& sit, SField::ref name)
 {
     std::uint64_t value = sit.get64 ();
@@ -141,13 +143,13 @@ STAmount::construct (SerializerIterator& sit, SField::ref name)
     {
         // positive
         if ((value & cPosNative) != 0)
-            return std::make_unique<STAmount> (name, value & ~cPosNative, false);
+            return STAmount (name, value & ~cPosNative, false);
 
         // negative
         if (value == 0)
             throw std::runtime_error ("negative zero is not canonical");
 
-        return std::make_unique<STAmount> (name, value, true);
+        return STAmount (name, value, true);
     }
 
     Issue issue;
@@ -179,13 +181,13 @@ STAmount::construct (SerializerIterator& sit, SField::ref name)
             throw std::runtime_error ("invalid currency value");
         }
 
-        return std::make_unique<STAmount> (name, issue, value, offset, isNegative);
+        return STAmount (name, issue, value, offset, isNegative);
     }
 
     if (offset != 512)
         throw std::runtime_error ("invalid currency value");
 
-    return std::make_unique<STAmount> (name, issue);
+    return STAmount (name, issue);
 }
 
 STAmount
@@ -198,12 +200,7 @@ STAmount::createFromInt64 (SField::ref name, std::int64_t value)
 
 STAmount STAmount::deserialize (SerializerIterator& it)
 {
-    auto s = construct (it, sfGeneric);
-
-    if (!s)
-        throw std::runtime_error("Deserialization error");
-
-    return STAmount (*s);
+    return construct (it, sfGeneric);
 }
 
 //------------------------------------------------------------------------------
@@ -383,80 +380,144 @@ std::uint64_t const STAmount::uRateOne = getRate (STAmount (1), STAmount (1));
 bool
 STAmount::setValue (std::string const& amount)
 {
-    static boost::regex const reNumber (
-        "^"                       // the beginning of the string
-        "([-+]?)"                 // (optional) + or - character
-        "(0|[1-9][0-9]*)"         // a number (no leading zeroes, unless 0)
-        "(\\.([0-9]+))?"          // (optional) period followed by any number
-        "([eE]([+-]?)([0-9]+))?"  // (optional) E, optional + or -, any number
-        "$",
-        boost::regex_constants::optimize);
+    // A single in-place scan of the grammar
+    //
+    //      [-+]? (0 | [1-9][0-9]*) (\.[0-9]+)? ([eE][+-]?[0-9]+)?
+    //
+    // accumulating the mantissa and exponent as it goes. This used to
+    // be a boost::regex whose submatches and digit-string
+    // concatenation allocated several times per amount parsed.
+    char const* p = amount.data ();
+    char const* const end = p + amount.size ();
+
+    bool valid = (p != end);
+    bool negative = false;
+    bool hasFraction = false;
+    bool overflow = false;
+    std::uint64_t mantissa = 0;
+    std::size_t digits = 0;
+    int fracDigits = 0;
 
-    boost::smatch match;
+    auto const isDigit = [] (char c)
+    {
+        return (c >= '0') && (c <= '9');
+    };
 
-    if (!boost::regex_match (amount, match, reNumber))
+    auto const accumulate = [&] (char c)
     {
-        WriteLog (lsWARNING, STAmount) <<
-            "Number not valid: \"" << amount << "\"";
-        return false;
+        std::uint64_t const d = c - '0';
+
+        if (mantissa > (std::numeric_limits <std::uint64_t>::max () - d) / 10)
+            overflow = true;
+        else
+            mantissa = mantissa * 10 + d;
+
+        ++digits;
+    };
+
+    if (valid && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
     }
 
-    // Match fields:
-    //   0 = whole input
-    //   1 = sign
-    //   2 = integer portion
-    //   3 = whole fraction (with '.')
-    //   4 = fraction (without '.')
-    //   5 = whole exponent (with 'e')
-    //   6 = exponent sign
-    //   7 = exponent number
+    // The integer part is "0", or a nonzero digit followed by any
+    // digits: no leading zeroes.
+    if (p == end || ! isDigit (*p))
+        valid = false;
+    else if (*p == '0')
+    {
+        accumulate (*p++);
 
-    try
+        if (p != end && isDigit (*p))
+            valid = false;
+    }
+    else
     {
-        // CHECKME: Why 32? Shouldn't this be 16?
-        if ((match[2].length () + match[4].length ()) > 32)
-        {
-            WriteLog (lsWARNING, STAmount) << "Overlong number: " << amount;
-            return false;
-        }
+        do
+            accumulate (*p++);
+        while (p != end && isDigit (*p));
+    }
 
-        mIsNegative = (match[1].matched && (match[1] == "-"));
+    if (valid && p != end && *p == '.')
+    {
+        hasFraction = true;
+        ++p;
 
-        // Can't specify XRP using fractional representation
-        if (mIsNative && match[3].matched)
-            return false;
+        if (p == end || ! isDigit (*p))
+            valid = false;
 
-        if (!match[4].matched) // integer only
+        while (p != end && isDigit (*p))
         {
-            mValue = beast::lexicalCastThrow <std::uint64_t> (std::string (match[2]));
-            mOffset = 0;
-        }
-        else
-        {
-            // integer and fraction
-            mValue = beast::lexicalCastThrow <std::uint64_t> (match[2] + match[4]);
-            mOffset = -(match[4].length ());
+            accumulate (*p++);
+            ++fracDigits;
         }
+    }
+
+    int exponent = 0;
+    bool expNegative = false;
 
-        if (match[5].matched)
+    if (valid && p != end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+
+        if (p != end && (*p == '-' || *p == '+'))
+            expNegative = (*p++ == '-');
+
+        if (p == end || ! isDigit (*p))
+            valid = false;
+
+        while (p != end && isDigit (*p))
         {
-            // we have an exponent
-            if (match[6].matched && (match[6] == "-"))
-                mOffset -= beast::lexicalCastThrow <int> (std::string (match[7]));
+            int const d = *p++ - '0';
+
+            if (exponent > (std::numeric_limits <int>::max () - d) / 10)
+                overflow = true;
             else
-                mOffset += beast::lexicalCastThrow <int> (std::string (match[7]));
+                exponent = exponent * 10 + d;
         }
+    }
 
-        canonicalize ();
+    if (! valid || p != end)
+    {
+        WriteLog (lsWARNING, STAmount) <<
+            "Number not valid: \"" << amount << "\"";
+        return false;
+    }
 
-        WriteLog (lsTRACE, STAmount) <<
-            "Canonicalized \"" << amount << "\" to " << mValue << " : " << mOffset;
+    // CHECKME: Why 32? Shouldn't this be 16?
+    if (digits > 32)
+    {
+        WriteLog (lsWARNING, STAmount) << "Overlong number: " << amount;
+        return false;
+    }
+
+    // The old lexicalCastThrow would have thrown here
+    if (overflow)
+        return false;
+
+    mIsNegative = negative;
+
+    // Can't specify XRP using fractional representation
+    if (mIsNative && hasFraction)
+        return false;
+
+    mValue = mantissa;
+    mOffset = -fracDigits;
+    mOffset += expNegative ? -exponent : exponent;
+
+    try
+    {
+        canonicalize ();
     }
     catch (...)
     {
         return false;
     }
 
+    WriteLog (lsTRACE, STAmount) <<
+        "Canonicalized \"" << amount << "\" to " << mValue << " : " << mOffset;
+
     return true;
 }
 
@@ -620,6 +681,33 @@ STAmount::getFullText () const
     return ret;
 }
 
+namespace {
+
+// A small per-thread cache of rendered amount texts. The publish path
+// serializes the same few amounts over and over — fees, round offer
+// prices — so remembering the last rendering of each slot skips the
+// formatting entirely for them. POD only: VS2013 thread storage cannot
+// run constructors.
+struct AmountTextEntry
+{
+    std::uint64_t value;
+    int offset;
+    bool negative;
+    bool native;
+    std::uint8_t length;
+    char text[32];
+};
+
+std::size_t const amountTextSlots = 64;
+
+#ifdef _MSC_VER
+__declspec(thread) AmountTextEntry amountTextCache[amountTextSlots];
+#else
+__thread AmountTextEntry amountTextCache[amountTextSlots];
+#endif
+
+}
+
 std::string
 STAmount::getText () const
 {
@@ -627,87 +715,83 @@ STAmount::getText () const
     if (*this == zero)
         return "0";
 
-    std::string const raw_value (std::to_string (mValue));
-    std::string ret;
+    auto& entry = amountTextCache[
+        (mValue ^ (mValue >> 17) ^ std::uint64_t (mOffset)) &
+            (amountTextSlots - 1)];
+
+    if (entry.length != 0 && entry.value == mValue &&
+        entry.offset == mOffset && entry.negative == mIsNegative &&
+        entry.native == mIsNative)
+    {
+        return std::string (entry.text, entry.length);
+    }
+
+    char buffer[32];
+    char* out = buffer;
 
     if (mIsNegative)
-        ret.append (1, '-');
+        *out++ = '-';
+
+    char digits[24];
+    char* digitsEnd = writeDecimal (digits, mValue);
+    int const nDigits = int (digitsEnd - digits);
 
     bool const scientific ((mOffset != 0) && ((mOffset < -25) || (mOffset > -5)));
 
     if (mIsNative || scientific)
     {
-        ret.append (raw_value);
+        out = std::copy (digits, digitsEnd, out);
 
         if (scientific)
         {
-            ret.append (1, 'e');
-            ret.append (std::to_string (mOffset));
+            *out++ = 'e';
+            out = writeDecimal (out, std::int64_t (mOffset));
         }
-
-        return ret;
     }
+    else
+    {
+        assert (mOffset + 43 > 0);
 
-    assert (mOffset + 43 > 0);
-
-    size_t const pad_prefix = 27;
-    size_t const pad_suffix = 23;
-
-    std::string val;
-    val.reserve (raw_value.length () + pad_prefix + pad_suffix);
-    val.append (pad_prefix, '0');
-    val.append (raw_value);
-    val.append (pad_suffix, '0');
-
-    size_t const offset (mOffset + 43);
-
-    auto pre_from (val.begin ());
-    auto const pre_to (val.begin () + offset);
-
-    auto const post_from (val.begin () + offset);
-    auto post_to (val.end ());
-
-    // Crop leading zeroes. Take advantage of the fact that there's always a
-    // fixed amount of leading zeroes and skip them.
-    if (std::distance (pre_from, pre_to) > pad_prefix)
-        pre_from += pad_prefix;
+        // The decimal point falls this many digits into the mantissa
+        int const point = nDigits + mOffset;
 
-    assert (post_to >= post_from);
+        // Crop trailing zeroes from the fractional part
+        while (digitsEnd > digits + std::max (point, 0) &&
+               digitsEnd[-1] == '0')
+            --digitsEnd;
 
-    pre_from = std::find_if (pre_from, pre_to,
-        [](char c)
+        if (point <= 0)
         {
-            return c != '0';
-        });
-
-    // Crop trailing zeroes. Take advantage of the fact that there's always a
-    // fixed amount of trailing zeroes and skip them.
-    if (std::distance (post_from, post_to) > pad_suffix)
-        post_to -= pad_suffix;
-
-    assert (post_to >= post_from);
-
-    post_to = std::find_if(
-        std::make_reverse_iterator (post_to),
-        std::make_reverse_iterator (post_from),
-        [](char c)
+            *out++ = '0';
+            *out++ = '.';
+            out = std::fill_n (out, -point, '0');
+            out = std::copy (digits, digitsEnd, out);
+        }
+        else if (point >= nDigits)
         {
-            return c != '0';
-        }).base();
-
-    // Assemble the output:
-    if (pre_from == pre_to)
-        ret.append (1, '0');
-    else
-        ret.append(pre_from, pre_to);
+            out = std::copy (digits, digitsEnd, out);
+            out = std::fill_n (out, point - nDigits, '0');
+        }
+        else
+        {
+            out = std::copy (digits, digits + point, out);
 
-    if (post_to != post_from)
-    {
-        ret.append (1, '.');
-        ret.append (post_from, post_to);
+            if (digitsEnd > digits + point)
+            {
+                *out++ = '.';
+                out = std::copy (digits + point, digitsEnd, out);
+            }
+        }
     }
 
-    return ret;
+    entry.value = mValue;
+    entry.offset = mOffset;
+    entry.negative = mIsNegative;
+    entry.native = mIsNative;
+    entry.length = std::uint8_t (out - buffer);
+    std::copy (buffer, out, entry.text);
+
+    return std::string (buffer, out);
 }
 
 Json::Value
@@ -1141,6 +1225,42 @@ operator- (STAmount const& value)
 //
 //------------------------------------------------------------------------------
 
+/** Computes (value1 * value2 + rounding) / divisor.
+
+    The inputs are 64-bit, so the intermediate product always fits in
+    128 bits: on compilers with a native 128-bit integer the result is
+    exact with no allocation. The bignum path remains only for
+    compilers without one.
+*/
+static
+std::uint64_t
+mulDiv (std::uint64_t value1, std::uint64_t value2,
+    std::uint64_t rounding, std::uint64_t divisor)
+{
+#if defined (__SIZEOF_INT128__)
+    unsigned __int128 product = value1;
+    product *= value2;
+    product += rounding;
+    return static_cast<std::uint64_t> (product / divisor);
+#else
+    CBigNum v;
+
+    if ((BN_add_word64 (&v, value1) != 1) ||
+            (BN_mul_word64 (&v, value2) != 1))
+        throw std::runtime_error ("internal bn error");
+
+    if (rounding != 0)
+        BN_add_word64 (&v, rounding);
+
+    if (BN_div_word64 (&v, divisor) == ((std::uint64_t) - 1))
+        throw std::runtime_error ("internal bn error");
+
+    assert (BN_num_bytes (&v) <= 64);
+
+    return v.getuint64 ();
+#endif
+}
+
 STAmount
 divide (STAmount const& num, STAmount const& den, Issue const& issue)
 {
@@ -1175,20 +1295,9 @@ divide (STAmount const& num, STAmount const& den, Issue const& issue)
     }
 
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) ||
-            (BN_mul_word64 (&v, tenTo17) != 1) ||
-            (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
     // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
     // TODO(tom): where do 5 and 17 come from?
-    return STAmount (issue, v.getuint64 () + 5,
+    return STAmount (issue, mulDiv (numVal, tenTo17, 0, denVal) + 5,
                      numOffset - denOffset - 17,
                      num.negative() != den.negative());
 }
@@ -1240,20 +1349,8 @@ multiply (STAmount const& v1, STAmount const& v2, Issue const& issue)
 
     // Compute (numerator * denominator) / 10^14 with rounding
     // 10^16 <= result <= 10^18
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, value1) != 1) ||
-            (BN_mul_word64 (&v, value2) != 1) ||
-            (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
-    // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
     // TODO(tom): where do 7 and 14 come from?
-    return STAmount (issue, v.getuint64 () + 7,
+    return STAmount (issue, mulDiv (value1, value2, 0, tenTo14) + 7,
         offset1 + offset2 + 14, v1.negative() != v2.negative());
 }
 
@@ -1496,21 +1593,9 @@ mulRound (STAmount const& v1, STAmount const& v2,
     bool resultNegative = v1.negative() != v2.negative();
     // Compute (numerator * denominator) / 10^14 with rounding
     // 10^16 <= result <= 10^18
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, value1) != 1) || (BN_mul_word64 (&v, value2) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // rounding down is automatic when we divide
-        BN_add_word64 (&v, tenTo14m1);
-
-    if  (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
-    // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
-    std::uint64_t amount = v.getuint64 ();
+    // Rounding down is automatic when we divide
+    std::uint64_t amount = mulDiv (value1, value2,
+        (resultNegative != roundUp) ? tenTo14m1 : 0, tenTo14);
     int offset = offset1 + offset2 + 14;
     canonicalizeRound (
         isXRP (issue), amount, offset, resultNegative != roundUp);
@@ -1547,21 +1632,10 @@ divRound (STAmount const& num, STAmount const& den,
 
     bool resultNegative = num.negative() != den.negative();
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) || (BN_mul_word64 (&v, tenTo17) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // Rounding down is automatic when we divide
-        BN_add_word64 (&v, denVal - 1);
-
-    if (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
     // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
-    std::uint64_t amount = v.getuint64 ();
+    // Rounding down is automatic when we divide
+    std::uint64_t amount = mulDiv (numVal, tenTo17,
+        (resultNegative != roundUp) ? denVal - 1 : 0, denVal);
     int offset = numOffset - denOffset - 17;
     canonicalizeRound (
         isXRP (issue), amount, offset, resultNegative != roundUp);
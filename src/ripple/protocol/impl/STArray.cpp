@@ -109,11 +109,14 @@ Json::Value STArray::getJson (int p) const
     {
         if (object.getSType () != STI_NOTPRESENT)
         {
-            Json::Value inner = Json::objectValue;
+            // Fill in place: append returns a reference to the new
+            // element, avoiding a deep copy of the inner object.
+            Json::Value& inner = v.append (Json::objectValue);
             auto const& fname = object.getFName ();
-            auto k = fname.hasName () ? fname.fieldName : std::to_string(index);
-            inner[k] = object.getJson (p);
-            v.append (inner);
+            if (fname.hasName ())
+                inner[fname.getJsonName ()] = object.getJson (p);
+            else
+                inner[std::to_string (index)] = object.getJson (p);
             index++;
         }
     }
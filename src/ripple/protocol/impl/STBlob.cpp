@@ -25,17 +25,17 @@ namespace ripple {
 STBlob::STBlob (SerializerIterator& st, SField::ref name)
     : STBase (name)
 {
-    value = st.getVL ();
+    st.getVL (value);
 }
 
 std::string STBlob::getText () const
 {
-    return strHex (value);
+    return strHex (value.begin (), value.size ());
 }
 
 STBlob* STBlob::construct (SerializerIterator& u, SField::ref name)
 {
-    return new STBlob (name, u.getVL ());
+    return new STBlob (u, name);
 }
 
 bool STBlob::isEquivalent (const STBase& t) const
@@ -151,76 +151,79 @@ STObject::makeDeserializedObject (SerializedTypeID id, SField::ref name,
 void STObject::set (const SOTemplate& type)
 {
     mData.clear ();
+    mData.reserve (type.peek ().size ());
     mType = &type;
 
     for (SOTemplate::value_type const& elem : type.peek ())
     {
         if (elem->flags != SOE_REQUIRED)
-            giveObject (makeNonPresentObject (elem->e_field));
+            mData.emplace_back (detail::nonPresentObject, elem->e_field);
         else
-            giveObject (makeDefaultObject (elem->e_field));
+            mData.emplace_back (detail::defaultObject, elem->e_field);
     }
 }
 
 bool STObject::setType (const SOTemplate& type)
 {
-    boost::ptr_vector<STBase> newData (type.peek ().size ());
     bool valid = true;
 
     mType = &type;
 
-    STBase** array = mData.c_array();
-    std::size_t count = mData.size ();
+    // Build the result with every template slot preallocated, then
+    // drop each parsed field directly into its slot using the
+    // template's field index. One pass over the parsed fields
+    // replaces the old quadratic match loop.
+    list_type newData;
+    newData.reserve (type.peek ().size ());
 
     for (auto const& elem : type.peek ())
-    {
-        // Loop through all the fields in the template
-        bool match = false;
+        newData.emplace_back (detail::nonPresentObject, elem->e_field);
 
-        for (std::size_t i = 0; i < count; ++i)
-            if ((array[i] != nullptr) &&
-                (array[i]->getFName () == elem->e_field))
-            {
-                // matching entry in the object, move to new vector
-                match = true;
+    std::vector<bool> filled (type.peek ().size (), false);
 
-                if ((elem->flags == SOE_DEFAULT) && array[i]->isDefault ())
-                {
-                    WriteLog (lsWARNING, STObject) <<
-                        "setType( " << getFName ().getName () <<
-                        ") invalid default " << elem->e_field.fieldName;
-                    valid = false;
-                }
+    for (auto& var : mData)
+    {
+        if (var.get_ptr () == nullptr)
+            continue;
 
-                newData.push_back (array[i]);
-                array[i] = nullptr;
-                break;
-            }
+        int const slot = type.getIndex (var.get ().getFName ());
 
-        if (!match)
+        if ((slot == -1) || filled[slot])
         {
-            // no match found in the object for an entry in the template
-            if (elem->flags == SOE_REQUIRED)
+            // Not in the template, or a duplicate of a field already
+            // placed: either way it must be discardable
+            if (!var.get ().getFName ().isDiscardable ())
             {
                 WriteLog (lsWARNING, STObject) <<
                     "setType( " << getFName ().getName () <<
-                    ") invalid missing " << elem->e_field.fieldName;
+                    ") invalid leftover " << var.get ().getFName ().getName ();
                 valid = false;
             }
 
-            // Make a default object
-            newData.push_back (makeNonPresentObject (elem->e_field).release ());
+            continue;
+        }
+
+        SOElement const& elem = *type.peek ()[slot];
+
+        if ((elem.flags == SOE_DEFAULT) && var.get ().isDefault ())
+        {
+            WriteLog (lsWARNING, STObject) <<
+                "setType( " << getFName ().getName () <<
+                ") invalid default " << elem.e_field.fieldName;
+            valid = false;
         }
+
+        newData[slot] = std::move (var);
+        filled[slot] = true;
     }
 
-    for (std::size_t i = 0; i < count; ++i)
+    for (std::size_t slot = 0; slot < filled.size (); ++slot)
     {
-        // Anything left over in the object must be discardable
-        if ((array[i] != nullptr) && !array[i]->getFName ().isDiscardable ())
+        if (!filled[slot] && (type.peek ()[slot]->flags == SOE_REQUIRED))
         {
             WriteLog (lsWARNING, STObject) <<
                 "setType( " << getFName ().getName () <<
-                ") invalid leftover " << array[i]->getFName ().getName ();
+                ") invalid missing " << type.peek ()[slot]->e_field.fieldName;
             valid = false;
         }
     }
@@ -234,14 +237,14 @@ bool STObject::setType (const SOTemplate& type)
 
 bool STObject::isValidForType ()
 {
-    boost::ptr_vector<STBase>::iterator it = mData.begin ();
+    auto it = mData.begin ();
 
     for (SOTemplate::value_type const& elem : mType->peek ())
     {
         if (it == mData.end ())
             return false;
 
-        if (elem->e_field != it->getFName ())
+        if (elem->e_field != it->get ().getFName ())
             return false;
 
         ++it;
@@ -267,6 +270,10 @@ bool STObject::set (SerializerIterator& sit, int depth)
     //
     mData.clear ();
 
+    // Enough slots for any common transaction, so the parse loop
+    // doesn't relocate the in-place fields while it appends
+    mData.reserve (16);
+
     // Consume data in the pipe until we run out or reach the end
     //
     while (!reachedEndOfObject && !sit.empty ())
@@ -301,10 +308,9 @@ bool STObject::set (SerializerIterator& sit, int depth)
                 throw std::runtime_error ("Unknown field");
             }
 
-            // Unflatten the field
+            // Unflatten the field in place
             //
-            giveObject (
-                makeDeserializedObject (fn.fieldType, fn, sit, depth + 1));
+            mData.emplace_back (sit, fn);
         }
     }
 
@@ -342,8 +348,10 @@ std::string STObject::getFullText () const
     }
     else ret = "{";
 
-    for (STBase const& elem : mData)
+    for (auto const& var : mData)
     {
+        auto const& elem = var.get ();
+
         if (elem.getSType () != STI_NOTPRESENT)
         {
             if (!first)
@@ -363,8 +371,10 @@ void STObject::add (Serializer& s, bool withSigningFields) const
 {
     std::map<int, const STBase*> fields;
 
-    for (STBase const& elem : mData)
+    for (auto const& var : mData)
     {
+        auto const& elem = var.get ();
+
         // pick out the fields and sort them
         if ((elem.getSType () != STI_NOTPRESENT) &&
             elem.getFName ().shouldInclude (withSigningFields))
@@ -399,7 +409,7 @@ std::string STObject::getText () const
 {
     std::string ret = "{";
     bool first = false;
-    for (STBase const& elem : mData)
+    for (auto const& var : mData)
     {
         if (!first)
         {
@@ -407,7 +417,7 @@ std::string STObject::getText () const
             first = false;
         }
 
-        ret += elem.getText ();
+        ret += var.get ().getText ();
     }
     ret += "}";
     return ret;
@@ -424,23 +434,25 @@ bool STObject::isEquivalent (const STBase& t) const
         return false;
     }
 
-    typedef boost::ptr_vector<STBase>::const_iterator const_iter;
-    const_iter it1 = mData.begin (), end1 = mData.end ();
-    const_iter it2 = v->mData.begin (), end2 = v->mData.end ();
+    auto it1 = mData.begin (), end1 = mData.end ();
+    auto it2 = v->mData.begin (), end2 = v->mData.end ();
 
     while ((it1 != end1) && (it2 != end2))
     {
-        if ((it1->getSType () != it2->getSType ()) || !it1->isEquivalent (*it2))
+        auto const& e1 = it1->get ();
+        auto const& e2 = it2->get ();
+
+        if ((e1.getSType () != e2.getSType ()) || !e1.isEquivalent (e2))
         {
-            if (it1->getSType () != it2->getSType ())
+            if (e1.getSType () != e2.getSType ())
             {
                 WriteLog (lsDEBUG, STObject) << "notEquiv type " <<
-                    it1->getFullText() << " != " <<  it2->getFullText();
+                    e1.getFullText() << " != " <<  e2.getFullText();
             }
             else
             {
                 WriteLog (lsDEBUG, STObject) << "notEquiv " <<
-                     it1->getFullText() << " != " <<  it2->getFullText();
+                     e1.getFullText() << " != " <<  e2.getFullText();
             }
             return false;
         }
@@ -474,9 +486,9 @@ int STObject::getFieldIndex (SField::ref field) const
         return mType->getIndex (field);
 
     int i = 0;
-    for (STBase const& elem : mData)
+    for (auto const& var : mData)
     {
-        if (elem.getFName () == field)
+        if (var.get ().getFName () == field)
             return i;
 
         ++i;
@@ -506,7 +518,7 @@ STBase& STObject::getField (SField::ref field)
 
 SField::ref STObject::getFieldSType (int index) const
 {
-    return mData[index].getFName ();
+    return mData[index].get ().getFName ();
 }
 
 const STBase* STObject::peekAtPField (SField::ref field) const
@@ -526,7 +538,10 @@ STBase* STObject::getPField (SField::ref field, bool createOkay)
     if (index == -1)
     {
         if (createOkay && isFree ())
-            return getPIndex (giveObject (makeDefaultObject (field)));
+        {
+            mData.emplace_back (detail::defaultObject, field);
+            return getPIndex (mData.size () - 1);
+        }
 
         return nullptr;
     }
@@ -608,7 +623,8 @@ STBase* STObject::makeFieldPresent (SField::ref field)
         if (!isFree ())
             throw std::runtime_error ("Field not found");
 
-        return getPIndex (giveObject (makeNonPresentObject (field)));
+        mData.emplace_back (detail::nonPresentObject, field);
+        return getPIndex (mData.size () - 1);
     }
 
     STBase* f = getPIndex (index);
@@ -616,7 +632,7 @@ STBase* STObject::makeFieldPresent (SField::ref field)
     if (f->getSType () != STI_NOTPRESENT)
         return f;
 
-    mData.replace (index, makeDefaultObject (f->getFName ()).release ());
+    mData[index] = detail::STVar (detail::defaultObject, f->getFName ());
     return getPIndex (index);
 }
 
@@ -632,7 +648,7 @@ void STObject::makeFieldAbsent (SField::ref field)
     if (f.getSType () == STI_NOTPRESENT)
         return;
 
-    mData.replace (index, makeNonPresentObject (f.getFName ()).release ());
+    mData[index] = detail::STVar (detail::nonPresentObject, f.getFName ());
 }
 
 bool STObject::delField (SField::ref field)
@@ -842,14 +858,20 @@ Json::Value STObject::getJson (int options) const
 
     // TODO(tom): this variable is never changed...?
     int index = 1;
-    for (auto const& it: mData)
+    for (auto const& var: mData)
     {
+        auto const& it = var.get ();
+
         if (it.getSType () != STI_NOTPRESENT)
         {
             auto const& n = it.getFName ();
-            auto key = n.hasName () ? std::string(n.getJsonName ()) :
-                    std::to_string (index);
-            ret[key] = it.getJson (options);
+
+            // Use the interned field name so the key string is not
+            // duplicated for every object serialized.
+            if (n.hasName ())
+                ret[n.getJsonName ()] = it.getJson (options);
+            else
+                ret[std::to_string (index)] = it.getJson (options);
         }
     }
     return ret;
@@ -860,14 +882,18 @@ bool STObject::operator== (const STObject& obj) const
     // This is not particularly efficient, and only compares data elements
     // with binary representations
     int matches = 0;
-    for (STBase const& t1 : mData)
+    for (auto const& var1 : mData)
     {
+        auto const& t1 = var1.get ();
+
         if ((t1.getSType () != STI_NOTPRESENT) && t1.getFName ().isBinary ())
         {
             // each present field must have a matching field
             bool match = false;
-            for (STBase const& t2 : obj.mData)
+            for (auto const& var2 : obj.mData)
             {
+                auto const& t2 = var2.get ();
+
                 if (t1.getFName () == t2.getFName ())
                 {
                     if (t2 != t1)
@@ -890,8 +916,10 @@ bool STObject::operator== (const STObject& obj) const
     }
 
     int fields = 0;
-    for (STBase const& t2 : obj.mData)
+    for (auto const& var2 : obj.mData)
     {
+        auto const& t2 = var2.get ();
+
         if ((t2.getSType () != STI_NOTPRESENT) && t2.getFName ().isBinary ())
             ++fields;
     }
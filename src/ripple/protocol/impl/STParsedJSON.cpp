@@ -680,7 +680,7 @@ static bool parseObject (
 
     SField::ptr name (&inName);
 
-    boost::ptr_vector<STBase> data;
+    STObject data (*name);
     Json::Value::Members members (json.getMemberNames ());
 
     for (Json::Value::Members::iterator it (members.begin ());
@@ -718,7 +718,7 @@ static bool parseObject (
                     value, field, depth + 1, sub_object_, error));
                 if (! success)
                     return false;
-                data.push_back (sub_object_.release ());
+                data.giveObject (std::move (sub_object_));
             }
             catch (...)
             {
@@ -737,7 +737,7 @@ static bool parseObject (
                     value, field, depth + 1, sub_array_, error));
                 if (! success)
                     return false;
-                data.push_back (sub_array_.release ());
+                data.giveObject (std::move (sub_array_));
             }
             catch (...)
             {
@@ -756,14 +756,14 @@ static bool parseObject (
                 if (!serTyp)
                     return false;
 
-                data.push_back (serTyp.release ());
+                data.giveObject (std::move (serTyp));
             }
 
             break;
         }
     }
 
-    sub_object = std::make_unique <STObject> (*name, data);
+    sub_object = std::make_unique <STObject> (std::move (data));
     return true;
 }
 
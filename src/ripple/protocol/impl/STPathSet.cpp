@@ -88,14 +88,16 @@ STPathSet* STPathSet::construct (SerializerIterator& s, SField::ref name)
             Currency currency;
             Account issuer;
 
+            // Fill the fields in place rather than copying through a
+            // temporary untagged uint160
             if (hasAccount)
-                account.copyFrom (s.get160 ());
+                s.getBitString (account);
 
             if (hasCurrency)
-                currency.copyFrom (s.get160 ());
+                s.getBitString (currency);
 
             if (hasIssuer)
-                issuer.copyFrom (s.get160 ());
+                s.getBitString (issuer);
 
             path.emplace_back (account, currency, issuer, hasCurrency);
         }
@@ -164,6 +166,32 @@ void STPathSet::add (Serializer& s) const
 {
     assert (fName->isBinary ());
     assert (fName->fieldType == STI_PATHSET);
+
+    // Size the output exactly: a type byte per element plus its
+    // 160-bit fields, a boundary byte between paths, the terminator.
+    std::size_t bytes = value.empty () ? 1 : value.size ();
+
+    for (auto const& spPath : value)
+    {
+        for (auto const& speElement : spPath)
+        {
+            int const iType = speElement.getNodeType ();
+
+            bytes += 1;
+
+            if (iType & STPathElement::typeAccount)
+                bytes += 160 / 8;
+
+            if (iType & STPathElement::typeCurrency)
+                bytes += 160 / 8;
+
+            if (iType & STPathElement::typeIssuer)
+                bytes += 160 / 8;
+        }
+    }
+
+    s.reserve (s.getLength () + bytes);
+
     bool first = true;
 
     for (auto const& spPath : value)
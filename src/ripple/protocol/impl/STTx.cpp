@@ -117,7 +117,7 @@ STTx::getMentionedAccounts () const
 {
     std::vector<RippleAddress> accounts;
 
-    for (auto const& it : peekData ())
+    for (auto const& it : *this)
     {
         if (auto sa = dynamic_cast<STAccount const*> (&it))
         {
@@ -147,13 +147,33 @@ STTx::getMentionedAccounts () const
 uint256
 STTx::getSigningHash () const
 {
-    return STObject::getSigningHash (HashPrefix::txSign);
+    if (signing_hash_.isZero ())
+        signing_hash_ = STObject::getSigningHash (HashPrefix::txSign);
+
+    return signing_hash_;
+}
+
+Blob const&
+STTx::getSerialized () const
+{
+    if (serialized_.empty ())
+    {
+        Serializer s;
+        add (s);
+        serialized_ = std::move (s.modData ());
+    }
+
+    return serialized_;
 }
 
 uint256
 STTx::getTransactionID () const
 {
-    return getHash (HashPrefix::transactionID);
+    if (txid_.isZero ())
+        txid_ = Serializer::getPrefixHash (
+            HashPrefix::transactionID, getSerialized ());
+
+    return txid_;
 }
 
 Blob STTx::getSignature () const
@@ -173,6 +193,7 @@ void STTx::sign (RippleAddress const& private_key)
     Blob signature;
     private_key.accountPrivateSign (getSigningHash (), signature);
     setFieldVL (sfTxnSignature, signature);
+    dirtyDigests ();
 }
 
 bool STTx::checkSign () const
@@ -205,11 +226,13 @@ bool STTx::checkSign () const
 void STTx::setSigningPubKey (RippleAddress const& naSignPubKey)
 {
     setFieldVL (sfSigningPubKey, naSignPubKey.getAccountPublic ());
+    dirtyDigests ();
 }
 
 void STTx::setSourceAccount (RippleAddress const& naSource)
 {
     setFieldAccount (sfAccount, naSource);
+    dirtyDigests ();
 }
 
 Json::Value STTx::getJson (int) const
@@ -224,8 +247,7 @@ Json::Value STTx::getJson (int options, bool binary) const
     if (binary)
     {
         Json::Value ret;
-        Serializer s = STObject::getSerializer ();
-        ret["tx"] = strHex (s.peekData ());
+        ret["tx"] = strHex (getSerialized ());
         ret["hash"] = to_string (getTransactionID ());
         return ret;
     }
@@ -245,8 +267,7 @@ STTx::getMetaSQLInsertReplaceHeader ()
 std::string STTx::getMetaSQL (std::uint32_t inLedger,
                                                std::string const& escapedMetaData) const
 {
-    Serializer s;
-    add (s);
+    Serializer s (getSerialized ());
     return getMetaSQL (s, inLedger, TXN_SQL_VALIDATED, escapedMetaData);
 }
 
@@ -403,6 +424,14 @@ public:
         {
             pass ();
         }
+
+        // The cached serialization and digests must track mutations
+        expect (j.getSerialized () == rawTxn.peekData (),
+            "Cached serialization mismatch");
+        uint256 const origID = j.getTransactionID ();
+        j.setSequence (7);
+        expect (j.getTransactionID () != origID,
+            "Transaction ID not recomputed after mutation");
     }
 };
 
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/protocol/STVar.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STBitString.h>
+#include <ripple/protocol/STBlob.h>
+#include <ripple/protocol/STInteger.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STPathSet.h>
+#include <ripple/protocol/STVector256.h>
+#include <cassert>
+#include <stdexcept>
+
+namespace ripple {
+namespace detail {
+
+defaultObject_t defaultObject;
+nonPresentObject_t nonPresentObject;
+
+STVar& STVar::operator= (STVar const& rhs)
+{
+    if (this != &rhs)
+    {
+        destroy ();
+        if (rhs.p_ != nullptr)
+            p_ = rhs.p_->copy (max_size, &d_);
+    }
+
+    return *this;
+}
+
+STVar& STVar::operator= (STVar&& rhs)
+{
+    if (this != &rhs)
+    {
+        destroy ();
+        if (rhs.on_heap ())
+        {
+            p_ = rhs.p_;
+            rhs.p_ = nullptr;
+        }
+        else
+        {
+            p_ = rhs.p_->move (max_size, &d_);
+            rhs.destroy ();
+        }
+    }
+
+    return *this;
+}
+
+STVar::STVar (defaultObject_t, SField::ref name)
+    : STVar (name.fieldType, name)
+{
+}
+
+STVar::STVar (nonPresentObject_t, SField::ref name)
+    : STVar (STI_NOTPRESENT, name)
+{
+}
+
+STVar::STVar (SerializedTypeID id, SField::ref name)
+{
+    assert ((id == STI_NOTPRESENT) || (id == name.fieldType));
+
+    switch (id)
+    {
+    case STI_NOTPRESENT: construct<STBase> (name); break;
+    case STI_UINT8:      construct<STUInt8> (name); break;
+    case STI_UINT16:     construct<STUInt16> (name); break;
+    case STI_UINT32:     construct<STUInt32> (name); break;
+    case STI_UINT64:     construct<STUInt64> (name); break;
+    case STI_AMOUNT:     construct<STAmount> (name); break;
+    case STI_HASH128:    construct<STHash128> (name); break;
+    case STI_HASH160:    construct<STHash160> (name); break;
+    case STI_HASH256:    construct<STHash256> (name); break;
+    case STI_VECTOR256:  construct<STVector256> (name); break;
+    case STI_VL:         construct<STBlob> (name); break;
+    case STI_ACCOUNT:    construct<STAccount> (name); break;
+    case STI_PATHSET:    construct<STPathSet> (name); break;
+    case STI_OBJECT:     construct<STObject> (name); break;
+    case STI_ARRAY:      construct<STArray> (name); break;
+    default:
+        throw std::runtime_error ("Unknown object type");
+    }
+}
+
+STVar::STVar (SerializerIterator& sit, SField::ref name)
+{
+    switch (name.fieldType)
+    {
+    case STI_NOTPRESENT:
+        construct<STBase> (name);
+        break;
+
+    case STI_UINT8:
+        construct<STUInt8> (name, sit.get8 ());
+        break;
+
+    case STI_UINT16:
+        construct<STUInt16> (name, sit.get16 ());
+        break;
+
+    case STI_UINT32:
+        construct<STUInt32> (name, sit.get32 ());
+        break;
+
+    case STI_UINT64:
+        construct<STUInt64> (name, sit.get64 ());
+        break;
+
+    case STI_AMOUNT:
+        construct<STAmount> (STAmount::construct (sit, name));
+        break;
+
+    case STI_HASH128:
+        construct<STHash128> (name, sit.getBitString<128> ());
+        break;
+
+    case STI_HASH160:
+        construct<STHash160> (name, sit.getBitString<160> ());
+        break;
+
+    case STI_HASH256:
+        construct<STHash256> (name, sit.getBitString<256> ());
+        break;
+
+    case STI_VL:
+        construct<STBlob> (name, sit.getVL ());
+        break;
+
+    case STI_ACCOUNT:
+        construct<STAccount> (name, sit.getVL ());
+        break;
+
+    case STI_OBJECT:
+        construct<STObject> (name);
+        static_cast<STObject*> (p_)->set (sit, 1);
+        break;
+
+    // The types with nontrivial decoding still deserialize onto the
+    // heap; their contents move into the in-place object
+    case STI_VECTOR256:
+    {
+        auto t = STVector256::deserialize (sit, name);
+        p_ = t->move (max_size, &d_);
+        break;
+    }
+
+    case STI_PATHSET:
+    {
+        auto t = STPathSet::deserialize (sit, name);
+        p_ = t->move (max_size, &d_);
+        break;
+    }
+
+    case STI_ARRAY:
+    {
+        auto t = STArray::deserialize (sit, name);
+        p_ = t->move (max_size, &d_);
+        break;
+    }
+
+    default:
+        throw std::runtime_error ("Unknown object type");
+    }
+}
+
+void STVar::destroy ()
+{
+    if (p_ == nullptr)
+        return;
+
+    if (on_heap ())
+        delete p_;
+    else
+        p_->~STBase ();
+
+    p_ = nullptr;
+}
+
+} // detail
+} // ripple
@@ -22,6 +22,7 @@
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/STVector256.h>
 #include <ripple/protocol/STAmount.h>
+#include <cstring>
 
 namespace ripple {
 
@@ -35,24 +36,18 @@ const STAmount saOne (noIssue(), 1u);
 // Return a new object from a SerializerIterator.
 STVector256* STVector256::construct (SerializerIterator& u, SField::ref name)
 {
-    Blob data = u.getVL ();
-    Blob ::iterator begin = data.begin ();
+    int dataLength;
+    unsigned char const* data = u.getVLDirect (dataLength);
 
     std::unique_ptr<STVector256> vec (new STVector256 (name));
 
-    int count = data.size () / (256 / 8);
-    vec->mValue.reserve (count);
+    int const count = dataLength / (256 / 8);
+    vec->mValue.resize (count);
 
-    unsigned int    uStart  = 0;
-
-    for (unsigned int i = 0; i != count; i++)
-    {
-        unsigned int    uEnd    = uStart + (256 / 8);
-
-        // This next line could be optimized to construct a default uint256 in the vector and then copy into it
-        vec->mValue.push_back (uint256 (Blob (begin + uStart, begin + uEnd)));
-        uStart  = uEnd;
-    }
+    // The wire format is just the concatenation of the hashes' bytes,
+    // which matches the in-memory layout: one copy moves them all.
+    if (count != 0)
+        memcpy (vec->mValue.front ().begin (), data, count * (256 / 8));
 
     return vec.release ();
 }
@@ -18,10 +18,12 @@
 //==============================================================================
 
 #include <ripple/basics/Log.h>
+#include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/Serializer.h>
 #include <beast/unit_test/suite.h>
 #include <openssl/ripemd.h>
 #include <openssl/pem.h>
+#include <cstring>
 
 namespace ripple {
 
@@ -301,6 +303,14 @@ bool Serializer::getRaw (Blob& o, int offset, int length) const
     return true;
 }
 
+bool Serializer::getRaw (SmallBlob& o, int offset, int length) const
+{
+    if ((offset + length) > mData.size ()) return false;
+
+    o.assign (mData.begin () + offset, mData.begin () + offset + length);
+    return true;
+}
+
 Blob Serializer::getRaw (int offset, int length) const
 {
     Blob o;
@@ -358,24 +368,115 @@ uint256 Serializer::getSHA512Half (const unsigned char* data, int len)
     return j[0];
 }
 
-uint256 Serializer::getPrefixHash (std::uint32_t prefix, const unsigned char* data, int len)
+namespace {
+
+void addPrefix (SHA512_CTX& ctx, std::uint32_t prefix)
 {
-    char be_prefix[4];
+    unsigned char be_prefix[4];
     be_prefix[0] = static_cast<unsigned char> (prefix >> 24);
     be_prefix[1] = static_cast<unsigned char> ((prefix >> 16) & 0xff);
     be_prefix[2] = static_cast<unsigned char> ((prefix >> 8) & 0xff);
     be_prefix[3] = static_cast<unsigned char> (prefix & 0xff);
 
-    uint256 j[2];
-    SHA512_CTX ctx;
     SHA512_Init (&ctx);
     SHA512_Update (&ctx, &be_prefix[0], 4);
-    SHA512_Update (&ctx, data, len);
-    SHA512_Final (reinterpret_cast<unsigned char*> (&j[0]), &ctx);
+}
+
+// Contexts that have already absorbed each protocol prefix. Cloning
+// one replaces an init and a prefix update on every prefixed hash,
+// which runs for every transaction ID, node hash and signing hash.
+struct PrefixedContexts
+{
+    enum { maxContexts = 8 };
+
+    std::uint32_t prefixes [maxContexts];
+    SHA512_CTX contexts [maxContexts];
+    int count;
+
+    PrefixedContexts ()
+        : count (0)
+    {
+        add (HashPrefix::transactionID);
+        add (HashPrefix::txNode);
+        add (HashPrefix::leafNode);
+        add (HashPrefix::innerNode);
+        add (HashPrefix::ledgerMaster);
+        add (HashPrefix::txSign);
+        add (HashPrefix::validation);
+        add (HashPrefix::proposal);
+    }
+
+    void add (std::uint32_t prefix)
+    {
+        assert (count < maxContexts);
+        addPrefix (contexts [count], prefix);
+        prefixes [count] = prefix;
+        ++count;
+    }
+
+    bool get (std::uint32_t prefix, SHA512_CTX& ctx) const
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (prefixes [i] == prefix)
+            {
+                std::memcpy (&ctx, &contexts [i], sizeof (ctx));
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+void initPrefixed (SHA512_CTX& ctx, std::uint32_t prefix)
+{
+    static PrefixedContexts const cached;
 
+    // Unknown prefixes (tests, future additions) pay the full init
+    if (!cached.get (prefix, ctx))
+        addPrefix (ctx, prefix);
+}
+
+}
+
+SHA512HalfHasher::SHA512HalfHasher (std::uint32_t prefix)
+{
+    static_assert (sizeof (m_ctx) >= sizeof (SHA512_CTX),
+        "SHA512HalfHasher storage is too small");
+
+    initPrefixed (*reinterpret_cast <SHA512_CTX*> (&m_ctx[0]), prefix);
+}
+
+void SHA512HalfHasher::update (void const* data, std::size_t bytes)
+{
+    SHA512_Update (reinterpret_cast <SHA512_CTX*> (&m_ctx[0]), data, bytes);
+}
+
+uint256 SHA512HalfHasher::finish ()
+{
+    uint256 j[2];
+    SHA512_Final (reinterpret_cast <unsigned char*> (&j[0]),
+        reinterpret_cast <SHA512_CTX*> (&m_ctx[0]));
     return j[0];
 }
 
+uint256 Serializer::getPrefixHash (std::uint32_t prefix, const unsigned char* data, int len)
+{
+    SHA512HalfHasher hasher (prefix);
+    hasher.update (data, len);
+    return hasher.finish ();
+}
+
+uint256 Serializer::getPrefixHash (std::uint32_t prefix, const unsigned char* data, int len,
+                                   uint256 const& tag)
+{
+    SHA512HalfHasher hasher (prefix);
+    hasher.update (data, len);
+    hasher.update (tag.begin (), tag.size ());
+    return hasher.finish ();
+}
+
 int Serializer::addVL (Blob const& vector)
 {
     int ret = addRaw (encodeVL (vector.size ()));
@@ -384,6 +485,16 @@ int Serializer::addVL (Blob const& vector)
     return ret;
 }
 
+int Serializer::addVL (SmallBlob const& blob)
+{
+    int ret = addRaw (encodeVL (blob.size ()));
+
+    if (!blob.empty ())
+        addRaw (blob.data (), blob.size ());
+
+    return ret;
+}
+
 int Serializer::addVL (const void* ptr, int len)
 {
     int ret = addRaw (encodeVL (len));
@@ -445,6 +556,47 @@ bool Serializer::getVL (Blob& objectVL, int offset, int& length) const
     return getRaw (objectVL, offset, datLen);
 }
 
+bool Serializer::getVL (SmallBlob& objectVL, int offset, int& length) const
+{
+    int b1;
+
+    if (!get8 (b1, offset++)) return false;
+
+    int datLen, lenLen = decodeLengthLength (b1);
+
+    try
+    {
+        if (lenLen == 1)
+            datLen = decodeVLLength (b1);
+        else if (lenLen == 2)
+        {
+            int b2;
+
+            if (!get8 (b2, offset++)) return false;
+
+            datLen = decodeVLLength (b1, b2);
+        }
+        else if (lenLen == 3)
+        {
+            int b2, b3;
+
+            if (!get8 (b2, offset++)) return false;
+
+            if (!get8 (b3, offset++)) return false;
+
+            datLen = decodeVLLength (b1, b2, b3);
+        }
+        else return false;
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    length = lenLen + datLen;
+    return getRaw (objectVL, offset, datLen);
+}
+
 bool Serializer::getVLLength (int& length, int offset) const
 {
     int b1;
@@ -640,6 +792,34 @@ Blob SerializerIterator::getVL ()
     return vl;
 }
 
+void SerializerIterator::getVL (SmallBlob& out)
+{
+    int length;
+
+    if (!mSerializer.getVL (out, mPos, length)) throw std::runtime_error ("invalid serializer getVL");
+
+    mPos += length;
+}
+
+unsigned char const* SerializerIterator::getVLDirect (int& dataLength)
+{
+    if (!mSerializer.getVLLength (dataLength, mPos))
+        throw std::runtime_error ("invalid serializer getVLDirect");
+
+    int b1;
+    mSerializer.get8 (b1, mPos);  // Cannot fail: getVLLength read it
+
+    int const lenLen = Serializer::decodeLengthLength (b1);
+
+    if ((mPos + lenLen + dataLength) > mSerializer.getLength ())
+        throw std::runtime_error ("invalid serializer getVLDirect");
+
+    auto data = static_cast<unsigned char const*> (
+        mSerializer.getDataPtr ()) + mPos + lenLen;
+    mPos += lenLen + dataLength;
+    return data;
+}
+
 Blob SerializerIterator::getRaw (int iLength)
 {
     int iPos    = mPos;
@@ -664,6 +844,40 @@ public:
         s2.addRaw (s1.peekData ());
 
         expect (s1.getPrefixHash (0x12345600) == s2.getSHA512Half ());
+
+        // A prefix with a precomputed context must hash identically
+        Serializer s3;
+        s3.add32 (HashPrefix::transactionID);
+        s3.addRaw (s1.peekData ());
+
+        expect (s1.getPrefixHash (HashPrefix::transactionID) ==
+            s3.getSHA512Half ());
+
+        // Material appended in pieces hashes the same as one buffer
+        SHA512HalfHasher hasher (HashPrefix::transactionID);
+        Blob const& data = s1.peekData ();
+        hasher.update (data.data (), 2);
+        hasher.update (data.data () + 2, data.size () - 2);
+
+        expect (hasher.finish () ==
+            s1.getPrefixHash (HashPrefix::transactionID));
+
+        // VL fields located in place match what was serialized
+        Serializer s4;
+        Blob const vl (300, 0x5a);
+        s4.addVL (vl);
+        s4.addVL (nullptr, 0);
+
+        SerializerIterator sit (s4);
+        int vlLength;
+        unsigned char const* vlData = sit.getVLDirect (vlLength);
+
+        expect (vlLength == 300);
+        expect (memcmp (vlData, vl.data (), vl.size ()) == 0);
+
+        sit.getVLDirect (vlLength);
+        expect (vlLength == 0);
+        expect (sit.empty ());
     }
 };
 
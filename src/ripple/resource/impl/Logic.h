@@ -41,9 +41,17 @@ private:
     typedef hash_map <Key, Entry, Key::hasher, Key::key_equal> Table;
     typedef beast::List <Entry> EntryIntrusiveList;
 
+    enum
+    {
+        // Number of lock shards the consumer table is split across.
+        // Entry operations only lock the shard the key hashes to, so
+        // concurrent charges on different endpoints don't contend.
+        numShards = 16
+    };
+
     struct State
     {
-        // Table of all entries
+        // Table of entries in this shard
         Table table;
 
         // Because the following are intrusive lists, a given Entry may be in
@@ -61,12 +69,16 @@ private:
 
         // List of all inactve entries
         EntryIntrusiveList inactive;
+    };
 
+    struct ImportState
+    {
         // All imported gossip data
         Imports import_table;
     };
 
     typedef beast::SharedData <State> SharedState;
+    typedef beast::SharedData <ImportState> SharedImportState;
 
     struct Stats
     {
@@ -80,11 +92,20 @@ private:
         beast::insight::Meter drop;
     };
 
-    SharedState m_state;
+    SharedState m_state [numShards];
+    SharedImportState m_import_state;
+    Key::hasher m_hasher;
     Stats m_stats;
     beast::abstract_clock <std::chrono::steady_clock>& m_clock;
     beast::Journal m_journal;
 
+    // Returns the shard holding this key. A single hasher instance is
+    // used so every lookup of a key lands on the same shard.
+    SharedState& stateFor (Key const& key)
+    {
+        return m_state [m_hasher (key) % numShards];
+    }
+
     //--------------------------------------------------------------------------
 public:
 
@@ -103,9 +124,16 @@ public:
         // Order matters here as well, the import table has to be
         // destroyed before the consumer table.
         //
-        SharedState::UnlockedAccess state (m_state);
-        state->import_table.clear();
-        state->table.clear();
+        {
+            SharedImportState::UnlockedAccess import (m_import_state);
+            import->import_table.clear();
+        }
+
+        for (int i = 0; i < numShards; ++i)
+        {
+            SharedState::UnlockedAccess state (m_state[i]);
+            state->table.clear();
+        }
     }
 
     Consumer newInboundEndpoint (beast::IP::Endpoint const& address)
@@ -113,13 +141,14 @@ public:
         if (isWhitelisted (address))
             return newAdminEndpoint (to_string (address));
 
+        Key const key (kindInbound, address.at_port (0));
         Entry* entry (nullptr);
 
         {
-            SharedState::Access state (m_state);
+            SharedState::Access state (stateFor (key));
             std::pair <Table::iterator, bool> result (
                 state->table.emplace (std::piecewise_construct,
-                    std::make_tuple (kindInbound, address.at_port (0)), // Key
+                    std::make_tuple (key),                              // Key
                     std::make_tuple (m_clock.now())));                  // Entry
 
             entry = &result.first->second;
@@ -147,13 +176,14 @@ public:
         if (isWhitelisted (address))
             return newAdminEndpoint (to_string (address));
 
+        Key const key (kindOutbound, address);
         Entry* entry (nullptr);
 
         {
-            SharedState::Access state (m_state);
+            SharedState::Access state (stateFor (key));
             std::pair <Table::iterator, bool> result (
                 state->table.emplace (std::piecewise_construct,
-                    std::make_tuple (kindOutbound, address),            // Key
+                    std::make_tuple (key),                              // Key
                     std::make_tuple (m_clock.now())));                  // Entry
 
             entry = &result.first->second;
@@ -176,13 +206,14 @@ public:
 
     Consumer newAdminEndpoint (std::string const& name)
     {
+        Key const key (kindAdmin, name);
         Entry* entry (nullptr);
 
         {
-            SharedState::Access state (m_state);
+            SharedState::Access state (stateFor (key));
             std::pair <Table::iterator, bool> result (
                 state->table.emplace (std::piecewise_construct,
-                    std::make_tuple (kindAdmin, name),                  // Key
+                    std::make_tuple (key),                              // Key
                     std::make_tuple (m_clock.now())));                  // Entry
 
             entry = &result.first->second;
@@ -208,13 +239,14 @@ public:
         m_journal.info <<
             "Elevate " << prior << " to " << name;
 
+        Key const key (kindAdmin, name);
         Entry* entry (nullptr);
 
         {
-            SharedState::Access state (m_state);
+            SharedState::Access state (stateFor (key));
             std::pair <Table::iterator, bool> result (
                 state->table.emplace (std::piecewise_construct,
-                    std::make_tuple (kindAdmin, name),                  // Key
+                    std::make_tuple (key),                              // Key
                     std::make_tuple (m_clock.now())));                  // Entry
 
             entry = &result.first->second;
@@ -227,10 +259,12 @@ public:
                         state->inactive.iterator_to (*entry));
                 state->admin.push_back (*entry);
             }
-
-            release (prior, state);
         }
 
+        // The prior entry may live in a different shard, so it is
+        // released under its own shard's lock.
+        release (prior);
+
         return *entry;
     }
 
@@ -245,43 +279,47 @@ public:
         clock_type::time_point const now (m_clock.now());
 
         Json::Value ret (Json::objectValue);
-        SharedState::Access state (m_state);
 
-        for (auto& inboundEntry : state->inbound)
+        for (int i = 0; i < numShards; ++i)
         {
-            int localBalance = inboundEntry.local_balance.value (now);
-            if ((localBalance + inboundEntry.remote_balance) >= threshold)
-            {
-                Json::Value& entry = (ret[inboundEntry.to_string()] = Json::objectValue);
-                entry["local"] = localBalance;
-                entry["remote"] = inboundEntry.remote_balance;
-                entry["type"] = "outbound";
-            }
+            SharedState::Access state (m_state[i]);
 
-        }
-        for (auto& outboundEntry : state->outbound)
-        {
-            int localBalance = outboundEntry.local_balance.value (now);
-            if ((localBalance + outboundEntry.remote_balance) >= threshold)
+            for (auto& inboundEntry : state->inbound)
             {
-                Json::Value& entry = (ret[outboundEntry.to_string()] = Json::objectValue);
-                entry["local"] = localBalance;
-                entry["remote"] = outboundEntry.remote_balance;
-                entry["type"] = "outbound";
-            }
+                int localBalance = inboundEntry.local_balance.value (now);
+                if ((localBalance + inboundEntry.remote_balance) >= threshold)
+                {
+                    Json::Value& entry = (ret[inboundEntry.to_string()] = Json::objectValue);
+                    entry["local"] = localBalance;
+                    entry["remote"] = inboundEntry.remote_balance;
+                    entry["type"] = "outbound";
+                }
 
-        }
-        for (auto& adminEntry : state->admin)
-        {
-            int localBalance = adminEntry.local_balance.value (now);
-            if ((localBalance + adminEntry.remote_balance) >= threshold)
+            }
+            for (auto& outboundEntry : state->outbound)
             {
-                Json::Value& entry = (ret[adminEntry.to_string()] = Json::objectValue);
-                entry["local"] = localBalance;
-                entry["remote"] = adminEntry.remote_balance;
-                entry["type"] = "admin";
+                int localBalance = outboundEntry.local_balance.value (now);
+                if ((localBalance + outboundEntry.remote_balance) >= threshold)
+                {
+                    Json::Value& entry = (ret[outboundEntry.to_string()] = Json::objectValue);
+                    entry["local"] = localBalance;
+                    entry["remote"] = outboundEntry.remote_balance;
+                    entry["type"] = "outbound";
+                }
+
             }
+            for (auto& adminEntry : state->admin)
+            {
+                int localBalance = adminEntry.local_balance.value (now);
+                if ((localBalance + adminEntry.remote_balance) >= threshold)
+                {
+                    Json::Value& entry = (ret[adminEntry.to_string()] = Json::objectValue);
+                    entry["local"] = localBalance;
+                    entry["remote"] = adminEntry.remote_balance;
+                    entry["type"] = "admin";
+                }
 
+            }
         }
 
         return ret;
@@ -292,18 +330,20 @@ public:
         clock_type::time_point const now (m_clock.now());
 
         Gossip gossip;
-        SharedState::Access state (m_state);
-
-        gossip.items.reserve (state->inbound.size());
 
-        for (auto& inboundEntry : state->inbound)
+        for (int i = 0; i < numShards; ++i)
         {
-            Gossip::Item item;
-            item.balance = inboundEntry.local_balance.value (now);
-            if (item.balance >= minimumGossipBalance)
+            SharedState::Access state (m_state[i]);
+
+            for (auto& inboundEntry : state->inbound)
             {
-                item.address = inboundEntry.key->address;
-                gossip.items.push_back (item);
+                Gossip::Item item;
+                item.balance = inboundEntry.local_balance.value (now);
+                if (item.balance >= minimumGossipBalance)
+                {
+                    item.address = inboundEntry.key->address;
+                    gossip.items.push_back (item);
+                }
             }
         }
 
@@ -316,9 +356,9 @@ public:
     {
         clock_type::rep const elapsed (m_clock.elapsed());
         {
-            SharedState::Access state (m_state);
+            SharedImportState::Access import (m_import_state);
             std::pair <Imports::iterator, bool> result (
-                state->import_table.emplace (std::piecewise_construct,
+                import->import_table.emplace (std::piecewise_construct,
                     std::make_tuple(origin),                  // Key
                     std::make_tuple(m_clock.elapsed())));     // Import
 
@@ -334,7 +374,7 @@ public:
                     Import::Item item;
                     item.balance = gossipItem.balance;
                     item.consumer = newInboundEndpoint (gossipItem.address);
-                    item.consumer.entry().remote_balance += item.balance;
+                    adjustRemoteBalance (item.consumer.entry(), item.balance);
                     next.items.push_back (item);
                 }
             }
@@ -351,14 +391,14 @@ public:
                     Import::Item item;
                     item.balance = gossipItem.balance;
                     item.consumer = newInboundEndpoint (gossipItem.address);
-                    item.consumer.entry().remote_balance += item.balance;
+                    adjustRemoteBalance (item.consumer.entry(), item.balance);
                     next.items.push_back (item);
                 }
 
                 Import& prev (result.first->second);
                 for (auto& item : prev.items)
                 {
-                    item.consumer.entry().remote_balance -= item.balance;
+                    adjustRemoteBalance (item.consumer.entry(), - item.balance);
                 }
 
                 std::swap (next, prev);
@@ -380,42 +420,50 @@ public:
     //
     void periodicActivity ()
     {
-        SharedState::Access state (m_state);
-
         clock_type::rep const elapsed (m_clock.elapsed());
 
-        for (auto iter (state->inactive.begin()); iter != state->inactive.end();)
+        for (int i = 0; i < numShards; ++i)
         {
-            if (iter->whenExpires <= elapsed)
-            {
-                m_journal.debug << "Expired " << *iter;
-                Table::iterator table_iter (
-                    state->table.find (*iter->key));
-                ++iter;
-                erase (table_iter, state);
-            }
-            else
+            SharedState::Access state (m_state[i]);
+
+            for (auto iter (state->inactive.begin()); iter != state->inactive.end();)
             {
-                break;
+                if (iter->whenExpires <= elapsed)
+                {
+                    m_journal.debug << "Expired " << *iter;
+                    Table::iterator table_iter (
+                        state->table.find (*iter->key));
+                    ++iter;
+                    erase (table_iter, state);
+                }
+                else
+                {
+                    break;
+                }
             }
         }
 
-        Imports::iterator iter (state->import_table.begin());
-        while (iter != state->import_table.end())
         {
-            Import& import (iter->second);
-            if (iter->second.whenExpires <= elapsed)
+            SharedImportState::Access import (m_import_state);
+
+            Imports::iterator iter (import->import_table.begin());
+            while (iter != import->import_table.end())
             {
-                for (auto item_iter (import.items.begin());
-                    item_iter != import.items.end(); ++item_iter)
+                if (iter->second.whenExpires <= elapsed)
                 {
-                    item_iter->consumer.entry().remote_balance -= item_iter->balance;
+                    Import& expired (iter->second);
+                    for (auto item_iter (expired.items.begin());
+                        item_iter != expired.items.end(); ++item_iter)
+                    {
+                        adjustRemoteBalance (
+                            item_iter->consumer.entry(), - item_iter->balance);
+                    }
+
+                    iter = import->import_table.erase (iter);
                 }
-
-                iter = state->import_table.erase (iter);
+                else
+                    ++iter;
             }
-            else
-                ++iter;
         }
     }
 
@@ -539,19 +587,19 @@ public:
 
     void acquire (Entry& entry)
     {
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         acquire (entry, state);
     }
 
     void release (Entry& entry)
     {
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         release (entry, state);
     }
 
     Disposition charge (Entry& entry, Charge const& fee)
     {
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         return charge (entry, fee, state);
     }
 
@@ -560,7 +608,7 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         return warn (entry, state);
     }
 
@@ -569,16 +617,23 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         return disconnect (entry, state);
     }
 
     int balance (Entry& entry)
     {
-        SharedState::Access state (m_state);
+        SharedState::Access state (stateFor (*entry.key));
         return balance (entry, state);
     }
 
+    // Adjust an entry's remote balance under its own shard's lock
+    void adjustRemoteBalance (Entry& entry, int amount)
+    {
+        SharedState::Access state (stateFor (*entry.key));
+        entry.remote_balance += amount;
+    }
+
     //--------------------------------------------------------------------------
 
     void writeList (
@@ -602,26 +657,40 @@ public:
     {
         clock_type::time_point const now (m_clock.now());
 
-        SharedState::Access state (m_state);
-
         {
             beast::PropertyStream::Set s ("inbound", map);
-            writeList (now, s, state->inbound);
+            for (int i = 0; i < numShards; ++i)
+            {
+                SharedState::Access state (m_state[i]);
+                writeList (now, s, state->inbound);
+            }
         }
 
         {
             beast::PropertyStream::Set s ("outbound", map);
-            writeList (now, s, state->outbound);
+            for (int i = 0; i < numShards; ++i)
+            {
+                SharedState::Access state (m_state[i]);
+                writeList (now, s, state->outbound);
+            }
         }
 
         {
             beast::PropertyStream::Set s ("admin", map);
-            writeList (now, s, state->admin);
+            for (int i = 0; i < numShards; ++i)
+            {
+                SharedState::Access state (m_state[i]);
+                writeList (now, s, state->admin);
+            }
         }
 
         {
             beast::PropertyStream::Set s ("inactive", map);
-            writeList (now, s, state->inactive);
+            for (int i = 0; i < numShards; ++i)
+            {
+                SharedState::Access state (m_state[i]);
+                writeList (now, s, state->inactive);
+            }
         }
     }
 };
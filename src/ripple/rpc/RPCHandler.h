@@ -22,6 +22,7 @@
 
 #include <ripple/core/Config.h>
 #include <ripple/net/InfoSub.h>
+#include <ripple/rpc/Output.h>
 #include <ripple/rpc/Status.h>
 #include <ripple/rpc/impl/Context.h>
 
@@ -37,6 +38,16 @@ Status doCommand (RPC::Context&, Json::Value&, YieldStrategy const& s = {});
 /** Execute an RPC command and store the results in an std::string. */
 void executeRPC (RPC::Context&, std::string&, YieldStrategy const& s = {});
 
+/** Execute an RPC command, writing results directly to an Output.
+
+    New-style handlers produce their results incrementally through the
+    O(1) JSON writer, so nothing larger than a single element - one
+    transaction, one ledger entry - is ever materialized before it is
+    handed to the Output.  Old-style handlers still build a Json::Value
+    and serialize it at the end.
+*/
+void executeRPC (RPC::Context&, Output const&, YieldStrategy const& s = {});
+
 /** Temporary flag to enable RPCs. */
 auto const streamingRPC = false;
 
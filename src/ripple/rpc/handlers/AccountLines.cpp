@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/AccountItemsCache.h>
 #include <ripple/rpc/impl/Tuning.h>
 
 namespace ripple {
@@ -191,7 +192,30 @@ Json::Value doAccountLines (RPC::Context& context)
         visitData.items.reserve (++reserve);
     }
 
-    if (! ledger->visitAccountItems (raAccount, startAfter, startHint, reserve,
+    // Snapshots only exist for accepted ledgers; open ledgers miss
+    uint256 const ledgerHash (
+        ledger->isClosed () ? ledger->getHash () : uint256 ());
+    auto& itemsCache (AccountItemsCache::instance ());
+    auto cachedItems (itemsCache.fetch (raAccount, ledgerHash));
+
+    if (! cachedItems && startAfter.isZero () &&
+        itemsCache.isCurrent (ledgerHash))
+    {
+        // Snapshot the owner directory; this request was going to walk
+        // all of it anyway, and later pages then come from memory
+        auto built (std::make_shared <std::vector <SLE::pointer>> ());
+        ledger->visitAccountItems (raAccount,
+            [&built](SLE::ref sleCur)
+            {
+                if (sleCur != nullptr)
+                    built->emplace_back (sleCur);
+            });
+
+        cachedItems = built;
+        itemsCache.insert (raAccount, ledgerHash, cachedItems);
+    }
+
+    auto const visitor =
         [&visitData](SLE::ref sleCur)
         {
             auto const line (RippleState::makeItem (visitData.accountID, sleCur));
@@ -204,7 +228,13 @@ Json::Value doAccountLines (RPC::Context& context)
             }
 
             return false;
-        }))
+        };
+
+    if (! (cachedItems
+        ? AccountItemsCache::visitItems (
+            cachedItems, startAfter, reserve, visitor)
+        : ledger->visitAccountItems (
+            raAccount, startAfter, startHint, reserve, visitor)))
     {
         return rpcError (rpcINVALID_PARAMS);
     }
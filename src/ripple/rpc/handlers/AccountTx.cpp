@@ -100,54 +100,53 @@ Json::Value doAccountTx (RPC::Context& context)
         ret["account"] = raAccount.humanAccountID ();
         Json::Value& jvTxns = (ret["transactions"] = Json::arrayValue);
 
+        // Rows are converted to JSON as they are decoded from the database,
+        // so the page is never also held as a vector of transaction objects.
         if (bBinary)
         {
-            auto txns = context.netOps.getTxsAccountB (
+            context.netOps.visitTxsAccountB (
                 raAccount, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                context.role == Role::ADMIN);
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
+                context.role == Role::ADMIN,
+                [&] (NetworkOPs::txnMetaLedgerType const& it)
+                {
+                    Json::Value& jvObj = jvTxns.append (Json::objectValue);
 
-                jvObj["tx_blob"] = std::get<0> (it);
-                jvObj["meta"] = std::get<1> (it);
+                    jvObj["tx_blob"] = std::get<0> (it);
+                    jvObj["meta"] = std::get<1> (it);
 
-                std::uint32_t uLedgerIndex = std::get<2> (it);
+                    std::uint32_t uLedgerIndex = std::get<2> (it);
 
-                jvObj["ledger_index"] = uLedgerIndex;
-                jvObj[jss::validated] = bValidated &&
-                    uValidatedMin <= uLedgerIndex &&
-                    uValidatedMax >= uLedgerIndex;
-            }
+                    jvObj["ledger_index"] = uLedgerIndex;
+                    jvObj[jss::validated] = bValidated &&
+                        uValidatedMin <= uLedgerIndex &&
+                        uValidatedMax >= uLedgerIndex;
+                });
         }
         else
         {
-            auto txns = context.netOps.getTxsAccount (
+            context.netOps.visitTxsAccount (
                 raAccount, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                context.role == Role::ADMIN);
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                if (it.first)
-                    jvObj[jss::tx] = it.first->getJson (1);
-
-                if (it.second)
+                context.role == Role::ADMIN,
+                [&] (NetworkOPs::AccountTx const& it)
                 {
-                    auto meta = it.second->getJson (1);
-                    addPaymentDeliveredAmount (meta, context, it.first, it.second);
-                    jvObj[jss::meta] = meta;
+                    Json::Value& jvObj = jvTxns.append (Json::objectValue);
 
-                    std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
+                    if (it.first)
+                        jvObj[jss::tx] = it.first->getJson (1);
 
-                    jvObj[jss::validated] = bValidated &&
-                        uValidatedMin <= uLedgerIndex &&
-                        uValidatedMax >= uLedgerIndex;
-                }
+                    if (it.second)
+                    {
+                        auto meta = it.second->getJson (1);
+                        addPaymentDeliveredAmount (meta, context, it.first, it.second);
+                        jvObj[jss::meta] = std::move (meta);
+
+                        std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
 
-            }
+                        jvObj[jss::validated] = bValidated &&
+                            uValidatedMin <= uLedgerIndex &&
+                            uValidatedMax >= uLedgerIndex;
+                    }
+                });
         }
 
         //Add information about the original query
@@ -188,7 +188,8 @@ Json::Value doBookOffers (RPC::Context& context)
         context.role == Role::ADMIN,
         lpLedger,
         {{pay_currency, pay_issuer}, {get_currency, get_issuer}},
-        raTakerID.getAccountID (), bProof, iLimit, jvMarker, jvResult);
+        raTakerID.getAccountID (), bProof, iLimit, jvMarker, jvResult,
+        context.yield);
 
     context.loadType = Resource::feeMediumBurdenRPC;
 
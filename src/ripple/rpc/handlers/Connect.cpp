@@ -28,7 +28,7 @@ namespace ripple {
 // XXX Might allow domain for manual connections.
 Json::Value doConnect (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
     if (getConfig ().RUN_STANDALONE)
         return "cannot connect in standalone mode";
 
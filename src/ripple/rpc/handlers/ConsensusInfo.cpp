@@ -24,7 +24,7 @@ Json::Value doConsensusInfo (RPC::Context& context)
     Json::Value ret (Json::objectValue);
 
     {
-        auto lock = getApp().masterLock();
+        MasterSharedGuard lock (getApp ().consensusLock ());
         ret["info"] = context.netOps.getConsensusInfo ();
     }
 
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/LatencyProbes.h>
 #include <ripple/basics/UptimeTimer.h>
 #include <ripple/nodestore/Database.h>
 #include <boost/foreach.hpp>
@@ -28,7 +29,7 @@ namespace ripple {
 // }
 Json::Value doGetCounts (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterSharedGuard lock (getApp ().netStateLock ());
 
     int minCount = 10;
 
@@ -93,6 +94,56 @@ Json::Value doGetCounts (RPC::Context& context)
     ret["node_written_bytes"] = app.getNodeStore().getStoreSize();
     ret["node_read_bytes"] = app.getNodeStore().getFetchSize();
 
+    // Latency histograms for the instrumented hot paths. Buckets are
+    // powers of two in microseconds, labeled by their upper bound.
+    {
+        Json::Value& probes = (ret["latency_probes"] = Json::objectValue);
+
+        for (auto const& entry : LatencyProbes::getInstance ().getCounts ())
+        {
+            if (entry.count == 0)
+                continue;
+
+            Json::Value& probe = (probes[entry.name] = Json::objectValue);
+            probe["count"] = static_cast<Json::UInt> (entry.count);
+            probe["total_us"] = static_cast<Json::UInt> (
+                entry.totalMicroseconds);
+
+            Json::Value& buckets = (probe["buckets"] = Json::objectValue);
+            for (std::size_t b = 0; b < LatencyProbes::numBuckets; ++b)
+            {
+                if (entry.buckets[b] == 0)
+                    continue;
+
+                std::string const label = (b == LatencyProbes::numBuckets - 1)
+                    ? "over"
+                    : "<" + std::to_string (1ull << b) + "us";
+                buckets[label] = static_cast<Json::UInt> (entry.buckets[b]);
+            }
+        }
+    }
+
+    // Hold times of the decomposed master lock, per domain, so the
+    // decomposition can be validated in production.
+    {
+        Json::Value& locks = (ret["master_locks"] = Json::objectValue);
+
+        auto addDomain = [&locks](char const* name, MasterLockDomain& domain)
+        {
+            auto const stats = domain.stats ();
+            Json::Value& e = (locks[name] = Json::objectValue);
+            e["holds"] = static_cast<Json::UInt> (stats.count);
+            e["hold_ms_avg"] = static_cast<Json::UInt> (stats.latencyAvg);
+            e["hold_ms_peak"] = static_cast<Json::UInt> (stats.latencyPeak);
+            if (stats.isOverloaded)
+                e["over_target"] = true;
+        };
+
+        addDomain ("consensus", app.consensusLock ());
+        addDomain ("open_ledger", app.openLedgerLock ());
+        addDomain ("net_state", app.netStateLock ());
+    }
+
     return ret;
 }
 
@@ -20,6 +20,8 @@
 #ifndef RIPPLE_HANDLER_HANDLERS
 #define RIPPLE_HANDLER_HANDLERS
 
+#include <ripple/rpc/Output.h>
+
 namespace ripple {
 
 Json::Value doAccountCurrencies     (RPC::Context&);
@@ -35,6 +37,7 @@ Json::Value doCanDelete             (RPC::Context&);
 Json::Value doConnect               (RPC::Context&);
 Json::Value doConsensusInfo         (RPC::Context&);
 Json::Value doFeature               (RPC::Context&);
+Json::Value doFee                   (RPC::Context&);
 Json::Value doFetchInfo             (RPC::Context&);
 Json::Value doGetCounts             (RPC::Context&);
 Json::Value doInternal              (RPC::Context&);
@@ -45,25 +48,34 @@ Json::Value doLedgerCurrent         (RPC::Context&);
 Json::Value doLedgerData            (RPC::Context&);
 Json::Value doLedgerEntry           (RPC::Context&);
 Json::Value doLedgerHeader          (RPC::Context&);
+Json::Value doLedgerReplay          (RPC::Context&);
 Json::Value doLedgerRequest         (RPC::Context&);
+Json::Value doLedgerSnapshot        (RPC::Context&);
+
+// Writes an HTTP response itself rather than returning Json; see the
+// dispatch in ServerHandlerImp::processRequest
+void doLedgerDataBinaryFrames       (RPC::Context&, RPC::Output const&);
+Json::Value doLoadGenerate          (RPC::Context&);
 Json::Value doLogLevel              (RPC::Context&);
 Json::Value doLogRotate             (RPC::Context&);
+Json::Value doMemoryBudget          (RPC::Context&);
 Json::Value doOwnerInfo             (RPC::Context&);
 Json::Value doPathFind              (RPC::Context&);
 Json::Value doPeers                 (RPC::Context&);
 Json::Value doPing                  (RPC::Context&);
 Json::Value doPrint                 (RPC::Context&);
 Json::Value doRandom                (RPC::Context&);
-Json::Value doRipplePathFind        (RPC::Context&);
 Json::Value doSMS                   (RPC::Context&);
 Json::Value doServerInfo            (RPC::Context&); // for humans
 Json::Value doServerState           (RPC::Context&); // for machines
 Json::Value doSessionClose          (RPC::Context&);
 Json::Value doSessionOpen           (RPC::Context&);
 Json::Value doSign                  (RPC::Context&);
+Json::Value doSignBatch             (RPC::Context&);
 Json::Value doStop                  (RPC::Context&);
 Json::Value doSubmit                (RPC::Context&);
 Json::Value doSubscribe             (RPC::Context&);
+Json::Value doSyncGovernor          (RPC::Context&);
 Json::Value doTransactionEntry      (RPC::Context&);
 Json::Value doTx                    (RPC::Context&);
 Json::Value doTxHistory             (RPC::Context&);
@@ -22,7 +22,7 @@ namespace ripple {
 
 Json::Value doLedgerAccept (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    // acceptLedger takes the consensus lock internally
     Json::Value jvResult;
 
     if (!getConfig ().RUN_STANDALONE)
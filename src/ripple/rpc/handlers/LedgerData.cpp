@@ -17,15 +17,37 @@
 */
 //==============================================================================
 
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/rpc/Yield.h>
+#include <ripple/rpc/impl/Tuning.h>
 #include <ripple/server/Role.h>
+#include <ripple/server/impl/JSONRPCUtil.h>
 
 namespace ripple {
 
+// Matches a serialized state entry against a ledger entry type without
+// materializing it. Entries serialize sfLedgerEntryType first: the
+// field byte 0x11, then the type as a big-endian 16-bit value.
+static bool entryHasType (SHAMapItem const& item, LedgerEntryType type)
+{
+    Blob const& data = item.peekData ();
+
+    if ((data.size () < 3) || (data[0] != 0x11))
+        return false;
+
+    return ((data[1] << 8) | data[2]) == type;
+}
+
 // Get state nodes from a ledger
 //   Inputs:
 //     limit:        integer, maximum number of entries
 //     marker:       opaque, resume point
 //     binary:       boolean, format
+//     type:         string, return only entries of this type, named as
+//                   in LedgerFormats ("Offer", "AccountRoot", ...).
+//                   Scanned entries still count against the limit, so a
+//                   page of a filtered scan can come back empty with a
+//                   marker.
 //   Outputs:
 //     ledger_hash:  chosen ledger's hash
 //     ledger_index: chosen ledger's index
@@ -70,14 +92,35 @@ Json::Value doLedgerData (RPC::Context& context)
     if ((limit < 0) || ((limit > maxLimit) && (context.role != Role::ADMIN)))
         limit = maxLimit;
 
+    LedgerEntryType filter = ltINVALID;
+    if (params.isMember ("type"))
+    {
+        Json::Value const& jType = params["type"];
+        auto const formatItem = jType.isString () ?
+            LedgerFormats::getInstance ().findByName (jType.asString ()) :
+            nullptr;
+
+        if (!formatItem)
+            return RPC::expected_field_error ("type", "valid");
+
+        filter = formatItem->getType ();
+    }
+
     jvResult["ledger_hash"] = to_string (lpLedger->getHash());
     jvResult["ledger_index"] = std::to_string( lpLedger->getLedgerSeq ());
 
     Json::Value& nodes = (jvResult["state"] = Json::arrayValue);
     SHAMap& map = *(lpLedger->peekAccountStateMap ());
 
+    // When running as a coroutine, give up the thread every so many
+    // entries so other clients can make progress while reads complete
+    RPC::CountedYield yield (
+        context.yield ? RPC::Tuning::ledgerDataYieldCount : 0, context.yield);
+
     for (;;)
     {
+       yield.yield ();
+
        SHAMapItem::pointer item = map.peekNextItem (resumePoint);
        if (!item)
            break;
@@ -90,6 +133,11 @@ Json::Value doLedgerData (RPC::Context& context)
            break;
        }
 
+       // Check the type straight off the serialized entry, before any
+       // deserialization, so a filtered scan is pure traversal
+       if ((filter != ltINVALID) && !entryHasType (*item, filter))
+           continue;
+
        if (isBinary)
        {
            Json::Value& entry = nodes.append (Json::objectValue);
@@ -108,4 +156,121 @@ Json::Value doLedgerData (RPC::Context& context)
     return jvResult;
 }
 
+// Raw-framed variant of ledger_data, reached over HTTP by passing
+// 'binary_frames': true. The body is back-to-back records - 32-byte
+// entry index, 32-bit big-endian size, raw entry data - with no hex
+// or JSON wrapping, so bulk state export is I/O bound rather than
+// CPU bound. Metadata rides in response headers: X-Ledger-Hash,
+// X-Ledger-Index and, when another page remains, X-Marker.
+void doLedgerDataBinaryFrames (RPC::Context& context,
+    RPC::Output const& output)
+{
+    int const BINARY_PAGE_LENGTH = 2048;
+
+    Ledger::pointer lpLedger;
+    auto const& params = context.params;
+
+    Json::Value jvResult = RPC::lookupLedger (params, lpLedger, context.netOps);
+    if (!lpLedger)
+    {
+        HTTPReply (400, to_string (jvResult), output);
+        return;
+    }
+
+    uint256 resumePoint;
+    if (params.isMember ("marker"))
+    {
+        Json::Value const& jMarker = params["marker"];
+        if (!jMarker.isString () || !resumePoint.SetHex (jMarker.asString ()))
+        {
+            HTTPReply (400, "Invalid field 'marker'", output);
+            return;
+        }
+    }
+
+    int limit = -1;
+
+    if (params.isMember ("limit"))
+    {
+        Json::Value const& jLimit = params["limit"];
+        if (!jLimit.isIntegral ())
+        {
+            HTTPReply (400, "Invalid field 'limit'", output);
+            return;
+        }
+
+        limit = jLimit.asInt ();
+    }
+
+    if ((limit < 0) ||
+        ((limit > BINARY_PAGE_LENGTH) && (context.role != Role::ADMIN)))
+        limit = BINARY_PAGE_LENGTH;
+
+    LedgerEntryType filter = ltINVALID;
+    if (params.isMember ("type"))
+    {
+        Json::Value const& jType = params["type"];
+        auto const formatItem = jType.isString () ?
+            LedgerFormats::getInstance ().findByName (jType.asString ()) :
+            nullptr;
+
+        if (!formatItem)
+        {
+            HTTPReply (400, "Invalid field 'type'", output);
+            return;
+        }
+
+        filter = formatItem->getType ();
+    }
+
+    std::string headers;
+    headers += "X-Ledger-Hash: " + to_string (lpLedger->getHash()) + "\r\n";
+    headers += "X-Ledger-Index: " +
+        std::to_string (lpLedger->getLedgerSeq ()) + "\r\n";
+
+    std::string body;
+    SHAMap& map = *(lpLedger->peekAccountStateMap ());
+
+    RPC::CountedYield yield (
+        context.yield ? RPC::Tuning::ledgerDataYieldCount : 0, context.yield);
+
+    for (;;)
+    {
+       yield.yield ();
+
+       SHAMapItem::pointer item = map.peekNextItem (resumePoint);
+       if (!item)
+           break;
+       resumePoint = item->getTag();
+
+       if (limit-- <= 0)
+       {
+           --resumePoint;
+           headers += "X-Marker: " + to_string (resumePoint) + "\r\n";
+           break;
+       }
+
+       if ((filter != ltINVALID) && !entryHasType (*item, filter))
+           continue;
+
+       Blob const& data = item->peekData ();
+       std::uint32_t const size = data.size ();
+
+       body.append (reinterpret_cast <char const*> (
+           item->getTag ().begin ()), 32);
+
+       char frame[4];
+       frame[0] = (size >> 24) & 0xff;
+       frame[1] = (size >> 16) & 0xff;
+       frame[2] = (size >> 8) & 0xff;
+       frame[3] = size & 0xff;
+       body.append (frame, 4);
+
+       body.append (reinterpret_cast <char const*> (
+           data.data ()), size);
+    }
+
+    HTTPBinaryReply (body, headers, output);
+}
+
 } // ripple
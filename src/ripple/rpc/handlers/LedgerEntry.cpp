@@ -17,38 +17,29 @@
 */
 //==============================================================================
 
+#include <ripple/rpc/impl/Tuning.h>
 
 namespace ripple {
 
-// {
-//   ledger_hash : <ledger>
-//   ledger_index : <ledger_index>
-//   ...
-// }
-Json::Value doLedgerEntry (RPC::Context& context)
+// Resolve one entry specifier to a state tree index. On a bad
+// specifier, sets "error" in jvResult and returns zero.
+static uint256 lookupLedgerEntryIndex (
+    Json::Value const& params, Json::Value& jvResult, bool& bNodeBinary)
 {
-    Ledger::pointer lpLedger;
-    Json::Value jvResult = RPC::lookupLedger (
-        context.params, lpLedger, context.netOps);
-
-    if (!lpLedger)
-        return jvResult;
-
     uint256     uNodeIndex;
-    bool        bNodeBinary = false;
 
-    if (context.params.isMember ("index"))
+    if (params.isMember ("index"))
     {
         // XXX Needs to provide proof.
-        uNodeIndex.SetHex (context.params["index"].asString ());
+        uNodeIndex.SetHex (params["index"].asString ());
         bNodeBinary = true;
     }
-    else if (context.params.isMember ("account_root"))
+    else if (params.isMember ("account_root"))
     {
         RippleAddress   naAccount;
 
         if (!naAccount.setAccountID (
-                context.params["account_root"].asString ())
+                params["account_root"].asString ())
             || !naAccount.getAccountID ())
         {
             jvResult["error"]   = "malformedAddress";
@@ -59,37 +50,37 @@ Json::Value doLedgerEntry (RPC::Context& context)
                     = getAccountRootIndex (naAccount.getAccountID ());
         }
     }
-    else if (context.params.isMember ("directory"))
+    else if (params.isMember ("directory"))
     {
-        if (!context.params["directory"].isObject ())
+        if (!params["directory"].isObject ())
         {
-            uNodeIndex.SetHex (context.params["directory"].asString ());
+            uNodeIndex.SetHex (params["directory"].asString ());
         }
-        else if (context.params["directory"].isMember ("sub_index")
-                 && !context.params["directory"]["sub_index"].isIntegral ())
+        else if (params["directory"].isMember ("sub_index")
+                 && !params["directory"]["sub_index"].isIntegral ())
         {
             jvResult["error"]   = "malformedRequest";
         }
         else
         {
             std::uint64_t  uSubIndex
-                    = context.params["directory"].isMember ("sub_index")
-                    ? context.params["directory"]["sub_index"].asUInt () : 0;
+                    = params["directory"].isMember ("sub_index")
+                    ? params["directory"]["sub_index"].asUInt () : 0;
 
-            if (context.params["directory"].isMember ("dir_root"))
+            if (params["directory"].isMember ("dir_root"))
             {
                 uint256 uDirRoot;
 
-                uDirRoot.SetHex (context.params["dir_root"].asString ());
+                uDirRoot.SetHex (params["dir_root"].asString ());
 
                 uNodeIndex  = getDirNodeIndex (uDirRoot, uSubIndex);
             }
-            else if (context.params["directory"].isMember ("owner"))
+            else if (params["directory"].isMember ("owner"))
             {
                 RippleAddress   naOwnerID;
 
                 if (!naOwnerID.setAccountID (
-                        context.params["directory"]["owner"].asString ()))
+                        params["directory"]["owner"].asString ()))
                 {
                     jvResult["error"]   = "malformedAddress";
                 }
@@ -107,20 +98,20 @@ Json::Value doLedgerEntry (RPC::Context& context)
             }
         }
     }
-    else if (context.params.isMember ("generator"))
+    else if (params.isMember ("generator"))
     {
         RippleAddress   naGeneratorID;
 
-        if (!context.params["generator"].isObject ())
+        if (!params["generator"].isObject ())
         {
-            uNodeIndex.SetHex (context.params["generator"].asString ());
+            uNodeIndex.SetHex (params["generator"].asString ());
         }
-        else if (!context.params["generator"].isMember ("regular_seed"))
+        else if (!params["generator"].isMember ("regular_seed"))
         {
             jvResult["error"]   = "malformedRequest";
         }
         else if (!naGeneratorID.setSeedGeneric (
-            context.params["generator"]["regular_seed"].asString ()))
+            params["generator"]["regular_seed"].asString ()))
         {
             jvResult["error"]   = "malformedAddress";
         }
@@ -135,37 +126,37 @@ Json::Value doLedgerEntry (RPC::Context& context)
             uNodeIndex  = getGeneratorIndex (na0Public.getAccountID ());
         }
     }
-    else if (context.params.isMember ("offer"))
+    else if (params.isMember ("offer"))
     {
         RippleAddress   naAccountID;
 
-        if (!context.params["offer"].isObject ())
+        if (!params["offer"].isObject ())
         {
-            uNodeIndex.SetHex (context.params["offer"].asString ());
+            uNodeIndex.SetHex (params["offer"].asString ());
         }
-        else if (!context.params["offer"].isMember ("account")
-                 || !context.params["offer"].isMember ("seq")
-                 || !context.params["offer"]["seq"].isIntegral ())
+        else if (!params["offer"].isMember ("account")
+                 || !params["offer"].isMember ("seq")
+                 || !params["offer"]["seq"].isIntegral ())
         {
             jvResult["error"]   = "malformedRequest";
         }
         else if (!naAccountID.setAccountID (
-            context.params["offer"]["account"].asString ()))
+            params["offer"]["account"].asString ()))
         {
             jvResult["error"]   = "malformedAddress";
         }
         else
         {
             uNodeIndex  = getOfferIndex (naAccountID.getAccountID (),
-                context.params["offer"]["seq"].asUInt ());
+                params["offer"]["seq"].asUInt ());
         }
     }
-    else if (context.params.isMember ("ripple_state"))
+    else if (params.isMember ("ripple_state"))
     {
         RippleAddress   naA;
         RippleAddress   naB;
         Currency         uCurrency;
-        Json::Value     jvRippleState   = context.params["ripple_state"];
+        Json::Value     jvRippleState   = params["ripple_state"];
 
         if (!jvRippleState.isObject ()
             || !jvRippleState.isMember ("currency")
@@ -203,36 +194,134 @@ Json::Value doLedgerEntry (RPC::Context& context)
         jvResult["error"]   = "unknownOption";
     }
 
-    if (uNodeIndex.isNonZero ())
-    {
-        auto sleNode = context.netOps.getSLEi (lpLedger, uNodeIndex);
+    return uNodeIndex;
+}
 
-        if (context.params.isMember("binary"))
-            bNodeBinary = context.params["binary"].asBool();
+// Fetch one resolved entry from the ledger and render it, with its
+// optional proof path, into jvResult
+static void renderLedgerEntry (RPC::Context& context,
+    Ledger::pointer const& lpLedger, Json::Value const& params,
+    uint256 const& uNodeIndex, bool bNodeBinary, Json::Value& jvResult)
+{
+    auto sleNode = context.netOps.getSLEi (lpLedger, uNodeIndex);
 
-        if (!sleNode)
+    if (params.isMember ("binary"))
+        bNodeBinary = params["binary"].asBool ();
+
+    if (params.isMember ("proof")
+        && params["proof"].asBool ())
+    {
+        // The path of hashed nodes from the state tree root to the
+        // entry. Each node hashes to the hash its parent lists, the
+        // first hashes to the account state root in the ledger
+        // header, and a partial path proves the entry's absence.
+        // Verifiable offline with SHAMap::verifyProofPath.
+        try
         {
-            // Not found.
-            // XXX Should also provide proof.
-            jvResult["error"]       = "entryNotFound";
+            std::vector<Blob> proof;
+            lpLedger->peekAccountStateMap ()->getProofPath (
+                uNodeIndex, proof);
+
+            Json::Value& jvProof
+                    = (jvResult["proof"] = Json::arrayValue);
+
+            for (auto const& node : proof)
+                jvProof.append (strHex (node));
         }
-        else if (bNodeBinary)
+        catch (SHAMapMissingNode&)
         {
-            // XXX Should also provide proof.
-            Serializer s;
+            // This server doesn't have the full path, so no proof
+        }
+    }
 
-            sleNode->add (s);
+    if (!sleNode)
+    {
+        // Not found. A requested proof, above, shows the absence.
+        jvResult["error"]       = "entryNotFound";
+    }
+    else if (bNodeBinary)
+    {
+        Serializer s;
 
-            jvResult["node_binary"] = strHex (s.peekData ());
-            jvResult["index"]       = to_string (uNodeIndex);
+        sleNode->add (s);
+
+        jvResult["node_binary"] = strHex (s.peekData ());
+        jvResult["index"]       = to_string (uNodeIndex);
+    }
+    else
+    {
+        jvResult["node"]        = sleNode->getJson (0);
+        jvResult["index"]       = to_string (uNodeIndex);
+    }
+}
+
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   ...
+// }
+//
+// Or, to resolve many entries against one ledger snapshot:
+//
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   entries : [ { <specifier> }, ... ]
+// }
+Json::Value doLedgerEntry (RPC::Context& context)
+{
+    Ledger::pointer lpLedger;
+    Json::Value jvResult = RPC::lookupLedger (
+        context.params, lpLedger, context.netOps);
+
+    if (!lpLedger)
+        return jvResult;
+
+    if (context.params.isMember ("entries"))
+    {
+        // Batch form: each element is one specifier in the same shape
+        // the single form takes at top level, and the results come
+        // back in request order. The whole batch resolves against the
+        // one snapshot, so pollers get a consistent view for the cost
+        // of a single round trip.
+        Json::Value const& jvEntries = context.params["entries"];
+
+        if (!jvEntries.isArray ()
+            || jvEntries.size () > RPC::Tuning::maxLedgerEntriesPerRequest)
+        {
+            jvResult["error"]   = "malformedRequest";
+            return jvResult;
         }
-        else
+
+        Json::Value& jvNodes = (jvResult["entries"] = Json::arrayValue);
+
+        for (auto const& jvSpec : jvEntries)
         {
-            jvResult["node"]        = sleNode->getJson (0);
-            jvResult["index"]       = to_string (uNodeIndex);
+            Json::Value jvEntry (Json::objectValue);
+            bool        bNodeBinary = false;
+
+            uint256 const uNodeIndex = lookupLedgerEntryIndex (
+                jvSpec, jvEntry, bNodeBinary);
+
+            if (uNodeIndex.isNonZero ())
+                renderLedgerEntry (context, lpLedger, jvSpec,
+                    uNodeIndex, bNodeBinary, jvEntry);
+
+            jvNodes.append (jvEntry);
         }
+
+        return jvResult;
     }
 
+    bool        bNodeBinary = false;
+
+    uint256 const uNodeIndex = lookupLedgerEntryIndex (
+        context.params, jvResult, bNodeBinary);
+
+    if (uNodeIndex.isNonZero ())
+        renderLedgerEntry (context, lpLedger, context.params,
+            uNodeIndex, bNodeBinary, jvResult);
+
     return jvResult;
 }
 
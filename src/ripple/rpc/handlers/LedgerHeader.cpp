@@ -27,6 +27,29 @@ namespace ripple {
 // }
 Json::Value doLedgerHeader (RPC::Context& context)
 {
+    // Answer by-hash requests from the compact header cache when
+    // possible, avoiding SQLite and full-ledger construction
+    if (context.params.isMember (jss::ledger_hash))
+    {
+        uint256 ledgerHash;
+
+        if (ledgerHash.SetHex (context.params[jss::ledger_hash].asString ()))
+        {
+            auto compact = getApp().getLedgerMaster ().getCompactLedger (
+                ledgerHash);
+
+            if (compact)
+            {
+                Json::Value jvResult (Json::objectValue);
+                jvResult["ledger_data"] = strHex (compact->header);
+
+                Ledger header (compact->header, false);
+                addJson (jvResult, {header, 0});
+                return jvResult;
+            }
+        }
+    }
+
     Ledger::pointer lpLedger;
     Json::Value jvResult = RPC::lookupLedger (
         context.params, lpLedger, context.netOps);
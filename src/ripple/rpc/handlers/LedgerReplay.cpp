@@ -0,0 +1,343 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/LatencyProbes.h>
+
+namespace ripple {
+
+// {
+//   ledger_hash : <ledger> | ledger_index : <ledger_index>
+// }
+//
+// Replays a validated ledger's transaction set against its parent,
+// timing every stage, to answer "why was this ledger slow to close?"
+// after the fact. Returns per-transaction signature check and apply
+// times, stage totals (deserialization, signature checks, application,
+// SHAMap flush) and the latency probe deltas accumulated during the
+// replay, which break out path engine and flush walk time.
+Json::Value doLedgerReplay (RPC::Context& context)
+{
+    using replay_clock = std::chrono::steady_clock;
+
+    auto const hasHash = context.params.isMember (jss::ledger_hash);
+    auto const hasIndex = context.params.isMember (jss::ledger_index);
+
+    if (hasHash == hasIndex)
+    {
+        return RPC::make_param_error(
+            "Exactly one of ledger_hash and ledger_index can be set.");
+    }
+
+    auto& ledgerMaster = getApp ().getLedgerMaster ();
+    Ledger::pointer target;
+
+    if (hasHash)
+    {
+        LedgerHash ledgerHash;
+        auto const& jsonHash = context.params[jss::ledger_hash];
+
+        if (!jsonHash.isString () || !ledgerHash.SetHex (jsonHash.asString ()))
+            return RPC::invalid_field_message ("ledger_hash");
+
+        target = ledgerMaster.getLedgerByHash (ledgerHash);
+
+        if (!target)
+        {
+            // Try to get the desired ledger
+            Json::Value jvResult = getApp ().getInboundLedgers ().findCreate (
+                ledgerHash, 0, InboundLedger::fcGENERIC)->getJson (0);
+            jvResult[jss::error] = "ledgerNotFound";
+            return jvResult;
+        }
+    }
+    else
+    {
+        auto const& jsonIndex = context.params[jss::ledger_index];
+
+        if (!jsonIndex.isNumeric ())
+            return RPC::invalid_field_message ("ledger_index");
+
+        target = ledgerMaster.getLedgerBySeq (jsonIndex.asUInt ());
+
+        if (!target)
+            return rpcError (rpcLGR_NOT_FOUND);
+    }
+
+    Ledger::pointer parent = ledgerMaster.getLedgerByHash (
+        target->getParentHash ());
+
+    if (!parent)
+    {
+        // Try to get the parent the replay must run against
+        Json::Value jvResult = getApp ().getInboundLedgers ().findCreate (
+            target->getParentHash (), target->getLedgerSeq () - 1,
+            InboundLedger::fcGENERIC)->getJson (0);
+        jvResult[jss::error] = "ledgerNotFound";
+        return jvResult;
+    }
+
+    struct TxTiming
+    {
+        uint256 hash;
+        std::string result;
+        std::uint64_t signUs = 0;
+        std::uint64_t applyUs = 0;
+        int retries = 0;
+    };
+
+    auto sinceUs = [](replay_clock::time_point t0)
+    {
+        return static_cast<std::uint64_t> (
+            std::chrono::duration_cast<std::chrono::microseconds> (
+                replay_clock::now () - t0).count ());
+    };
+
+    auto const probesBefore = LatencyProbes::getInstance ().getCounts ();
+    auto const startAll = replay_clock::now ();
+
+    // Deserialize the recorded transaction set. Validated ledger
+    // entries carry the transaction followed by its metadata.
+    std::vector<STTx::pointer> candidates;
+    std::vector<TxTiming> timings;
+    hash_map<uint256, std::size_t> timingIndex;
+
+    auto t0 = replay_clock::now ();
+
+    auto const txMap = target->peekTransactionMap ();
+    for (SHAMapItem::pointer item = txMap->peekFirstItem (); !!item;
+        item = txMap->peekNextItem (item->getTag ()))
+    {
+        try
+        {
+            SerializerIterator sit (item->peekSerializer ());
+            Serializer sTxn (sit.getVL ());
+            SerializerIterator tSit (sTxn);
+            candidates.push_back (std::make_shared<STTx> (tSit));
+
+            TxTiming timing;
+            timing.hash = item->getTag ();
+            timingIndex[item->getTag ()] = timings.size ();
+            timings.push_back (timing);
+        }
+        catch (...)
+        {
+            WriteLog (lsWARNING, RPCHandler)
+                << "ledger_replay: undeserializable transaction "
+                << item->getTag ();
+        }
+    }
+
+    std::uint64_t const deserializeUs = sinceUs (t0);
+
+    // Check every signature, timed per transaction. Application below
+    // then skips the check, so its numbers are pure state mutation,
+    // the way a synced server experiences a close.
+    std::uint64_t signatureUs = 0;
+    int badSignatures = 0;
+
+    for (auto const& txn : candidates)
+    {
+        auto& timing = timings[timingIndex[txn->getTransactionID ()]];
+
+        t0 = replay_clock::now ();
+        bool const sigGood = txn->checkSign ();
+        timing.signUs = sinceUs (t0);
+        signatureUs += timing.signUs;
+
+        if (!sigGood)
+            ++badSignatures;
+    }
+
+    // Apply in the same order and with the same retry rules the close
+    // used, against a scratch ledger built on the parent.
+    Ledger::pointer replay = std::make_shared<Ledger> (false, *parent);
+    TransactionEngine engine (replay);
+
+    enum { replaySuccess, replayFail, replayRetry };
+
+    auto apply = [&](STTx::ref txn, bool retryAssured) -> int
+    {
+        auto& timing = timings[timingIndex[txn->getTransactionID ()]];
+
+        TransactionEngineParams parms = tapNO_CHECK_SIGN;
+
+        if (retryAssured)
+            parms = static_cast<TransactionEngineParams> (parms | tapRETRY);
+
+        bool didApply = false;
+        TER result = tefEXCEPTION;
+
+        auto const tStart = replay_clock::now ();
+
+        try
+        {
+            result = engine.applyTransaction (*txn, parms, didApply);
+        }
+        catch (...)
+        {
+            WriteLog (lsWARNING, RPCHandler)
+                << "ledger_replay: transaction throws "
+                << txn->getTransactionID ();
+        }
+
+        timing.applyUs += sinceUs (tStart);
+        timing.result = transToken (result);
+
+        if (didApply)
+            return replaySuccess;
+
+        if (isTefFailure (result) || isTemMalformed (result) ||
+            isTelLocal (result))
+            return replayFail;
+
+        ++timing.retries;
+        return replayRetry;
+    };
+
+    std::uint64_t applyUs = 0;
+    t0 = replay_clock::now ();
+
+    CanonicalTXSet retriableTransactions (txMap->getHash ());
+
+    for (auto const& txn : candidates)
+    {
+        if (apply (txn, true) == replayRetry)
+            retriableTransactions.push_back (txn);
+    }
+
+    bool certainRetry = true;
+
+    for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
+    {
+        int changes = 0;
+        auto it = retriableTransactions.begin ();
+
+        while (it != retriableTransactions.end ())
+        {
+            switch (apply (it->second, certainRetry))
+            {
+            case replaySuccess:
+                it = retriableTransactions.erase (it);
+                ++changes;
+                break;
+
+            case replayFail:
+                it = retriableTransactions.erase (it);
+                break;
+
+            case replayRetry:
+                ++it;
+            }
+        }
+
+        if (!changes && !certainRetry)
+            break;
+
+        if ((!changes) || (pass >= LEDGER_RETRY_PASSES))
+            certainRetry = false;
+    }
+
+    applyUs = sinceUs (t0);
+
+    replay->updateSkipList ();
+    replay->setClosed ();
+
+    bool const stateMatches =
+        replay->peekAccountStateMap ()->getHash () == target->getAccountHash ();
+
+    // The flush walk, exactly as the close runs it. When the replayed
+    // state matches the recorded ledger this rewrites nodes the store
+    // already has.
+    t0 = replay_clock::now ();
+
+    int const flushedState = replay->peekAccountStateMap ()->flushDirty (
+        hotACCOUNT_NODE, target->getLedgerSeq ());
+    int const flushedTxns = replay->peekTransactionMap ()->flushDirty (
+        hotTRANSACTION_NODE, target->getLedgerSeq ());
+
+    std::uint64_t const flushUs = sinceUs (t0);
+    std::uint64_t const totalUs = sinceUs (startAll);
+
+    auto const probesAfter = LatencyProbes::getInstance ().getCounts ();
+
+    //--------------------------------------------------------------------------
+
+    Json::Value jvResult (Json::objectValue);
+
+    jvResult[jss::ledger_index] = target->getLedgerSeq ();
+    jvResult[jss::ledger_hash] = to_string (target->getHash ());
+    jvResult["parent_hash"] = to_string (target->getParentHash ());
+    jvResult["txn_count"] = static_cast<Json::UInt> (candidates.size ());
+    jvResult["bad_signatures"] = badSignatures;
+    jvResult["state_hash_matches"] = stateMatches;
+    jvResult["flushed_nodes"] = flushedState + flushedTxns;
+
+    Json::Value& stages = (jvResult["stages"] = Json::objectValue);
+    stages["deserialize_us"] = static_cast<Json::UInt> (deserializeUs);
+    stages["signature_us"] = static_cast<Json::UInt> (signatureUs);
+    stages["apply_us"] = static_cast<Json::UInt> (applyUs);
+    stages["flush_us"] = static_cast<Json::UInt> (flushUs);
+    stages["total_us"] = static_cast<Json::UInt> (totalUs);
+
+    Json::Value& transactions =
+        (jvResult["transactions"] = Json::arrayValue);
+
+    for (auto const& timing : timings)
+    {
+        Json::Value& entry = transactions.append (Json::objectValue);
+        entry[jss::hash] = to_string (timing.hash);
+        entry["result"] = timing.result;
+        entry["sign_us"] = static_cast<Json::UInt> (timing.signUs);
+        entry["apply_us"] = static_cast<Json::UInt> (timing.applyUs);
+        if (timing.retries > 0)
+            entry["retries"] = timing.retries;
+    }
+
+    // Latency probe deltas attribute time inside the apply stage to
+    // instrumented hot paths: "ripplecalc" is the path engine's share
+    // and "shamap.flush" the flush walk's.
+    Json::Value& probes = (jvResult["probes"] = Json::objectValue);
+
+    for (auto const& after : probesAfter)
+    {
+        std::uint64_t count = after.count;
+        std::uint64_t total = after.totalMicroseconds;
+
+        for (auto const& before : probesBefore)
+        {
+            if (before.name == after.name)
+            {
+                count -= before.count;
+                total -= before.totalMicroseconds;
+                break;
+            }
+        }
+
+        if (count != 0)
+        {
+            Json::Value& probe = (probes[after.name] = Json::objectValue);
+            probe["count"] = static_cast<Json::UInt> (count);
+            probe["time_us"] = static_cast<Json::UInt> (total);
+        }
+    }
+
+    return jvResult;
+}
+
+} // ripple
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+namespace ripple {
+
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   destination_file : <path>
+// }
+//
+// Writes the ledger's header and complete state map to a snapshot
+// file that a new node can bulk-load with --import_snapshot. Walks
+// the whole state tree, so expect it to run for a while.
+Json::Value doLedgerSnapshot (RPC::Context& context)
+{
+    Ledger::pointer lpLedger;
+    Json::Value jvResult = RPC::lookupLedger (
+        context.params, lpLedger, context.netOps);
+
+    if (!lpLedger)
+        return jvResult;
+
+    if (!context.params.isMember ("destination_file"))
+        return RPC::missing_field_error ("destination_file");
+
+    if (!lpLedger->isClosed ())
+    {
+        // An open ledger's state map is still changing under us
+        jvResult["error"] = "ledgerNotClosed";
+        return jvResult;
+    }
+
+    std::string const path
+            = context.params["destination_file"].asString ();
+
+    if (!exportLedgerSnapshot (lpLedger, path,
+            deprecatedLogs ().journal ("LedgerSnapshot")))
+    {
+        jvResult["error"] = "snapshotFailed";
+        return jvResult;
+    }
+
+    jvResult["destination_file"] = path;
+    return jvResult;
+}
+
+} // ripple
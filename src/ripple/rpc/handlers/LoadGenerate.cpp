@@ -0,0 +1,435 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace ripple {
+
+namespace {
+
+// One synthetic account in the load population
+struct LoadAccount
+{
+    RippleAddress publicKey;
+    RippleAddress privateKey;
+    Account account;
+    std::uint32_t seq;
+};
+
+LoadAccount makeLoadAccount (RippleAddress const& seed)
+{
+    RippleAddress const generator =
+        RippleAddress::createGeneratorPublic (seed);
+
+    LoadAccount a;
+    a.publicKey = RippleAddress::createAccountPublic (generator, 0);
+    a.privateKey = RippleAddress::createAccountPrivate (generator, seed, 0);
+    a.account = a.publicKey.getAccountID ();
+    a.seq = 1;
+    return a;
+}
+
+std::uint64_t percentile (
+    std::vector<std::uint64_t> const& sorted, double p)
+{
+    if (sorted.empty ())
+        return 0;
+    return sorted[static_cast<std::size_t> (
+        p * (sorted.size () - 1) + 0.5)];
+}
+
+// Latencies arrive in microseconds; sorts in place
+Json::Value stageJson (std::vector<std::uint64_t>& v, double elapsed)
+{
+    Json::Value j (Json::objectValue);
+
+    std::sort (v.begin (), v.end ());
+
+    j["count"] = static_cast<Json::UInt> (v.size ());
+
+    if (elapsed > 0)
+        j["per_second"] = static_cast<Json::UInt> (v.size () / elapsed);
+
+    j["p50_us"] = static_cast<Json::UInt> (percentile (v, 0.50));
+    j["p90_us"] = static_cast<Json::UInt> (percentile (v, 0.90));
+    j["p99_us"] = static_cast<Json::UInt> (percentile (v, 0.99));
+
+    if (!v.empty ())
+        j["max_us"] = static_cast<Json::UInt> (v.back ());
+
+    return j;
+}
+
+int intParam (Json::Value const& params, char const* name,
+    int defaultValue, int minValue, int maxValue)
+{
+    if (!params.isMember (name))
+        return defaultValue;
+
+    return std::max (minValue,
+        std::min (maxValue, params[name].asInt ()));
+}
+
+}
+
+// Built-in load generator for standalone mode. Synthesizes a funded
+// account population, pushes signed payment/offer mixes straight into
+// NetworkOPs, closes ledgers on a batch schedule and reports per-stage
+// latency percentiles, so every build gets a reproducible transactions
+// per second number without an external driver in the loop.
+//
+// Parameters, all optional:
+//
+//   accounts      funded accounts to create           (default 500)
+//   transactions  load transactions to run            (default 5000)
+//   batch         transactions per ledger close       (default 500)
+//   offer_pct     share of transactions that are
+//                 offer creates instead of payments   (default 0)
+//
+Json::Value doLoadGenerate (RPC::Context& context)
+{
+    Json::Value jvResult;
+
+    if (!getConfig ().RUN_STANDALONE)
+    {
+        jvResult["error"] = "notStandAlone";
+        return jvResult;
+    }
+
+    int const accounts = intParam (
+        context.params, "accounts", 500, 1, 100000);
+    int const transactions = intParam (
+        context.params, "transactions", 5000, 1, 1000000);
+    int const batch = intParam (
+        context.params, "batch", 500, 1, 10000);
+    int const offerPct = intParam (
+        context.params, "offer_pct", 0, 0, 100);
+
+    // Generous enough to clear admission control however far the open
+    // ledger fee escalates during the run
+    std::uint64_t const fee = 1000;
+    std::uint64_t const fund =
+        10000 * SYSTEM_CURRENCY_PARTS;  // covers reserve plus load
+
+    using bench_clock = std::chrono::steady_clock;
+
+    auto const sinceUs = [] (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds> (
+            bench_clock::now () - t0).count ();
+    };
+
+    auto const sinceSeconds = [] (bench_clock::time_point t0)
+    {
+        return std::chrono::duration_cast<
+            std::chrono::duration<double>> (
+                bench_clock::now () - t0).count ();
+    };
+
+    // The root account from the genesis ledger funds everyone
+    LoadAccount root = makeLoadAccount (
+        RippleAddress::createSeedGeneric ("masterpassphrase"));
+
+    {
+        auto const state = getApp().getLedgerMaster ().
+            getCurrentLedger ()->getAccountState (root.publicKey);
+
+        if (!state)
+            return rpcError (rpcACT_NOT_FOUND);
+
+        root.seq = state->getSeq ();
+    }
+
+    std::vector<LoadAccount> population;
+    population.reserve (accounts);
+
+    for (int i = 0; i < accounts; ++i)
+    {
+        population.push_back (makeLoadAccount (
+            RippleAddress::createSeedGeneric (
+                "load-" + std::to_string (i))));
+    }
+
+    auto const makePayment = [&fee] (LoadAccount& from,
+        Account const& to, std::uint64_t drops)
+    {
+        auto tx = std::make_shared<STTx> (ttPAYMENT);
+        tx->setFieldAccount (sfAccount, from.account);
+        tx->setFieldU32 (sfSequence, from.seq++);
+        tx->setFieldAmount (sfFee, STAmount (fee));
+        tx->setFieldVL (sfSigningPubKey,
+            from.publicKey.getAccountPublic ());
+        tx->setFieldAccount (sfDestination, to);
+        tx->setFieldAmount (sfAmount, STAmount (drops));
+        return tx;
+    };
+
+    // An offer selling the account's own IOU; it books without
+    // crossing, exercising the order book paths
+    Currency loadCurrency;
+    to_currency (loadCurrency, "LGN");
+
+    auto const makeOffer = [&fee, &loadCurrency] (LoadAccount& from,
+        std::uint64_t drops)
+    {
+        auto tx = std::make_shared<STTx> (ttOFFER_CREATE);
+        tx->setFieldAccount (sfAccount, from.account);
+        tx->setFieldU32 (sfSequence, from.seq++);
+        tx->setFieldAmount (sfFee, STAmount (fee));
+        tx->setFieldVL (sfSigningPubKey,
+            from.publicKey.getAccountPublic ());
+        tx->setFieldAmount (sfTakerPays, STAmount (drops));
+        tx->setFieldAmount (sfTakerGets, STAmount (
+            Issue (loadCurrency, from.account), 1, 0));
+        return tx;
+    };
+
+    // Signs everything in txs in parallel, collecting per-transaction
+    // latencies; signing dominates generation and each signature is
+    // independent, so this mirrors the batch signing handler
+    auto const signAll = [] (std::vector<STTx::pointer>& txs,
+        std::vector<RippleAddress> const& keys,
+        std::vector<std::uint64_t>* latencies)
+    {
+        unsigned const threadCount = std::max (1u,
+            std::min (4u, std::thread::hardware_concurrency ()));
+
+        std::atomic<std::size_t> next (0);
+        std::vector<std::vector<std::uint64_t>> lanes (threadCount);
+
+        auto const worker = [&] (unsigned lane)
+        {
+            for (;;)
+            {
+                std::size_t const i = next++;
+
+                if (i >= txs.size ())
+                    break;
+
+                auto const t0 = bench_clock::now ();
+                txs[i]->sign (keys[i]);
+                lanes[lane].push_back (
+                    std::chrono::duration_cast<
+                        std::chrono::microseconds> (
+                            bench_clock::now () - t0).count ());
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount; ++t)
+            threads.emplace_back (worker, t);
+        worker (0);
+        for (auto& t : threads)
+            t.join ();
+
+        if (latencies)
+        {
+            for (auto& lane : lanes)
+                latencies->insert (latencies->end (),
+                    lane.begin (), lane.end ());
+        }
+    };
+
+    int ledgers = 0;
+
+    auto const closeLedger = [&context, &ledgers] ()
+    {
+        context.netOps.acceptLedger ();
+        ++ledgers;
+    };
+
+    //--------------------------------------------------------------------------
+    // Stage 1: fund the population from the root account
+
+    auto started = bench_clock::now ();
+
+    {
+        std::vector<STTx::pointer> txs;
+        std::vector<RippleAddress> keys;
+        txs.reserve (accounts);
+
+        for (auto& target : population)
+        {
+            txs.push_back (makePayment (root, target.account, fund));
+            keys.push_back (root.privateKey);
+        }
+
+        signAll (txs, keys, nullptr);
+
+        for (int i = 0; i < accounts; ++i)
+        {
+            context.netOps.processTransaction (
+                std::make_shared<Transaction> (txs[i], Validate::NO),
+                true, true, false);
+
+            if (((i + 1) % batch) == 0)
+                closeLedger ();
+        }
+
+        closeLedger ();
+    }
+
+    double const fundingSeconds = sinceSeconds (started);
+
+    //--------------------------------------------------------------------------
+    // Stage 2: generate and sign the load mix
+
+    std::vector<STTx::pointer> txs;
+    std::vector<RippleAddress> keys;
+    txs.reserve (transactions);
+    keys.reserve (transactions);
+
+    std::mt19937_64 rng (context.params.isMember ("seed") ?
+        context.params["seed"].asUInt () : 42);
+
+    for (int i = 0; i < transactions; ++i)
+    {
+        LoadAccount& from = population[rng () % accounts];
+
+        if (static_cast<int> (rng () % 100) < offerPct)
+        {
+            txs.push_back (makeOffer (from, 1000 + (rng () % 1000)));
+        }
+        else
+        {
+            LoadAccount const& to = population[rng () % accounts];
+            txs.push_back (makePayment (
+                from, to.account, 1000 + (rng () % 1000)));
+        }
+
+        keys.push_back (from.privateKey);
+    }
+
+    std::vector<std::uint64_t> signLat;
+    signLat.reserve (transactions);
+
+    started = bench_clock::now ();
+    signAll (txs, keys, &signLat);
+    double const signSeconds = sinceSeconds (started);
+
+    //--------------------------------------------------------------------------
+    // Stage 3: signature checks, marking each good signature in the
+    // hash router so the apply stage measures the engine alone
+
+    std::vector<std::uint64_t> checkLat (transactions);
+    int badSignatures = 0;
+
+    started = bench_clock::now ();
+
+    for (int i = 0; i < transactions; ++i)
+    {
+        auto const t0 = bench_clock::now ();
+        bool const good = txs[i]->checkSign ();
+        checkLat[i] = sinceUs (t0);
+
+        if (good)
+            getApp().getHashRouter ().setFlag (
+                txs[i]->getTransactionID (), SF_SIGGOOD);
+        else
+            ++badSignatures;
+    }
+
+    double const checkSeconds = sinceSeconds (started);
+
+    //--------------------------------------------------------------------------
+    // Stage 4: apply into the open ledger, closing on the batch
+    // schedule
+
+    std::vector<std::uint64_t> applyLat;
+    std::vector<std::uint64_t> closeLat;
+    applyLat.reserve (transactions);
+
+    int applied = 0;
+    int held = 0;
+    int other = 0;
+
+    started = bench_clock::now ();
+
+    for (int i = 0; i < transactions; ++i)
+    {
+        auto trans = std::make_shared<Transaction> (
+            txs[i], Validate::NO);
+
+        auto const t0 = bench_clock::now ();
+        trans = context.netOps.processTransaction (
+            trans, true, true, false);
+        applyLat.push_back (sinceUs (t0));
+
+        if (trans->getResult () == tesSUCCESS)
+            ++applied;
+        else if (isTerRetry (trans->getResult ()) ||
+                 trans->getResult () == temUNCERTAIN)
+            ++held;    // queued or held for a later ledger
+        else
+            ++other;
+
+        if (((i + 1) % batch) == 0)
+        {
+            auto const t1 = bench_clock::now ();
+            closeLedger ();
+            closeLat.push_back (sinceUs (t1));
+        }
+    }
+
+    // Drain whatever was queued or held for a later ledger
+    for (int i = 0; i < 2; ++i)
+    {
+        auto const t1 = bench_clock::now ();
+        closeLedger ();
+        closeLat.push_back (sinceUs (t1));
+    }
+
+    double const loadSeconds = sinceSeconds (started);
+
+    //--------------------------------------------------------------------------
+
+    jvResult["accounts"] = accounts;
+    jvResult["transactions"] = transactions;
+    jvResult["batch"] = batch;
+    jvResult["offer_pct"] = offerPct;
+    jvResult["ledgers"] = ledgers;
+    jvResult["funding_seconds"] = fundingSeconds;
+    jvResult["load_seconds"] = loadSeconds;
+
+    if (loadSeconds > 0)
+        jvResult["tps"] = static_cast<Json::UInt> (
+            applied / loadSeconds);
+
+    Json::Value& stages = (jvResult["stages"] =
+        Json::Value (Json::objectValue));
+    stages["sign"] = stageJson (signLat, signSeconds);
+    stages["sigcheck"] = stageJson (checkLat, checkSeconds);
+    stages["apply"] = stageJson (applyLat, loadSeconds);
+    stages["close"] = stageJson (closeLat, loadSeconds);
+
+    Json::Value& results = (jvResult["results"] =
+        Json::Value (Json::objectValue));
+    results["applied"] = applied;
+    results["held"] = held;
+    results["other"] = other;
+    results["bad_signatures"] = badSignatures;
+
+    return jvResult;
+}
+
+} // ripple
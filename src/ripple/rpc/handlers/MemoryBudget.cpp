@@ -17,30 +17,15 @@
 */
 //==============================================================================
 
-#ifndef RIPPLE_RPC_LEGACYPATHFIND_H_INCLUDED
-#define RIPPLE_RPC_LEGACYPATHFIND_H_INCLUDED
+#include <ripple/app/main/CacheBudget.h>
 
 namespace ripple {
-namespace RPC {
 
-class LegacyPathFind
+// The cache memory budget, the estimated per-cache usage and the
+// steering state. No parameters.
+Json::Value doMemoryBudget (RPC::Context& context)
 {
-public:
-    LegacyPathFind (bool isAdmin);
-    ~LegacyPathFind ();
+    return getApp ().getCacheBudget ().getJson ();
+}
 
-    bool isOk () const
-    {
-        return m_isOk;
-    }
-
-private:
-    static std::atomic <int> inProgress;
-
-    bool m_isOk;
-};
-
-} // RPC
 } // ripple
-
-#endif
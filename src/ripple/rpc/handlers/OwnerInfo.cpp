@@ -26,7 +26,7 @@ namespace ripple {
 // }
 Json::Value doOwnerInfo (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterSharedGuard lock (getApp ().netStateLock ());
     if (!context.params.isMember ("account") &&
         !context.params.isMember ("ident"))
     {
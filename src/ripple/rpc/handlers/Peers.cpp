@@ -27,7 +27,7 @@ Json::Value doPeers (RPC::Context& context)
     Json::Value jvResult (Json::objectValue);
 
     {
-        auto lock = getApp().masterLock();
+        MasterSharedGuard lock (getApp ().netStateLock ());
 
         jvResult["peers"] = getApp().overlay ().json ();
         getApp().getUNL().addClusterStatus(jvResult);
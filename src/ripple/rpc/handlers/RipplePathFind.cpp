@@ -18,311 +18,281 @@
 //==============================================================================
 
 #include <ripple/app/paths/AccountCurrencies.h>
-#include <ripple/app/paths/FindPaths.h>
 #include <ripple/core/LoadFeeTrack.h>
 #include <ripple/protocol/STParsedJSON.h>
-#include <ripple/rpc/impl/LegacyPathFind.h>
+#include <ripple/rpc/handlers/RipplePathFind.h>
 #include <ripple/server/Role.h>
 
 namespace ripple {
+namespace RPC {
 
-// This interface is deprecated.
-Json::Value doRipplePathFind (RPC::Context& context)
+RipplePathFindHandler::RipplePathFindHandler (Context& context)
+    : context_ (context)
 {
-    RPC::LegacyPathFind lpf (context.role == Role::ADMIN);
-    if (!lpf.isOk ())
-        return rpcError (rpcTOO_BUSY);
-
-    context.loadType = Resource::feeHighBurdenRPC;
+}
 
-    RippleAddress raSrc;
-    RippleAddress raDst;
-    STAmount saDstAmount;
-    Ledger::pointer lpLedger;
+Status RipplePathFindHandler::check ()
+{
+    auto const& params = context_.params;
 
-    Json::Value jvResult;
+    context_.loadType = Resource::feeHighBurdenRPC;
 
-    if (getConfig().RUN_STANDALONE ||
-        context.params.isMember(jss::ledger) ||
-        context.params.isMember(jss::ledger_index) ||
-        context.params.isMember(jss::ledger_hash))
+    if (getConfig ().RUN_STANDALONE ||
+        params.isMember (jss::ledger) ||
+        params.isMember (jss::ledger_index) ||
+        params.isMember (jss::ledger_hash))
     {
         // The caller specified a ledger
-        jvResult = RPC::lookupLedger (
-            context.params, lpLedger, context.netOps);
-        if (!lpLedger)
-            return jvResult;
+        if (auto s = RPC::lookupLedger (
+                params, ledger_, context_.netOps, result_))
+            return s;
     }
 
-    if (!context.params.isMember ("source_account"))
+    if (!params.isMember ("source_account"))
+        return rpcSRC_ACT_MISSING;
+
+    if (!params["source_account"].isString () ||
+        !raSrc_.setAccountID (params["source_account"].asString ()))
     {
-        jvResult = rpcError (rpcSRC_ACT_MISSING);
+        return rpcSRC_ACT_MALFORMED;
     }
-    else if (!context.params["source_account"].isString ()
-             || !raSrc.setAccountID (
-                 context.params["source_account"].asString ()))
+
+    if (!params.isMember ("destination_account"))
+        return rpcDST_ACT_MISSING;
+
+    if (!params["destination_account"].isString () ||
+        !raDst_.setAccountID (params["destination_account"].asString ()))
     {
-        jvResult = rpcError (rpcSRC_ACT_MALFORMED);
+        return rpcDST_ACT_MALFORMED;
     }
-    else if (!context.params.isMember ("destination_account"))
+
+    if (!params.isMember ("destination_amount") ||
+        !amountFromJsonNoThrow (saDstAmount_, params["destination_amount"]) ||
+        saDstAmount_ <= zero ||
+        (!isXRP (saDstAmount_.getCurrency ()) &&
+            (!saDstAmount_.getIssuer () ||
+                noAccount () == saDstAmount_.getIssuer ())))
     {
-        jvResult = rpcError (rpcDST_ACT_MISSING);
+        WriteLog (lsINFO, RPCHandler) << "Bad destination_amount.";
+        return rpcINVALID_PARAMS;
     }
-    else if (!context.params["destination_account"].isString ()
-             || !raDst.setAccountID (
-                 context.params["destination_account"].asString ()))
+
+    if (params.isMember ("source_currencies") &&
+        (!params["source_currencies"].isArray () ||
+            !params["source_currencies"].size ()))
     {
-        jvResult = rpcError (rpcDST_ACT_MALFORMED);
+        // Don't allow empty currencies.
+        WriteLog (lsINFO, RPCHandler) << "Bad source_currencies.";
+        return rpcINVALID_PARAMS;
     }
-    else if (
-        // Parse saDstAmount.
-        !context.params.isMember ("destination_amount")
-        || ! amountFromJsonNoThrow(saDstAmount, context.params["destination_amount"])
-        || saDstAmount <= zero
-        || (!isXRP(saDstAmount.getCurrency ())
-            && (!saDstAmount.getIssuer () ||
-                noAccount() == saDstAmount.getIssuer ())))
+
+    if (ledger_)
     {
-        WriteLog (lsINFO, RPCHandler) << "Bad destination_amount.";
-        jvResult    = rpcError (rpcINVALID_PARAMS);
+        // The caller specified a ledger
+        ledger_ = std::make_shared<Ledger> (std::ref (*ledger_), false);
+        cache_ = std::make_shared<RippleLineCache> (ledger_);
     }
-    else if (
-        // Checks on source_currencies.
-        context.params.isMember ("source_currencies")
-        && (!context.params["source_currencies"].isArray ()
-            || !context.params["source_currencies"].size ())
-        // Don't allow empty currencies.
-    )
+    else
     {
-        WriteLog (lsINFO, RPCHandler) << "Bad source_currencies.";
-        jvResult    = rpcError (rpcINVALID_PARAMS);
+        // The closed ledger is recent and any nodes made resident
+        // have the best chance to persist
+        ledger_ = context_.netOps.getClosedLedger ();
+        cache_ = getApp ().getPathRequests ().getLineCache (ledger_, false);
+    }
+
+    Json::Value jvSrcCurrencies;
+
+    if (params.isMember ("source_currencies"))
+    {
+        jvSrcCurrencies = params["source_currencies"];
     }
     else
     {
-        context.loadType = Resource::feeHighBurdenRPC;
-        RippleLineCache::pointer cache;
+        jvSrcCurrencies = Json::Value (Json::arrayValue);
 
-        if (lpLedger)
-        {
-            // The caller specified a ledger
-            lpLedger = std::make_shared<Ledger> (std::ref (*lpLedger), false);
-            cache = std::make_shared<RippleLineCache>(lpLedger);
-        }
-        else
+        for (auto const& uCurrency:
+                accountSourceCurrencies (raSrc_, cache_, true))
         {
-            // The closed ledger is recent and any nodes made resident
-            // have the best chance to persist
-            lpLedger = context.netOps.getClosedLedger();
-            cache = getApp().getPathRequests().getLineCache(lpLedger, false);
+            Json::Value jvCurrency (Json::objectValue);
+            jvCurrency["currency"] = to_string (uCurrency);
+            jvSrcCurrencies.append (jvCurrency);
         }
+    }
+
+    // Parse every source currency up front: once streaming has begun
+    // there is no way left to report a malformed entry as an error.
+    for (auto const& jvSource: jvSrcCurrencies)
+    {
+        Currency uSrcCurrencyID;
+        Account uSrcIssuerID;
 
-        Json::Value     jvSrcCurrencies;
+        if (!jvSource.isObject ())
+            return rpcINVALID_PARAMS;
 
-        if (context.params.isMember ("source_currencies"))
+        // Parse mandatory currency.
+        if (!jvSource.isMember ("currency") ||
+            !to_currency (uSrcCurrencyID, jvSource["currency"].asString ()))
         {
-            jvSrcCurrencies = context.params["source_currencies"];
+            WriteLog (lsINFO, RPCHandler) << "Bad currency.";
+            return rpcSRC_CUR_MALFORMED;
         }
-        else
+
+        if (uSrcCurrencyID.isNonZero ())
+            uSrcIssuerID = raSrc_.getAccountID ();
+
+        // Parse optional issuer.
+        if (jvSource.isMember ("issuer") &&
+            ((!jvSource["issuer"].isString () ||
+                !to_issuer (uSrcIssuerID, jvSource["issuer"].asString ())) ||
+             (uSrcIssuerID.isZero () != uSrcCurrencyID.isZero ()) ||
+             (noAccount () == uSrcIssuerID)))
         {
-            auto currencies = accountSourceCurrencies (raSrc, cache, true);
-            jvSrcCurrencies = Json::Value (Json::arrayValue);
-
-            for (auto const& uCurrency: currencies)
-            {
-                Json::Value jvCurrency (Json::objectValue);
-                jvCurrency["currency"] = to_string(uCurrency);
-                jvSrcCurrencies.append (jvCurrency);
-            }
+            WriteLog (lsINFO, RPCHandler) << "Bad issuer.";
+            return rpcSRC_ISR_MALFORMED;
         }
 
-        // Fill in currencies destination will accept
-        Json::Value jvDestCur (Json::arrayValue);
+        sourceIssues_.push_back (Issue (uSrcCurrencyID, uSrcIssuerID));
+    }
+
+    if (params.isMember ("paths"))
+    {
+        Json::Value pathSet = Json::objectValue;
+        pathSet["Paths"] = params["paths"];
+        STParsedJSONObject paths ("pathSet", pathSet);
 
-        // TODO(tom): this could be optimized the same way that
-        // PathRequest::doUpdate() is - if we don't obsolete this code first.
-        auto usDestCurrID = accountDestCurrencies (raDst, cache, true);
-        for (auto const& uCurrency: usDestCurrID)
-                jvDestCur.append (to_string (uCurrency));
+        if (paths.object.get () == nullptr)
+            return Status (rpcINVALID_PARAMS,
+                paths.error[jss::error_message].asString ());
 
-        jvResult["destination_currencies"] = jvDestCur;
-        jvResult["destination_account"] = raDst.humanAccountID ();
+        spsProvided_ = paths.object.get ()->getFieldPathSet (sfPaths);
+        WriteLog (lsTRACE, RPCHandler)
+            << "ripple_path_find: Paths: " << spsProvided_.getJson (0);
+    }
 
-        Json::Value jvArray (Json::arrayValue);
+    level_ = getConfig ().PATH_SEARCH_OLD;
+    if ((getConfig ().PATH_SEARCH_MAX > level_) &&
+        !getApp ().getFeeTrack ().isLoadedLocal ())
+    {
+        ++level_;
+    }
 
-        int level = getConfig().PATH_SEARCH_OLD;
-        if ((getConfig().PATH_SEARCH_MAX > level)
-            && !getApp().getFeeTrack().isLoadedLocal())
-        {
-            ++level;
-        }
+    if (params.isMember ("search_depth") &&
+        params["search_depth"].isIntegral ())
+    {
+        int rLev = params["search_depth"].asInt ();
+        if ((rLev < level_) || (context_.role == Role::ADMIN))
+            level_ = rLev;
+    }
 
-        if (context.params.isMember("search_depth")
-            && context.params["search_depth"].isIntegral())
-        {
-            int rLev = context.params["search_depth"].asInt ();
-            if ((rLev < level) || (context.role == Role::ADMIN))
-                level = rLev;
-        }
+    if (params.isMember ("max_alternatives") &&
+        params["max_alternatives"].isIntegral ())
+    {
+        maxAlternatives_ = params["max_alternatives"].asUInt ();
+    }
 
-        FindPaths fp (
-            cache,
-            raSrc.getAccountID(),
-            raDst.getAccountID(),
-            saDstAmount,
-            level,
-            4); // max paths
+    // Fill in currencies destination will accept
+    Json::Value jvDestCur (Json::arrayValue);
 
-        for (unsigned int i = 0; i != jvSrcCurrencies.size (); ++i)
-        {
-            Json::Value jvSource        = jvSrcCurrencies[i];
-
-            Currency uSrcCurrencyID;
-            Account uSrcIssuerID;
-
-            if (!jvSource.isObject ())
-                return rpcError (rpcINVALID_PARAMS);
-
-            // Parse mandatory currency.
-            if (!jvSource.isMember ("currency")
-                || !to_currency (
-                    uSrcCurrencyID, jvSource["currency"].asString ()))
-            {
-                WriteLog (lsINFO, RPCHandler) << "Bad currency.";
-
-                return rpcError (rpcSRC_CUR_MALFORMED);
-            }
-
-            if (uSrcCurrencyID.isNonZero ())
-                uSrcIssuerID = raSrc.getAccountID ();
-
-            // Parse optional issuer.
-            if (jvSource.isMember ("issuer") &&
-                ((!jvSource["issuer"].isString () ||
-                  !to_issuer (uSrcIssuerID, jvSource["issuer"].asString ())) ||
-                 (uSrcIssuerID.isZero () != uSrcCurrencyID.isZero ()) ||
-                 (noAccount() == uSrcIssuerID)))
-            {
-                WriteLog (lsINFO, RPCHandler) << "Bad issuer.";
-                return rpcError (rpcSRC_ISR_MALFORMED);
-            }
-
-            STPathSet spsComputed;
-            if (context.params.isMember("paths"))
-            {
-                Json::Value pathSet = Json::objectValue;
-                pathSet["Paths"] = context.params["paths"];
-                STParsedJSONObject paths ("pathSet", pathSet);
-                if (paths.object.get() == nullptr)
-                    return paths.error;
-                else
-                {
-                    spsComputed = paths.object.get()->getFieldPathSet (sfPaths);
-                    WriteLog (lsTRACE, RPCHandler) << "ripple_path_find: Paths: " << spsComputed.getJson (0);
-                }
-            }
-
-            STPath fullLiquidityPath;
-            auto valid = fp.findPathsForIssue (
-                {uSrcCurrencyID, uSrcIssuerID},
-                spsComputed,
-                fullLiquidityPath);
-            if (!valid)
-            {
-                WriteLog (lsWARNING, RPCHandler)
-                    << "ripple_path_find: No paths found.";
-            }
-            else
-            {
-                auto& issuer =
-                    isXRP (uSrcIssuerID) ?
-                        isXRP (uSrcCurrencyID) ? // Default to source account.
-                            xrpAccount() :
-                            Account (raSrc.getAccountID ())
-                        : uSrcIssuerID;            // Use specifed issuer.
-
-                STAmount saMaxAmount ({uSrcCurrencyID, issuer}, 1);
-                saMaxAmount.negate ();
-
-                LedgerEntrySet lesSandbox (lpLedger, tapNONE);
-
-                auto rc = path::RippleCalc::rippleCalculate (
-                    lesSandbox,
-                    saMaxAmount,            // --> Amount to send is unlimited
-                                            //     to get an estimate.
-                    saDstAmount,            // --> Amount to deliver.
-                    raDst.getAccountID (),  // --> Account to deliver to.
-                    raSrc.getAccountID (),  // --> Account sending from.
-                    spsComputed);           // --> Path set.
-
-                WriteLog (lsWARNING, RPCHandler)
-                    << "ripple_path_find:"
-                    << " saMaxAmount=" << saMaxAmount
-                    << " saDstAmount=" << saDstAmount
-                    << " saMaxAmountAct=" << rc.actualAmountIn
-                    << " saDstAmountAct=" << rc.actualAmountOut;
-
-                if (fullLiquidityPath.size() > 0 &&
-                    (rc.result() == terNO_LINE || rc.result() == tecPATH_PARTIAL))
-                {
-                    WriteLog (lsDEBUG, PathRequest)
-                        << "Trying with an extra path element";
-
-                    spsComputed.push_back (fullLiquidityPath);
-                    lesSandbox.clear ();
-                    rc = path::RippleCalc::rippleCalculate (
-                        lesSandbox,
-                        saMaxAmount,            // --> Amount to send is unlimited
-                        //     to get an estimate.
-                        saDstAmount,            // --> Amount to deliver.
-                        raDst.getAccountID (),  // --> Account to deliver to.
-                        raSrc.getAccountID (),  // --> Account sending from.
-                        spsComputed);         // --> Path set.
-                    WriteLog (lsDEBUG, PathRequest)
-                        << "Extra path element gives "
-                        << transHuman (rc.result ());
-                }
-
-                if (rc.result () == tesSUCCESS)
-                {
-                    Json::Value jvEntry (Json::objectValue);
-
-                    STPathSet   spsCanonical;
-
-                    // Reuse the expanded as it would need to be calcuated
-                    // anyway to produce the canonical.  (At least unless we
-                    // make a direct canonical.)
-
-                    jvEntry["source_amount"] = rc.actualAmountIn.getJson (0);
-                    jvEntry["paths_canonical"]  = Json::arrayValue;
-                    jvEntry["paths_computed"]   = spsComputed.getJson (0);
-
-                    jvArray.append (jvEntry);
-                }
-                else
-                {
-                    std::string strToken;
-                    std::string strHuman;
-
-                    transResultInfo (rc.result (), strToken, strHuman);
-
-                    WriteLog (lsDEBUG, RPCHandler)
-                        << "ripple_path_find: "
-                        << strToken << " "
-                        << strHuman << " "
-                        << spsComputed.getJson (0);
-                }
-            }
-        }
+    // TODO(tom): this could be optimized the same way that
+    // PathRequest::doUpdate() is - if we don't obsolete this code first.
+    for (auto const& uCurrency: accountDestCurrencies (raDst_, cache_, true))
+        jvDestCur.append (to_string (uCurrency));
+
+    result_[jss::destination_currencies] = jvDestCur;
+    result_[jss::destination_account] = raDst_.humanAccountID ();
 
-        // Each alternative differs by source currency.
-        jvResult["alternatives"] = jvArray;
+    return Status::OK;
+}
+
+bool RipplePathFindHandler::findAlternative (
+    FindPaths& fp, Issue const& issue, Json::Value& entry)
+{
+    STPathSet spsComputed = spsProvided_;
+    STPath fullLiquidityPath;
+
+    if (!fp.findPathsForIssue (issue, spsComputed, fullLiquidityPath))
+    {
+        WriteLog (lsWARNING, RPCHandler)
+            << "ripple_path_find: No paths found.";
+        return false;
+    }
+
+    auto const& issuer =
+        isXRP (issue.account) ?
+            isXRP (issue.currency) ? // Default to source account.
+                xrpAccount () :
+                Account (raSrc_.getAccountID ())
+            : issue.account;         // Use specifed issuer.
+
+    STAmount saMaxAmount ({issue.currency, issuer}, 1);
+    saMaxAmount.negate ();
+
+    LedgerEntrySet lesSandbox (ledger_, tapNONE);
+
+    auto rc = path::RippleCalc::rippleCalculate (
+        lesSandbox,
+        saMaxAmount,             // --> Amount to send is unlimited
+                                 //     to get an estimate.
+        saDstAmount_,            // --> Amount to deliver.
+        raDst_.getAccountID (),  // --> Account to deliver to.
+        raSrc_.getAccountID (),  // --> Account sending from.
+        spsComputed);            // --> Path set.
+
+    WriteLog (lsWARNING, RPCHandler)
+        << "ripple_path_find:"
+        << " saMaxAmount=" << saMaxAmount
+        << " saDstAmount=" << saDstAmount_
+        << " saMaxAmountAct=" << rc.actualAmountIn
+        << " saDstAmountAct=" << rc.actualAmountOut;
+
+    if (fullLiquidityPath.size () > 0 &&
+        (rc.result () == terNO_LINE || rc.result () == tecPATH_PARTIAL))
+    {
+        WriteLog (lsDEBUG, PathRequest)
+            << "Trying with an extra path element";
+
+        spsComputed.push_back (fullLiquidityPath);
+        lesSandbox.clear ();
+        rc = path::RippleCalc::rippleCalculate (
+            lesSandbox,
+            saMaxAmount,             // --> Amount to send is unlimited
+                                     //     to get an estimate.
+            saDstAmount_,            // --> Amount to deliver.
+            raDst_.getAccountID (),  // --> Account to deliver to.
+            raSrc_.getAccountID (),  // --> Account sending from.
+            spsComputed);            // --> Path set.
+        WriteLog (lsDEBUG, PathRequest)
+            << "Extra path element gives "
+            << transHuman (rc.result ());
     }
 
-    WriteLog (lsDEBUG, RPCHandler)
-            << boost::str (boost::format ("ripple_path_find< %s")
-                           % jvResult);
+    if (rc.result () != tesSUCCESS)
+    {
+        std::string strToken;
+        std::string strHuman;
+
+        transResultInfo (rc.result (), strToken, strHuman);
+
+        WriteLog (lsDEBUG, RPCHandler)
+            << "ripple_path_find: "
+            << strToken << " "
+            << strHuman << " "
+            << spsComputed.getJson (0);
+        return false;
+    }
+
+    entry = Json::Value (Json::objectValue);
+
+    // Reuse the expanded as it would need to be calcuated
+    // anyway to produce the canonical.  (At least unless we
+    // make a direct canonical.)
+
+    entry["source_amount"] = rc.actualAmountIn.getJson (0);
+    entry["paths_canonical"] = Json::arrayValue;
+    entry["paths_computed"] = spsComputed.getJson (0);
 
-    return jvResult;
+    return true;
 }
 
+} // RPC
 } // ripple
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLED_RIPPLE_RPC_HANDLERS_RIPPLEPATHFIND_H
+#define RIPPLED_RIPPLE_RPC_HANDLERS_RIPPLEPATHFIND_H
+
+#include <ripple/app/paths/FindPaths.h>
+#include <ripple/rpc/impl/JsonObject.h>
+#include <ripple/server/Role.h>
+
+namespace ripple {
+namespace RPC {
+
+// ripple_path_find
+// {
+//    source_account: <account>,
+//    destination_account: <account>,
+//    destination_amount: <amount>,
+//    source_currencies: [{currency: ..., issuer: ...}, ...],  // optional
+//    paths: <path set>,          // optional
+//    search_depth: <number>,     // optional
+//    max_alternatives: <number>  // optional, stop after this many
+// }
+//
+// Each alternative covers one source currency, and the search for one
+// alternative is expensive.  The streaming object form writes every
+// alternative as soon as the path engine confirms it and yields, so a
+// client sees its first quote after one search instead of waiting for
+// every source currency to finish.
+
+class RipplePathFindHandler {
+public:
+    explicit RipplePathFindHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static const char* const name()
+    {
+        return "ripple_path_find";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NEEDS_CURRENT_LEDGER;
+    }
+
+private:
+    // Search one source currency; fills entry and returns true if a
+    // viable alternative was found.
+    bool findAlternative (FindPaths&, Issue const&, Json::Value& entry);
+
+    Context& context_;
+    RippleAddress raSrc_;
+    RippleAddress raDst_;
+    STAmount saDstAmount_;
+    Ledger::pointer ledger_;
+    RippleLineCache::pointer cache_;
+    std::vector <Issue> sourceIssues_;
+    STPathSet spsProvided_;
+    Json::Value result_;
+    int level_ = 0;
+    unsigned int maxAlternatives_ = 0;  // zero means no limit
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void RipplePathFindHandler::writeResult (Object& value)
+{
+    RPC::copyFrom (value, result_);
+
+    FindPaths fp (
+        cache_,
+        raSrc_.getAccountID (),
+        raDst_.getAccountID (),
+        saDstAmount_,
+        level_,
+        4); // max paths
+
+    unsigned int found = 0;
+    auto&& alternatives = RPC::addArray (value, jss::alternatives);
+
+    // Each alternative differs by source currency.
+    for (auto const& issue: sourceIssues_)
+    {
+        if (maxAlternatives_ && found >= maxAlternatives_)
+            break;
+
+        Json::Value entry;
+        if (!findAlternative (fp, issue, entry))
+            continue;
+
+        alternatives.append (entry);
+        ++found;
+
+        // Flush the finished alternative to the client before starting
+        // the search for the next source currency.
+        if (context_.yield)
+            context_.yield ();
+    }
+}
+
+} // RPC
+} // ripple
+
+#endif
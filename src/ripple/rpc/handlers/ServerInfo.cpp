@@ -21,9 +21,11 @@
 
 namespace ripple {
 
+// No master lock: the info payload is served from a prebuilt snapshot
+// maintained by NetworkOPs, so monitoring can poll this continuously
+// without perturbing the server.
 Json::Value doServerInfo (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
     Json::Value ret (Json::objectValue);
 
     ret["info"] = context.netOps.getServerInfo (
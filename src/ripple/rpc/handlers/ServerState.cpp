@@ -21,9 +21,10 @@
 
 namespace ripple {
 
+// No master lock: like server_info, the payload comes from the
+// prebuilt snapshot maintained by NetworkOPs.
 Json::Value doServerState (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
     Json::Value ret (Json::objectValue);
 
     ret["state"] = context.netOps.getServerInfo (
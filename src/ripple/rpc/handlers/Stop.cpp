@@ -22,7 +22,7 @@ namespace ripple {
 
 Json::Value doStop (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
     getApp().signalStop ();
 
     return RPC::makeObjectValue (systemName () + " server stopping");
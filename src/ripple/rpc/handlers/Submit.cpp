@@ -66,7 +66,17 @@ Json::Value doSubmit (RPC::Context& context)
 
     try
     {
-        tpTrans     = std::make_shared<Transaction> (stpTrans, Validate::YES);
+        // Resubmissions of the same blob are common. If this exact
+        // transaction already passed a signature check, skip the
+        // second ECDSA verification but keep the local checks.
+        bool const sigVerified = (getApp().getHashRouter ().getFlags (
+            stpTrans->getTransactionID ()) & SF_SIGGOOD) != 0;
+
+        tpTrans = std::make_shared<Transaction> (stpTrans,
+            sigVerified ? Validate::NO : Validate::YES);
+
+        if (sigVerified && !passesLocalChecks (*stpTrans))
+            tpTrans->setStatus (INVALID);
     }
     catch (std::exception& e)
     {
@@ -104,7 +114,7 @@ Json::Value doSubmit (RPC::Context& context)
     {
         jvResult[jss::tx_json] = tpTrans->getJson (0);
         jvResult[jss::tx_blob] = strHex (
-            tpTrans->getSTransaction ()->getSerializer ().peekData ());
+            tpTrans->getSTransaction ()->getSerialized ());
 
         if (temUNCERTAIN != tpTrans->getResult ())
         {
@@ -25,7 +25,7 @@ namespace ripple {
 
 Json::Value doSubscribe (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
 
     // FIXME: This needs to release the master lock immediately
     // Subscriptions need to be protected by their own lock
@@ -95,6 +95,73 @@ Json::Value doSubscribe (RPC::Context& context)
         ispSub  = context.infoSub;
     }
 
+    // Deliver transaction stream events as canonical serialized blobs
+    // in a compact binary envelope instead of JSON. Only transports
+    // with binary frames honor this; others keep sending JSON.
+    if (context.params.isMember ("binary"))
+        ispSub->setBinaryMode (context.params["binary"].asBool ());
+
+    // Restrict the transaction streams to matching transactions. The
+    // filter is evaluated server side before serialization, so
+    // subscribers that want one transaction type or a few accounts do
+    // not cost a rendering and a send per uninteresting transaction.
+    // Criteria: "types", an array of transaction type names
+    // ("OfferCreate", "Payment", ...), and "accounts", an array of
+    // accounts matched against each transaction's affected set. Pass
+    // null to clear an earlier filter.
+    if (context.params.isMember ("transactions_filter"))
+    {
+        Json::Value const& jvFilter = context.params["transactions_filter"];
+
+        if (jvFilter.isNull ())
+        {
+            ispSub->setTxFilter (nullptr);
+        }
+        else if (!jvFilter.isObject ())
+        {
+            return rpcError (rpcINVALID_PARAMS);
+        }
+        else
+        {
+            auto filter = std::make_shared <InfoSub::TxFilter> ();
+
+            if (jvFilter.isMember ("types"))
+            {
+                if (!jvFilter["types"].isArray ())
+                    return rpcError (rpcINVALID_PARAMS);
+
+                for (auto const& jvType : jvFilter["types"])
+                {
+                    auto const item = jvType.isString ()
+                        ? TxFormats::getInstance ().findByName (
+                            jvType.asString ())
+                        : nullptr;
+
+                    if (!item)
+                        return rpcError (rpcINVALID_PARAMS);
+
+                    filter->types.insert (item->getType ());
+                }
+            }
+
+            if (jvFilter.isMember ("accounts"))
+            {
+                if (!jvFilter["accounts"].isArray ())
+                    return rpcError (rpcINVALID_PARAMS);
+
+                auto ids = RPC::parseAccountIds (jvFilter["accounts"]);
+
+                if (ids.empty ())
+                    return rpcError (rpcINVALID_PARAMS);
+
+                for (auto const& id : ids)
+                    filter->accounts.insert (id.getAccountID ());
+            }
+
+            ispSub->setTxFilter (filter);
+        }
+    }
+
     if (!context.params.isMember ("streams"))
     {
     }
@@ -314,7 +381,7 @@ Json::Value doSubscribe (RPC::Context& context)
                         context.netOps.getBookPage (
                             context.role == Role::ADMIN,
                             lpLedger, book, raTakerID.getAccountID (), false, 0,
-                            jvMarker, jvBids);
+                            jvMarker, jvBids, context.yield);
 
                         if (jvBids.isMember (jss::offers))
                             jvResult[jss::bids] = jvBids[jss::offers];
@@ -322,7 +389,7 @@ Json::Value doSubscribe (RPC::Context& context)
                         context.netOps.getBookPage (
                             context.role == Role::ADMIN,
                             lpLedger, book, raTakerID.getAccountID (),
-                            false, 0, jvMarker, jvAsks);
+                            false, 0, jvMarker, jvAsks, context.yield);
 
                         if (jvAsks.isMember (jss::offers))
                             jvResult[jss::asks] = jvAsks[jss::offers];
@@ -332,7 +399,7 @@ Json::Value doSubscribe (RPC::Context& context)
                         context.netOps.getBookPage (
                             context.role == Role::ADMIN,
                             lpLedger, book, raTakerID.getAccountID (), false, 0,
-                            jvMarker, jvResult);
+                            jvMarker, jvResult, context.yield);
                     }
                 }
             }
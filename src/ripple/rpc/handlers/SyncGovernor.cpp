@@ -17,51 +17,29 @@
 */
 //==============================================================================
 
-#include <ripple/rpc/impl/Tuning.h>
-#include <ripple/rpc/impl/LegacyPathFind.h>
+#include <ripple/core/SyncGovernor.h>
 
 namespace ripple {
-namespace RPC {
 
-LegacyPathFind::LegacyPathFind (bool isAdmin) : m_isOk (false)
+// Report or adjust the background sync budgets. With no parameters,
+// returns the current budgets and observed rates. Optional parameters:
+//   express: true/false  lift or restore the budgets for a fast sync
+//   fetch_limit: n       MB/s of peer ledger data, 0 for unlimited
+//   write_limit: n       node store writes per second, 0 for unlimited
+Json::Value doSyncGovernor (RPC::Context& context)
 {
-    if (isAdmin)
-    {
-        ++inProgress;
-        m_isOk = true;
-        return;
-    }
+    auto const& params = context.params;
 
-    auto& app = getApp();
-    auto const& jobCount = app.getJobQueue ().getJobCountGE (jtCLIENT);
-    if (jobCount > Tuning::maxPathfindJobCount || app.getFeeTrack().isLoadedLocal ())
-        return;
+    if (params.isMember ("express"))
+        SyncGovernor::setExpress (params["express"].asBool ());
 
-    while (true)
-    {
-        int prevVal = inProgress.load();
-        if (prevVal >= Tuning::maxPathfindsInProgress)
-            return;
+    if (params.isMember ("fetch_limit"))
+        SyncGovernor::setFetchLimit (params["fetch_limit"].asInt ());
 
-        if (inProgress.compare_exchange_strong (
-                prevVal,
-                prevVal + 1,
-                std::memory_order_release,
-                std::memory_order_relaxed))
-        {
-            m_isOk = true;
-            return;
-        }
-    }
-}
+    if (params.isMember ("write_limit"))
+        SyncGovernor::setWriteLimit (params["write_limit"].asInt ());
 
-LegacyPathFind::~LegacyPathFind ()
-{
-    if (m_isOk)
-        --inProgress;
+    return SyncGovernor::getInfo ();
 }
 
-std::atomic <int> LegacyPathFind::inProgress (0);
-
-} // RPC
 } // ripple
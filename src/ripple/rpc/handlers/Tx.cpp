@@ -45,6 +45,35 @@ Json::Value doTx (RPC::Context& context)
     if (txn->getLedger () == 0)
         return ret;
 
+    // Try the packed metadata index first; a hit answers without
+    // touching the ledger the transaction was in
+    {
+        std::uint32_t seq;
+        Blob rawMeta;
+
+        if (getApp().getTxMetaIndex ().getMeta (txn->getID (), seq, rawMeta)
+            && (seq == txn->getLedger ()))
+        {
+            if (binary)
+            {
+                ret[jss::meta] = strHex (rawMeta);
+            }
+            else
+            {
+                auto txMeta = std::make_shared<TransactionMetaSet> (
+                    txn->getID (), seq, rawMeta);
+                auto meta = txMeta->getJson (0);
+                addPaymentDeliveredAmount (meta, context, txn, txMeta);
+                ret[jss::meta] = meta;
+            }
+
+            // Only validated ledgers are indexed
+            ret[jss::validated] =
+                seq <= getApp().getLedgerMaster ().getValidLedgerIndex ();
+            return ret;
+        }
+    }
+
     if (auto lgr = context.netOps.getLedgerBySeq (txn->getLedger ()))
     {
         bool okay = false;
@@ -47,8 +47,8 @@ Json::Value doTxHistory (RPC::Context& context)
                     % startIndex);
 
     {
-        auto db = getApp().getTxnDB ().getDB ();
-        auto sl (getApp().getTxnDB ().lock ());
+        DatabaseCon::ScopedReader reader (getApp().getTxnDB ());
+        auto db = reader.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -26,7 +26,7 @@ namespace ripple {
 // }
 Json::Value doUnlAdd (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
 
     std::string strNode = context.params.isMember ("node")
             ? context.params["node"].asString () : "";
@@ -25,7 +25,7 @@ namespace ripple {
 // }
 Json::Value doUnlDelete (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
 
     if (!context.params.isMember ("node"))
         return rpcError (rpcINVALID_PARAMS);
@@ -22,7 +22,7 @@ namespace ripple {
 
 Json::Value doUnlList (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterSharedGuard lock (getApp ().netStateLock ());
     Json::Value obj (Json::objectValue);
 
     obj["unl"] = getApp().getUNL ().getUnlJson ();
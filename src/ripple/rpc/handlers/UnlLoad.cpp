@@ -23,7 +23,7 @@ namespace ripple {
 // Populate the UNL from a local validators.txt file.
 Json::Value doUnlLoad (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
 
     if (getConfig ().VALIDATORS_FILE.empty ()
         || !getApp().getUNL ().nodeLoad (getConfig ().VALIDATORS_FILE))
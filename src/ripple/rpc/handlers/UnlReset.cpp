@@ -22,7 +22,7 @@ namespace ripple {
 
 Json::Value doUnlReset (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
     getApp().getUNL ().nodeReset ();
 
     return RPC::makeObjectValue ("removing nodes");
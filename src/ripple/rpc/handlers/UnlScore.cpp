@@ -23,7 +23,7 @@ namespace ripple {
 // unl_score
 Json::Value doUnlScore (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
     getApp().getUNL ().nodeScore ();
 
     return RPC::makeObjectValue ("scoring requested");
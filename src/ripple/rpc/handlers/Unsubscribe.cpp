@@ -25,7 +25,7 @@ namespace ripple {
 // sane.
 Json::Value doUnsubscribe (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
 
     InfoSub::pointer ispSub;
     Json::Value jvResult (Json::objectValue);
@@ -25,7 +25,7 @@ namespace ripple {
 // }
 Json::Value doValidationSeed (RPC::Context& context)
 {
-    auto lock = getApp().masterLock();
+    MasterLockGuard lock (getApp ().netStateLock ());
     Json::Value obj (Json::objectValue);
 
     if (!context.params.isMember ("secret"))
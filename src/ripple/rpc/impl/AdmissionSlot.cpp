@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/Tuning.h>
+#include <ripple/rpc/impl/AdmissionSlot.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace ripple {
+namespace RPC {
+
+namespace {
+
+// Per-command cost estimates, created on first use. Entries are never
+// removed, so references handed out stay valid for the life of the process.
+std::mutex estimateMutex;
+std::map <std::string, std::atomic <int>> estimates;
+
+std::atomic <int>& estimateFor (std::string const& command)
+{
+    std::lock_guard <std::mutex> lock (estimateMutex);
+    auto it = estimates.find (command);
+
+    if (it == estimates.end ())
+        it = estimates.emplace (std::piecewise_construct,
+            std::forward_as_tuple (command),
+            std::forward_as_tuple (Tuning::admissionDefaultCost)).first;
+
+    return it->second;
+}
+
+}
+
+AdmissionSlot::AdmissionSlot (std::string const& command, bool isAdmin)
+    : m_estimate (&estimateFor (command))
+    , m_start (std::chrono::steady_clock::now ())
+    , m_cost (m_estimate->load ())
+    , m_isOk (false)
+{
+    if (isAdmin)
+    {
+        // Administrative commands are never refused, but are still
+        // charged so the estimates they feed stay calibrated.
+        inProgressCost += m_cost;
+        m_isOk = true;
+        return;
+    }
+
+    while (true)
+    {
+        int prevVal = inProgressCost.load ();
+        if (prevVal + m_cost > Tuning::maxAdmissionCostInProgress)
+            return;
+
+        if (inProgressCost.compare_exchange_strong (
+                prevVal,
+                prevVal + m_cost,
+                std::memory_order_release,
+                std::memory_order_relaxed))
+        {
+            m_isOk = true;
+            return;
+        }
+    }
+}
+
+AdmissionSlot::~AdmissionSlot ()
+{
+    if (!m_isOk)
+        return;
+
+    inProgressCost -= m_cost;
+
+    int const elapsed = static_cast <int> (std::min <std::int64_t> (
+        std::chrono::duration_cast <std::chrono::microseconds> (
+            std::chrono::steady_clock::now () - m_start).count (),
+        Tuning::maxAdmissionCostInProgress));
+
+    // Quarter-weight smoothing, as LoadMonitor applies to job latencies
+    int const prevVal = m_estimate->load ();
+    m_estimate->store (prevVal - (prevVal / 4) + (elapsed / 4));
+}
+
+int AdmissionSlot::retryAfterMilliseconds ()
+{
+    // The outstanding work drains across the client job lanes in
+    // parallel, so half the estimate in flight is a fair wait.
+    return std::max (10, inProgressCost.load () / 2000);
+}
+
+std::atomic <int> AdmissionSlot::inProgressCost (0);
+
+} // RPC
+} // ripple
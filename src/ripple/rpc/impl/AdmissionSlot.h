@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_ADMISSIONSLOT_H_INCLUDED
+#define RIPPLE_RPC_ADMISSIONSLOT_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace ripple {
+namespace RPC {
+
+/** Cost-model admission control over the RPC handler table.
+
+    Every command keeps a running estimate of its execution time,
+    calibrated from measured runs with the same quarter-weight smoothing
+    LoadMonitor applies to job latencies. A non-administrative command is
+    admitted when charging its estimate against the outstanding work
+    leaves the budget unexceeded; otherwise the caller should refuse it
+    with rpcTOO_BUSY and a retry hint. Administrative commands are always
+    admitted, but are charged and measured so their estimates stay
+    calibrated.
+
+    This replaces the LegacyPathFind throttle, which capped only the
+    number of concurrent pathfinds and let equally expensive commands
+    through unexamined.
+*/
+class AdmissionSlot
+{
+public:
+    /** Attempt to admit a command; check isOk() for the decision. */
+    AdmissionSlot (std::string const& command, bool isAdmin);
+
+    /** Release the charge and fold the measured time into the estimate. */
+    ~AdmissionSlot ();
+
+    bool isOk () const
+    {
+        return m_isOk;
+    }
+
+    /** The estimated cost charged for this command, in microseconds. */
+    int cost () const
+    {
+        return m_cost;
+    }
+
+    /** How long a refused client should wait before retrying. */
+    static int retryAfterMilliseconds ();
+
+private:
+    static std::atomic <int> inProgressCost;
+
+    std::atomic <int>* m_estimate;
+    std::chrono::steady_clock::time_point m_start;
+    int m_cost;
+    bool m_isOk;
+};
+
+} // RPC
+} // ripple
+
+#endif
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/AdmissionSlot.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <beast/unit_test/suite.h>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+namespace RPC {
+
+class AdmissionSlot_test : public beast::unit_test::suite
+{
+public:
+    void test_admitsWithinBudget ()
+    {
+        testcase ("admit");
+        AdmissionSlot slot ("admission_test_admit", false);
+        expect (slot.isOk (), "idle budget admits a user command");
+    }
+
+    void test_refusesOverBudget ()
+    {
+        testcase ("refuse");
+
+        // Each distinct unmeasured command is charged the default cost,
+        // so enough concurrent slots must exhaust the budget
+        std::vector <std::unique_ptr <AdmissionSlot>> held;
+        int admitted = 0;
+        int const limit = 2 + Tuning::maxAdmissionCostInProgress /
+            Tuning::admissionDefaultCost;
+
+        for (int i = 0; i < limit; ++i)
+        {
+            held.emplace_back (std::make_unique <AdmissionSlot> (
+                "admission_test_refuse_" + std::to_string (i), false));
+            if (held.back ()->isOk ())
+                ++admitted;
+        }
+
+        expect (admitted < limit, "full budget refuses a user command");
+
+        AdmissionSlot admin ("admission_test_admin", true);
+        expect (admin.isOk (), "full budget still admits an admin command");
+        expect (AdmissionSlot::retryAfterMilliseconds () > 0,
+            "refusal comes with a retry hint");
+
+        // Releasing the slots restores the budget
+        held.clear ();
+        AdmissionSlot slot ("admission_test_refuse_0", false);
+        expect (slot.isOk (), "drained budget admits again");
+    }
+
+    void run ()
+    {
+        test_admitsWithinBudget ();
+        test_refusesOverBudget ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AdmissionSlot, RPC, ripple);
+
+} // RPC
+} // ripple
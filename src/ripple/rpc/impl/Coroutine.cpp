@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/core/JobArena.h>
 #include <ripple/rpc/Coroutine.h>
 #include <ripple/rpc/impl/TestOutputSuite.h>
 
@@ -28,6 +29,12 @@ using CoroutinePull = boost::coroutines::coroutine <void>::pull_type;
 struct Coroutine::Impl : CoroutinePull
 {
     Impl (CoroutinePull&& p) : CoroutinePull (std::move(p)) {}
+
+    // Arena allocations made inside the coroutine must survive
+    // suspension, so the coroutine carries its own arena rather
+    // than borrowing the worker's, which is reset between the
+    // jobs that resume it.
+    JobArena arena;
 };
 
 Coroutine::Coroutine (YieldFunction const& yieldFunction)
@@ -52,6 +59,7 @@ Coroutine::operator bool() const
 
 void Coroutine::operator()() const
 {
+    JobArena::ScopedActive active (impl_->arena);
     (*impl_)();
 }
 
@@ -59,6 +59,7 @@ class HandlerTable {
 
         // This is where the new-style handlers are added.
         addHandler<LedgerHandler>();
+        addHandler<RipplePathFindHandler>();
     }
 
     const Handler* getHandler(std::string name) {
@@ -100,6 +101,7 @@ HandlerTable HANDLERS({
     {   "get_counts",           byRef (&doGetCounts),           Role::ADMIN,   NO_CONDITION     },
     {   "internal",             byRef (&doInternal),            Role::ADMIN,   NO_CONDITION     },
     {   "feature",              byRef (&doFeature),             Role::ADMIN,   NO_CONDITION     },
+    {   "fee",                  byRef (&doFee),                 Role::USER,    NO_CONDITION     },
     {   "fetch_info",           byRef (&doFetchInfo),           Role::ADMIN,   NO_CONDITION     },
     {   "ledger_accept",        byRef (&doLedgerAccept),        Role::ADMIN,   NEEDS_CURRENT_LEDGER  },
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),       Role::ADMIN,   NEEDS_NETWORK_CONNECTION  },
@@ -108,9 +110,13 @@ HandlerTable HANDLERS({
     {   "ledger_data",          byRef (&doLedgerData),          Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "ledger_entry",         byRef (&doLedgerEntry),         Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "ledger_header",        byRef (&doLedgerHeader),        Role::USER,  NEEDS_CURRENT_LEDGER  },
+    {   "ledger_replay",        byRef (&doLedgerReplay),        Role::ADMIN,   NO_CONDITION     },
     {   "ledger_request",       byRef (&doLedgerRequest),       Role::ADMIN,   NO_CONDITION     },
+    {   "ledger_snapshot",      byRef (&doLedgerSnapshot),      Role::ADMIN,   NO_CONDITION     },
+    {   "load_generate",        byRef (&doLoadGenerate),        Role::ADMIN,   NEEDS_CURRENT_LEDGER  },
     {   "log_level",            byRef (&doLogLevel),            Role::ADMIN,   NO_CONDITION     },
     {   "logrotate",            byRef (&doLogRotate),           Role::ADMIN,   NO_CONDITION     },
+    {   "memory_budget",        byRef (&doMemoryBudget),        Role::ADMIN,   NO_CONDITION     },
     {   "owner_info",           byRef (&doOwnerInfo),           Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "peers",                byRef (&doPeers),               Role::ADMIN,   NO_CONDITION     },
     {   "path_find",            byRef (&doPathFind),            Role::USER,  NEEDS_CURRENT_LEDGER  },
@@ -118,13 +124,14 @@ HandlerTable HANDLERS({
     {   "print",                byRef (&doPrint),               Role::ADMIN,   NO_CONDITION     },
 //      {   "profile",              byRef (&doProfile),             Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "random",               byRef (&doRandom),              Role::USER,  NO_CONDITION     },
-    {   "ripple_path_find",     byRef (&doRipplePathFind),      Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "sign",                 byRef (&doSign),                Role::USER,  NO_CONDITION     },
+    {   "sign_batch",           byRef (&doSignBatch),           Role::USER,  NO_CONDITION     },
     {   "submit",               byRef (&doSubmit),              Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "server_info",          byRef (&doServerInfo),          Role::USER,  NO_CONDITION     },
     {   "server_state",         byRef (&doServerState),         Role::USER,  NO_CONDITION     },
     {   "sms",                  byRef (&doSMS),                 Role::ADMIN,   NO_CONDITION     },
     {   "stop",                 byRef (&doStop),                Role::ADMIN,   NO_CONDITION     },
+    {   "sync_governor",        byRef (&doSyncGovernor),        Role::ADMIN,   NO_CONDITION     },
     {   "transaction_entry",    byRef (&doTransactionEntry),    Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "tx",                   byRef (&doTx),                  Role::USER,  NEEDS_NETWORK_CONNECTION  },
     {   "tx_history",           byRef (&doTxHistory),           Role::USER,  NO_CONDITION     },
@@ -277,6 +277,20 @@ Json::Value& addObject (Json::Value&, Json::StaticString const& key);
 /** Add a new subobject at a named key in a Json object. */
 Object addObject (Object&, Json::StaticString const& key);
 
+/** Append a new, empty subobject to a Json array and return it, so
+    callers build the element in place instead of building a local
+    and copying it in. */
+Json::Value& appendObject (Json::Value&);
+
+/** Append a new subobject to an Array. */
+Object appendObject (Array&);
+
+/** Append a new, empty subarray to a Json array and return it. */
+Json::Value& appendArray (Json::Value&);
+
+/** Append a new subarray to an Array. */
+Array appendArray (Array&);
+
 /** Copy all the keys and values from one object into another. */
 void copyFrom (Json::Value& to, Json::Value const& from);
 
@@ -383,6 +397,30 @@ Object addObject (Object& object, Json::StaticString const& key)
     return object.makeObject (std::string (key));
 }
 
+inline
+Json::Value& appendObject (Json::Value& json)
+{
+    return json.append (Json::objectValue);
+}
+
+inline
+Object appendObject (Array& array)
+{
+    return array.makeObject ();
+}
+
+inline
+Json::Value& appendArray (Json::Value& json)
+{
+    return json.append (Json::arrayValue);
+}
+
+inline
+Array appendArray (Array& array)
+{
+    return array.makeArray ();
+}
+
 } // RPC
 } // ripple
 
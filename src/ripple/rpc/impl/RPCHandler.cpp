@@ -25,8 +25,10 @@
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/rpc/Yield.h>
 #include <ripple/rpc/impl/Tuning.h>
+#include <ripple/rpc/impl/AdmissionSlot.h>
 #include <ripple/rpc/impl/Context.h>
 #include <ripple/rpc/impl/Handler.h>
+#include <ripple/rpc/impl/ResponseCache.h>
 #include <ripple/rpc/impl/WriteJson.h>
 
 #include <ripple/server/Role.h>
@@ -164,15 +166,69 @@ error_code_i fillHandler (Context& context,
     return rpcSUCCESS;
 }
 
+// The response cache holds Json::Value responses; the streaming
+// object path always misses and never stores.
+bool cacheLookup (std::string const& key, Json::Value& result)
+{
+    return ResponseCache::lookup (key, result);
+}
+
+template <class Object>
+bool cacheLookup (std::string const&, Object&)
+{
+    return false;
+}
+
+void cacheStore (std::string const& key, Json::Value const& result)
+{
+    ResponseCache::store (key, result);
+}
+
+template <class Object>
+void cacheStore (std::string const&, Object const&)
+{
+}
+
 template <class Object, class Method>
 Status callMethod (
     Context& context, Method method, std::string const& name, Object& result)
 {
+    // Serve designated idempotent commands from the response cache.
+    // A hit costs no admission charge and no job queue time.
+    std::string cacheKey;
+
+    if (ResponseCache::isCacheable (name))
+    {
+        if (auto ledger = getApp ().getLedgerMaster ().getValidatedLedger ())
+        {
+            cacheKey = ResponseCache::makeKey (name, context.params,
+                ledger->getHash ());
+
+            if (cacheLookup (cacheKey, result))
+                return Status ();
+        }
+    }
+
+    AdmissionSlot slot (name, context.role == Role::ADMIN);
+    if (!slot.isOk ())
+    {
+        WriteLog (lsDEBUG, RPCHandler)
+            << "Admission refused for command: " << name;
+        inject_error (rpcTOO_BUSY, result);
+        result[jss::retry_after] = AdmissionSlot::retryAfterMilliseconds ();
+        return rpcTOO_BUSY;
+    }
+
     try
     {
         auto v = getApp().getJobQueue().getLoadEventAP(
             jtGENERIC, "cmd:" + name);
-        return method (context, result);
+        auto status = method (context, result);
+
+        if (!status && !cacheKey.empty ())
+            cacheStore (cacheKey, result);
+
+        return status;
     }
     catch (std::exception& e)
     {
@@ -254,5 +310,37 @@ void executeRPC (
     }
 }
 
+/** Execute an RPC command, writing the results directly to an Output. */
+void executeRPC (
+    RPC::Context& context, Output const& output, YieldStrategy const&)
+{
+    boost::optional <Handler const&> handler;
+    if (auto error = fillHandler (context, handler))
+    {
+        WriterObject wo (output);
+        auto&& sub = addObject (*wo, jss::result);
+        inject_error (error, sub);
+    }
+    else if (auto method = handler->objectMethod_)
+    {
+        // The writer hands each complete segment to the output as it is
+        // produced, so no more than one element is in memory at a time.
+        WriterObject wo (output);
+        getResult (context, method, *wo, handler->name_);
+    }
+    else if (auto method = handler->valueMethod_)
+    {
+        auto object = Json::Value (Json::objectValue);
+        getResult (context, method, object, handler->name_);
+        writeJson (object, output);
+    }
+    else
+    {
+        // Can't ever get here.
+        assert (false);
+        throw RPC::JsonException ("RPC handler with no method");
+    }
+}
+
 } // RPC
 } // ripple
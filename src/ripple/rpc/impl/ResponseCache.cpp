@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/ResponseCache.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/JsonFields.h>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+namespace ripple {
+namespace RPC {
+
+namespace {
+
+using cache_clock = std::chrono::steady_clock;
+
+struct Entry
+{
+    Json::Value response;
+    cache_clock::time_point expires;
+};
+
+std::mutex cacheMutex;
+hash_map <std::string, Entry> cache;
+
+} // namespace
+
+bool ResponseCache::isCacheable (std::string const& command)
+{
+    // Read-only commands whose responses depend only on their
+    // parameters and ledger state. Commands that mutate state, draw
+    // on live counters, or stream may never appear here.
+    static char const* const commands[] =
+    {
+        "account_currencies",
+        "account_info",
+        "account_lines",
+        "account_offers",
+        "book_offers",
+        "ledger_closed",
+        "ledger_entry"
+    };
+
+    for (auto const name : commands)
+    {
+        if (command == name)
+            return true;
+    }
+
+    return false;
+}
+
+std::string ResponseCache::makeKey (std::string const& command,
+    Json::Value const& params, uint256 const& validatedLedger)
+{
+    // Object members serialize in sorted order, so the text is
+    // canonical for any arrival order of the fields.
+    Json::Value canonical = params;
+    canonical.removeMember (jss::id);
+
+    return command + '|' + to_string (validatedLedger) + '|' +
+        to_string (canonical);
+}
+
+bool ResponseCache::lookup (std::string const& key, Json::Value& result)
+{
+    std::lock_guard <std::mutex> lock (cacheMutex);
+
+    auto it = cache.find (key);
+
+    if (it == cache.end ())
+        return false;
+
+    if (cache_clock::now () >= it->second.expires)
+    {
+        cache.erase (it);
+        return false;
+    }
+
+    result = it->second.response;
+    return true;
+}
+
+void ResponseCache::store (std::string const& key, Json::Value const& result)
+{
+    auto const now = cache_clock::now ();
+
+    std::lock_guard <std::mutex> lock (cacheMutex);
+
+    if (cache.size () >= Tuning::responseCacheMaxEntries)
+    {
+        for (auto it = cache.begin (); it != cache.end ();)
+        {
+            if (now >= it->second.expires)
+                it = cache.erase (it);
+            else
+                ++it;
+        }
+
+        // Still full of live entries: the query mix is wider than the
+        // cache. Start over rather than churn.
+        if (cache.size () >= Tuning::responseCacheMaxEntries)
+            cache.clear ();
+    }
+
+    Entry entry;
+    entry.response = result;
+    entry.expires = now + std::chrono::milliseconds (
+        Tuning::responseCacheExpiryMilliseconds);
+    cache[key] = entry;
+}
+
+} // RPC
+} // ripple
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+#define RIPPLE_RPC_RESPONSECACHE_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/json/json_value.h>
+#include <string>
+
+namespace ripple {
+namespace RPC {
+
+/** Short-lived cache of responses to idempotent read commands.
+
+    Load balancers fan the same few hundred queries at a server
+    thousands of times per validated ledger, and the answers only
+    change when the ledger does. Responses to the designated commands
+    are kept under a key that binds the canonical parameter text to
+    the validated ledger hash, so a ledger advance implicitly
+    invalidates every entry; a short expiry bounds the staleness of
+    answers drawn from the open ledger, which can drift between
+    closes as transactions arrive.
+
+    Only complete, successful responses are stored. The cache is
+    best-effort: under size pressure it simply empties.
+*/
+class ResponseCache
+{
+public:
+    /** True for commands whose responses depend only on their
+        parameters and ledger state. */
+    static bool isCacheable (std::string const& command);
+
+    /** Build the cache key for a request.
+        The client's id field does not influence the response and is
+        ignored.
+    */
+    static std::string makeKey (std::string const& command,
+        Json::Value const& params, uint256 const& validatedLedger);
+
+    /** Look up a response, filling result on a hit. */
+    static bool lookup (std::string const& key, Json::Value& result);
+
+    /** Store a successful response. */
+    static void store (std::string const& key, Json::Value const& result);
+};
+
+} // RPC
+} // ripple
+
+#endif
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/ResponseCache.h>
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+namespace RPC {
+
+class ResponseCache_test : public beast::unit_test::suite
+{
+public:
+    void test_designation ()
+    {
+        testcase ("designation");
+
+        expect (ResponseCache::isCacheable ("account_info"),
+            "read command is cacheable");
+        expect (ResponseCache::isCacheable ("ledger_closed"),
+            "read command is cacheable");
+        expect (!ResponseCache::isCacheable ("submit"),
+            "mutating command is not cacheable");
+        expect (!ResponseCache::isCacheable ("server_info"),
+            "live counter command is not cacheable");
+    }
+
+    void test_keying ()
+    {
+        testcase ("keying");
+
+        Json::Value params (Json::objectValue);
+        params["command"] = "account_info";
+        params["account"] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+
+        uint256 ledgerA (1);
+        uint256 ledgerB (2);
+
+        auto const key = ResponseCache::makeKey (
+            "account_info", params, ledgerA);
+
+        expect (key != ResponseCache::makeKey (
+            "account_info", params, ledgerB),
+            "ledger advance changes the key");
+
+        Json::Value withId = params;
+        withId["id"] = 17;
+        expect (key == ResponseCache::makeKey (
+            "account_info", withId, ledgerA),
+            "client id does not change the key");
+
+        Json::Value other = params;
+        other["account"] = "rrrrrrrrrrrrrrrrrrrrBZbvji";
+        expect (key != ResponseCache::makeKey (
+            "account_info", other, ledgerA),
+            "different parameters get different keys");
+    }
+
+    void test_roundTrip ()
+    {
+        testcase ("round trip");
+
+        Json::Value params (Json::objectValue);
+        params["command"] = "account_info";
+
+        auto const key = ResponseCache::makeKey (
+            "account_info", params, uint256 (3));
+
+        Json::Value result;
+        expect (!ResponseCache::lookup (key, result), "cold cache misses");
+
+        Json::Value response (Json::objectValue);
+        response["account_data"] = "cached";
+        ResponseCache::store (key, response);
+
+        expect (ResponseCache::lookup (key, result), "stored entry hits");
+        expect (result == response, "hit returns the stored response");
+
+        response["account_data"] = "updated";
+        ResponseCache::store (key, response);
+        expect (ResponseCache::lookup (key, result) && result == response,
+            "store overwrites");
+    }
+
+    void run ()
+    {
+        test_designation ();
+        test_keying ();
+        test_roundTrip ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ResponseCache, RPC, ripple);
+
+} // RPC
+} // ripple
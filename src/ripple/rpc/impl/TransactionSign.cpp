@@ -23,6 +23,8 @@
 #include <ripple/protocol/TxFlags.h>
 #include <ripple/rpc/impl/TransactionSign.h>
 #include <beast/unit_test.h>
+#include <atomic>
+#include <thread>
 
 namespace ripple {
 
@@ -283,10 +285,6 @@ static Json::Value signPayment(
                 "Cannot build XRP to XRP paths.");
 
         {
-            LegacyPathFind lpf (role == Role::ADMIN);
-            if (!lpf.isOk ())
-                return rpcError (rpcTOO_BUSY);
-
             STPathSet spsPaths;
             STPath fullLiquidityPath;
             bool valid = ledgerFacade.findPathsForOneIssuer (
@@ -527,7 +525,7 @@ transactionSign (
     {
         jvResult["tx_json"] = tpTrans->getJson (0);
         jvResult["tx_blob"] = strHex (
-            tpTrans->getSTransaction ()->getSerializer ().peekData ());
+            tpTrans->getSTransaction ()->getSerialized ());
 
         if (temUNCERTAIN != tpTrans->getResult ())
         {
@@ -552,6 +550,280 @@ transactionSign (
 
 //------------------------------------------------------------------------------
 
+Json::Value
+transactionSignBatch (
+    Json::Value params,
+    RPCDetail::LedgerFacade& ledgerFacade,
+    Role role)
+{
+    WriteLog (lsDEBUG, RPCHandler) << "transactionSignBatch";
+
+    if (! params.isMember ("secret"))
+        return RPC::missing_field_error ("secret");
+
+    if (! params.isMember ("tx_json"))
+        return RPC::missing_field_error ("tx_json");
+
+    RippleAddress naSeed;
+
+    if (! naSeed.setSeedGeneric (params["secret"].asString ()))
+        return RPC::make_error (rpcBAD_SEED,
+            RPC::invalid_field_message ("secret"));
+
+    Json::Value& txArray (params ["tx_json"]);
+
+    if (! txArray.isArray () || txArray.size () == 0)
+        return RPC::make_error (rpcINVALID_PARAMS,
+            "Field 'tx_json' must be a non-empty array.");
+
+    // The batch is all-or-nothing: the first bad entry fails the
+    // whole request, so a partial failure can never leave a gap in
+    // the assigned sequence numbers. The failing entry's position is
+    // reported in "tx_index".
+    auto entryError = [](Json::Value error, Json::UInt i)
+    {
+        error ["tx_index"] = i;
+        return error;
+    };
+
+    // Every entry must name the same source account so that account
+    // and key resolution happen once for the whole batch.
+    RippleAddress raSrcAddressID;
+
+    for (Json::UInt i = 0; i < txArray.size (); ++i)
+    {
+        Json::Value const& tx_json (txArray [i]);
+
+        if (! tx_json.isObject ())
+            return entryError (RPC::object_field_error ("tx_json"), i);
+
+        if (! tx_json.isMember ("TransactionType"))
+            return entryError (
+                RPC::missing_field_error ("tx_json.TransactionType"), i);
+
+        if (! tx_json.isMember ("Account"))
+            return entryError (RPC::make_error (rpcSRC_ACT_MISSING,
+                RPC::missing_field_message ("tx_json.Account")), i);
+
+        RippleAddress entryAddress;
+
+        if (! entryAddress.setAccountID (tx_json["Account"].asString ()))
+            return entryError (RPC::make_error (rpcSRC_ACT_MALFORMED,
+                RPC::invalid_field_message ("tx_json.Account")), i);
+
+        if (i == 0)
+            raSrcAddressID = entryAddress;
+        else if (entryAddress.getAccountID () !=
+                 raSrcAddressID.getAccountID ())
+            return entryError (RPC::make_error (rpcINVALID_PARAMS,
+                "All transactions in a batch must share one Account."), i);
+    }
+
+    bool const verify = !(params.isMember ("offline")
+                          && params["offline"].asBool ());
+
+    // Check for current ledger.
+    if (verify && !getConfig ().RUN_STANDALONE &&
+        (ledgerFacade.getValidatedLedgerAge () > 120))
+        return rpcError (rpcNO_CURRENT);
+
+    // Check for load.
+    if (ledgerFacade.isLoadedCluster () && (role != Role::ADMIN))
+        return rpcError (rpcTOO_BUSY);
+
+    ledgerFacade.snapshotAccountState (raSrcAddressID);
+
+    if (verify)
+    {
+        if (!ledgerFacade.isValidAccount ())
+        {
+            WriteLog (lsDEBUG, RPCHandler)
+                << "transactionSignBatch: Failed to find source account "
+                << "in current ledger: "
+                << raSrcAddressID.humanAccountID ();
+
+            return rpcError (rpcSRC_ACT_NOT_FOUND);
+        }
+
+        if (!ledgerFacade.hasAccountRoot ())
+            return rpcError (rpcSRC_ACT_NOT_FOUND);
+    }
+
+    RippleAddress secret = RippleAddress::createSeedGeneric (
+        params["secret"].asString ());
+    RippleAddress masterGenerator = RippleAddress::createGeneratorPublic (
+        secret);
+    RippleAddress masterAccountPublic = RippleAddress::createAccountPublic (
+        masterGenerator, 0);
+
+    if (verify)
+    {
+        auto const secretAccountID = masterAccountPublic.getAccountID();
+        if (raSrcAddressID.getAccountID () == secretAccountID)
+        {
+            if (ledgerFacade.accountMasterDisabled ())
+                return rpcError (rpcMASTER_DISABLED);
+        }
+        else if (!ledgerFacade.accountMatchesRegularKey (secretAccountID))
+        {
+            return rpcError (rpcBAD_SECRET);
+        }
+    }
+
+    RippleAddress naAccountPrivate = RippleAddress::createAccountPrivate (
+        masterGenerator, secret, 0);
+
+    // Entries without an explicit Sequence are numbered consecutively,
+    // seeded from the account's current sequence (or the first entry's
+    // Sequence when offline). An explicit Sequence resets the counter.
+    std::uint32_t sequence = 0;
+
+    if (txArray[0u].isMember ("Sequence"))
+        sequence = txArray[0u]["Sequence"].asUInt ();
+    else if (verify)
+        sequence = ledgerFacade.getSeq ();
+    else
+        return entryError (
+            RPC::missing_field_error ("tx_json.Sequence"), 0);
+
+    std::vector <STTx::pointer> transactions;
+    transactions.reserve (txArray.size ());
+
+    for (Json::UInt i = 0; i < txArray.size (); ++i)
+    {
+        Json::Value& tx_json (txArray [i]);
+
+        // autofill_fee works on a request holding one tx_json.
+        {
+            Json::Value request (Json::objectValue);
+
+            if (params.isMember ("fee_mult_max"))
+                request["fee_mult_max"] = params["fee_mult_max"];
+
+            request["tx_json"] = tx_json;
+
+            Json::Value feeResult;
+            autofill_fee (request, ledgerFacade, feeResult,
+                role == Role::ADMIN);
+            if (RPC::contains_error (feeResult))
+                return entryError (std::move (feeResult), i);
+
+            tx_json = request["tx_json"];
+        }
+
+        if ("Payment" == tx_json ["TransactionType"].asString ())
+        {
+            auto e = signPayment(
+                params,
+                tx_json,
+                raSrcAddressID,
+                ledgerFacade,
+                role);
+            if (contains_error(e))
+                return entryError (std::move (e), i);
+        }
+
+        if (tx_json.isMember ("Sequence"))
+            sequence = tx_json["Sequence"].asUInt ();
+        else
+            tx_json["Sequence"] = sequence;
+
+        ++sequence;
+
+        if (!tx_json.isMember ("Flags"))
+            tx_json["Flags"] = tfFullyCanonicalSig;
+
+        STParsedJSONObject parsed ("tx_json", tx_json);
+        if (!parsed.object.get())
+        {
+            Json::Value jvResult;
+            jvResult ["error"] = parsed.error ["error"];
+            jvResult ["error_code"] = parsed.error ["error_code"];
+            jvResult ["error_message"] = parsed.error ["error_message"];
+            return entryError (std::move (jvResult), i);
+        }
+
+        std::unique_ptr<STObject> sopTrans = std::move(parsed.object);
+        sopTrans->setFieldVL (
+            sfSigningPubKey,
+            masterAccountPublic.getAccountPublic ());
+
+        STTx::pointer stpTrans;
+
+        try
+        {
+            stpTrans = std::make_shared<STTx> (*sopTrans);
+        }
+        catch (std::exception&)
+        {
+            return entryError (RPC::make_error (rpcINTERNAL,
+                "Exception occurred during transaction"), i);
+        }
+
+        std::string reason;
+        if (!passesLocalChecks (*stpTrans, reason))
+            return entryError (
+                RPC::make_error (rpcINVALID_PARAMS, reason), i);
+
+        transactions.push_back (stpTrans);
+    }
+
+    // Signing dominates the cost and each signature is independent,
+    // so spread the batch over a pool of workers.
+    {
+        std::atomic <std::size_t> next (0);
+
+        auto signWorker = [&]()
+        {
+            for (;;)
+            {
+                std::size_t const i = next++;
+
+                if (i >= transactions.size ())
+                    return;
+
+                transactions[i]->sign (naAccountPrivate);
+            }
+        };
+
+        std::size_t const threadCount (std::min <std::size_t> (
+            std::max (1u, std::thread::hardware_concurrency ()),
+            transactions.size ()));
+
+        if (threadCount <= 1)
+        {
+            signWorker ();
+        }
+        else
+        {
+            std::vector <std::thread> threads;
+            threads.reserve (threadCount);
+
+            for (std::size_t i = 0; i < threadCount; ++i)
+                threads.emplace_back (signWorker);
+
+            for (auto& t : threads)
+                t.join ();
+        }
+    }
+
+    Json::Value jvResult;
+    Json::Value& results (jvResult["transactions"] = Json::arrayValue);
+
+    for (auto const& stpTrans : transactions)
+    {
+        Json::Value entry (Json::objectValue);
+        entry["tx_json"] = stpTrans->getJson (0);
+        entry["tx_blob"] = strHex (
+            stpTrans->getSerialized ());
+        results.append (entry);
+    }
+
+    return jvResult;
+}
+
+//------------------------------------------------------------------------------
+
 // Struct used to test calls to transactionSign and transactionSubmit.
 struct TxnTestData
 {
@@ -1087,10 +1359,66 @@ public:
         }
     }
 
+    void testBatchSign ()
+    {
+        // The first entry of txnTestArray is a good payment.
+        Json::Value req;
+        Json::Reader ().parse (txnTestArray[0].json, req);
+        if (contains_error (req))
+            throw std::runtime_error (
+                "Internal JSONRPC_test error.  Bad test JSON.");
+
+        {
+            // Two entries sharing one account; neither carries a
+            // Sequence, so they must be numbered consecutively.
+            Json::Value params;
+            params["secret"] = req["secret"];
+            params["tx_json"] = Json::arrayValue;
+            params["tx_json"].append (req["tx_json"]);
+            params["tx_json"].append (req["tx_json"]);
+
+            RPCDetail::LedgerFacade fakeNetOPs (
+                RPCDetail::LedgerFacade::noNetOPs);
+
+            Json::Value result = transactionSignBatch (
+                params, fakeNetOPs, Role::ADMIN);
+
+            expect (! contains_error (result));
+            expect (result["transactions"].size () == 2);
+            expect (result["transactions"][0u]["tx_json"]["Sequence"] == 0);
+            expect (result["transactions"][1u]["tx_json"]["Sequence"] == 1);
+
+            for (auto const& entry : result["transactions"])
+                expect (entry.isMember ("tx_blob"));
+        }
+
+        {
+            // Entries with different accounts must be rejected.
+            Json::Value params;
+            params["secret"] = req["secret"];
+            params["tx_json"] = Json::arrayValue;
+            params["tx_json"].append (req["tx_json"]);
+
+            Json::Value second (req["tx_json"]);
+            second["Account"] = second["Destination"];
+            params["tx_json"].append (second);
+
+            RPCDetail::LedgerFacade fakeNetOPs (
+                RPCDetail::LedgerFacade::noNetOPs);
+
+            Json::Value result = transactionSignBatch (
+                params, fakeNetOPs, Role::ADMIN);
+
+            expect (contains_error (result));
+            expect (result["tx_index"] == 1);
+        }
+    }
+
     void run ()
     {
         testAutoFillFees ();
         testTransactionRPC ();
+        testBatchSign ();
     }
 };
 
@@ -118,6 +118,27 @@ inline Json::Value transactionSign (
     return transactionSign (params, bSubmit, bFailHard, ledgerFacade, role);
 }
 
+/** Sign an array of transactions sharing one account and secret.
+
+    Account and key resolution are performed once, entries without a
+    Sequence are numbered consecutively, and the signatures are
+    computed on a pool of worker threads. Returns a Json::objectValue
+    whose "transactions" array matches the input order.
+*/
+Json::Value transactionSignBatch (
+    Json::Value params,
+    RPCDetail::LedgerFacade& ledgerFacade,
+    Role role);
+
+inline Json::Value transactionSignBatch (
+    Json::Value params,
+    NetworkOPs& netOPs,
+    Role role)
+{
+    RPCDetail::LedgerFacade ledgerFacade (netOPs);
+    return transactionSignBatch (params, ledgerFacade, role);
+}
+
 } // RPC
 } // ripple
 
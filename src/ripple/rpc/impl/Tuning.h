@@ -57,9 +57,30 @@ Specified in the limit param.
 */
 unsigned int const maxOffersPerRequest (400);
 
+/** How many state entries ledger_data returns between coroutine yields */
+unsigned int const ledgerDataYieldCount (256);
+
+/** Maximum specifiers accepted in one batched ledger_entry request */
+unsigned int const maxLedgerEntriesPerRequest (400);
+
 int const defaultAutoFillFeeMultiplier (10);
-int const maxPathfindsInProgress (2);
-int const maxPathfindJobCount (50);
+
+/** Estimated cost, in microseconds, charged for a command that has
+never been measured */
+int const admissionDefaultCost (10000);
+
+/** Budget of estimated non-administrative RPC work in progress,
+in microseconds */
+int const maxAdmissionCostInProgress (500000);
+
+/** How long a cached response to an idempotent read command stays
+servable. A ledger advance invalidates entries regardless; the expiry
+bounds the staleness of answers drawn from the open ledger. */
+int const responseCacheExpiryMilliseconds (1000);
+
+/** Maximum responses held in the response cache */
+unsigned int const responseCacheMaxEntries (1024);
+
 int const maxJobQueueClients (500);
 int const maxValidatedLedgerAge (120);
 int const maxRequestSize (1000000);
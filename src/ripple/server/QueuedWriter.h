@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SERVER_QUEUEDWRITER_H_INCLUDED
+#define RIPPLE_SERVER_QUEUEDWRITER_H_INCLUDED
+
+#include <ripple/rpc/Output.h>
+#include <ripple/server/Writer.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+namespace HTTP {
+
+/** Writer fed incrementally from a producer thread.
+
+    A streaming handler renders its response - typically through
+    RPC::JsonWriter - into the Output returned by output(), while the
+    io side pulls the bytes off as the socket accepts them. The queue
+    between them is bounded: when the client cannot keep up, the
+    producer blocks in output() until the socket drains, so a slow
+    consumer throttles response generation instead of ballooning a
+    write queue.
+
+    A producer stalled longer than the session timeout gives up and
+    truncates the response; by then the connection's own timer has
+    already failed the peer.
+*/
+class QueuedWriter : public Writer
+{
+private:
+    enum
+    {
+        // Stop the producer when this much is waiting on the socket
+        highWaterMark = 256 * 1024,
+
+        // Matches the Peer session timeout: a connection that cannot
+        // accept bytes for this long is already being torn down
+        timeoutSeconds = 30
+    };
+
+    std::mutex mutex_;
+    std::condition_variable consumed_;
+    std::list <std::string> queue_;
+    std::size_t size_ = 0;      // Queued bytes not yet consumed
+    std::size_t used_ = 0;      // Consumed bytes of the front string
+    bool finished_ = false;
+    bool abandoned_ = false;
+    std::function <void(void)> resume_;
+
+public:
+    /** Returns the functor the producer writes the response through. */
+    RPC::Output
+    output()
+    {
+        return [this] (boost::string_ref const& bytes)
+        {
+            write (bytes.data(), bytes.size());
+        };
+    }
+
+    void
+    write (char const* data, std::size_t bytes)
+    {
+        if (bytes == 0)
+            return;
+        std::function <void(void)> resume;
+        {
+            std::unique_lock <std::mutex> lock (mutex_);
+            if (abandoned_)
+                return;
+            if (! consumed_.wait_for (lock,
+                std::chrono::seconds (timeoutSeconds),
+                    [this] { return size_ < highWaterMark; }))
+            {
+                // Leave what is queued for the io side to drain; the
+                // buffers may be in the middle of a write right now.
+                abandoned_ = true;
+                finished_ = true;
+                return;
+            }
+            queue_.emplace_back (data, bytes);
+            size_ += bytes;
+            std::swap (resume, resume_);
+        }
+        if (resume)
+            resume();
+    }
+
+    /** The producer calls this once the response is fully written. */
+    void
+    finish()
+    {
+        std::function <void(void)> resume;
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            finished_ = true;
+            std::swap (resume, resume_);
+        }
+        if (resume)
+            resume();
+    }
+
+    // Writer
+
+    bool
+    complete() override
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        return finished_ && queue_.empty();
+    }
+
+    void
+    consume (std::size_t bytes) override
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        size_ -= bytes;
+        used_ += bytes;
+        while (! queue_.empty() && (used_ >= queue_.front().size()))
+        {
+            used_ -= queue_.front().size();
+            queue_.pop_front();
+        }
+        consumed_.notify_all();
+    }
+
+    bool
+    prepare (std::size_t, std::function <void(void)> resume) override
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        if (! queue_.empty() || finished_)
+            return true;
+        resume_ = std::move (resume);
+        return false;
+    }
+
+    std::vector <boost::asio::const_buffer>
+    data() override
+    {
+        std::lock_guard <std::mutex> lock (mutex_);
+        std::vector <boost::asio::const_buffer> result;
+        result.reserve (queue_.size());
+        std::size_t used = used_;
+        for (auto const& s : queue_)
+        {
+            result.emplace_back (s.data() + used, s.size() - used);
+            used = 0;
+        }
+        return result;
+    }
+};
+
+}
+}
+
+#endif
@@ -24,6 +24,7 @@
 #include <beast/asio/placeholders.h>
 #include <beast/asio/ssl_bundle.h>
 #include <functional>
+#include <thread>
 
 namespace ripple {
 namespace HTTP {
@@ -97,6 +98,7 @@ Door::detector::detector (Door& door, socket_type&& socket,
     : Child(door)
     , socket_(std::move(socket))
     , timer_(socket_.get_io_service())
+    , strand_(socket_.get_io_service())
     , remote_address_(remote_address)
 {
 }
@@ -106,10 +108,10 @@ Door::detector::run()
 {
     // do_detect must be called before do_timer or else
     // the timer can be canceled before it gets set.
-    boost::asio::spawn (door_.strand_, std::bind (&detector::do_detect,
+    boost::asio::spawn (strand_, std::bind (&detector::do_detect,
         shared_from_this(), std::placeholders::_1));
 
-    boost::asio::spawn (door_.strand_, std::bind (&detector::do_timer,
+    boost::asio::spawn (strand_, std::bind (&detector::do_timer,
         shared_from_this(), std::placeholders::_1));
 }
 
@@ -229,8 +231,17 @@ Door::~Door()
 void
 Door::run()
 {
-    boost::asio::spawn (strand_, std::bind (&Door::do_accept,
-        shared_from_this(), std::placeholders::_1));
+    // Keep several accept operations in flight so a reconnect storm is
+    // drained in parallel instead of serialized behind a single accept
+    // chain. Initiations share the strand (the acceptor itself is not
+    // thread safe) but completions are distributed across the pool's
+    // threads, and each detector runs on its own strand.
+    std::size_t const acceptors (std::min <std::size_t> (16,
+        std::max (1u, std::thread::hardware_concurrency ())));
+
+    for (std::size_t i = 0; i < acceptors; ++i)
+        boost::asio::spawn (strand_, std::bind (&Door::do_accept,
+            shared_from_this(), std::placeholders::_1));
 }
 
 void
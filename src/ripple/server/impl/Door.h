@@ -70,6 +70,9 @@ private:
     private:
         socket_type socket_;
         timer_type timer_;
+        // Each detector serializes its own coroutines so detection of
+        // concurrent connections can proceed in parallel across the pool.
+        boost::asio::io_service::strand strand_;
         endpoint_type remote_address_;
 
     public:
@@ -18,17 +18,102 @@
 //==============================================================================
 
 #include <ripple/basics/Log.h>
+#include <ripple/core/JobArena.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/json/to_string.h>
+#include <beast/http/rfc2616.h>
 #include <boost/algorithm/string.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
 
 namespace ripple {
 
 unsigned int const gMaxHTTPHeaderSize = 0x02000000;
 
+namespace {
+
+// Below this size the compression overhead outweighs the savings
+std::size_t const minCompressBytes = 1024;
+
+// HTTP "gzip" is a gzip stream and "deflate" is a zlib stream: the
+// same compressor with different framing, selected by windowBits.
+int windowBitsFor (std::string const& contentEncoding)
+{
+    return (contentEncoding == "gzip") ? 31 : 15;
+}
+
+// Compress `in` in one shot. Returns false, leaving `out`
+// unspecified, if the compressor cannot be set up. The scratch
+// buffer draws from the job arena and is reclaimed when the
+// rendering job finishes.
+bool deflateAll (std::string const& in, int windowBits, ArenaString& out)
+{
+    z_stream zs;
+    std::memset (&zs, 0, sizeof (zs));
+
+    if (deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+            windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    out.resize (deflateBound (&zs, in.size ()));
+    zs.next_in = reinterpret_cast <Bytef*> (
+        const_cast <char*> (in.data ()));
+    zs.avail_in = in.size ();
+    zs.next_out = reinterpret_cast <Bytef*> (&out[0]);
+    zs.avail_out = out.size ();
+
+    int const result = deflate (&zs, Z_FINISH);
+    deflateEnd (&zs);
+
+    if (result != Z_STREAM_END)
+        return false;
+
+    out.resize (zs.total_out);
+    return true;
+}
+
+}
+
+std::string negotiateEncoding (std::string const& acceptEncoding)
+{
+    bool gzip = false;
+    bool deflate = false;
+
+    for (auto const& element : beast::rfc2616::split_commas (
+            acceptEncoding.begin (), acceptEncoding.end ()))
+    {
+        std::string token = element;
+
+        auto const semi = token.find (';');
+        if (semi != std::string::npos)
+        {
+            // A quality of zero refuses the coding outright
+            auto const q = token.find ("q=", semi);
+            if ((q != std::string::npos) &&
+                (std::strtod (token.c_str () + q + 2, nullptr) == 0))
+                continue;
+            token.erase (semi);
+        }
+        boost::trim (token);
+
+        if (boost::iequals (token, "gzip"))
+            gzip = true;
+        else if (boost::iequals (token, "deflate"))
+            deflate = true;
+    }
+
+    if (gzip)
+        return "gzip";
+    if (deflate)
+        return "deflate";
+    return std::string ();
+}
+
 std::string getHTTPHeaderTimestamp ()
 {
     // CHECKME This is probably called often enough that optimizing it makes
@@ -44,7 +129,8 @@ std::string getHTTPHeaderTimestamp ()
     return std::string (buffer);
 }
 
-void HTTPReply (int nStatus, std::string const& content, RPC::Output output)
+void HTTPReply (int nStatus, std::string const& content, RPC::Output output,
+    std::string const& contentEncoding)
 {
     if (ShouldLog (lsTRACE, RPC))
     {
@@ -95,6 +181,19 @@ void HTTPReply (int nStatus, std::string const& content, RPC::Output output)
 
     output (getHTTPHeaderTimestamp ());
 
+    // Compress large result bodies when the client offered an
+    // encoding. Small replies are not worth the compressor setup, and
+    // error replies stay readable in any tool.
+    ArenaString compressed;
+    bool bCompressed = false;
+    if ((nStatus == 200) && ! contentEncoding.empty () &&
+        (content.size () >= minCompressBytes))
+    {
+        bCompressed = deflateAll (content,
+            windowBitsFor (contentEncoding), compressed) &&
+                (compressed.size () < content.size ());
+    }
+
     output ("Connection: Keep-Alive\r\n"
             "Content-Length: ");
 
@@ -102,16 +201,147 @@ void HTTPReply (int nStatus, std::string const& content, RPC::Output output)
     //if (getConfig ().RPC_ALLOW_REMOTE)
     //    output ("Access-Control-Allow-Origin: *\r\n");
 
-    output (std::to_string(content.size () + 2));
+    output (std::to_string (bCompressed ?
+        compressed.size () : content.size () + 2));
     output ("\r\n"
             "Content-Type: application/json; charset=UTF-8\r\n");
 
+    if (bCompressed)
+        output ("Content-Encoding: " + contentEncoding + "\r\n");
+
+    output ("Server: " + systemName () + "-json-rpc/");
+    output (BuildInfo::getFullVersionString ());
+    output ("\r\n"
+            "\r\n");
+
+    if (bCompressed)
+    {
+        output (compressed);
+    }
+    else
+    {
+        output (content);
+        output ("\r\n");
+    }
+}
+
+void HTTPBinaryReply (std::string const& content,
+    std::string const& extraHeaders, RPC::Output output)
+{
+    // Raw bytes, exactly Content-Length of them: no charset, no
+    // trailing newline, no JSON framing.
+    output ("HTTP/1.1 200 OK\r\n");
+    output (getHTTPHeaderTimestamp ());
+
+    output ("Connection: Keep-Alive\r\n"
+            "Content-Length: ");
+    output (std::to_string(content.size ()));
+    output ("\r\n"
+            "Content-Type: application/octet-stream\r\n");
+    output (extraHeaders);
+
     output ("Server: " + systemName () + "-json-rpc/");
     output (BuildInfo::getFullVersionString ());
     output ("\r\n"
             "\r\n");
     output (content);
-    output ("\r\n");
+}
+
+void HTTPChunkedReply (
+    std::function <void (RPC::Output const&)> const& body, RPC::Output output,
+    std::string const& contentEncoding)
+{
+    std::size_t const chunkSize = 8192;
+
+    // The compressor runs right here, on the thread rendering the
+    // body, so the io threads only ever shuttle finished bytes. If it
+    // cannot be set up, fall back to identity before any header goes
+    // out.
+    z_stream zs;
+    bool compressing = ! contentEncoding.empty ();
+    if (compressing)
+    {
+        std::memset (&zs, 0, sizeof (zs));
+        compressing = deflateInit2 (&zs, Z_DEFAULT_COMPRESSION,
+            Z_DEFLATED, windowBitsFor (contentEncoding), 8,
+            Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    output ("HTTP/1.1 200 OK\r\n");
+    output (getHTTPHeaderTimestamp ());
+
+    output ("Connection: Keep-Alive\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Type: application/json; charset=UTF-8\r\n");
+
+    if (compressing)
+        output ("Content-Encoding: " + contentEncoding + "\r\n");
+
+    output ("Server: " + systemName () + "-json-rpc/");
+    output (BuildInfo::getFullVersionString ());
+    output ("\r\n"
+            "\r\n");
+
+    auto chunk = [&output] (char const* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+        char head[16];
+        auto const length = snprintf (
+            head, sizeof (head), "%zx\r\n", size);
+        output (boost::string_ref (head, length));
+        output (boost::string_ref (data, size));
+        output ("\r\n");
+    };
+
+    // The JSON writer emits many tiny segments; framing each one as its
+    // own HTTP chunk would be mostly overhead, so gather them into
+    // fixed-size chunks before they go to the session. The gathering
+    // buffer is job-arena scratch, like the compressor's.
+    ArenaString buffer;
+    buffer.reserve (chunkSize);
+
+    auto flush = [&] (bool finished)
+    {
+        if (! compressing)
+        {
+            chunk (buffer.data (), buffer.size ());
+            buffer.clear ();
+            return;
+        }
+
+        // Feed the gathered segment through the compressor; each
+        // filled output buffer becomes one HTTP chunk.
+        zs.next_in = reinterpret_cast <Bytef*> (
+            const_cast <char*> (buffer.data ()));
+        zs.avail_in = buffer.size ();
+
+        char out[chunkSize];
+        for (;;)
+        {
+            zs.next_out = reinterpret_cast <Bytef*> (out);
+            zs.avail_out = sizeof (out);
+            int const result = deflate (
+                &zs, finished ? Z_FINISH : Z_NO_FLUSH);
+            chunk (out, sizeof (out) - zs.avail_out);
+            if (finished ? (result == Z_STREAM_END) : (zs.avail_in == 0))
+                break;
+        }
+        buffer.clear ();
+    };
+
+    body ([&] (boost::string_ref const& bytes)
+    {
+        buffer.append (bytes.data (), bytes.size ());
+        if (buffer.size () >= chunkSize)
+            flush (false);
+    });
+
+    flush (true);
+    if (compressing)
+        deflateEnd (&zs);
+
+    output ("0\r\n\r\n");
 }
 
 } // ripple
@@ -25,7 +25,38 @@
 
 namespace ripple {
 
-void HTTPReply (int nStatus, std::string const& strMsg, RPC::Output);
+/** Select a response encoding from an Accept-Encoding header value.
+    @return "gzip", "deflate", or an empty string for identity.
+*/
+std::string negotiateEncoding (std::string const& acceptEncoding);
+
+/** Send a JSON-RPC response.
+    When `contentEncoding` is non-empty, large 200 bodies are
+    compressed with it; small bodies and errors go out as-is.
+*/
+void HTTPReply (int nStatus, std::string const& strMsg, RPC::Output,
+    std::string const& contentEncoding = std::string ());
+
+/** Send a 200 response whose body is raw bytes, not JSON.
+    @param extraHeaders Extra response headers, each "Name: value\r\n".
+*/
+void HTTPBinaryReply (std::string const& content,
+    std::string const& extraHeaders, RPC::Output);
+
+/** Send a 200 response with chunked transfer-encoding.
+
+    The body is produced incrementally: headers go out first, then
+    `body` is invoked with an Output that frames whatever is written to
+    it as HTTP chunks, so the client starts consuming while the rest of
+    the response is still being generated and the server never holds
+    the whole response in memory.
+
+    When `contentEncoding` is non-empty the body is compressed with it
+    as it streams, on the thread rendering the body.
+*/
+void HTTPChunkedReply (
+    std::function <void (RPC::Output const&)> const& body, RPC::Output,
+    std::string const& contentEncoding = std::string ());
 
 } // ripple
 
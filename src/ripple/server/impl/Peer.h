@@ -33,6 +33,7 @@
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/spawn.hpp>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
@@ -40,6 +41,7 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include <beast/cxx14/type_traits.h> // <type_traits>
 
 namespace ripple {
@@ -64,23 +66,38 @@ protected:
         bufferSize = 4 * 1024,
 
         // Max seconds without completing a message
-        timeoutSeconds = 30
+        timeoutSeconds = 30,
+
+        // Minimum allocation for a queued write, so the many small
+        // header chunks of a reply coalesce into one buffer
+        chunkSize = 512
 
     };
 
     struct buffer
     {
         buffer (void const* ptr, std::size_t len)
-            : data (new char[len])
+            : data (new char[std::max <std::size_t> (len, chunkSize)])
             , bytes (len)
             , used (0)
+            , capacity (std::max <std::size_t> (len, chunkSize))
         {
             memcpy (data.get(), ptr, len);
         }
 
+        // Append more data, which the caller has checked will fit
+        void
+        append (void const* ptr, std::size_t len)
+        {
+            assert (bytes + len <= capacity);
+            memcpy (data.get() + bytes, ptr, len);
+            bytes += len;
+        }
+
         std::unique_ptr <char[]> data;
         std::size_t bytes;
         std::size_t used;
+        std::size_t capacity;
     };
 
     boost::asio::io_service::work work_;
@@ -96,6 +113,7 @@ protected:
     beast::http::message message_;
     beast::http::body body_;
     std::list <buffer> write_queue_;
+    std::size_t writing_ = 0;   // buffers being sent by do_write
     std::mutex mutex_;
     bool graceful_ = false;
     bool complete_ = false;
@@ -393,39 +411,40 @@ void
 Peer<Impl>::do_write (yield_context yield)
 {
     error_code ec;
-    std::size_t bytes = 0;
     for(;;)
     {
-        bytes_out_ += bytes;
-        void const* data;
+        // Gather everything queued so far into a single vectored
+        // write instead of sending one small buffer at a time
+        std::size_t count;
+        std::vector <boost::asio::const_buffer> buffers;
         {
             std::lock_guard <std::mutex> lock (mutex_);
             assert(! write_queue_.empty());
-            buffer& b1 = write_queue_.front();
-            b1.used += bytes;
-            if (b1.used >= b1.bytes)
-            {
-                write_queue_.pop_front();
-                if (write_queue_.empty())
-                    break;
-                buffer& b2 = write_queue_.front();
-                data = b2.data.get();
-                bytes = b2.bytes;
-            }
-            else
-            {
-                data = b1.data.get() + b1.used;
-                bytes = b1.bytes - b1.used;
-            }
+            count = write_queue_.size();
+            writing_ = count;
+            buffers.reserve (count);
+            for (auto const& b : write_queue_)
+                buffers.emplace_back (b.data.get() + b.used,
+                    b.bytes - b.used);
         }
 
         start_timer();
-        bytes = boost::asio::async_write (impl().stream_,
-            boost::asio::buffer (data, bytes),
-                boost::asio::transfer_at_least(1), yield[ec]);
+        auto const bytes_transferred = boost::asio::async_write (
+            impl().stream_, buffers, yield[ec]);
         cancel_timer();
         if (ec)
             return fail (ec, "write");
+        bytes_out_ += bytes_transferred;
+
+        {
+            // More buffers may have arrived while we were writing
+            std::lock_guard <std::mutex> lock (mutex_);
+            while (count--)
+                write_queue_.pop_front();
+            writing_ = 0;
+            if (write_queue_.empty())
+                break;
+        }
     }
 
     if (! complete_)
@@ -491,7 +510,15 @@ Peer<Impl>::write (void const* buffer, std::size_t bytes)
     {
         std::lock_guard <std::mutex> lock (mutex_);
         empty = write_queue_.empty();
-        write_queue_.emplace_back (buffer, bytes);
+
+        // Coalesce into the newest buffer when it has room and is
+        // not already being sent
+        if (! empty && (write_queue_.size() > writing_) &&
+            (write_queue_.back().bytes + bytes <=
+                write_queue_.back().capacity))
+            write_queue_.back().append (buffer, bytes);
+        else
+            write_queue_.emplace_back (buffer, bytes);
     }
 
     if (empty)
@@ -26,10 +26,12 @@
 #include <ripple/basics/make_SSLContext.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/server/make_Server.h>
+#include <ripple/server/QueuedWriter.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/Manager.h>
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/Coroutine.h>
+#include <ripple/rpc/handlers/Handlers.h>
 #include <beast/crypto/base64.h>
 #include <beast/cxx14/algorithm.h> // <algorithm>
 #include <beast/http/rfc2616.h>
@@ -227,6 +229,38 @@ void
 ServerHandlerImp::processSession (
     std::shared_ptr<HTTP::Session> const& session, Yield const& yield)
 {
+    // The client's Accept-Encoding header decides how the reply body
+    // goes out; compression happens here on the job queue worker, not
+    // on an io thread.
+    auto const contentEncoding =
+        negotiateEncoding (session->request().headers["Accept-Encoding"]);
+
+    if (setup_.yieldStrategy.streaming == RPC::YieldStrategy::Streaming::yes)
+    {
+        // Stream through a bounded writer that the io side drains as
+        // the socket accepts bytes. A slow client throttles response
+        // generation here instead of growing the session's write
+        // queue, and the writer settles keep-alive when it drains.
+        bool const keep_alive = session->request().keep_alive();
+        auto writer = std::make_shared <HTTP::QueuedWriter> ();
+        auto output = writer->output();
+        if (auto byteYieldCount = setup_.yieldStrategy.byteYieldCount)
+            output = RPC::chunkedYieldingOutput (
+                output, yield, byteYieldCount);
+        session->write (writer, keep_alive);
+
+        processRequest (
+            session->port(),
+            to_string (session->body()),
+            session->remoteAddress().at_port (0),
+            output,
+            yield,
+            contentEncoding);
+
+        writer->finish();
+        return;
+    }
+
     auto output = makeOutput (*session);
     if (auto byteYieldCount = setup_.yieldStrategy.byteYieldCount)
         output = RPC::chunkedYieldingOutput (output, yield, byteYieldCount);
@@ -236,7 +270,8 @@ ServerHandlerImp::processSession (
         to_string (session->body()),
         session->remoteAddress().at_port (0),
         output,
-        yield);
+        yield,
+        contentEncoding);
 
     if (session->request().keep_alive())
         session->complete();
@@ -250,21 +285,85 @@ ServerHandlerImp::processRequest (
     std::string const& request,
     beast::IP::Endpoint const& remoteIPAddress,
     Output output,
-    Yield yield)
+    Yield yield,
+    std::string const& contentEncoding)
 {
     Json::Value jsonRPC;
     {
         Json::Reader reader;
+        // Parse directly from the request buffer; the std::string
+        // overload copies the entire document first.
         if ((request.size () > 1000000) ||
-            ! reader.parse (request, jsonRPC) ||
+            ! reader.parse (request.data (),
+                request.data () + request.size (), jsonRPC) ||
             jsonRPC.isNull () ||
-            ! jsonRPC.isObject ())
+            ! (jsonRPC.isObject () || jsonRPC.isArray ()))
         {
             HTTPReply (400, "Unable to parse request", output);
             return;
         }
     }
 
+    // JSON-RPC batch: an array of requests is dispatched in order and
+    // answered with one aggregated array, amortizing the HTTP, TLS and
+    // JSON envelope overhead across many small commands.
+    if (jsonRPC.isArray ())
+    {
+        unsigned const maxRequestsPerBatch = 100;
+
+        if (jsonRPC.size () == 0)
+        {
+            HTTPReply (400, "empty batch", output);
+            return;
+        }
+
+        // The first entry's credentials decide the resource consumer
+        // and whether the batch size cap applies; each entry is still
+        // authorized individually when it is dispatched.
+        auto const& admin_allow = getConfig().RPC_ADMIN_ALLOW;
+        auto role = Role::FORBID;
+        Json::Value const& first = jsonRPC[0u];
+        if (first.isObject() && first.isMember("params") &&
+                first["params"].isArray() && first["params"].size() > 0 &&
+                    first["params"][Json::UInt(0)].isObject())
+            role = adminRole(port, first["params"][Json::UInt(0)],
+                remoteIPAddress, admin_allow);
+        else
+            role = adminRole(port, Json::objectValue,
+                remoteIPAddress, admin_allow);
+
+        if ((jsonRPC.size () > maxRequestsPerBatch) && (role != Role::ADMIN))
+        {
+            HTTPReply (400, "batch too large", output);
+            return;
+        }
+
+        Resource::Consumer usage;
+        if (role == Role::ADMIN)
+            usage = m_resourceManager.newAdminEndpoint (
+                remoteIPAddress.to_string());
+        else
+            usage = m_resourceManager.newInboundEndpoint(remoteIPAddress);
+
+        Json::Value replies (Json::arrayValue);
+        for (Json::Value const& entry : jsonRPC)
+        {
+            if (usage.disconnect ())
+            {
+                HTTPReply (503, "Server is overloaded", output);
+                return;
+            }
+
+            replies.append (processCommand (
+                port, entry, remoteIPAddress, usage, yield));
+        }
+
+        std::string response = to_string (replies);
+        response += '\n';
+        HTTPReply (200, response, output, contentEncoding);
+        return;
+    }
+
     auto const& admin_allow = getConfig().RPC_ADMIN_ALLOW;
     auto role = Role::FORBID;
     if (jsonRPC.isObject() && jsonRPC.isMember("params") &&
@@ -362,13 +461,37 @@ ServerHandlerImp::processRequest (
         << "doRpcCommand:" << strMethod << ":" << params;
 
     RPC::Context context {params, loadType, m_networkOPs, role, nullptr, yield};
-    std::string response;
+
+    // Bulk state export bypasses JSON framing entirely; the handler
+    // writes raw length-prefixed entry frames straight to the session
+    if ((strMethod == "ledger_data") && params["binary_frames"].asBool ())
+    {
+        doLedgerDataBinaryFrames (context, output);
+        usage.charge (loadType);
+        return;
+    }
 
     if (setup_.yieldStrategy.streaming == RPC::YieldStrategy::Streaming::yes)
     {
-        executeRPC (context, response, setup_.yieldStrategy);
+        // Render straight to the session with chunked transfer-encoding.
+        // New-style handlers expand one element at a time - for the
+        // ledger command, one transaction - as the writer drains, so
+        // memory stays bounded and the client starts consuming the
+        // first results while the rest are still being produced.
+        HTTPChunkedReply (
+            [&] (RPC::Output const& chunked)
+            {
+                executeRPC (context, chunked, setup_.yieldStrategy);
+                chunked ("\n");
+            },
+            output,
+            contentEncoding);
+        usage.charge (loadType);
+        return;
     }
-    else
+
+    std::string response;
+
     {
         Json::Value result;
         RPC::doCommand (context, result, setup_.yieldStrategy);
@@ -404,7 +527,91 @@ ServerHandlerImp::processRequest (
             m_journal.debug << "Reply: " << response.substr (0, maxSize);
     }
 
-    HTTPReply (200, response, output);
+    HTTPReply (200, response, output, contentEncoding);
+}
+
+// Dispatch one entry of a JSON-RPC batch. Malformed entries and
+// authorization failures produce an error reply for that entry rather
+// than failing the whole batch; the entry's "id", if any, is echoed so
+// callers can match replies to requests.
+Json::Value
+ServerHandlerImp::processCommand (HTTP::Port const& port,
+    Json::Value const& jsonRPC, beast::IP::Endpoint const& remoteIPAddress,
+    Resource::Consumer& usage, Yield const& yield)
+{
+    Json::Value reply (Json::objectValue);
+
+    if (! jsonRPC.isObject ())
+    {
+        reply["error"] = "Unable to parse request";
+        return reply;
+    }
+
+    if (jsonRPC.isMember ("id"))
+        reply["id"] = jsonRPC["id"];
+
+    auto const& admin_allow = getConfig().RPC_ADMIN_ALLOW;
+    auto role = Role::FORBID;
+    if (jsonRPC.isMember("params") &&
+            jsonRPC["params"].isArray() && jsonRPC["params"].size() > 0 &&
+                jsonRPC["params"][Json::UInt(0)].isObject())
+        role = adminRole(port, jsonRPC["params"][Json::UInt(0)],
+            remoteIPAddress, admin_allow);
+    else
+        role = adminRole(port, Json::objectValue,
+            remoteIPAddress, admin_allow);
+
+    if (role == Role::FORBID)
+    {
+        reply["error"] = "Forbidden";
+        return reply;
+    }
+
+    Json::Value const method = jsonRPC ["method"];
+    if (! method.isString () || method.asString ().empty ())
+    {
+        reply["error"] = "Null method";
+        return reply;
+    }
+    std::string const strMethod = method.asString ();
+
+    Json::Value params = jsonRPC ["params"];
+    if (params.isNull () || params.empty())
+        params = Json::Value (Json::objectValue);
+    else if (!params.isArray () || params.size() != 1 ||
+        !params[0u].isObject())
+    {
+        reply["error"] = "params unparseable";
+        return reply;
+    }
+    else
+        params = std::move (params[0u]);
+
+    Resource::Charge loadType = Resource::feeReferenceRPC;
+
+    params[jss::command] = strMethod;
+    WriteLog (lsTRACE, RPCHandler)
+        << "doRpcCommand:" << strMethod << ":" << params;
+
+    RPC::Context context {params, loadType, m_networkOPs, role, nullptr,
+        yield};
+
+    Json::Value result;
+    RPC::doCommand (context, result, setup_.yieldStrategy);
+    usage.charge (loadType);
+
+    if (result.isMember ("error"))
+    {
+        result[jss::status] = jss::error;
+        result[jss::request] = params;
+    }
+    else
+    {
+        result[jss::status] = jss::success;
+    }
+
+    reply[jss::result] = std::move (result);
+    return reply;
 }
 
 //------------------------------------------------------------------------------
@@ -112,7 +112,14 @@ private:
 
     void
     processRequest (HTTP::Port const& port, std::string const& request,
-        beast::IP::Endpoint const& remoteIPAddress, Output, Yield);
+        beast::IP::Endpoint const& remoteIPAddress, Output, Yield,
+        std::string const& contentEncoding);
+
+    /** Dispatch one entry of a JSON-RPC batch, returning its reply. */
+    Json::Value
+    processCommand (HTTP::Port const& port, Json::Value const& jsonRPC,
+        beast::IP::Endpoint const& remoteIPAddress,
+        Resource::Consumer& usage, Yield const& yield);
 
     //
     // PropertyStream
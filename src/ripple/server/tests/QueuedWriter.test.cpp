@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/server/QueuedWriter.h>
+#include <beast/unit_test/suite.h>
+#include <string>
+
+namespace ripple {
+namespace HTTP {
+
+class QueuedWriter_test : public beast::unit_test::suite
+{
+public:
+    // Gather everything the writer currently offers into a string
+    static
+    std::string
+    gather (Writer& writer)
+    {
+        std::string result;
+        for (auto const& buffer : writer.data())
+            result.append (
+                boost::asio::buffer_cast <char const*> (buffer),
+                boost::asio::buffer_size (buffer));
+        return result;
+    }
+
+    void
+    testPushPull()
+    {
+        testcase ("push and pull");
+
+        QueuedWriter writer;
+        auto output = writer.output();
+
+        expect (! writer.prepare (1, [] {}), "no data yet");
+
+        output ("hello, ");
+        output ("world");
+        expect (writer.prepare (1, [] {}), "data ready");
+        expect (gather (writer) == "hello, world");
+
+        // Partial consumption leaves the remainder on offer
+        writer.consume (5);
+        expect (gather (writer) == ", world");
+        expect (! writer.complete ());
+
+        writer.consume (7);
+        expect (! writer.complete (), "not finished yet");
+
+        writer.finish ();
+        expect (writer.complete ());
+    }
+
+    void
+    testResume()
+    {
+        testcase ("resume");
+
+        QueuedWriter writer;
+        bool resumed = false;
+
+        expect (! writer.prepare (1, [&] { resumed = true; }));
+        expect (! resumed, "not resumed before data");
+
+        writer.output() ("x");
+        expect (resumed, "resumed by the producer");
+
+        // Finishing with nothing queued resumes the io side too
+        QueuedWriter empty;
+        resumed = false;
+        expect (! empty.prepare (1, [&] { resumed = true; }));
+        empty.finish ();
+        expect (resumed, "resumed by finish");
+        expect (empty.complete ());
+    }
+
+    void
+    run() override
+    {
+        testPushPull();
+        testResume();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(QueuedWriter,http,ripple);
+
+}
+}
@@ -0,0 +1,769 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerTiming.h>
+#include <ripple/app/shamap/SHAMap.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/UInt160.h>
+#include <beast/chrono/manual_clock.h>
+#include <beast/unit_test/suite.h>
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ripple {
+namespace TestOverlay {
+
+/*  A simulation harness for evaluating protocol changes at network scale.
+
+    SimNetwork instantiates hundreds of lightweight peers joined by links
+    with modeled latency and bandwidth, and advances them in discrete
+    steps, each representing stepMillis of wall time. Workloads push typed
+    messages through the links; the harness accumulates message and byte
+    counts and the step at which the network converged, so relay, batching
+    and sync changes can be compared quantitatively before deployment.
+
+    Two workloads are provided:
+
+      SyncNetwork runs the real SHAMapSync code: one peer holds a
+      populated map and the rest acquire it with getMissingNodes /
+      getNodeFat / addKnownNode round trips over the simulated links.
+
+      ConsensusNetwork models the avalanche schedule of LedgerConsensus
+      (the real class is bound to the Application object and cannot be
+      instantiated standalone) using the thresholds from LedgerTiming.h,
+      measuring how long position agreement takes to spread.
+*/
+
+enum
+{
+    // One simulation step of wall time, in milliseconds
+    stepMillis = 10
+};
+
+/** Accumulates statistics over a simulation run. */
+struct SimResults
+{
+    SimResults ()
+        : steps (0)
+        , sent (0)
+        , received (0)
+        , bytes (0)
+        , convergedStep (-1)
+    {
+    }
+
+    std::string to_string () const
+    {
+        std::string s =
+            "steps=" + std::to_string (steps) +
+            ", sent=" + std::to_string (sent) +
+            ", received=" + std::to_string (received) +
+            ", bytes=" + std::to_string (bytes);
+
+        if (convergedStep >= 0)
+            s += ", converged=" +
+                std::to_string (convergedStep * stepMillis) + "ms";
+        else
+            s += ", converged=no";
+
+        return s;
+    }
+
+    int steps;
+    int sent;
+    int received;
+    std::uint64_t bytes;
+    int convergedStep;
+};
+
+//------------------------------------------------------------------------------
+
+/** One directed link with modeled latency and bandwidth.
+    Messages serialize onto the link: each waits for the bytes queued
+    ahead of it at the link's bandwidth, then propagates for the latency.
+*/
+template <typename Message>
+class SimLink
+{
+public:
+    SimLink (int peer, int latencySteps, int bytesPerStep)
+        : m_peer (peer)
+        , m_latency (latencySteps)
+        , m_bandwidth (bytesPerStep)
+        , m_busyUntil (0)
+    {
+    }
+
+    int peer () const
+    {
+        return m_peer;
+    }
+
+    void send (int now, Message const& m)
+    {
+        int const clear (std::max (now, m_busyUntil));
+        int const transmit (std::max <int> (1,
+            (m.size () + m_bandwidth - 1) / m_bandwidth));
+
+        m_busyUntil = clear + transmit;
+        m_queue.push_back (std::make_pair (m_busyUntil + m_latency, m));
+    }
+
+    /** Hand every message due by now to the handler. */
+    template <typename Handler>
+    void deliver (int now, Handler handler)
+    {
+        while (!m_queue.empty () && m_queue.front ().first <= now)
+        {
+            handler (m_queue.front ().second);
+            m_queue.pop_front ();
+        }
+    }
+
+private:
+    int m_peer;
+    int m_latency;
+    int m_bandwidth;
+    int m_busyUntil;
+    std::deque <std::pair <int, Message>> m_queue;
+};
+
+//------------------------------------------------------------------------------
+
+/** The simulated network.
+    Peer must provide a Message type with a size() member, plus
+    receive (from, message) and step ().
+*/
+template <typename Peer>
+class SimNetwork
+{
+public:
+    typedef typename Peer::Message Message;
+    typedef SimLink <Message> Link;
+
+    explicit SimNetwork (std::uint32_t seed)
+        : m_rng (seed)
+        , m_now (0)
+    {
+    }
+
+    int now () const
+    {
+        return m_now;
+    }
+
+    SimResults const& results () const
+    {
+        return m_results;
+    }
+
+    int size () const
+    {
+        return static_cast <int> (m_peers.size ());
+    }
+
+    Peer& peer (int id)
+    {
+        return *m_peers[id];
+    }
+
+    std::mt19937& rng ()
+    {
+        return m_rng;
+    }
+
+    /** Takes ownership of the peer. Peers get ids in creation order. */
+    void add (Peer* peer)
+    {
+        m_peers.emplace_back (peer);
+        m_links.resize (m_peers.size ());
+    }
+
+    bool connected (int a, int b) const
+    {
+        for (auto const& link : m_links[a])
+        {
+            if (link.peer () == b)
+                return true;
+        }
+        return false;
+    }
+
+    void connect (int a, int b, int latencySteps, int bytesPerStep)
+    {
+        m_links[a].push_back (Link (b, latencySteps, bytesPerStep));
+        m_links[b].push_back (Link (a, latencySteps, bytesPerStep));
+    }
+
+    /** Join every peer to outDegree random others, with symmetric links
+        whose latency is drawn uniformly from [minLatency, maxLatency].
+    */
+    void randomTopology (int outDegree, int minLatency, int maxLatency,
+        int bytesPerStep)
+    {
+        std::uniform_int_distribution <int> pick (0, size () - 1);
+        std::uniform_int_distribution <int> latency (minLatency, maxLatency);
+
+        for (int i = 0; i < size (); ++i)
+        {
+            for (int d = 0; d < outDegree; ++d)
+            {
+                for (;;)
+                {
+                    int const j (pick (m_rng));
+
+                    if (j == i || connected (i, j))
+                        continue;
+
+                    connect (i, j, latency (m_rng), bytesPerStep);
+                    break;
+                }
+            }
+        }
+    }
+
+    void send (int from, int to, Message const& m)
+    {
+        for (auto& link : m_links[from])
+        {
+            if (link.peer () == to)
+            {
+                link.send (m_now, m);
+                ++m_results.sent;
+                m_results.bytes += m.size ();
+                return;
+            }
+        }
+    }
+
+    void broadcast (int from, Message const& m)
+    {
+        for (auto& link : m_links[from])
+        {
+            link.send (m_now, m);
+            ++m_results.sent;
+            m_results.bytes += m.size ();
+        }
+    }
+
+    /** Deliver due messages, then let every peer act. */
+    void step ()
+    {
+        ++m_now;
+        ++m_results.steps;
+
+        for (int i = 0; i < size (); ++i)
+        {
+            for (auto& link : m_links[i])
+            {
+                link.deliver (m_now, [&] (Message const& m)
+                {
+                    ++m_results.received;
+                    m_peers[link.peer ()]->receive (i, m);
+                });
+            }
+        }
+
+        for (auto& p : m_peers)
+            p->step ();
+    }
+
+    void markConverged ()
+    {
+        if (m_results.convergedStep < 0)
+            m_results.convergedStep = m_now;
+    }
+
+private:
+    std::mt19937 m_rng;
+    int m_now;
+    SimResults m_results;
+    std::vector <std::unique_ptr <Peer>> m_peers;
+    std::vector <std::vector <Link>> m_links;
+};
+
+//------------------------------------------------------------------------------
+
+/** Full-map acquisition through the real SHAMapSync code. */
+class SyncNetwork_test : public beast::unit_test::suite
+{
+public:
+    enum
+    {
+        numPeers      = 200,
+        numItems      = 400,
+        outDegree     = 3,
+        minLatency    = 2,          // steps
+        maxLatency    = 10,
+        linkBandwidth = 16 * 1024,  // bytes per step (~1.6 MB/s)
+        syncBatch     = 64,         // missing nodes requested per round trip
+        maxSteps      = 5000
+    };
+
+    struct Message
+    {
+        enum Type
+        {
+            tmHave,     // sender has the complete map
+            tmGetNodes, // request for the listed nodes
+            tmNodeData  // the nodes, fattened by getNodeFat
+        };
+
+        Message ()
+            : type (tmHave)
+            , root (false)
+        {
+        }
+
+        Type type;
+        bool root;
+        std::vector <SHAMapNodeID> nodeIDs;
+        std::list <Blob> nodes;
+
+        std::size_t size () const
+        {
+            // Approximate wire size: fixed overhead, the node IDs, and
+            // the raw node payloads
+            std::size_t n (16 + 33 * nodeIDs.size ());
+            for (auto const& b : nodes)
+                n += b.size ();
+            return n;
+        }
+    };
+
+    class Peer;
+    typedef SimNetwork <Peer> Network;
+
+    class Peer
+    {
+    public:
+        typedef SyncNetwork_test::Message Message;
+
+        Peer (Network& network, int id, SHAMap::pointer map, bool complete)
+            : m_network (network)
+            , m_id (id)
+            , m_map (map)
+            , m_complete (complete)
+            , m_haveRoot (complete)
+            , m_announced (false)
+            , m_outstanding (false)
+        {
+            if (!complete)
+                m_map->setSynching ();
+        }
+
+        bool complete () const
+        {
+            return m_complete;
+        }
+
+        SHAMap& map ()
+        {
+            return *m_map;
+        }
+
+        void receive (int from, Message const& m)
+        {
+            switch (m.type)
+            {
+            case Message::tmHave:
+                m_sources.push_back (from);
+                break;
+
+            case Message::tmGetNodes:
+            {
+                if (!m_complete)
+                    break;
+
+                Message reply;
+                reply.type = Message::tmNodeData;
+                reply.root = m.root;
+
+                for (auto const& id : m.nodeIDs)
+                    m_map->getNodeFat (id, reply.nodeIDs, reply.nodes,
+                        false, true);
+
+                m_network.send (m_id, from, reply);
+                break;
+            }
+
+            case Message::tmNodeData:
+            {
+                m_outstanding = false;
+
+                if (m_complete)
+                    break;
+
+                auto idIter (m.nodeIDs.begin ());
+                auto nodeIter (m.nodes.begin ());
+
+                for (; idIter != m.nodeIDs.end () &&
+                       nodeIter != m.nodes.end (); ++idIter, ++nodeIter)
+                {
+                    if (m.root && idIter == m.nodeIDs.begin ())
+                    {
+                        if (m_map->addRootNode (
+                                *nodeIter, snfWIRE, nullptr).isGood ())
+                            m_haveRoot = true;
+                    }
+                    else
+                    {
+                        m_map->addKnownNode (*idIter, *nodeIter, nullptr);
+                    }
+                }
+
+                checkComplete ();
+                break;
+            }
+            }
+        }
+
+        void step ()
+        {
+            if (m_complete)
+            {
+                // Let neighbors know they can sync from us
+                if (!m_announced)
+                {
+                    m_announced = true;
+                    Message m;
+                    m.type = Message::tmHave;
+                    m_network.broadcast (m_id, m);
+                }
+                return;
+            }
+
+            if (m_outstanding || m_sources.empty ())
+                return;
+
+            Message request;
+            request.type = Message::tmGetNodes;
+
+            if (!m_haveRoot)
+            {
+                request.root = true;
+                request.nodeIDs.push_back (SHAMapNodeID ());
+            }
+            else
+            {
+                std::vector <uint256> hashes;
+                m_map->getMissingNodes (request.nodeIDs, hashes,
+                    syncBatch, nullptr);
+
+                if (request.nodeIDs.empty ())
+                {
+                    checkComplete ();
+                    return;
+                }
+            }
+
+            std::uniform_int_distribution <std::size_t> pick (
+                0, m_sources.size () - 1);
+            m_network.send (m_id, m_sources[pick (m_network.rng ())],
+                request);
+            m_outstanding = true;
+        }
+
+    private:
+        void checkComplete ()
+        {
+            if (!m_haveRoot)
+                return;
+
+            std::vector <SHAMapNodeID> nodeIDs;
+            std::vector <uint256> hashes;
+            m_map->getMissingNodes (nodeIDs, hashes, 1, nullptr);
+
+            if (nodeIDs.empty ())
+            {
+                m_map->clearSynching ();
+                m_complete = true;
+            }
+        }
+
+        Network& m_network;
+        int m_id;
+        SHAMap::pointer m_map;
+        bool m_complete;
+        bool m_haveRoot;
+        bool m_announced;
+        bool m_outstanding;
+        std::vector <int> m_sources;
+    };
+
+    //--------------------------------------------------------------------------
+
+    static SHAMapItem::pointer makeRandomAS ()
+    {
+        Serializer s;
+
+        for (int d = 0; d < 3; ++d)
+            s.add32 (rand ());
+
+        return std::make_shared <SHAMapItem> (
+            to256 (s.getRIPEMD160 ()), s.peekData ());
+    }
+
+    void run ()
+    {
+        beast::manual_clock <std::chrono::steady_clock> clock;
+        beast::Journal const j;
+
+        TreeNodeCache treeNodeCache ("sim.tree_node_cache",
+            65536, 60, clock, j);
+
+        // The full-below caches cannot be shared: each records which
+        // subtrees one particular map has completely acquired
+        std::vector <std::unique_ptr <FullBelowCache>> belowCaches;
+        std::vector <SHAMap::pointer> maps;
+        Network network (42);
+
+        for (int i = 0; i < numPeers; ++i)
+        {
+            belowCaches.emplace_back (
+                new FullBelowCache ("sim.full_below", clock));
+            maps.push_back (std::make_shared <SHAMap> (
+                smtFREE, *belowCaches.back (), treeNodeCache));
+        }
+
+        for (int i = 0; i < numItems; ++i)
+            maps[0]->addItem (*makeRandomAS (), false, false);
+
+        maps[0]->setImmutable ();
+
+        for (int i = 0; i < numPeers; ++i)
+            network.add (new Peer (network, i, maps[i], i == 0));
+
+        network.randomTopology (outDegree, minLatency, maxLatency,
+            linkBandwidth);
+
+        int complete (1);
+
+        while (network.now () < maxSteps)
+        {
+            network.step ();
+
+            if ((network.now () % 100) == 0)
+                ++clock;
+
+            complete = 0;
+            for (int i = 0; i < numPeers; ++i)
+            {
+                if (network.peer (i).complete ())
+                    ++complete;
+            }
+
+            if (complete == numPeers)
+            {
+                network.markConverged ();
+                break;
+            }
+        }
+
+        expect (complete == numPeers, "all peers synchronized");
+
+        int mismatches (0);
+        for (int i = 1; i < numPeers; ++i)
+        {
+            if (network.peer (i).map ().getHash () != maps[0]->getHash ())
+                ++mismatches;
+        }
+
+        expect (mismatches == 0, "all map hashes match");
+
+        log << "sync: " << network.results ().to_string ();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Position agreement under the LedgerConsensus avalanche schedule. */
+class ConsensusNetwork_test : public beast::unit_test::suite
+{
+public:
+    enum
+    {
+        numPeers      = 200,
+        outDegree     = 4,
+        minLatency    = 2,
+        maxLatency    = 10,
+        linkBandwidth = 16 * 1024,
+
+        // Re-examine positions on the consensus timer cadence
+        proposeEvery  = LEDGER_GRANULARITY / stepMillis,
+
+        maxSteps      = 1000
+    };
+
+    struct Message
+    {
+        Message ()
+            : position (0)
+        {
+        }
+
+        explicit Message (int position_)
+            : position (position_)
+        {
+        }
+
+        int position;
+
+        std::size_t size () const
+        {
+            // approximate size of a signed proposal
+            return 300;
+        }
+    };
+
+    class Peer;
+    typedef SimNetwork <Peer> Network;
+
+    class Peer
+    {
+    public:
+        typedef ConsensusNetwork_test::Message Message;
+
+        Peer (Network& network, int id, int position)
+            : m_network (network)
+            , m_id (id)
+            , m_position (position)
+        {
+        }
+
+        int position () const
+        {
+            return m_position;
+        }
+
+        // The support threshold for keeping a position, from the
+        // avalanche schedule in LedgerConsensus::updateOurPositions
+        static int neededPct (int convergePct)
+        {
+            if (convergePct < AV_MID_CONSENSUS_TIME)
+                return AV_INIT_CONSENSUS_PCT;
+
+            if (convergePct < AV_LATE_CONSENSUS_TIME)
+                return AV_MID_CONSENSUS_PCT;
+
+            if (convergePct < AV_STUCK_CONSENSUS_TIME)
+                return AV_LATE_CONSENSUS_PCT;
+
+            return AV_STUCK_CONSENSUS_PCT;
+        }
+
+        void receive (int from, Message const& m)
+        {
+            m_positions[from] = m.position;
+        }
+
+        void step ()
+        {
+            if (m_network.now () == 1)
+                m_network.broadcast (m_id, Message (m_position));
+
+            if ((m_network.now () % int (proposeEvery)) != 0)
+                return;
+
+            // Tally support for each candidate among the peers we have
+            // heard from, counting ourselves
+            std::map <int, int> votes;
+            ++votes[m_position];
+            for (auto const& v : m_positions)
+                ++votes[v.second];
+
+            int const total (1 + static_cast <int> (m_positions.size ()));
+
+            // The best supported candidate, ties broken toward the
+            // lowest so symmetric splits cannot deadlock
+            int best (m_position);
+            int bestVotes (votes[m_position]);
+            for (auto const& v : votes)
+            {
+                if ((v.second > bestVotes) ||
+                    (v.second == bestVotes && v.first < best))
+                {
+                    best = v.first;
+                    bestVotes = v.second;
+                }
+            }
+
+            int const convergePct (
+                (m_network.now () * stepMillis * 100) / LEDGER_MIN_CONSENSUS);
+
+            if ((best != m_position) &&
+                (100 * votes[m_position] / total < neededPct (convergePct)))
+            {
+                m_position = best;
+                m_network.broadcast (m_id, Message (m_position));
+            }
+        }
+
+    private:
+        Network& m_network;
+        int m_id;
+        int m_position;
+        std::map <int, int> m_positions;
+    };
+
+    //--------------------------------------------------------------------------
+
+    void run ()
+    {
+        Network network (7);
+
+        // A 60/40 split over two candidate positions
+        for (int i = 0; i < numPeers; ++i)
+            network.add (new Peer (network, i, (i % 5) < 3 ? 0 : 1));
+
+        network.randomTopology (outDegree, minLatency, maxLatency,
+            linkBandwidth);
+
+        bool agreed (false);
+
+        while (network.now () < maxSteps && !agreed)
+        {
+            network.step ();
+
+            agreed = true;
+            for (int i = 1; agreed && i < numPeers; ++i)
+            {
+                if (network.peer (i).position () !=
+                        network.peer (0).position ())
+                    agreed = false;
+            }
+
+            if (agreed)
+                network.markConverged ();
+        }
+
+        expect (agreed, "all peers agree on a position");
+
+        log << "consensus: " << network.results ().to_string ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SyncNetwork,overlay,ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(ConsensusNetwork,overlay,ripple);
+
+}
+}
@@ -23,6 +23,9 @@
 #include <ripple/unity/app.h>
 #include <ripple/unity/websocket.h>
 #include <ripple/app/impl/BasicApp.cpp>
+#include <ripple/app/main/BasicFullBelowCache.cpp>
+#include <ripple/app/main/CacheBudget.cpp>
+#include <ripple/app/main/CacheBudget.test.cpp>
 #include <ripple/app/main/CollectorManager.cpp>
 #include <ripple/app/main/NodeStoreScheduler.cpp>
 #include <ripple/app/websocket/WSServerHandler.cpp>
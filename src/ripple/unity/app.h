@@ -61,6 +61,9 @@
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/AcceptedLedgerTx.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
+#include <ripple/app/ledger/TransactionMetaIndex.h>
+#include <ripple/app/ledger/TxnMetaCodec.h>
+#include <ripple/app/ledger/LedgerHashIndex.h>
 #include <ripple/app/ledger/LedgerEntrySet.h>
 #include <ripple/app/ledger/DirectoryEntryIterator.h>
 #include <ripple/app/ledger/OrderBookIterator.h>
@@ -68,6 +71,7 @@
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/ledger/LedgerHolder.h>
 #include <ripple/app/ledger/LedgerHistory.h>
+#include <ripple/app/ledger/LedgerSnapshot.h>
 #include <ripple/app/ledger/LedgerCleaner.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerProposal.h>
@@ -38,3 +38,4 @@
 #include <ripple/app/shamap/RadixMapTest.h>
 #include <ripple/app/shamap/RadixMapTest.cpp>
 #include <ripple/app/shamap/FetchPackTests.cpp>
+#include <ripple/testoverlay/impl/SimNetwork.test.cpp>
@@ -21,8 +21,10 @@
 
 #include <ripple/unity/app.h>
 
+#include <ripple/app/ledger/HistoryShards.test.cpp>
 #include <ripple/app/ledger/Ledger.cpp>
 #include <ripple/app/ledger/Ledger.test.cpp>
+#include <ripple/app/ledger/LedgerSnapshot.cpp>
 #include <ripple/app/shamap/SHAMapDelta.cpp>
 #include <ripple/app/shamap/SHAMapNodeID.cpp>
 #include <ripple/app/shamap/SHAMapTreeNode.cpp>
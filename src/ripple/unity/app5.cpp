@@ -23,6 +23,8 @@
 
 #include <ripple/app/ledger/LedgerTiming.cpp>
 #include <ripple/app/ledger/AcceptedLedgerTx.cpp>
+#include <ripple/app/ledger/TxnMetaCodec.cpp>
+#include <ripple/app/ledger/TxnMetaCodec.test.cpp>
 #include <ripple/app/main/LocalCredentials.cpp>
 #include <ripple/app/misc/Validations.cpp>
 #include <ripple/app/misc/FeeVoteImpl.cpp>
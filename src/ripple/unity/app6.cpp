@@ -23,12 +23,17 @@
 
 #include <ripple/app/ledger/LedgerEntrySet.cpp>
 #include <ripple/app/ledger/AcceptedLedger.cpp>
+#include <ripple/app/ledger/TransactionMetaIndex.cpp>
+#include <ripple/app/ledger/LedgerHashIndex.cpp>
+#include <ripple/app/ledger/AccountItemsCache.cpp>
 #include <ripple/app/ledger/DirectoryEntryIterator.cpp>
 #include <ripple/app/ledger/OrderBookIterator.cpp>
 #include <ripple/app/consensus/DisputedTx.cpp>
 #include <ripple/app/misc/HashRouter.cpp>
+#include <ripple/app/misc/SignatureVerifierImpl.cpp>
 #include <ripple/app/paths/AccountCurrencies.cpp>
 #include <ripple/app/paths/Credit.cpp>
 #include <ripple/app/paths/FindPaths.cpp>
+#include <ripple/app/paths/PathFindCache.cpp>
 #include <ripple/app/paths/Pathfinder.cpp>
 #include <ripple/app/misc/AmendmentTableImpl.cpp>
@@ -44,6 +44,8 @@
 #include <ripple/app/main/ParameterTable.cpp>
 #include <ripple/app/paths/RippleLineCache.cpp>
 
+#include <ripple/app/paths/tests/PathsBenchmark.test.cpp>
+
 #ifdef _MSC_VER
 #pragma warning (pop)
 #endif
@@ -26,6 +26,7 @@
 #include <ripple/basics/impl/BasicConfig.cpp>
 #include <ripple/basics/impl/CheckLibraryVersions.cpp>
 #include <ripple/basics/impl/CountedObject.cpp>
+#include <ripple/basics/impl/LatencyProbes.cpp>
 #include <ripple/basics/impl/Log.cpp>
 #include <ripple/basics/impl/StringUtilities.cpp>
 #include <ripple/basics/impl/RangeSet.cpp>
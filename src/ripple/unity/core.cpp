@@ -24,4 +24,10 @@
 #include <ripple/core/impl/LoadEvent.cpp>
 #include <ripple/core/impl/LoadMonitor.cpp>
 #include <ripple/core/impl/Job.cpp>
+#include <ripple/core/impl/JobArena.cpp>
 #include <ripple/core/impl/JobQueue.cpp>
+#include <ripple/core/impl/SyncGovernor.cpp>
+#include <ripple/core/impl/ThreadAffinity.cpp>
+#include <ripple/core/impl/TimerWheel.cpp>
+#include <ripple/core/impl/JobArena.test.cpp>
+#include <ripple/core/impl/TimerWheel.test.cpp>
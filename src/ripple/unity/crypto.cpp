@@ -31,7 +31,10 @@
 #include <ripple/crypto/impl/ECDSA.cpp>
 #include <ripple/crypto/impl/ECDSACanonical.cpp>
 #include <ripple/crypto/impl/ECIES.cpp>
+#include <ripple/crypto/impl/Ed25519.cpp>
 #include <ripple/crypto/impl/GenerateDeterministicKey.cpp>
 #include <ripple/crypto/impl/RandomNumbers.cpp>
 #include <ripple/crypto/impl/RFC1751.cpp>
+#include <ripple/crypto/impl/SignatureEngine.cpp>
 #include <ripple/crypto/tests/CKey.test.cpp>
+#include <ripple/crypto/tests/Ed25519.test.cpp>
@@ -30,8 +30,11 @@
 #include <ripple/basics/seconds_clock.h>
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/basics/KeyCache.h>
+#include <ripple/protocol/CompactLedgerEntry.h>
+#include <ripple/protocol/HashPrefix.h>
 
 #include <ripple/nodestore/impl/Tuning.h>
+#include <ripple/nodestore/impl/CompactInnerNode.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
 #include <ripple/nodestore/impl/BatchWriter.h>
@@ -41,6 +44,8 @@
 #include <ripple/nodestore/backend/LevelDBFactory.cpp>
 #include <ripple/nodestore/backend/MemoryFactory.h>
 #include <ripple/nodestore/backend/MemoryFactory.cpp>
+#include <ripple/nodestore/backend/MmapArchiveFactory.h>
+#include <ripple/nodestore/backend/MmapArchiveFactory.cpp>
 #include <ripple/nodestore/backend/NullFactory.h>
 #include <ripple/nodestore/backend/NullFactory.cpp>
 #include <ripple/nodestore/backend/RocksDBFactory.h>
@@ -52,9 +57,12 @@
 #include <ripple/nodestore/impl/BatchWriter.cpp>
 #include <ripple/nodestore/impl/DatabaseImp.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/PresenceFilter.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
 #include <ripple/nodestore/impl/Database.cpp>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.cpp>
 #include <ripple/nodestore/impl/DummyScheduler.cpp>
+#include <ripple/nodestore/impl/CompactInnerNode.cpp>
 #include <ripple/nodestore/impl/DecodedBlob.cpp>
 #include <ripple/nodestore/impl/EncodedBlob.cpp>
 #include <ripple/nodestore/impl/Factory.cpp>
@@ -67,4 +75,6 @@
 #include <ripple/nodestore/tests/BackendTests.cpp>
 #include <ripple/nodestore/tests/BasicTests.cpp>
 #include <ripple/nodestore/tests/DatabaseTests.cpp>
+#include <ripple/nodestore/tests/TieredTests.cpp>
 #include <ripple/nodestore/tests/TimingTests.cpp>
+#include <ripple/nodestore/tests/BenchmarkTests.cpp>
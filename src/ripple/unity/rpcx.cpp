@@ -49,6 +49,7 @@
 #include <ripple/rpc/handlers/Connect.cpp>
 #include <ripple/rpc/handlers/ConsensusInfo.cpp>
 #include <ripple/rpc/handlers/Feature.cpp>
+#include <ripple/rpc/handlers/Fee.cpp>
 #include <ripple/rpc/handlers/FetchInfo.cpp>
 #include <ripple/rpc/handlers/GetCounts.cpp>
 #include <ripple/rpc/handlers/Internal.cpp>
@@ -60,9 +61,13 @@
 #include <ripple/rpc/handlers/LedgerData.cpp>
 #include <ripple/rpc/handlers/LedgerEntry.cpp>
 #include <ripple/rpc/handlers/LedgerHeader.cpp>
+#include <ripple/rpc/handlers/LedgerReplay.cpp>
 #include <ripple/rpc/handlers/LedgerRequest.cpp>
+#include <ripple/rpc/handlers/LedgerSnapshot.cpp>
+#include <ripple/rpc/handlers/LoadGenerate.cpp>
 #include <ripple/rpc/handlers/LogLevel.cpp>
 #include <ripple/rpc/handlers/LogRotate.cpp>
+#include <ripple/rpc/handlers/MemoryBudget.cpp>
 #include <ripple/rpc/handlers/OwnerInfo.cpp>
 #include <ripple/rpc/handlers/PathFind.cpp>
 #include <ripple/rpc/handlers/Peers.cpp>
@@ -74,9 +79,11 @@
 #include <ripple/rpc/handlers/ServerInfo.cpp>
 #include <ripple/rpc/handlers/ServerState.cpp>
 #include <ripple/rpc/handlers/Sign.cpp>
+#include <ripple/rpc/handlers/SignBatch.cpp>
 #include <ripple/rpc/handlers/Stop.cpp>
 #include <ripple/rpc/handlers/Submit.cpp>
 #include <ripple/rpc/handlers/Subscribe.cpp>
+#include <ripple/rpc/handlers/SyncGovernor.cpp>
 #include <ripple/rpc/handlers/TransactionEntry.cpp>
 #include <ripple/rpc/handlers/Tx.cpp>
 #include <ripple/rpc/handlers/TxHistory.cpp>
@@ -96,16 +103,19 @@
 
 #include <ripple/rpc/impl/AccountFromString.cpp>
 #include <ripple/rpc/impl/Accounts.cpp>
+#include <ripple/rpc/impl/AdmissionSlot.cpp>
 #include <ripple/rpc/impl/GetMasterGenerator.cpp>
 #include <ripple/rpc/impl/Handler.cpp>
-#include <ripple/rpc/impl/LegacyPathFind.cpp>
 #include <ripple/rpc/impl/LookupLedger.cpp>
 #include <ripple/rpc/impl/ParseAccountIds.cpp>
+#include <ripple/rpc/impl/ResponseCache.cpp>
 #include <ripple/rpc/impl/TransactionSign.cpp>
 
+#include <ripple/rpc/impl/AdmissionSlot.test.cpp>
 #include <ripple/rpc/impl/Coroutine.test.cpp>
 #include <ripple/rpc/impl/JsonObject.test.cpp>
 #include <ripple/rpc/impl/JsonWriter.test.cpp>
+#include <ripple/rpc/impl/ResponseCache.test.cpp>
 #include <ripple/rpc/impl/Status.test.cpp>
 #include <ripple/rpc/impl/WriteJson.test.cpp>
 #include <ripple/rpc/impl/Yield.test.cpp>
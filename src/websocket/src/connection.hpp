@@ -117,6 +117,7 @@ public:
      , m_state(session::state::CONNECTING)
      , m_protocol_error(false)
      , m_write_buffer(0)
+     , m_write_batch(0)
      , m_write_state(IDLE)
      , m_fail_code(fail::status::GOOD)
      , m_local_close_code(close::status::ABNORMAL_CLOSE)
@@ -1169,7 +1170,7 @@ public:
         if (m_write_state == INTURRUPT) {return;}
         
         m_write_buffer += msg->get_payload().size();
-        m_write_queue.push(msg);
+        m_write_queue.push_back(msg);
         
         write();
     }
@@ -1192,7 +1193,7 @@ public:
                 // clear the queue except for the last message
                 while (m_write_queue.size() > 1) {
                     m_write_buffer -= m_write_queue.front()->get_payload().size();
-                    m_write_queue.pop();
+                    m_write_queue.pop_front();
                 }
                 break;
             default:
@@ -1204,12 +1205,33 @@ public:
             if (m_write_state == IDLE) {
                 m_write_state = WRITING;
             }
-                        
-            m_write_buf.push_back(boost::asio::buffer(m_write_queue.front()->get_header()));
-            m_write_buf.push_back(boost::asio::buffer(m_write_queue.front()->get_payload()));
-            
+
+            // Gather as many queued messages as possible into one vectored
+            // write. A CLOSE frame ends the batch so the close bookkeeping
+            // in handle_write still runs with the close as the last message
+            // written. The messages stay in m_write_queue until handle_write
+            // pops them, which keeps the gathered buffers alive.
+            static const size_t max_batch = 32;
+
+            m_write_batch = 0;
+
+            std::deque<message::data_ptr>::const_iterator it;
+
+            for (it = m_write_queue.begin();
+                 it != m_write_queue.end() && m_write_batch < max_batch;
+                 ++it)
+            {
+                m_write_buf.push_back(boost::asio::buffer((*it)->get_header()));
+                m_write_buf.push_back(boost::asio::buffer((*it)->get_payload()));
+                ++m_write_batch;
+
+                if ((*it)->get_opcode() == frame::opcode::CLOSE) {
+                    break;
+                }
+            }
+
             //m_endpoint.alog().at(log::alevel::DEVEL) << "write header: " << zsutil::to_hex(m_write_queue.front()->get_header()) << log::endl;
-            
+
             async_write(socket_type::get_socket(),
                 m_write_buf,
                 m_strand.wrap(boost::bind(
@@ -1272,13 +1294,20 @@ public:
 	    return;
         }
         
-        m_write_buffer -= m_write_queue.front()->get_payload().size();
+        // Pop every message covered by the completed vectored write. The
+        // batch never extends past a CLOSE frame, so the close handling
+        // below sees the close as the last message written.
+        frame::opcode::value code = frame::opcode::CONTINUATION;
+
+        for (size_t i = 0; i < m_write_batch && !m_write_queue.empty(); ++i) {
+            m_write_buffer -= m_write_queue.front()->get_payload().size();
+            code = m_write_queue.front()->get_opcode();
+            m_write_queue.pop_front();
+        }
+
+        m_write_batch = 0;
         m_write_buf.clear();
         
-        frame::opcode::value code = m_write_queue.front()->get_opcode();
-        
-        m_write_queue.pop();
-        
         if (m_write_state == WRITING) {
             m_write_state = IDLE;
         }
@@ -1498,7 +1527,7 @@ public:
     
     // Write queue
     std::vector<boost::asio::const_buffer> m_write_buf;
-    std::queue<message::data_ptr>   m_write_queue;
+    std::deque<message::data_ptr>   m_write_queue;
     uint64_t                        m_write_buffer;
     write_state                     m_write_state;
     
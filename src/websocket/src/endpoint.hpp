@@ -46,6 +46,22 @@ namespace websocketpp {
 /// before endpoint policy classes are constructed.
 class endpoint_base {
 protected:
+    /// Construct an endpoint_base that owns its own io_service.
+    endpoint_base()
+     : m_owned_io_service(new boost::asio::io_service())
+     , m_io_service(*m_owned_io_service) {}
+
+    /// Construct an endpoint_base hosted on an external io_service. The
+    /// caller is responsible for running the io_service; run_internal and
+    /// the stop path will never stop a service the endpoint does not own.
+    explicit endpoint_base(boost::asio::io_service& ios)
+     : m_io_service(ios) {}
+
+    /// Whether this endpoint owns (and may run/stop) its io_service.
+    bool owns_io_service() const {
+        return m_owned_io_service.get() != 0;
+    }
+
     /// Start the run method of the endpoint's io_service object.
     void run_internal() {
         for (;;) {
@@ -57,8 +73,9 @@ protected:
             }
         }
     }
-    
-    boost::asio::io_service m_io_service;
+
+    boost::shared_ptr<boost::asio::io_service> m_owned_io_service;
+    boost::asio::io_service& m_io_service;
 };
 
 /// Describes a configurable WebSocket endpoint.
@@ -134,7 +151,7 @@ public:
      * @param handler A shared_ptr to the handler to use as the default handler
      * when creating new connections.
      */
-    explicit endpoint(handler_ptr handler) 
+    explicit endpoint(handler_ptr handler)
      : role_type(endpoint_base::m_io_service)
      , socket_type(endpoint_base::m_io_service)
      , m_handler(handler)
@@ -148,6 +165,33 @@ public:
     {
         m_pool->set_callback(boost::bind(&type::on_new_message,this));
     }
+
+    /// Construct an endpoint hosted on an external io_service.
+    /**
+     * Identical to the single argument constructor except that all
+     * asynchronous operations are posted to the supplied io_service, which
+     * the caller runs (typically on a shared thread pool). The endpoint
+     * will never run or stop an io_service it does not own.
+     *
+     * @param handler A shared_ptr to the handler to use as the default
+     * handler when creating new connections.
+     * @param ios The io_service to host this endpoint's operations on.
+     */
+    endpoint(handler_ptr handler, boost::asio::io_service& ios)
+     : endpoint_base(ios)
+     , role_type(endpoint_base::m_io_service)
+     , socket_type(endpoint_base::m_io_service)
+     , m_handler(handler)
+     , m_read_threshold(DEFAULT_READ_THRESHOLD)
+     , m_silent_close(DEFAULT_SILENT_CLOSE)
+     , m_state(IDLE)
+     , m_alog(new alogger_type())
+     , m_elog(new elogger_type())
+     , m_pool(new message::pool<message::data>(1000))
+     , m_pool_control(new message::pool<message::data>(SIZE_MAX))
+    {
+        m_pool->set_callback(boost::bind(&type::on_new_message,this));
+    }
     
     /// Destroy an endpoint
     ~endpoint() {
@@ -387,10 +431,14 @@ public:
             m_state = STOPPING;
             close_all(code,reason);
         } else {
-            m_alog->at(log::alevel::ENDPOINT) 
+            m_alog->at(log::alevel::ENDPOINT)
                 << "Endpoint is stopping immediately" << log::endl;
-            
-            endpoint_base::m_io_service.stop();
+
+            // An endpoint hosted on an external io_service must not stop
+            // it; other endpoints may be sharing the same service.
+            if (owns_io_service()) {
+                endpoint_base::m_io_service.stop();
+            }
             m_state = STOPPED;
         }
     }
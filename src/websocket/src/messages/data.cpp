@@ -37,7 +37,7 @@
 using websocketpp::message::data;
 using websocketpp::processor::hybi_util::circshift_prepared_key;
 
-data::data(data::pool_ptr p, size_t s) : m_prepared(false),m_index(s),m_ref_count(0),m_pool(p),m_live(false) {
+data::data(data::pool_ptr p, size_t s) : m_prepared(false),m_compressed(false),m_index(s),m_ref_count(0),m_pool(p),m_live(false) {
     m_payload.reserve(PAYLOAD_SIZE_INIT);
 }
     
@@ -91,13 +91,13 @@ void data::process_payload(char *input, size_t size) {
         //std::cout << " to " << zsutil::to_hex(reinterpret_cast<char*>(&m_prepared_key),sizeof(size_t)) << std::endl;
     }
     
-    if (m_opcode == frame::opcode::TEXT) {
+    if (m_opcode == frame::opcode::TEXT && !m_compressed) {
         if (!m_validator.decode(input, input+size)) {
             throw processor::exception("Invalid UTF8 data",
                                        processor::error::PAYLOAD_VIOLATION);
         }
     }
-    
+
     // copy working buffer into
     //std::cout << "before: " << m_payload.size() << std::endl;
     
@@ -112,6 +112,7 @@ void data::reset(websocketpp::frame::opcode::value opcode) {
     m_payload.clear();
     m_validator.reset();
     m_prepared = false;
+    m_compressed = false;
 }
 
 void data::complete() {
@@ -146,7 +147,15 @@ void data::set_prepared(bool b) {
 }
 
 bool data::get_prepared() const {
-    return m_prepared; 
+    return m_prepared;
+}
+
+void data::set_compressed(bool b) {
+    m_compressed = b;
+}
+
+bool data::get_compressed() const {
+    return m_compressed;
 }
 
 // This could be further optimized using methods that write directly into the
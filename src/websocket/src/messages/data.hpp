@@ -201,6 +201,12 @@ public:
     void set_prepared(bool b);
     bool get_prepared() const;
     void mask();
+
+    // Marks the payload as compressed by a negotiated extension. While set,
+    // incremental UTF8 validation is skipped during reading; the processor
+    // validates the payload after inflating the completed message.
+    void set_compressed(bool b);
+    bool get_compressed() const;
     
     int32_t get_masking_key() const {
         return m_masking_key.i;
@@ -255,8 +261,9 @@ private:
     
     std::string                 m_header;
     std::string                 m_payload;
-    
+
     bool                        m_prepared;
+    bool                        m_compressed;
     
     // reference counting
     size_t                              m_index;
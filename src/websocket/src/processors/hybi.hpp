@@ -30,6 +30,7 @@
 
 #include "processor.hpp"
 #include "hybi_header.hpp"
+#include "permessage_deflate.hpp"
 
 #include "../base64/base64.h"
 #include "../sha1/sha1.h"
@@ -243,6 +244,19 @@ public:
             response.replace_header("Sec-WebSocket-Accept",server_key);
             response.add_header("Upgrade","websocket");
             response.add_header("Connection","Upgrade");
+
+            // negotiate optional per-message compression
+            std::string extensions = request.header("Sec-WebSocket-Extensions");
+            if (extensions != "") {
+                std::string negotiated = m_extension.negotiate(extensions);
+                if (negotiated != "") {
+                    response.replace_header("Sec-WebSocket-Extensions",
+                                            negotiated);
+                    // compressed frames carry the RSV1 bit
+                    m_header.set_allow_rsv1(true);
+                    m_write_header.set_allow_rsv1(true);
+                }
+            }
         } else {
             //m_endpoint->elog().at(log::elevel::RERROR) 
             //<< "Error computing handshake sha1 hash" << log::endl;
@@ -349,6 +363,12 @@ public:
             }
             
             m_data_message->reset(m_header.get_opcode());
+
+            if (m_header.get_rsv1()) {
+                // payload is compressed; it is inflated once the message
+                // completes
+                m_data_message->set_compressed(true);
+            }
         } else {
             // A message has already been started. Continuation frames only!
             if (m_header.get_opcode() != frame::opcode::CONTINUATION) {
@@ -407,6 +427,13 @@ public:
             if (m_header.is_control()) {
                 m_control_message->complete();
             } else {
+                if (m_data_message->get_compressed()) {
+                    m_data_message->set_payload(
+                        m_extension.decompress(m_data_message->get_payload()));
+                    m_data_message->set_compressed(false);
+                    // UTF8 validation was deferred until after inflation
+                    m_data_message->validate_payload();
+                }
                 m_data_message->complete();
             }
             m_state = hybi_state::READY;
@@ -561,12 +588,21 @@ public:
         }
         
         msg->validate_payload();
-        
+
         bool masked = !m_connection.is_server();
         int32_t key = m_connection.rand();
-        
+
+        bool compressed = m_extension.enabled() &&
+            !frame::opcode::is_control(msg->get_opcode()) &&
+            msg->get_payload().size() >= permessage_deflate::MIN_MESSAGE_SIZE;
+
+        if (compressed) {
+            msg->set_payload(m_extension.compress(msg->get_payload()));
+        }
+
         m_write_header.reset();
         m_write_header.set_fin(true);
+        m_write_header.set_rsv1(compressed);
         m_write_header.set_opcode(msg->get_opcode());
         m_write_header.set_masked(masked,key);
         m_write_header.set_payload_size(msg->get_payload().size());
@@ -614,6 +650,7 @@ private:
     message::control_ptr    m_control_message;
     hybi_header             m_header;
     hybi_header             m_write_header;
+    permessage_deflate      m_extension;
     size_t                  m_payload_left;
     
     char                    m_payload_buffer[PAYLOAD_BUFFER_SIZE];
@@ -31,7 +31,7 @@
 
 using websocketpp::processor::hybi_header;
 
-hybi_header::hybi_header() {
+hybi_header::hybi_header() : m_allow_rsv1(false) {
     reset();
 }
 void hybi_header::reset() {
@@ -85,6 +85,10 @@ bool hybi_header::ready() const {
     return m_state == STATE_READY;
 }
 
+void hybi_header::set_allow_rsv1(bool b) {
+    m_allow_rsv1 = b;
+}
+
 // Writing interface (set fields directly)
 void hybi_header::set_fin(bool fin) {
     set_header_bit(BPB0_FIN,0,fin);
@@ -220,8 +224,10 @@ void hybi_header::validate_basic_header() const {
         throw processor::exception("Control Frame is too large",processor::error::PROTOCOL_VIOLATION);
     }
     
-    // check for reserved bits
-    if (get_rsv1() || get_rsv2() || get_rsv3()) {
+    // check for reserved bits. RSV1 is valid on data frames when a
+    // negotiated extension has claimed it.
+    if ((get_rsv1() && !(m_allow_rsv1 && !is_control())) ||
+        get_rsv2() || get_rsv3()) {
         throw processor::exception("Reserved bit used",processor::error::PROTOCOL_VIOLATION);
     }
     
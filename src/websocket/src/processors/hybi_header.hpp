@@ -60,6 +60,11 @@ public:
     hybi_header();
     /// Reset a header processor for writing
     void reset();
+
+    /// Permit the RSV1 bit on data frames. Used when a negotiated extension
+    /// (such as permessage-deflate) gives the bit meaning. Persists across
+    /// calls to reset().
+    void set_allow_rsv1(bool b);
     
     // Writing interface (parse a byte stream)
     // valid only if ready() returns false
@@ -136,6 +141,7 @@ private:
     static const uint8_t STATE_WRITE = 4;
     
     uint8_t     m_state;
+    bool        m_allow_rsv1;
     std::streamsize m_bytes_needed;
     uint64_t    m_payload_size;
     char m_header[MAX_HEADER_LENGTH];
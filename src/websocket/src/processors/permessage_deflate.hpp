@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2011, Peter Thorson. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the WebSocket++ Project nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL PETER THORSON BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef WEBSOCKET_PROCESSOR_PERMESSAGE_DEFLATE_HPP
+#define WEBSOCKET_PROCESSOR_PERMESSAGE_DEFLATE_HPP
+
+#include "processor.hpp"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/utility.hpp>
+
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+namespace websocketpp {
+namespace processor {
+
+/// Implements the permessage-deflate WebSocket extension
+/**
+ * Each instance holds one pair of raw deflate/inflate streams whose
+ * compression context is shared across the messages of a single connection
+ * ("context takeover"), which is where most of the win on repetitive
+ * payloads comes from. Messages are compressed with a sync flush and the
+ * trailing 00 00 ff ff marker is stripped per the extension specification;
+ * compressed frames carry the RSV1 bit.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe
+ */
+class permessage_deflate : boost::noncopyable {
+public:
+    /// Messages smaller than this are sent uncompressed; on tiny payloads
+    /// the deflate block overhead outweighs any savings.
+    static const size_t MIN_MESSAGE_SIZE = 64;
+
+    /// Upper bound on the size of an inflated message. Matches the payload
+    /// limit enforced by message::data.
+    static const uint64_t MAX_MESSAGE_SIZE = 100000000; // 100MB
+
+    permessage_deflate() : m_enabled(false), m_reset_deflate(false) {}
+
+    ~permessage_deflate() {
+        if (m_enabled) {
+            deflateEnd(&m_dstate);
+            inflateEnd(&m_istate);
+        }
+    }
+
+    bool enabled() const {
+        return m_enabled;
+    }
+
+    /// Examines a client's Sec-WebSocket-Extensions offer. If it contains a
+    /// permessage-deflate configuration this implementation can honor, the
+    /// extension is enabled and the value to return in the server's
+    /// Sec-WebSocket-Extensions header is returned. Returns an empty string
+    /// if no acceptable configuration was offered.
+    std::string negotiate(const std::string& offer) {
+        if (m_enabled) {
+            return "";
+        }
+
+        std::vector<std::string> offers;
+        boost::split(offers,offer,boost::is_any_of(","));
+
+        for (size_t i = 0; i < offers.size(); i++) {
+            std::vector<std::string> params;
+            boost::split(params,offers[i],boost::is_any_of(";"));
+
+            boost::trim(params[0]);
+            if (params[0] != "permessage-deflate") {
+                continue;
+            }
+
+            bool acceptable = true;
+            bool reset_deflate = false;
+            std::string response = "permessage-deflate";
+
+            for (size_t j = 1; j < params.size(); j++) {
+                boost::trim(params[j]);
+
+                if (params[j].compare(0,22,"client_max_window_bits") == 0) {
+                    // A hint about the client's compression window. A
+                    // smaller client window decodes fine with our 15 bit
+                    // inflate window, so no response parameter is needed.
+                } else if (params[j] == "client_no_context_takeover") {
+                    response += "; client_no_context_takeover";
+                } else if (params[j] == "server_no_context_takeover") {
+                    reset_deflate = true;
+                    response += "; server_no_context_takeover";
+                } else {
+                    // Includes server_max_window_bits: zlib does not
+                    // reliably honor reduced raw deflate windows, so
+                    // decline this configuration.
+                    acceptable = false;
+                    break;
+                }
+            }
+
+            if (!acceptable) {
+                continue;
+            }
+
+            if (!init()) {
+                return "";
+            }
+
+            m_enabled = true;
+            m_reset_deflate = reset_deflate;
+            return response;
+        }
+
+        return "";
+    }
+
+    /// Compresses payload with the connection's shared deflate context and
+    /// strips the trailing flush marker.
+    std::string compress(const std::string& payload) {
+        std::string out;
+        char buffer[8192];
+
+        m_dstate.next_in = reinterpret_cast<Bytef*>(
+            const_cast<char*>(payload.data()));
+        m_dstate.avail_in = static_cast<uInt>(payload.size());
+
+        do {
+            m_dstate.next_out = reinterpret_cast<Bytef*>(buffer);
+            m_dstate.avail_out = sizeof(buffer);
+
+            deflate(&m_dstate,Z_SYNC_FLUSH);
+
+            out.append(buffer,sizeof(buffer)-m_dstate.avail_out);
+        } while (m_dstate.avail_out == 0);
+
+        if (m_reset_deflate) {
+            deflateReset(&m_dstate);
+        }
+
+        // A sync flush always ends with an empty stored block; the
+        // extension transmits the message without this 00 00 ff ff marker.
+        if (out.size() >= 4) {
+            out.resize(out.size()-4);
+        }
+
+        return out;
+    }
+
+    /// Reverses compress(). Throws a processor exception on malformed
+    /// compressed data or if the inflated message exceeds MAX_MESSAGE_SIZE.
+    std::string decompress(const std::string& payload) {
+        // restore the flush marker stripped by the sender
+        std::string in(payload);
+        in.append("\x00\x00\xff\xff",4);
+
+        std::string out;
+        char buffer[8192];
+
+        m_istate.next_in = reinterpret_cast<Bytef*>(
+            const_cast<char*>(in.data()));
+        m_istate.avail_in = static_cast<uInt>(in.size());
+
+        do {
+            m_istate.next_out = reinterpret_cast<Bytef*>(buffer);
+            m_istate.avail_out = sizeof(buffer);
+
+            int ret = inflate(&m_istate,Z_SYNC_FLUSH);
+
+            if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+                throw processor::exception("Invalid compressed data",
+                                           processor::error::PAYLOAD_VIOLATION);
+            }
+
+            out.append(buffer,sizeof(buffer)-m_istate.avail_out);
+
+            if (out.size() > MAX_MESSAGE_SIZE) {
+                throw processor::exception("Message too big",
+                                           processor::error::MESSAGE_TOO_BIG);
+            }
+
+            if (ret == Z_STREAM_END) {
+                // A final deflate block ends the raw stream; reset so the
+                // next message starts cleanly.
+                inflateReset(&m_istate);
+                break;
+            }
+        } while (m_istate.avail_out == 0);
+
+        return out;
+    }
+private:
+    bool init() {
+        m_dstate.zalloc = Z_NULL;
+        m_dstate.zfree = Z_NULL;
+        m_dstate.opaque = Z_NULL;
+
+        m_istate.zalloc = Z_NULL;
+        m_istate.zfree = Z_NULL;
+        m_istate.opaque = Z_NULL;
+        m_istate.next_in = Z_NULL;
+        m_istate.avail_in = 0;
+
+        // negative window bits select raw deflate streams without
+        // zlib headers, as the extension requires
+        if (deflateInit2(&m_dstate,Z_DEFAULT_COMPRESSION,Z_DEFLATED,-15,8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return false;
+        }
+
+        if (inflateInit2(&m_istate,-15) != Z_OK) {
+            deflateEnd(&m_dstate);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool        m_enabled;
+    bool        m_reset_deflate;
+    z_stream    m_dstate;
+    z_stream    m_istate;
+};
+
+} // namespace processor
+} // namespace websocketpp
+
+#endif // WEBSOCKET_PROCESSOR_PERMESSAGE_DEFLATE_HPP
@@ -259,6 +259,14 @@ public:
 
     void stop_listen(bool join);
 
+    /// Bind the acceptor and begin accepting without running the io_service.
+    /**
+     * For endpoints hosted on an external io_service: binds, listens, and
+     * posts the first async_accept, then returns immediately. Accept and
+     * connection handlers run on whichever threads run the io_service.
+     */
+    void start_listen_external(const boost::asio::ip::tcp::endpoint& e);
+
     // legacy interface
     void listen(uint16_t port, size_t num_threads = 1) {
       start_listen(port,num_threads>1 ? num_threads : 0);
@@ -379,6 +387,24 @@ void server<endpoint>::stop_listen(bool join) {
     m_state = IDLE;
 }
 
+template <class endpoint>
+void server<endpoint>::start_listen_external(const boost::asio::ip::tcp::endpoint& e) {
+    boost::unique_lock<boost::recursive_mutex> lock(m_endpoint.m_lock);
+
+    if (m_state != IDLE) {
+        throw exception("listen called from invalid state.");
+    }
+
+    m_acceptor.open(e.protocol());
+    m_acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    m_acceptor.bind(e);
+    m_acceptor.listen();
+
+    this->start_accept();
+
+    m_state = LISTENING;
+}
+
 template <class endpoint>
 void server<endpoint>::start_listen(uint16_t port, size_t num_threads) {
     start_listen(boost::asio::ip::tcp::v6(), port, num_threads);